@@ -23,6 +23,7 @@
 #include "itkBSplineKernelFunction.h"
 #include "itkArray.h"
 #include "itkArray2D.h"
+#include "itkMatrix.h"
 
 namespace itk
 {
@@ -83,6 +84,10 @@ public:
   /** ContinuousIndex typedef support. */
   typedef ContinuousIndex< TCoordRep, VSpaceDimension > ContinuousIndexType;
 
+  /** One-dimensional weights typedef support. Row j holds the
+   * SplineOrder + 1 weights along dimension j. */
+  typedef Matrix< double, VSpaceDimension, VSplineOrder + 1 > OneDWeightsType;
+
   /** Evaluate the weights at specified ContinuousIndex position.
    * Subclasses must provide this method. */
   virtual WeightsType Evaluate(const ContinuousIndexType & index) const ITK_OVERRIDE;
@@ -98,6 +103,16 @@ public:
   virtual void Evaluate(const ContinuousIndexType & index,
                         WeightsType & weights, IndexType & startIndex) const;
 
+  /** Evaluate the one-dimensional weights along each dimension at the
+   * specified ContinuousIndex position. The weights returned by
+   * Evaluate() are the tensor product of these, so callers that walk
+   * the support region dimension by dimension can use them directly
+   * and avoid computing the (SplineOrder + 1)^(SpaceDimension) products.
+   * On return, startIndex contains the start index of the support region.
+   */
+  virtual void Evaluate1DWeights(const ContinuousIndexType & index,
+                                 OneDWeightsType & weights1D, IndexType & startIndex) const;
+
   /** Get support region size. */
   itkGetConstMacro(SupportSize, SizeType);
 
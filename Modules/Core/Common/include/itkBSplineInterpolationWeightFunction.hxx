@@ -113,32 +113,42 @@ void BSplineInterpolationWeightFunction< TCoordRep, VSpaceDimension,
 {
   unsigned int j, k;
 
-  // Find the starting index of the support region
-  for ( j = 0; j < SpaceDimension; j++ )
-    {
-    startIndex[j] = Math::Floor< IndexValueType >(index[j] - static_cast< double >( SplineOrder - 1 ) / 2.0);
-    }
+  // Compute the weights along each dimension
+  OneDWeightsType weights1D;
+  this->Evaluate1DWeights(index, weights1D, startIndex);
 
-  // Compute the weights
-  Matrix< double, SpaceDimension, SplineOrder + 1 > weights1D;
-  for ( j = 0; j < SpaceDimension; j++ )
+  for ( k = 0; k < m_NumberOfWeights; k++ )
     {
-    double x = index[j] - static_cast< double >( startIndex[j] );
+    weights[k] = 1.0;
 
-    for ( k = 0; k <= SplineOrder; k++ )
+    for ( j = 0; j < SpaceDimension; j++ )
       {
-      weights1D[j][k] = m_Kernel->Evaluate(x);
-      x -= 1.0;
+      weights[k] *= weights1D[j][m_OffsetToIndexTable[k][j]];
       }
     }
+}
 
-  for ( k = 0; k < m_NumberOfWeights; k++ )
+/** Compute the one-dimensional weights at continuous index position */
+template< typename TCoordRep, unsigned int VSpaceDimension,
+          unsigned int VSplineOrder >
+void BSplineInterpolationWeightFunction< TCoordRep, VSpaceDimension,
+                                         VSplineOrder >
+::Evaluate1DWeights(
+  const ContinuousIndexType & index,
+  OneDWeightsType & weights1D,
+  IndexType & startIndex) const
+{
+  for ( unsigned int j = 0; j < SpaceDimension; j++ )
     {
-    weights[k] = 1.0;
+    // Find the starting index of the support region
+    startIndex[j] = Math::Floor< IndexValueType >(index[j] - static_cast< double >( SplineOrder - 1 ) / 2.0);
 
-    for ( j = 0; j < SpaceDimension; j++ )
+    double x = index[j] - static_cast< double >( startIndex[j] );
+
+    for ( unsigned int k = 0; k <= SplineOrder; k++ )
       {
-      weights[k] *= weights1D[j][m_OffsetToIndexTable[k][j]];
+      weights1D[j][k] = m_Kernel->Evaluate(x);
+      x -= 1.0;
       }
     }
 }
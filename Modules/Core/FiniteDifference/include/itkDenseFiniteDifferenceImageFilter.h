@@ -54,6 +54,20 @@ namespace itk
  * This is an image to image filter.  The specific types of the images are not
  * fixed at this level in the hierarchy.
  *
+ * \par Active tiles
+ * When UseActiveTiles is on, the output is divided in tiles of ActiveTileSize
+ * pixels, and the change is calculated and applied only on the tiles which
+ * changed by more than ActiveTileTolerance in the previous iteration and on
+ * their neighbors, whose change depends on them.  The other tiles have
+ * converged and are skipped, until the front reaches them again.  The update
+ * buffer is then written and read only on the active tiles, and the largest
+ * change of each tile is measured in the same pass as the update is applied.
+ * With a null tolerance this gives the same output as the full iteration, as
+ * long as the update of a pixel depends only on its neighborhood and on a time
+ * step which does not vary.  Filters which process the whole update buffer
+ * after CalculateChange(), like the smoothing of the deformable registration
+ * filters, should not use this mode.
+ *
  * \par How to use this class
  * This filter is only one layer in a branch the finite difference solver
  * hierarchy.  It does not define the function used in the CalculateChange() and
@@ -101,6 +115,30 @@ public:
   /** The container type for the update buffer. */
   typedef OutputImageType UpdateBufferType;
 
+  /** The type of the size of the active tiles. */
+  typedef typename OutputImageType::SizeType ActiveTileSizeType;
+
+  /** Set/Get whether the change is calculated and applied only on the tiles
+   * of the output which have not converged.  Off by default. */
+  itkSetMacro(UseActiveTiles, bool);
+  itkGetConstMacro(UseActiveTiles, bool);
+  itkBooleanMacro(UseActiveTiles);
+
+  /** Set/Get the size of the active tiles, in pixels.  Defaults to 16 in
+   * each dimension. */
+  itkSetMacro(ActiveTileSize, ActiveTileSizeType);
+  itkGetConstReferenceMacro(ActiveTileSize, ActiveTileSizeType);
+
+  /** Set/Get the largest change of a pixel component under which a tile is
+   * considered converged.  Defaults to 0. */
+  itkSetMacro(ActiveTileTolerance, double);
+  itkGetConstMacro(ActiveTileTolerance, double);
+
+  /** Get the number of tiles on which the next iteration calculates the
+   * change, when UseActiveTiles is on. */
+  SizeValueType GetNumberOfActiveTiles() const
+  { return static_cast< SizeValueType >( m_ActiveTiles.size() ); }
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   // Begin concept checking
   itkConceptMacro( OutputTimesDoubleCheck,
@@ -115,8 +153,7 @@ public:
 #endif
 
 protected:
-  DenseFiniteDifferenceImageFilter()
-  { m_UpdateBuffer = UpdateBufferType::New(); }
+  DenseFiniteDifferenceImageFilter();
   ~DenseFiniteDifferenceImageFilter() {}
   void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
 
@@ -185,8 +222,38 @@ private:
    * which it then passes to ThreadedCalculateChange for processing. */
   static ITK_THREAD_RETURN_TYPE CalculateChangeThreaderCallback(void *arg);
 
+  /** An image with one pixel per tile, which flags the active tiles. */
+  typedef Image< unsigned char, itkGetStaticConstMacro(ImageDimension) > TileImageType;
+  typedef typename TileImageType::IndexType                              TileIndexType;
+
+  /** Divides the requested region of the output in tiles, all active. */
+  void InitializeActiveTiles();
+
+  /** Keeps active the tiles which changed by more than the tolerance and
+   * activates their neighbors.  Called after the update is applied. */
+  void UpdateActiveTiles();
+
+  /** Returns the region of the output covered by a tile. */
+  ThreadRegionType GetTileRegion(const TileIndexType & tile) const;
+
+  /** Gets the range of the active tiles processed by a thread. */
+  void SplitActiveTiles(ThreadIdType threadId, ThreadIdType threadCount,
+                        SizeValueType & begin, SizeValueType & end) const;
+
+  /** Applies the update to a tile, and returns the largest change of a pixel
+   * component. */
+  double ApplyUpdateToTile(const TimeStepType & dt, const ThreadRegionType & tile);
+
   /** The buffer that holds the updates for an iteration of the algorithm. */
   typename UpdateBufferType::Pointer m_UpdateBuffer;
+
+  bool               m_UseActiveTiles;
+  ActiveTileSizeType m_ActiveTileSize;
+  double             m_ActiveTileTolerance;
+
+  typename TileImageType::Pointer m_TileImage;
+  std::vector< TileIndexType >    m_ActiveTiles;
+  std::vector< double >           m_ActiveTileChanges;
 };
 } // end namespace itk
 
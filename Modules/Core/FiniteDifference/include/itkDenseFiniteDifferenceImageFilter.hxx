@@ -20,12 +20,26 @@
 #include "itkDenseFiniteDifferenceImageFilter.h"
 
 #include <list>
+#include <algorithm>
+#include <cmath>
 #include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkDefaultConvertPixelTraits.h"
 #include "itkNumericTraits.h"
 #include "itkNeighborhoodAlgorithm.h"
 
 namespace itk
 {
+template< typename TInputImage, typename TOutputImage >
+DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >
+::DenseFiniteDifferenceImageFilter()
+{
+  m_UpdateBuffer = UpdateBufferType::New();
+  m_UseActiveTiles = false;
+  m_ActiveTileSize.Fill(16);
+  m_ActiveTileTolerance = 0.0;
+}
+
 template< typename TInputImage, typename TOutputImage >
 void
 DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >
@@ -78,6 +92,121 @@ DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >
   m_UpdateBuffer->SetRequestedRegion( output->GetRequestedRegion() );
   m_UpdateBuffer->SetBufferedRegion( output->GetBufferedRegion() );
   m_UpdateBuffer->Allocate();
+
+  // The tiles are set up by the first CalculateChange().
+  m_TileImage = ITK_NULLPTR;
+  m_ActiveTiles.clear();
+  m_ActiveTileChanges.clear();
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >
+::InitializeActiveTiles()
+{
+  const ThreadRegionType & region = this->GetOutput()->GetRequestedRegion();
+
+  typename TileImageType::SizeType numberOfTiles;
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    if ( m_ActiveTileSize[i] == 0 )
+      {
+      itkExceptionMacro(<< "ActiveTileSize must be positive in each dimension.");
+      }
+    numberOfTiles[i] = ( region.GetSize()[i] + m_ActiveTileSize[i] - 1 ) / m_ActiveTileSize[i];
+    }
+
+  m_TileImage = TileImageType::New();
+  m_TileImage->SetRegions(numberOfTiles);
+  m_TileImage->Allocate();
+  m_TileImage->FillBuffer(1);
+
+  m_ActiveTiles.clear();
+  ImageRegionConstIteratorWithIndex< TileImageType > it( m_TileImage, m_TileImage->GetBufferedRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    m_ActiveTiles.push_back( it.GetIndex() );
+    }
+  m_ActiveTileChanges.assign(m_ActiveTiles.size(), 0.0);
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >
+::UpdateActiveTiles()
+{
+  // A change of a tile reaches the tiles within the radius of the function.
+  const typename FiniteDifferenceFunctionType::RadiusType radius =
+    this->GetDifferenceFunction()->GetRadius();
+  typename TileImageType::SizeType reach;
+  typename TileImageType::SizeType neighborhoodSize;
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    reach[i] = ( radius[i] + m_ActiveTileSize[i] - 1 ) / m_ActiveTileSize[i];
+    neighborhoodSize[i] = 2 * reach[i] + 1;
+    }
+
+  m_TileImage->FillBuffer(0);
+  for ( size_t t = 0; t < m_ActiveTiles.size(); ++t )
+    {
+    if ( m_ActiveTileChanges[t] > m_ActiveTileTolerance )
+      {
+      TileIndexType start = m_ActiveTiles[t];
+      for ( unsigned int i = 0; i < ImageDimension; ++i )
+        {
+        start[i] -= static_cast< IndexValueType >( reach[i] );
+        }
+      typename TileImageType::RegionType neighborhood(start, neighborhoodSize);
+      neighborhood.Crop( m_TileImage->GetBufferedRegion() );
+
+      ImageRegionIterator< TileImageType > nIt(m_TileImage, neighborhood);
+      for ( nIt.GoToBegin(); !nIt.IsAtEnd(); ++nIt )
+        {
+        nIt.Set(1);
+        }
+      }
+    }
+
+  // Keep the active tiles in memory order.
+  m_ActiveTiles.clear();
+  ImageRegionConstIteratorWithIndex< TileImageType > it( m_TileImage, m_TileImage->GetBufferedRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() )
+      {
+      m_ActiveTiles.push_back( it.GetIndex() );
+      }
+    }
+  m_ActiveTileChanges.assign(m_ActiveTiles.size(), 0.0);
+}
+
+template< typename TInputImage, typename TOutputImage >
+typename DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >::ThreadRegionType
+DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >
+::GetTileRegion(const TileIndexType & tile) const
+{
+  const ThreadRegionType & region = this->GetOutput()->GetRequestedRegion();
+
+  ThreadRegionType tileRegion;
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    const SizeValueType offset = tile[i] * m_ActiveTileSize[i];
+    tileRegion.SetIndex( i, region.GetIndex(i) + static_cast< IndexValueType >( offset ) );
+    tileRegion.SetSize( i, std::min( m_ActiveTileSize[i], region.GetSize(i) - offset ) );
+    }
+  return tileRegion;
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >
+::SplitActiveTiles(ThreadIdType threadId, ThreadIdType threadCount,
+                   SizeValueType & begin, SizeValueType & end) const
+{
+  // Contiguous ranges, so that each thread works on neighboring tiles.
+  const SizeValueType numberOfTiles = static_cast< SizeValueType >( m_ActiveTiles.size() );
+  begin = numberOfTiles * threadId / threadCount;
+  end = numberOfTiles * ( threadId + 1 ) / threadCount;
 }
 
 template< typename TInputImage, typename TOutputImage >
@@ -96,6 +225,11 @@ DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >
   // Multithread the execution
   this->GetMultiThreader()->SingleMethodExecute();
 
+  if ( m_UseActiveTiles )
+    {
+    this->UpdateActiveTiles();
+    }
+
   // Explicitely call Modified on GetOutput here
   // since ThreadedApplyUpdate changes this buffer
   // through iterators which do not increment the
@@ -114,6 +248,19 @@ DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >
   DenseFDThreadStruct* str = (DenseFDThreadStruct *)
       ( ( (MultiThreader::ThreadInfoStruct *)( arg ) )->UserData );
 
+  if ( str->Filter->m_UseActiveTiles )
+    {
+    SizeValueType begin;
+    SizeValueType end;
+    str->Filter->SplitActiveTiles(threadId, threadCount, begin, end);
+    for ( SizeValueType t = begin; t < end; ++t )
+      {
+      str->Filter->m_ActiveTileChanges[t] = str->Filter->ApplyUpdateToTile(
+        str->TimeStep, str->Filter->GetTileRegion( str->Filter->m_ActiveTiles[t] ) );
+      }
+    return ITK_THREAD_RETURN_VALUE;
+    }
+
   // Execute the actual method with appropriate output region
   // first find out how many pieces extent can be split into.
   // Using the SplitRequestedRegion method from itk::ImageSource.
@@ -135,6 +282,19 @@ DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >::TimeStepType
 DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >
 ::CalculateChange()
 {
+  if ( m_UseActiveTiles )
+    {
+    if ( m_TileImage.IsNull() )
+      {
+      this->InitializeActiveTiles();
+      }
+    // All the tiles have converged, nothing changes anymore.
+    if ( m_ActiveTiles.empty() )
+      {
+      return NumericTraits< TimeStepType >::ZeroValue();
+      }
+    }
+
   // Set up for multithreaded processing.
   DenseFDThreadStruct str;
 
@@ -183,6 +343,24 @@ DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >
   DenseFDThreadStruct * str = (DenseFDThreadStruct *)
       ( ( (MultiThreader::ThreadInfoStruct *)( arg ) )->UserData );
 
+  if ( str->Filter->m_UseActiveTiles )
+    {
+    SizeValueType begin;
+    SizeValueType end;
+    str->Filter->SplitActiveTiles(threadId, threadCount, begin, end);
+    for ( SizeValueType t = begin; t < end; ++t )
+      {
+      const TimeStepType timeStep = str->Filter->ThreadedCalculateChange(
+        str->Filter->GetTileRegion( str->Filter->m_ActiveTiles[t] ), threadId );
+      if ( t == begin || timeStep < str->TimeStepList[threadId] )
+        {
+        str->TimeStepList[threadId] = timeStep;
+        }
+      str->ValidTimeStepList[threadId] = true;
+      }
+    return ITK_THREAD_RETURN_VALUE;
+    }
+
   // Execute the actual method with appropriate output region
   // first find out how many pieces extent can be split into.
   // Using the SplitRequestedRegion method from itk::ImageSource.
@@ -224,6 +402,38 @@ DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >
     }
 }
 
+template< typename TInputImage, typename TOutputImage >
+double
+DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >
+::ApplyUpdateToTile(const TimeStepType & dt, const ThreadRegionType & tile)
+{
+  typedef DefaultConvertPixelTraits< PixelType > PixelTraitsType;
+
+  ImageRegionIterator< UpdateBufferType > u(m_UpdateBuffer,    tile);
+  ImageRegionIterator< OutputImageType >  o(this->GetOutput(), tile);
+
+  double maximumChange = 0.0;
+  while ( !u.IsAtEnd() )
+    {
+    const PixelType change = static_cast< PixelType >( u.Value() * dt );
+    o.Value() += change;
+
+    const unsigned int numberOfComponents = PixelTraitsType::GetNumberOfComponents(change);
+    for ( unsigned int c = 0; c < numberOfComponents; ++c )
+      {
+      const double componentChange =
+        std::abs( static_cast< double >( PixelTraitsType::GetNthComponent(c, change) ) );
+      if ( componentChange > maximumChange )
+        {
+        maximumChange = componentChange;
+        }
+      }
+    ++o;
+    ++u;
+    }
+  return maximumChange;
+}
+
 template< typename TInputImage, typename TOutputImage >
 typename
 DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >::TimeStepType
@@ -306,6 +516,11 @@ DenseFiniteDifferenceImageFilter< TInputImage, TOutputImage >
 ::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
+
+  os << indent << "UseActiveTiles: " << ( m_UseActiveTiles ? "On" : "Off" ) << std::endl;
+  os << indent << "ActiveTileSize: " << m_ActiveTileSize << std::endl;
+  os << indent << "ActiveTileTolerance: " << m_ActiveTileTolerance << std::endl;
+  os << indent << "NumberOfActiveTiles: " << m_ActiveTiles.size() << std::endl;
 }
 } // end namespace itk
 
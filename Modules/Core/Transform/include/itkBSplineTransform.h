@@ -234,6 +234,17 @@ public:
   virtual void TransformPoint( const InputPointType & inputPoint, OutputPointType & outputPoint,
     WeightsType & weights, ParameterIndexArrayType & indices, bool & inside ) const ITK_OVERRIDE;
 
+  /** Transform a point by a BSpline deformable transformation.
+   * Unlike the variant above, the full set of interpolation weights is
+   * not formed: the displacement is accumulated from the separable
+   * weights along each dimension, with no memory allocation. */
+  virtual OutputPointType TransformPoint( const InputPointType & point ) const ITK_OVERRIDE;
+
+  /** Transform a contiguous array of points. The coefficient buffers and
+   * grid strides are looked up once for the whole batch. */
+  virtual void TransformPoints( const InputPointType *inputPoints, OutputPointType *outputPoints,
+    SizeValueType numberOfPoints ) const ITK_OVERRIDE;
+
   virtual void ComputeJacobianWithRespectToParameters( const InputPointType &, JacobianType & ) const ITK_OVERRIDE;
 
   /** Return the number of parameters that completely define the Transfom */
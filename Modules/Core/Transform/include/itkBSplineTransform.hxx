@@ -21,8 +21,6 @@
 #include "itkBSplineTransform.h"
 
 #include "itkContinuousIndex.h"
-#include "itkImageScanlineConstIterator.h"
-#include "itkImageRegionConstIteratorWithIndex.h"
 
 namespace itk
 {
@@ -494,6 +492,122 @@ BSplineTransform<TParametersValueType, NDimensions, VSplineOrder>
   return inside;
 }
 
+template<typename TParametersValueType, unsigned int NDimensions, unsigned int VSplineOrder>
+typename BSplineTransform<TParametersValueType, NDimensions, VSplineOrder>::OutputPointType
+BSplineTransform<TParametersValueType, NDimensions, VSplineOrder>
+::TransformPoint( const InputPointType & point ) const
+{
+  OutputPointType outputPoint;
+
+  this->TransformPoints( &point, &outputPoint, 1 );
+
+  return outputPoint;
+}
+
+template<typename TParametersValueType, unsigned int NDimensions, unsigned int VSplineOrder>
+void
+BSplineTransform<TParametersValueType, NDimensions, VSplineOrder>
+::TransformPoints( const InputPointType *inputPoints, OutputPointType *outputPoints,
+  SizeValueType numberOfPoints ) const
+{
+  const ImageType *coefficientImage = this->m_CoefficientImages[0];
+
+  if( !coefficientImage->GetBufferPointer() )
+    {
+    itkWarningMacro( "B-spline coefficients have not been set" );
+    for( SizeValueType n = 0; n < numberOfPoints; n++ )
+      {
+      for( unsigned int j = 0; j < SpaceDimension; j++ )
+        {
+        outputPoints[n][j] = inputPoints[n][j];
+        }
+      }
+    return;
+    }
+
+  const OffsetValueType *offsetTable = coefficientImage->GetOffsetTable();
+  const ParametersValueType *basePointers[SpaceDimension];
+  for( unsigned int j = 0; j < SpaceDimension; j++ )
+    {
+    basePointers[j] = this->m_CoefficientImages[j]->GetBufferPointer();
+    }
+
+  typename WeightsFunctionType::OneDWeightsType weights1D;
+  ContinuousIndexType                           index;
+  IndexType                                     supportIndex;
+
+  for( SizeValueType n = 0; n < numberOfPoints; n++ )
+    {
+    coefficientImage->TransformPhysicalPointToContinuousIndex( inputPoints[n], index );
+
+    // NOTE: if the support region does not lie totally within the grid
+    // we assume zero displacement and return the input point
+    if( !this->InsideValidRegion( index ) )
+      {
+      outputPoints[n] = inputPoints[n];
+      continue;
+      }
+
+    // The weights are separable, so the support region is walked one line
+    // along the first dimension at a time: each line contributes the
+    // product of its weights along the other dimensions times the inner
+    // product of its contiguous coefficients with the first dimension
+    // weights. This avoids forming all (SplineOrder + 1)^SpaceDimension
+    // weights and any iterator over the coefficient images.
+    this->m_WeightsFunction->Evaluate1DWeights( index, weights1D, supportIndex );
+
+    const OffsetValueType startOffset = coefficientImage->ComputeOffset( supportIndex );
+
+    ScalarType   displacement[SpaceDimension];
+    unsigned int lineIndex[SpaceDimension];
+    for( unsigned int j = 0; j < SpaceDimension; j++ )
+      {
+      displacement[j] = NumericTraits<ScalarType>::ZeroValue();
+      lineIndex[j] = 0;
+      }
+
+    bool moreLines = true;
+    while( moreLines )
+      {
+      OffsetValueType lineOffset = startOffset;
+      ScalarType      lineWeight = NumericTraits<ScalarType>::OneValue();
+      for( unsigned int d = 1; d < SpaceDimension; d++ )
+        {
+        lineOffset += lineIndex[d] * offsetTable[d];
+        lineWeight *= static_cast<ScalarType>( weights1D[d][lineIndex[d]] );
+        }
+
+      for( unsigned int j = 0; j < SpaceDimension; j++ )
+        {
+        const ParametersValueType *coefficient = basePointers[j] + lineOffset;
+        ScalarType                 lineSum = NumericTraits<ScalarType>::ZeroValue();
+        for( unsigned int k = 0; k <= SplineOrder; k++ )
+          {
+          lineSum += static_cast<ScalarType>( weights1D[0][k] * coefficient[k] );
+          }
+        displacement[j] += lineWeight * lineSum;
+        }
+
+      // go to the next line in the support region
+      moreLines = false;
+      for( unsigned int d = 1; d < SpaceDimension; d++ )
+        {
+        if( ++lineIndex[d] <= SplineOrder )
+          {
+          moreLines = true;
+          break;
+          }
+        lineIndex[d] = 0;
+        }
+      }
+
+    for( unsigned int j = 0; j < SpaceDimension; j++ )
+      {
+      outputPoints[n][j] = inputPoints[n][j] + displacement[j];
+      }
+    }
+}
+
 template<typename TParametersValueType, unsigned int NDimensions, unsigned int VSplineOrder>
 void
 BSplineTransform<TParametersValueType, NDimensions, VSplineOrder>
@@ -502,10 +616,12 @@ BSplineTransform<TParametersValueType, NDimensions, VSplineOrder>
 {
   inside = true;
 
-  if( this->m_CoefficientImages[0]->GetBufferPointer() )
+  const ImageType *coefficientImage = this->m_CoefficientImages[0];
+
+  if( coefficientImage->GetBufferPointer() )
     {
     ContinuousIndexType index;
-    this->m_CoefficientImages[0]->TransformPhysicalPointToContinuousIndex( point, index );
+    coefficientImage->TransformPhysicalPointToContinuousIndex( point, index );
 
     // NOTE: if the support region does not lie totally within the grid
     // we assume zero displacement and return the input point
@@ -520,53 +636,63 @@ BSplineTransform<TParametersValueType, NDimensions, VSplineOrder>
     // Compute interpolation weights
     this->m_WeightsFunction->Evaluate( index, weights, supportIndex );
 
-    // For each dimension, correlate coefficient with weights
-    SizeType   supportSize;
-    supportSize.Fill( SplineOrder + 1 );
-    RegionType supportRegion;
-    supportRegion.SetSize( supportSize );
-    supportRegion.SetIndex( supportIndex );
-
+    // For each dimension, correlate coefficient with weights. The support
+    // region is visited in the same order as the weights, one line along
+    // the first dimension at a time, directly in the coefficient buffers.
     outputPoint.Fill( NumericTraits<ScalarType>::ZeroValue() );
 
-    typedef ImageScanlineConstIterator<ImageType> IteratorType;
-    IteratorType               coeffIterator[SpaceDimension];
-    unsigned long              counter = 0;
-    const ParametersValueType *basePointer =
-      this->m_CoefficientImages[0]->GetBufferPointer();
+    const OffsetValueType *offsetTable = coefficientImage->GetOffsetTable();
+    const ParametersValueType *basePointers[SpaceDimension];
     for( unsigned int j = 0; j < SpaceDimension; j++ )
       {
-      coeffIterator[j] =
-        IteratorType( this->m_CoefficientImages[j], supportRegion );
+      basePointers[j] = this->m_CoefficientImages[j]->GetBufferPointer();
       }
 
-    while( !coeffIterator[0].IsAtEnd() )
+    const OffsetValueType startOffset = coefficientImage->ComputeOffset( supportIndex );
+
+    unsigned int lineIndex[SpaceDimension];
+    for( unsigned int d = 0; d < SpaceDimension; d++ )
       {
-       while( !coeffIterator[0].IsAtEndOfLine() )
-         {
-         // multiply weigth with coefficient
-         for( unsigned int j = 0; j < SpaceDimension; j++ )
-           {
-           outputPoint[j] += static_cast<ScalarType>(
-             weights[counter] * coeffIterator[j].Get() );
-           }
-
-         // populate the indices array
-         indices[counter] = &( coeffIterator[0].Value() ) - basePointer;
-
-         // go to next coefficient in the support region
-         ++counter;
-         for( unsigned int j = 0; j < SpaceDimension; j++ )
-           {
-           ++( coeffIterator[j] );
-           }
-         } // end scanline
-
-       for( unsigned int j = 0; j < SpaceDimension; j++ )
-         {
-         coeffIterator[j].NextLine();
-         }
+      lineIndex[d] = 0;
       }
+
+    unsigned long counter = 0;
+    bool          moreLines = true;
+    while( moreLines )
+      {
+      OffsetValueType lineOffset = startOffset;
+      for( unsigned int d = 1; d < SpaceDimension; d++ )
+        {
+        lineOffset += lineIndex[d] * offsetTable[d];
+        }
+
+      for( unsigned int k = 0; k <= SplineOrder; k++ )
+        {
+        // multiply weigth with coefficient
+        for( unsigned int j = 0; j < SpaceDimension; j++ )
+          {
+          outputPoint[j] += static_cast<ScalarType>(
+            weights[counter] * basePointers[j][lineOffset + k] );
+          }
+
+        // populate the indices array
+        indices[counter] = lineOffset + k;
+        ++counter;
+        }
+
+      // go to the next line in the support region
+      moreLines = false;
+      for( unsigned int d = 1; d < SpaceDimension; d++ )
+        {
+        if( ++lineIndex[d] <= SplineOrder )
+          {
+          moreLines = true;
+          break;
+          }
+        lineIndex[d] = 0;
+        }
+      }
+
     // return results
     for( unsigned int j = 0; j < SpaceDimension; j++ )
       {
@@ -593,14 +719,11 @@ BSplineTransform<TParametersValueType, NDimensions, VSplineOrder>
   // Zero all components of jacobian
   jacobian.SetSize( SpaceDimension, this->GetNumberOfParameters() );
   jacobian.Fill( 0.0 );
-  RegionType   supportRegion;
-  SizeType     supportSize;
-  supportSize.Fill( SplineOrder + 1 );
-  supportRegion.SetSize( supportSize );
+
+  const ImageType *coefficientImage = this->m_CoefficientImages[0];
 
   ContinuousIndexType index;
-  this->m_CoefficientImages[0]->
-    TransformPhysicalPointToContinuousIndex( point, index );
+  coefficientImage->TransformPhysicalPointToContinuousIndex( point, index );
 
   // NOTE: if the support region does not lie totally within the grid we assume
   // zero displacement and do no computations beyond zeroing out the value
@@ -616,37 +739,50 @@ BSplineTransform<TParametersValueType, NDimensions, VSplineOrder>
   IndexType supportIndex;
   this->m_WeightsFunction->Evaluate( index, weights, supportIndex );
 
-  supportRegion.SetIndex( supportIndex );
+  // The coefficient images wrap the flat parameters buffer, so the
+  // parameter number of a coefficient is its offset in the buffer.
+  const OffsetValueType *offsetTable = coefficientImage->GetOffsetTable();
+  const OffsetValueType  startOffset = coefficientImage->ComputeOffset( supportIndex );
 
-  IndexType startIndex =
-    this->m_CoefficientImages[0]->GetLargestPossibleRegion().GetIndex();
+  SizeValueType numberOfParametersPerDimension = this->GetNumberOfParametersPerDimension();
 
-  SizeType cumulativeGridSizes;
-  cumulativeGridSizes[0] = ( this->m_TransformDomainMeshSize[0] + SplineOrder );
-  for( unsigned int d = 1; d < SpaceDimension; d++ )
+  unsigned int lineIndex[SpaceDimension];
+  for( unsigned int d = 0; d < SpaceDimension; d++ )
     {
-    cumulativeGridSizes[d] = cumulativeGridSizes[d-1] * ( this->m_TransformDomainMeshSize[d] + SplineOrder );
+    lineIndex[d] = 0;
     }
 
-  SizeValueType numberOfParametersPerDimension = this->GetNumberOfParametersPerDimension();
-
-  ImageRegionConstIteratorWithIndex<ImageType> It( this->m_CoefficientImages[0], supportRegion );
   unsigned long counter = 0;
-  for( It.GoToBegin(); !It.IsAtEnd(); ++It )
+  bool          moreLines = true;
+  while( moreLines )
     {
-    typename ImageType::OffsetType currentIndex = It.GetIndex() - startIndex;
-
-    unsigned long number = currentIndex[0];
+    OffsetValueType lineOffset = startOffset;
     for( unsigned int d = 1; d < SpaceDimension; d++ )
       {
-      number += ( currentIndex[d] * cumulativeGridSizes[d-1] );
+      lineOffset += lineIndex[d] * offsetTable[d];
       }
 
-    for( unsigned int d = 0; d < SpaceDimension; d++ )
+    for( unsigned int k = 0; k <= SplineOrder; k++ )
+      {
+      const SizeValueType number = lineOffset + k;
+      for( unsigned int d = 0; d < SpaceDimension; d++ )
+        {
+        jacobian( d, number + d * numberOfParametersPerDimension ) = weights[counter];
+        }
+      counter++;
+      }
+
+    // go to the next line in the support region
+    moreLines = false;
+    for( unsigned int d = 1; d < SpaceDimension; d++ )
       {
-      jacobian( d, number + d * numberOfParametersPerDimension ) = weights[counter];
+      if( ++lineIndex[d] <= SplineOrder )
+        {
+        moreLines = true;
+        break;
+        }
+      lineIndex[d] = 0;
       }
-    counter++;
     }
 }
 
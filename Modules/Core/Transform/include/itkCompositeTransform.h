@@ -243,6 +243,14 @@ public:
   */
   virtual OutputPointType TransformPoint( const InputPointType & inputPoint ) const ITK_OVERRIDE;
 
+  /** Transform a contiguous array of points, applying each transform of the
+   * queue to the whole array in turn (in reverse queue order, as for
+   * TransformPoint) so that sub-transforms can use their own batched
+   * TransformPoints. */
+  virtual void TransformPoints( const InputPointType *inputPoints,
+                                OutputPointType *outputPoints,
+                                SizeValueType numberOfPoints ) const ITK_OVERRIDE;
+
   /**  Method to transform a vector. */
   using Superclass::TransformVector;
   virtual OutputVectorType TransformVector(const InputVectorType &) const ITK_OVERRIDE;
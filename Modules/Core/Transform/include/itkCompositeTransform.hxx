@@ -100,6 +100,32 @@ CompositeTransform<TParametersValueType, NDimensions>
 }
 
 
+template<typename TParametersValueType, unsigned int NDimensions>
+void
+CompositeTransform<TParametersValueType, NDimensions>
+::TransformPoints( const InputPointType *inputPoints, OutputPointType *outputPoints,
+  SizeValueType numberOfPoints ) const
+{
+  if( outputPoints != inputPoints )
+    {
+    for( SizeValueType n = 0; n < numberOfPoints; n++ )
+      {
+      outputPoints[n] = inputPoints[n];
+      }
+    }
+
+  /* Apply in reverse queue order, in place.  */
+  typename TransformQueueType::const_iterator it( this->m_TransformQueue.end() );
+  const typename TransformQueueType::const_iterator beginit( this->m_TransformQueue.begin() );
+  do
+    {
+    it--;
+    (*it)->TransformPoints( outputPoints, outputPoints, numberOfPoints );
+    }
+  while( it != beginit );
+}
+
+
 template<typename TParametersValueType, unsigned int NDimensions>
 typename CompositeTransform<TParametersValueType, NDimensions>
 ::OutputVectorType
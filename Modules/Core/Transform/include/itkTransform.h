@@ -188,6 +188,19 @@ public:
    */
   virtual OutputPointType TransformPoint(const InputPointType  &) const = 0;
 
+  /**  Method to transform a contiguous array of points.
+   * On return, outputPoints[i] holds the transform of inputPoints[i] for
+   * i < numberOfPoints. The default implementation calls TransformPoint()
+   * for each point; transforms that can share work between points (e.g.
+   * BSplineTransform) override it. Filters that map many points at once,
+   * such as ResampleImageFilter, call this method per scanline.
+   * inputPoints and outputPoints may be the same array, in which case the
+   * points are transformed in place; overrides must preserve this.
+   * \warning This method must be thread-safe. */
+  virtual void TransformPoints(const InputPointType *inputPoints,
+                               OutputPointType *outputPoints,
+                               SizeValueType numberOfPoints) const;
+
   /**  Method to transform a vector. */
   virtual OutputVectorType  TransformVector(const InputVectorType &) const
   {
@@ -152,6 +152,21 @@ Transform<TParametersValueType, NInputDimensions, NOutputDimensions>
 }
 
 
+template<typename TParametersValueType,
+          unsigned int NInputDimensions,
+          unsigned int NOutputDimensions>
+void
+Transform<TParametersValueType, NInputDimensions, NOutputDimensions>
+::TransformPoints( const InputPointType *inputPoints, OutputPointType *outputPoints,
+                   SizeValueType numberOfPoints ) const
+{
+  for( SizeValueType i = 0; i < numberOfPoints; ++i )
+    {
+    outputPoints[i] = this->TransformPoint( inputPoints[i] );
+    }
+}
+
+
 template<typename TParametersValueType,
           unsigned int NInputDimensions,
           unsigned int NOutputDimensions>
@@ -731,6 +731,98 @@ int itkBSplineTransformTest3()
   return EXIT_SUCCESS;
 }
 
+int itkBSplineTransformTest4()
+{
+
+  // This function tests that the TransformPoints batch interface and the
+  // single point TransformPoint() agree with the variant of TransformPoint()
+  // that returns the interpolation weights.
+
+  const unsigned int SpaceDimension = 3;
+  const unsigned int SplineOrder = 3;
+  typedef double CoordinateRepType;
+  typedef itk::BSplineTransform
+  <CoordinateRepType, SpaceDimension, SplineOrder> TransformType;
+
+  typedef TransformType::ParametersType ParametersType;
+
+  TransformType::OriginType origin;
+  origin.Fill( -10.0 );
+
+  TransformType::PhysicalDimensionsType dimensions;
+  dimensions[0] = 100.0;
+  dimensions[1] = 80.0;
+  dimensions[2] = 60.0;
+
+  TransformType::MeshSizeType meshSize;
+  meshSize[0] = 7;
+  meshSize[1] = 5;
+  meshSize[2] = 4;
+
+  TransformType::DirectionType direction;
+  direction.SetIdentity();
+
+  TransformType::Pointer transform = TransformType::New();
+
+  transform->SetTransformDomainOrigin( origin );
+  transform->SetTransformDomainPhysicalDimensions( dimensions );
+  transform->SetTransformDomainMeshSize( meshSize );
+  transform->SetTransformDomainDirection( direction );
+
+  // Give every coefficient a different value
+  ParametersType parameters( transform->GetNumberOfParameters() );
+  for( unsigned int p = 0; p < parameters.Size(); p++ )
+    {
+    parameters[p] = std::sin( 0.37 * static_cast<double>( p ) ) * 3.0;
+    }
+  transform->SetParameters( parameters );
+
+  typedef TransformType::InputPointType PointType;
+
+  const unsigned int numberOfPoints = 200;
+  std::vector<PointType> inputPoints( numberOfPoints );
+  std::vector<PointType> outputPoints( numberOfPoints );
+  for( unsigned int n = 0; n < numberOfPoints; n++ )
+    {
+    // Points spread inside and outside the grid support region
+    for( unsigned int j = 0; j < SpaceDimension; j++ )
+      {
+      inputPoints[n][j] = origin[j] - 5.0 +
+        ( dimensions[j] + 10.0 ) * std::fabs( std::cos( 1.3 * n + 0.7 * j ) );
+      }
+    }
+
+  transform->TransformPoints( &inputPoints[0], &outputPoints[0], numberOfPoints );
+
+  TransformType::WeightsType             weights( transform->GetNumberOfWeights() );
+  TransformType::ParameterIndexArrayType indices( transform->GetNumberOfWeights() );
+  bool                                   inside;
+
+  const double tolerance = 1e-10;
+  for( unsigned int n = 0; n < numberOfPoints; n++ )
+    {
+    PointType expectedPoint;
+    transform->TransformPoint( inputPoints[n], expectedPoint, weights, indices, inside );
+
+    PointType singlePoint = transform->TransformPoint( inputPoints[n] );
+
+    for( unsigned int j = 0; j < SpaceDimension; j++ )
+      {
+      if( std::fabs( outputPoints[n][j] - expectedPoint[j] ) > tolerance ||
+          std::fabs( singlePoint[j] - expectedPoint[j] ) > tolerance )
+        {
+        std::cout << "Mismatch at point " << inputPoints[n] << ": expected "
+                  << expectedPoint << ", TransformPoints returned " << outputPoints[n]
+                  << ", TransformPoint returned " << singlePoint << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
+
 int itkBSplineTransformTest(int, char * [] )
 {
   bool failed;
@@ -753,5 +845,11 @@ int itkBSplineTransformTest(int, char * [] )
     return EXIT_FAILURE;
     }
 
+  failed = itkBSplineTransformTest4();
+  if( failed )
+    {
+    return EXIT_FAILURE;
+    }
+
   return EXIT_SUCCESS;
 }
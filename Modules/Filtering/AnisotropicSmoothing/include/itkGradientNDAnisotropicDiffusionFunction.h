@@ -86,6 +86,9 @@ public:
 
   typedef SizeValueType NeighborhoodSizeValueType;
 
+  typedef typename ImageType::NeighborhoodAccessorFunctorType NeighborhoodAccessorFunctorType;
+  typedef typename ImageType::InternalPixelType               InternalPixelType;
+
   /** Inherit some parameters from the superclass type. */
   itkStaticConstMacro(ImageDimension, unsigned int, Superclass::ImageDimension);
 
@@ -95,6 +98,24 @@ public:
                                   const FloatOffsetType & offset = FloatOffsetType(0.0)
                                   ) ITK_OVERRIDE;
 
+  /** Returns a structure that carries the conductance modified derivative
+   * between the last pixel and its forward neighbor along the first
+   * dimension, so that the next pixel of the row does not compute it again.
+   * Each thread owns its own structure. */
+  virtual void * GetGlobalDataPointer() const ITK_OVERRIDE
+  {
+    GlobalDataStruct *ans = new GlobalDataStruct();
+    ans->m_Center = ITK_NULLPTR;
+    ans->m_ForwardFlux = NumericTraits< PixelRealType >::ZeroValue();
+    return ans;
+  }
+
+  /** Deletes the structure returned by GetGlobalDataPointer(). */
+  virtual void ReleaseGlobalDataPointer(void *GlobalData) const ITK_OVERRIDE
+  {
+    delete static_cast< GlobalDataStruct * >( GlobalData );
+  }
+
   /** This method is called prior to each iteration of the solver. */
   virtual void InitializeIteration() ITK_OVERRIDE
   {
@@ -125,6 +146,22 @@ protected:
 
   static double m_MIN_NORM;
 
+  /** The conductance modified derivative between the pixel at m_Center and
+   * its forward neighbor along the first dimension. */
+  struct GlobalDataStruct {
+    const InternalPixelType *m_Center;
+    PixelRealType            m_ForwardFlux;
+  };
+
+  /** Reads a neighbor through its pointer when the neighborhood is inside
+   * the image, and with the boundary condition of the iterator otherwise. */
+  PixelType GetNeighbor(const NeighborhoodType & it,
+                        const NeighborhoodAccessorFunctorType & accessor,
+                        bool inside, NeighborhoodSizeValueType n) const
+  {
+    return inside ? accessor.Get( it[n] ) : it.GetPixel(n);
+  }
+
 private:
   GradientNDAnisotropicDiffusionFunction(const Self &) ITK_DELETE_FUNCTION;
   void operator=(const Self &) ITK_DELETE_FUNCTION;
@@ -81,7 +81,7 @@ GradientNDAnisotropicDiffusionFunction< TImage >
 template< typename TImage >
 typename GradientNDAnisotropicDiffusionFunction< TImage >::PixelType
 GradientNDAnisotropicDiffusionFunction< TImage >
-::ComputeUpdate(const NeighborhoodType & it, void *,
+::ComputeUpdate(const NeighborhoodType & it, void *globalData,
                 const FloatOffsetType &)
 {
   unsigned int i, j;
@@ -99,23 +99,65 @@ GradientNDAnisotropicDiffusionFunction< TImage >
   PixelRealType dx_aug;
   PixelRealType dx_dim;
 
+  // Read the center, face and edge neighbors once.  When the neighborhood
+  // is inside the image, they are read through their pointers rather than
+  // with the virtual GetPixel() and its boundary condition.
+  const bool inside = !it.GetNeedToUseBoundaryCondition() || it.InBounds();
+  const NeighborhoodAccessorFunctorType accessor =
+    it.GetImagePointer()->GetNeighborhoodAccessor();
+
+  // The neighbors at +/- one pixel along i, and at +/- one pixel along i
+  // and j.  The neighbor at -i +j is the one at +j -i.
+  PixelType center;
+  PixelType forward[ImageDimension];
+  PixelType backward[ImageDimension];
+  PixelType forwardForward[ImageDimension][ImageDimension];
+  PixelType forwardBackward[ImageDimension][ImageDimension];
+  PixelType backwardBackward[ImageDimension][ImageDimension];
+
+  center = this->GetNeighbor(it, accessor, inside, m_Center);
+  for ( i = 0; i < ImageDimension; i++ )
+    {
+    forward[i] = this->GetNeighbor(it, accessor, inside, m_Center + m_Stride[i]);
+    backward[i] = this->GetNeighbor(it, accessor, inside, m_Center - m_Stride[i]);
+    for ( j = 0; j < i; j++ )
+      {
+      forwardForward[i][j] = forwardForward[j][i] =
+        this->GetNeighbor(it, accessor, inside, m_Center + m_Stride[i] + m_Stride[j]);
+      backwardBackward[i][j] = backwardBackward[j][i] =
+        this->GetNeighbor(it, accessor, inside, m_Center - m_Stride[i] - m_Stride[j]);
+      forwardBackward[i][j] =
+        this->GetNeighbor(it, accessor, inside, m_Center + m_Stride[i] - m_Stride[j]);
+      forwardBackward[j][i] =
+        this->GetNeighbor(it, accessor, inside, m_Center + m_Stride[j] - m_Stride[i]);
+      }
+    }
+
   delta = NumericTraits< PixelRealType >::ZeroValue();
 
   // Calculate the centralized derivatives for each dimension.
   for ( i = 0; i < ImageDimension; i++ )
     {
-    dx[i]  =  ( it.GetPixel(m_Center + m_Stride[i]) - it.GetPixel(m_Center - m_Stride[i]) ) / 2.0f;
+    dx[i]  =  ( forward[i] - backward[i] ) / 2.0f;
     dx[i] *= this->m_ScaleCoefficients[i];
     }
 
+  // The backward derivative along the first dimension is the forward one
+  // of the previous pixel of the row, when this thread has just computed it.
+  // Both read the same pixels, so reusing it does not change the result.
+  GlobalDataStruct *gd = static_cast< GlobalDataStruct * >( globalData );
+  const InternalPixelType *centerPointer = it.GetCenterPointer();
+  const bool reuseBackward = gd != ITK_NULLPTR && inside
+                             && gd->m_Center == centerPointer - 1;
+
   for ( i = 0; i < ImageDimension; i++ )
     {
+    const bool computeBackward = ( i != 0 || !reuseBackward );
+
     // ``Half'' directional derivatives
-    dx_forward = it.GetPixel(m_Center + m_Stride[i])
-                 - it.GetPixel(m_Center);
+    dx_forward = forward[i] - center;
     dx_forward *= this->m_ScaleCoefficients[i];
-    dx_backward =  it.GetPixel(m_Center)
-                  - it.GetPixel(m_Center - m_Stride[i]);
+    dx_backward =  center - backward[i];
     dx_backward *= this->m_ScaleCoefficients[i];
 
     // Calculate the conductance terms.  Conductance varies with each
@@ -127,14 +169,15 @@ GradientNDAnisotropicDiffusionFunction< TImage >
       {
       if ( j != i )
         {
-        dx_aug = ( it.GetPixel(m_Center + m_Stride[i] + m_Stride[j])
-                   - it.GetPixel(m_Center + m_Stride[i] - m_Stride[j]) ) / 2.0f;
+        dx_aug = ( forwardForward[i][j] - forwardBackward[i][j] ) / 2.0f;
         dx_aug *= this->m_ScaleCoefficients[j];
-        dx_dim = ( it.GetPixel(m_Center - m_Stride[i] + m_Stride[j])
-                   - it.GetPixel(m_Center - m_Stride[i] - m_Stride[j]) ) / 2.0f;
-        dx_dim *= this->m_ScaleCoefficients[j];
         accum += 0.25f * vnl_math_sqr(dx[j] + dx_aug);
-        accum_d += 0.25f * vnl_math_sqr(dx[j] + dx_dim);
+        if ( computeBackward )
+          {
+          dx_dim = ( forwardBackward[j][i] - backwardBackward[i][j] ) / 2.0f;
+          dx_dim *= this->m_ScaleCoefficients[j];
+          accum_d += 0.25f * vnl_math_sqr(dx[j] + dx_dim);
+          }
         }
       }
 
@@ -146,12 +189,19 @@ GradientNDAnisotropicDiffusionFunction< TImage >
     else
       {
       Cx = std::exp( ( vnl_math_sqr(dx_forward) + accum )  / m_K );
-      Cxd = std::exp( ( vnl_math_sqr(dx_backward) + accum_d ) / m_K );
+      Cxd = computeBackward ?
+        std::exp( ( vnl_math_sqr(dx_backward) + accum_d ) / m_K ) : 0.0;
       }
 
     // Conductance modified first order derivatives.
     dx_forward  = dx_forward * Cx;
-    dx_backward = dx_backward * Cxd;
+    dx_backward = computeBackward ? dx_backward * Cxd : gd->m_ForwardFlux;
+
+    if ( i == 0 && gd != ITK_NULLPTR )
+      {
+      gd->m_Center = centerPointer;
+      gd->m_ForwardFlux = dx_forward;
+      }
 
     // Conductance modified second order derivative.
     delta += dx_forward - dx_backward;
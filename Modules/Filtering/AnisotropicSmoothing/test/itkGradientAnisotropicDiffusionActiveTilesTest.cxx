@@ -0,0 +1,119 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkGradientAnisotropicDiffusionImageFilter.h"
+#include "itkImageRegionIterator.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+typedef itk::Image< float, 3 >                                             ImageType;
+typedef itk::GradientAnisotropicDiffusionImageFilter< ImageType, ImageType > FilterType;
+
+ImageType::Pointer
+Diffuse( const ImageType * input, bool useActiveTiles, double tolerance )
+{
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( input );
+  filter->SetNumberOfIterations( 10 );
+  filter->SetTimeStep( 0.0625 );
+  filter->SetConductanceParameter( 1.0 );
+  // A fixed conductance keeps the update local
+  filter->SetFixedAverageGradientMagnitude( 10.0 );
+  filter->SetNumberOfThreads( 4 );
+  filter->SetUseActiveTiles( useActiveTiles );
+  filter->SetActiveTileTolerance( tolerance );
+  FilterType::ActiveTileSizeType tileSize;
+  tileSize.Fill( 16 );
+  filter->SetActiveTileSize( tileSize );
+  if( filter->GetUseActiveTiles() != useActiveTiles || filter->GetActiveTileTolerance() != tolerance
+      || filter->GetActiveTileSize() != tileSize )
+    {
+    std::cerr << "Wrong active tile parameters" << std::endl;
+    return ITK_NULLPTR;
+    }
+
+  filter->Update();
+  std::cout << "Active tiles " << ( useActiveTiles ? "on" : "off" ) << ", tolerance " << tolerance << ": "
+            << filter->GetNumberOfActiveTiles() << " active tiles" << std::endl;
+
+  if( useActiveTiles && filter->GetNumberOfActiveTiles() >= 64 )
+    {
+    std::cerr << "The tiles far from the cube are still active" << std::endl;
+    return ITK_NULLPTR;
+    }
+  return filter->GetOutput();
+}
+
+float
+MaximumDifference( ImageType * image1, ImageType * image2 )
+{
+  float maximumDifference = 0.0f;
+  itk::ImageRegionIterator< ImageType > it1( image1, image1->GetLargestPossibleRegion() );
+  itk::ImageRegionIterator< ImageType > it2( image2, image2->GetLargestPossibleRegion() );
+  for(; !it1.IsAtEnd(); ++it1, ++it2 )
+    {
+    maximumDifference = std::max( maximumDifference, std::abs( it1.Get() - it2.Get() ) );
+    }
+  return maximumDifference;
+}
+}
+
+/* Diffuses a bright cube in a corner of a dark volume with and without the
+ * active tiles of DenseFiniteDifferenceImageFilter, and compares the outputs.
+ * The diffusion does not reach most of the 64 tiles of the volume. */
+int itkGradientAnisotropicDiffusionActiveTilesTest( int, char * [] )
+{
+  ImageType::SizeType size;
+  size.Fill( 64 );
+  ImageType::Pointer input = ImageType::New();
+  input->SetRegions( size );
+  input->Allocate();
+  input->FillBuffer( 0.0f );
+
+  ImageType::RegionType cube;
+  cube.GetModifiableIndex().Fill( 4 );
+  cube.GetModifiableSize().Fill( 8 );
+  itk::ImageRegionIterator< ImageType > it( input, cube );
+  for(; !it.IsAtEnd(); ++it )
+    {
+    it.Set( 10.0f );
+    }
+
+  ImageType::Pointer full = Diffuse( input, false, 0.0 );
+  ImageType::Pointer exact = Diffuse( input, true, 0.0 );
+  ImageType::Pointer approximate = Diffuse( input, true, 1e-3 );
+  if( full.IsNull() || exact.IsNull() || approximate.IsNull() )
+    {
+    return EXIT_FAILURE;
+    }
+
+  const float exactDifference = MaximumDifference( full, exact );
+  const float approximateDifference = MaximumDifference( full, approximate );
+  std::cout << "Maximum difference " << exactDifference << " with a null tolerance, "
+            << approximateDifference << " with a tolerance" << std::endl;
+  if( exactDifference > 0.0f || approximateDifference > 1e-2f )
+    {
+    std::cerr << "The outputs with the active tiles differ from the full iteration" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,90 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkBinaryDilateLabelMapFilter_h
+#define itkBinaryDilateLabelMapFilter_h
+
+#include "itkBinaryMorphologyLabelMapFilter.h"
+
+namespace itk
+{
+/** \class BinaryDilateLabelMapFilter
+ * \brief Binary dilation of the objects of a LabelMap
+ *
+ * Each object is dilated by the kernel, on its lines, and cropped to the
+ * largest possible region of the image. The dilated objects do not
+ * overlap: an object does not grow into the other objects, and a pixel
+ * reached by several objects goes to the one with the lowest label.
+ *
+ * \sa BinaryDilateImageFilter BinaryMorphologyLabelMapFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ * \ingroup ITKBinaryMathematicalMorphology
+ */
+template< typename TImage,
+          typename TKernel = FlatStructuringElement< TImage::ImageDimension > >
+class BinaryDilateLabelMapFilter:
+  public BinaryMorphologyLabelMapFilter< TImage, TKernel >
+{
+public:
+  /** Standard class typedefs. */
+  typedef BinaryDilateLabelMapFilter                        Self;
+  typedef BinaryMorphologyLabelMapFilter< TImage, TKernel > Superclass;
+  typedef SmartPointer< Self >                              Pointer;
+  typedef SmartPointer< const Self >                        ConstPointer;
+
+  /** Some convenient typedefs. */
+  typedef typename Superclass::ImageType       ImageType;
+  typedef typename Superclass::RegionType      RegionType;
+  typedef typename Superclass::LabelObjectType LabelObjectType;
+  typedef typename Superclass::KernelType      KernelType;
+
+  /** ImageDimension constants */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TImage::ImageDimension);
+
+  /** Standard New method. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(BinaryDilateLabelMapFilter,
+               BinaryMorphologyLabelMapFilter);
+
+protected:
+  BinaryDilateLabelMapFilter();
+  ~BinaryDilateLabelMapFilter() {}
+
+  virtual void ThreadedProcessLabelObject( LabelObjectType * labelObject ) ITK_OVERRIDE;
+
+  virtual bool AddsPixels() const ITK_OVERRIDE
+  {
+    return true;
+  }
+
+private:
+  BinaryDilateLabelMapFilter(const Self &) ITK_DELETE_FUNCTION;
+  void operator=(const Self &) ITK_DELETE_FUNCTION;
+
+  typedef typename Superclass::LineContainerType LineContainerType;
+}; // end of class
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkBinaryDilateLabelMapFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,45 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkBinaryDilateLabelMapFilter_hxx
+#define itkBinaryDilateLabelMapFilter_hxx
+
+#include "itkBinaryDilateLabelMapFilter.h"
+
+namespace itk
+{
+template< typename TImage, typename TKernel >
+BinaryDilateLabelMapFilter< TImage, TKernel >
+::BinaryDilateLabelMapFilter()
+{
+}
+
+template< typename TImage, typename TKernel >
+void
+BinaryDilateLabelMapFilter< TImage, TKernel >
+::ThreadedProcessLabelObject( LabelObjectType * labelObject )
+{
+  LineContainerType lines;
+  LineContainerType dilated;
+  LineContainerType clipped;
+  this->GetLines( labelObject, lines );
+  this->Dilate( lines, this->GetOutput()->GetLargestPossibleRegion(), dilated );
+  this->ClipToInput( lines, dilated, clipped );
+  this->SetLines( labelObject, clipped );
+}
+} // end namespace itk
+#endif
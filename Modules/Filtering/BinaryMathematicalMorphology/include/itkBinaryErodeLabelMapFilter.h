@@ -0,0 +1,93 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkBinaryErodeLabelMapFilter_h
+#define itkBinaryErodeLabelMapFilter_h
+
+#include "itkBinaryMorphologyLabelMapFilter.h"
+
+namespace itk
+{
+/** \class BinaryErodeLabelMapFilter
+ * \brief Binary erosion of the objects of a LabelMap
+ *
+ * Each object is eroded by the kernel, on its lines. The objects which
+ * become empty are removed.
+ *
+ * \sa BinaryErodeImageFilter BinaryMorphologyLabelMapFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ * \ingroup ITKBinaryMathematicalMorphology
+ */
+template< typename TImage,
+          typename TKernel = FlatStructuringElement< TImage::ImageDimension > >
+class BinaryErodeLabelMapFilter:
+  public BinaryMorphologyLabelMapFilter< TImage, TKernel >
+{
+public:
+  /** Standard class typedefs. */
+  typedef BinaryErodeLabelMapFilter                         Self;
+  typedef BinaryMorphologyLabelMapFilter< TImage, TKernel > Superclass;
+  typedef SmartPointer< Self >                              Pointer;
+  typedef SmartPointer< const Self >                        ConstPointer;
+
+  /** Some convenient typedefs. */
+  typedef typename Superclass::ImageType       ImageType;
+  typedef typename Superclass::RegionType      RegionType;
+  typedef typename Superclass::LabelObjectType LabelObjectType;
+  typedef typename Superclass::KernelType      KernelType;
+
+  /** ImageDimension constants */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TImage::ImageDimension);
+
+  /** Standard New method. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(BinaryErodeLabelMapFilter,
+               BinaryMorphologyLabelMapFilter);
+
+  /** Get/Set whether the pixels outside the image are in the objects
+   * (true) or not (false). Defaults to true. */
+  itkSetMacro(BoundaryToForeground, bool);
+  itkGetConstReferenceMacro(BoundaryToForeground, bool);
+  itkBooleanMacro(BoundaryToForeground);
+
+protected:
+  BinaryErodeLabelMapFilter();
+  ~BinaryErodeLabelMapFilter() {}
+
+  virtual void ThreadedProcessLabelObject( LabelObjectType * labelObject ) ITK_OVERRIDE;
+
+  void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+private:
+  BinaryErodeLabelMapFilter(const Self &) ITK_DELETE_FUNCTION;
+  void operator=(const Self &) ITK_DELETE_FUNCTION;
+
+  typedef typename Superclass::LineContainerType LineContainerType;
+
+  bool m_BoundaryToForeground;
+}; // end of class
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkBinaryErodeLabelMapFilter.hxx"
+#endif
+
+#endif
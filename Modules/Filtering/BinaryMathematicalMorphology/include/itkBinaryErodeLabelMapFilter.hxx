@@ -0,0 +1,54 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkBinaryErodeLabelMapFilter_hxx
+#define itkBinaryErodeLabelMapFilter_hxx
+
+#include "itkBinaryErodeLabelMapFilter.h"
+
+namespace itk
+{
+template< typename TImage, typename TKernel >
+BinaryErodeLabelMapFilter< TImage, TKernel >
+::BinaryErodeLabelMapFilter()
+{
+  m_BoundaryToForeground = true;
+}
+
+template< typename TImage, typename TKernel >
+void
+BinaryErodeLabelMapFilter< TImage, TKernel >
+::ThreadedProcessLabelObject( LabelObjectType * labelObject )
+{
+  LineContainerType lines;
+  LineContainerType eroded;
+  this->GetLines( labelObject, lines );
+  this->Erode( lines, this->GetOutput()->GetLargestPossibleRegion(), m_BoundaryToForeground, eroded );
+  this->SetLines( labelObject, eroded );
+}
+
+template< typename TImage, typename TKernel >
+void
+BinaryErodeLabelMapFilter< TImage, TKernel >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "BoundaryToForeground: " << m_BoundaryToForeground << std::endl;
+}
+} // end namespace itk
+#endif
@@ -0,0 +1,105 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkBinaryMorphologicalClosingLabelMapFilter_h
+#define itkBinaryMorphologicalClosingLabelMapFilter_h
+
+#include "itkBinaryMorphologyLabelMapFilter.h"
+
+namespace itk
+{
+/** \class BinaryMorphologicalClosingLabelMapFilter
+ * \brief Binary morphological closing of the objects of a LabelMap
+ *
+ * Each object is dilated and then eroded by the kernel, on its lines. As
+ * in BinaryMorphologicalClosingImageFilter, when SafeBorder is true the
+ * dilation is not cropped to the image, so the objects close to the border
+ * of the image are not eroded by the border; when it is false the pixels
+ * outside the image are in the objects during the erosion. The pixels of
+ * the objects are always kept in the result. The closed objects do not
+ * overlap: the pixels added to an object are clipped against the other
+ * objects, and a pixel added to several objects goes to the one with the
+ * lowest label.
+ *
+ * \sa BinaryMorphologicalClosingImageFilter BinaryMorphologyLabelMapFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ * \ingroup ITKBinaryMathematicalMorphology
+ */
+template< typename TImage,
+          typename TKernel = FlatStructuringElement< TImage::ImageDimension > >
+class BinaryMorphologicalClosingLabelMapFilter:
+  public BinaryMorphologyLabelMapFilter< TImage, TKernel >
+{
+public:
+  /** Standard class typedefs. */
+  typedef BinaryMorphologicalClosingLabelMapFilter          Self;
+  typedef BinaryMorphologyLabelMapFilter< TImage, TKernel > Superclass;
+  typedef SmartPointer< Self >                              Pointer;
+  typedef SmartPointer< const Self >                        ConstPointer;
+
+  /** Some convenient typedefs. */
+  typedef typename Superclass::ImageType       ImageType;
+  typedef typename Superclass::RegionType      RegionType;
+  typedef typename Superclass::LabelObjectType LabelObjectType;
+  typedef typename Superclass::KernelType      KernelType;
+
+  /** ImageDimension constants */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TImage::ImageDimension);
+
+  /** Standard New method. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(BinaryMorphologicalClosingLabelMapFilter,
+               BinaryMorphologyLabelMapFilter);
+
+  /** A safe border is added to the image during the computation of the
+   * closing. Defaults to true. */
+  itkSetMacro(SafeBorder, bool);
+  itkGetConstReferenceMacro(SafeBorder, bool);
+  itkBooleanMacro(SafeBorder);
+
+protected:
+  BinaryMorphologicalClosingLabelMapFilter();
+  ~BinaryMorphologicalClosingLabelMapFilter() {}
+
+  virtual void ThreadedProcessLabelObject( LabelObjectType * labelObject ) ITK_OVERRIDE;
+
+  virtual bool AddsPixels() const ITK_OVERRIDE
+  {
+    return true;
+  }
+
+  void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+private:
+  BinaryMorphologicalClosingLabelMapFilter(const Self &) ITK_DELETE_FUNCTION;
+  void operator=(const Self &) ITK_DELETE_FUNCTION;
+
+  typedef typename Superclass::LineContainerType LineContainerType;
+
+  bool m_SafeBorder;
+}; // end of class
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkBinaryMorphologicalClosingLabelMapFilter.hxx"
+#endif
+
+#endif
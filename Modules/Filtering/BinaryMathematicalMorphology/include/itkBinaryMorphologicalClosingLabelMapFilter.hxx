@@ -0,0 +1,76 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkBinaryMorphologicalClosingLabelMapFilter_hxx
+#define itkBinaryMorphologicalClosingLabelMapFilter_hxx
+
+#include "itkBinaryMorphologicalClosingLabelMapFilter.h"
+
+namespace itk
+{
+template< typename TImage, typename TKernel >
+BinaryMorphologicalClosingLabelMapFilter< TImage, TKernel >
+::BinaryMorphologicalClosingLabelMapFilter()
+{
+  m_SafeBorder = true;
+}
+
+template< typename TImage, typename TKernel >
+void
+BinaryMorphologicalClosingLabelMapFilter< TImage, TKernel >
+::ThreadedProcessLabelObject( LabelObjectType * labelObject )
+{
+  const RegionType region = this->GetOutput()->GetLargestPossibleRegion();
+
+  LineContainerType lines;
+  LineContainerType dilated;
+  LineContainerType closed;
+  this->GetLines( labelObject, lines );
+  if ( m_SafeBorder )
+    {
+    // the image is padded by the radius of the kernel, so the erosion
+    // never reaches the border, and the result is cropped
+    RegionType paddedRegion = region;
+    paddedRegion.PadByRadius( this->GetKernel().GetRadius() );
+    this->Dilate( lines, paddedRegion, dilated );
+    this->Erode( dilated, paddedRegion, true, closed );
+    this->Crop( closed, region );
+    }
+  else
+    {
+    this->Dilate( lines, region, dilated );
+    this->Erode( dilated, region, true, closed );
+    }
+
+  // as in BinaryMorphologicalClosingImageFilter, the pixels of the object
+  // are kept, even if the kernel is not symmetric
+  this->Union( closed, lines, dilated );
+  this->ClipToInput( lines, dilated, closed );
+  this->SetLines( labelObject, closed );
+}
+
+template< typename TImage, typename TKernel >
+void
+BinaryMorphologicalClosingLabelMapFilter< TImage, TKernel >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "SafeBorder: " << m_SafeBorder << std::endl;
+}
+} // end namespace itk
+#endif
@@ -0,0 +1,85 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkBinaryMorphologicalOpeningLabelMapFilter_h
+#define itkBinaryMorphologicalOpeningLabelMapFilter_h
+
+#include "itkBinaryMorphologyLabelMapFilter.h"
+
+namespace itk
+{
+/** \class BinaryMorphologicalOpeningLabelMapFilter
+ * \brief Binary morphological opening of the objects of a LabelMap
+ *
+ * Each object is eroded and then dilated by the kernel, on its lines. As
+ * in BinaryMorphologicalOpeningImageFilter, the pixels outside the image
+ * are in the objects during the erosion. The objects which become empty
+ * are removed.
+ *
+ * \sa BinaryMorphologicalOpeningImageFilter BinaryMorphologyLabelMapFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ * \ingroup ITKBinaryMathematicalMorphology
+ */
+template< typename TImage,
+          typename TKernel = FlatStructuringElement< TImage::ImageDimension > >
+class BinaryMorphologicalOpeningLabelMapFilter:
+  public BinaryMorphologyLabelMapFilter< TImage, TKernel >
+{
+public:
+  /** Standard class typedefs. */
+  typedef BinaryMorphologicalOpeningLabelMapFilter          Self;
+  typedef BinaryMorphologyLabelMapFilter< TImage, TKernel > Superclass;
+  typedef SmartPointer< Self >                              Pointer;
+  typedef SmartPointer< const Self >                        ConstPointer;
+
+  /** Some convenient typedefs. */
+  typedef typename Superclass::ImageType       ImageType;
+  typedef typename Superclass::RegionType      RegionType;
+  typedef typename Superclass::LabelObjectType LabelObjectType;
+  typedef typename Superclass::KernelType      KernelType;
+
+  /** ImageDimension constants */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TImage::ImageDimension);
+
+  /** Standard New method. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(BinaryMorphologicalOpeningLabelMapFilter,
+               BinaryMorphologyLabelMapFilter);
+
+protected:
+  BinaryMorphologicalOpeningLabelMapFilter();
+  ~BinaryMorphologicalOpeningLabelMapFilter() {}
+
+  virtual void ThreadedProcessLabelObject( LabelObjectType * labelObject ) ITK_OVERRIDE;
+
+private:
+  BinaryMorphologicalOpeningLabelMapFilter(const Self &) ITK_DELETE_FUNCTION;
+  void operator=(const Self &) ITK_DELETE_FUNCTION;
+
+  typedef typename Superclass::LineContainerType LineContainerType;
+}; // end of class
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkBinaryMorphologicalOpeningLabelMapFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,46 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkBinaryMorphologicalOpeningLabelMapFilter_hxx
+#define itkBinaryMorphologicalOpeningLabelMapFilter_hxx
+
+#include "itkBinaryMorphologicalOpeningLabelMapFilter.h"
+
+namespace itk
+{
+template< typename TImage, typename TKernel >
+BinaryMorphologicalOpeningLabelMapFilter< TImage, TKernel >
+::BinaryMorphologicalOpeningLabelMapFilter()
+{
+}
+
+template< typename TImage, typename TKernel >
+void
+BinaryMorphologicalOpeningLabelMapFilter< TImage, TKernel >
+::ThreadedProcessLabelObject( LabelObjectType * labelObject )
+{
+  const RegionType region = this->GetOutput()->GetLargestPossibleRegion();
+
+  LineContainerType lines;
+  LineContainerType eroded;
+  this->GetLines( labelObject, lines );
+  this->Erode( lines, region, true, eroded );
+  this->Dilate( eroded, region, lines );
+  this->SetLines( labelObject, lines );
+}
+} // end namespace itk
+#endif
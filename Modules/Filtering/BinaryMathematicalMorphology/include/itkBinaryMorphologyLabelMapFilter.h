@@ -0,0 +1,249 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkBinaryMorphologyLabelMapFilter_h
+#define itkBinaryMorphologyLabelMapFilter_h
+
+#include "itkInPlaceLabelMapFilter.h"
+#include "itkFlatStructuringElement.h"
+#include "itkLabelMapLineClipper.h"
+#include <vector>
+
+namespace itk
+{
+/** \class BinaryMorphologyLabelMapFilter
+ * \brief Base class for the binary morphology filters working on the lines
+ * of the objects of a LabelMap
+ *
+ * A LabelMap stores each object as a set of lines, i.e. a run length
+ * encoding of the object along the first dimension. The subclasses of this
+ * filter compute the dilation, erosion, opening or closing of every object
+ * of the LabelMap directly on its lines, without ever building an image:
+ * their cost depends on the number of lines of the objects and on the
+ * number of rows of the structuring element, not on the number of pixels
+ * in the image. They are much faster than the image filters on large
+ * images with sparse objects.
+ *
+ * The structuring element is decomposed in intervals along the first
+ * dimension: a line of an object and an interval of the structuring
+ * element give a single line of the dilated object, and the erosion of a
+ * line is the intersection of the shifted lines of its neighbors.
+ *
+ * Each object is processed independently of the others, as a binary image
+ * where the pixels of the object are in the foreground, and the objects
+ * are processed in parallel. A binary image is converted to a LabelMap
+ * with a single object with LabelImageToLabelMapFilter and converted back
+ * with LabelMapToBinaryImageFilter. BinaryImageToLabelMapFilter would
+ * split the image in connected components, and the erosion of the
+ * components is not the erosion of their union. The objects which become
+ * empty are removed from the output.
+ *
+ * The filters which add pixels to the objects, the dilation and the
+ * closing, then clip the added pixels against the other objects, so the
+ * output objects do not overlap: an object only grows into the pixels
+ * which are in no object of the input, and a pixel reached by several
+ * objects goes to the one with the lowest label. The pixels removed by
+ * the erosion and the opening are not given to the other objects.
+ *
+ * With a single object, the results are the same as the ones of
+ * BinaryDilateImageFilter, BinaryErodeImageFilter,
+ * BinaryMorphologicalOpeningImageFilter and
+ * BinaryMorphologicalClosingImageFilter with the same kernel.
+ *
+ * \sa BinaryMorphologyImageFilter LabelImageToLabelMapFilter LabelMapToBinaryImageFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ * \ingroup ITKBinaryMathematicalMorphology
+ */
+template< typename TImage,
+          typename TKernel = FlatStructuringElement< TImage::ImageDimension > >
+class BinaryMorphologyLabelMapFilter:
+  public InPlaceLabelMapFilter< TImage >
+{
+public:
+  /** Standard class typedefs. */
+  typedef BinaryMorphologyLabelMapFilter  Self;
+  typedef InPlaceLabelMapFilter< TImage > Superclass;
+  typedef SmartPointer< Self >            Pointer;
+  typedef SmartPointer< const Self >      ConstPointer;
+
+  /** Some convenient typedefs. */
+  typedef TImage                              ImageType;
+  typedef typename ImageType::Pointer         ImagePointer;
+  typedef typename ImageType::ConstPointer    ImageConstPointer;
+  typedef typename ImageType::PixelType       PixelType;
+  typedef typename ImageType::IndexType       IndexType;
+  typedef typename ImageType::OffsetType      OffsetType;
+  typedef typename ImageType::RegionType      RegionType;
+  typedef typename ImageType::LabelObjectType LabelObjectType;
+  typedef typename LabelObjectType::LineType  LineType;
+
+  /** Kernel typedef. */
+  typedef TKernel                       KernelType;
+  typedef typename KernelType::SizeType RadiusType;
+
+  /** ImageDimension constants */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TImage::ImageDimension);
+
+  /** Standard New method. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(BinaryMorphologyLabelMapFilter,
+               InPlaceLabelMapFilter);
+
+  /** Set/Get the kernel (structuring element). The elements of the kernel
+   * greater than zero are in the structuring element. */
+  void SetKernel(const KernelType & kernel);
+  itkGetConstReferenceMacro(Kernel, KernelType);
+
+  /** Set the kernel to a box of the given radius. */
+  void SetRadius(const RadiusType & radius);
+  void SetRadius(const SizeValueType & radius);
+
+protected:
+  BinaryMorphologyLabelMapFilter();
+  ~BinaryMorphologyLabelMapFilter() {}
+
+  /** Process the objects, then remove the empty ones. */
+  virtual void GenerateData() ITK_OVERRIDE;
+
+  /** Store the lines of the objects when the filter adds pixels to them. */
+  virtual void BeforeThreadedGenerateData() ITK_OVERRIDE;
+
+  /** Give the pixels added to several objects to one of them. */
+  virtual void AfterThreadedGenerateData() ITK_OVERRIDE;
+
+  void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+  typedef LabelMapLineClipper< ImageType >        ClipperType;
+  typedef typename ClipperType::LineContainerType LineContainerType;
+
+  /** Returns true in the subclasses which add pixels to the objects. They
+   * must pass the lines they compute through ClipToInput(). */
+  virtual bool AddsPixels() const
+  {
+    return false;
+  }
+
+  /** Remove from the lines computed for an object the pixels of the other
+   * objects of the input. */
+  void ClipToInput(const LineContainerType & input, const LineContainerType & lines,
+                   LineContainerType & output) const;
+
+  /** Copy the lines of the object, sorted and without overlap. */
+  void GetLines(LabelObjectType *labelObject, LineContainerType & lines) const;
+
+  /** Replace the lines of the object. */
+  void SetLines(LabelObjectType *labelObject, const LineContainerType & lines) const;
+
+  /** Dilate the lines with the kernel, and crop the result to the
+   * region. The input lines must be sorted and must not overlap, and so
+   * are the output lines. */
+  void Dilate(const LineContainerType & input, const RegionType & region,
+              LineContainerType & output) const;
+
+  /** Erode the lines with the kernel, inside the region. The pixels
+   * outside the region are in the foreground if boundaryToForeground is
+   * true. The input lines must be sorted and must not overlap, and so
+   * are the output lines. */
+  void Erode(const LineContainerType & input, const RegionType & region,
+             bool boundaryToForeground, LineContainerType & output) const;
+
+  /** Remove the parts of the lines outside the region. */
+  void Crop(LineContainerType & lines, const RegionType & region) const;
+
+  /** Union of two sets of lines. The input lines must be sorted and must
+   * not overlap, and so are the output lines. */
+  static void Union(const LineContainerType & lines1, const LineContainerType & lines2,
+                    LineContainerType & output);
+
+private:
+  BinaryMorphologyLabelMapFilter(const Self &) ITK_DELETE_FUNCTION;
+  void operator=(const Self &) ITK_DELETE_FUNCTION;
+
+  template< typename T > void MakeKernel(const RadiusType & radius, T & kernel)
+  {
+    kernel.SetRadius(radius);
+    for ( typename T::Iterator kit = kernel.Begin(); kit != kernel.End(); kit++ )
+      {
+      *kit = 1;
+      }
+  }
+
+  void MakeKernel(const RadiusType & radius, FlatStructuringElement< ImageDimension > & kernel)
+  {
+    kernel = FlatStructuringElement< ImageDimension >::Box(radius);
+  }
+
+  /** An interval of the kernel along the first dimension: the offsets
+   * Offset + (i, 0, ..., 0) for i in [Begin, End]. The first component of
+   * Offset is zero. */
+  struct KernelLine
+  {
+    OffsetType      Offset;
+    OffsetValueType Begin;
+    OffsetValueType End;
+  };
+  typedef std::vector< KernelLine > KernelLineContainerType;
+
+  /** Orders the lines by their position in the dimensions greater than
+   * zero only. */
+  struct LinePositionComparator
+  {
+    bool operator()(const LineType & l1, const LineType & l2) const
+    {
+      for ( int i = ImageDimension - 1; i > 0; i-- )
+        {
+        if ( l1.GetIndex()[i] != l2.GetIndex()[i] )
+          {
+          return l1.GetIndex()[i] < l2.GetIndex()[i];
+          }
+        }
+      return false;
+    }
+  };
+
+  /** Intervals [first, second] along the first dimension. */
+  typedef std::pair< OffsetValueType, OffsetValueType > IntervalType;
+  typedef std::vector< IntervalType >                   IntervalContainerType;
+
+  /** Append the line [begin, end] at index to the lines, merging it with
+   * the last line if they touch. */
+  static void AppendLine(LineContainerType & lines, IndexType index, OffsetValueType begin,
+                         OffsetValueType end);
+
+  /** Intersection of two sorted lists of disjoint intervals. */
+  static void Intersect(const IntervalContainerType & intervals1, const IntervalContainerType & intervals2,
+                        IntervalContainerType & output);
+
+  /** Erode the line at position, the first component being ignored. */
+  void ErodeLine(const LineContainerType & input, const RegionType & region, bool boundaryToForeground,
+                 const IndexType & position, LineContainerType & output) const;
+
+  KernelType              m_Kernel;
+  KernelLineContainerType m_KernelLines;
+  bool                    m_KernelContainsCenter;
+  ClipperType             m_Clipper;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkBinaryMorphologyLabelMapFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,498 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkBinaryMorphologyLabelMapFilter_hxx
+#define itkBinaryMorphologyLabelMapFilter_hxx
+
+#include "itkBinaryMorphologyLabelMapFilter.h"
+#include "itkLabelObjectLineComparator.h"
+#include <algorithm>
+
+namespace itk
+{
+template< typename TImage, typename TKernel >
+BinaryMorphologyLabelMapFilter< TImage, TKernel >
+::BinaryMorphologyLabelMapFilter():
+  m_KernelContainsCenter( false )
+{
+  this->SetRadius( 1UL );
+}
+
+template< typename TImage, typename TKernel >
+void
+BinaryMorphologyLabelMapFilter< TImage, TKernel >
+::SetKernel(const KernelType & kernel)
+{
+  m_Kernel = kernel;
+
+  // group the offsets of the kernel in intervals along the first dimension.
+  // The neighborhood is ordered along the first dimension first, so the
+  // offsets of an interval are consecutive.
+  m_KernelLines.clear();
+  m_KernelContainsCenter = false;
+  for ( unsigned int i = 0; i < kernel.Size(); i++ )
+    {
+    if ( !( kernel[i] > NumericTraits< typename KernelType::PixelType >::ZeroValue() ) )
+      {
+      continue;
+      }
+    OffsetType offset = kernel.GetOffset(i);
+    if ( offset == OffsetType() )
+      {
+      m_KernelContainsCenter = true;
+      }
+    const OffsetValueType x = offset[0];
+    offset[0] = 0;
+    if ( !m_KernelLines.empty() && m_KernelLines.back().Offset == offset && m_KernelLines.back().End + 1 == x )
+      {
+      m_KernelLines.back().End = x;
+      }
+    else
+      {
+      KernelLine kernelLine;
+      kernelLine.Offset = offset;
+      kernelLine.Begin = x;
+      kernelLine.End = x;
+      m_KernelLines.push_back(kernelLine);
+      }
+    }
+
+  this->Modified();
+}
+
+template< typename TImage, typename TKernel >
+void
+BinaryMorphologyLabelMapFilter< TImage, TKernel >
+::SetRadius(const RadiusType & radius)
+{
+  KernelType kernel;
+  this->MakeKernel(radius, kernel);
+  this->SetKernel(kernel);
+}
+
+template< typename TImage, typename TKernel >
+void
+BinaryMorphologyLabelMapFilter< TImage, TKernel >
+::SetRadius(const SizeValueType & radius)
+{
+  RadiusType rad;
+  rad.Fill(radius);
+  this->SetRadius(rad);
+}
+
+template< typename TImage, typename TKernel >
+void
+BinaryMorphologyLabelMapFilter< TImage, TKernel >
+::GenerateData()
+{
+  Superclass::GenerateData();
+
+  ImageType *output = this->GetOutput();
+
+  // the objects can't be removed while they are processed by the threads
+  std::vector< PixelType > emptyLabels;
+  for ( typename ImageType::Iterator it( output ); !it.IsAtEnd(); ++it )
+    {
+    if ( it.GetLabelObject()->Empty() )
+      {
+      emptyLabels.push_back( it.GetLabel() );
+      }
+    }
+  for ( typename std::vector< PixelType >::const_iterator lit = emptyLabels.begin(); lit != emptyLabels.end(); ++lit )
+    {
+    output->RemoveLabel(*lit);
+    }
+}
+
+template< typename TImage, typename TKernel >
+void
+BinaryMorphologyLabelMapFilter< TImage, TKernel >
+::BeforeThreadedGenerateData()
+{
+  Superclass::BeforeThreadedGenerateData();
+
+  if ( this->AddsPixels() )
+    {
+    m_Clipper.Initialize( this->GetOutput() );
+    }
+}
+
+template< typename TImage, typename TKernel >
+void
+BinaryMorphologyLabelMapFilter< TImage, TKernel >
+::AfterThreadedGenerateData()
+{
+  if ( this->AddsPixels() )
+    {
+    m_Clipper.Resolve( this->GetOutput() );
+    }
+
+  Superclass::AfterThreadedGenerateData();
+}
+
+template< typename TImage, typename TKernel >
+void
+BinaryMorphologyLabelMapFilter< TImage, TKernel >
+::ClipToInput(const LineContainerType & input, const LineContainerType & lines, LineContainerType & output) const
+{
+  m_Clipper.ClipToInput( input, lines, output );
+}
+
+template< typename TImage, typename TKernel >
+void
+BinaryMorphologyLabelMapFilter< TImage, TKernel >
+::GetLines(LabelObjectType *labelObject, LineContainerType & lines) const
+{
+  labelObject->Optimize();
+  lines.clear();
+  lines.reserve( labelObject->GetNumberOfLines() );
+  for ( SizeValueType i = 0; i < labelObject->GetNumberOfLines(); i++ )
+    {
+    lines.push_back( labelObject->GetLine(i) );
+    }
+}
+
+template< typename TImage, typename TKernel >
+void
+BinaryMorphologyLabelMapFilter< TImage, TKernel >
+::SetLines(LabelObjectType *labelObject, const LineContainerType & lines) const
+{
+  labelObject->Clear();
+  for ( typename LineContainerType::const_iterator it = lines.begin(); it != lines.end(); ++it )
+    {
+    labelObject->AddLine(*it);
+    }
+}
+
+template< typename TImage, typename TKernel >
+void
+BinaryMorphologyLabelMapFilter< TImage, TKernel >
+::AppendLine(LineContainerType & lines, IndexType index, OffsetValueType begin, OffsetValueType end)
+{
+  if ( !lines.empty() )
+    {
+    LineType & last = lines.back();
+    const OffsetValueType lastBegin = last.GetIndex()[0];
+    const OffsetValueType lastEnd = lastBegin + static_cast< OffsetValueType >( last.GetLength() ) - 1;
+    bool samePosition = true;
+    for ( unsigned int i = 1; i < ImageDimension; i++ )
+      {
+      samePosition = samePosition && last.GetIndex()[i] == index[i];
+      }
+    if ( samePosition && begin <= lastEnd + 1 )
+      {
+      last.SetLength( std::max( lastEnd, end ) - lastBegin + 1 );
+      return;
+      }
+    }
+  index[0] = begin;
+  lines.push_back( LineType( index, end - begin + 1 ) );
+}
+
+template< typename TImage, typename TKernel >
+void
+BinaryMorphologyLabelMapFilter< TImage, TKernel >
+::Intersect(const IntervalContainerType & intervals1, const IntervalContainerType & intervals2,
+            IntervalContainerType & output)
+{
+  output.clear();
+  typename IntervalContainerType::const_iterator it1 = intervals1.begin();
+  typename IntervalContainerType::const_iterator it2 = intervals2.begin();
+  while ( it1 != intervals1.end() && it2 != intervals2.end() )
+    {
+    const OffsetValueType begin = std::max( it1->first, it2->first );
+    const OffsetValueType end = std::min( it1->second, it2->second );
+    if ( begin <= end )
+      {
+      output.push_back( IntervalType( begin, end ) );
+      }
+    // move forward the interval which ends first
+    if ( it1->second < it2->second )
+      {
+      ++it1;
+      }
+    else
+      {
+      ++it2;
+      }
+    }
+}
+
+template< typename TImage, typename TKernel >
+void
+BinaryMorphologyLabelMapFilter< TImage, TKernel >
+::Dilate(const LineContainerType & input, const RegionType & region, LineContainerType & output) const
+{
+  output.clear();
+
+  const IndexType regionBegin = region.GetIndex();
+  const IndexType regionEnd = region.GetUpperIndex();
+
+  // each line of the input and each line of the kernel give a line of the
+  // output. As in BinaryDilateImageFilter, the kernel is not reflected.
+  LineContainerType lines;
+  lines.reserve( input.size() * m_KernelLines.size() );
+  for ( typename LineContainerType::const_iterator it = input.begin(); it != input.end(); ++it )
+    {
+    const IndexType &     lineIndex = it->GetIndex();
+    const OffsetValueType lineEnd = lineIndex[0] + static_cast< OffsetValueType >( it->GetLength() ) - 1;
+    for ( typename KernelLineContainerType::const_iterator kit = m_KernelLines.begin(); kit != m_KernelLines.end();
+          ++kit )
+      {
+      IndexType index = lineIndex + kit->Offset;
+      bool      inside = true;
+      for ( unsigned int i = 1; i < ImageDimension; i++ )
+        {
+        inside = inside && index[i] >= regionBegin[i] && index[i] <= regionEnd[i];
+        }
+      const OffsetValueType begin = std::max( lineIndex[0] + kit->Begin, regionBegin[0] );
+      const OffsetValueType end = std::min( lineEnd + kit->End, regionEnd[0] );
+      if ( inside && begin <= end )
+        {
+        index[0] = begin;
+        lines.push_back( LineType( index, end - begin + 1 ) );
+        }
+      }
+    }
+
+  // sort and merge the lines
+  std::sort( lines.begin(), lines.end(), Functor::LabelObjectLineComparator< LineType >() );
+  output.reserve( lines.size() );
+  for ( typename LineContainerType::const_iterator it = lines.begin(); it != lines.end(); ++it )
+    {
+    AppendLine( output, it->GetIndex(), it->GetIndex()[0],
+                it->GetIndex()[0] + static_cast< OffsetValueType >( it->GetLength() ) - 1 );
+    }
+}
+
+template< typename TImage, typename TKernel >
+void
+BinaryMorphologyLabelMapFilter< TImage, TKernel >
+::Erode(const LineContainerType & input, const RegionType & region, bool boundaryToForeground,
+        LineContainerType & output) const
+{
+  output.clear();
+  if ( region.GetNumberOfPixels() == 0 )
+    {
+    return;
+    }
+
+  if ( m_KernelContainsCenter )
+    {
+    // the eroded object is included in the input one: only the positions
+    // of the input lines have to be considered
+    typename LineContainerType::const_iterator it = input.begin();
+    while ( it != input.end() )
+      {
+      const IndexType position = it->GetIndex();
+      this->ErodeLine( input, region, boundaryToForeground, position, output );
+      do
+        {
+        ++it;
+        }
+      while ( it != input.end() && !LinePositionComparator()( LineType( position, 1 ), *it ) );
+      }
+    }
+  else
+    {
+    // any line of the region may be in the eroded object
+    const IndexType regionBegin = region.GetIndex();
+    const IndexType regionEnd = region.GetUpperIndex();
+    IndexType       position = regionBegin;
+    while ( true )
+      {
+      this->ErodeLine( input, region, boundaryToForeground, position, output );
+      unsigned int i = 1;
+      for (; i < ImageDimension; i++ )
+        {
+        if ( ++position[i] <= regionEnd[i] )
+          {
+          break;
+          }
+        position[i] = regionBegin[i];
+        }
+      if ( i >= ImageDimension )
+        {
+        break;
+        }
+      }
+    }
+}
+
+template< typename TImage, typename TKernel >
+void
+BinaryMorphologyLabelMapFilter< TImage, TKernel >
+::ErodeLine(const LineContainerType & input, const RegionType & region, bool boundaryToForeground,
+            const IndexType & position, LineContainerType & output) const
+{
+  const IndexType regionBegin = region.GetIndex();
+  const IndexType regionEnd = region.GetUpperIndex();
+
+  for ( unsigned int i = 1; i < ImageDimension; i++ )
+    {
+    if ( position[i] < regionBegin[i] || position[i] > regionEnd[i] )
+      {
+      return;
+      }
+    }
+
+  // a pixel is in the eroded object if the translation of the reflected
+  // kernel on that pixel is included in the object: for each line of the
+  // kernel, the pixels of the line are in one of the input lines at the
+  // matching position
+  IntervalContainerType result( 1, IntervalType( regionBegin[0], regionEnd[0] ) );
+  IntervalContainerType allowed;
+  IntervalContainerType intersection;
+  for ( typename KernelLineContainerType::const_iterator kit = m_KernelLines.begin(); kit != m_KernelLines.end();
+        ++kit )
+    {
+    const IndexType neighbor = position - kit->Offset;
+    bool            inside = true;
+    for ( unsigned int i = 1; i < ImageDimension; i++ )
+      {
+      inside = inside && neighbor[i] >= regionBegin[i] && neighbor[i] <= regionEnd[i];
+      }
+    if ( !inside )
+      {
+      if ( boundaryToForeground )
+        {
+        continue;
+        }
+      result.clear();
+      break;
+      }
+
+    // the input lines at that position, with the outside of the region
+    // when it is in the foreground
+    IntervalContainerType lines;
+    if ( boundaryToForeground )
+      {
+      lines.push_back( IntervalType( std::min( regionBegin[0] - kit->End, regionBegin[0] - 1 ), regionBegin[0] - 1 ) );
+      }
+    std::pair< typename LineContainerType::const_iterator, typename LineContainerType::const_iterator > range =
+      std::equal_range( input.begin(), input.end(), LineType( neighbor, 1 ), LinePositionComparator() );
+    for ( typename LineContainerType::const_iterator it = range.first; it != range.second; ++it )
+      {
+      const OffsetValueType begin = it->GetIndex()[0];
+      const OffsetValueType end = begin + static_cast< OffsetValueType >( it->GetLength() ) - 1;
+      if ( !lines.empty() && begin <= lines.back().second + 1 )
+        {
+        lines.back().second = std::max( lines.back().second, end );
+        }
+      else
+        {
+        lines.push_back( IntervalType( begin, end ) );
+        }
+      }
+    if ( boundaryToForeground )
+      {
+      const OffsetValueType begin = regionEnd[0] + 1;
+      const OffsetValueType end = std::max( regionEnd[0] - kit->Begin, regionEnd[0] + 1 );
+      if ( !lines.empty() && begin <= lines.back().second + 1 )
+        {
+        lines.back().second = std::max( lines.back().second, end );
+        }
+      else
+        {
+        lines.push_back( IntervalType( begin, end ) );
+        }
+      }
+
+    // the pixels x such that [x - End, x - Begin] is included in a line
+    allowed.clear();
+    for ( typename IntervalContainerType::const_iterator it = lines.begin(); it != lines.end(); ++it )
+      {
+      if ( it->first + kit->End <= it->second + kit->Begin )
+        {
+        allowed.push_back( IntervalType( it->first + kit->End, it->second + kit->Begin ) );
+        }
+      }
+
+    Intersect( result, allowed, intersection );
+    result.swap( intersection );
+    if ( result.empty() )
+      {
+      break;
+      }
+    }
+
+  for ( typename IntervalContainerType::const_iterator it = result.begin(); it != result.end(); ++it )
+    {
+    AppendLine( output, position, it->first, it->second );
+    }
+}
+
+template< typename TImage, typename TKernel >
+void
+BinaryMorphologyLabelMapFilter< TImage, TKernel >
+::Crop(LineContainerType & lines, const RegionType & region) const
+{
+  const IndexType regionBegin = region.GetIndex();
+  const IndexType regionEnd = region.GetUpperIndex();
+
+  LineContainerType cropped;
+  cropped.reserve( lines.size() );
+  for ( typename LineContainerType::const_iterator it = lines.begin(); it != lines.end(); ++it )
+    {
+    IndexType index = it->GetIndex();
+    bool      inside = true;
+    for ( unsigned int i = 1; i < ImageDimension; i++ )
+      {
+      inside = inside && index[i] >= regionBegin[i] && index[i] <= regionEnd[i];
+      }
+    const OffsetValueType begin = std::max( index[0], regionBegin[0] );
+    const OffsetValueType end = std::min( index[0] + static_cast< OffsetValueType >( it->GetLength() ) - 1,
+                                          regionEnd[0] );
+    if ( inside && begin <= end )
+      {
+      index[0] = begin;
+      cropped.push_back( LineType( index, end - begin + 1 ) );
+      }
+    }
+  lines.swap( cropped );
+}
+
+template< typename TImage, typename TKernel >
+void
+BinaryMorphologyLabelMapFilter< TImage, TKernel >
+::Union(const LineContainerType & lines1, const LineContainerType & lines2, LineContainerType & output)
+{
+  output.clear();
+  output.reserve( lines1.size() + lines2.size() );
+  typename LineContainerType::const_iterator it1 = lines1.begin();
+  typename LineContainerType::const_iterator it2 = lines2.begin();
+  Functor::LabelObjectLineComparator< LineType > comparator;
+  while ( it1 != lines1.end() || it2 != lines2.end() )
+    {
+    const LineType & line = ( it2 == lines2.end() || ( it1 != lines1.end() && comparator( *it1, *it2 ) ) )
+                            ? *it1++ : *it2++;
+    AppendLine( output, line.GetIndex(), line.GetIndex()[0],
+                line.GetIndex()[0] + static_cast< OffsetValueType >( line.GetLength() ) - 1 );
+    }
+}
+
+template< typename TImage, typename TKernel >
+void
+BinaryMorphologyLabelMapFilter< TImage, TKernel >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Kernel: " << m_Kernel << std::endl;
+}
+} // end namespace itk
+#endif
@@ -0,0 +1,357 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBinaryDilateLabelMapFilter.h"
+#include "itkBinaryErodeLabelMapFilter.h"
+#include "itkBinaryMorphologicalOpeningLabelMapFilter.h"
+#include "itkBinaryMorphologicalClosingLabelMapFilter.h"
+#include "itkBinaryDilateImageFilter.h"
+#include "itkBinaryErodeImageFilter.h"
+#include "itkBinaryMorphologicalOpeningImageFilter.h"
+#include "itkBinaryMorphologicalClosingImageFilter.h"
+#include "itkLabelImageToLabelMapFilter.h"
+#include "itkLabelMapToBinaryImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+#include <cmath>
+
+namespace
+{
+
+const unsigned int Dimension = 3;
+
+typedef itk::Image< unsigned char, Dimension >             ImageType;
+typedef itk::LabelMap< itk::LabelObject< unsigned char, Dimension > > LabelMapType;
+typedef itk::FlatStructuringElement< Dimension >           KernelType;
+
+/* Runs the label map filter on the label map of the image and checks the
+ * result against the output of the image filter. */
+template< typename TLabelMapFilter, typename TImageFilter >
+bool
+CheckFilter( const ImageType *image, TLabelMapFilter *labelMapFilter, TImageFilter *imageFilter,
+             const char *name )
+{
+  typedef itk::LabelImageToLabelMapFilter< ImageType, LabelMapType > LabelizerType;
+  typedef itk::LabelMapToBinaryImageFilter< LabelMapType, ImageType > BinarizerType;
+
+  typename LabelizerType::Pointer labelizer = LabelizerType::New();
+  labelizer->SetInput( image );
+  labelizer->SetBackgroundValue( 0 );
+
+  labelMapFilter->SetInput( labelizer->GetOutput() );
+  labelMapFilter->SetNumberOfThreads( 2 );
+
+  typename BinarizerType::Pointer binarizer = BinarizerType::New();
+  binarizer->SetInput( labelMapFilter->GetOutput() );
+  binarizer->SetForegroundValue( 1 );
+  binarizer->SetBackgroundValue( 0 );
+  TRY_EXPECT_NO_EXCEPTION( binarizer->Update() );
+
+  imageFilter->SetInput( image );
+  imageFilter->SetForegroundValue( 1 );
+  TRY_EXPECT_NO_EXCEPTION( imageFilter->Update() );
+
+  itk::ImageRegionConstIteratorWithIndex< ImageType > it( binarizer->GetOutput(),
+    image->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< ImageType > rit( imageFilter->GetOutput(), image->GetLargestPossibleRegion() );
+  for(; !it.IsAtEnd(); ++it, ++rit )
+    {
+    if( it.Get() != rit.Get() )
+      {
+      std::cerr << name << ": mismatch at " << it.GetIndex() << ": expected "
+                << static_cast< int >( rit.Get() ) << ", got " << static_cast< int >( it.Get() ) << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+/* Runs the label map filter on the label map of a label image with several
+ * objects, and checks that the output objects do not overlap, and that
+ * each pixel is in the object which contains it in the input, or else in
+ * the object with the lowest label whose result with the image filter
+ * contains it. */
+template< typename TLabelMapFilter, typename TImageFilter >
+bool
+CheckLabels( const ImageType *labels, TLabelMapFilter *labelMapFilter, TImageFilter *imageFilter,
+             const char *name )
+{
+  typedef itk::LabelImageToLabelMapFilter< ImageType, LabelMapType > LabelizerType;
+
+  const ImageType::RegionType region = labels->GetLargestPossibleRegion();
+
+  typename LabelizerType::Pointer labelizer = LabelizerType::New();
+  labelizer->SetInput( labels );
+  labelizer->SetBackgroundValue( 0 );
+
+  labelMapFilter->SetInput( labelizer->GetOutput() );
+  labelMapFilter->SetNumberOfThreads( 2 );
+  TRY_EXPECT_NO_EXCEPTION( labelMapFilter->Update() );
+
+  // the label of each pixel in the output, or 255 if several objects
+  // contain it
+  ImageType::Pointer output = ImageType::New();
+  output->SetRegions( region );
+  output->Allocate();
+  output->FillBuffer( 0 );
+  const LabelMapType *labelMap = labelMapFilter->GetOutput();
+  for( LabelMapType::ConstIterator lit( labelMap ); !lit.IsAtEnd(); ++lit )
+    {
+    const LabelMapType::LabelObjectType *labelObject = lit.GetLabelObject();
+    for( itk::SizeValueType l = 0; l < labelObject->GetNumberOfLines(); l++ )
+      {
+      ImageType::IndexType index = labelObject->GetLine( l ).GetIndex();
+      for( itk::SizeValueType i = 0; i < labelObject->GetLine( l ).GetLength(); i++, index[0]++ )
+        {
+        output->SetPixel( index, output->GetPixel( index ) == 0 ? lit.GetLabel() : 255 );
+        }
+      }
+    }
+
+  // the expected labels
+  ImageType::Pointer expected = ImageType::New();
+  expected->SetRegions( region );
+  expected->Allocate();
+  itk::ImageRegionConstIterator< ImageType > lit( labels, region );
+  itk::ImageRegionIterator< ImageType >      eit( expected, region );
+  for(; !lit.IsAtEnd(); ++lit, ++eit )
+    {
+    eit.Set( lit.Get() );
+    }
+  for( LabelMapType::ConstIterator it( labelizer->GetOutput() ); !it.IsAtEnd(); ++it )
+    {
+    ImageType::Pointer object = ImageType::New();
+    object->SetRegions( region );
+    object->Allocate();
+    itk::ImageRegionIterator< ImageType > oit( object, region );
+    for( lit.GoToBegin(); !lit.IsAtEnd(); ++lit, ++oit )
+      {
+      oit.Set( lit.Get() == it.GetLabel() ? 1 : 0 );
+      }
+
+    imageFilter->SetInput( object );
+    imageFilter->SetForegroundValue( 1 );
+    TRY_EXPECT_NO_EXCEPTION( imageFilter->Update() );
+    itk::ImageRegionConstIterator< ImageType > rit( imageFilter->GetOutput(), region );
+    for( eit.GoToBegin(); !eit.IsAtEnd(); ++eit, ++rit )
+      {
+      if( eit.Get() == 0 && rit.Get() == 1 )
+        {
+        eit.Set( it.GetLabel() );
+        }
+      }
+    }
+
+  itk::ImageRegionConstIteratorWithIndex< ImageType > oit( output, region );
+  for( eit.GoToBegin(); !oit.IsAtEnd(); ++oit, ++eit )
+    {
+    if( oit.Get() != eit.Get() )
+      {
+      std::cerr << name << ": mismatch at " << oit.GetIndex() << ": expected label "
+                << static_cast< int >( eit.Get() ) << ", got " << static_cast< int >( oit.Get() ) << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+}
+
+/* Dilates, erodes, opens and closes a sparse 3D binary image with several
+ * kernels, including an asymmetric one, and checks the results against
+ * the image filters. */
+int itkBinaryMorphologyLabelMapFilterTest( int, char * [] )
+{
+  ImageType::IndexType start;
+  start[0] = -5;
+  start[1] = 3;
+  start[2] = 1;
+  ImageType::SizeType size;
+  size[0] = 47;
+  size[1] = 31;
+  size[2] = 19;
+  ImageType::RegionType region( start, size );
+
+  // Blobs, and a lattice of isolated pixels starting on the border of the
+  // image
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( region );
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, region );
+  for(; !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType index = it.GetIndex();
+    const bool                 blob =
+      std::sin( 0.3 * index[0] ) * std::cos( 0.25 * index[1] ) + std::sin( 0.4 * index[2] ) > 1.2;
+    const bool dot = ( index[0] - start[0] ) % 9 == 0 && ( index[1] - start[1] ) % 6 == 0
+                     && ( index[2] - start[2] ) % 6 == 0;
+    it.Set( ( blob || dot ) ? 1 : 0 );
+    }
+
+  // Kernels: a box, a ball and an asymmetric one
+  std::vector< KernelType > kernels;
+  KernelType::RadiusType    radius;
+  radius[0] = 2;
+  radius[1] = 1;
+  radius[2] = 1;
+  kernels.push_back( KernelType::Box( radius ) );
+  radius.Fill( 2 );
+  kernels.push_back( KernelType::Ball( radius ) );
+  KernelType asymmetric = KernelType::Box( radius );
+  for( unsigned int i = 0; i < asymmetric.Size(); i++ )
+    {
+    const KernelType::OffsetType offset = asymmetric.GetOffset( i );
+    asymmetric[i] = offset[0] >= -1 && offset[1] <= offset[0] && offset[2] != 1 && ( offset[1] != -2 || offset[0] > 0 );
+    }
+  kernels.push_back( asymmetric );
+
+  for( unsigned int k = 0; k < kernels.size(); k++ )
+    {
+    const KernelType & kernel = kernels[k];
+
+    typedef itk::BinaryDilateLabelMapFilter< LabelMapType > DilateType;
+    typedef itk::BinaryDilateImageFilter< ImageType, ImageType, KernelType > ReferenceDilateType;
+    DilateType::Pointer dilate = DilateType::New();
+    EXERCISE_BASIC_OBJECT_METHODS( dilate, BinaryDilateLabelMapFilter );
+    dilate->SetKernel( kernel );
+    ReferenceDilateType::Pointer referenceDilate = ReferenceDilateType::New();
+    referenceDilate->SetKernel( kernel );
+    if( !CheckFilter( image.GetPointer(), dilate.GetPointer(), referenceDilate.GetPointer(), "Dilate" ) )
+      {
+      return EXIT_FAILURE;
+      }
+
+    for( unsigned int boundaryToForeground = 0; boundaryToForeground < 2; boundaryToForeground++ )
+      {
+      typedef itk::BinaryErodeLabelMapFilter< LabelMapType > ErodeType;
+      typedef itk::BinaryErodeImageFilter< ImageType, ImageType, KernelType > ReferenceErodeType;
+      ErodeType::Pointer erode = ErodeType::New();
+      EXERCISE_BASIC_OBJECT_METHODS( erode, BinaryErodeLabelMapFilter );
+      erode->SetKernel( kernel );
+      erode->SetBoundaryToForeground( boundaryToForeground != 0 );
+      ReferenceErodeType::Pointer referenceErode = ReferenceErodeType::New();
+      referenceErode->SetKernel( kernel );
+      referenceErode->SetBoundaryToForeground( boundaryToForeground != 0 );
+      if( !CheckFilter( image.GetPointer(), erode.GetPointer(), referenceErode.GetPointer(), "Erode" ) )
+        {
+        return EXIT_FAILURE;
+        }
+      }
+
+    typedef itk::BinaryMorphologicalOpeningLabelMapFilter< LabelMapType > OpeningType;
+    typedef itk::BinaryMorphologicalOpeningImageFilter< ImageType, ImageType, KernelType > ReferenceOpeningType;
+    OpeningType::Pointer opening = OpeningType::New();
+    EXERCISE_BASIC_OBJECT_METHODS( opening, BinaryMorphologicalOpeningLabelMapFilter );
+    opening->SetKernel( kernel );
+    ReferenceOpeningType::Pointer referenceOpening = ReferenceOpeningType::New();
+    referenceOpening->SetKernel( kernel );
+    if( !CheckFilter( image.GetPointer(), opening.GetPointer(), referenceOpening.GetPointer(), "Opening" ) )
+      {
+      return EXIT_FAILURE;
+      }
+
+    for( unsigned int safeBorder = 0; safeBorder < 2; safeBorder++ )
+      {
+      typedef itk::BinaryMorphologicalClosingLabelMapFilter< LabelMapType > ClosingType;
+      typedef itk::BinaryMorphologicalClosingImageFilter< ImageType, ImageType, KernelType > ReferenceClosingType;
+      ClosingType::Pointer closing = ClosingType::New();
+      EXERCISE_BASIC_OBJECT_METHODS( closing, BinaryMorphologicalClosingLabelMapFilter );
+      closing->SetKernel( kernel );
+      closing->SetSafeBorder( safeBorder != 0 );
+      ReferenceClosingType::Pointer referenceClosing = ReferenceClosingType::New();
+      referenceClosing->SetKernel( kernel );
+      referenceClosing->SetSafeBorder( safeBorder != 0 );
+      if( !CheckFilter( image.GetPointer(), closing.GetPointer(), referenceClosing.GetPointer(), "Closing" ) )
+        {
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  // A cell with a nucleus inside it, and another object touching the cell.
+  // The dilation and the closing keep the objects disjoint.
+  ImageType::Pointer labels = ImageType::New();
+  labels->SetRegions( region );
+  labels->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > lit( labels, region );
+  for(; !lit.IsAtEnd(); ++lit )
+    {
+    const ImageType::IndexType index = lit.GetIndex();
+    itk::OffsetValueType       distance = 0;
+    for( unsigned int i = 0; i < Dimension; i++ )
+      {
+      distance = std::max( distance, std::abs( index[i] - start[i] - 9 ) );
+      }
+    unsigned char label = 0;
+    if( distance >= 6 && distance <= 8 )
+      {
+      label = 2;
+      }
+    else if( distance <= 3 )
+      {
+      label = 5;
+      }
+    else if( index[0] - start[0] >= 18 && index[0] - start[0] <= 23
+             && std::abs( index[1] - start[1] - 9 ) <= 3 && std::abs( index[2] - start[2] - 7 ) <= 3 )
+      {
+      label = 1;
+      }
+    lit.Set( label );
+    }
+
+  typedef itk::BinaryDilateLabelMapFilter< LabelMapType > DilateType;
+  typedef itk::BinaryDilateImageFilter< ImageType, ImageType, KernelType > ReferenceDilateType;
+  DilateType::Pointer dilate = DilateType::New();
+  dilate->SetKernel( kernels[0] );
+  ReferenceDilateType::Pointer referenceDilate = ReferenceDilateType::New();
+  referenceDilate->SetKernel( kernels[0] );
+  if( !CheckLabels( labels.GetPointer(), dilate.GetPointer(), referenceDilate.GetPointer(), "Dilate labels" ) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  typedef itk::BinaryMorphologicalClosingLabelMapFilter< LabelMapType > ClosingType;
+  typedef itk::BinaryMorphologicalClosingImageFilter< ImageType, ImageType, KernelType > ReferenceClosingType;
+  radius.Fill( 3 );
+  ClosingType::Pointer closing = ClosingType::New();
+  closing->SetKernel( KernelType::Box( radius ) );
+  ReferenceClosingType::Pointer referenceClosing = ReferenceClosingType::New();
+  referenceClosing->SetKernel( KernelType::Box( radius ) );
+  if( !CheckLabels( labels.GetPointer(), closing.GetPointer(), referenceClosing.GetPointer(), "Closing labels" ) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // The objects removed by the erosion are removed from the label map
+  typedef itk::LabelImageToLabelMapFilter< ImageType, LabelMapType > LabelizerType;
+  LabelizerType::Pointer labelizer = LabelizerType::New();
+  labelizer->SetInput( image );
+  typedef itk::BinaryErodeLabelMapFilter< LabelMapType > ErodeType;
+  ErodeType::Pointer erode = ErodeType::New();
+  erode->SetInput( labelizer->GetOutput() );
+  erode->SetRadius( 10 );
+  TRY_EXPECT_NO_EXCEPTION( erode->Update() );
+  if( erode->GetOutput()->GetNumberOfLabelObjects() != 0 )
+    {
+    std::cerr << "The eroded object was not removed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -19,7 +19,11 @@
 #define itkComposeDisplacementFieldsImageFilter_h
 
 #include "itkImageToImageFilter.h"
+#include "itkImageRegionSplitterDirection.h"
 #include "itkVectorInterpolateImageFunction.h"
+#include "itkVectorLinearInterpolateImageFunction.h"
+
+#include <vector>
 
 namespace itk
 {
@@ -29,6 +33,22 @@ namespace itk
  *
  * \brief Compose two displacement fields.
  *
+ * The output at a point x of the warping field grid is w(x) + u(x + w(x)),
+ * with w the warping field and u the displacement field, evaluated with the
+ * interpolator. With the default linear interpolator, u is interpolated
+ * directly from the displacement field buffer, all components at once, and
+ * the continuous index of x + w(x) is computed from matrices precomputed
+ * once per update instead of through physical points.
+ *
+ * The composed field can optionally be smoothed with a Gaussian kernel of
+ * variance GaussianSmoothingVarianceForTheComposedField (in pixel units,
+ * as in GaussianSmoothingOnUpdateDisplacementFieldTransform). The
+ * smoothing runs separably and in place on the output buffer, so the
+ * composition and the smoothing together write a single field, where
+ * composing and then smoothing with VectorNeighborhoodOperatorImageFilter
+ * would allocate one field per pass. Image borders use a zero flux
+ * Neumann boundary condition.
+ *
  * \author Nick Tustison
  * \author Brian Avants
  *
@@ -72,6 +92,8 @@ public:
   typedef typename VectorType::ComponentType      RealType;
   typedef VectorInterpolateImageFunction
     <InputFieldType, RealType>                    InterpolatorType;
+  typedef VectorLinearInterpolateImageFunction
+    <InputFieldType, RealType>                    DefaultInterpolatorType;
 
   /** Get the interpolator. */
   itkGetModifiableObjectMacro( Interpolator, InterpolatorType );
@@ -120,6 +142,11 @@ public:
   /* Set the interpolator. */
   virtual void SetInterpolator( InterpolatorType* interpolator );
 
+  /** Set/Get the variance of the Gaussian smoothing applied to the composed
+   * field, in pixel units. Zero (the default) disables the smoothing. */
+  itkSetMacro( GaussianSmoothingVarianceForTheComposedField, RealType );
+  itkGetConstMacro( GaussianSmoothingVarianceForTheComposedField, RealType );
+
 protected:
 
   /** Constructor */
@@ -137,6 +164,21 @@ protected:
   /** Multithreaded function which generates the output field. */
   void ThreadedGenerateData( const RegionType &, ThreadIdType ) ITK_OVERRIDE;
 
+  /** Smooth the composed field if requested. */
+  void AfterThreadedGenerateData() ITK_OVERRIDE;
+
+  /** The smoothing passes must not split the output along the smoothing
+   * direction. */
+  virtual const ImageRegionSplitterBase* GetImageRegionSplitter() const ITK_OVERRIDE;
+
+  /** Composition with the linear interpolation done in place on the
+   * displacement field buffer. */
+  void LinearThreadedGenerateData( const RegionType & );
+
+  /** Convolve the output lines along m_SmoothingDirection with
+   * m_SmoothingKernel, in place. */
+  void ThreadedSmoothAlongDirection( const RegionType & );
+
 private:
   ComposeDisplacementFieldsImageFilter( const Self& ) ITK_DELETE_FUNCTION;
   void operator=( const Self& ) ITK_DELETE_FUNCTION;
@@ -144,6 +186,15 @@ private:
   /** The interpolator. */
   typename InterpolatorType::Pointer             m_Interpolator;
 
+  RealType                                       m_GaussianSmoothingVarianceForTheComposedField;
+
+  // internal ivars necessary for multithreading basic operations
+
+  bool                                           m_UseLinearInterpolationKernel;
+  unsigned int                                   m_SmoothingDirection;
+  std::vector<double>                            m_SmoothingKernel;
+  ImageRegionSplitterDirection::Pointer          m_ImageRegionSplitter;
+
 };
 
 } // end namespace itk
@@ -20,9 +20,12 @@
 
 #include "itkComposeDisplacementFieldsImageFilter.h"
 
+#include "itkGaussianOperator.h"
+#include "itkImageLinearIteratorWithIndex.h"
 #include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkImageRegionIterator.h"
-#include "itkVectorLinearInterpolateImageFunction.h"
+#include "itkImageScanlineIterator.h"
+#include "itkMath.h"
 
 namespace itk
 {
@@ -32,11 +35,14 @@ namespace itk
  */
 template<typename InputImage, typename TOutputImage>
 ComposeDisplacementFieldsImageFilter<InputImage, TOutputImage>
-::ComposeDisplacementFieldsImageFilter()
+::ComposeDisplacementFieldsImageFilter() :
+  m_GaussianSmoothingVarianceForTheComposedField( 0.0 ),
+  m_UseLinearInterpolationKernel( false ),
+  m_SmoothingDirection( ImageDimension ),
+  m_ImageRegionSplitter( ImageRegionSplitterDirection::New() )
 {
   this->SetNumberOfRequiredInputs( 2 );
 
-  typedef VectorLinearInterpolateImageFunction<InputFieldType, RealType> DefaultInterpolatorType;
   typename DefaultInterpolatorType::Pointer interpolator = DefaultInterpolatorType::New();
   this->m_Interpolator = interpolator;
 }
@@ -69,14 +75,29 @@ void
 ComposeDisplacementFieldsImageFilter<InputImage, TOutputImage>
 ::BeforeThreadedGenerateData()
 {
-  VectorType zeroVector( 0.0 );
-
-  this->GetOutput()->FillBuffer( zeroVector );
-
+  // Every output pixel is written by ThreadedGenerateData, so the output
+  // is not initialized here.
   if( !this->m_Interpolator->GetInputImage() )
     {
     itkExceptionMacro( "Displacement field not set in interpolator." );
     }
+
+  this->m_UseLinearInterpolationKernel =
+    ( dynamic_cast<const DefaultInterpolatorType *>( this->m_Interpolator.GetPointer() ) != ITK_NULLPTR &&
+      this->m_Interpolator->GetInputImage() == this->GetDisplacementField() );
+  this->m_SmoothingDirection = ImageDimension;
+}
+
+template<typename InputImage, typename TOutputImage>
+const ImageRegionSplitterBase*
+ComposeDisplacementFieldsImageFilter<InputImage, TOutputImage>
+::GetImageRegionSplitter() const
+{
+  if( this->m_SmoothingDirection < ImageDimension )
+    {
+    return this->m_ImageRegionSplitter.GetPointer();
+    }
+  return Superclass::GetImageRegionSplitter();
 }
 
 template<typename InputImage, typename TOutputImage>
@@ -84,6 +105,17 @@ void
 ComposeDisplacementFieldsImageFilter<InputImage, TOutputImage>
 ::ThreadedGenerateData( const RegionType & region, ThreadIdType itkNotUsed( threadId ) )
 {
+  if( this->m_SmoothingDirection < ImageDimension )
+    {
+    this->ThreadedSmoothAlongDirection( region );
+    return;
+    }
+  if( this->m_UseLinearInterpolationKernel )
+    {
+    this->LinearThreadedGenerateData( region );
+    return;
+    }
+
   typename OutputFieldType::Pointer output = this->GetOutput();
   typename InputFieldType::ConstPointer warpingField = this->GetWarpingField();
 
@@ -124,6 +156,270 @@ ComposeDisplacementFieldsImageFilter<InputImage, TOutputImage>
     }
 }
 
+template<typename InputImage, typename TOutputImage>
+void
+ComposeDisplacementFieldsImageFilter<InputImage, TOutputImage>
+::LinearThreadedGenerateData( const RegionType & region )
+{
+  OutputFieldType *output = this->GetOutput();
+  const InputFieldType *warpingField = this->GetWarpingField();
+  const InputFieldType *displacementField = this->GetDisplacementField();
+
+  typedef typename InputFieldType::PixelType  InputPixelType;
+  typedef typename OutputFieldType::PixelType OutputPixelType;
+  typedef typename OutputPixelType::ValueType OutputValueType;
+
+  // The continuous index in the displacement field of x + w(x), with x the
+  // physical point of a warping field index, is
+  //   indexToIndex * index + originOffset + physicalToIndex * w(x).
+  const typename InputFieldType::DirectionType & warpingDirection = warpingField->GetDirection();
+  const typename InputFieldType::DirectionType & inverseDirection = displacementField->GetInverseDirection();
+  const typename InputFieldType::SpacingType & warpingSpacing = warpingField->GetSpacing();
+  const typename InputFieldType::SpacingType & displacementSpacing = displacementField->GetSpacing();
+
+  double physicalToIndex[ImageDimension][ImageDimension];
+  double indexToIndex[ImageDimension][ImageDimension];
+  double originOffset[ImageDimension];
+  for( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    for( unsigned int j = 0; j < ImageDimension; j++ )
+      {
+      physicalToIndex[i][j] = inverseDirection[i][j] / displacementSpacing[i];
+      }
+    }
+  for( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    originOffset[i] = 0.0;
+    for( unsigned int j = 0; j < ImageDimension; j++ )
+      {
+      indexToIndex[i][j] = 0.0;
+      for( unsigned int k = 0; k < ImageDimension; k++ )
+        {
+        indexToIndex[i][j] += physicalToIndex[i][k] * warpingDirection[k][j] * warpingSpacing[j];
+        }
+      originOffset[i] += physicalToIndex[i][j] *
+        ( warpingField->GetOrigin()[j] - displacementField->GetOrigin()[j] );
+      }
+    }
+
+  // Buffer bounds, with the half pixel margin of ImageFunction::IsInsideBuffer()
+  const typename InputFieldType::RegionType & bufferedRegion = displacementField->GetBufferedRegion();
+  const InputPixelType *buffer = displacementField->GetBufferPointer();
+  const OffsetValueType *offsetTable = displacementField->GetOffsetTable();
+  IndexValueType startIndex[ImageDimension];
+  IndexValueType endIndex[ImageDimension];
+  double         startContinuousIndex[ImageDimension];
+  double         endContinuousIndex[ImageDimension];
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    startIndex[d] = bufferedRegion.GetIndex()[d];
+    endIndex[d] = startIndex[d] + static_cast<IndexValueType>( bufferedRegion.GetSize()[d] ) - 1;
+    startContinuousIndex[d] = startIndex[d] - 0.5;
+    endContinuousIndex[d] = endIndex[d] + 0.5;
+    }
+
+  typedef ImageScanlineConstIterator<InputFieldType> WarpingIteratorType;
+  typedef ImageScanlineIterator<OutputFieldType>     OutputIteratorType;
+  WarpingIteratorType ItW( warpingField, region );
+  OutputIteratorType  ItF( output, region );
+
+  const unsigned int numberOfNeighbors = 1u << ImageDimension;
+
+  double          lineStart[ImageDimension];
+  double          continuousIndex[ImageDimension];
+  OffsetValueType neighborOffset[ImageDimension][2];
+  double          neighborWeight[ImageDimension][2];
+  double          displacement[ImageDimension];
+  OutputPixelType outDisplacement;
+
+  while( !ItW.IsAtEnd() )
+    {
+    const IndexType index = ItW.GetIndex();
+    for( unsigned int i = 0; i < ImageDimension; i++ )
+      {
+      lineStart[i] = originOffset[i];
+      for( unsigned int j = 0; j < ImageDimension; j++ )
+        {
+        lineStart[i] += indexToIndex[i][j] * index[j];
+        }
+      }
+
+    SizeValueType n = 0;
+    while( !ItW.IsAtEndOfLine() )
+      {
+      const InputPixelType & warpVector = ItW.Get();
+
+      bool isInside = true;
+      for( unsigned int i = 0; i < ImageDimension; i++ )
+        {
+        continuousIndex[i] = lineStart[i] + indexToIndex[i][0] * n;
+        for( unsigned int j = 0; j < ImageDimension; j++ )
+          {
+          continuousIndex[i] += physicalToIndex[i][j] * warpVector[j];
+          }
+        // Test for negative of a positive so we can catch NaN's.
+        if( !( continuousIndex[i] >= startContinuousIndex[i] &&
+               continuousIndex[i] < endContinuousIndex[i] ) )
+          {
+          isInside = false;
+          }
+        }
+
+      for( unsigned int d = 0; d < ImageDimension; d++ )
+        {
+        displacement[d] = 0.0;
+        }
+
+      if( isInside )
+        {
+        // Offsets and weights of the lower and upper neighbors along each
+        // dimension, clamped to the buffer as in
+        // VectorLinearInterpolateImageFunction.
+        for( unsigned int d = 0; d < ImageDimension; d++ )
+          {
+          const IndexValueType baseIndex = Math::Floor<IndexValueType>( continuousIndex[d] );
+          const double distance = continuousIndex[d] - static_cast<double>( baseIndex );
+
+          const IndexValueType lower = std::max( baseIndex, startIndex[d] );
+          const IndexValueType upper = std::min( baseIndex + 1, endIndex[d] );
+          neighborOffset[d][0] = ( lower - startIndex[d] ) * offsetTable[d];
+          neighborOffset[d][1] = ( upper - startIndex[d] ) * offsetTable[d];
+          neighborWeight[d][0] = 1.0 - distance;
+          neighborWeight[d][1] = distance;
+          }
+
+        for( unsigned int counter = 0; counter < numberOfNeighbors; counter++ )
+          {
+          OffsetValueType offset = 0;
+          double          overlap = 1.0;
+          for( unsigned int d = 0; d < ImageDimension; d++ )
+            {
+            const unsigned int upper = ( counter >> d ) & 1u;
+            offset += neighborOffset[d][upper];
+            overlap *= neighborWeight[d][upper];
+            }
+          const InputPixelType & neighbor = buffer[offset];
+          for( unsigned int d = 0; d < ImageDimension; d++ )
+            {
+            displacement[d] += overlap * static_cast<double>( neighbor[d] );
+            }
+          }
+        }
+
+      for( unsigned int d = 0; d < ImageDimension; d++ )
+        {
+        outDisplacement[d] = static_cast<OutputValueType>( warpVector[d] + displacement[d] );
+        }
+      ItF.Set( outDisplacement );
+
+      ++ItW;
+      ++ItF;
+      ++n;
+      }
+    ItW.NextLine();
+    ItF.NextLine();
+    }
+}
+
+template<typename InputImage, typename TOutputImage>
+void
+ComposeDisplacementFieldsImageFilter<InputImage, TOutputImage>
+::AfterThreadedGenerateData()
+{
+  if( this->m_GaussianSmoothingVarianceForTheComposedField <= 0.0 )
+    {
+    return;
+    }
+
+  OutputFieldType *output = this->GetOutput();
+
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    GaussianOperator<double, ImageDimension> gaussianOperator;
+    gaussianOperator.SetDirection( d );
+    gaussianOperator.SetVariance( this->m_GaussianSmoothingVarianceForTheComposedField );
+    gaussianOperator.SetMaximumError( 0.001 );
+    gaussianOperator.SetMaximumKernelWidth( output->GetRequestedRegion().GetSize()[d] );
+    gaussianOperator.CreateDirectional();
+
+    // The operator is one dimensional, so its buffer holds the kernel
+    this->m_SmoothingKernel.resize( gaussianOperator.Size() );
+    for( unsigned int k = 0; k < gaussianOperator.Size(); k++ )
+      {
+      this->m_SmoothingKernel[k] = gaussianOperator[k];
+      }
+
+    this->m_SmoothingDirection = d;
+    this->m_ImageRegionSplitter->SetDirection( d );
+
+    typename ImageSource<TOutputImage>::ThreadStruct str;
+    str.Filter = this;
+    this->GetMultiThreader()->SetNumberOfThreads( this->GetNumberOfThreads() );
+    this->GetMultiThreader()->SetSingleMethod( this->ThreaderCallback, &str );
+    this->GetMultiThreader()->SingleMethodExecute();
+    }
+
+  this->m_SmoothingDirection = ImageDimension;
+}
+
+template<typename InputImage, typename TOutputImage>
+void
+ComposeDisplacementFieldsImageFilter<InputImage, TOutputImage>
+::ThreadedSmoothAlongDirection( const RegionType & region )
+{
+  typedef typename OutputFieldType::PixelType OutputPixelType;
+  typedef typename OutputPixelType::ValueType OutputValueType;
+
+  const unsigned int direction = this->m_SmoothingDirection;
+  const std::vector<double> & kernel = this->m_SmoothingKernel;
+  const SizeValueType radius = kernel.size() / 2;
+  const SizeValueType lineLength = region.GetSize()[direction];
+  const unsigned int  numberOfComponents = OutputPixelType::Dimension;
+
+  // Each line is copied to a buffer padded with its end values (zero flux
+  // Neumann boundary), then convolved back into the output.
+  std::vector<OutputPixelType> line( lineLength + 2 * radius );
+  double                       sum[OutputPixelType::Dimension];
+  OutputPixelType              smoothed;
+
+  ImageLinearIteratorWithIndex<OutputFieldType> It( this->GetOutput(), region );
+  It.SetDirection( direction );
+  for( It.GoToBegin(); !It.IsAtEnd(); It.NextLine() )
+    {
+    for( SizeValueType i = 0; i < lineLength; i++, ++It )
+      {
+      line[radius + i] = It.Get();
+      }
+    for( SizeValueType r = 0; r < radius; r++ )
+      {
+      line[r] = line[radius];
+      line[radius + lineLength + r] = line[radius + lineLength - 1];
+      }
+
+    It.GoToBeginOfLine();
+    for( SizeValueType i = 0; i < lineLength; i++, ++It )
+      {
+      for( unsigned int c = 0; c < numberOfComponents; c++ )
+        {
+        sum[c] = 0.0;
+        }
+      for( SizeValueType k = 0; k < kernel.size(); k++ )
+        {
+        const OutputPixelType & value = line[i + k];
+        for( unsigned int c = 0; c < numberOfComponents; c++ )
+          {
+          sum[c] += kernel[k] * value[c];
+          }
+        }
+      for( unsigned int c = 0; c < numberOfComponents; c++ )
+        {
+        smoothed[c] = static_cast<OutputValueType>( sum[c] );
+        }
+      It.Set( smoothed );
+      }
+    }
+}
+
 template<typename InputImage, typename TOutputImage>
 void
 ComposeDisplacementFieldsImageFilter<InputImage, TOutputImage>
@@ -131,6 +427,8 @@ ComposeDisplacementFieldsImageFilter<InputImage, TOutputImage>
 {
   Superclass::PrintSelf( os, indent );
   itkPrintSelfObjectMacro( Interpolator );
+  os << indent << "Gaussian smoothing variance for the composed field: "
+     << this->m_GaussianSmoothingVarianceForTheComposedField << std::endl;
 }
 
 }  //end namespace itk
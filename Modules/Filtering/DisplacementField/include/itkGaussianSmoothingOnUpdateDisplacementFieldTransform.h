@@ -22,6 +22,7 @@
 
 #include "itkGaussianOperator.h"
 #include "itkVectorNeighborhoodOperatorImageFilter.h"
+#include "itkSmoothingRecursiveGaussianVectorFieldImageFilter.h"
 
 namespace itk
 {
@@ -34,7 +35,8 @@ namespace itk
  * This class is the same as \c DisplacementFieldTransform, except
  * for the changes to UpdateTransformParameters. The method smooths
  * the result of the addition of the update array and the displacement
- * field, using a \c GaussianOperator filter.
+ * field, using a \c GaussianOperator filter, or optionally the recursive
+ * Gaussian filter \c SmoothingRecursiveGaussianVectorFieldImageFilter.
  *
  * To free the memory allocated and cached in \c GaussianSmoothDisplacementField
  * on demand, see \c FreeGaussianSmoothingTempField.
@@ -84,6 +86,18 @@ public:
   itkSetMacro( GaussianSmoothingVarianceForTheTotalField, ScalarType );
   itkGetConstReferenceMacro( GaussianSmoothingVarianceForTheTotalField, ScalarType );
 
+  /**
+   * Get/Set whether the fields are smoothed with the recursive Gaussian filter
+   * instead of the GaussianOperator. The recursive filter smooths all the
+   * components at once, in place in a buffer kept across the iterations, and
+   * its cost does not depend on the variance. It needs at least 4 pixels
+   * along each direction, and its result is close to but not the same as the
+   * one of the GaussianOperator. Default = false.
+   */
+  itkSetMacro( UseRecursiveGaussianSmoothing, bool );
+  itkGetConstMacro( UseRecursiveGaussianSmoothing, bool );
+  itkBooleanMacro( UseRecursiveGaussianSmoothing );
+
   /** Update the transform's parameters by the values in \c update.
    * We assume \c update is of the same length as Parameters. Throw
    * exception otherwise.
@@ -122,6 +136,15 @@ protected:
                                                   GaussianSmoothingSmootherType;
   GaussianSmoothingOperatorType                    m_GaussianSmoothingOperator;
 
+  /** Recursive smoother used when m_UseRecursiveGaussianSmoothing is on, and
+   * the field it smooths, both kept across the iterations. */
+  typedef SmoothingRecursiveGaussianVectorFieldImageFilter< DisplacementFieldType >
+                                                  GaussianSmoothingRecursiveSmootherType;
+  typename GaussianSmoothingRecursiveSmootherType::Pointer m_GaussianSmoothingRecursiveSmoother;
+  DisplacementFieldPointer                                 m_GaussianSmoothingRecursiveField;
+
+  bool                                             m_UseRecursiveGaussianSmoothing;
+
 private:
   GaussianSmoothingOnUpdateDisplacementFieldTransform( const Self& ) ITK_DELETE_FUNCTION;
   void operator=( const Self& ) ITK_DELETE_FUNCTION;
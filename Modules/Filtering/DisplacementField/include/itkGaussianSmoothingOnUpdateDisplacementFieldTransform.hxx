@@ -38,6 +38,8 @@ GaussianSmoothingOnUpdateDisplacementFieldTransform<TParametersValueType, NDimen
 {
   this->m_GaussianSmoothingVarianceForTheUpdateField = 3.0;
   this->m_GaussianSmoothingVarianceForTheTotalField = 0.5;
+  this->m_UseRecursiveGaussianSmoothing = false;
+  this->m_GaussianSmoothingRecursiveSmoother = GaussianSmoothingRecursiveSmootherType::New();
 }
 
 template<typename TParametersValueType, unsigned int NDimensions>
@@ -136,30 +138,29 @@ GaussianSmoothingOnUpdateDisplacementFieldTransform<TParametersValueType, NDimen
     return field;
     }
 
-  typedef ImageDuplicator< DisplacementFieldType > DuplicatorType;
-  typename DuplicatorType::Pointer duplicator = DuplicatorType::New();
-  duplicator->SetInputImage( field );
-  duplicator->Update();
+  DisplacementFieldPointer smoothField;
 
-  DisplacementFieldPointer smoothField = duplicator->GetModifiableOutput();
-
-  typename GaussianSmoothingSmootherType::Pointer smoother = GaussianSmoothingSmootherType::New();
-
-  for( unsigned int dimension = 0; dimension < Superclass::Dimension; ++dimension )
+  if( this->m_UseRecursiveGaussianSmoothing )
     {
-    // smooth along this dimension
-    this->m_GaussianSmoothingOperator.SetDirection( dimension );
-    this->m_GaussianSmoothingOperator.SetVariance( variance );
-    this->m_GaussianSmoothingOperator.SetMaximumError( 0.001 );
-    this->m_GaussianSmoothingOperator.SetMaximumKernelWidth( smoothField->GetRequestedRegion().GetSize()[dimension] );
-    this->m_GaussianSmoothingOperator.CreateDirectional();
-
-    // todo: make sure we only smooth within the buffered region
-    smoother->SetOperator( this->m_GaussianSmoothingOperator );
-    smoother->SetInput( smoothField );
+    // The field is copied in the buffer kept from the previous iterations,
+    // which has a unit spacing so that the variance is in pixels as with the
+    // GaussianOperator, and smoothed there in place.
+    DisplacementFieldPointer recursiveField = this->m_GaussianSmoothingRecursiveField;
+    if( recursiveField.IsNull() || recursiveField->GetBufferPointer() == ITK_NULLPTR ||
+        recursiveField->GetBufferedRegion() != field->GetBufferedRegion() )
+      {
+      recursiveField = DisplacementFieldType::New();
+      recursiveField->SetRegions( field->GetBufferedRegion() );
+      recursiveField->Allocate();
+      }
+    ImageAlgorithm::Copy< DisplacementFieldType, DisplacementFieldType >( field, recursiveField, field->GetBufferedRegion(), recursiveField->GetBufferedRegion() );
+    recursiveField->Modified();
+
+    this->m_GaussianSmoothingRecursiveSmoother->SetInput( recursiveField );
+    this->m_GaussianSmoothingRecursiveSmoother->SetSigma( std::sqrt( variance ) );
     try
       {
-      smoother->Update();
+      this->m_GaussianSmoothingRecursiveSmoother->Update();
       }
     catch( ExceptionObject & exc )
       {
@@ -168,9 +169,49 @@ GaussianSmoothingOnUpdateDisplacementFieldTransform<TParametersValueType, NDimen
       itkExceptionMacro( << msg );
       }
 
-    smoothField = smoother->GetOutput();
-    smoothField->Update();
+    // the output holds the buffer of the input, which is released
+    smoothField = this->m_GaussianSmoothingRecursiveSmoother->GetOutput();
     smoothField->DisconnectPipeline();
+    this->m_GaussianSmoothingRecursiveField = smoothField;
+    }
+  else
+    {
+    typedef ImageDuplicator< DisplacementFieldType > DuplicatorType;
+    typename DuplicatorType::Pointer duplicator = DuplicatorType::New();
+    duplicator->SetInputImage( field );
+    duplicator->Update();
+
+    smoothField = duplicator->GetModifiableOutput();
+
+    typename GaussianSmoothingSmootherType::Pointer smoother = GaussianSmoothingSmootherType::New();
+
+    for( unsigned int dimension = 0; dimension < Superclass::Dimension; ++dimension )
+      {
+      // smooth along this dimension
+      this->m_GaussianSmoothingOperator.SetDirection( dimension );
+      this->m_GaussianSmoothingOperator.SetVariance( variance );
+      this->m_GaussianSmoothingOperator.SetMaximumError( 0.001 );
+      this->m_GaussianSmoothingOperator.SetMaximumKernelWidth( smoothField->GetRequestedRegion().GetSize()[dimension] );
+      this->m_GaussianSmoothingOperator.CreateDirectional();
+
+      // todo: make sure we only smooth within the buffered region
+      smoother->SetOperator( this->m_GaussianSmoothingOperator );
+      smoother->SetInput( smoothField );
+      try
+        {
+        smoother->Update();
+        }
+      catch( ExceptionObject & exc )
+        {
+        std::string msg("Caught exception: ");
+        msg += exc.what();
+        itkExceptionMacro( << msg );
+        }
+
+      smoothField = smoother->GetOutput();
+      smoothField->Update();
+      smoothField->DisconnectPipeline();
+      }
     }
 
   const DisplacementVectorType zeroVector( 0.0 );
@@ -236,6 +277,8 @@ GaussianSmoothingOnUpdateDisplacementFieldTransform<TParametersValueType, NDimen
     (this->GetGaussianSmoothingVarianceForTheUpdateField());
   rval->SetGaussianSmoothingVarianceForTheTotalField
     (this->GetGaussianSmoothingVarianceForTheTotalField());
+  rval->SetUseRecursiveGaussianSmoothing
+    (this->GetUseRecursiveGaussianSmoothing());
 
   rval->SetFixedParameters(this->GetFixedParameters());
   rval->SetParameters(this->GetParameters());
@@ -254,6 +297,8 @@ PrintSelf( std::ostream& os, Indent indent ) const
      << indent << "m_GaussianSmoothingVarianceForTheUpdateField: " << this->m_GaussianSmoothingVarianceForTheUpdateField
      << std::endl
      << indent << "m_GaussianSmoothingVarianceForTheTotalField: " << this->m_GaussianSmoothingVarianceForTheTotalField
+     << std::endl
+     << indent << "m_UseRecursiveGaussianSmoothing: " << this->m_UseRecursiveGaussianSmoothing
      << std::endl;
 }
 } // namespace itk
@@ -119,6 +119,15 @@ InvertDisplacementFieldImageFilter<TInputImage, TOutputImage>
   this->m_MeanErrorNorm = NumericTraits<RealType>::max();
   unsigned int iteration = 0;
 
+  // The composer and its output buffer are reused by all iterations. The
+  // inverse field is updated in place, so the composer is marked as
+  // modified before each update.
+  typedef ComposeDisplacementFieldsImageFilter<DisplacementFieldType> ComposerType;
+  typename ComposerType::Pointer composer = ComposerType::New();
+  composer->SetDisplacementField( displacementField );
+  composer->SetWarpingField( inverseDisplacementField );
+  composer->SetNumberOfThreads( this->GetNumberOfThreads() );
+
   while( iteration++ < this->m_MaximumNumberOfIterations &&
     this->m_MaxErrorNorm > this->m_MaxErrorToleranceThreshold &&
     this->m_MeanErrorNorm > this->m_MeanErrorToleranceThreshold )
@@ -126,14 +135,9 @@ InvertDisplacementFieldImageFilter<TInputImage, TOutputImage>
     itkDebugMacro( "Iteration " << iteration << ": mean error norm = " << this->m_MeanErrorNorm
       << ", max error norm = " << this->m_MaxErrorNorm );
 
-    typedef ComposeDisplacementFieldsImageFilter<DisplacementFieldType> ComposerType;
-    typename ComposerType::Pointer composer = ComposerType::New();
-    composer->SetDisplacementField( displacementField );
-    composer->SetWarpingField( inverseDisplacementField );
-
+    composer->Modified();
+    composer->Update();
     this->m_ComposedField = composer->GetOutput();
-    this->m_ComposedField->Update();
-    this->m_ComposedField->DisconnectPipeline();
 
     /**
      * Multithread processing to multiply each element of the composed field by 1 / spacing
@@ -77,6 +77,7 @@ public:
   typedef typename OutputImageType::PixelType      OutputImagePixelType;
   typedef typename OutputImageType::PointType      OutputImagePointType;
   typedef typename OutputImageType::IndexType      OutputImageIndexType;
+  typedef typename OutputImageType::RegionType     OutputImageRegionType;
   typedef typename OutputImagePixelType::ValueType OutputImageValueType;
 
   typedef TimeProbe TimeType;
@@ -119,6 +120,11 @@ protected:
 
   void GenerateData() ITK_OVERRIDE;
 
+  /** Refine the first guess of the inverse field over a region. Called by
+   * the threads spawned in GenerateData(). */
+  void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                            ThreadIdType threadId) ITK_OVERRIDE;
+
   unsigned int m_NumberOfIterations;
 
   double m_StopValue;
@@ -127,6 +133,9 @@ protected:
 private:
   IterativeInverseDisplacementFieldImageFilter(const Self &) ITK_DELETE_FUNCTION;
   void operator=(const Self &) ITK_DELETE_FUNCTION;
+
+  // internal ivar shared by the threads
+  FieldInterpolatorPointer m_InputFieldInterpolator;
 };
 } // end namespace itk
 
@@ -39,8 +39,7 @@ template< typename TInputImage, typename TOutputImage >
 void IterativeInverseDisplacementFieldImageFilter< TInputImage, TOutputImage >
 ::GenerateData()
 {
-  const unsigned int ImageDimension = InputImageType::ImageDimension;
-  TimeType           time;
+  TimeType time;
 
   time.Start(); //time measurement
 
@@ -96,149 +95,163 @@ void IterativeInverseDisplacementFieldImageFilter< TInputImage, TOutputImage >
     }
   else
     {
-    // calculate the inverted field
-    InputImagePointType         mappedPoint, newPoint;
-    OutputImagePointType        point, originalPoint, newRemappedPoint;
-    OutputImageIndexType        index;
-    OutputImagePixelType        displacement, outputValue;
-    FieldInterpolatorOutputType forwardVector;
-    double                      spacing = inputPtr->GetSpacing()[0];
-    double                      smallestError = 0;
-    int                         stillSamePoint;
-    InputImageRegionType        region = inputPtr->GetLargestPossibleRegion();
-    unsigned int                numberOfPoints = 1;
-    for ( unsigned int i = 0; i < ImageDimension; i++ )
-      {
-      numberOfPoints *= region.GetSize()[i];
-      }
+    // calculate the inverted field, each thread refining the first guess
+    // over its own part of the output
+    m_InputFieldInterpolator = FieldInterpolatorType::New();
+    m_InputFieldInterpolator->SetInputImage(inputPtr);
+
+    typename ImageSource< TOutputImage >::ThreadStruct str;
+    str.Filter = this;
+    this->GetMultiThreader()->SetNumberOfThreads( this->GetNumberOfThreads() );
+    this->GetMultiThreader()->SetSingleMethod(this->ThreaderCallback, &str);
+    this->GetMultiThreader()->SingleMethodExecute();
+
+    m_InputFieldInterpolator = ITK_NULLPTR;
+    }   //end else
 
-    ProgressReporter progress( this, 0,
-                               inputPtr->GetLargestPossibleRegion().GetNumberOfPixels() );
-    OutputIterator           OutputIt = OutputIterator( outputPtr, outputPtr->GetRequestedRegion() );
-    FieldInterpolatorPointer inputFieldInterpolator = FieldInterpolatorType::New();
-    inputFieldInterpolator->SetInputImage(inputPtr);
+  time.Stop();
+  m_Time = time.GetMean();
+}
 
-    InputIt.GoToBegin();
-    OutputIt.GoToBegin();
-    while ( !OutputIt.IsAtEnd() )
-      {
-      // get the output image index
-      index = OutputIt.GetIndex();
-      outputPtr->TransformIndexToPhysicalPoint(index, originalPoint);
+//----------------------------------------------------------------------------
+template< typename TInputImage, typename TOutputImage >
+void IterativeInverseDisplacementFieldImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId)
+{
+  const unsigned int ImageDimension = InputImageType::ImageDimension;
+
+  InputImageConstPointer inputPtr = this->GetInput(0);
+  OutputImagePointer     outputPtr = this->GetOutput(0);
 
-      stillSamePoint = 0;
-      double step = spacing;
+  const FieldInterpolatorType *inputFieldInterpolator = m_InputFieldInterpolator;
 
-      // get the required displacement
-      displacement = OutputIt.Get();
+  InputImagePointType         mappedPoint, newPoint;
+  OutputImagePointType        originalPoint;
+  OutputImageIndexType        index;
+  OutputImagePixelType        displacement, outputValue;
+  FieldInterpolatorOutputType forwardVector;
+  const double                spacing = inputPtr->GetSpacing()[0];
+  double                      smallestError = 0;
+  int                         stillSamePoint;
 
-      // compute the required input image point
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
+  OutputIterator   OutputIt = OutputIterator( outputPtr, outputRegionForThread );
+
+  OutputIt.GoToBegin();
+  while ( !OutputIt.IsAtEnd() )
+    {
+    // get the output image index
+    index = OutputIt.GetIndex();
+    outputPtr->TransformIndexToPhysicalPoint(index, originalPoint);
+
+    stillSamePoint = 0;
+    double step = spacing;
+
+    // get the required displacement
+    displacement = OutputIt.Get();
+
+    // compute the required input image point
+    for ( unsigned int j = 0; j < ImageDimension; j++ )
+      {
+      mappedPoint[j] = originalPoint[j] + displacement[j];
+      newPoint[j] = mappedPoint[j];
+      }
+
+    // calculate the error of the last iteration
+    if ( inputFieldInterpolator->IsInsideBuffer(mappedPoint) )
+      {
+      forwardVector = inputFieldInterpolator->Evaluate(mappedPoint);
+
+      smallestError = 0;
       for ( unsigned int j = 0; j < ImageDimension; j++ )
         {
-        mappedPoint[j] = originalPoint[j] + displacement[j];
-        newPoint[j] = mappedPoint[j];
+        smallestError += vnl_math_sqr(mappedPoint[j] + forwardVector[j] - originalPoint[j]);
         }
+      smallestError = std::sqrt(smallestError);
+      }
 
-      // calculate the error of the last iteration
-      if ( inputFieldInterpolator->IsInsideBuffer(mappedPoint) )
-        {
-        forwardVector = inputFieldInterpolator->Evaluate(mappedPoint);
+    // iteration loop
+    for ( unsigned int i = 0; i < m_NumberOfIterations; i++ )
+      {
+      double tmp;
 
-        smallestError = 0;
-        for ( unsigned int j = 0; j < ImageDimension; j++ )
-          {
-          smallestError += std::pow(mappedPoint[j] + forwardVector[j] - originalPoint[j], 2);
-          }
-        smallestError = std::sqrt(smallestError);
+      if ( stillSamePoint )
+        {
+        step = step / 2;
         }
 
-      // iteration loop
-      for ( unsigned int i = 0; i < m_NumberOfIterations; i++ )
+      for ( unsigned int k = 0; k < ImageDimension; k++ )
         {
-        double tmp;
-
-        if ( stillSamePoint )
-          {
-          step = step / 2;
-          }
-
-        for ( unsigned int k = 0; k < ImageDimension; k++ )
+        mappedPoint[k] += step;
+        if ( inputFieldInterpolator->IsInsideBuffer(mappedPoint) )
           {
-          mappedPoint[k] += step;
-          if ( inputFieldInterpolator->IsInsideBuffer(mappedPoint) )
+          forwardVector = inputFieldInterpolator->Evaluate(mappedPoint);
+          tmp = 0;
+          for ( unsigned int l = 0; l < ImageDimension; l++ )
             {
-            forwardVector = inputFieldInterpolator->Evaluate(mappedPoint);
-            tmp = 0;
-            for ( unsigned int l = 0; l < ImageDimension; l++ )
-              {
-              tmp += std::pow(mappedPoint[l] + forwardVector[l] - originalPoint[l], 2);
-              }
-            tmp = std::sqrt(tmp);
-            if ( tmp < smallestError )
-              {
-              smallestError = tmp;
-              for ( unsigned int l = 0; l < ImageDimension; l++ )
-                {
-                newPoint[l] = mappedPoint[l];
-                }
-              }
+            tmp += vnl_math_sqr(mappedPoint[l] + forwardVector[l] - originalPoint[l]);
             }
-
-          mappedPoint[k] -= 2 * step;
-          if ( inputFieldInterpolator->IsInsideBuffer(mappedPoint) )
+          tmp = std::sqrt(tmp);
+          if ( tmp < smallestError )
             {
-            forwardVector = inputFieldInterpolator->Evaluate(mappedPoint);
-            tmp = 0;
+            smallestError = tmp;
             for ( unsigned int l = 0; l < ImageDimension; l++ )
               {
-              tmp += std::pow(mappedPoint[l] + forwardVector[l] - originalPoint[l], 2);
-              }
-            tmp = std::sqrt(tmp);
-            if ( tmp < smallestError )
-              {
-              smallestError = tmp;
-              for ( unsigned int l = 0; l < ImageDimension; l++ )
-                {
-                newPoint[l] = mappedPoint[l];
-                }
+              newPoint[l] = mappedPoint[l];
               }
             }
+          }
 
-          mappedPoint[k] += step;
-          } //end for loop over image dimension
-
-        stillSamePoint = 1;
-        for ( unsigned int j = 0; j < ImageDimension; j++ )
+        mappedPoint[k] -= 2 * step;
+        if ( inputFieldInterpolator->IsInsideBuffer(mappedPoint) )
           {
-          if ( Math::NotExactlyEquals(newPoint[j], mappedPoint[j]) )
+          forwardVector = inputFieldInterpolator->Evaluate(mappedPoint);
+          tmp = 0;
+          for ( unsigned int l = 0; l < ImageDimension; l++ )
             {
-            stillSamePoint = 0;
+            tmp += vnl_math_sqr(mappedPoint[l] + forwardVector[l] - originalPoint[l]);
+            }
+          tmp = std::sqrt(tmp);
+          if ( tmp < smallestError )
+            {
+            smallestError = tmp;
+            for ( unsigned int l = 0; l < ImageDimension; l++ )
+              {
+              newPoint[l] = mappedPoint[l];
+              }
             }
-          mappedPoint[j] = newPoint[j];
           }
 
-        if ( smallestError < m_StopValue )
+        mappedPoint[k] += step;
+        } //end for loop over image dimension
+
+      stillSamePoint = 1;
+      for ( unsigned int j = 0; j < ImageDimension; j++ )
+        {
+        if ( Math::NotExactlyEquals(newPoint[j], mappedPoint[j]) )
           {
-          break;
+          stillSamePoint = 0;
           }
-        } //end iteration loop
+        mappedPoint[j] = newPoint[j];
+        }
 
-      for ( unsigned int k = 0; k < ImageDimension; k++ )
+      if ( smallestError < m_StopValue )
         {
-        outputValue[k] = static_cast< OutputImageValueType >( mappedPoint[k] - originalPoint[k] );
+        break;
         }
+      } //end iteration loop
 
-      OutputIt.Set(outputValue);
+    for ( unsigned int k = 0; k < ImageDimension; k++ )
+      {
+      outputValue[k] = static_cast< OutputImageValueType >( mappedPoint[k] - originalPoint[k] );
+      }
 
-      ++InputIt;
-      ++OutputIt;
+    OutputIt.Set(outputValue);
 
-      progress.CompletedPixel();
-      } //end while loop
-    }   //end else
+    ++OutputIt;
 
-  time.Stop();
-  m_Time = time.GetMean();
+    progress.CompletedPixel();
+    } //end while loop
 }
 
 //----------------------------------------------------------------------------
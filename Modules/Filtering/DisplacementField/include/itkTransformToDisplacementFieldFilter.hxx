@@ -22,8 +22,8 @@
 
 #include "itkIdentityTransform.h"
 #include "itkProgressReporter.h"
-#include "itkImageRegionIteratorWithIndex.h"
 #include "itkImageLinearIteratorWithIndex.h"
+#include "itkImageScanlineIterator.h"
 
 namespace itk
 {
@@ -188,36 +188,59 @@ TransformToDisplacementFieldFilter< TOutputImage, TParametersValueType>
   const TransformType * transform = this->GetInput()->Get();
 
   // Create an iterator that will walk the output region for this thread.
-  typedef ImageRegionIteratorWithIndex< TOutputImage > OutputIteratorType;
+  typedef ImageScanlineIterator< TOutputImage > OutputIteratorType;
   OutputIteratorType outIt( output, outputRegionForThread );
 
-  // Define a few variables that will be used to translate from an input pixel
-  // to an output pixel
-  PointType outputPoint;         // Coordinates of output pixel
-  PointType transformedPoint;    // Coordinates of transformed pixel
+  typedef typename TransformType::InputPointType  TransformInputPointType;
+  typedef typename TransformType::OutputPointType TransformOutputPointType;
+
+  // The points of a scanline are mapped with a single call to
+  // TransformPoints, so that transforms which can share work between
+  // points (e.g. BSplineTransform) do so.
+  const SizeValueType lineLength = outputRegionForThread.GetSize()[0];
+  std::vector< PointType >                outputPoints( lineLength );
+  std::vector< TransformInputPointType >  inputPoints( lineLength );
+  std::vector< TransformOutputPointType > transformedPoints( lineLength );
+
+  IndexType index;
   PixelType displacement;         // the difference
 
   // Support for progress methods/callbacks
-  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
+  const SizeValueType numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / lineLength;
+  ProgressReporter progress( this, threadId, numberOfLinesToProcess );
 
   // Walk the output region
-  outIt.GoToBegin();
   while ( !outIt.IsAtEnd() )
     {
-    // Determine the index of the current output pixel
-    output->TransformIndexToPhysicalPoint( outIt.GetIndex(), outputPoint );
+    index = outIt.GetIndex();
+    for ( SizeValueType i = 0; i < lineLength; ++i )
+      {
+      output->TransformIndexToPhysicalPoint( index, outputPoints[i] );
+      for ( unsigned int j = 0; j < ImageDimension; ++j )
+        {
+        inputPoints[i][j] = outputPoints[i][j];
+        }
+      ++index[0];
+      }
 
-    // Compute corresponding input pixel position
-    transformedPoint = transform->TransformPoint( outputPoint );
+    // Compute corresponding input pixel positions
+    transform->TransformPoints( &inputPoints[0], &transformedPoints[0], lineLength );
 
-    displacement = transformedPoint - outputPoint;
+    for ( SizeValueType i = 0; i < lineLength; ++i )
+      {
+      for ( unsigned int j = 0; j < ImageDimension; ++j )
+        {
+        displacement[j] = static_cast< typename PixelType::ValueType >( transformedPoints[i][j] - outputPoints[i][j] );
+        }
 
-    // Set it
-    outIt.Set( displacement );
+      // Set it
+      outIt.Set( displacement );
+      ++outIt;
+      }
 
     // Update progress and iterator
     progress.CompletedPixel();
-    ++outIt;
+    outIt.NextLine();
     }
 }
 
@@ -9,6 +9,7 @@ itk_module(ITKDisplacementField
   COMPILE_DEPENDS
     ITKImageGrid
     ITKImageIntensity
+    ITKSmoothing
   TEST_DEPENDS
     ITKTestKernel
   DESCRIPTION
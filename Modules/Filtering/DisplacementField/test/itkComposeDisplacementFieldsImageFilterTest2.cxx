@@ -0,0 +1,189 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkComposeDisplacementFieldsImageFilter.h"
+#include "itkVectorLinearInterpolateImageFunction.h"
+#include "itkVectorNeighborhoodOperatorImageFilter.h"
+#include "itkGaussianOperator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+/* Composes two fields on an oblique grid and checks the result against a
+ * direct evaluation with VectorLinearInterpolateImageFunction, then checks
+ * the fused smoothing against VectorNeighborhoodOperatorImageFilter. */
+int itkComposeDisplacementFieldsImageFilterTest2( int, char * [] )
+{
+  const unsigned int   ImageDimension = 3;
+
+  typedef itk::Vector<float, ImageDimension>       VectorType;
+  typedef itk::Image<VectorType, ImageDimension>   DisplacementFieldType;
+
+  typedef itk::ComposeDisplacementFieldsImageFilter<DisplacementFieldType> ComposerType;
+  typedef itk::VectorLinearInterpolateImageFunction<DisplacementFieldType, float> InterpolatorType;
+
+  // Displacement field on an oblique grid
+  DisplacementFieldType::SizeType size;
+  size[0] = 20;
+  size[1] = 18;
+  size[2] = 16;
+  DisplacementFieldType::SpacingType spacing;
+  spacing[0] = 1.5;
+  spacing[1] = 1.25;
+  spacing[2] = 2.0;
+  DisplacementFieldType::PointType origin;
+  origin[0] = -2.0;
+  origin[1] = 1.0;
+  origin[2] = 0.5;
+  DisplacementFieldType::DirectionType direction;
+  direction.SetIdentity();
+  const double angle = 0.2;
+  direction[0][0] = std::cos( angle );
+  direction[0][1] = -std::sin( angle );
+  direction[1][0] = std::sin( angle );
+  direction[1][1] = std::cos( angle );
+
+  DisplacementFieldType::Pointer field = DisplacementFieldType::New();
+  field->SetRegions( size );
+  field->SetSpacing( spacing );
+  field->SetOrigin( origin );
+  field->SetDirection( direction );
+  field->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<DisplacementFieldType> fieldIt( field, field->GetLargestPossibleRegion() );
+  for( ; !fieldIt.IsAtEnd(); ++fieldIt )
+    {
+    const DisplacementFieldType::IndexType index = fieldIt.GetIndex();
+    VectorType v;
+    v[0] = 3.0 * std::sin( 0.3 * index[1] + 0.1 * index[2] );
+    v[1] = 2.0 * std::cos( 0.2 * index[0] );
+    v[2] = 1.5 * std::sin( 0.25 * index[0] + 0.35 * index[1] );
+    fieldIt.Set( v );
+    }
+
+  // Warping field on the same grid, mapping the border points outside the
+  // displacement field
+  DisplacementFieldType::Pointer warpingField = DisplacementFieldType::New();
+  warpingField->CopyInformation( field );
+  warpingField->SetRegions( size );
+  warpingField->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<DisplacementFieldType> warpingIt( warpingField, warpingField->GetLargestPossibleRegion() );
+  for( ; !warpingIt.IsAtEnd(); ++warpingIt )
+    {
+    const DisplacementFieldType::IndexType index = warpingIt.GetIndex();
+    VectorType v;
+    v[0] = 1.7 * std::cos( 0.15 * index[2] );
+    v[1] = -2.3 * std::sin( 0.4 * index[0] );
+    v[2] = 0.8 * std::cos( 0.3 * index[1] );
+    warpingIt.Set( v );
+    }
+
+  ComposerType::Pointer composer = ComposerType::New();
+  composer->SetDisplacementField( field );
+  composer->SetWarpingField( warpingField );
+  composer->SetNumberOfThreads( 3 );
+  TEST_SET_GET_VALUE( 0.0, composer->GetGaussianSmoothingVarianceForTheComposedField() );
+  TRY_EXPECT_NO_EXCEPTION( composer->Update() );
+
+  // Reference composition
+  InterpolatorType::Pointer interpolator = InterpolatorType::New();
+  interpolator->SetInputImage( field );
+
+  unsigned int numberOfInsidePoints = 0;
+  itk::ImageRegionIteratorWithIndex<DisplacementFieldType> outputIt( composer->GetOutput(),
+    composer->GetOutput()->GetLargestPossibleRegion() );
+  for( warpingIt.GoToBegin(); !warpingIt.IsAtEnd(); ++warpingIt, ++outputIt )
+    {
+    DisplacementFieldType::PointType point;
+    warpingField->TransformIndexToPhysicalPoint( warpingIt.GetIndex(), point );
+    point += warpingIt.Get();
+
+    VectorType expected = warpingIt.Get();
+    if( interpolator->IsInsideBuffer( point ) )
+      {
+      expected += interpolator->Evaluate( point );
+      ++numberOfInsidePoints;
+      }
+
+    const VectorType composed = outputIt.Get();
+    for( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      if( std::abs( composed[d] - expected[d] ) > 1e-4 )
+        {
+        std::cerr << "Composition mismatch at " << warpingIt.GetIndex() << ": expected "
+                  << expected << ", got " << composed << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+  if( numberOfInsidePoints == 0 ||
+      numberOfInsidePoints == warpingField->GetLargestPossibleRegion().GetNumberOfPixels() )
+    {
+    std::cerr << "The test fields should map both inside and outside the displacement field" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Fused smoothing against composing, then smoothing one direction at a time
+  DisplacementFieldType::Pointer composed = composer->GetOutput();
+  composed->DisconnectPipeline();
+
+  const double variance = 1.5;
+  typedef itk::GaussianOperator<float, ImageDimension> OperatorType;
+  typedef itk::VectorNeighborhoodOperatorImageFilter<DisplacementFieldType, DisplacementFieldType> SmootherType;
+
+  DisplacementFieldType::Pointer smoothed = composed;
+  OperatorType gaussianOperator;
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    gaussianOperator.SetDirection( d );
+    gaussianOperator.SetVariance( variance );
+    gaussianOperator.SetMaximumError( 0.001 );
+    gaussianOperator.SetMaximumKernelWidth( size[d] );
+    gaussianOperator.CreateDirectional();
+
+    SmootherType::Pointer smoother = SmootherType::New();
+    smoother->SetOperator( gaussianOperator );
+    smoother->SetInput( smoothed );
+    TRY_EXPECT_NO_EXCEPTION( smoother->Update() );
+    smoothed = smoother->GetOutput();
+    smoothed->DisconnectPipeline();
+    }
+
+  composer->SetGaussianSmoothingVarianceForTheComposedField( variance );
+  TEST_SET_GET_VALUE( variance, composer->GetGaussianSmoothingVarianceForTheComposedField() );
+  TRY_EXPECT_NO_EXCEPTION( composer->Update() );
+
+  itk::ImageRegionIteratorWithIndex<DisplacementFieldType> smoothedIt( smoothed, smoothed->GetLargestPossibleRegion() );
+  outputIt = itk::ImageRegionIteratorWithIndex<DisplacementFieldType>( composer->GetOutput(),
+    composer->GetOutput()->GetLargestPossibleRegion() );
+  for( ; !smoothedIt.IsAtEnd(); ++smoothedIt, ++outputIt )
+    {
+    for( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      if( std::abs( smoothedIt.Get()[d] - outputIt.Get()[d] ) > 1e-4 )
+        {
+        std::cerr << "Smoothing mismatch at " << smoothedIt.GetIndex() << ": expected "
+                  << smoothedIt.Get() << ", got " << outputIt.Get() << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
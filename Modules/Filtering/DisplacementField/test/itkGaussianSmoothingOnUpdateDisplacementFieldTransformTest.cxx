@@ -16,6 +16,8 @@
  *
  *=========================================================================*/
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 #include "itkGaussianSmoothingOnUpdateDisplacementFieldTransform.h"
@@ -179,6 +181,69 @@ int itkGaussianSmoothingOnUpdateDisplacementFieldTransformTest(int ,char *[] )
     std::cout << std::endl;
     }
 
+  /* Smooth with the recursive Gaussian filter, which should be close to the
+   * GaussianOperator. The update is smoothed in place, so it is filled again
+   * before each call. */
+  std::cout << "Testing UseRecursiveGaussianSmoothing..." << std::endl;
+  if( displacementTransform->GetUseRecursiveGaussianSmoothing() )
+    {
+    std::cout << "The recursive Gaussian smoothing should be off by default." << std::endl;
+    return EXIT_FAILURE;
+    }
+  field->FillBuffer( zeroVector );
+  update.Fill( 1.0 );
+  update( outlier ) = 99.0;
+  update( outlier + 1 ) = 99.0;
+  displacementTransform->UpdateTransformParameters( update );
+  const itk::Array< ParametersValueType > paramsOperator = displacementTransform->GetParameters();
+
+  displacementTransform->UseRecursiveGaussianSmoothingOn();
+  field->FillBuffer( zeroVector );
+  update.Fill( 1.0 );
+  update( outlier ) = 99.0;
+  update( outlier + 1 ) = 99.0;
+  displacementTransform->UpdateTransformParameters( update );
+  const itk::Array< ParametersValueType > paramsRecursive = displacementTransform->GetParameters();
+
+  /* The smoother and its buffer are kept, and give the same result again. */
+  field->FillBuffer( zeroVector );
+  update.Fill( 1.0 );
+  update( outlier ) = 99.0;
+  update( outlier + 1 ) = 99.0;
+  displacementTransform->UpdateTransformParameters( update );
+  params = displacementTransform->GetParameters();
+
+  ParametersValueType maximumValue = paramsZero;
+  ParametersValueType maximumDifference = paramsZero;
+  linelength = dimLength * dimensions;
+  for( unsigned int i=0; i < displacementTransform->GetNumberOfParameters(); i++ )
+    {
+    if( ( i < linelength || i % linelength == 0 || i % linelength == (linelength - 1) )
+        && itk::Math::NotAlmostEquals( paramsRecursive[i], paramsZero ) )
+      {
+      std::cout << "0-valued boundaries not found when expected "
+                << "after the recursive smoothing." << std::endl;
+      return EXIT_FAILURE;
+      }
+    if( itk::Math::NotExactlyEquals( params[i], paramsRecursive[i] ) )
+      {
+      std::cout << "Different result when the recursive smoother is reused at "
+                << i << ": " << params[i] << " instead of " << paramsRecursive[i] << std::endl;
+      return EXIT_FAILURE;
+      }
+    maximumValue = std::max( maximumValue, std::abs( paramsOperator[i] ) );
+    maximumDifference = std::max( maximumDifference, std::abs( paramsRecursive[i] - paramsOperator[i] ) );
+    }
+  std::cout << "Maximum difference with the GaussianOperator: " << maximumDifference
+            << " for a maximum value of " << maximumValue << std::endl;
+  // the recursive filter extends the image differently at its borders
+  if( maximumDifference > 0.1 * maximumValue )
+    {
+    std::cout << "The recursive smoothing is too far from the GaussianOperator." << std::endl;
+    return EXIT_FAILURE;
+    }
+  displacementTransform->UseRecursiveGaussianSmoothingOff();
+
   /* Exercise Get/Set sigma */
   displacementTransform->SetGaussianSmoothingVarianceForTheUpdateField(2);
   std::cout << "sigma: "
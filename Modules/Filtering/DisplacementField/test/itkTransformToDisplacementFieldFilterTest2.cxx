@@ -0,0 +1,265 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+/** This test computes the displacement field of a composite transform once
+ * with the TransformToDisplacementFieldFilter, resamples an intensity image
+ * and a label image through that field with ResampleImageFilter, and checks
+ * the results against resampling directly through the transform. It also
+ * checks a streamed pipeline in which each output tile computes only its
+ * own tile of the field.
+ */
+
+#include "itkTransformToDisplacementFieldFilter.h"
+#include "itkResampleImageFilter.h"
+#include "itkNearestNeighborInterpolateImageFunction.h"
+#include "itkStreamingImageFilter.h"
+#include "itkCompositeTransform.h"
+#include "itkAffineTransform.h"
+#include "itkBSplineTransform.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkMath.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+
+template< typename TImage >
+unsigned int
+CountDifferences( const TImage *image1, const TImage *image2, double tolerance )
+{
+  typedef itk::ImageRegionConstIterator< TImage > IteratorType;
+  IteratorType it1( image1, image1->GetLargestPossibleRegion() );
+  IteratorType it2( image2, image2->GetLargestPossibleRegion() );
+
+  unsigned int differences = 0;
+  for( ; !it1.IsAtEnd(); ++it1, ++it2 )
+    {
+    if( std::abs( static_cast< double >( it1.Get() ) - static_cast< double >( it2.Get() ) ) > tolerance )
+      {
+      ++differences;
+      }
+    }
+  return differences;
+}
+
+}
+
+int itkTransformToDisplacementFieldFilterTest2( int, char * [] )
+{
+  const unsigned int Dimension = 2;
+
+  typedef itk::Image< float, Dimension >                    ImageType;
+  typedef itk::Image< unsigned char, Dimension >            LabelImageType;
+  typedef itk::CompositeTransform< double, Dimension >      CompositeTransformType;
+  typedef itk::AffineTransform< double, Dimension >         AffineTransformType;
+  typedef itk::BSplineTransform< double, Dimension, 3 >     BSplineTransformType;
+
+  typedef itk::ResampleImageFilter< ImageType, ImageType >           ResampleFilterType;
+  typedef itk::ResampleImageFilter< LabelImageType, LabelImageType > LabelResampleFilterType;
+  typedef ResampleFilterType::DisplacementFieldType                  DisplacementFieldType;
+
+  typedef itk::TransformToDisplacementFieldFilter< DisplacementFieldType, double > FieldGeneratorType;
+  typedef itk::NearestNeighborInterpolateImageFunction< LabelImageType, double >   LabelInterpolatorType;
+
+  // Input images: a smooth intensity pattern and a label image of bands
+  ImageType::SizeType size;
+  size.Fill( 64 );
+  ImageType::RegionType region;
+  region.SetSize( size );
+  ImageType::SpacingType spacing;
+  spacing[0] = 1.0;
+  spacing[1] = 1.5;
+  ImageType::PointType origin;
+  origin[0] = -3.0;
+  origin[1] = 5.0;
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( region );
+  image->SetSpacing( spacing );
+  image->SetOrigin( origin );
+  image->Allocate();
+
+  LabelImageType::Pointer labels = LabelImageType::New();
+  labels->SetRegions( region );
+  labels->SetSpacing( spacing );
+  labels->SetOrigin( origin );
+  labels->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< ImageType >      imageIt( image, region );
+  itk::ImageRegionIteratorWithIndex< LabelImageType > labelIt( labels, region );
+  for( ; !imageIt.IsAtEnd(); ++imageIt, ++labelIt )
+    {
+    const ImageType::IndexType index = imageIt.GetIndex();
+    imageIt.Set( static_cast< float >( 100.0 * std::sin( 0.2 * index[0] ) * std::cos( 0.15 * index[1] ) ) );
+    labelIt.Set( static_cast< unsigned char >( ( index[0] / 8 + 3 * ( index[1] / 8 ) ) % 7 ) );
+    }
+
+  // Composite transform: an affine followed by a B-spline
+  AffineTransformType::Pointer affine = AffineTransformType::New();
+  AffineTransformType::OutputVectorType translation;
+  translation[0] = 2.5;
+  translation[1] = -1.75;
+  affine->Translate( translation );
+  affine->Rotate2D( 0.1 );
+  AffineTransformType::InputPointType center;
+  center[0] = origin[0] + 32.0 * spacing[0];
+  center[1] = origin[1] + 32.0 * spacing[1];
+  affine->SetCenter( center );
+
+  BSplineTransformType::Pointer bspline = BSplineTransformType::New();
+  BSplineTransformType::PhysicalDimensionsType physicalDimensions;
+  BSplineTransformType::MeshSizeType           meshSize;
+  for( unsigned int d = 0; d < Dimension; d++ )
+    {
+    physicalDimensions[d] = spacing[d] * ( size[d] - 1 );
+    meshSize[d] = 5;
+    }
+  bspline->SetTransformDomainOrigin( origin );
+  bspline->SetTransformDomainPhysicalDimensions( physicalDimensions );
+  bspline->SetTransformDomainMeshSize( meshSize );
+  bspline->SetTransformDomainDirection( image->GetDirection() );
+
+  BSplineTransformType::ParametersType parameters( bspline->GetNumberOfParameters() );
+  for( unsigned int p = 0; p < parameters.Size(); p++ )
+    {
+    parameters[p] = 3.0 * std::sin( 0.7 * p );
+    }
+  bspline->SetParameters( parameters );
+
+  CompositeTransformType::Pointer composite = CompositeTransformType::New();
+  composite->AddTransform( affine );
+  composite->AddTransform( bspline );
+
+  // Batched composite mapping agrees with the point-wise one
+  std::vector< CompositeTransformType::InputPointType > points( 17 );
+  for( unsigned int i = 0; i < points.size(); i++ )
+    {
+    points[i][0] = origin[0] + 3.7 * i;
+    points[i][1] = origin[1] + 5.3 * i;
+    }
+  std::vector< CompositeTransformType::OutputPointType > mapped( points.size() );
+  composite->TransformPoints( &points[0], &mapped[0], points.size() );
+  for( unsigned int i = 0; i < points.size(); i++ )
+    {
+    const CompositeTransformType::OutputPointType expected = composite->TransformPoint( points[i] );
+    if( expected.EuclideanDistanceTo( mapped[i] ) > 1e-10 )
+      {
+      std::cerr << "TransformPoints mismatch at point " << i << ": expected " << expected
+                << ", got " << mapped[i] << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Compute the displacement field once on the output grid
+  FieldGeneratorType::Pointer fieldGenerator = FieldGeneratorType::New();
+  fieldGenerator->SetTransform( composite );
+  fieldGenerator->SetReferenceImage( image );
+  fieldGenerator->UseReferenceImageOn();
+  TRY_EXPECT_NO_EXCEPTION( fieldGenerator->Update() );
+
+  DisplacementFieldType::Pointer field = fieldGenerator->GetOutput();
+  field->DisconnectPipeline();
+
+  // Intensity image: through the transform and through the field
+  ResampleFilterType::Pointer direct = ResampleFilterType::New();
+  direct->SetInput( image );
+  direct->SetTransform( composite );
+  direct->SetReferenceImage( image );
+  direct->UseReferenceImageOn();
+  TRY_EXPECT_NO_EXCEPTION( direct->Update() );
+
+  ResampleFilterType::Pointer throughField = ResampleFilterType::New();
+  throughField->SetInput( image );
+  throughField->SetDisplacementField( field );
+  throughField->SetReferenceImage( image );
+  throughField->UseReferenceImageOn();
+  TEST_SET_GET_VALUE( field.GetPointer(), throughField->GetDisplacementField() );
+  TRY_EXPECT_NO_EXCEPTION( throughField->Update() );
+
+  unsigned int differences = CountDifferences< ImageType >( direct->GetOutput(), throughField->GetOutput(), 1e-3 );
+  if( differences != 0 )
+    {
+    std::cerr << differences << " intensity pixels differ between transform and field resampling" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Label image: the same field is reused with a nearest neighbor interpolator
+  LabelResampleFilterType::Pointer labelDirect = LabelResampleFilterType::New();
+  labelDirect->SetInput( labels );
+  labelDirect->SetTransform( composite );
+  labelDirect->SetInterpolator( LabelInterpolatorType::New() );
+  labelDirect->SetReferenceImage( labels );
+  labelDirect->UseReferenceImageOn();
+  TRY_EXPECT_NO_EXCEPTION( labelDirect->Update() );
+
+  LabelResampleFilterType::Pointer labelThroughField = LabelResampleFilterType::New();
+  labelThroughField->SetInput( labels );
+  labelThroughField->SetDisplacementField( field );
+  labelThroughField->SetInterpolator( LabelInterpolatorType::New() );
+  labelThroughField->SetReferenceImage( labels );
+  labelThroughField->UseReferenceImageOn();
+  TRY_EXPECT_NO_EXCEPTION( labelThroughField->Update() );
+
+  differences = CountDifferences< LabelImageType >( labelDirect->GetOutput(), labelThroughField->GetOutput(), 0.0 );
+  if( differences != 0 )
+    {
+    std::cerr << differences << " label pixels differ between transform and field resampling" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Streamed: each output tile requests only its tile of the field
+  FieldGeneratorType::Pointer tileFieldGenerator = FieldGeneratorType::New();
+  tileFieldGenerator->SetTransform( composite );
+  tileFieldGenerator->SetReferenceImage( image );
+  tileFieldGenerator->UseReferenceImageOn();
+
+  ResampleFilterType::Pointer streamedResample = ResampleFilterType::New();
+  streamedResample->SetInput( image );
+  streamedResample->SetDisplacementField( tileFieldGenerator->GetOutput() );
+  streamedResample->SetReferenceImage( image );
+  streamedResample->UseReferenceImageOn();
+
+  typedef itk::StreamingImageFilter< ImageType, ImageType > StreamingFilterType;
+  StreamingFilterType::Pointer streamer = StreamingFilterType::New();
+  streamer->SetInput( streamedResample->GetOutput() );
+  streamer->SetNumberOfStreamDivisions( 4 );
+  TRY_EXPECT_NO_EXCEPTION( streamer->Update() );
+
+  if( tileFieldGenerator->GetOutput()->GetBufferedRegion() == region )
+    {
+    std::cerr << "The streamed field was computed over the whole output" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  differences = CountDifferences< ImageType >( direct->GetOutput(), streamer->GetOutput(), 1e-3 );
+  if( differences != 0 )
+    {
+    std::cerr << differences << " intensity pixels differ between transform and streamed field resampling" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // A field on another grid is rejected
+  DisplacementFieldType::PointType shiftedOrigin = origin;
+  shiftedOrigin[0] += 0.5;
+  field->SetOrigin( shiftedOrigin );
+  throughField->Modified();
+  TRY_EXPECT_EXCEPTION( throughField->Update() );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
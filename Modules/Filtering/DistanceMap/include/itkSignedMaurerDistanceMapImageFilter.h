@@ -46,8 +46,19 @@ namespace itk
  *  Set/GetBackgroundValue specifies the background of the value of the
  *  input binary image. Normally this is zero and, as such, zero is the
  *  default value.  Other than that, the usage is completely analogous to
- *  the itk::DanielssonDistanceImageFilter class except it does not return
- *  the Voronoi map.
+ *  the itk::DanielssonDistanceImageFilter class.
+ *
+ *  \par Voronoi map and vector distance map
+ *  When ComputeVoronoiMap is on, the filter also produces the Voronoi map
+ *  and the vector distance map of DanielssonDistanceMapImageFilter. They are
+ *  computed during the same parallel passes as the distance. The vector
+ *  distance map gives, in pixels, the offset from each pixel to the closest
+ *  pixel of the object boundary, i.e. to the pixel that defines its
+ *  distance. The Voronoi map gives the input value of that pixel for the
+ *  background pixels and the input value of the pixel itself for the
+ *  object pixels, so that a label image is partitioned between its labels.
+ *  Both maps are left empty when ComputeVoronoiMap is off, which is the
+ *  default.
  *
  *  Reference:
  *  C. R. Maurer, Jr., R. Qi, and V. Raghavan, "A Linear Time Algorithm
@@ -58,7 +69,9 @@ namespace itk
  * \ingroup ImageFeatureExtraction
  * \ingroup ITKDistanceMap
  */
-template< typename TInputImage, typename TOutputImage >
+template< typename TInputImage,
+  typename TOutputImage,
+  typename TVoronoiImage = TInputImage >
 class SignedMaurerDistanceMapImageFilter:
   public ImageToImageFilter< TInputImage, TOutputImage >
 {
@@ -116,6 +129,16 @@ public:
   typedef typename OutputImageType::SpacingType OutputSpacingType;
   typedef typename OutputImageType::RegionType  OutputImageRegionType;
 
+  /** Type for the Voronoi map. */
+  typedef TVoronoiImage                        VoronoiImageType;
+  typedef typename VoronoiImageType::PixelType VoronoiPixelType;
+
+  /** Type for the vector distance map. */
+  typedef typename InputImageType::OffsetType  OffsetType;
+  typedef typename OffsetType::OffsetValueType OffsetValueType;
+  typedef Image< OffsetType,
+                 itkGetStaticConstMacro(InputImageDimension) > VectorImageType;
+
   /** Set if the distance should be squared. */
   itkSetMacro(SquaredDistance, bool);
 
@@ -154,6 +177,36 @@ public:
   itkSetMacro(BackgroundValue, InputPixelType);
   itkGetConstReferenceMacro(BackgroundValue, InputPixelType);
 
+  /** Set if the Voronoi map and the vector distance map should be
+   * computed. Default is false. */
+  itkSetMacro(ComputeVoronoiMap, bool);
+
+  /** Get whether the Voronoi map and the vector distance map are
+   * computed. */
+  itkGetConstReferenceMacro(ComputeVoronoiMap, bool);
+
+  /** Set On/Off whether the Voronoi map and the vector distance map are
+   * computed. */
+  itkBooleanMacro(ComputeVoronoiMap);
+
+  /** Get the distance map. This is the same as GetOutput(). */
+  OutputImageType * GetDistanceMap();
+
+  /** Get the Voronoi map. It holds for each background pixel the input
+   * value of the closest object pixel, and for each object pixel its own
+   * input value. Only computed when ComputeVoronoiMap is on. */
+  VoronoiImageType * GetVoronoiMap();
+
+  /** Get the vector distance map. It holds for each pixel the offset to
+   * the closest pixel of the object boundary. Only computed when
+   * ComputeVoronoiMap is on. */
+  VectorImageType * GetVectorDistanceMap();
+
+  /** Standard itk::ProcessObject subclass method. */
+  typedef ProcessObject::DataObjectPointerArraySizeType DataObjectPointerArraySizeType;
+  using Superclass::MakeOutput;
+  virtual DataObject::Pointer MakeOutput( DataObjectPointerArraySizeType idx ) ITK_OVERRIDE;
+
 protected:
   SignedMaurerDistanceMapImageFilter();
   virtual ~SignedMaurerDistanceMapImageFilter();
@@ -162,6 +215,10 @@ protected:
 
   virtual void GenerateData() ITK_OVERRIDE;
 
+  /** Allocate the Voronoi map and the vector distance map only when they
+   * are computed. */
+  virtual void AllocateOutputs() ITK_OVERRIDE;
+
   virtual unsigned int SplitRequestedRegion(unsigned int i, unsigned int num,
     OutputImageRegionType & splitRegion) ITK_OVERRIDE;
 
@@ -184,8 +241,10 @@ private:
   bool m_InsideIsPositive;
   bool m_UseImageSpacing;
   bool m_SquaredDistance;
+  bool m_ComputeVoronoiMap;
 
   const InputImageType *m_InputCache;
+  VectorImageType      *m_VectorDistanceMapCache;
 };
 } // end namespace itk
 
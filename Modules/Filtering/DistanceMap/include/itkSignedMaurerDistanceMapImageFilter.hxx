@@ -30,8 +30,8 @@
 
 namespace itk
 {
-template< typename TInputImage, typename TOutputImage >
-SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage >
+template< typename TInputImage, typename TOutputImage, typename TVoronoiImage >
+SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >
 ::SignedMaurerDistanceMapImageFilter():
   m_BackgroundValue( NumericTraits< InputPixelType >::ZeroValue() ),
   m_Spacing(0.0),
@@ -39,17 +39,88 @@ SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage >
   m_InsideIsPositive(false),
   m_UseImageSpacing(true),
   m_SquaredDistance(false),
-  m_InputCache(ITK_NULLPTR)
-{}
+  m_ComputeVoronoiMap(false),
+  m_InputCache(ITK_NULLPTR),
+  m_VectorDistanceMapCache(ITK_NULLPTR)
+{
+  this->SetNumberOfRequiredOutputs(3);
+
+  // voronoi map
+  this->SetNthOutput( 1, this->MakeOutput( 1 ) );
+
+  // distance vectors
+  this->SetNthOutput( 2, this->MakeOutput( 2 ) );
+}
 
-template< typename TInputImage, typename TOutputImage >
-SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage >
+template< typename TInputImage, typename TOutputImage, typename TVoronoiImage >
+SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >
 ::~SignedMaurerDistanceMapImageFilter()
 {}
 
-template< typename TInputImage, typename TOutputImage >
+template< typename TInputImage, typename TOutputImage, typename TVoronoiImage >
+DataObject::Pointer
+SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >
+::MakeOutput(DataObjectPointerArraySizeType idx)
+{
+  if( idx == 1 )
+    {
+    return VoronoiImageType::New().GetPointer();
+    }
+  if( idx == 2 )
+    {
+    return VectorImageType::New().GetPointer();
+    }
+  return Superclass::MakeOutput( idx );
+}
+
+template< typename TInputImage, typename TOutputImage, typename TVoronoiImage >
+typename SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >::OutputImageType *
+SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >
+::GetDistanceMap()
+{
+  return this->GetOutput();
+}
+
+template< typename TInputImage, typename TOutputImage, typename TVoronoiImage >
+typename SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >::VoronoiImageType *
+SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >
+::GetVoronoiMap()
+{
+  return dynamic_cast< VoronoiImageType * >( this->ProcessObject::GetOutput(1) );
+}
+
+template< typename TInputImage, typename TOutputImage, typename TVoronoiImage >
+typename SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >::VectorImageType *
+SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >
+::GetVectorDistanceMap()
+{
+  return dynamic_cast< VectorImageType * >( this->ProcessObject::GetOutput(2) );
+}
+
+template< typename TInputImage, typename TOutputImage, typename TVoronoiImage >
+void
+SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >
+::AllocateOutputs()
+{
+  OutputImageType *outputPtr = this->GetOutput();
+  outputPtr->SetBufferedRegion( outputPtr->GetRequestedRegion() );
+  outputPtr->Allocate();
+
+  if ( this->m_ComputeVoronoiMap )
+    {
+    VoronoiImageType *voronoiMap = this->GetVoronoiMap();
+    voronoiMap->SetBufferedRegion( voronoiMap->GetRequestedRegion() );
+    voronoiMap->Allocate();
+
+    VectorImageType *vectorMap = this->GetVectorDistanceMap();
+    vectorMap->SetBufferedRegion( vectorMap->GetRequestedRegion() );
+    vectorMap->Allocate();
+    }
+}
+
+template< typename TInputImage, typename TOutputImage, typename TVoronoiImage >
 unsigned int
-SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage >
+SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >
 ::SplitRequestedRegion(unsigned int i, unsigned int num,
   OutputImageRegionType & splitRegion)
 {
@@ -108,9 +179,9 @@ SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage >
   return maxThreadIdUsed + 1;
 }
 
-template< typename TInputImage, typename TOutputImage >
+template< typename TInputImage, typename TOutputImage, typename TVoronoiImage >
 void
-SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage >
+SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >
 ::GenerateData()
 {
   ThreadIdType nbthreads = this->GetNumberOfThreads();
@@ -162,6 +233,14 @@ SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage >
 
   this->GraftOutput( borderFilter->GetOutput() );
 
+  // the offsets to the closest boundary pixels are propagated along with
+  // the distances; they are initialized by the first pass
+  this->m_VectorDistanceMapCache = ITK_NULLPTR;
+  if ( this->m_ComputeVoronoiMap )
+    {
+    this->m_VectorDistanceMapCache = this->GetVectorDistanceMap();
+    }
+
   // Set up the multithreaded processing
   typename ImageSource< OutputImageType >::ThreadStruct str;
   str.Filter = this;
@@ -176,11 +255,13 @@ SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage >
     m_CurrentDimension = d;
     multithreader->SingleMethodExecute();
     }
+
+  this->m_VectorDistanceMapCache = ITK_NULLPTR;
 }
 
-template< typename TInputImage, typename TOutputImage >
+template< typename TInputImage, typename TOutputImage, typename TVoronoiImage >
 void
-SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage >
+SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                        ThreadIdType threadId)
 {
@@ -192,6 +273,18 @@ SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage >
 
   OutputImageType      *outputPtr = this->GetOutput();
 
+  // the boundary pixels are their own closest boundary pixel
+  if ( m_CurrentDimension == 0 && this->m_VectorDistanceMapCache )
+    {
+    OffsetType zeroOffset;
+    zeroOffset.Fill(0);
+    ImageRegionIterator< VectorImageType > vt(this->m_VectorDistanceMapCache, outputRegionForThread);
+    for ( vt.GoToBegin(); !vt.IsAtEnd(); ++vt )
+      {
+      vt.Set(zeroOffset);
+      }
+    }
+
   // compute the number of rows first, so we can setup a progress reporter
   std::vector< InputSizeValueType > NumberOfRows;
   for ( unsigned int i = 0; i < InputImageDimension; i++ )
@@ -319,11 +412,32 @@ SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage >
       progress2.CompletedPixel();
       }
     }
+
+  if ( m_CurrentDimension == ImageDimension - 1 && this->m_VectorDistanceMapCache )
+    {
+    ImageRegionIteratorWithIndex< VoronoiImageType > Vt(this->GetVoronoiMap(), outputRegionForThread);
+    ImageRegionConstIterator< VectorImageType >      Ct(this->m_VectorDistanceMapCache, outputRegionForThread);
+    ImageRegionConstIterator< InputImageType >       It(m_InputCache, outputRegionForThread);
+
+    while ( !Vt.IsAtEnd() )
+      {
+      InputPixelType label = It.Get();
+      if ( Math::ExactlyEquals( label, this->m_BackgroundValue ) )
+        {
+        label = m_InputCache->GetPixel( Vt.GetIndex() + Ct.Get() );
+        }
+      Vt.Set( static_cast< VoronoiPixelType >( label ) );
+
+      ++Vt;
+      ++Ct;
+      ++It;
+      }
+    }
 }
 
-template< typename TInputImage, typename TOutputImage >
+template< typename TInputImage, typename TOutputImage, typename TVoronoiImage >
 void
-SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage >
+SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >
 ::Voronoi(unsigned int d, OutputIndexType idx, OutputImageType *output)
 {
   OutputRegionType      oRegion = output->GetRequestedRegion();
@@ -332,6 +446,17 @@ SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage >
   vnl_vector< OutputPixelType > g(nd, 0 );
   vnl_vector< OutputPixelType > h(nd, 0 );
 
+  // position along the row and offset to the closest boundary pixel of
+  // the sites, when the vector distance map is computed
+  VectorImageType *vectorMap = this->m_VectorDistanceMapCache;
+  std::vector< OffsetValueType > s;
+  std::vector< OffsetType >      f;
+  if ( vectorMap )
+    {
+    s.resize(nd);
+    f.resize(nd);
+    }
+
 
   InputRegionType iRegion = m_InputCache->GetRequestedRegion();
   InputIndexType startIndex = iRegion.GetIndex();
@@ -377,6 +502,11 @@ SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage >
         g(l) = di;
         h(l) = iw;
         }
+      if ( vectorMap )
+        {
+        s[l] = static_cast< OffsetValueType >( i );
+        f[l] = vectorMap->GetPixel(idx);
+        }
       }
     }
 
@@ -418,6 +548,13 @@ SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage >
       }
     idx[d] = i + startIndex[d];
 
+    if ( vectorMap )
+      {
+      OffsetType offset = f[l];
+      offset[d] += s[l] - static_cast< OffsetValueType >( i );
+      vectorMap->SetPixel(idx, offset);
+      }
+
     if ( Math::NotExactlyEquals( m_InputCache->GetPixel(idx), this->m_BackgroundValue ) )
       {
       if ( this->m_InsideIsPositive )
@@ -443,9 +580,9 @@ SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage >
     }
 }
 
-template< typename TInputImage, typename TOutputImage >
+template< typename TInputImage, typename TOutputImage, typename TVoronoiImage >
 bool
-SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage >
+SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >
 ::Remove(OutputPixelType d1, OutputPixelType d2, OutputPixelType df,
          OutputPixelType x1, OutputPixelType x2, OutputPixelType xf)
 {
@@ -463,9 +600,9 @@ SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage >
 /**
  * Standard "PrintSelf" method
  */
-template< typename TInputImage, typename TOutputImage >
+template< typename TInputImage, typename TOutputImage, typename TVoronoiImage >
 void
-SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage >
+SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage, TVoronoiImage >
 ::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
@@ -479,6 +616,8 @@ SignedMaurerDistanceMapImageFilter< TInputImage, TOutputImage >
      << this->m_UseImageSpacing << std::endl;
   os << indent << "Squared distance: "
      << this->m_SquaredDistance << std::endl;
+  os << indent << "Compute Voronoi map: "
+     << this->m_ComputeVoronoiMap << std::endl;
 }
 } // end namespace itk
 
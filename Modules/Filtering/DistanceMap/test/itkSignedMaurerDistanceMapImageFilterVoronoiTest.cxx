@@ -0,0 +1,188 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkSignedMaurerDistanceMapImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkNeighborhoodIterator.h"
+#include "itkFilterWatcher.h"
+#include "itkTestingMacros.h"
+#include <algorithm>
+#include <vector>
+
+/* Computes the squared distance map, the Voronoi map and the vector
+ * distance map of a label image with anisotropic spacing, and checks them
+ * against a brute force search of the closest boundary pixel. */
+int itkSignedMaurerDistanceMapImageFilterVoronoiTest( int, char * [] )
+{
+  const unsigned int Dimension = 3;
+
+  typedef itk::Image< unsigned char, Dimension >  LabelImageType;
+  typedef itk::Image< float, Dimension >          DistanceImageType;
+  typedef itk::Image< unsigned short, Dimension > VoronoiImageType;
+
+  typedef itk::SignedMaurerDistanceMapImageFilter< LabelImageType, DistanceImageType, VoronoiImageType > FilterType;
+
+  LabelImageType::SizeType size;
+  size[0] = 23;
+  size[1] = 19;
+  size[2] = 15;
+  LabelImageType::SpacingType spacing;
+  spacing[0] = 1.0;
+  spacing[1] = 1.5;
+  spacing[2] = 0.75;
+
+  LabelImageType::Pointer image = LabelImageType::New();
+  image->SetRegions( size );
+  image->SetSpacing( spacing );
+  image->Allocate();
+  image->FillBuffer( 0 );
+
+  // A few objects with different labels, two of them touching
+  itk::ImageRegionIteratorWithIndex< LabelImageType > it( image, image->GetLargestPossibleRegion() );
+  for( ; !it.IsAtEnd(); ++it )
+    {
+    const LabelImageType::IndexType index = it.GetIndex();
+    if( index[0] >= 3 && index[0] < 9 && index[1] >= 4 && index[1] < 12 && index[2] >= 2 && index[2] < 8 )
+      {
+      it.Set( 3 );
+      }
+    else if( index[0] >= 9 && index[0] < 12 && index[1] >= 5 && index[1] < 9 && index[2] >= 3 && index[2] < 6 )
+      {
+      it.Set( 7 );
+      }
+    else if( ( index[0] - 17 ) * ( index[0] - 17 ) + ( index[1] - 13 ) * ( index[1] - 13 )
+             + ( index[2] - 10 ) * ( index[2] - 10 ) <= 6 )
+      {
+      it.Set( 12 );
+      }
+    }
+  LabelImageType::IndexType isolated;
+  isolated[0] = 20;
+  isolated[1] = 2;
+  isolated[2] = 3;
+  image->SetPixel( isolated, 5 );
+
+  // Boundary pixels: object pixels with a background neighbor
+  std::vector< LabelImageType::IndexType > boundary;
+  LabelImageType::SizeType radius;
+  radius.Fill( 1 );
+  itk::NeighborhoodIterator< LabelImageType > nit( radius, image, image->GetLargestPossibleRegion() );
+  for( ; !nit.IsAtEnd(); ++nit )
+    {
+    if( nit.GetCenterPixel() == 0 )
+      {
+      continue;
+      }
+    for( unsigned int n = 0; n < nit.Size(); n++ )
+      {
+      if( nit.GetPixel( n ) == 0 )
+        {
+        boundary.push_back( nit.GetIndex() );
+        break;
+        }
+      }
+    }
+
+  FilterType::Pointer filter = FilterType::New();
+  FilterWatcher watcher( filter, "filter" );
+  filter->SetInput( image );
+  filter->SquaredDistanceOn();
+  filter->UseImageSpacingOn();
+  filter->InsideIsPositiveOff();
+  TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+  DistanceImageType::Pointer reference = filter->GetOutput();
+  reference->DisconnectPipeline();
+
+  filter->ComputeVoronoiMapOn();
+  filter->SetNumberOfThreads( 4 );
+  TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+  if( filter->GetDistanceMap() != filter->GetOutput() )
+    {
+    std::cerr << "GetDistanceMap() is not the output" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const DistanceImageType::PixelType tolerance = 1e-4;
+
+  itk::ImageRegionConstIteratorWithIndex< DistanceImageType > dt( filter->GetDistanceMap(),
+    image->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< DistanceImageType > rt( reference, image->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< VoronoiImageType > vt( filter->GetVoronoiMap(), image->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< FilterType::VectorImageType > ct( filter->GetVectorDistanceMap(),
+    image->GetLargestPossibleRegion() );
+  for( ; !dt.IsAtEnd(); ++dt, ++rt, ++vt, ++ct )
+    {
+    const LabelImageType::IndexType index = dt.GetIndex();
+    const bool                      inside = image->GetPixel( index ) != 0;
+
+    // The distance does not depend on the other outputs
+    if( dt.Get() != rt.Get() )
+      {
+      std::cerr << "Distance changed at " << index << ": " << rt.Get() << " vs " << dt.Get() << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    // Brute force distance to the closest boundary pixel
+    double minimumDistance = itk::NumericTraits< double >::max();
+    for( size_t b = 0; b < boundary.size(); b++ )
+      {
+      double distance = 0.0;
+      for( unsigned int d = 0; d < Dimension; d++ )
+        {
+        const double component = ( boundary[b][d] - index[d] ) * spacing[d];
+        distance += component * component;
+        }
+      minimumDistance = std::min( minimumDistance, distance );
+      }
+    const double expected = inside ? -minimumDistance : minimumDistance;
+    if( std::abs( dt.Get() - expected ) > tolerance )
+      {
+      std::cerr << "Wrong distance at " << index << ": expected " << expected << ", got " << dt.Get() << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    // The offset leads to a boundary pixel at that distance
+    const LabelImageType::IndexType closest = index + ct.Get();
+    double                          offsetDistance = 0.0;
+    for( unsigned int d = 0; d < Dimension; d++ )
+      {
+      const double component = ct.Get()[d] * spacing[d];
+      offsetDistance += component * component;
+      }
+    if( std::find( boundary.begin(), boundary.end(), closest ) == boundary.end()
+        || std::abs( offsetDistance - minimumDistance ) > tolerance )
+      {
+      std::cerr << "Wrong offset at " << index << ": " << ct.Get() << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    // Background pixels take the label of the closest boundary pixel,
+    // object pixels keep theirs
+    const VoronoiImageType::PixelType label = inside ? image->GetPixel( index ) : image->GetPixel( closest );
+    if( vt.Get() != label )
+      {
+      std::cerr << "Wrong label at " << index << ": expected " << label << ", got " << vt.Get() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -22,6 +22,7 @@
 #include "itkIntTypes.h"
 #include "itkFastMarchingStoppingCriterionBase.h"
 #include "itkFastMarchingTraits.h"
+#include "itkFastMarchingPriorityQueue.h"
 
 #include <queue>
 #include <functional>
@@ -40,11 +41,15 @@ namespace itk
  *
  * Updates are preformed using an entropy satisfy scheme where only
  * "upwind" neighborhoods are used. This implementation of Fast Marching
- * uses a std::priority_queue to locate the next proper node to
+ * uses a FastMarchingPriorityQueue to locate the next proper node to
  * update.
  *
  * Fast Marching sweeps through N points in (N log N) steps to obtain
  * the arrival time value as the front propagates through the domain.
+ * With a positive BucketWidth, the priority queue is an untidy queue of
+ * buckets of values, and the N points are processed in N steps. The nodes
+ * of a bucket are processed in any order, which adds an error of the order
+ * of the bucket width to the arrival times.
  *
  * The initial front is specified by two containers:
  * \li one containing the known nodes (Alive Nodes: nodes that are already
@@ -68,9 +73,9 @@ namespace itk
  *    \li Superclass (itk::ImageToImageFilter or
  * itk::QuadEdgeMeshToQuadEdgeMeshFilter )
  *
- * \todo In the current implemenation, std::priority_queue only allows
- * taking nodes out from the front and putting nodes in from the back.
- * Use itk::PriorityQueueContainer instead.
+ * \todo The priority queue only allows taking nodes out from the front
+ * and putting nodes in from the back: a node whose value decreases is
+ * pushed again, and the previous entry is skipped when it comes out.
  *
  * \par Topology constraints:
  * Additional flexibiility in this class includes the implementation of
@@ -192,6 +197,14 @@ public:
   itkGetMacro( NormalizationFactor, double );
   itkSetMacro( NormalizationFactor, double );
 
+  /** \brief Set/Get the width of the buckets of values of the untidy
+   * priority queue. With the default null width, the nodes are processed in
+   * the exact order of their values with a binary heap. A width close to the
+   * time for the front to cross a node, as the spacing divided by the
+   * largest speed, gives a constant time per node. */
+  itkGetMacro( BucketWidth, double );
+  itkSetMacro( BucketWidth, double );
+
   /** \brief Get the value reached by the front when it stops propagating */
   itkGetMacro( TargetReachedValue, OutputPixelType );
 
@@ -218,6 +231,7 @@ protected:
   double m_SpeedConstant;
   double m_InverseSpeed;
   double m_NormalizationFactor;
+  double m_BucketWidth;
 
   OutputPixelType m_TargetReachedValue;
   OutputPixelType m_LargeValue;
@@ -231,14 +245,7 @@ protected:
   bool m_CollectPoints;
 
   //PriorityQueuePointer m_Heap;
-  typedef std::vector< NodePairType >   HeapContainerType;
-  typedef std::greater< NodePairType >  NodeComparerType;
-
-  typedef std::priority_queue<
-    NodeType,
-    HeapContainerType,
-    NodeComparerType >
-    PriorityQueueType;
+  typedef FastMarchingPriorityQueue< NodePairType > PriorityQueueType;
 
   PriorityQueueType m_Heap;
 
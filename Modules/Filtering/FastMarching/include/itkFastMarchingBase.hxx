@@ -43,6 +43,7 @@ FastMarchingBase()
   m_SpeedConstant = 1.;
   m_InverseSpeed = -1.;
   m_NormalizationFactor = 1.;
+  m_BucketWidth = 0.;
   m_TargetReachedValue = NumericTraits< OutputPixelType >::ZeroValue();
   m_TopologyCheck = Nothing;
   m_LargeValue = NumericTraits< OutputPixelType >::max();
@@ -69,6 +70,7 @@ PrintSelf( std::ostream & os, Indent indent ) const
   os << indent << "Speed constant: " << m_SpeedConstant << std::endl;
   os << indent << "Topology check: " << m_TopologyCheck << std::endl;
   os << indent << "Normalization Factor: " << m_NormalizationFactor << std::endl;
+  os << indent << "Bucket width: " << m_BucketWidth << std::endl;
   }
 
 // -----------------------------------------------------------------------------
@@ -95,6 +97,10 @@ Initialize( OutputDomainType* oDomain )
     {
     itkExceptionMacro( <<"SpeedConstant is null or negative" );
     }
+  if( m_BucketWidth < 0. )
+    {
+    itkExceptionMacro( <<"BucketWidth is negative" );
+    }
   if( m_CollectPoints )
     {
     if( m_ProcessedPoints.IsNull() )
@@ -104,10 +110,8 @@ Initialize( OutputDomainType* oDomain )
     }
 
   // make sure the heap is empty
-  while ( !m_Heap.empty() )
-    {
-    m_Heap.pop();
-    }
+  m_Heap.clear();
+  m_Heap.SetBucketWidth( m_BucketWidth );
   /*
   while ( !m_Heap->Empty() )
     {
@@ -195,10 +199,7 @@ GenerateData()
     // it.
     //
     // RELEASE MEMORY!!!
-    while( !m_Heap.empty() )
-      {
-      m_Heap.pop();
-      }
+    m_Heap.clear();
     /*while( !m_Heap->Empty() )
       {
       m_Heap->Pop();
@@ -210,10 +211,7 @@ GenerateData()
   m_TargetReachedValue = current_value;
 
   // let's release some useless memory...
-  while( !m_Heap.empty() )
-    {
-    m_Heap.pop();
-    }
+  m_Heap.clear();
   /*while( !m_Heap->Empty() )
     {
     m_Heap->Pop();
@@ -0,0 +1,207 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef itkFastMarchingPriorityQueue_h
+#define itkFastMarchingPriorityQueue_h
+
+#include "itkIntTypes.h"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace itk
+{
+/**
+\class FastMarchingPriorityQueue
+\brief Priority queue of the trial nodes of fast marching, with the lowest
+values first.
+
+It has the interface of the std::priority_queue it replaces in
+FastMarchingBase. With a null bucket width, the default, it is a binary
+heap and the nodes come out in the exact order of their values.
+
+With a positive bucket width, it is the untidy priority queue of
+L. Yatziv, A. Bartesaghi and G. Sapiro, "O(N) implementation of the fast
+marching algorithm", Journal of Computational Physics, 212(2):393-399,
+2006. The nodes are stored in buckets of values of this width, and push and
+pop take a constant time. The nodes of a bucket come out in any order, and a
+node pushed with a value lower than the current bucket is put in the current
+bucket, so the order of the values is only respected up to the width of the
+buckets. The nodes whose values are far beyond the current bucket are kept
+in a binary heap until the front reaches them.
+
+\ingroup ITKFastMarching
+*/
+template< typename TNodePair >
+class FastMarchingPriorityQueue
+  {
+public:
+  typedef TNodePair NodePairType;
+
+  FastMarchingPriorityQueue() : m_BucketWidth( 0. ), m_FirstBucket( 0. ),
+    m_Size( 0 ) {}
+
+  /** Set the width of the buckets. The queue must be empty. */
+  void SetBucketWidth( double iWidth )
+    {
+    m_BucketWidth = iWidth;
+    }
+  double GetBucketWidth() const
+    {
+    return m_BucketWidth;
+    }
+
+  bool empty() const
+    {
+    return m_Size == 0;
+    }
+
+  SizeValueType size() const
+    {
+    return m_Size;
+    }
+
+  /** Remove all the nodes, and release the memory. */
+  void clear()
+    {
+    std::vector< NodePairType >().swap( m_Heap );
+    std::deque< BucketType >().swap( m_Buckets );
+    m_Size = 0;
+    }
+
+  const NodePairType & top() const
+    {
+    if( m_BucketWidth > 0. )
+      {
+      return m_Buckets.front().back();
+      }
+    return m_Heap.front();
+    }
+
+  void push( const NodePairType & iNodePair )
+    {
+    ++m_Size;
+    if( m_BucketWidth > 0. && this->PushInBuckets( iNodePair ) )
+      {
+      return;
+      }
+    m_Heap.push_back( iNodePair );
+    std::push_heap( m_Heap.begin(), m_Heap.end(), std::greater< NodePairType >() );
+    }
+
+  void pop()
+    {
+    --m_Size;
+    if( m_BucketWidth > 0. )
+      {
+      m_Buckets.front().pop_back();
+
+      // move to the next bucket which is not empty, and bring the nodes of
+      // the heap which are now in the range of the buckets
+      while( !m_Buckets.empty() && m_Buckets.front().empty() )
+        {
+        m_Buckets.pop_front();
+        m_FirstBucket += 1.;
+        this->PopFromHeapToBuckets();
+        }
+      }
+    else
+      {
+      std::pop_heap( m_Heap.begin(), m_Heap.end(), std::greater< NodePairType >() );
+      m_Heap.pop_back();
+      }
+    }
+
+private:
+  typedef std::vector< NodePairType > BucketType;
+
+  /** The number of buckets after the current one. The nodes beyond them are
+   * kept in the heap. */
+  static SizeValueType MaximumNumberOfBuckets()
+    {
+    return 4096;
+    }
+
+  double BucketOf( const NodePairType & iNodePair ) const
+    {
+    return std::floor( static_cast< double >( iNodePair.GetValue() ) / m_BucketWidth );
+    }
+
+  /** Put the node in its bucket. Returns false if the node is too far from
+   * the current bucket. */
+  bool PushInBuckets( const NodePairType & iNodePair )
+    {
+    const double bucket = this->BucketOf( iNodePair );
+
+    // the buckets are only empty when the heap is empty too
+    if( m_Buckets.empty() )
+      {
+      m_FirstBucket = bucket;
+      }
+    if( bucket - m_FirstBucket >= static_cast< double >( MaximumNumberOfBuckets() ) )
+      {
+      return false;
+      }
+
+    SizeValueType position = 0;
+    if( bucket > m_FirstBucket )
+      {
+      position = static_cast< SizeValueType >( bucket - m_FirstBucket );
+      }
+    if( position >= m_Buckets.size() )
+      {
+      m_Buckets.resize( position + 1 );
+      }
+    m_Buckets[position].push_back( iNodePair );
+    return true;
+    }
+
+  /** Move the nodes of the heap which are in the range of the buckets. If
+   * the buckets are empty, they start at the lowest node of the heap. */
+  void PopFromHeapToBuckets()
+    {
+    if( m_Buckets.empty() && !m_Heap.empty() )
+      {
+      m_FirstBucket = this->BucketOf( m_Heap.front() );
+      }
+    while( !m_Heap.empty()
+           && this->BucketOf( m_Heap.front() ) - m_FirstBucket < static_cast< double >( MaximumNumberOfBuckets() ) )
+      {
+      const NodePairType nodePair = m_Heap.front();
+      std::pop_heap( m_Heap.begin(), m_Heap.end(), std::greater< NodePairType >() );
+      m_Heap.pop_back();
+
+      SizeValueType position = static_cast< SizeValueType >( this->BucketOf( nodePair ) - m_FirstBucket );
+      if( position >= m_Buckets.size() )
+        {
+        m_Buckets.resize( position + 1 );
+        }
+      m_Buckets[position].push_back( nodePair );
+      }
+    }
+
+  double                      m_BucketWidth;
+  double                      m_FirstBucket;
+  SizeValueType               m_Size;
+  std::vector< NodePairType > m_Heap;
+  std::deque< BucketType >    m_Buckets;
+  };
+}
+#endif
@@ -0,0 +1,158 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkFastMarchingImageFilterBase.h"
+#include "itkFastMarchingThresholdStoppingCriterion.h"
+#include "itkFastMarchingPriorityQueue.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+#include <cmath>
+
+namespace
+{
+typedef itk::NodePair< unsigned int, double > QueueNodePairType;
+
+/* Pushes values in the queue as a front does, several sawtooth sweeps
+ * which go back below the values already pushed, with some values far
+ * beyond the others, and checks that they come out in the order of their
+ * buckets. */
+bool
+CheckQueueOrder( double bucketWidth )
+{
+  itk::FastMarchingPriorityQueue< QueueNodePairType > queue;
+  queue.SetBucketWidth( bucketWidth );
+
+  const unsigned int numberOfValues = 10000;
+  for( unsigned int i = 0; i < numberOfValues; i++ )
+    {
+    double value = ( i % 97 ) * 0.37 + ( i / 97 ) * 0.1;
+    if( i % 7 == 0 )
+      {
+      value *= 1000.0;
+      }
+    queue.push( QueueNodePairType( i, value ) );
+    }
+
+  double        previous = 0.0;
+  unsigned int  numberOfPops = 0;
+  while( !queue.empty() )
+    {
+    const double value = queue.top().GetValue();
+    const double order = bucketWidth > 0.0 ? std::floor( value / bucketWidth ) : value;
+    if( order < previous )
+      {
+      std::cerr << "Bucket width " << bucketWidth << ": " << value << " comes out after " << previous << std::endl;
+      return false;
+      }
+    previous = order;
+    queue.pop();
+    numberOfPops++;
+    }
+  if( numberOfPops != numberOfValues )
+    {
+    std::cerr << "Bucket width " << bucketWidth << ": " << numberOfPops << " values instead of " << numberOfValues
+              << std::endl;
+    return false;
+    }
+  return true;
+}
+}
+
+/* Compares the arrival times computed with the untidy priority queue to the
+ * ones computed with the binary heap, on a 3D speed image with several
+ * seeds. */
+int itkFastMarchingBucketQueueTest( int, char * [] )
+{
+  if( !CheckQueueOrder( 0.0 ) || !CheckQueueOrder( 0.5 ) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  const unsigned int Dimension = 3;
+
+  typedef itk::Image< float, Dimension >                                              ImageType;
+  typedef itk::FastMarchingThresholdStoppingCriterion< ImageType, ImageType >         CriterionType;
+  typedef itk::FastMarchingImageFilterBase< ImageType, ImageType >                    FastMarchingType;
+  typedef FastMarchingType::NodePairType                                              NodePairType;
+  typedef FastMarchingType::NodePairContainerType                                     NodePairContainerType;
+
+  ImageType::SizeType size;
+  size.Fill( 64 );
+  ImageType::Pointer speed = ImageType::New();
+  speed->SetRegions( size );
+  speed->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > it( speed, speed->GetLargestPossibleRegion() );
+  for(; !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType index = it.GetIndex();
+    it.Set( static_cast< float >( 1.0 + 0.5 * std::sin( index[0] / 5.0 ) * std::cos( index[1] / 7.0 + index[2] / 3.0 ) ) );
+    }
+
+  NodePairContainerType::Pointer trial = NodePairContainerType::New();
+  for( unsigned int i = 0; i < 8; i++ )
+    {
+    ImageType::IndexType seed;
+    for( unsigned int d = 0; d < Dimension; d++ )
+      {
+      seed[d] = 8 + 48 * ( ( i >> d ) & 1 ) + 3 * d;
+      }
+    trial->push_back( NodePairType( seed, 0.0 ) );
+    }
+
+  // The front crosses a pixel in at least 1 / 1.5
+  const double bucketWidths[2] = { 0.0, 0.5 };
+  ImageType::Pointer outputs[2];
+  for( unsigned int i = 0; i < 2; i++ )
+    {
+    CriterionType::Pointer criterion = CriterionType::New();
+    criterion->SetThreshold( 1000.0 );
+
+    FastMarchingType::Pointer marcher = FastMarchingType::New();
+    marcher->SetInput( speed );
+    marcher->SetOutputSize( size );
+    marcher->SetTrialPoints( trial );
+    marcher->SetStoppingCriterion( criterion );
+    marcher->SetBucketWidth( bucketWidths[i] );
+    TEST_SET_GET_VALUE( bucketWidths[i], marcher->GetBucketWidth() );
+
+    TRY_EXPECT_NO_EXCEPTION( marcher->Update() );
+    outputs[i] = marcher->GetOutput();
+    }
+
+  // The nodes of a bucket are processed in any order, so a node can be
+  // computed before one of its upwind neighbors, by up to the bucket width,
+  // and the errors add up along the front.
+  double maximumError = 0.0;
+  double maximumValue = 0.0;
+  itk::ImageRegionIteratorWithIndex< ImageType > hit( outputs[0], outputs[0]->GetLargestPossibleRegion() );
+  itk::ImageRegionIteratorWithIndex< ImageType > bit( outputs[1], outputs[1]->GetLargestPossibleRegion() );
+  for(; !hit.IsAtEnd(); ++hit, ++bit )
+    {
+    maximumError = std::max( maximumError, static_cast< double >( std::abs( hit.Get() - bit.Get() ) ) );
+    maximumValue = std::max( maximumValue, static_cast< double >( hit.Get() ) );
+    }
+  std::cout << "Maximum arrival time " << maximumValue << ", maximum difference " << maximumError << std::endl;
+  if( maximumValue < 10.0 || maximumError > 2.0 * bucketWidths[1] )
+    {
+    std::cerr << "The arrival times with the buckets are too far from the ones with the heap" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -22,6 +22,7 @@
 #include "itkNumericTraits.h"
 #include "itkImageRegionSplitterDirection.h"
 #include "itkVariableLengthVector.h"
+#include "itkIsSame.h"
 
 namespace itk
 {
@@ -105,6 +106,19 @@ protected:
 
   void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId) ITK_OVERRIDE;
 
+  /** Filter the lines of the region one at a time. */
+  void ThreadedGenerateDataLineByLine(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId);
+
+  /** Filter the lines of the region by blocks of lines that are adjacent
+   * along the first dimension. A block is copied into a small tile in
+   * which the lines are interleaved, so that both the copies and
+   * FilterInterleavedDataArray() access memory contiguously. This is used
+   * for scalar pixels when the filtering direction is not the first
+   * dimension; otherwise it falls back to ThreadedGenerateDataLineByLine(). */
+  void ThreadedGenerateDataInBlocks(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId,
+                                    const TrueType &);
+  void ThreadedGenerateDataInBlocks(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId,
+                                    const FalseType &);
 
   virtual const ImageRegionSplitterBase* GetImageRegionSplitter(void) const ITK_OVERRIDE;
 
@@ -133,6 +147,17 @@ protected:
   void FilterDataArray(RealType *outs, const RealType *data, RealType *scratch,
                        SizeValueType ln);
 
+  /** Apply the Recursive Filter to numberOfLanes interleaved arrays of
+   * scalars: sample i of lane l is stored at [i * numberOfLanes + l] in
+   * "outs", "data" and "scratch", which all hold ln * numberOfLanes values.
+   * The lanes may be the components of multi-component pixels, or several
+   * lines filtered together; each lane gives the same result as
+   * FilterDataArray() on that lane alone. The inner loops run over the
+   * lanes, so they access memory contiguously and can be vectorized. */
+  void FilterInterleavedDataArray(ScalarRealType *outs, const ScalarRealType *data,
+                                  ScalarRealType *scratch, SizeValueType ln,
+                                  unsigned int numberOfLanes);
+
 protected:
   /** Causal coefficients that multiply the input data. */
   ScalarRealType m_N0;
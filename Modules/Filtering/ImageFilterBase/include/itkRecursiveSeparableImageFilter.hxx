@@ -21,8 +21,12 @@
 #include "itkRecursiveSeparableImageFilter.h"
 #include "itkObjectFactory.h"
 #include "itkImageLinearIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkProgressReporter.h"
 #include <new>
+#include <vector>
+#include <algorithm>
 
 namespace itk
 {
@@ -170,6 +174,120 @@ RecursiveSeparableImageFilter< TInputImage, TOutputImage >
     }
 }
 
+/**
+ * Apply Recursive Filter to interleaved lanes
+ */
+template< typename TInputImage, typename TOutputImage >
+void
+RecursiveSeparableImageFilter< TInputImage, TOutputImage >
+::FilterInterleavedDataArray(ScalarRealType *outs, const ScalarRealType *data,
+                             ScalarRealType *scratch, SizeValueType ln,
+                             unsigned int numberOfLanes)
+{
+  const SizeValueType L = numberOfLanes;
+
+  ScalarRealType * scratch1 = outs;
+  ScalarRealType * scratch2 = scratch;
+
+  /**
+   * Causal direction pass, with the borders initialized as in
+   * FilterDataArray
+   */
+  for ( SizeValueType l = 0; l < L; ++l )
+    {
+    const ScalarRealType *d = data + l;
+    ScalarRealType       *s = scratch1 + l;
+
+    // this value is assumed to exist from the border to infinity.
+    const ScalarRealType outV1 = d[0];
+
+    MathEMAMAMAM( s[0],   outV1   , m_N0, outV1   , m_N1, outV1   , m_N2, outV1, m_N3 );
+    MathEMAMAMAM( s[L],   d[L]    , m_N0, outV1   , m_N1, outV1   , m_N2, outV1, m_N3 );
+    MathEMAMAMAM( s[2*L], d[2*L]  , m_N0, d[L]    , m_N1, outV1   , m_N2, outV1, m_N3 );
+    MathEMAMAMAM( s[3*L], d[3*L]  , m_N0, d[2*L]  , m_N1, d[L]    , m_N2, outV1, m_N3 );
+
+    MathSMAMAMAM( s[0],   outV1   , m_BN1, outV1   , m_BN2, outV1 , m_BN3, outV1, m_BN4 );
+    MathSMAMAMAM( s[L],   s[0]    , m_D1 , outV1   , m_BN2, outV1 , m_BN3, outV1, m_BN4 );
+    MathSMAMAMAM( s[2*L], s[L]    , m_D1 , s[0]    , m_D2 , outV1 , m_BN3, outV1, m_BN4 );
+    MathSMAMAMAM( s[3*L], s[2*L]  , m_D1 , s[L]    , m_D2 , s[0]  , m_D3 , outV1, m_BN4 );
+    }
+
+  /**
+   * Recursively filter the rest
+   */
+  for ( SizeValueType i = 4; i < ln; i++ )
+    {
+    const ScalarRealType *d0 = data + i * L;
+    const ScalarRealType *d1 = d0 - L;
+    const ScalarRealType *d2 = d1 - L;
+    const ScalarRealType *d3 = d2 - L;
+    ScalarRealType       *s0 = scratch1 + i * L;
+    const ScalarRealType *s1 = s0 - L;
+    const ScalarRealType *s2 = s1 - L;
+    const ScalarRealType *s3 = s2 - L;
+    const ScalarRealType *s4 = s3 - L;
+    for ( SizeValueType l = 0; l < L; ++l )
+      {
+      ScalarRealType v = d0[l] * m_N0 + d1[l] * m_N1 + d2[l] * m_N2 + d3[l] * m_N3;
+      v -= s1[l] * m_D1 + s2[l] * m_D2 + s3[l] * m_D3 + s4[l] * m_D4;
+      s0[l] = v;
+      }
+    }
+
+  /**
+   * AntiCausal direction pass
+   */
+  for ( SizeValueType l = 0; l < L; ++l )
+    {
+    const ScalarRealType *d = data + ( ln - 1 ) * L + l;
+    ScalarRealType       *s = scratch2 + ( ln - 1 ) * L + l;
+
+    // this value is assumed to exist from the border to infinity.
+    const ScalarRealType outV2 = d[0];
+
+    MathEMAMAMAM( *( s ),       outV2      , m_M1, outV2      , m_M2, outV2    , m_M3, outV2, m_M4 );
+    MathEMAMAMAM( *( s - L ),   d[0]       , m_M1, outV2      , m_M2, outV2    , m_M3, outV2, m_M4 );
+    MathEMAMAMAM( *( s - 2*L ), *( d - L ) , m_M1, d[0]       , m_M2, outV2    , m_M3, outV2, m_M4 );
+    MathEMAMAMAM( *( s - 3*L ), *( d - 2*L ), m_M1, *( d - L ), m_M2, d[0]     , m_M3, outV2, m_M4 );
+
+    MathSMAMAMAM( *( s ),       outV2      , m_BM1, outV2     , m_BM2, outV2   , m_BM3, outV2, m_BM4 );
+    MathSMAMAMAM( *( s - L ),   *( s )     , m_D1 , outV2     , m_BM2, outV2   , m_BM3, outV2, m_BM4 );
+    MathSMAMAMAM( *( s - 2*L ), *( s - L ) , m_D1 , *( s )    , m_D2 , outV2   , m_BM3, outV2, m_BM4 );
+    MathSMAMAMAM( *( s - 3*L ), *( s - 2*L ), m_D1, *( s - L ), m_D2 , *( s )  , m_D3 , outV2, m_BM4 );
+    }
+
+  /**
+   * Recursively filter the rest
+   */
+  for ( SizeValueType i = ln - 4; i > 0; i-- )
+    {
+    const ScalarRealType *d0 = data + i * L;
+    const ScalarRealType *d1 = d0 + L;
+    const ScalarRealType *d2 = d1 + L;
+    const ScalarRealType *d3 = d2 + L;
+    ScalarRealType       *s0 = scratch2 + ( i - 1 ) * L;
+    const ScalarRealType *s1 = s0 + L;
+    const ScalarRealType *s2 = s1 + L;
+    const ScalarRealType *s3 = s2 + L;
+    const ScalarRealType *s4 = s3 + L;
+    for ( SizeValueType l = 0; l < L; ++l )
+      {
+      ScalarRealType v = d0[l] * m_M1 + d1[l] * m_M2 + d2[l] * m_M3 + d3[l] * m_M4;
+      v -= s1[l] * m_D1 + s2[l] * m_D2 + s3[l] * m_D3 + s4[l] * m_D4;
+      s0[l] = v;
+      }
+    }
+
+  /**
+   * Roll the antiCausal part into the output
+   */
+  const SizeValueType numberOfValues = ln * L;
+  for ( SizeValueType i = 0; i < numberOfValues; i++ )
+    {
+    outs[i] += scratch2[i];
+    }
+}
+
 //
 // we need all of the image in just the "Direction" we are separated into
 //
@@ -248,12 +366,119 @@ RecursiveSeparableImageFilter< TInputImage, TOutputImage >
 
 /**
  * Compute Recursive filter
- * line by line in one of the dimensions
+ * in one of the dimensions
  */
 template< typename TInputImage, typename TOutputImage >
 void
 RecursiveSeparableImageFilter< TInputImage, TOutputImage >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId)
+{
+  if ( this->m_Direction == 0 )
+    {
+    // The lines are already contiguous in memory
+    this->ThreadedGenerateDataLineByLine(outputRegionForThread, threadId);
+    }
+  else
+    {
+    this->ThreadedGenerateDataInBlocks( outputRegionForThread, threadId,
+                                        IsSame< RealType, ScalarRealType >() );
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+RecursiveSeparableImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateDataInBlocks(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId,
+                               const FalseType &)
+{
+  this->ThreadedGenerateDataLineByLine(outputRegionForThread, threadId);
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+RecursiveSeparableImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateDataInBlocks(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId,
+                               const TrueType &)
+{
+  typedef typename TOutputImage::PixelType OutputPixelType;
+
+  typedef ImageRegionConstIterator< TInputImage >           InputConstIteratorType;
+  typedef ImageRegionIterator< TOutputImage >               OutputIteratorType;
+  typedef ImageRegionConstIteratorWithIndex< TOutputImage > BlockStartIteratorType;
+
+  // Number of lines filtered together: 16 float pixels fill a cache line
+  // along the first dimension.
+  const SizeValueType maximumNumberOfLinesPerBlock = 16;
+
+  typename TInputImage::ConstPointer inputImage( this->GetInputImage () );
+  typename TOutputImage::Pointer     outputImage( this->GetOutput() );
+
+  const unsigned int  direction = this->m_Direction;
+  const SizeValueType ln = outputRegionForThread.GetSize(direction);
+  const SizeValueType firstDimensionSize = outputRegionForThread.GetSize(0);
+
+  std::vector< ScalarRealType > buffer( 3 * ln * maximumNumberOfLinesPerBlock );
+  ScalarRealType *inps = &buffer[0];
+  ScalarRealType *outs = inps + ln * maximumNumberOfLinesPerBlock;
+  ScalarRealType *scratch = outs + ln * maximumNumberOfLinesPerBlock;
+
+  const SizeValueType numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / ln;
+  ProgressReporter    progress(this, threadId, numberOfLinesToProcess, 10);
+
+  // The blocks start on the region of first samples of the lines, with
+  // one block start for the first dimension
+  OutputImageRegionType blockStartRegion = outputRegionForThread;
+  blockStartRegion.SetSize(0, 1);
+  blockStartRegion.SetSize(direction, 1);
+
+  BlockStartIteratorType blockStartIt(outputImage, blockStartRegion);
+  for ( blockStartIt.GoToBegin(); !blockStartIt.IsAtEnd(); ++blockStartIt )
+    {
+    typename OutputImageRegionType::SizeType blockSize;
+    blockSize.Fill(1);
+    blockSize[direction] = ln;
+    OutputImageRegionType blockRegion( blockStartIt.GetIndex(), blockSize );
+
+    for ( SizeValueType first = 0; first < firstDimensionSize; first += maximumNumberOfLinesPerBlock )
+      {
+      const SizeValueType numberOfLanes = std::min(maximumNumberOfLinesPerBlock, firstDimensionSize - first);
+      blockRegion.SetIndex(0, outputRegionForThread.GetIndex(0) + static_cast< IndexValueType >( first ) );
+      blockRegion.SetSize(0, numberOfLanes);
+
+      // The region iterators walk the first dimension fastest, which
+      // interleaves the lines of the block
+      InputConstIteratorType inputIterator(inputImage, blockRegion);
+      ScalarRealType *in = inps;
+      for ( ; !inputIterator.IsAtEnd(); ++inputIterator )
+        {
+        *in++ = static_cast< ScalarRealType >( inputIterator.Get() );
+        }
+
+      this->FilterInterleavedDataArray( outs, inps, scratch, ln, static_cast< unsigned int >( numberOfLanes ) );
+
+      OutputIteratorType outputIterator(outputImage, blockRegion);
+      const ScalarRealType *out = outs;
+      for ( ; !outputIterator.IsAtEnd(); ++outputIterator )
+        {
+        outputIterator.Set( static_cast< OutputPixelType >( *out++ ) );
+        }
+
+      for ( SizeValueType l = 0; l < numberOfLanes; ++l )
+        {
+        progress.CompletedPixel();
+        }
+      }
+    }
+}
+
+/**
+ * Compute Recursive filter
+ * line by line in one of the dimensions
+ */
+template< typename TInputImage, typename TOutputImage >
+void
+RecursiveSeparableImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateDataLineByLine(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId)
 {
   typedef typename TOutputImage::PixelType OutputPixelType;
 
@@ -0,0 +1,149 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSeparableNeighborhoodOperatorImageFilter_h
+#define itkSeparableNeighborhoodOperatorImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkNeighborhoodOperator.h"
+#include <vector>
+
+namespace itk
+{
+/** \class SeparableNeighborhoodOperatorImageFilter
+ * \brief Applies one directional NeighborhoodOperator per dimension in a
+ * single pass over the image.
+ *
+ * The result is the same as a chain of NeighborhoodOperatorImageFilter,
+ * one per operator, with the default ZeroFluxNeumannBoundaryCondition,
+ * except that the intermediate results are kept in double precision
+ * instead of being stored in an image of the output pixel type.
+ *
+ * No intermediate image is allocated. Each thread splits its output
+ * region into tiles small enough to stay in cache, copies the input of a
+ * tile padded by the operator radii into a buffer, and convolves the
+ * buffer along one direction after the other. The inner loops run along
+ * the first dimension for every direction, so they access memory
+ * contiguously and can be vectorized, and the symmetry or antisymmetry of
+ * the operators is used to halve the number of multiplications.
+ *
+ * The pixels may be scalars, fixed length vectors or the pixels of a
+ * VectorImage; all the components are filtered by the same operators.
+ *
+ * \sa NeighborhoodOperatorImageFilter
+ * \sa DiscreteGaussianImageFilter
+ * \ingroup ITKImageFilterBase
+ */
+template< typename TInputImage, typename TOutputImage, typename TOperatorValueType = double >
+class SeparableNeighborhoodOperatorImageFilter:
+  public ImageToImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard "Self" & Superclass typedef. */
+  typedef SeparableNeighborhoodOperatorImageFilter        Self;
+  typedef ImageToImageFilter< TInputImage, TOutputImage > Superclass;
+  typedef SmartPointer< Self >                            Pointer;
+  typedef SmartPointer< const Self >                      ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(SeparableNeighborhoodOperatorImageFilter, ImageToImageFilter);
+
+  itkStaticConstMacro(ImageDimension, unsigned int, TOutputImage::ImageDimension);
+
+  /** Image typedef support. */
+  typedef TInputImage                                InputImageType;
+  typedef TOutputImage                               OutputImageType;
+  typedef typename InputImageType::PixelType         InputPixelType;
+  typedef typename OutputImageType::PixelType        OutputPixelType;
+  typedef typename InputImageType::RegionType        InputImageRegionType;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+  typedef TOperatorValueType                         OperatorValueType;
+
+  typedef NeighborhoodOperator< OperatorValueType,
+                                itkGetStaticConstMacro(ImageDimension) > OperatorType;
+  typedef typename OperatorType::SizeType                                RadiusType;
+
+  /** Set the operator applied along operator.GetDirection(). The
+   * operator must have been created with CreateDirectional(); it replaces
+   * any operator previously set for the same direction. The coefficients
+   * are copied. */
+  void SetOperator(const OperatorType & op);
+
+  /** Remove all the operators. The directions without operator are not
+   * filtered. */
+  void ClearOperators();
+
+  /** Radius of the operators along each direction, zero for the
+   * directions that are not filtered. */
+  itkGetConstReferenceMacro(Radius, RadiusType);
+
+  /** The filter needs the output requested region padded by the radius
+   * of the operators.
+   *
+   * \sa ProcessObject::GenerateInputRequestedRegion() */
+  virtual void GenerateInputRequestedRegion() ITK_OVERRIDE;
+
+protected:
+  SeparableNeighborhoodOperatorImageFilter();
+  virtual ~SeparableNeighborhoodOperatorImageFilter() {}
+  void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+  void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                            ThreadIdType threadId) ITK_OVERRIDE;
+
+private:
+  SeparableNeighborhoodOperatorImageFilter(const Self &) ITK_DELETE_FUNCTION;
+  void operator=(const Self &) ITK_DELETE_FUNCTION;
+
+  typedef typename OutputImageRegionType::SizeType  SizeType;
+  typedef typename OutputImageRegionType::IndexType IndexType;
+
+  typedef enum { GeneralKernel, SymmetricKernel, AntisymmetricKernel } KernelSymmetryType;
+
+  /** Size of the tiles of the output region, chosen so that the padded
+   * input of a tile fits in a few hundred kilobytes. */
+  SizeType ComputeTileSize(const OutputImageRegionType & region, unsigned int numberOfComponents) const;
+
+  /** Copy the input pixels of the region into the buffer, with the
+   * components interleaved. The pixels outside the buffered region of the
+   * input are replaced by the closest pixel inside. */
+  void CopyInputRegion(const InputImageRegionType & region, unsigned int numberOfComponents,
+                       double *buffer) const;
+
+  /** Convolve the buffer along one direction. The output buffer is the
+   * input buffer cropped by the radius of the operator along the
+   * direction. */
+  void ConvolveAlongDirection(const double *input, const SizeType & inputSize,
+                              double *output, unsigned int direction,
+                              unsigned int numberOfComponents) const;
+
+  /** Coefficients of the operators, empty for the directions that are not
+   * filtered. */
+  std::vector< double > m_Kernels[ImageDimension];
+  KernelSymmetryType    m_KernelSymmetry[ImageDimension];
+  RadiusType            m_Radius;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkSeparableNeighborhoodOperatorImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,489 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSeparableNeighborhoodOperatorImageFilter_hxx
+#define itkSeparableNeighborhoodOperatorImageFilter_hxx
+
+#include "itkSeparableNeighborhoodOperatorImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkDefaultConvertPixelTraits.h"
+#include "itkNumericTraits.h"
+#include "itkProgressReporter.h"
+#include <algorithm>
+
+namespace itk
+{
+
+template< typename TInputImage, typename TOutputImage, typename TOperatorValueType >
+SeparableNeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::SeparableNeighborhoodOperatorImageFilter()
+{
+  this->ClearOperators();
+}
+
+template< typename TInputImage, typename TOutputImage, typename TOperatorValueType >
+void
+SeparableNeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::SetOperator(const OperatorType & op)
+{
+  const unsigned int direction = op.GetDirection();
+  if ( direction >= ImageDimension )
+    {
+    itkExceptionMacro("Direction of the operator is greater than ImageDimension");
+    }
+
+  const SizeValueType radius = op.GetRadius(direction);
+  if ( op.Size() != 2 * radius + 1 )
+    {
+    itkExceptionMacro("The operator along direction " << direction << " is not directional");
+    }
+
+  std::vector< double > & kernel = this->m_Kernels[direction];
+  kernel.resize( op.Size() );
+  for ( unsigned int i = 0; i < op.Size(); ++i )
+    {
+    kernel[i] = static_cast< double >( op[i] );
+    }
+
+  bool symmetric = true;
+  bool antisymmetric = true;
+  for ( SizeValueType j = 1; j <= radius; ++j )
+    {
+    symmetric = symmetric && ( kernel[radius - j] == kernel[radius + j] );
+    antisymmetric = antisymmetric && ( kernel[radius - j] == -kernel[radius + j] );
+    }
+  if ( symmetric )
+    {
+    this->m_KernelSymmetry[direction] = SymmetricKernel;
+    }
+  else if ( antisymmetric )
+    {
+    this->m_KernelSymmetry[direction] = AntisymmetricKernel;
+    }
+  else
+    {
+    this->m_KernelSymmetry[direction] = GeneralKernel;
+    }
+
+  this->m_Radius[direction] = radius;
+  this->Modified();
+}
+
+template< typename TInputImage, typename TOutputImage, typename TOperatorValueType >
+void
+SeparableNeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::ClearOperators()
+{
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    this->m_Kernels[d].clear();
+    this->m_KernelSymmetry[d] = GeneralKernel;
+    }
+  this->m_Radius.Fill(0);
+  this->Modified();
+}
+
+template< typename TInputImage, typename TOutputImage, typename TOperatorValueType >
+void
+SeparableNeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::GenerateInputRequestedRegion()
+{
+  // call the superclass' implementation of this method. this should
+  // copy the output requested region to the input requested region
+  Superclass::GenerateInputRequestedRegion();
+
+  InputImageType *inputPtr = const_cast< InputImageType * >( this->GetInput() );
+
+  if ( !inputPtr )
+    {
+    return;
+    }
+
+  // pad the input requested region by the operator radii
+  InputImageRegionType inputRequestedRegion = inputPtr->GetRequestedRegion();
+  inputRequestedRegion.PadByRadius(this->m_Radius);
+
+  // crop the input requested region at the input's largest possible region
+  if ( inputRequestedRegion.Crop( inputPtr->GetLargestPossibleRegion() ) )
+    {
+    inputPtr->SetRequestedRegion(inputRequestedRegion);
+    return;
+    }
+  else
+    {
+    // Couldn't crop the region (requested region is outside the largest
+    // possible region).  Throw an exception.
+
+    // store what we tried to request (prior to trying to crop)
+    inputPtr->SetRequestedRegion(inputRequestedRegion);
+
+    // build an exception
+    InvalidRequestedRegionError e(__FILE__, __LINE__);
+    e.SetLocation(ITK_LOCATION);
+    e.SetDescription("Requested region is (at least partially) outside the largest possible region.");
+    e.SetDataObject(inputPtr);
+    throw e;
+    }
+}
+
+template< typename TInputImage, typename TOutputImage, typename TOperatorValueType >
+typename SeparableNeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >::SizeType
+SeparableNeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::ComputeTileSize(const OutputImageRegionType & region, unsigned int numberOfComponents) const
+{
+  // Maximum number of values in the padded input of a tile
+  const SizeValueType maximumNumberOfTileValues = 1 << 16;
+
+  SizeType tileSize = region.GetSize();
+  while ( true )
+    {
+    SizeValueType numberOfTileValues = numberOfComponents;
+    for ( unsigned int d = 0; d < ImageDimension; ++d )
+      {
+      numberOfTileValues *= tileSize[d] + 2 * this->m_Radius[d];
+      }
+    if ( numberOfTileValues <= maximumNumberOfTileValues )
+      {
+      break;
+      }
+
+    // Halve the largest size along the directions after the first one,
+    // then along the first one, keeping the tiles large enough compared
+    // to the radii for the padding to remain a small overhead
+    int          largestDirection = -1;
+    unsigned int d = ImageDimension;
+    while ( d > 0 )
+      {
+      --d;
+      const SizeValueType minimumSize = std::max( static_cast< SizeValueType >( d == 0 ? 64 : 16 ),
+                                                  4 * this->m_Radius[d] );
+      if ( tileSize[d] >= 2 * minimumSize
+           && ( largestDirection < 0 || tileSize[d] > tileSize[largestDirection] ) )
+        {
+        largestDirection = d;
+        }
+      if ( d == 1 && largestDirection >= 0 )
+        {
+        break;
+        }
+      }
+    if ( largestDirection < 0 )
+      {
+      break;
+      }
+    tileSize[largestDirection] = ( tileSize[largestDirection] + 1 ) / 2;
+    }
+
+  return tileSize;
+}
+
+template< typename TInputImage, typename TOutputImage, typename TOperatorValueType >
+void
+SeparableNeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::CopyInputRegion(const InputImageRegionType & region, unsigned int numberOfComponents,
+                  double *buffer) const
+{
+  typedef DefaultConvertPixelTraits< InputPixelType > InputPixelTraits;
+  typedef ImageRegionConstIterator< InputImageType >  InputIteratorType;
+
+  const InputImageType *       input = this->GetInput();
+  const InputImageRegionType & bufferedRegion = input->GetBufferedRegion();
+
+  const SizeType &     size = region.GetSize();
+  const IndexValueType rowStart = region.GetIndex(0);
+  const IndexValueType rowEnd = rowStart + static_cast< IndexValueType >( size[0] );
+  const IndexValueType bufferedStart = bufferedRegion.GetIndex(0);
+  const IndexValueType bufferedEnd = bufferedStart + static_cast< IndexValueType >( bufferedRegion.GetSize(0) );
+
+  // Part of the rows inside the buffered region
+  const IndexValueType insideStart = std::max(rowStart, bufferedStart);
+  const IndexValueType insideEnd = std::min(rowEnd, bufferedEnd);
+  const SizeValueType  rowLength = size[0] * numberOfComponents;
+
+  SizeValueType numberOfRows = 1;
+  for ( unsigned int d = 1; d < ImageDimension; ++d )
+    {
+    numberOfRows *= size[d];
+    }
+
+  IndexType rowIndex = region.GetIndex();
+  for ( SizeValueType row = 0; row < numberOfRows; ++row )
+    {
+    // Replace the indices outside the buffered region by the closest
+    // index inside
+    IndexType insideIndex = rowIndex;
+    insideIndex[0] = insideStart;
+    for ( unsigned int d = 1; d < ImageDimension; ++d )
+      {
+      const IndexValueType first = bufferedRegion.GetIndex(d);
+      const IndexValueType last = first + static_cast< IndexValueType >( bufferedRegion.GetSize(d) ) - 1;
+      insideIndex[d] = std::min( std::max(rowIndex[d], first), last );
+      }
+    SizeType insideSize;
+    insideSize.Fill(1);
+    insideSize[0] = static_cast< SizeValueType >( insideEnd - insideStart );
+
+    double *rowBuffer = buffer + row * rowLength;
+    double *value = rowBuffer + ( insideStart - rowStart ) * numberOfComponents;
+
+    InputIteratorType it( input, InputImageRegionType(insideIndex, insideSize) );
+    for ( ; !it.IsAtEnd(); ++it )
+      {
+      const InputPixelType pixel = it.Get();
+      for ( unsigned int c = 0; c < numberOfComponents; ++c )
+        {
+        *value++ = static_cast< double >( InputPixelTraits::GetNthComponent(c, pixel) );
+        }
+      }
+
+    // Extend the row with its first and last pixels
+    const double *firstPixel = rowBuffer + ( insideStart - rowStart ) * numberOfComponents;
+    for ( double *v = rowBuffer; v < firstPixel; v += numberOfComponents )
+      {
+      std::copy(firstPixel, firstPixel + numberOfComponents, v);
+      }
+    const double *lastPixel = value - numberOfComponents;
+    for ( double *v = value; v < rowBuffer + rowLength; v += numberOfComponents )
+      {
+      std::copy(lastPixel, lastPixel + numberOfComponents, v);
+      }
+
+    // Next row
+    for ( unsigned int d = 1; d < ImageDimension; ++d )
+      {
+      ++rowIndex[d];
+      if ( rowIndex[d] < region.GetIndex(d) + static_cast< IndexValueType >( size[d] ) )
+        {
+        break;
+        }
+      rowIndex[d] = region.GetIndex(d);
+      }
+    }
+}
+
+template< typename TInputImage, typename TOutputImage, typename TOperatorValueType >
+void
+SeparableNeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::ConvolveAlongDirection(const double *input, const SizeType & inputSize,
+                         double *output, unsigned int direction,
+                         unsigned int numberOfComponents) const
+{
+  const std::vector< double > & kernel = this->m_Kernels[direction];
+  const SizeValueType           radius = this->m_Radius[direction];
+
+  SizeType outputSize = inputSize;
+  outputSize[direction] -= 2 * radius;
+
+  // Strides of the input buffer, in values
+  SizeValueType inputStrides[ImageDimension];
+  inputStrides[0] = numberOfComponents;
+  for ( unsigned int d = 1; d < ImageDimension; ++d )
+    {
+    inputStrides[d] = inputStrides[d - 1] * inputSize[d - 1];
+    }
+  const SizeValueType stride = inputStrides[direction];
+
+  const SizeValueType rowLength = outputSize[0] * numberOfComponents;
+  SizeValueType       numberOfRows = 1;
+  for ( unsigned int d = 1; d < ImageDimension; ++d )
+    {
+    numberOfRows *= outputSize[d];
+    }
+
+  // Every output row is computed from rows of the input, so that the
+  // inner loops are contiguous whatever the direction
+  SizeValueType rowPosition[ImageDimension];
+  std::fill(rowPosition, rowPosition + ImageDimension, 0);
+  SizeValueType inputOffset = 0;
+  for ( SizeValueType row = 0; row < numberOfRows; ++row )
+    {
+    const double *center = input + inputOffset + radius * stride;
+    double *      out = output + row * rowLength;
+
+    const double centerWeight = kernel[radius];
+    for ( SizeValueType i = 0; i < rowLength; ++i )
+      {
+      out[i] = centerWeight * center[i];
+      }
+
+    switch ( this->m_KernelSymmetry[direction] )
+      {
+      case SymmetricKernel:
+        for ( SizeValueType j = 1; j <= radius; ++j )
+          {
+          const double   weight = kernel[radius + j];
+          const double * before = center - j * stride;
+          const double * after = center + j * stride;
+          for ( SizeValueType i = 0; i < rowLength; ++i )
+            {
+            out[i] += weight * ( before[i] + after[i] );
+            }
+          }
+        break;
+      case AntisymmetricKernel:
+        for ( SizeValueType j = 1; j <= radius; ++j )
+          {
+          const double   weight = kernel[radius + j];
+          const double * before = center - j * stride;
+          const double * after = center + j * stride;
+          for ( SizeValueType i = 0; i < rowLength; ++i )
+            {
+            out[i] += weight * ( after[i] - before[i] );
+            }
+          }
+        break;
+      default:
+        for ( SizeValueType j = 0; j < kernel.size(); ++j )
+          {
+          if ( j == radius )
+            {
+            continue;
+            }
+          const double   weight = kernel[j];
+          const double * in = input + inputOffset + j * stride;
+          for ( SizeValueType i = 0; i < rowLength; ++i )
+            {
+            out[i] += weight * in[i];
+            }
+          }
+        break;
+      }
+
+    // Next row
+    for ( unsigned int d = 1; d < ImageDimension; ++d )
+      {
+      ++rowPosition[d];
+      inputOffset += inputStrides[d];
+      if ( rowPosition[d] < outputSize[d] )
+        {
+        break;
+        }
+      inputOffset -= rowPosition[d] * inputStrides[d];
+      rowPosition[d] = 0;
+      }
+    }
+}
+
+template< typename TInputImage, typename TOutputImage, typename TOperatorValueType >
+void
+SeparableNeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                       ThreadIdType threadId)
+{
+  typedef DefaultConvertPixelTraits< OutputPixelType > OutputPixelTraits;
+  typedef typename OutputPixelTraits::ComponentType    OutputComponentType;
+  typedef ImageRegionIterator< OutputImageType >       OutputIteratorType;
+
+  if ( outputRegionForThread.GetNumberOfPixels() == 0 )
+    {
+    return;
+    }
+
+  OutputImageType *  output = this->GetOutput();
+  const unsigned int numberOfComponents = this->GetInput()->GetNumberOfComponentsPerPixel();
+
+  const SizeType & regionSize = outputRegionForThread.GetSize();
+  const SizeType   tileSize = this->ComputeTileSize(outputRegionForThread, numberOfComponents);
+  SizeValueType    numberOfTiles = 1;
+  SizeValueType    numberOfTileValues = numberOfComponents;
+  SizeValueType    tilesPerDirection[ImageDimension];
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    tilesPerDirection[d] = ( regionSize[d] + tileSize[d] - 1 ) / tileSize[d];
+    numberOfTiles *= tilesPerDirection[d];
+    numberOfTileValues *= tileSize[d] + 2 * this->m_Radius[d];
+    }
+
+  std::vector< double > buffer(numberOfTileValues);
+  std::vector< double > filtered(numberOfTileValues);
+
+  OutputPixelType value;
+  NumericTraits< OutputPixelType >::SetLength(value, numberOfComponents);
+
+  ProgressReporter progress(this, threadId, numberOfTiles);
+
+  for ( SizeValueType tile = 0; tile < numberOfTiles; ++tile )
+    {
+    // Region of the tile
+    OutputImageRegionType tileRegion;
+    SizeValueType         tilePosition = tile;
+    for ( unsigned int d = 0; d < ImageDimension; ++d )
+      {
+      const SizeValueType position = tilePosition % tilesPerDirection[d];
+      tilePosition /= tilesPerDirection[d];
+      const SizeValueType start = position * tileSize[d];
+      tileRegion.SetIndex( d, outputRegionForThread.GetIndex(d) + static_cast< IndexValueType >( start ) );
+      tileRegion.SetSize( d, std::min(tileSize[d], regionSize[d] - start) );
+      }
+
+    InputImageRegionType paddedRegion = tileRegion;
+    paddedRegion.PadByRadius(this->m_Radius);
+    this->CopyInputRegion(paddedRegion, numberOfComponents, &buffer[0]);
+
+    // The directions are filtered from the last one, each pass cropping
+    // the padding along its direction
+    SizeType     size = paddedRegion.GetSize();
+    unsigned int d = ImageDimension;
+    while ( d > 0 )
+      {
+      --d;
+      if ( this->m_Kernels[d].empty() )
+        {
+        continue;
+        }
+      this->ConvolveAlongDirection(&buffer[0], size, &filtered[0], d, numberOfComponents);
+      size[d] -= 2 * this->m_Radius[d];
+      buffer.swap(filtered);
+      }
+
+    const double *v = &buffer[0];
+    OutputIteratorType it(output, tileRegion);
+    for ( ; !it.IsAtEnd(); ++it )
+      {
+      for ( unsigned int c = 0; c < numberOfComponents; ++c )
+        {
+        OutputPixelTraits::SetNthComponent( c, value, static_cast< OutputComponentType >( *v++ ) );
+        }
+      it.Set(value);
+      }
+
+    progress.CompletedPixel();
+    }
+}
+
+template< typename TInputImage, typename TOutputImage, typename TOperatorValueType >
+void
+SeparableNeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Radius: " << this->m_Radius << std::endl;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    os << indent << "Kernel[" << d << "]:";
+    for ( unsigned int i = 0; i < this->m_Kernels[d].size(); ++i )
+      {
+      os << " " << this->m_Kernels[d][i];
+      }
+    os << std::endl;
+    }
+}
+} // end namespace itk
+
+#endif
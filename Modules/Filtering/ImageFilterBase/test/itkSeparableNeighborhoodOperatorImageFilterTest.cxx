@@ -0,0 +1,244 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkSeparableNeighborhoodOperatorImageFilter.h"
+#include "itkNeighborhoodOperatorImageFilter.h"
+#include "itkVectorNeighborhoodOperatorImageFilter.h"
+#include "itkGaussianOperator.h"
+#include "itkGaussianDerivativeOperator.h"
+#include "itkForwardDifferenceOperator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkFilterWatcher.h"
+#include "itkTestingMacros.h"
+
+/* Applies a symmetric, an antisymmetric and a general operator along the
+ * three directions of a scalar image, over the whole image and over a
+ * requested region, and a Gaussian to an image of vectors, and checks the
+ * results against chains of NeighborhoodOperatorImageFilter. */
+int itkSeparableNeighborhoodOperatorImageFilterTest( int, char * [] )
+{
+  const unsigned int Dimension = 3;
+
+  typedef itk::Image< float, Dimension >           ImageType;
+  typedef itk::Image< double, Dimension >          RealImageType;
+  typedef itk::Image< itk::Vector< float, 2 >, 2 > VectorImageType;
+
+  typedef itk::SeparableNeighborhoodOperatorImageFilter< ImageType, ImageType >             FilterType;
+  typedef itk::SeparableNeighborhoodOperatorImageFilter< VectorImageType, VectorImageType > VectorFilterType;
+
+  // Input with a non zero start index
+  ImageType::IndexType start;
+  start[0] = -3;
+  start[1] = 5;
+  start[2] = 2;
+  ImageType::SizeType size;
+  size[0] = 150;
+  size[1] = 40;
+  size[2] = 23;
+  ImageType::RegionType region( start, size );
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( region );
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, region );
+  for( ; !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType index = it.GetIndex();
+    float value = static_cast< float >( std::sin( 0.1 * index[0] ) * std::cos( 0.3 * index[1] ) + 0.05 * index[2] );
+    if( ( index[0] * 7 + index[1] * 3 + index[2] ) % 31 == 0 )
+      {
+      value += 20.0f;
+      }
+    it.Set( value );
+    }
+
+  // Operators
+  itk::GaussianOperator< double, Dimension > gaussian;
+  gaussian.SetDirection( 0 );
+  gaussian.SetVariance( 6.0 );
+  gaussian.SetMaximumError( 0.001 );
+  gaussian.SetMaximumKernelWidth( 64 );
+  gaussian.CreateDirectional();
+
+  itk::GaussianDerivativeOperator< double, Dimension > derivative;
+  derivative.SetDirection( 1 );
+  derivative.SetVariance( 2.0 );
+  derivative.SetOrder( 1 );
+  derivative.CreateDirectional();
+
+  itk::ForwardDifferenceOperator< double, Dimension > difference;
+  difference.SetDirection( 2 );
+  difference.CreateDirectional();
+
+  // Reference: one filter per operator, in double precision
+  typedef itk::NeighborhoodOperatorImageFilter< ImageType, RealImageType, double >     FirstReferenceType;
+  typedef itk::NeighborhoodOperatorImageFilter< RealImageType, RealImageType, double > ReferenceType;
+
+  FirstReferenceType::Pointer reference0 = FirstReferenceType::New();
+  reference0->SetInput( image );
+  reference0->SetOperator( gaussian );
+  ReferenceType::Pointer reference1 = ReferenceType::New();
+  reference1->SetInput( reference0->GetOutput() );
+  reference1->SetOperator( derivative );
+  ReferenceType::Pointer reference2 = ReferenceType::New();
+  reference2->SetInput( reference1->GetOutput() );
+  reference2->SetOperator( difference );
+  TRY_EXPECT_NO_EXCEPTION( reference2->Update() );
+
+  FilterType::Pointer filter = FilterType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( filter, SeparableNeighborhoodOperatorImageFilter );
+  FilterWatcher watcher( filter, "filter" );
+  filter->SetInput( image );
+  filter->SetOperator( gaussian );
+  filter->SetOperator( derivative );
+  filter->SetOperator( difference );
+  filter->SetNumberOfThreads( 3 );
+  TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+  if( filter->GetRadius()[0] != gaussian.GetRadius( 0 )
+      || filter->GetRadius()[1] != derivative.GetRadius( 1 )
+      || filter->GetRadius()[2] != 1 )
+    {
+    std::cerr << "Wrong radius " << filter->GetRadius() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const double tolerance = 1e-4;
+  itk::ImageRegionConstIterator< RealImageType > referenceIt( reference2->GetOutput(), region );
+  itk::ImageRegionConstIteratorWithIndex< ImageType > outputIt( filter->GetOutput(), region );
+  for( ; !outputIt.IsAtEnd(); ++outputIt, ++referenceIt )
+    {
+    if( std::abs( outputIt.Get() - referenceIt.Get() ) > tolerance )
+      {
+      std::cerr << "Mismatch at " << outputIt.GetIndex() << ": expected " << referenceIt.Get()
+                << ", got " << outputIt.Get() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Requested region in the middle of the image
+  ImageType::RegionType requestedRegion( region );
+  requestedRegion.ShrinkByRadius( 4 );
+  requestedRegion.SetSize( 0, 61 );
+
+  FilterType::Pointer streamedFilter = FilterType::New();
+  streamedFilter->SetInput( image );
+  streamedFilter->SetOperator( gaussian );
+  streamedFilter->SetOperator( derivative );
+  streamedFilter->SetOperator( difference );
+  streamedFilter->GetOutput()->SetRequestedRegion( requestedRegion );
+  TRY_EXPECT_NO_EXCEPTION( streamedFilter->Update() );
+
+  itk::ImageRegionConstIteratorWithIndex< ImageType > streamedIt( streamedFilter->GetOutput(), requestedRegion );
+  for( ; !streamedIt.IsAtEnd(); ++streamedIt )
+    {
+    const double expected = reference2->GetOutput()->GetPixel( streamedIt.GetIndex() );
+    if( std::abs( streamedIt.Get() - expected ) > tolerance )
+      {
+      std::cerr << "Mismatch in the requested region at " << streamedIt.GetIndex() << ": expected " << expected
+                << ", got " << streamedIt.Get() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Without operators the input is copied
+  filter->ClearOperators();
+  TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+  outputIt.GoToBegin();
+  itk::ImageRegionConstIterator< ImageType > inputIt( image, region );
+  for( ; !outputIt.IsAtEnd(); ++outputIt, ++inputIt )
+    {
+    if( outputIt.Get() != inputIt.Get() )
+      {
+      std::cerr << "The input was not copied at " << outputIt.GetIndex() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // A non directional operator is rejected
+  itk::GaussianOperator< double, Dimension > nonDirectional;
+  nonDirectional.SetDirection( 0 );
+  nonDirectional.SetVariance( 1.0 );
+  ImageType::SizeType radius;
+  radius.Fill( 1 );
+  nonDirectional.CreateToRadius( radius );
+  TRY_EXPECT_EXCEPTION( filter->SetOperator( nonDirectional ) );
+
+  // Image of vectors
+  VectorImageType::SizeType vectorSize;
+  vectorSize[0] = 33;
+  vectorSize[1] = 27;
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  vectorImage->SetRegions( vectorSize );
+  vectorImage->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< VectorImageType > vectorIt( vectorImage, vectorImage->GetLargestPossibleRegion() );
+  for( ; !vectorIt.IsAtEnd(); ++vectorIt )
+    {
+    const VectorImageType::IndexType index = vectorIt.GetIndex();
+    VectorImageType::PixelType v;
+    v[0] = static_cast< float >( index[0] % 5 );
+    v[1] = static_cast< float >( std::cos( 0.2 * index[1] ) );
+    vectorIt.Set( v );
+    }
+
+  typedef itk::VectorNeighborhoodOperatorImageFilter< VectorImageType, VectorImageType > VectorReferenceType;
+  VectorFilterType::Pointer vectorFilter = VectorFilterType::New();
+  vectorFilter->SetInput( vectorImage );
+  VectorImageType::Pointer vectorReference = vectorImage;
+  for( unsigned int d = 0; d < 2; d++ )
+    {
+    itk::GaussianOperator< double, 2 > vectorGaussian;
+    vectorGaussian.SetDirection( d );
+    vectorGaussian.SetVariance( 1.5 + d );
+    vectorGaussian.CreateDirectional();
+    vectorFilter->SetOperator( vectorGaussian );
+
+    itk::GaussianOperator< float, 2 > floatGaussian;
+    floatGaussian.SetDirection( d );
+    floatGaussian.SetVariance( 1.5 + d );
+    floatGaussian.CreateDirectional();
+    VectorReferenceType::Pointer referenceFilter = VectorReferenceType::New();
+    referenceFilter->SetInput( vectorReference );
+    referenceFilter->SetOperator( floatGaussian );
+    TRY_EXPECT_NO_EXCEPTION( referenceFilter->Update() );
+    vectorReference = referenceFilter->GetOutput();
+    vectorReference->DisconnectPipeline();
+    }
+  TRY_EXPECT_NO_EXCEPTION( vectorFilter->Update() );
+
+  itk::ImageRegionConstIteratorWithIndex< VectorImageType > vectorOutputIt( vectorFilter->GetOutput(),
+    vectorImage->GetLargestPossibleRegion() );
+  for( ; !vectorOutputIt.IsAtEnd(); ++vectorOutputIt )
+    {
+    const VectorImageType::PixelType expected = vectorReference->GetPixel( vectorOutputIt.GetIndex() );
+    for( unsigned int c = 0; c < 2; c++ )
+      {
+      if( std::abs( vectorOutputIt.Get()[c] - expected[c] ) > tolerance )
+        {
+        std::cerr << "Vector mismatch at " << vectorOutputIt.GetIndex() << ": expected " << expected
+                  << ", got " << vectorOutputIt.Get() << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
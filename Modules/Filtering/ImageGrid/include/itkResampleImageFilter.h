@@ -73,6 +73,18 @@ namespace itk
  * \warning For multithreading, the TransformPoint method of the
  * user-designated coordinate transform must be threadsafe.
  *
+ * When the same transform is applied to several images on the same output
+ * grid (e.g. labels, several modalities or time points), the transform can
+ * be evaluated once: compute its displacement field on the output grid
+ * with TransformToDisplacementFieldFilter and pass it to each resampler
+ * with SetDisplacementField(). The field replaces the transform, and each
+ * output pixel reads its displacement directly, without interpolating the
+ * field. The field must have the origin, spacing and direction of the
+ * output. For outputs too large to hold the field in memory, connect the
+ * TransformToDisplacementFieldFilter output instead of a cached image and
+ * stream the resampler (e.g. with StreamingImageFilter): each output tile
+ * then only requests, and computes, the matching tile of the field.
+ *
  * \ingroup GeometricTransform
  * \ingroup ITKImageGrid
  *
@@ -183,6 +195,10 @@ public:
   /** Typedef the reference image type to be the ImageBase of the OutputImageType */
   typedef ImageBase<ImageDimension> ReferenceImageBaseType;
 
+  /** Displacement field typedef. */
+  typedef Vector< TTransformPrecisionType, ImageDimension > DisplacementType;
+  typedef Image< DisplacementType, ImageDimension >         DisplacementFieldType;
+
   /** Get/Set the coordinate transformation.
    * Set the coordinate transform to use for resampling.  Note that this must
    * be in physical coordinates and it is the output-to-input transform, NOT
@@ -262,6 +278,14 @@ public:
   itkBooleanMacro(UseReferenceImage);
   itkGetConstMacro(UseReferenceImage, bool);
 
+  /** Set/Get an optional displacement field sampled on the output grid.
+   *  When set, the input point of each output pixel is its physical point
+   *  plus the displacement at the same index, and the transform is not
+   *  used. The field must have the origin, spacing and direction of the
+   *  output image and cover the output requested region. */
+  itkSetInputMacro(DisplacementField, DisplacementFieldType);
+  itkGetInputMacro(DisplacementField, DisplacementFieldType);
+
   /** ResampleImageFilter produces an image which is a different size
    * than its input.  As such, it needs to provide an implementation
    * for GenerateOutputInformation() in order to inform the pipeline
@@ -332,6 +356,22 @@ protected:
                                           outputRegionForThread,
                                           ThreadIdType threadId);
 
+  /** Implementation for resampling through a displacement field set with
+   *  SetDisplacementField(). */
+  virtual void DisplacementFieldThreadedGenerateData(const OutputImageRegionType &
+                                                     outputRegionForThread,
+                                                     ThreadIdType threadId);
+
+  /** Compute the range [spanBegin, spanEnd) of pixels of a scanline of
+   * length lineLength, starting at the continuous input index startIndex
+   * and advancing by delta per pixel, that are guaranteed to map inside
+   * the interpolator's buffer. Used by LinearThreadedGenerateData(). */
+  void ComputeScanlineInsideSpan(const ContinuousInputIndexType & startIndex,
+                                 const typename PointType::VectorType & delta,
+                                 SizeValueType lineLength,
+                                 SizeValueType & spanBegin,
+                                 SizeValueType & spanEnd) const;
+
   virtual PixelType CastPixelWithBoundsChecking( const InterpolatorOutputType value,
                                                  const ComponentType minComponent,
                                                  const ComponentType maxComponent) const;
@@ -24,6 +24,7 @@
 #include "itkProgressReporter.h"
 #include "itkImageRegionIteratorWithIndex.h"
 #include "itkImageScanlineIterator.h"
+#include "itkImageScanlineConstIterator.h"
 #include "itkSpecialCoordinatesImage.h"
 #include "itkDefaultConvertPixelTraits.h"
 
@@ -57,6 +58,8 @@ ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTra
   Self::AddRequiredInputName("ReferenceImage",1);
   Self::RemoveRequiredInputName("ReferenceImage");
 
+  //   "DisplacementField" optional ( not numbered )
+
   //   "Transform" required ( not numbered )
   Self::AddRequiredInputName("Transform");
   Self::SetTransform(IdentityTransform< TTransformPrecisionType, ImageDimension >::New());
@@ -99,6 +102,7 @@ ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTra
   os << indent << "Extrapolator: " << m_Extrapolator.GetPointer() << std::endl;
   os << indent << "UseReferenceImage: " << ( m_UseReferenceImage ? "On" : "Off" )
      << std::endl;
+  os << indent << "DisplacementField: " << this->GetDisplacementField() << std::endl;
 }
 
 /**
@@ -171,6 +175,35 @@ ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTra
     itkExceptionMacro(<< "Interpolator not set");
     }
 
+  // A displacement field is read at the output indices, so it must
+  // share the output grid
+  const DisplacementFieldType *displacementField = this->GetDisplacementField();
+  if ( displacementField )
+    {
+    const OutputImageType *outputPtr = this->GetOutput();
+    const SpacePrecisionType coordinateTol
+      = std::abs(this->GetCoordinateTolerance() * outputPtr->GetSpacing()[0]);
+
+    if ( !outputPtr->GetOrigin().GetVnlVector().is_equal(displacementField->GetOrigin().GetVnlVector(), coordinateTol)
+         || !outputPtr->GetSpacing().GetVnlVector().is_equal(displacementField->GetSpacing().GetVnlVector(), coordinateTol)
+         || !outputPtr->GetDirection().GetVnlMatrix().as_ref().is_equal(displacementField->GetDirection().GetVnlMatrix(),
+                                                                     this->GetDirectionTolerance()) )
+      {
+      itkExceptionMacro(<< "The displacement field does not share the output grid." << std::endl
+                        << "Output origin: " << outputPtr->GetOrigin()
+                        << ", displacement field origin: " << displacementField->GetOrigin() << std::endl
+                        << "Output spacing: " << outputPtr->GetSpacing()
+                        << ", displacement field spacing: " << displacementField->GetSpacing() << std::endl
+                        << "Output direction: " << outputPtr->GetDirection()
+                        << ", displacement field direction: " << displacementField->GetDirection());
+      }
+    if ( !displacementField->GetBufferedRegion().IsInside( outputPtr->GetRequestedRegion() ) )
+      {
+      itkExceptionMacro(<< "The displacement field buffered region " << displacementField->GetBufferedRegion()
+                        << " does not cover the output requested region " << outputPtr->GetRequestedRegion());
+      }
+    }
+
   // Connect input image to interpolator
   m_Interpolator->SetInputImage( this->GetInput() );
 
@@ -230,6 +263,14 @@ ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTra
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                        ThreadIdType threadId)
 {
+  // A displacement field sampled on the output grid replaces the
+  // transform.
+  if ( this->GetDisplacementField() )
+    {
+    this->DisplacementFieldThreadedGenerateData(outputRegionForThread, threadId);
+    return;
+    }
+
   // Check whether the input or the output is a
   // SpecialCoordinatesImage.  If either are, then we cannot use the
   // fast path since index mapping will definitely not be linear.
@@ -325,20 +366,26 @@ ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTra
 
 
   // Create an iterator that will walk the output region for this thread.
-  typedef ImageRegionIteratorWithIndex< TOutputImage > OutputIterator;
+  typedef ImageScanlineIterator< TOutputImage > OutputIterator;
   OutputIterator outIt(outputPtr, outputRegionForThread);
 
-  // Define a few indices that will be used to translate from an input pixel
-  // to an output pixel
-  PointType outputPoint;         // Coordinates of current output pixel
-  PointType inputPoint;          // Coordinates of current input pixel
+  // The points of a whole output scanline are mapped through the
+  // transform at once, so that transforms which can share work between
+  // points (see Transform::TransformPoints) benefit from it.
+  const typename OutputImageRegionType::SizeType &regionSize = outputRegionForThread.GetSize();
+  const SizeValueType lineLength = regionSize[0];
+  const SizeValueType numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / lineLength;
+
+  std::vector< PointType > outputPoints( lineLength ); // Coordinates of output pixels
+  std::vector< PointType > inputPoints( lineLength );  // Coordinates of input pixels
 
   ContinuousInputIndexType inputIndex;
+  IndexType                index;
 
   // Support for progress methods/callbacks
   ProgressReporter progress( this,
                              threadId,
-                             outputRegionForThread.GetNumberOfPixels() );
+                             numberOfLinesToProcess );
 
   // Min/max values of the output pixel type AND these values
   // represented as the output type of the interpolator
@@ -350,42 +397,50 @@ ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTra
   const ComponentType maxOutputValue = static_cast< ComponentType >( maxValue );
 
   // Walk the output region
-  outIt.GoToBegin();
-
   while ( !outIt.IsAtEnd() )
     {
-    // Determine the index of the current output pixel
-    outputPtr->TransformIndexToPhysicalPoint(outIt.GetIndex(), outputPoint);
-
-    // Compute corresponding input pixel position
-    inputPoint = transformPtr->TransformPoint(outputPoint);
-    inputPtr->TransformPhysicalPointToContinuousIndex(inputPoint, inputIndex);
-
-    PixelType  pixval;
-    OutputType value;
-    // Evaluate input at right position and copy to the output
-    if ( m_Interpolator->IsInsideBuffer(inputIndex) )
+    // Determine the coordinates of the output pixels of this scanline
+    index = outIt.GetIndex();
+    for ( SizeValueType i = 0; i < lineLength; ++i )
       {
-      value = m_Interpolator->EvaluateAtContinuousIndex(inputIndex);
-      pixval = this->CastPixelWithBoundsChecking( value, minOutputValue, maxOutputValue );
-      outIt.Set(pixval);
+      outputPtr->TransformIndexToPhysicalPoint(index, outputPoints[i]);
+      ++index[0];
       }
-    else
+
+    // Compute corresponding input pixel positions
+    transformPtr->TransformPoints(&outputPoints[0], &inputPoints[0], lineLength);
+
+    for ( SizeValueType i = 0; i < lineLength; ++i )
       {
-      if( m_Extrapolator.IsNull() )
+      inputPtr->TransformPhysicalPointToContinuousIndex(inputPoints[i], inputIndex);
+
+      PixelType  pixval;
+      OutputType value;
+      // Evaluate input at right position and copy to the output
+      if ( m_Interpolator->IsInsideBuffer(inputIndex) )
         {
-        outIt.Set( m_DefaultPixelValue ); // default background value
+        value = m_Interpolator->EvaluateAtContinuousIndex(inputIndex);
+        pixval = this->CastPixelWithBoundsChecking( value, minOutputValue, maxOutputValue );
+        outIt.Set(pixval);
         }
       else
         {
-        value = m_Extrapolator->EvaluateAtContinuousIndex( inputIndex );
-        pixval = this->CastPixelWithBoundsChecking( value, minOutputValue, maxOutputValue );
-        outIt.Set(pixval);
+        if( m_Extrapolator.IsNull() )
+          {
+          outIt.Set( m_DefaultPixelValue ); // default background value
+          }
+        else
+          {
+          value = m_Extrapolator->EvaluateAtContinuousIndex( inputIndex );
+          pixval = this->CastPixelWithBoundsChecking( value, minOutputValue, maxOutputValue );
+          outIt.Set(pixval);
+          }
         }
-      }
 
+      ++outIt;
+      }
     progress.CompletedPixel();
-    ++outIt;
+    outIt.NextLine();
     }
 }
 
@@ -432,7 +487,8 @@ ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTra
   IndexType index;
 
   const typename OutputImageRegionType::SizeType &regionSize = outputRegionForThread.GetSize();
-  const SizeValueType numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / regionSize[0];
+  const SizeValueType lineLength = regionSize[0];
+  const SizeValueType numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / lineLength;
 
   // Support for progress methods/callbacks
   ProgressReporter progress( this,
@@ -499,12 +555,20 @@ ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTra
     inputPoint = transformPtr->TransformPoint(outputPoint);
     inputPtr->TransformPhysicalPointToContinuousIndex(inputPoint, inputIndex);
 
-    while ( !outIt.IsAtEndOfLine() )
+    // The traced line enters and leaves the input buffer at most once, so
+    // the pixels of the scanline that map inside it form a single span
+    // which can be computed up front. Pixels in that span are interpolated
+    // without testing IsInsideBuffer() on each of them.
+    SizeValueType spanBegin;
+    SizeValueType spanEnd;
+    this->ComputeScanlineInsideSpan(inputIndex, delta, lineLength, spanBegin, spanEnd);
+
+    for ( SizeValueType i = 0; i < lineLength; ++i )
       {
       PixelType  pixval;
       OutputType value;
       // Evaluate input at right position and copy to the output
-      if ( m_Interpolator->IsInsideBuffer(inputIndex) )
+      if ( ( i >= spanBegin && i < spanEnd ) || m_Interpolator->IsInsideBuffer(inputIndex) )
         {
         value = m_Interpolator->EvaluateAtContinuousIndex(inputIndex);
         pixval = this->CastPixelWithBoundsChecking( value, minOutputValue, maxOutputValue );
@@ -532,6 +596,185 @@ ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTra
     } //while( !outIt.IsAtEnd() )
 }
 
+/**
+ * DisplacementFieldThreadedGenerateData
+ */
+template< typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType >
+void
+ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType >
+::DisplacementFieldThreadedGenerateData(const OutputImageRegionType &
+                                        outputRegionForThread,
+                                        ThreadIdType threadId)
+{
+  // Get the output pointers
+  OutputImageType *outputPtr = this->GetOutput();
+
+  // Get this input pointers
+  const InputImageType *inputPtr = this->GetInput();
+
+  // Get the displacement field, which shares the output grid
+  const DisplacementFieldType *fieldPtr = this->GetDisplacementField();
+
+  // Create iterators that will walk the output region for this thread.
+  typedef ImageScanlineIterator< TOutputImage >                   OutputIterator;
+  typedef ImageScanlineConstIterator< DisplacementFieldType >     FieldIterator;
+  OutputIterator outIt(outputPtr, outputRegionForThread);
+  FieldIterator  fieldIt(fieldPtr, outputRegionForThread);
+
+  PointType outputPoint;         // Coordinates of current output pixel
+  PointType inputPoint;          // Coordinates of current input pixel
+
+  ContinuousInputIndexType inputIndex;
+  IndexType                index;
+
+  const typename OutputImageRegionType::SizeType &regionSize = outputRegionForThread.GetSize();
+  const SizeValueType numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / regionSize[0];
+
+  // Support for progress methods/callbacks
+  ProgressReporter progress( this,
+                             threadId,
+                             numberOfLinesToProcess );
+
+  // Min/max values of the output pixel type AND these values
+  // represented as the output type of the interpolator
+  const PixelComponentType minValue =  NumericTraits< PixelComponentType >::NonpositiveMin();
+  const PixelComponentType maxValue =  NumericTraits< PixelComponentType >::max();
+
+  typedef typename InterpolatorType::OutputType OutputType;
+  const ComponentType minOutputValue = static_cast< ComponentType >( minValue );
+  const ComponentType maxOutputValue = static_cast< ComponentType >( maxValue );
+
+  // Walk the output region
+  while ( !outIt.IsAtEnd() )
+    {
+    index = outIt.GetIndex();
+    while ( !outIt.IsAtEndOfLine() )
+      {
+      // Compute corresponding input pixel position
+      outputPtr->TransformIndexToPhysicalPoint(index, outputPoint);
+      const DisplacementType & displacement = fieldIt.Value();
+      for ( unsigned int j = 0; j < ImageDimension; ++j )
+        {
+        inputPoint[j] = outputPoint[j] + displacement[j];
+        }
+      inputPtr->TransformPhysicalPointToContinuousIndex(inputPoint, inputIndex);
+
+      PixelType  pixval;
+      OutputType value;
+      // Evaluate input at right position and copy to the output
+      if ( m_Interpolator->IsInsideBuffer(inputIndex) )
+        {
+        value = m_Interpolator->EvaluateAtContinuousIndex(inputIndex);
+        pixval = this->CastPixelWithBoundsChecking( value, minOutputValue, maxOutputValue );
+        outIt.Set(pixval);
+        }
+      else
+        {
+        if( m_Extrapolator.IsNull() )
+          {
+          outIt.Set( m_DefaultPixelValue ); // default background value
+          }
+        else
+          {
+          value = m_Extrapolator->EvaluateAtContinuousIndex( inputIndex );
+          pixval = this->CastPixelWithBoundsChecking( value, minOutputValue, maxOutputValue );
+          outIt.Set(pixval);
+          }
+        }
+
+      ++outIt;
+      ++fieldIt;
+      ++index[0];
+      }
+    progress.CompletedPixel();
+    outIt.NextLine();
+    fieldIt.NextLine();
+    }
+}
+
+/**
+ * ComputeScanlineInsideSpan
+ */
+template< typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType >
+void
+ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType >
+::ComputeScanlineInsideSpan(const ContinuousInputIndexType & startIndex,
+                            const typename PointType::VectorType & delta,
+                            SizeValueType lineLength,
+                            SizeValueType & spanBegin,
+                            SizeValueType & spanEnd) const
+{
+  const typename InterpolatorType::ContinuousIndexType & bufferStart =
+    m_Interpolator->GetStartContinuousIndex();
+  const typename InterpolatorType::ContinuousIndexType & bufferEnd =
+    m_Interpolator->GetEndContinuousIndex();
+
+  // Work on pixel positions along the scanline in double precision and
+  // clamp to [0, lineLength - 1].
+  double first = 0.0;
+  double last = static_cast< double >( lineLength ) - 1.0;
+
+  for ( unsigned int j = 0; j < ImageDimension; ++j )
+    {
+    const double start = static_cast< double >( startIndex[j] );
+    const double step = static_cast< double >( delta[j] );
+
+    // The continuous index is advanced incrementally along the scanline,
+    // so shrink the bounds by more than the round-off it can accumulate.
+    const double tolerance = 4.0 * static_cast< double >( lineLength )
+      * static_cast< double >( NumericTraits< TTransformPrecisionType >::epsilon() )
+      * ( std::abs( start ) + std::abs( step ) * static_cast< double >( lineLength )
+          + std::abs( static_cast< double >( bufferStart[j] ) )
+          + std::abs( static_cast< double >( bufferEnd[j] ) ) + 1.0 );
+    const double lower = static_cast< double >( bufferStart[j] ) + tolerance;
+    const double upper = static_cast< double >( bufferEnd[j] ) - tolerance;
+
+    if ( step > 0.0 )
+      {
+      first = std::max( first, std::ceil( ( lower - start ) / step ) );
+      last = std::min( last, std::floor( ( upper - start ) / step ) );
+      }
+    else if ( step < 0.0 )
+      {
+      first = std::max( first, std::ceil( ( upper - start ) / step ) );
+      last = std::min( last, std::floor( ( lower - start ) / step ) );
+      }
+    else if ( !( start >= lower && start <= upper ) )
+      {
+      first = 1.0;
+      last = 0.0;
+      }
+    }
+
+  spanBegin = 0;
+  spanEnd = 0;
+  if ( !( first <= last ) )
+    {
+    return;
+    }
+
+  // The span is only used if the interpolator agrees that both of its
+  // ends are inside; the interpolator's inside region is assumed convex.
+  ContinuousInputIndexType firstIndex;
+  ContinuousInputIndexType lastIndex;
+  for ( unsigned int j = 0; j < ImageDimension; ++j )
+    {
+    firstIndex[j] = startIndex[j] + static_cast< TTransformPrecisionType >( first ) * delta[j];
+    lastIndex[j] = startIndex[j] + static_cast< TTransformPrecisionType >( last ) * delta[j];
+    }
+  if ( m_Interpolator->IsInsideBuffer(firstIndex) && m_Interpolator->IsInsideBuffer(lastIndex) )
+    {
+    spanBegin = static_cast< SizeValueType >( first );
+    spanEnd = static_cast< SizeValueType >( last ) + 1;
+    }
+}
+
 /**
  * Inform pipeline of necessary input image region
  *
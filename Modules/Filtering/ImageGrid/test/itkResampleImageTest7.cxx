@@ -0,0 +1,176 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include <iostream>
+
+#include "itkAffineTransform.h"
+#include "itkCompositeTransform.h"
+#include "itkResampleImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+/* Test the linear path of ResampleImageFilter with output scanlines that
+ * enter and leave the input buffer. Every pixel is checked against a
+ * reference computed by testing each traced continuous index against the
+ * interpolator's buffer. */
+int itkResampleImageTest7(int, char * [] )
+{
+
+  const unsigned int NDimensions = 2;
+
+  typedef float                               PixelType;
+  typedef itk::Image<PixelType, NDimensions>  ImageType;
+  typedef ImageType::IndexType                ImageIndexType;
+  typedef ImageType::RegionType               ImageRegionType;
+  typedef ImageType::SizeType                 ImageSizeType;
+  typedef ImageType::PointType                ImagePointType;
+
+  typedef double                                                      CoordRepType;
+  typedef itk::AffineTransform<CoordRepType,NDimensions>              AffineTransformType;
+  typedef itk::CompositeTransform<CoordRepType,NDimensions>           CompositeTransformType;
+  typedef itk::LinearInterpolateImageFunction<ImageType,CoordRepType> InterpolatorType;
+  typedef itk::ResampleImageFilter<ImageType, ImageType>              ResampleFilterType;
+
+  // Create an image filled with a ramp
+  ImageType::Pointer image = ImageType::New();
+  ImageIndexType  index = {{3, -2}};
+  ImageSizeType   size  = {{64, 48}};
+  ImageRegionType region( index, size );
+  image->SetRegions( region );
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<ImageType> iter( image, region );
+  for( iter.GoToBegin(); !iter.IsAtEnd(); ++iter )
+    {
+    index = iter.GetIndex();
+    iter.Set( 3.0 * index[0] - 2.0 * index[1] );
+    }
+
+  // A composite of linear transforms is resampled with the linear path
+  AffineTransformType::Pointer rotation = AffineTransformType::New();
+  rotation->Rotate2D( 0.3 );
+
+  AffineTransformType::Pointer scaleAndShift = AffineTransformType::New();
+  scaleAndShift->Scale( 0.8 );
+  AffineTransformType::OutputVectorType translation;
+  translation[0] = 7.5;
+  translation[1] = -4.25;
+  scaleAndShift->Translate( translation );
+
+  CompositeTransformType::Pointer composite = CompositeTransformType::New();
+  composite->AddTransform( rotation );
+  composite->AddTransform( scaleAndShift );
+
+  if( composite->GetTransformCategory() != CompositeTransformType::Linear )
+    {
+    std::cerr << "A composite of affine transforms is expected to be linear." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  InterpolatorType::Pointer interpolator = InterpolatorType::New();
+
+  const PixelType defaultValue = -1000.0;
+
+  ImageSizeType outputSize = {{97, 83}};
+  ImagePointType outputOrigin;
+  outputOrigin[0] = -20.0;
+  outputOrigin[1] = -15.0;
+  ImageType::SpacingType outputSpacing;
+  outputSpacing.Fill( 0.9 );
+
+  ResampleFilterType::Pointer resample = ResampleFilterType::New();
+  resample->SetInput( image );
+  resample->SetTransform( composite );
+  resample->SetInterpolator( interpolator );
+  resample->SetDefaultPixelValue( defaultValue );
+  resample->SetSize( outputSize );
+  resample->SetOutputOrigin( outputOrigin );
+  resample->SetOutputSpacing( outputSpacing );
+  // The reference below traces the whole output as one region
+  resample->SetNumberOfThreads( 1 );
+  resample->Update();
+
+  ImageType::Pointer output = resample->GetOutput();
+
+  // The filter disconnects the interpolator once done
+  interpolator->SetInputImage( image );
+
+  // Trace each output scanline in the input continuous index space the
+  // same way the filter does, and check every pixel
+  typedef itk::ContinuousIndex<CoordRepType, NDimensions> ContinuousIndexType;
+
+  ImageRegionType outputRegion = output->GetBufferedRegion();
+
+  ImageIndexType outputIndex = outputRegion.GetIndex();
+  ImagePointType point;
+  ContinuousIndexType firstIndex;
+  ContinuousIndexType nextIndex;
+  output->TransformIndexToPhysicalPoint( outputIndex, point );
+  image->TransformPhysicalPointToContinuousIndex( composite->TransformPoint( point ), firstIndex );
+  ++outputIndex[0];
+  output->TransformIndexToPhysicalPoint( outputIndex, point );
+  image->TransformPhysicalPointToContinuousIndex( composite->TransformPoint( point ), nextIndex );
+  const ImagePointType::VectorType delta = nextIndex - firstIndex;
+
+  unsigned int numberOfInsidePixels = 0;
+  unsigned int numberOfOutsidePixels = 0;
+  for( unsigned int y = 0; y < outputSize[1]; ++y )
+    {
+    outputIndex[0] = outputRegion.GetIndex()[0];
+    outputIndex[1] = outputRegion.GetIndex()[1] + y;
+    output->TransformIndexToPhysicalPoint( outputIndex, point );
+
+    ContinuousIndexType inputIndex;
+    image->TransformPhysicalPointToContinuousIndex( composite->TransformPoint( point ), inputIndex );
+
+    for( unsigned int x = 0; x < outputSize[0]; ++x )
+      {
+      PixelType expected = defaultValue;
+      if( interpolator->IsInsideBuffer( inputIndex ) )
+        {
+        expected = static_cast<PixelType>( interpolator->EvaluateAtContinuousIndex( inputIndex ) );
+        ++numberOfInsidePixels;
+        }
+      else
+        {
+        ++numberOfOutsidePixels;
+        }
+
+      const PixelType actual = output->GetPixel( outputIndex );
+      if( actual != expected )
+        {
+        std::cerr << "Mismatch at " << outputIndex << ": expected " << expected
+                  << ", got " << actual << std::endl;
+        return EXIT_FAILURE;
+        }
+
+      ++outputIndex[0];
+      inputIndex += delta;
+      }
+    }
+
+  if( numberOfInsidePixels == 0 || numberOfOutsidePixels == 0 )
+    {
+    std::cerr << "The output grid is expected to cover pixels both inside and outside the input." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Inside pixels: " << numberOfInsidePixels
+            << ", outside pixels: " << numberOfOutsidePixels << std::endl;
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -47,7 +47,9 @@ namespace itk
  *
  * The filter passes its intensity input through unmodified.  The filter is
  * threaded. It computes statistics in each thread then combines them in
- * its AfterThreadedGenerate method.
+ * its AfterThreadedGenerate method. For the label types of 8 or 16 bits,
+ * the statistics of each thread are stored in an array indexed by the
+ * label, which avoids a hash map lookup for each pixel.
  *
  * \ingroup MathematicalStatisticsImageFilters
  * \ingroup ITKImageStatistics
@@ -353,9 +355,32 @@ private:
   LabelStatisticsImageFilter(const Self &) ITK_DELETE_FUNCTION;
   void operator=(const Self &) ITK_DELETE_FUNCTION;
 
-  std::vector< MapType >        m_LabelStatisticsPerThread;
-  MapType                       m_LabelStatistics;
-  ValidLabelValuesContainerType m_ValidLabelValues;
+  /** The labels of the integer types of 8 or 16 bits are used directly as
+   * an index in an array, which gives the position of the statistics of the
+   * label in the thread, instead of a key in a hash map. */
+  static const bool UseDenseLabels = NumericTraits< LabelPixelType >::is_integer && sizeof( LabelPixelType ) <= 2;
+
+  struct DenseStatisticsType
+    {
+    std::vector< unsigned int >    m_Positions;
+    std::vector< LabelPixelType >  m_Labels;
+    std::vector< LabelStatistics > m_Statistics;
+    };
+
+  static SizeValueType DenseIndexOf(const LabelPixelType & label)
+  {
+    return static_cast< SizeValueType >( static_cast< OffsetValueType >( label )
+                                         - static_cast< OffsetValueType >( NumericTraits< LabelPixelType >::NonpositiveMin() ) );
+  }
+
+  /** Add the statistics computed by a thread for a label to the final
+   * statistics. */
+  void MergeLabelStatistics(const LabelPixelType & label, const LabelStatistics & threadStatistics);
+
+  std::vector< MapType >             m_LabelStatisticsPerThread;
+  std::vector< DenseStatisticsType > m_DenseLabelStatisticsPerThread;
+  MapType                            m_LabelStatistics;
+  ValidLabelValuesContainerType      m_ValidLabelValues;
 
   bool m_UseHistograms;
 
@@ -81,11 +81,19 @@ LabelStatisticsImageFilter< TInputImage, TLabelImage >
 
   // Resize the thread temporaries
   m_LabelStatisticsPerThread.resize(numberOfThreads);
+  m_DenseLabelStatisticsPerThread.resize(numberOfThreads);
 
   // Initialize the temporaries
   for ( ThreadIdType i = 0; i < numberOfThreads; ++i )
     {
     m_LabelStatisticsPerThread[i].clear();
+    if ( UseDenseLabels )
+      {
+      // a position for each possible label, 0 for the labels not found yet
+      m_DenseLabelStatisticsPerThread[i].m_Positions.assign(SizeValueType(1) << ( 8 * sizeof( LabelPixelType ) ), 0);
+      m_DenseLabelStatisticsPerThread[i].m_Labels.clear();
+      m_DenseLabelStatisticsPerThread[i].m_Statistics.clear();
+      }
     }
 
   // Initialize the final map
@@ -102,77 +110,31 @@ LabelStatisticsImageFilter< TInputImage, TLabelImage >
   ThreadIdType     i;
   ThreadIdType     numberOfThreads = this->GetNumberOfThreads();
 
-  // Run through the map for each thread and accumulate the count,
-  // sum, and sumofsquares
+  // Run through the map or the array of each thread and accumulate the
+  // count, sum, and sumofsquares
   for ( i = 0; i < numberOfThreads; i++ )
     {
-    // iterate over the map for this thread
-    for ( threadIt = m_LabelStatisticsPerThread[i].begin();
-          threadIt != m_LabelStatisticsPerThread[i].end();
-          ++threadIt )
+    if ( UseDenseLabels )
       {
-      // does this label exist in the cumulative structure yet?
-      mapIt = m_LabelStatistics.find( ( *threadIt ).first );
-      if ( mapIt == m_LabelStatistics.end() )
-        {
-        // create a new entry
-        typedef typename MapType::value_type MapValueType;
-        if ( m_UseHistograms )
-          {
-          mapIt = m_LabelStatistics.insert( MapValueType( ( *threadIt ).first,
-                                                          LabelStatistics(m_NumBins[0], m_LowerBound,
-                                                                          m_UpperBound) ) ).first;
-          }
-        else
-          {
-          mapIt = m_LabelStatistics.insert( MapValueType( ( *threadIt ).first,
-                                                          LabelStatistics() ) ).first;
-          }
-        }
-
-
-      typename MapType::mapped_type &labelStats = ( *mapIt ).second;
-
-      // accumulate the information from this thread
-      labelStats.m_Count += ( *threadIt ).second.m_Count;
-      labelStats.m_Sum += ( *threadIt ).second.m_Sum;
-      labelStats.m_SumOfSquares += ( *threadIt ).second.m_SumOfSquares;
-
-      if ( labelStats.m_Minimum > ( *threadIt ).second.m_Minimum )
-        {
-        labelStats.m_Minimum = ( *threadIt ).second.m_Minimum;
-        }
-      if ( labelStats.m_Maximum < ( *threadIt ).second.m_Maximum )
-        {
-        labelStats.m_Maximum = ( *threadIt ).second.m_Maximum;
-        }
-
-      //bounding box is min,max pairs
-      int dimension = labelStats.m_BoundingBox.size() / 2;
-      for ( int ii = 0; ii < ( dimension * 2 ); ii += 2 )
+      DenseStatisticsType & threadStatistics = m_DenseLabelStatisticsPerThread[i];
+      for ( SizeValueType j = 0; j < threadStatistics.m_Labels.size(); j++ )
         {
-        if ( labelStats.m_BoundingBox[ii] > ( *threadIt ).second.m_BoundingBox[ii] )
-          {
-          labelStats.m_BoundingBox[ii] = ( *threadIt ).second.m_BoundingBox[ii];
-          }
-        if ( labelStats.m_BoundingBox[ii + 1] < ( *threadIt ).second.m_BoundingBox[ii + 1] )
-          {
-          labelStats.m_BoundingBox[ii + 1] = ( *threadIt ).second.m_BoundingBox[ii + 1];
-          }
+        this->MergeLabelStatistics( threadStatistics.m_Labels[j], threadStatistics.m_Statistics[j] );
         }
-
-      // if enabled, update the histogram for this label
-      if ( m_UseHistograms )
+      std::vector< unsigned int >().swap(threadStatistics.m_Positions);
+      std::vector< LabelPixelType >().swap(threadStatistics.m_Labels);
+      std::vector< LabelStatistics >().swap(threadStatistics.m_Statistics);
+      }
+    else
+      {
+      // iterate over the map for this thread
+      for ( threadIt = m_LabelStatisticsPerThread[i].begin();
+            threadIt != m_LabelStatisticsPerThread[i].end();
+            ++threadIt )
         {
-        typename HistogramType::IndexType index;
-        index.SetSize(1);
-        for ( unsigned int bin = 0; bin < m_NumBins[0]; bin++ )
-          {
-          index[0] = bin;
-          labelStats.m_Histogram->IncreaseFrequency( bin, ( *threadIt ).second.m_Histogram->GetFrequency(bin) );
-          }
+        this->MergeLabelStatistics( ( *threadIt ).first, ( *threadIt ).second );
         }
-      } // end of thread map iterator loop
+      }
     }   // end of thread loop
 
   // compute the remainder of the statistics
@@ -218,6 +180,73 @@ LabelStatisticsImageFilter< TInputImage, TLabelImage >
     }
 }
 
+template< typename TInputImage, typename TLabelImage >
+void
+LabelStatisticsImageFilter< TInputImage, TLabelImage >
+::MergeLabelStatistics(const LabelPixelType & label, const LabelStatistics & threadStatistics)
+{
+  // does this label exist in the cumulative structure yet?
+  MapIterator mapIt = m_LabelStatistics.find( label );
+  if ( mapIt == m_LabelStatistics.end() )
+    {
+    // create a new entry
+    typedef typename MapType::value_type MapValueType;
+    if ( m_UseHistograms )
+      {
+      mapIt = m_LabelStatistics.insert( MapValueType( label,
+                                                      LabelStatistics(m_NumBins[0], m_LowerBound,
+                                                                      m_UpperBound) ) ).first;
+      }
+    else
+      {
+      mapIt = m_LabelStatistics.insert( MapValueType( label,
+                                                      LabelStatistics() ) ).first;
+      }
+    }
+
+  typename MapType::mapped_type &labelStats = ( *mapIt ).second;
+
+  // accumulate the information from this thread
+  labelStats.m_Count += threadStatistics.m_Count;
+  labelStats.m_Sum += threadStatistics.m_Sum;
+  labelStats.m_SumOfSquares += threadStatistics.m_SumOfSquares;
+
+  if ( labelStats.m_Minimum > threadStatistics.m_Minimum )
+    {
+    labelStats.m_Minimum = threadStatistics.m_Minimum;
+    }
+  if ( labelStats.m_Maximum < threadStatistics.m_Maximum )
+    {
+    labelStats.m_Maximum = threadStatistics.m_Maximum;
+    }
+
+  //bounding box is min,max pairs
+  int dimension = labelStats.m_BoundingBox.size() / 2;
+  for ( int ii = 0; ii < ( dimension * 2 ); ii += 2 )
+    {
+    if ( labelStats.m_BoundingBox[ii] > threadStatistics.m_BoundingBox[ii] )
+      {
+      labelStats.m_BoundingBox[ii] = threadStatistics.m_BoundingBox[ii];
+      }
+    if ( labelStats.m_BoundingBox[ii + 1] < threadStatistics.m_BoundingBox[ii + 1] )
+      {
+      labelStats.m_BoundingBox[ii + 1] = threadStatistics.m_BoundingBox[ii + 1];
+      }
+    }
+
+  // if enabled, update the histogram for this label
+  if ( m_UseHistograms )
+    {
+    typename HistogramType::IndexType index;
+    index.SetSize(1);
+    for ( unsigned int bin = 0; bin < m_NumBins[0]; bin++ )
+      {
+      index[0] = bin;
+      labelStats.m_Histogram->IncreaseFrequency( bin, threadStatistics.m_Histogram->GetFrequency(bin) );
+      }
+    }
+}
+
 template< typename TInputImage, typename TLabelImage >
 void
 LabelStatisticsImageFilter< TInputImage, TLabelImage >
@@ -255,26 +284,52 @@ LabelStatisticsImageFilter< TInputImage, TLabelImage >
 
       const LabelPixelType & label = labelIt.Get();
 
-      // is the label already in this thread?
-      mapIt = m_LabelStatisticsPerThread[threadId].find(label);
-      if ( mapIt == m_LabelStatisticsPerThread[threadId].end() )
+      LabelStatistics *labelStatsPointer;
+      if ( UseDenseLabels )
         {
-        // create a new statistics object
-        typedef typename MapType::value_type MapValueType;
-        if ( m_UseHistograms )
+        // the label is the index of the position of its statistics
+        DenseStatisticsType & threadStatistics = m_DenseLabelStatisticsPerThread[threadId];
+        unsigned int &        position = threadStatistics.m_Positions[Self::DenseIndexOf(label)];
+        if ( position == 0 )
           {
-          mapIt = m_LabelStatisticsPerThread[threadId].insert( MapValueType( label,
-                                                                             LabelStatistics(m_NumBins[0], m_LowerBound,
-                                                                                             m_UpperBound) ) ).first;
+          // create a new statistics object
+          if ( m_UseHistograms )
+            {
+            threadStatistics.m_Statistics.push_back( LabelStatistics(m_NumBins[0], m_LowerBound, m_UpperBound) );
+            }
+          else
+            {
+            threadStatistics.m_Statistics.push_back( LabelStatistics() );
+            }
+          threadStatistics.m_Labels.push_back(label);
+          position = static_cast< unsigned int >( threadStatistics.m_Statistics.size() );
           }
-        else
+        labelStatsPointer = &threadStatistics.m_Statistics[position - 1];
+        }
+      else
+        {
+        // is the label already in this thread?
+        mapIt = m_LabelStatisticsPerThread[threadId].find(label);
+        if ( mapIt == m_LabelStatisticsPerThread[threadId].end() )
           {
-          mapIt = m_LabelStatisticsPerThread[threadId].insert( MapValueType( label,
-                                                                             LabelStatistics() ) ).first;
+          // create a new statistics object
+          typedef typename MapType::value_type MapValueType;
+          if ( m_UseHistograms )
+            {
+            mapIt = m_LabelStatisticsPerThread[threadId].insert( MapValueType( label,
+                                                                               LabelStatistics(m_NumBins[0], m_LowerBound,
+                                                                                               m_UpperBound) ) ).first;
+            }
+          else
+            {
+            mapIt = m_LabelStatisticsPerThread[threadId].insert( MapValueType( label,
+                                                                               LabelStatistics() ) ).first;
+            }
           }
+        labelStatsPointer = &( *mapIt ).second;
         }
 
-      typename MapType::mapped_type &labelStats = ( *mapIt ).second;
+      LabelStatistics &labelStats = *labelStatsPointer;
 
       // update the values for this label and this thread
       if ( value < labelStats.m_Minimum )
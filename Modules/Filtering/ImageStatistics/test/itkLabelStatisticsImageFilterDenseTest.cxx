@@ -0,0 +1,107 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkLabelStatisticsImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include <cmath>
+#include "itkTestingMacros.h"
+
+/* Computes the statistics of the same labels stored in a short image, which
+ * uses the arrays indexed by the label, and in an int image, which uses the
+ * hash maps, and checks that the statistics are the same. */
+int itkLabelStatisticsImageFilterDenseTest( int, char * [] )
+{
+  const unsigned int Dimension = 3;
+
+  typedef itk::Image< float, Dimension >                                      ImageType;
+  typedef itk::Image< short, Dimension >                                      DenseLabelImageType;
+  typedef itk::Image< int, Dimension >                                        MapLabelImageType;
+  typedef itk::LabelStatisticsImageFilter< ImageType, DenseLabelImageType >   DenseFilterType;
+  typedef itk::LabelStatisticsImageFilter< ImageType, MapLabelImageType >     MapFilterType;
+
+  ImageType::SizeType size;
+  size.Fill( 64 );
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+  DenseLabelImageType::Pointer denseLabels = DenseLabelImageType::New();
+  denseLabels->SetRegions( size );
+  denseLabels->Allocate();
+  MapLabelImageType::Pointer mapLabels = MapLabelImageType::New();
+  mapLabels->SetRegions( size );
+  mapLabels->Allocate();
+
+  // labels of blocks of 4x4x4 pixels, with negative values and gaps, on a
+  // wave, so that the labels have different means, ranges and medians
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+  itk::ImageRegionIteratorWithIndex< DenseLabelImageType > dit( denseLabels, denseLabels->GetLargestPossibleRegion() );
+  itk::ImageRegionIteratorWithIndex< MapLabelImageType >   mit( mapLabels, mapLabels->GetLargestPossibleRegion() );
+  for(; !it.IsAtEnd(); ++it, ++dit, ++mit )
+    {
+    const ImageType::IndexType index = it.GetIndex();
+    const int label = 3 * ( index[0] / 4 + 16 * ( index[1] / 4 + 16 * ( index[2] / 4 ) ) ) - 100;
+    dit.Set( static_cast< short >( label ) );
+    mit.Set( label );
+    const double wave = 45.0 + 40.0 * std::sin( 0.3 * index[0] ) * std::cos( 0.2 * index[1] ) + index[2] % 7;
+    it.Set( static_cast< float >( std::floor( 10.0 * wave ) / 10.0 ) );
+    }
+
+  DenseFilterType::Pointer denseFilter = DenseFilterType::New();
+  denseFilter->SetInput( image );
+  denseFilter->SetLabelInput( denseLabels );
+  denseFilter->UseHistogramsOn();
+  denseFilter->SetHistogramParameters( 100, 0.0, 100.0 );
+  denseFilter->SetNumberOfThreads( 4 );
+  TRY_EXPECT_NO_EXCEPTION( denseFilter->Update() );
+
+  MapFilterType::Pointer mapFilter = MapFilterType::New();
+  mapFilter->SetInput( image );
+  mapFilter->SetLabelInput( mapLabels );
+  mapFilter->UseHistogramsOn();
+  mapFilter->SetHistogramParameters( 100, 0.0, 100.0 );
+  mapFilter->SetNumberOfThreads( 4 );
+  TRY_EXPECT_NO_EXCEPTION( mapFilter->Update() );
+
+  if( denseFilter->GetNumberOfLabels() != 4096 || mapFilter->GetNumberOfLabels() != 4096 )
+    {
+    std::cerr << "Wrong number of labels: " << denseFilter->GetNumberOfLabels() << " and "
+              << mapFilter->GetNumberOfLabels() << " instead of 4096" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const DenseFilterType::ValidLabelValuesContainerType & labels = denseFilter->GetValidLabelValues();
+  for( unsigned int i = 0; i < labels.size(); i++ )
+    {
+    const short label = labels[i];
+    if( !mapFilter->HasLabel( label )
+        || denseFilter->GetCount( label ) != mapFilter->GetCount( label )
+        || denseFilter->GetSum( label ) != mapFilter->GetSum( label )
+        || denseFilter->GetMinimum( label ) != mapFilter->GetMinimum( label )
+        || denseFilter->GetMaximum( label ) != mapFilter->GetMaximum( label )
+        || denseFilter->GetVariance( label ) != mapFilter->GetVariance( label )
+        || denseFilter->GetMedian( label ) != mapFilter->GetMedian( label )
+        || denseFilter->GetRegion( label ) != mapFilter->GetRegion( label ) )
+      {
+      std::cerr << "The statistics of the label " << label << " differ" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
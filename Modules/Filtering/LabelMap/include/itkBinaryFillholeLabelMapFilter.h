@@ -0,0 +1,130 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkBinaryFillholeLabelMapFilter_h
+#define itkBinaryFillholeLabelMapFilter_h
+
+#include "itkInPlaceLabelMapFilter.h"
+#include "itkLabelMapLineClipper.h"
+#include <vector>
+
+namespace itk
+{
+/** \class BinaryFillholeLabelMapFilter
+ * \brief Fill the holes of the objects of a LabelMap
+ *
+ * The holes of an object are the connected components of its background
+ * which are not connected to the border of the image. They are found
+ * directly on the lines of the object: the background of the object is
+ * run length encoded inside its bounding box, and the background lines
+ * are merged in connected components with a union-find. A background line
+ * touching the bounding box is connected to the border of the image, so
+ * only the bounding box of the object is visited.
+ *
+ * The holes of each object are found independently of the others, as in
+ * a binary image where the pixels of the object are in the foreground, and
+ * the objects are processed in parallel. The holes are then clipped
+ * against the other objects, so the output objects do not overlap: a hole
+ * is filled only with the pixels which are in no object of the input, and
+ * the pixels in the holes of several objects, like the center of nested
+ * rings, go to the object with the lowest label. A nucleus inside a cell
+ * is kept, and the cell grows around it. With a single object, the result
+ * is the same as the one of BinaryFillholeImageFilter.
+ *
+ * \sa BinaryFillholeImageFilter LabelImageToLabelMapFilter LabelMapToBinaryImageFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ * \ingroup ITKLabelMap
+ */
+template< typename TImage >
+class BinaryFillholeLabelMapFilter:
+  public InPlaceLabelMapFilter< TImage >
+{
+public:
+  /** Standard class typedefs. */
+  typedef BinaryFillholeLabelMapFilter    Self;
+  typedef InPlaceLabelMapFilter< TImage > Superclass;
+  typedef SmartPointer< Self >            Pointer;
+  typedef SmartPointer< const Self >      ConstPointer;
+
+  /** Some convenient typedefs. */
+  typedef TImage                              ImageType;
+  typedef typename ImageType::Pointer         ImagePointer;
+  typedef typename ImageType::ConstPointer    ImageConstPointer;
+  typedef typename ImageType::PixelType       PixelType;
+  typedef typename ImageType::IndexType       IndexType;
+  typedef typename ImageType::OffsetType      OffsetType;
+  typedef typename ImageType::LabelObjectType LabelObjectType;
+  typedef typename LabelObjectType::LineType  LineType;
+
+  /** ImageDimension constants */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TImage::ImageDimension);
+
+  /** Standard New method. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(BinaryFillholeLabelMapFilter,
+               InPlaceLabelMapFilter);
+
+  /**
+   * Set/Get whether the connected components of the background are
+   * defined strictly by face connectivity or by face+edge+vertex
+   * connectivity.  Default is FullyConnectedOff.
+   */
+  itkSetMacro(FullyConnected, bool);
+  itkGetConstReferenceMacro(FullyConnected, bool);
+  itkBooleanMacro(FullyConnected);
+
+protected:
+  BinaryFillholeLabelMapFilter();
+  ~BinaryFillholeLabelMapFilter() {}
+
+  /** Store the lines of the objects, to clip the holes against them. */
+  virtual void BeforeThreadedGenerateData() ITK_OVERRIDE;
+
+  virtual void ThreadedProcessLabelObject( LabelObjectType * labelObject ) ITK_OVERRIDE;
+
+  /** Give the pixels in the holes of several objects to one of them. */
+  virtual void AfterThreadedGenerateData() ITK_OVERRIDE;
+
+  void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+private:
+  BinaryFillholeLabelMapFilter(const Self &) ITK_DELETE_FUNCTION;
+  void operator=(const Self &) ITK_DELETE_FUNCTION;
+
+  /** Intervals [first, second] along the first dimension. */
+  typedef std::pair< OffsetValueType, OffsetValueType > IntervalType;
+  typedef std::vector< IntervalType >                   IntervalContainerType;
+
+  typedef LabelMapLineClipper< ImageType >        ClipperType;
+  typedef typename ClipperType::LineContainerType LineContainerType;
+
+  static SizeValueType FindRoot(std::vector< SizeValueType > & parent, SizeValueType run);
+
+  bool        m_FullyConnected;
+  ClipperType m_Clipper;
+}; // end of class
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkBinaryFillholeLabelMapFilter.hxx"
+#endif
+
+#endif
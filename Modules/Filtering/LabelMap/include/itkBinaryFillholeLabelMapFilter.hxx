@@ -0,0 +1,298 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkBinaryFillholeLabelMapFilter_hxx
+#define itkBinaryFillholeLabelMapFilter_hxx
+
+#include "itkBinaryFillholeLabelMapFilter.h"
+#include <algorithm>
+
+namespace itk
+{
+template< typename TImage >
+BinaryFillholeLabelMapFilter< TImage >
+::BinaryFillholeLabelMapFilter()
+{
+  m_FullyConnected = false;
+}
+
+template< typename TImage >
+SizeValueType
+BinaryFillholeLabelMapFilter< TImage >
+::FindRoot(std::vector< SizeValueType > & parent, SizeValueType run)
+{
+  SizeValueType root = run;
+  while ( parent[root] != root )
+    {
+    root = parent[root];
+    }
+  // path compression
+  while ( parent[run] != root )
+    {
+    const SizeValueType next = parent[run];
+    parent[run] = root;
+    run = next;
+    }
+  return root;
+}
+
+template< typename TImage >
+void
+BinaryFillholeLabelMapFilter< TImage >
+::BeforeThreadedGenerateData()
+{
+  Superclass::BeforeThreadedGenerateData();
+
+  m_Clipper.Initialize( this->GetOutput() );
+}
+
+template< typename TImage >
+void
+BinaryFillholeLabelMapFilter< TImage >
+::AfterThreadedGenerateData()
+{
+  m_Clipper.Resolve( this->GetOutput() );
+
+  Superclass::AfterThreadedGenerateData();
+}
+
+template< typename TImage >
+void
+BinaryFillholeLabelMapFilter< TImage >
+::ThreadedProcessLabelObject( LabelObjectType * labelObject )
+{
+  labelObject->Optimize();
+  const SizeValueType numberOfLines = labelObject->GetNumberOfLines();
+  if ( numberOfLines == 0 )
+    {
+    return;
+    }
+
+  // the bounding box of the object. The holes are inside, and the
+  // background pixels on its border are connected to the border of the
+  // image by a straight line of background pixels.
+  IndexType minimum = labelObject->GetLine(0).GetIndex();
+  IndexType maximum = minimum;
+  for ( SizeValueType i = 0; i < numberOfLines; i++ )
+    {
+    const LineType & line = labelObject->GetLine(i);
+    for ( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      minimum[d] = std::min( minimum[d], line.GetIndex()[d] );
+      maximum[d] = std::max( maximum[d], line.GetIndex()[d] );
+      }
+    maximum[0] = std::max( maximum[0], line.GetIndex()[0] + static_cast< OffsetValueType >( line.GetLength() ) - 1 );
+    }
+
+  OffsetType    strides;
+  SizeValueType numberOfBoxLines = 1;
+  strides[0] = 0;
+  for ( unsigned int d = 1; d < ImageDimension; d++ )
+    {
+    strides[d] = numberOfBoxLines;
+    numberOfBoxLines *= maximum[d] - minimum[d] + 1;
+    }
+
+  // the neighbor lines already visited, in the dimensions greater than zero
+  std::vector< OffsetType > neighbors;
+  OffsetType                neighbor;
+  neighbor.Fill( -1 );
+  neighbor[0] = 0;
+  while ( ImageDimension > 1 )
+    {
+    int          lastNonZero = 0;
+    unsigned int numberOfNonZeros = 0;
+    for ( unsigned int d = 1; d < ImageDimension; d++ )
+      {
+      if ( neighbor[d] != 0 )
+        {
+        lastNonZero = neighbor[d];
+        numberOfNonZeros++;
+        }
+      }
+    if ( lastNonZero < 0 && ( m_FullyConnected || numberOfNonZeros == 1 ) )
+      {
+      neighbors.push_back( neighbor );
+      }
+    unsigned int d = 1;
+    for (; d < ImageDimension; d++ )
+      {
+      if ( ++neighbor[d] <= 1 )
+        {
+        break;
+        }
+      neighbor[d] = -1;
+      }
+    if ( d >= ImageDimension )
+      {
+      break;
+      }
+    }
+  const OffsetValueType slack = m_FullyConnected ? 1 : 0;
+
+  // encode the background of each line of the bounding box, in the order of
+  // the lines of the object, and merge the background lines which touch
+  // the ones of the previous lines
+  IntervalContainerType        runs;
+  std::vector< SizeValueType > firstRun( numberOfBoxLines + 1 );
+  std::vector< SizeValueType > parent;
+  std::vector< bool >          border;
+  SizeValueType                objectLine = 0;
+  IndexType                    position = minimum;
+  for ( SizeValueType l = 0; l < numberOfBoxLines; l++ )
+    {
+    firstRun[l] = runs.size();
+    bool onFace = false;
+    for ( unsigned int d = 1; d < ImageDimension; d++ )
+      {
+      onFace = onFace || position[d] == minimum[d] || position[d] == maximum[d];
+      }
+
+    OffsetValueType x = minimum[0];
+    while ( objectLine < numberOfLines )
+      {
+      const LineType & line = labelObject->GetLine(objectLine);
+      bool             samePosition = true;
+      for ( unsigned int d = 1; d < ImageDimension; d++ )
+        {
+        samePosition = samePosition && line.GetIndex()[d] == position[d];
+        }
+      if ( !samePosition )
+        {
+        break;
+        }
+      if ( line.GetIndex()[0] > x )
+        {
+        runs.push_back( IntervalType( x, line.GetIndex()[0] - 1 ) );
+        border.push_back( onFace || x == minimum[0] );
+        }
+      x = line.GetIndex()[0] + static_cast< OffsetValueType >( line.GetLength() );
+      ++objectLine;
+      }
+    if ( x <= maximum[0] )
+      {
+      runs.push_back( IntervalType( x, maximum[0] ) );
+      border.push_back( true );
+      }
+    firstRun[l + 1] = runs.size();
+    for ( SizeValueType r = firstRun[l]; r < runs.size(); r++ )
+      {
+      parent.push_back( r );
+      }
+
+    for ( typename std::vector< OffsetType >::const_iterator nit = neighbors.begin(); nit != neighbors.end(); ++nit )
+      {
+      bool            inside = true;
+      OffsetValueType neighborLine = l;
+      for ( unsigned int d = 1; d < ImageDimension; d++ )
+        {
+        inside = inside && position[d] + ( *nit )[d] >= minimum[d] && position[d] + ( *nit )[d] <= maximum[d];
+        neighborLine += ( *nit )[d] * strides[d];
+        }
+      if ( !inside )
+        {
+        continue;
+        }
+      SizeValueType       i = firstRun[l];
+      SizeValueType       j = firstRun[neighborLine];
+      const SizeValueType iEnd = firstRun[l + 1];
+      const SizeValueType jEnd = firstRun[neighborLine + 1];
+      while ( i < iEnd && j < jEnd )
+        {
+        if ( runs[i].first <= runs[j].second + slack && runs[j].first <= runs[i].second + slack )
+          {
+          const SizeValueType rootI = FindRoot( parent, i );
+          const SizeValueType rootJ = FindRoot( parent, j );
+          if ( rootI != rootJ )
+            {
+            const SizeValueType root = std::min( rootI, rootJ );
+            const SizeValueType other = std::max( rootI, rootJ );
+            parent[other] = root;
+            border[root] = border[root] || border[other];
+            }
+          }
+        if ( runs[i].second < runs[j].second )
+          {
+          ++i;
+          }
+        else
+          {
+          ++j;
+          }
+        }
+      }
+
+    for ( unsigned int d = 1; d < ImageDimension; d++ )
+      {
+      if ( ++position[d] <= maximum[d] )
+        {
+        break;
+        }
+      position[d] = minimum[d];
+      }
+    }
+
+  // the background lines not connected to the border are the holes
+  LineContainerType holes;
+  position = minimum;
+  for ( SizeValueType l = 0; l < numberOfBoxLines; l++ )
+    {
+    for ( SizeValueType r = firstRun[l]; r < firstRun[l + 1]; r++ )
+      {
+      if ( !border[FindRoot( parent, r )] )
+        {
+        position[0] = runs[r].first;
+        holes.push_back( LineType( position, runs[r].second - runs[r].first + 1 ) );
+        }
+      }
+    for ( unsigned int d = 1; d < ImageDimension; d++ )
+      {
+      if ( ++position[d] <= maximum[d] )
+        {
+        break;
+        }
+      position[d] = minimum[d];
+      }
+    }
+
+  // only the pixels of the holes which are in no other object are added
+  LineContainerType lines;
+  LineContainerType clipped;
+  lines.reserve( numberOfLines );
+  for ( SizeValueType i = 0; i < numberOfLines; i++ )
+    {
+    lines.push_back( labelObject->GetLine(i) );
+    }
+  m_Clipper.ClipToInput( lines, holes, clipped );
+  for ( typename LineContainerType::const_iterator it = clipped.begin(); it != clipped.end(); ++it )
+    {
+    labelObject->AddLine( *it );
+    }
+  labelObject->Optimize();
+}
+
+template< typename TImage >
+void
+BinaryFillholeLabelMapFilter< TImage >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "FullyConnected: " << m_FullyConnected << std::endl;
+}
+} // end namespace itk
+#endif
@@ -94,6 +94,12 @@ LabelImageToLabelMapFilter< TInputImage, TOutputImage >
   InputLineIteratorType it(this->GetInput(), regionForThread);
   it.SetDirection(0);
 
+  // the object of the last run - the runs of the same object are often
+  // found one after the other, so the search in the label map is avoided
+  // for them
+  OutputImageType *labelMap = m_TemporaryImages[threadId];
+  LabelObjectType *labelObject = ITK_NULLPTR;
+
   for ( it.GoToBegin(); !it.IsAtEnd(); it.NextLine() )
     {
     it.GoToBeginOfLine();
@@ -114,8 +120,23 @@ LabelImageToLabelMapFilter< TInputImage, TOutputImage >
           ++length;
           ++it;
           }
-        // create the run length object to go in the vector
-        m_TemporaryImages[threadId]->SetLine(idx, length, value);
+        // add the run to its object
+        const OutputImagePixelType label = static_cast< OutputImagePixelType >( value );
+        if ( labelObject == ITK_NULLPTR || labelObject->GetLabel() != label )
+          {
+          if ( labelMap->HasLabel(label) )
+            {
+            labelObject = labelMap->GetLabelObject(label);
+            }
+          else
+            {
+            typename LabelObjectType::Pointer newLabelObject = LabelObjectType::New();
+            newLabelObject->SetLabel(label);
+            labelMap->AddLabelObject(newLabelObject);
+            labelObject = newLabelObject.GetPointer();
+            }
+          }
+        labelObject->AddLine(idx, length);
         }
       else
         {
@@ -21,6 +21,10 @@
 #include "itkShapeLabelObject.h"
 #include "itkLabelImageToLabelMapFilter.h"
 #include "itkShapeLabelMapFilter.h"
+#include "itkShapeLabelMapAccumulator.h"
+#include "itkAtomicInt.h"
+#include <map>
+#include <vector>
 
 namespace itk
 {
@@ -29,6 +33,19 @@ namespace itk
  *
  *  A convenient class that converts a label image to a label map and valuates the shape attribute at once.
  *
+ * The label image is scanned once, by several threads. Each thread adds the
+ * runs of its part of the image to the objects of its own label map, and
+ * accumulates their moments, bounding boxes, border pixels and the
+ * intercept counts of their perimeter at the same time. The intercepts are
+ * counted by comparing the runs with the neighbor rows of the label image.
+ * The label maps and the sums of the threads are merged at the end, and the
+ * attributes of the objects are then computed from their sums. The Feret
+ * diameter, which is computed from the lines of the objects, is only
+ * computed when it is requested.
+ *
+ * The attributes are the same as the ones computed by a
+ * LabelImageToLabelMapFilter followed by a ShapeLabelMapFilter.
+ *
  * This implementation was taken from the Insight Journal paper:
  *
  * https://hdl.handle.net/1926/584  or
@@ -135,17 +152,50 @@ protected:
   /** LabelImageToShapeLabelMapFilter will produce the entire output. */
   void EnlargeOutputRequestedRegion( DataObject *itkNotUsed(output) ) ITK_OVERRIDE;
 
-  /** Single-threaded version of GenerateData.
-   * This filter delegates to GrayscaleGeodesicErodeImageFilter. */
-  void GenerateData() ITK_OVERRIDE;
+  virtual void BeforeThreadedGenerateData() ITK_OVERRIDE;
+
+  virtual void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId) ITK_OVERRIDE;
+
+  virtual void AfterThreadedGenerateData() ITK_OVERRIDE;
 
 private:
   LabelImageToShapeLabelMapFilter(const Self &) ITK_DELETE_FUNCTION;
   void operator=(const Self &) ITK_DELETE_FUNCTION;
 
+  typedef typename InputImageType::IndexType              IndexType;
+  typedef typename InputImageType::OffsetType             OffsetType;
+  typedef typename LabelObjectType::LengthType            LengthType;
+  typedef ShapeLabelMapAccumulator< OutputImageType >     AccumulatorType;
+  typedef typename AccumulatorType::SumsType              SumsType;
+  typedef std::map< OutputImagePixelType, SumsType >      SumsMapType;
+
+  /** Counts the intercepts of a run with the neighbor pixels of the label
+   * image. */
+  void AddIntercepts(SumsType & sums, const IndexType & idx, LengthType length,
+                     const InputImagePixelType & value) const;
+
+  /** Computes the attributes of the objects, by chunks of objects. */
+  static ITK_THREAD_RETURN_TYPE SetAttributesThreaderCallback(void *arg);
+
   OutputImagePixelType m_BackgroundValue;
   bool                 m_ComputeFeretDiameter;
   bool                 m_ComputePerimeter;
+
+  AccumulatorType                            m_Accumulator;
+  typename std::vector< OutputImagePointer > m_TemporaryImages;
+  typename std::vector< SumsMapType >        m_Sums;
+
+  /** The rows around a row, in the dimensions other than 0, with their
+   * offset in the buffer of the label image and the direction of their
+   * intercepts. */
+  std::vector< OffsetType >      m_NeighborOffsets;
+  std::vector< OffsetValueType > m_NeighborBufferOffsets;
+  std::vector< unsigned int >    m_NeighborInterceptDirections;
+
+  std::vector< LabelObjectType * > m_LabelObjects;
+  std::vector< const SumsType * >  m_LabelObjectSums;
+  SizeValueType                    m_ChunkSize;
+  AtomicInt< SizeValueType >       m_NextLabelObject;
 }; // end of class
 } // end namespace itk
 
@@ -19,7 +19,9 @@
 #define itkLabelImageToShapeLabelMapFilter_hxx
 
 #include "itkLabelImageToShapeLabelMapFilter.h"
-#include "itkProgressAccumulator.h"
+#include "itkProgressReporter.h"
+#include "itkImageLinearConstIteratorWithIndex.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -30,6 +32,7 @@ LabelImageToShapeLabelMapFilter< TInputImage, TOutputImage >
   m_BackgroundValue = NumericTraits< OutputImagePixelType >::NonpositiveMin();
   m_ComputeFeretDiameter = false;
   m_ComputePerimeter = true;
+  m_ChunkSize = 1;
 }
 
 template< typename TInputImage, typename TOutputImage >
@@ -60,32 +63,316 @@ LabelImageToShapeLabelMapFilter< TInputImage, TOutputImage >
 template< typename TInputImage, typename TOutputImage >
 void
 LabelImageToShapeLabelMapFilter< TInputImage, TOutputImage >
-::GenerateData()
+::BeforeThreadedGenerateData()
 {
-  // Create a process accumulator for tracking the progress of this minipipeline
-  ProgressAccumulator::Pointer progress = ProgressAccumulator::New();
-
-  progress->SetMiniPipelineFilter(this);
-
-  // Allocate the output
-  this->AllocateOutputs();
-
-  typename LabelizerType::Pointer labelizer = LabelizerType::New();
-  labelizer->SetInput( this->GetInput() );
-  labelizer->SetBackgroundValue(m_BackgroundValue);
-  labelizer->SetNumberOfThreads( this->GetNumberOfThreads() );
-  progress->RegisterInternalFilter(labelizer, .5f);
-
-  typename LabelObjectValuatorType::Pointer valuator = LabelObjectValuatorType::New();
-  valuator->SetInput( labelizer->GetOutput() );
-  valuator->SetNumberOfThreads( this->GetNumberOfThreads() );
-  valuator->SetComputePerimeter(m_ComputePerimeter);
-  valuator->SetComputeFeretDiameter(m_ComputeFeretDiameter);
-  progress->RegisterInternalFilter(valuator, .5f);
-
-  valuator->GraftOutput( this->GetOutput() );
-  valuator->Update();
-  this->GraftOutput( valuator->GetOutput() );
+  // init the temp images and sums - one per thread
+  m_TemporaryImages.resize( this->GetNumberOfThreads() );
+  m_Sums.clear();
+  m_Sums.resize( this->GetNumberOfThreads() );
+
+  for ( ThreadIdType i = 0; i < this->GetNumberOfThreads(); i++ )
+    {
+    if ( i == 0 )
+      {
+      // the first one is the output image
+      m_TemporaryImages[0] = this->GetOutput();
+      }
+    else
+      {
+      // the other must be created
+      m_TemporaryImages[i] = OutputImageType::New();
+      }
+
+    // set the minimum data needed to create the objects properly
+    m_TemporaryImages[i]->SetBackgroundValue(m_BackgroundValue);
+    }
+
+  m_Accumulator.SetImage( this->GetOutput() );
+
+  // the offsets to the neighbor rows - all the rows around a row, in the
+  // dimensions other than 0
+  const InputImageType *input = this->GetInput();
+  m_NeighborOffsets.clear();
+  m_NeighborBufferOffsets.clear();
+  m_NeighborInterceptDirections.clear();
+  OffsetType offset;
+  offset.Fill( -1 );
+  offset[0] = 0;
+  while( offset[ImageDimension - 1] <= 1 )
+    {
+    bool isCenter = true;
+    OffsetType direction;
+    direction[0] = 0;
+    OffsetValueType bufferOffset = 0;
+    for( unsigned int i = 1; i < ImageDimension; i++ )
+      {
+      isCenter = isCenter && offset[i] == 0;
+      direction[i] = offset[i] != 0;
+      bufferOffset += offset[i] * input->GetOffsetTable()[i];
+      }
+    if( !isCenter )
+      {
+      m_NeighborOffsets.push_back( offset );
+      m_NeighborBufferOffsets.push_back( bufferOffset );
+      m_NeighborInterceptDirections.push_back( AccumulatorType::GetInterceptDirection( direction ) );
+      }
+    // go to the next offset
+    unsigned int i = 1;
+    ++offset[i];
+    while( i < ImageDimension - 1 && offset[i] > 1 )
+      {
+      offset[i] = -1;
+      ++offset[++i];
+      }
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+LabelImageToShapeLabelMapFilter< TInputImage, TOutputImage >
+::ThreadedGenerateData(const OutputImageRegionType & regionForThread, ThreadIdType threadId)
+{
+  const SizeValueType numberOfLines = regionForThread.GetNumberOfPixels() / regionForThread.GetSize(0);
+  ProgressReporter progress( this, threadId, numberOfLines, 100, 0.0f, 0.5f );
+
+  typedef ImageLinearConstIteratorWithIndex< InputImageType > InputLineIteratorType;
+  InputLineIteratorType it(this->GetInput(), regionForThread);
+  it.SetDirection(0);
+
+  // the object of the last run, and its sums - the runs of the same object
+  // are often found one after the other, so the searches are avoided for
+  // them
+  OutputImageType *labelMap = m_TemporaryImages[threadId];
+  SumsMapType &    sumsMap = m_Sums[threadId];
+  LabelObjectType *labelObject = ITK_NULLPTR;
+  SumsType *       sums = ITK_NULLPTR;
+
+  for ( it.GoToBegin(); !it.IsAtEnd(); it.NextLine() )
+    {
+    it.GoToBeginOfLine();
+
+    while ( !it.IsAtEndOfLine() )
+      {
+      const InputImagePixelType & value = it.Get();
+
+      if ( value != static_cast< InputImagePixelType >( m_BackgroundValue ) )
+        {
+        // We've hit the start of a run
+        IndexType  idx = it.GetIndex();
+        LengthType length = 1;
+        ++it;
+        while ( !it.IsAtEndOfLine() && it.Get() == value )
+          {
+          ++length;
+          ++it;
+          }
+        // add the run to its object
+        const OutputImagePixelType label = static_cast< OutputImagePixelType >( value );
+        if ( labelObject == ITK_NULLPTR || labelObject->GetLabel() != label )
+          {
+          if ( labelMap->HasLabel(label) )
+            {
+            labelObject = labelMap->GetLabelObject(label);
+            }
+          else
+            {
+            typename LabelObjectType::Pointer newLabelObject = LabelObjectType::New();
+            newLabelObject->SetLabel(label);
+            labelMap->AddLabelObject(newLabelObject);
+            labelObject = newLabelObject.GetPointer();
+            }
+          sums = &sumsMap[label];
+          }
+        labelObject->AddLine(idx, length);
+
+        // and to its sums
+        m_Accumulator.AddLine(*sums, idx, length);
+        if ( m_ComputePerimeter )
+          {
+          this->AddIntercepts(*sums, idx, length, value);
+          }
+        }
+      else
+        {
+        // go the the next pixel
+        ++it;
+        }
+      }
+    progress.CompletedPixel();
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+LabelImageToShapeLabelMapFilter< TInputImage, TOutputImage >
+::AddIntercepts(SumsType & sums, const IndexType & idx, LengthType length,
+                const InputImagePixelType & value) const
+{
+  const InputImageType *       input = this->GetInput();
+  const InputImageRegionType & region = input->GetBufferedRegion();
+  const IndexType &            regionIndex = region.GetIndex();
+  const typename InputImageType::SizeType & regionSize = region.GetSize();
+
+  // the pixels before and after the run in the row, which are outside of
+  // the object when they are outside of the image
+  const bool hasPrevious = idx[0] > regionIndex[0];
+  const bool hasNext = idx[0] + static_cast< OffsetValueType >( length )
+                       < regionIndex[0] + static_cast< OffsetValueType >( regionSize[0] );
+
+  const InputImagePixelType *line = input->GetBufferPointer() + input->ComputeOffset(idx);
+
+  // the ends of the run which are next to another label; the runs are
+  // usually complete, but they are split where the regions of the threads
+  // cut the rows
+  SizeValueType *intercepts = sums.m_Intercepts;
+  intercepts[1] += ( !hasPrevious || line[-1] != value ) + ( !hasNext || line[length] != value );
+
+  // and the pixels of the run next to another label in the neighbor rows
+  for ( unsigned int n = 0; n < m_NeighborOffsets.size(); n++ )
+    {
+    SizeValueType & noIntercepts = intercepts[m_NeighborInterceptDirections[n]];
+    SizeValueType & dnoIntercepts = intercepts[m_NeighborInterceptDirections[n] | 1];
+
+    bool isInside = true;
+    for ( unsigned int i = 1; i < ImageDimension; i++ )
+      {
+      const OffsetValueType neighborIndex = idx[i] + m_NeighborOffsets[n][i];
+      isInside = isInside && neighborIndex >= regionIndex[i]
+                 && neighborIndex < regionIndex[i] + static_cast< OffsetValueType >( regionSize[i] );
+      }
+    if ( !isInside )
+      {
+      // no object in the neighbor row: all the pixels are on the contour
+      noIntercepts += length;
+      dnoIntercepts += 2 * length;
+      continue;
+      }
+
+    // count the pixels of the neighbor row which are not in the object,
+    // along the run, and before and after it for the diagonals
+    const InputImagePixelType *neighborLine = line + m_NeighborBufferOffsets[n];
+    SizeValueType              count = 0;
+    for ( LengthType l = 0; l < length; l++ )
+      {
+      count += neighborLine[l] != value;
+      }
+    const SizeValueType first = neighborLine[0] != value;
+    const SizeValueType last = neighborLine[length - 1] != value;
+    const SizeValueType previous = !hasPrevious || neighborLine[-1] != value;
+    const SizeValueType next = !hasNext || neighborLine[length] != value;
+
+    noIntercepts += count;
+    // left and right diagonal intercepts
+    dnoIntercepts += ( count - last + previous ) + ( count - first + next );
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+LabelImageToShapeLabelMapFilter< TInputImage, TOutputImage >
+::AfterThreadedGenerateData()
+{
+  OutputImageType *output = this->GetOutput();
+  SumsMapType &    sumsMap = m_Sums[0];
+
+  // merge the lines and the sums of the temporary images in the output image
+  // don't use the first image - that's the output image
+  for ( ThreadIdType i = 1; i < this->GetNumberOfThreads(); i++ )
+    {
+    for ( typename OutputImageType::Iterator it( m_TemporaryImages[i] );
+          ! it.IsAtEnd();
+          ++it )
+      {
+      LabelObjectType *labelObject = it.GetLabelObject();
+      if ( output->HasLabel( labelObject->GetLabel() ) )
+        {
+        // merge the lines in the output's object
+        LabelObjectType * lo = output->GetLabelObject( labelObject->GetLabel() );
+        typename LabelObjectType::ConstLineIterator lit( labelObject );
+        while( ! lit.IsAtEnd() )
+          {
+          lo->AddLine( lit.GetLine() );
+          ++lit;
+          }
+        }
+      else
+        {
+        // simply take the object
+        output->AddLabelObject(labelObject);
+        }
+      }
+    for ( typename SumsMapType::const_iterator it = m_Sums[i].begin(); it != m_Sums[i].end(); ++it )
+      {
+      sumsMap[it->first] += it->second;
+      }
+    m_Sums[i].clear();
+    }
+
+  // release the data in the temp images
+  m_TemporaryImages.clear();
+
+  // now compute the attributes of the objects, by chunks of objects which
+  // are taken by the threads as they are done with the previous ones
+  m_LabelObjects.clear();
+  m_LabelObjectSums.clear();
+  m_LabelObjects.reserve( output->GetNumberOfLabelObjects() );
+  m_LabelObjectSums.reserve( output->GetNumberOfLabelObjects() );
+  for ( typename OutputImageType::Iterator it( output ); !it.IsAtEnd(); ++it )
+    {
+    m_LabelObjects.push_back( it.GetLabelObject() );
+    m_LabelObjectSums.push_back( &sumsMap[it.GetLabel()] );
+    }
+  const SizeValueType numberOfChunks = 16 * static_cast< SizeValueType >( this->GetNumberOfThreads() );
+  m_ChunkSize = std::max( static_cast< SizeValueType >( m_LabelObjects.size() ) / numberOfChunks,
+                          static_cast< SizeValueType >( 1 ) );
+  m_NextLabelObject = 0;
+
+  MultiThreader *threader = this->GetMultiThreader();
+  threader->SetNumberOfThreads( this->GetNumberOfThreads() );
+  threader->SetSingleMethod(Self::SetAttributesThreaderCallback, this);
+  threader->SingleMethodExecute();
+
+  m_LabelObjects.clear();
+  m_LabelObjectSums.clear();
+  m_Sums.clear();
+  this->UpdateProgress(1.0);
+}
+
+template< typename TInputImage, typename TOutputImage >
+ITK_THREAD_RETURN_TYPE
+LabelImageToShapeLabelMapFilter< TInputImage, TOutputImage >
+::SetAttributesThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  Self *                           filter = static_cast< Self * >( info->UserData );
+
+  const SizeValueType numberOfLabelObjects = static_cast< SizeValueType >( filter->m_LabelObjects.size() );
+  while ( true )
+    {
+    // take the next chunk of objects
+    const SizeValueType end = ( filter->m_NextLabelObject += filter->m_ChunkSize );
+    const SizeValueType begin = end - filter->m_ChunkSize;
+    if ( begin >= numberOfLabelObjects )
+      {
+      return ITK_THREAD_RETURN_VALUE;
+      }
+
+    const SizeValueType chunkEnd = std::min( end, numberOfLabelObjects );
+    for ( SizeValueType i = begin; i < chunkEnd; ++i )
+      {
+      LabelObjectType * labelObject = filter->m_LabelObjects[i];
+      const SumsType &  sums = *filter->m_LabelObjectSums[i];
+      filter->m_Accumulator.SetAttributes( labelObject, sums );
+      if ( filter->m_ComputePerimeter )
+        {
+        filter->m_Accumulator.SetPerimeter( labelObject, sums );
+        }
+      if ( filter->m_ComputeFeretDiameter )
+        {
+        filter->m_Accumulator.SetFeretDiameter( labelObject );
+        }
+      }
+    }
 }
 
 template< typename TInputImage, typename TOutputImage >
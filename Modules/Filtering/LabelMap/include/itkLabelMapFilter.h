@@ -30,6 +30,8 @@
 
 #include "itkImageToImageFilter.h"
 #include "itkFastMutexLock.h"
+#include "itkAtomicInt.h"
+#include <vector>
 
 namespace itk
 {
@@ -42,6 +44,12 @@ namespace itk
  * With that class, the developer doesn't need to take care of iterating over all the objects in
  * the image, or to manage by hand the threads.
  *
+ * The objects are gathered in a vector before the threads are started, and
+ * the threads take them by chunks of consecutive objects, so no lock is
+ * needed to dispatch them. ThreadedProcessLabelObject() may remove the
+ * object it processes from the label map, but must lock
+ * m_LabelObjectContainerLock to do so.
+ *
  * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
  *
  * This implementation was taken from the Insight Journal paper:
@@ -124,9 +132,11 @@ private:
   LabelMapFilter(const Self &) ITK_DELETE_FUNCTION;
   void operator=(const Self &) ITK_DELETE_FUNCTION;
 
-  typename InputImageType::Iterator m_LabelObjectIterator;
-  float                             m_InverseNumberOfLabelObjects;
-  SizeValueType                     m_NumberOfLabelObjectsProcessed;
+  std::vector< LabelObjectType * > m_LabelObjects;
+  SizeValueType                    m_ChunkSize;
+  AtomicInt< SizeValueType >       m_NextLabelObject;
+  float                            m_InverseNumberOfLabelObjects;
+  AtomicInt< SizeValueType >       m_NumberOfLabelObjectsProcessed;
 };
 } // end namespace itk
 
@@ -28,13 +28,15 @@
 #ifndef itkLabelMapFilter_hxx
 #define itkLabelMapFilter_hxx
 #include "itkLabelMapFilter.h"
-#include "itkMutexLockHolder.h"
+#include <algorithm>
 
 namespace itk
 {
 template< typename TInputImage, typename TOutputImage >
 LabelMapFilter< TInputImage, TOutputImage >
 ::LabelMapFilter():
+  m_ChunkSize( 1 ),
+  m_NextLabelObject( 0 ),
   m_InverseNumberOfLabelObjects( 1.0f ),
   m_NumberOfLabelObjectsProcessed( 1 )
 {
@@ -76,9 +78,21 @@ void
 LabelMapFilter< TInputImage, TOutputImage >
 ::BeforeThreadedGenerateData()
 {
-  // initialize the iterator
-  m_LabelObjectIterator =  typename InputImageType::Iterator(this->GetLabelMap());
-//  m_LabelObjectIterator = typename InputImageType::Iterator(this->GetLabelMap());
+  // gather the objects, so the threads can take them without iterating over
+  // the label map, which may be modified by the threads
+  m_LabelObjects.clear();
+  m_LabelObjects.reserve( this->GetLabelMap()->GetNumberOfLabelObjects() );
+  for ( typename InputImageType::Iterator it( this->GetLabelMap() ); !it.IsAtEnd(); ++it )
+    {
+    m_LabelObjects.push_back( it.GetLabelObject() );
+    }
+
+  // several chunks per thread, to balance the load when the objects are of
+  // very different sizes
+  const SizeValueType numberOfChunks = 16 * static_cast< SizeValueType >( this->GetNumberOfThreads() );
+  m_ChunkSize = std::max( static_cast< SizeValueType >( m_LabelObjects.size() ) / numberOfChunks,
+                          static_cast< SizeValueType >( 1 ) );
+  m_NextLabelObject = 0;
 
   // and the mutex
   m_LabelObjectContainerLock = FastMutexLock::New();
@@ -100,6 +114,7 @@ void
 LabelMapFilter< TInputImage, TOutputImage >
 ::AfterThreadedGenerateData()
 {
+  m_LabelObjects.clear();
   this->UpdateProgress(1.0);
 }
 
@@ -108,51 +123,41 @@ void
 LabelMapFilter< TInputImage, TOutputImage >
 ::ThreadedGenerateData( const OutputImageRegionType &, ThreadIdType threadId )
 {
+  const SizeValueType numberOfLabelObjects = static_cast< SizeValueType >( m_LabelObjects.size() );
+
   while ( true )
     {
-    LabelObjectType *labelObject;
-    // begin mutex lock
-    {
-    MutexLockHolder< FastMutexLock > lock(*m_LabelObjectContainerLock );
-
-    if ( m_LabelObjectIterator.IsAtEnd() )
+    // take the next chunk of objects
+    const SizeValueType end = ( m_NextLabelObject += m_ChunkSize );
+    const SizeValueType begin = end - m_ChunkSize;
+    if ( begin >= numberOfLabelObjects )
       {
-      // mutex lock holder deleted
       return;
       }
 
-    // get the label object
-    labelObject = m_LabelObjectIterator.GetLabelObject();
-
-    // increment the iterator now, so it will not be invalidated if the object
-    // is destroyed
-    ++m_LabelObjectIterator;
-    ++m_NumberOfLabelObjectsProcessed;
-
-    // unlock the mutex, so the other threads can get an object
-    }
-    // end mutex lock
-
-
-    // and run the user defined method for that object
-    this->ThreadedProcessLabelObject(labelObject);
-
-    if (threadId==0)
+    const SizeValueType chunkEnd = std::min( end, numberOfLabelObjects );
+    for ( SizeValueType i = begin; i < chunkEnd; ++i )
       {
-      const float progress = m_InverseNumberOfLabelObjects*m_NumberOfLabelObjectsProcessed;
-      this->UpdateProgress(progress);
+      // run the user defined method for that object
+      this->ThreadedProcessLabelObject(m_LabelObjects[i]);
+
+      // all threads needs to check the abort flag
+      if ( this->GetAbortGenerateData() )
+        {
+        std::string    msg;
+        ProcessAborted e(__FILE__, __LINE__);
+        msg += "Object " + std::string(this->GetNameOfClass() ) + ": AbortGenerateDataOn";
+        e.SetDescription(msg);
+        throw e;
+        }
       }
 
-    // all threads needs to check the abort flag
-    if ( this->GetAbortGenerateData() )
+    const SizeValueType processed = ( m_NumberOfLabelObjectsProcessed += chunkEnd - begin );
+    if (threadId==0)
       {
-      std::string    msg;
-      ProcessAborted e(__FILE__, __LINE__);
-      msg += "Object " + std::string(this->GetNameOfClass() ) + ": AbortGenerateDataOn";
-      e.SetDescription(msg);
-      throw e;
+      const float progress = m_InverseNumberOfLabelObjects*processed;
+      this->UpdateProgress(progress);
       }
-
     }
 }
 
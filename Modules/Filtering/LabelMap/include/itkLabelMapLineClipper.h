@@ -0,0 +1,128 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkLabelMapLineClipper_h
+#define itkLabelMapLineClipper_h
+
+#include "itkLabelMap.h"
+#include <vector>
+
+namespace itk
+{
+/** \class LabelMapLineClipper
+ * \brief Keep the objects of a LabelMap disjoint when a filter adds pixels
+ * to them
+ *
+ * The filters which process each object of a LabelMap as if it was alone,
+ * like a dilation or a hole filling, may add to an object pixels which
+ * belong to another object, or add the same pixel to several objects.
+ * LabelMapLineClipper removes these pixels, on the lines of the objects:
+ *
+ * - Initialize() stores the lines of all the objects before they are
+ *   modified.
+ * - ClipToInput() removes from the lines computed for an object the pixels
+ *   of the other objects. It is called by the threads, for each object.
+ * - Resolve() is called once all the objects are processed. A pixel added
+ *   to several objects is kept in the one with the lowest label.
+ *
+ * The pixels of an object in the input are always kept in that object.
+ *
+ * \sa BinaryFillholeLabelMapFilter BinaryDilateLabelMapFilter
+ * \ingroup ITKLabelMap
+ */
+template< typename TImage >
+class LabelMapLineClipper
+{
+public:
+  /** Some convenient typedefs. */
+  typedef TImage                              ImageType;
+  typedef typename ImageType::IndexType       IndexType;
+  typedef typename ImageType::LabelObjectType LabelObjectType;
+  typedef typename LabelObjectType::LineType  LineType;
+  typedef std::vector< LineType >             LineContainerType;
+
+  /** ImageDimension constants */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TImage::ImageDimension);
+
+  /** Store the lines of the objects of the label map. */
+  void Initialize(const ImageType *labelMap);
+
+  /** Keep the parts of lines which are in input, the lines of the object in
+   * the label map given to Initialize(), or in none of its objects. The
+   * lines must be sorted and must not overlap, and so are the output
+   * lines. */
+  void ClipToInput(const LineContainerType & input, const LineContainerType & lines,
+                   LineContainerType & output) const;
+
+  /** Remove the pixels added to several objects from all of them but the
+   * one with the lowest label, and release the stored lines. */
+  void Resolve(ImageType *labelMap);
+
+  /** Keep the parts of lines which are inside, or outside, mask. The lines
+   * must be sorted and must not overlap, and so are the output lines. */
+  static void Clip(const LineContainerType & lines, const LineContainerType & mask, bool inside,
+                   LineContainerType & output);
+
+private:
+  /** Orders the lines by their position in the dimensions greater than
+   * zero only. */
+  struct LinePositionComparator
+  {
+    bool operator()(const LineType & l1, const LineType & l2) const
+    {
+      for ( int i = ImageDimension - 1; i > 0; i-- )
+        {
+        if ( l1.GetIndex()[i] != l2.GetIndex()[i] )
+          {
+          return l1.GetIndex()[i] < l2.GetIndex()[i];
+          }
+        }
+      return false;
+    }
+  };
+
+  /** A line added to an object, and the rank of the object. */
+  typedef std::pair< LineType, SizeValueType > AddedLineType;
+
+  struct AddedLinePositionComparator
+  {
+    bool operator()(const AddedLineType & l1, const AddedLineType & l2) const
+    {
+      return LinePositionComparator()( l1.first, l2.first );
+    }
+  };
+
+  /** Intervals [first, second] along the first dimension. */
+  typedef std::pair< OffsetValueType, OffsetValueType > IntervalType;
+  typedef std::vector< IntervalType >                   IntervalContainerType;
+
+  /** Append the line [begin, end] at index to the lines, merging it with
+   * the last line if they touch. */
+  static void AppendLine(LineContainerType & lines, IndexType index, OffsetValueType begin,
+                         OffsetValueType end);
+
+  /** The lines of all the objects, sorted and merged. */
+  LineContainerType m_Lines;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkLabelMapLineClipper.hxx"
+#endif
+
+#endif
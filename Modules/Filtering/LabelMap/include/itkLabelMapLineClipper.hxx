@@ -0,0 +1,264 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkLabelMapLineClipper_hxx
+#define itkLabelMapLineClipper_hxx
+
+#include "itkLabelMapLineClipper.h"
+#include "itkLabelObjectLineComparator.h"
+#include <algorithm>
+
+namespace itk
+{
+template< typename TImage >
+void
+LabelMapLineClipper< TImage >
+::Initialize(const ImageType *labelMap)
+{
+  LineContainerType lines;
+  for ( typename ImageType::ConstIterator it( labelMap ); !it.IsAtEnd(); ++it )
+    {
+    const LabelObjectType *labelObject = it.GetLabelObject();
+    for ( SizeValueType i = 0; i < labelObject->GetNumberOfLines(); i++ )
+      {
+      lines.push_back( labelObject->GetLine(i) );
+      }
+    }
+
+  // the lines of different objects may touch, or overlap when the objects
+  // do, so they are merged
+  std::sort( lines.begin(), lines.end(), Functor::LabelObjectLineComparator< LineType >() );
+  m_Lines.clear();
+  m_Lines.reserve( lines.size() );
+  for ( typename LineContainerType::const_iterator it = lines.begin(); it != lines.end(); ++it )
+    {
+    AppendLine( m_Lines, it->GetIndex(), it->GetIndex()[0],
+                it->GetIndex()[0] + static_cast< OffsetValueType >( it->GetLength() ) - 1 );
+    }
+}
+
+template< typename TImage >
+void
+LabelMapLineClipper< TImage >
+::ClipToInput(const LineContainerType & input, const LineContainerType & lines, LineContainerType & output) const
+{
+  LineContainerType own;
+  LineContainerType added;
+  Clip( lines, input, true, own );
+  Clip( lines, m_Lines, false, added );
+
+  // both are sorted and disjoint
+  output.clear();
+  output.reserve( own.size() + added.size() );
+  typename LineContainerType::const_iterator it1 = own.begin();
+  typename LineContainerType::const_iterator it2 = added.begin();
+  Functor::LabelObjectLineComparator< LineType > comparator;
+  while ( it1 != own.end() || it2 != added.end() )
+    {
+    const LineType & line = ( it2 == added.end() || ( it1 != own.end() && comparator( *it1, *it2 ) ) )
+                            ? *it1++ : *it2++;
+    AppendLine( output, line.GetIndex(), line.GetIndex()[0],
+                line.GetIndex()[0] + static_cast< OffsetValueType >( line.GetLength() ) - 1 );
+    }
+}
+
+template< typename TImage >
+void
+LabelMapLineClipper< TImage >
+::Resolve(ImageType *labelMap)
+{
+  // the pixels added to the objects, with the rank of their object. The
+  // label map is ordered by label.
+  std::vector< AddedLineType >     addedLines;
+  std::vector< LabelObjectType * > labelObjects;
+  LineContainerType                lines;
+  LineContainerType                added;
+  for ( typename ImageType::Iterator it( labelMap ); !it.IsAtEnd(); ++it )
+    {
+    LabelObjectType *labelObject = it.GetLabelObject();
+    labelObject->Optimize();
+    lines.clear();
+    for ( SizeValueType i = 0; i < labelObject->GetNumberOfLines(); i++ )
+      {
+      lines.push_back( labelObject->GetLine(i) );
+      }
+    Clip( lines, m_Lines, false, added );
+    for ( typename LineContainerType::const_iterator lit = added.begin(); lit != added.end(); ++lit )
+      {
+      addedLines.push_back( AddedLineType( *lit, labelObjects.size() ) );
+      }
+    labelObjects.push_back( labelObject );
+    }
+  m_Lines.clear();
+
+  // group the added lines by position, keeping the order of the objects and
+  // the order of the lines of each object, and remove from each line the
+  // pixels already added to an object with a lower label
+  LinePositionComparator positionComparator;
+  std::stable_sort( addedLines.begin(), addedLines.end(), AddedLinePositionComparator() );
+  std::vector< LineContainerType > removedLines( labelObjects.size() );
+  IntervalContainerType            taken;
+  IntervalContainerType            merged;
+  bool                             anyRemoved = false;
+  for ( SizeValueType i = 0; i < addedLines.size(); i++ )
+    {
+    const LineType & line = addedLines[i].first;
+    if ( i == 0 || positionComparator( addedLines[i - 1].first, line ) )
+      {
+      taken.clear();
+      }
+    const OffsetValueType begin = line.GetIndex()[0];
+    const OffsetValueType end = begin + static_cast< OffsetValueType >( line.GetLength() ) - 1;
+    for ( typename IntervalContainerType::const_iterator tit = taken.begin(); tit != taken.end(); ++tit )
+      {
+      if ( tit->second < begin )
+        {
+        continue;
+        }
+      if ( tit->first > end )
+        {
+        break;
+        }
+      AppendLine( removedLines[addedLines[i].second], line.GetIndex(), std::max( tit->first, begin ),
+                  std::min( tit->second, end ) );
+      anyRemoved = true;
+      }
+
+    // add the line to the pixels taken at that position
+    merged.clear();
+    bool inserted = false;
+    for ( typename IntervalContainerType::const_iterator tit = taken.begin(); tit != taken.end() || !inserted; )
+      {
+      IntervalType interval;
+      if ( !inserted && ( tit == taken.end() || begin < tit->first ) )
+        {
+        interval = IntervalType( begin, end );
+        inserted = true;
+        }
+      else
+        {
+        interval = *tit++;
+        }
+      if ( !merged.empty() && interval.first <= merged.back().second + 1 )
+        {
+        merged.back().second = std::max( merged.back().second, interval.second );
+        }
+      else
+        {
+        merged.push_back( interval );
+        }
+      }
+    taken.swap( merged );
+    }
+
+  if ( !anyRemoved )
+    {
+    return;
+    }
+  for ( SizeValueType o = 0; o < labelObjects.size(); o++ )
+    {
+    if ( removedLines[o].empty() )
+      {
+      continue;
+      }
+    LabelObjectType *labelObject = labelObjects[o];
+    lines.clear();
+    for ( SizeValueType i = 0; i < labelObject->GetNumberOfLines(); i++ )
+      {
+      lines.push_back( labelObject->GetLine(i) );
+      }
+    Clip( lines, removedLines[o], false, added );
+    labelObject->Clear();
+    for ( typename LineContainerType::const_iterator lit = added.begin(); lit != added.end(); ++lit )
+      {
+      labelObject->AddLine( *lit );
+      }
+    }
+}
+
+template< typename TImage >
+void
+LabelMapLineClipper< TImage >
+::Clip(const LineContainerType & lines, const LineContainerType & mask, bool inside, LineContainerType & output)
+{
+  output.clear();
+  output.reserve( lines.size() );
+  for ( typename LineContainerType::const_iterator it = lines.begin(); it != lines.end(); ++it )
+    {
+    const OffsetValueType begin = it->GetIndex()[0];
+    const OffsetValueType end = begin + static_cast< OffsetValueType >( it->GetLength() ) - 1;
+    OffsetValueType       x = begin;
+
+    // the lines of the mask at that position, ordered along the first
+    // dimension
+    std::pair< typename LineContainerType::const_iterator, typename LineContainerType::const_iterator > range =
+      std::equal_range( mask.begin(), mask.end(), *it, LinePositionComparator() );
+    for ( typename LineContainerType::const_iterator mit = range.first; mit != range.second; ++mit )
+      {
+      const OffsetValueType maskBegin = mit->GetIndex()[0];
+      const OffsetValueType maskEnd = maskBegin + static_cast< OffsetValueType >( mit->GetLength() ) - 1;
+      if ( maskEnd < x )
+        {
+        continue;
+        }
+      if ( maskBegin > end )
+        {
+        break;
+        }
+      if ( inside )
+        {
+        AppendLine( output, it->GetIndex(), std::max( maskBegin, x ), std::min( maskEnd, end ) );
+        }
+      else if ( maskBegin > x )
+        {
+        AppendLine( output, it->GetIndex(), x, maskBegin - 1 );
+        }
+      x = maskEnd + 1;
+      }
+    if ( !inside && x <= end )
+      {
+      AppendLine( output, it->GetIndex(), x, end );
+      }
+    }
+}
+
+template< typename TImage >
+void
+LabelMapLineClipper< TImage >
+::AppendLine(LineContainerType & lines, IndexType index, OffsetValueType begin, OffsetValueType end)
+{
+  if ( !lines.empty() )
+    {
+    LineType & last = lines.back();
+    const OffsetValueType lastBegin = last.GetIndex()[0];
+    const OffsetValueType lastEnd = lastBegin + static_cast< OffsetValueType >( last.GetLength() ) - 1;
+    bool samePosition = true;
+    for ( unsigned int i = 1; i < ImageDimension; i++ )
+      {
+      samePosition = samePosition && last.GetIndex()[i] == index[i];
+      }
+    if ( samePosition && begin <= lastEnd + 1 )
+      {
+      last.SetLength( std::max( lastEnd, end ) - lastBegin + 1 );
+      return;
+      }
+    }
+  index[0] = begin;
+  lines.push_back( LineType( index, end - begin + 1 ) );
+}
+} // end namespace itk
+#endif
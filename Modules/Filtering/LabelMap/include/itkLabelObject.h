@@ -18,7 +18,7 @@
 #ifndef itkLabelObject_h
 #define itkLabelObject_h
 
-#include <deque>
+#include <vector>
 #include "itkLightObject.h"
 #include "itkLabelObjectLine.h"
 #include "itkWeakPointer.h"
@@ -250,7 +250,7 @@ public:
     }
 
   private:
-    typedef typename std::deque< LineType >            LineContainerType;
+    typedef typename std::vector< LineType >           LineContainerType;
     typedef typename LineContainerType::const_iterator InternalIteratorType;
     InternalIteratorType m_Iterator;
     InternalIteratorType m_Begin;
@@ -345,7 +345,7 @@ public:
 
   private:
 
-    typedef typename std::deque< LineType >            LineContainerType;
+    typedef typename std::vector< LineType >           LineContainerType;
     typedef typename LineContainerType::const_iterator InternalIteratorType;
     void NextValidLine()
     {
@@ -374,7 +374,7 @@ private:
   LabelObject(const Self &) ITK_DELETE_FUNCTION;
   void operator=(const Self &) ITK_DELETE_FUNCTION;
 
-  typedef typename std::deque< LineType >    LineContainerType;
+  typedef typename std::vector< LineType >   LineContainerType;
 
   LineContainerType m_LineContainer;
   LabelType         m_Label;
@@ -0,0 +1,144 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkShapeLabelMapAccumulator_h
+#define itkShapeLabelMapAccumulator_h
+
+#include "itkContinuousIndex.h"
+#include "itkVector.h"
+
+namespace itk
+{
+/** \class ShapeLabelMapAccumulator
+ * \brief Accumulates the sums from which the shape attributes of the
+ * objects of a label map are computed.
+ *
+ * The sums of an object are accumulated line by line in a SumsType. The
+ * sums of the parts of an object, for example the parts found by several
+ * threads, are added together before the attributes are set in the object.
+ *
+ * The intercept counts used to compute the perimeter are stored by
+ * direction. A direction is an offset with components of 0 or 1, and is
+ * stored at the position which has bit i set when its component i is 1.
+ * They can be counted from the lines of the object with AddIntercepts(),
+ * or from the label image while it is scanned.
+ *
+ * The accumulator must be given the label map, or an image with the same
+ * geometry, with SetImage() before it is used.
+ *
+ * \sa ShapeLabelMapFilter, LabelImageToShapeLabelMapFilter
+ * \ingroup ITKLabelMap
+ */
+template< typename TImage >
+class ShapeLabelMapAccumulator
+{
+public:
+  /** Standard class typedefs. */
+  typedef ShapeLabelMapAccumulator Self;
+
+  /** Some convenient typedefs. */
+  typedef TImage                                ImageType;
+  typedef typename ImageType::IndexType         IndexType;
+  typedef typename ImageType::OffsetType        OffsetType;
+  typedef typename ImageType::SpacingType       SpacingType;
+  typedef typename ImageType::LabelObjectType   LabelObjectType;
+  typedef typename LabelObjectType::LengthType  LengthType;
+  typedef typename LabelObjectType::MatrixType  MatrixType;
+  typedef typename LabelObjectType::VectorType  VectorType;
+
+  /** ImageDimension constants */
+  itkStaticConstMacro(ImageDimension, unsigned int, TImage::ImageDimension);
+
+  /** The number of directions in which the intercepts are counted. */
+  itkStaticConstMacro(NumberOfInterceptDirections, unsigned int, 1 << ImageDimension);
+
+  typedef ContinuousIndex< double, ImageDimension > ContinuousIndexType;
+
+  /** The sums over the lines of an object, or of a part of an object. */
+  struct SumsType
+    {
+    SumsType();
+
+    /** Adds the sums of another part of the object. */
+    SumsType & operator+=(const SumsType & sums);
+
+    SizeValueType       m_NumberOfPixels;
+    ContinuousIndexType m_IndexSum;
+    IndexType           m_Minimum;
+    IndexType           m_Maximum;
+    SizeValueType       m_NumberOfPixelsOnBorder;
+    double              m_PerimeterOnBorder;
+    MatrixType          m_SecondOrderMoments;
+    SizeValueType       m_Intercepts[NumberOfInterceptDirections];
+    };
+
+  ShapeLabelMapAccumulator();
+
+  /** Set the image whose geometry is used to compute the attributes. */
+  void SetImage(const ImageType *image);
+
+  /** Adds a line to the sums of an object, all but the intercepts. */
+  void AddLine(SumsType & sums, const IndexType & idx, LengthType length) const;
+
+  /** Counts the intercepts of all the lines of an object. */
+  void AddIntercepts(SumsType & sums, const LabelObjectType *labelObject) const;
+
+  /** Sets the attributes computed from the sums in the object, all but
+   * the perimeter and the Feret diameter. */
+  void SetAttributes(LabelObjectType *labelObject, const SumsType & sums) const;
+
+  /** Sets the perimeter and the attributes which depend on it in the
+   * object, from the intercept counts. SetAttributes() must have been
+   * called before. */
+  void SetPerimeter(LabelObjectType *labelObject, const SumsType & sums) const;
+
+  /** Computes the Feret diameter of the object from its lines, and sets
+   * it in the object. */
+  void SetFeretDiameter(LabelObjectType *labelObject) const;
+
+  /** The position of the intercept counts of a direction. */
+  static unsigned int GetInterceptDirection(const OffsetType & direction);
+
+private:
+  /** Compares the rows of two indexes, without the dimension 0, in the
+   * order of LabelObjectLineComparator. */
+  static bool RowIsBefore(const IndexType & idx1, const IndexType & idx2);
+
+  typedef Vector< double, 2 > Spacing2Type;
+  typedef Vector< double, 3 > Spacing3Type;
+
+  // it seems impossible to specialize a method without specializing the whole class, but we
+  // can use simple overloading
+  template< typename TSpacing > static double PerimeterFromInterceptCount( const SizeValueType *intercepts, const TSpacing & spacing );
+#if ! defined(ITK_DO_NOT_USE_PERIMETER_SPECIALIZATION)
+  static double PerimeterFromInterceptCount( const SizeValueType *intercepts, const Spacing2Type spacing );
+  static double PerimeterFromInterceptCount( const SizeValueType *intercepts, const Spacing3Type spacing );
+#endif
+
+  const ImageType *m_Image;
+  double           m_SizePerPixel;
+  double           m_SizePerPixelPerDimension[ImageDimension];
+  IndexType        m_BorderMin;
+  IndexType        m_BorderMax;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkShapeLabelMapAccumulator.hxx"
+#endif
+
+#endif
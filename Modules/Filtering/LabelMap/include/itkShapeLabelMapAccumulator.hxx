@@ -0,0 +1,734 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkShapeLabelMapAccumulator_hxx
+#define itkShapeLabelMapAccumulator_hxx
+
+#include "itkShapeLabelMapAccumulator.h"
+#include "itkGeometryUtilities.h"
+#include "itkLabelObjectLineComparator.h"
+#include "itkMath.h"
+#include "vnl/algo/vnl_real_eigensystem.h"
+#include "vnl/algo/vnl_symmetric_eigensystem.h"
+#include "vnl/vnl_math.h"
+#include <algorithm>
+#include <vector>
+
+namespace itk
+{
+template< typename TImage >
+ShapeLabelMapAccumulator< TImage >::SumsType
+::SumsType()
+{
+  m_NumberOfPixels = 0;
+  m_IndexSum.Fill(0);
+  m_Minimum.Fill( NumericTraits< IndexValueType >::max() );
+  m_Maximum.Fill( NumericTraits< IndexValueType >::NonpositiveMin() );
+  m_NumberOfPixelsOnBorder = 0;
+  m_PerimeterOnBorder = 0;
+  m_SecondOrderMoments.Fill(0);
+  std::fill( m_Intercepts, m_Intercepts + NumberOfInterceptDirections, 0 );
+}
+
+template< typename TImage >
+typename ShapeLabelMapAccumulator< TImage >::SumsType &
+ShapeLabelMapAccumulator< TImage >::SumsType
+::operator+=(const SumsType & sums)
+{
+  m_NumberOfPixels += sums.m_NumberOfPixels;
+  for ( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    m_IndexSum[i] += sums.m_IndexSum[i];
+    m_Minimum[i] = std::min( m_Minimum[i], sums.m_Minimum[i] );
+    m_Maximum[i] = std::max( m_Maximum[i], sums.m_Maximum[i] );
+    }
+  m_NumberOfPixelsOnBorder += sums.m_NumberOfPixelsOnBorder;
+  m_PerimeterOnBorder += sums.m_PerimeterOnBorder;
+  m_SecondOrderMoments += sums.m_SecondOrderMoments;
+  for ( unsigned int d = 0; d < NumberOfInterceptDirections; d++ )
+    {
+    m_Intercepts[d] += sums.m_Intercepts[d];
+    }
+  return *this;
+}
+
+template< typename TImage >
+ShapeLabelMapAccumulator< TImage >
+::ShapeLabelMapAccumulator()
+{
+  m_Image = ITK_NULLPTR;
+  m_SizePerPixel = 1;
+  std::fill( m_SizePerPixelPerDimension, m_SizePerPixelPerDimension + ImageDimension, 1.0 );
+  m_BorderMin.Fill(0);
+  m_BorderMax.Fill(0);
+}
+
+template< typename TImage >
+void
+ShapeLabelMapAccumulator< TImage >
+::SetImage(const ImageType *image)
+{
+  m_Image = image;
+
+  // Compute the size per pixel, to be used later
+  const SpacingType & spacing = image->GetSpacing();
+  m_SizePerPixel = 1;
+  for ( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    m_SizePerPixel *= spacing[i];
+    }
+  for ( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    m_SizePerPixelPerDimension[i] = m_SizePerPixel / spacing[i];
+    }
+
+  // Compute the max the index on the border of the image
+  m_BorderMin = image->GetLargestPossibleRegion().GetIndex();
+  m_BorderMax = m_BorderMin;
+  for ( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    m_BorderMax[i] += image->GetLargestPossibleRegion().GetSize()[i] - 1;
+    }
+}
+
+template< typename TImage >
+void
+ShapeLabelMapAccumulator< TImage >
+::AddLine(SumsType & sums, const IndexType & idx, LengthType length) const
+{
+  // Update the nbOfPixels
+  sums.m_NumberOfPixels += length;
+
+  // Update the centroid
+  // First, update the axes that are not 0
+  for ( unsigned int i = 1; i < ImageDimension; i++ )
+    {
+    sums.m_IndexSum[i] += (OffsetValueType)length * idx[i];
+    }
+  // Then, update the axis 0
+  sums.m_IndexSum[0] += idx[0] * (OffsetValueType)length + ( length * ( length - 1 ) ) / 2.0;
+
+  // Update the mins and maxs
+  for ( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    if ( idx[i] < sums.m_Minimum[i] )
+      {
+      sums.m_Minimum[i] = idx[i];
+      }
+    if ( idx[i] > sums.m_Maximum[i] )
+      {
+      sums.m_Maximum[i] = idx[i];
+      }
+    }
+  // Must fix the max for the axis 0
+  if ( idx[0] + (OffsetValueType)length > sums.m_Maximum[0] )
+    {
+    sums.m_Maximum[0] = idx[0] + length - 1;
+    }
+
+  // Object is on a border ?
+  bool isOnBorder = false;
+  for ( unsigned int i = 1; i < ImageDimension; i++ )
+    {
+    if ( idx[i] == m_BorderMin[i] || idx[i] == m_BorderMax[i] )
+      {
+      isOnBorder = true;
+      break;
+      }
+    }
+  if ( isOnBorder )
+    {
+    // The line touch a border on a dimension other than 0, so
+    // all the line touch a border
+    sums.m_NumberOfPixelsOnBorder += length;
+    }
+  else
+    {
+    // We must check for the dimension 0
+    bool isOnBorder0 = false;
+    if ( idx[0] == m_BorderMin[0] )
+      {
+      // One more pixel on the border
+      sums.m_NumberOfPixelsOnBorder++;
+      isOnBorder0 = true;
+      }
+    if ( !isOnBorder0 || length > 1 )
+      {
+      // We can check for the end of the line
+      if ( idx[0] + (OffsetValueType)length - 1 == m_BorderMax[0] )
+        {
+        // One more pixel on the border
+        sums.m_NumberOfPixelsOnBorder++;
+        }
+      }
+    }
+
+  // Physical size on border
+  // First, the dimension 0
+  if ( idx[0] == m_BorderMin[0] )
+    {
+    // Fhe beginning of the line
+    sums.m_PerimeterOnBorder += m_SizePerPixelPerDimension[0];
+    }
+  if ( idx[0] + (OffsetValueType)length - 1 == m_BorderMax[0] )
+    {
+    // And the end of the line
+    sums.m_PerimeterOnBorder += m_SizePerPixelPerDimension[0];
+    }
+  // Then the other dimensions
+  for ( unsigned int i = 1; i < ImageDimension; i++ )
+    {
+    if ( idx[i] == m_BorderMin[i] )
+      {
+      // one border
+      sums.m_PerimeterOnBorder += m_SizePerPixelPerDimension[i] * length;
+      }
+    if ( idx[i] == m_BorderMax[i] )
+      {
+      // and the other
+      sums.m_PerimeterOnBorder += m_SizePerPixelPerDimension[i] * length;
+      }
+    }
+
+  // moments computation
+// ****************************************************************
+// that commented code is the basic implementation. The next piece of code
+// give the same result in a much efficient way, by using expended formulae
+// allowed by the binary case instead of loops.
+// ****************************************************************
+//     IndexValueType endIdx0 = idx[0] + length;
+//     for( IndexType iidx = idx; iidx[0]<endIdx0; iidx[0]++)
+//       {
+//       typename LabelObjectType::CentroidType pP;
+//       m_Image->TransformIndexToPhysicalPoint(iidx, pP);
+//
+//       for(unsigned int i=0; i<ImageDimension; i++)
+//         {
+//         for(unsigned int j=0; j<ImageDimension; j++)
+//           {
+//           centralMoments[i][j] += pP[i] * pP[j];
+//           }
+//         }
+//       }
+  // get the physical position and the spacing - they are used several times
+  // later
+  MatrixType & centralMoments = sums.m_SecondOrderMoments;
+  typename LabelObjectType::CentroidType physicalPosition;
+  m_Image->TransformIndexToPhysicalPoint(idx, physicalPosition);
+  const SpacingType & spacing = m_Image->GetSpacing();
+  // the sum of x positions, also reused several times
+  double sumX = length * ( physicalPosition[0] + ( spacing[0] * ( length - 1 ) ) / 2.0 );
+  // the real job - the sum of square of x positions
+  // that's the central moments for dims 0, 0
+  centralMoments[0][0] += length * ( physicalPosition[0] * physicalPosition[0]
+                                     + spacing[0]
+                                     * ( length
+                                         - 1 ) * ( ( spacing[0] * ( 2 * length - 1 ) ) / 6.0 + physicalPosition[0] ) );
+  // the other ones
+  for ( unsigned int i = 1; i < ImageDimension; i++ )
+    {
+    // do this one here to avoid the double assigment in the following loop
+    // when i == j
+    centralMoments[i][i] += length * physicalPosition[i] * physicalPosition[i];
+    // central moments are symetrics, so avoid to compute them 2 times
+    for ( unsigned int j = i + 1; j < ImageDimension; j++ )
+      {
+      // note that we won't use that code if the image dimension is less than
+      // 3
+      // --> the tests should be in 3D at least
+      double cm = length * physicalPosition[i] * physicalPosition[j];
+      centralMoments[i][j] += cm;
+      centralMoments[j][i] += cm;
+      }
+    // the last moments: the ones for the dimension 0
+    double cm = sumX * physicalPosition[i];
+    centralMoments[i][0] += cm;
+    centralMoments[0][i] += cm;
+    }
+}
+
+template< typename TImage >
+void
+ShapeLabelMapAccumulator< TImage >
+::AddIntercepts(SumsType & sums, const LabelObjectType *labelObject) const
+{
+  // sort the lines, so the lines of a row of the object are contiguous, in
+  // the order of the rows, and ordered along the row
+  typedef typename LabelObjectType::LineType LineType;
+  typedef std::vector< LineType >            VectorLineType;
+  VectorLineType lines;
+  lines.reserve( labelObject->GetNumberOfLines() );
+  typename LabelObjectType::ConstLineIterator lit( labelObject );
+  while( ! lit.IsAtEnd() )
+    {
+    lines.push_back( lit.GetLine() );
+    ++lit;
+    }
+  std::sort( lines.begin(), lines.end(), Functor::LabelObjectLineComparator< LineType >() );
+
+  // the index of the first line of each row, and the position of its first
+  // line in the lines vector
+  std::vector< IndexType >     rowIndexes;
+  std::vector< SizeValueType > rowBegins;
+  for( SizeValueType l = 0; l < lines.size(); l++ )
+    {
+    if( rowIndexes.empty() || Self::RowIsBefore( rowIndexes.back(), lines[l].GetIndex() ) )
+      {
+      rowIndexes.push_back( lines[l].GetIndex() );
+      rowBegins.push_back( l );
+      }
+    }
+  rowBegins.push_back( lines.size() );
+
+  // the offsets to the neighbor rows - all the rows around a row, in the
+  // dimensions other than 0
+  std::vector< OffsetType > neighborOffsets;
+  OffsetType                offset;
+  offset.Fill( -1 );
+  offset[0] = 0;
+  while( offset[ImageDimension - 1] <= 1 )
+    {
+    bool isCenter = true;
+    for( unsigned int i = 1; i < ImageDimension; i++ )
+      {
+      isCenter = isCenter && offset[i] == 0;
+      }
+    if( !isCenter )
+      {
+      neighborOffsets.push_back( offset );
+      }
+    // go to the next offset
+    unsigned int i = 1;
+    ++offset[i];
+    while( i < ImageDimension - 1 && offset[i] > 1 )
+      {
+      offset[i] = -1;
+      ++offset[++i];
+      }
+    }
+
+  // the number of intercepts on each direction
+  SizeValueType *intercepts = sums.m_Intercepts;
+
+  // now iterate over the rows of lines
+  for( SizeValueType r = 0; r < rowIndexes.size(); r++ )
+    {
+    const typename VectorLineType::const_iterator lsBegin = lines.begin() + rowBegins[r];
+    const typename VectorLineType::const_iterator lsEnd = lines.begin() + rowBegins[r + 1];
+
+    // there are two intercepts on the 0 axis for each line
+    OffsetType no;
+    no.Fill(0);
+    no[0] = 1;
+    intercepts[Self::GetInterceptDirection(no)] += 2 * ( rowBegins[r + 1] - rowBegins[r] );
+
+    // and look at the neighbors
+    for( typename std::vector< OffsetType >::const_iterator oit = neighborOffsets.begin();
+         oit != neighborOffsets.end(); ++oit )
+      {
+      // prepare the offset to be stored in the intercepts
+      no[0] = 0;
+      for( unsigned int i = 1; i < ImageDimension; i++ )
+        {
+        no[i] = vnl_math_abs( ( *oit )[i] );
+        }
+      OffsetType dno = no; // offset for the diagonal
+      dno[0] = 1;
+      SizeValueType & noIntercepts = intercepts[Self::GetInterceptDirection(no)];
+      SizeValueType & dnoIntercepts = intercepts[Self::GetInterceptDirection(dno)];
+
+      // search the lines of the neighbor row
+      const IndexType neighborIndex = rowIndexes[r] + *oit;
+      const typename std::vector< IndexType >::const_iterator nit =
+        std::lower_bound( rowIndexes.begin(), rowIndexes.end(), neighborIndex, &Self::RowIsBefore );
+
+      // now process the two lines to search the pixels on the contour of the object
+      if( nit == rowIndexes.end() || Self::RowIsBefore( neighborIndex, *nit ) )
+        {
+        // no line in the neighbors - all the lines in ls are on the contour
+        for( typename VectorLineType::const_iterator li = lsBegin; li != lsEnd; ++li )
+          {
+          const LineType & l = *li;
+          // add as much intercepts as the line size
+          noIntercepts += l.GetLength();
+          // and 2 times as much diagonal intercepts as the line size
+          dnoIntercepts += l.GetLength() * 2;
+          }
+        }
+      else
+        {
+        const SizeValueType                           n = nit - rowIndexes.begin();
+        const typename VectorLineType::const_iterator nsEnd = lines.begin() + rowBegins[n + 1];
+        typename VectorLineType::const_iterator       li = lsBegin;
+        typename VectorLineType::const_iterator       ni = lines.begin() + rowBegins[n];
+
+        // TODO - fix the code when the line starts at  NumericTraits<IndexValueType>::NonpositiveMin()
+        // or end at  NumericTraits<IndexValueType>::max()
+        IndexValueType lZero = 0;
+        IndexValueType lMin = 0;
+        IndexValueType lMax = 0;
+
+        IndexValueType nMin = NumericTraits<IndexValueType>::NonpositiveMin() + 1;
+        IndexValueType nMax = ni->GetIndex()[0] - 1;
+
+        while( li!=lsEnd )
+          {
+          // update the current line min and max. Neighbor line data is already up to date.
+          lMin = li->GetIndex()[0];
+          lMax = lMin + li->GetLength() - 1;
+
+          // add as much intercepts as intersections of the 2 lines
+          noIntercepts += std::max( lZero, std::min(lMax, nMax) - std::max(lMin, nMin) + 1 );
+          // left diagonal intercepts
+          dnoIntercepts += std::max( lZero, std::min(lMax, nMax+1) - std::max(lMin, nMin+1) + 1 );
+          // right diagonal intercepts
+          dnoIntercepts += std::max( lZero, std::min(lMax, nMax-1) - std::max(lMin, nMin-1) + 1 );
+
+          // go to the next line or the next neighbor depending on where we are
+          if(nMax <= lMax )
+            {
+            // go to next neighbor
+            nMin = ni->GetIndex()[0] + ni->GetLength();
+            ni++;
+
+            if( ni != nsEnd )
+              {
+              nMax = ni->GetIndex()[0] - 1;
+              }
+            else
+              {
+              nMax = NumericTraits<IndexValueType>::max() - 1;
+              }
+            }
+          else
+            {
+            // go to next line
+            li++;
+            }
+          }
+        }
+      }
+    }
+}
+
+template< typename TImage >
+void
+ShapeLabelMapAccumulator< TImage >
+::SetAttributes(LabelObjectType *labelObject, const SumsType & sums) const
+{
+  const SizeValueType nbOfPixels = sums.m_NumberOfPixels;
+
+  // final computation
+  ContinuousIndexType centroid;
+  MatrixType          centralMoments = sums.m_SecondOrderMoments;
+  typename LabelObjectType::RegionType::SizeType boundingBoxSize;
+  for ( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    centroid[i] = sums.m_IndexSum[i] / nbOfPixels;
+    boundingBoxSize[i] = sums.m_Maximum[i] - sums.m_Minimum[i] + 1;
+    for ( unsigned int j = 0; j < ImageDimension; j++ )
+      {
+      centralMoments[i][j] /= nbOfPixels;
+      }
+    }
+  typename LabelObjectType::RegionType boundingBox(sums.m_Minimum, boundingBoxSize);
+  typename LabelObjectType::CentroidType physicalCentroid;
+  m_Image->TransformContinuousIndexToPhysicalPoint(centroid, physicalCentroid);
+
+  // Center the second order moments
+  for ( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    for ( unsigned int j = 0; j < ImageDimension; j++ )
+      {
+      centralMoments[i][j] -= physicalCentroid[i] * physicalCentroid[j];
+      }
+    }
+
+  // Compute principal moments and axes
+  VectorType                          principalMoments;
+  vnl_symmetric_eigensystem< double > eigen( centralMoments.GetVnlMatrix() );
+  vnl_diag_matrix< double >           pm = eigen.D;
+  for ( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    principalMoments[i] = pm(i);
+    }
+  MatrixType principalAxes = eigen.V.transpose();
+
+  // Add a final reflection if needed for a proper rotation,
+  // by multiplying the last row by the determinant
+  vnl_real_eigensystem                     eigenrot( principalAxes.GetVnlMatrix() );
+  vnl_diag_matrix< std::complex< double > > eigenval = eigenrot.D;
+  std::complex< double >                    det(1.0, 0.0);
+
+  for ( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    det *= eigenval(i);
+    }
+
+  for ( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    principalAxes[ImageDimension - 1][i] *= std::real(det);
+    }
+
+  double elongation = 0;
+  double flatness = 0;
+  if ( ImageDimension < 2 )
+    {
+    elongation = 1;
+    flatness = 1;
+    }
+  else if ( Math::NotAlmostEquals( principalMoments[0], itk::NumericTraits< typename VectorType::ValueType >::ZeroValue() ) )
+    {
+    elongation = std::sqrt(principalMoments[ImageDimension - 1] / principalMoments[ImageDimension - 2]);
+    flatness = std::sqrt(principalMoments[1] / principalMoments[0]);
+    }
+
+  double physicalSize = nbOfPixels * m_SizePerPixel;
+  double equivalentRadius = GeometryUtilities::HyperSphereRadiusFromVolume(ImageDimension, physicalSize);
+  double equivalentPerimeter = GeometryUtilities::HyperSpherePerimeter(ImageDimension, equivalentRadius);
+
+  // Compute equivalent ellipsoid radius
+  VectorType ellipsoidDiameter;
+  double     edet = 1.0;
+  for ( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    edet *= principalMoments[i];
+    }
+  edet = std::pow(edet, 1.0 / ImageDimension);
+  for ( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    if ( edet != 0.0 )
+      {
+      ellipsoidDiameter[i] = 2.0 *equivalentRadius *std::sqrt(principalMoments[i] / edet);
+      }
+    else
+      {
+      ellipsoidDiameter[i] = 0.0;
+      }
+    }
+
+  // Set the values in the object
+  labelObject->SetNumberOfPixels(nbOfPixels);
+  labelObject->SetPhysicalSize(physicalSize);
+  labelObject->SetBoundingBox(boundingBox);
+  labelObject->SetCentroid(physicalCentroid);
+  labelObject->SetNumberOfPixelsOnBorder(sums.m_NumberOfPixelsOnBorder);
+  labelObject->SetPerimeterOnBorder(sums.m_PerimeterOnBorder);
+  labelObject->SetPrincipalMoments(principalMoments);
+  labelObject->SetPrincipalAxes(principalAxes);
+  labelObject->SetElongation(elongation);
+  labelObject->SetEquivalentSphericalRadius(equivalentRadius);
+  labelObject->SetEquivalentSphericalPerimeter(equivalentPerimeter);
+  labelObject->SetEquivalentEllipsoidDiameter(ellipsoidDiameter);
+  labelObject->SetFlatness(flatness);
+}
+
+template< typename TImage >
+void
+ShapeLabelMapAccumulator< TImage >
+::SetPerimeter(LabelObjectType *labelObject, const SumsType & sums) const
+{
+  // compute the perimeter based on the intercept counts
+  double perimeter = PerimeterFromInterceptCount( sums.m_Intercepts, m_Image->GetSpacing() );
+  labelObject->SetPerimeter( perimeter );
+  labelObject->SetRoundness( labelObject->GetEquivalentSphericalPerimeter() / perimeter );
+  labelObject->SetPerimeterOnBorderRatio( labelObject->GetPerimeterOnBorder() / perimeter );
+}
+
+template< typename TImage >
+void
+ShapeLabelMapAccumulator< TImage >
+::SetFeretDiameter(LabelObjectType *labelObject) const
+{
+  // The maximum distance between two pixels of the object is reached
+  // between two vertices of its convex hull. These vertices are at an end of
+  // the lines of the object, so only the ends of the lines are compared.
+  typedef typename std::vector< IndexType > IndexListType;
+  IndexListType idxList;
+  idxList.reserve( 2 * labelObject->GetNumberOfLines() );
+
+  typename LabelObjectType::ConstLineIterator lit( labelObject );
+  while( ! lit.IsAtEnd() )
+    {
+    IndexType idx = lit.GetLine().GetIndex();
+    idxList.push_back( idx );
+    if ( lit.GetLine().GetLength() > 1 )
+      {
+      idx[0] += lit.GetLine().GetLength() - 1;
+      idxList.push_back( idx );
+      }
+    ++lit;
+    }
+
+  const SpacingType & spacing = m_Image->GetSpacing();
+
+  // We can now search the feret diameter
+  double feretDiameter = 0;
+  for ( typename IndexListType::const_iterator iIt1 = idxList.begin();
+        iIt1 != idxList.end();
+        iIt1++ )
+    {
+    typename IndexListType::const_iterator iIt2 = iIt1;
+    for ( iIt2++; iIt2 != idxList.end(); iIt2++ )
+      {
+      // Compute the length between the 2 indexes
+      double length = 0;
+      for ( unsigned int i = 0; i < ImageDimension; i++ )
+        {
+        const OffsetValueType indexDifference = ( iIt1->operator[](i) - iIt2->operator[](i) );
+        length += std::pow(indexDifference * spacing[i], 2);
+        }
+      if ( feretDiameter < length )
+        {
+        feretDiameter = length;
+        }
+      }
+    }
+  // Final computation
+  feretDiameter = std::sqrt(feretDiameter);
+
+  // Finally put the values in the label object
+  labelObject->SetFeretDiameter(feretDiameter);
+}
+
+template< typename TImage >
+unsigned int
+ShapeLabelMapAccumulator< TImage >
+::GetInterceptDirection(const OffsetType & direction)
+{
+  unsigned int d = 0;
+  for ( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    if ( direction[i] != 0 )
+      {
+      d |= 1 << i;
+      }
+    }
+  return d;
+}
+
+template< typename TImage >
+bool
+ShapeLabelMapAccumulator< TImage >
+::RowIsBefore(const IndexType & idx1, const IndexType & idx2)
+{
+  for ( unsigned int i = ImageDimension - 1; i > 0; i-- )
+    {
+    if ( idx1[i] != idx2[i] )
+      {
+      return idx1[i] < idx2[i];
+      }
+    }
+  return false;
+}
+
+template< typename TImage >
+template< typename TSpacing >
+double
+ShapeLabelMapAccumulator< TImage >
+::PerimeterFromInterceptCount( const SizeValueType *intercepts, const TSpacing & spacing )
+{
+  double perimeter = 0.0;
+  double pixelSize = 1.0;
+  int dim = TSpacing::GetVectorDimension();
+  for ( int i = 0; i < dim; i++ )
+    {
+    pixelSize *= spacing[i];
+    }
+
+  for( int i=0; i<dim; i++ )
+    {
+    perimeter += pixelSize / spacing[i] * intercepts[1 << i]/2.0;
+    }
+
+  // Crofton's constant
+  perimeter *= GeometryUtilities::HyperSphereVolume( dim, 1.0 )
+                 / GeometryUtilities::HyperSphereVolume( dim - 1, 1.0 );
+  return perimeter;
+}
+
+#if ! defined(ITK_DO_NOT_USE_PERIMETER_SPECIALIZATION)
+template< typename TImage >
+double
+ShapeLabelMapAccumulator< TImage >
+::PerimeterFromInterceptCount( const SizeValueType *intercepts, const Spacing2Type spacing )
+{
+  double dx = spacing[0];
+  double dy = spacing[1];
+
+  // the directions x, y and xy
+  const unsigned int nx = 1;
+  const unsigned int ny = 2;
+  const unsigned int nxy = 3;
+
+  double perimeter = 0.0;
+  perimeter += dy * intercepts[nx]/2.0;
+  perimeter += dx * intercepts[ny]/2.0;
+  perimeter += dx*dy / spacing.GetNorm() * intercepts[nxy]/2.0;
+  perimeter *= itk::Math::pi / 4.0;
+  return perimeter;
+}
+
+template< typename TImage >
+double
+ShapeLabelMapAccumulator< TImage >
+::PerimeterFromInterceptCount( const SizeValueType *intercepts, const Spacing3Type spacing )
+{
+  double dx = spacing[0];
+  double dy = spacing[1];
+  double dz = spacing[2];
+  double dxy = std::sqrt( spacing[0]*spacing[0] + spacing[1]*spacing[1] );
+  double dxz = std::sqrt( spacing[0]*spacing[0] + spacing[2]*spacing[2] );
+  double dyz = std::sqrt( spacing[1]*spacing[1] + spacing[2]*spacing[2] );
+  double dxyz = std::sqrt( spacing[0]*spacing[0] + spacing[1]*spacing[1] + spacing[2]*spacing[2] );
+  double vol = spacing[0]*spacing[1]*spacing[2];
+
+  // 'magical numbers', corresponding to area of voronoi partition on the
+  // unit sphere, when germs are the 26 directions on the unit cube
+  // Sum of (c1+c2+c3 + c4*2+c5*2+c6*2 + c7*4) equals 1.
+  double c1 = 0.04577789120476 * 2;  // Ox
+  double c2 = 0.04577789120476 * 2;  // Oy
+  double c3 = 0.04577789120476 * 2;  // Oz
+  double c4 = 0.03698062787608 * 2;  // Oxy
+  double c5 = 0.03698062787608 * 2;  // Oxz
+  double c6 = 0.03698062787608 * 2;  // Oyz
+  double c7 = 0.03519563978232 * 2;  // Oxyz
+  // TODO - recompute those values if the spacing is non isotrope
+
+  // the directions x, y, z, xy, xz, yz and xyz
+  const unsigned int nx = 1;
+  const unsigned int ny = 2;
+  const unsigned int nz = 4;
+  const unsigned int nxy = 3;
+  const unsigned int nxz = 5;
+  const unsigned int nyz = 6;
+  const unsigned int nxyz = 7;
+
+  double perimeter = 0.0;
+  perimeter += vol/dx * intercepts[nx]/2.0 * c1;
+  perimeter += vol/dy * intercepts[ny]/2.0 * c2;
+  perimeter += vol/dz * intercepts[nz]/2.0 * c3;
+  perimeter += vol/dxy * intercepts[nxy]/2.0 * c4;
+  perimeter += vol/dxz * intercepts[nxz]/2.0 * c5;
+  perimeter += vol/dyz * intercepts[nyz]/2.0 * c6;
+  perimeter += vol/dxyz * intercepts[nxyz]/2.0 * c7;
+  perimeter *= 4;
+  return perimeter;
+}
+#endif
+} // end namespace itk
+#endif
@@ -19,6 +19,7 @@
 #define itkShapeLabelMapFilter_h
 
 #include "itkInPlaceLabelMapFilter.h"
+#include "itkShapeLabelMapAccumulator.h"
 
 namespace itk
 {
@@ -28,15 +29,14 @@ namespace itk
  * ShapeLabelMapFilter can be used to set the attributes values of the
  * ShapeLabelObject in a LabelMap.
  *
- * ShapeLabelMapFilter takes an optional parameter, used only to
- * optimize the computation time and the memory usage when the
- * perimeter or the feret diameter is used: the exact copy of the
- * input LabelMap is stored in an Image.
- * It can be set with SetLabelImage(). It is cleared at the end of the
- * computation, so must be reset before running Update() again. It is
- * not part of the pipeline management design, to let the subclasses
- * of ShapeLabelMapFilter use the pipeline design to specify truly
- * required inputs.
+ * The perimeter and the Feret diameter are computed from the lines of
+ * each object only, so they don't need an image of the labels. The
+ * Feret diameter is only searched between the ends of the lines, which
+ * contain the vertices of the convex hull of the object.
+ *
+ * The attributes are computed with a ShapeLabelMapAccumulator, which
+ * LabelImageToShapeLabelMapFilter also uses to compute them while it scans
+ * the label image.
  *
  * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
  *
@@ -115,11 +115,9 @@ public:
   itkGetConstReferenceMacro(ComputePerimeter, bool);
   itkBooleanMacro(ComputePerimeter);
 
-  /** Set the label image */
-  void SetLabelImage(const TLabelImage *input)
-  {
-    m_LabelImage = input;
-  }
+  /** Set the label image. It is not used anymore: the attributes are
+   * computed from the lines of the objects. */
+  itkLegacyMacro(void SetLabelImage(const TLabelImage *));
 
 protected:
   ShapeLabelMapFilter();
@@ -129,35 +127,16 @@ protected:
 
   virtual void BeforeThreadedGenerateData() ITK_OVERRIDE;
 
-  virtual void AfterThreadedGenerateData() ITK_OVERRIDE;
-
   void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
 
 private:
   ShapeLabelMapFilter(const Self &) ITK_DELETE_FUNCTION;
   void operator=(const Self &) ITK_DELETE_FUNCTION;
 
-  bool                   m_ComputeFeretDiameter;
-  bool                   m_ComputePerimeter;
-  LabelImageConstPointer m_LabelImage;
-
-  void ComputeFeretDiameter(LabelObjectType *labelObject);
-  void ComputePerimeter(LabelObjectType *labelObject);
-
-  typedef itk::Offset<2>                                                          Offset2Type;
-  typedef itk::Offset<3>                                                          Offset3Type;
-  typedef itk::Vector<double, 2>                                                  Spacing2Type;
-  typedef itk::Vector<double, 3>                                                  Spacing3Type;
-  typedef std::map<Offset2Type, SizeValueType, Offset2Type::LexicographicCompare> MapIntercept2Type;
-  typedef std::map<Offset3Type, SizeValueType, Offset3Type::LexicographicCompare> MapIntercept3Type;
-
-  // it seems impossible to specialize a method without specializing the whole class, but we
-  // can use simple overloading
-  template<typename TMapIntercept, typename TSpacing> double PerimeterFromInterceptCount( TMapIntercept & intercepts, const TSpacing & spacing );
-#if ! defined(ITK_DO_NOT_USE_PERIMETER_SPECIALIZATION)
-  double PerimeterFromInterceptCount( MapIntercept2Type & intercepts, const Spacing2Type spacing );
-  double PerimeterFromInterceptCount( MapIntercept3Type & intercepts, const Spacing3Type spacing );
-#endif
+  typedef ShapeLabelMapAccumulator< ImageType > AccumulatorType;
+
+  bool m_ComputeFeretDiameter;
+  bool m_ComputePerimeter;
 };
 
 
@@ -0,0 +1,236 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBinaryFillholeLabelMapFilter.h"
+#include "itkBinaryFillholeImageFilter.h"
+#include "itkLabelImageToLabelMapFilter.h"
+#include "itkLabelMapToBinaryImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+#include <cmath>
+
+/* Fills the holes of a 3D binary image with many holes, some of them on the
+ * border of the image, and checks the result against
+ * BinaryFillholeImageFilter. */
+int itkBinaryFillholeLabelMapFilterTest( int, char * [] )
+{
+  const unsigned int Dimension = 3;
+
+  typedef itk::Image< unsigned char, Dimension >                      ImageType;
+  typedef itk::LabelMap< itk::LabelObject< unsigned char, Dimension > > LabelMapType;
+
+  typedef itk::LabelImageToLabelMapFilter< ImageType, LabelMapType > LabelizerType;
+  typedef itk::BinaryFillholeLabelMapFilter< LabelMapType >          FilterType;
+  typedef itk::LabelMapToBinaryImageFilter< LabelMapType, ImageType > BinarizerType;
+  typedef itk::BinaryFillholeImageFilter< ImageType >                ReferenceType;
+
+  ImageType::IndexType start;
+  start[0] = 7;
+  start[1] = -4;
+  start[2] = 2;
+  ImageType::SizeType size;
+  size[0] = 41;
+  size[1] = 33;
+  size[2] = 17;
+  ImageType::RegionType region( start, size );
+
+  // Shells with holes of several sizes, and a lattice of one pixel holes
+  // punched in them, starting on the border of the image
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( region );
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, region );
+  for(; !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType index = it.GetIndex();
+    const double               wave = std::sin( 0.5 * index[0] ) + std::cos( 0.45 * index[1] ) + std::sin( 0.6 * index[2] );
+    const bool                 dot = ( index[0] - start[0] ) % 4 == 0 && ( index[1] - start[1] ) % 3 == 0
+                                     && ( index[2] - start[2] ) % 2 == 0;
+    it.Set( ( wave > -0.5 && !dot ) ? 1 : 0 );
+    }
+
+  for( unsigned int fullyConnected = 0; fullyConnected < 2; fullyConnected++ )
+    {
+    LabelizerType::Pointer labelizer = LabelizerType::New();
+    labelizer->SetInput( image );
+    labelizer->SetBackgroundValue( 0 );
+
+    FilterType::Pointer filter = FilterType::New();
+    EXERCISE_BASIC_OBJECT_METHODS( filter, BinaryFillholeLabelMapFilter );
+    filter->SetInput( labelizer->GetOutput() );
+    filter->SetFullyConnected( fullyConnected != 0 );
+    filter->SetNumberOfThreads( 2 );
+
+    BinarizerType::Pointer binarizer = BinarizerType::New();
+    binarizer->SetInput( filter->GetOutput() );
+    binarizer->SetForegroundValue( 1 );
+    binarizer->SetBackgroundValue( 0 );
+    TRY_EXPECT_NO_EXCEPTION( binarizer->Update() );
+
+    ReferenceType::Pointer reference = ReferenceType::New();
+    reference->SetInput( image );
+    reference->SetForegroundValue( 1 );
+    reference->SetFullyConnected( fullyConnected != 0 );
+    TRY_EXPECT_NO_EXCEPTION( reference->Update() );
+
+    unsigned int numberOfFilledPixels = 0;
+    itk::ImageRegionConstIteratorWithIndex< ImageType > oit( binarizer->GetOutput(), region );
+    itk::ImageRegionConstIterator< ImageType >          rit( reference->GetOutput(), region );
+    for(; !oit.IsAtEnd(); ++oit, ++rit )
+      {
+      if( oit.Get() != rit.Get() )
+        {
+        std::cerr << "Mismatch at " << oit.GetIndex() << " with fully connected " << fullyConnected
+                  << ": expected " << static_cast< int >( rit.Get() ) << ", got " << static_cast< int >( oit.Get() )
+                  << std::endl;
+        return EXIT_FAILURE;
+        }
+      if( oit.Get() != image->GetPixel( oit.GetIndex() ) )
+        {
+        numberOfFilledPixels++;
+        }
+      }
+    std::cout << "Fully connected " << fullyConnected << ": " << numberOfFilledPixels << " pixels filled"
+              << std::endl;
+    }
+
+  // Several objects: a cell with a nucleus inside it and another object
+  // touching it, and two nested shells. The holes are filled only with the
+  // pixels in no object, and the center of the nested shells goes to the
+  // lowest label.
+  ImageType::Pointer labels = ImageType::New();
+  labels->SetRegions( region );
+  labels->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > lit( labels, region );
+  for(; !lit.IsAtEnd(); ++lit )
+    {
+    const ImageType::IndexType index = lit.GetIndex();
+    itk::OffsetValueType       cell = 0;
+    itk::OffsetValueType       shells = 0;
+    for( unsigned int i = 0; i < Dimension; i++ )
+      {
+      cell = std::max( cell, std::abs( index[i] - start[i] - 8 ) );
+      shells = std::max( shells, std::abs( index[i] - start[i] - ( i == 0 ? 30 : 8 ) ) );
+      }
+    unsigned char label = 0;
+    if( cell >= 5 && cell <= 6 )
+      {
+      label = 3;
+      }
+    else if( cell <= 2 )
+      {
+      label = 7;
+      }
+    else if( index[0] - start[0] == 15 && std::abs( index[1] - start[1] - 8 ) <= 2 )
+      {
+      label = 1;
+      }
+    else if( shells == 6 )
+      {
+      label = 6;
+      }
+    else if( shells == 3 )
+      {
+      label = 4;
+      }
+    lit.Set( label );
+    }
+
+  for( unsigned int fullyConnected = 0; fullyConnected < 2; fullyConnected++ )
+    {
+    LabelizerType::Pointer labelizer = LabelizerType::New();
+    labelizer->SetInput( labels );
+    labelizer->SetBackgroundValue( 0 );
+
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput( labelizer->GetOutput() );
+    filter->SetFullyConnected( fullyConnected != 0 );
+    filter->SetNumberOfThreads( 2 );
+    TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+    // the label of each pixel in the output, or 255 if several objects
+    // contain it
+    ImageType::Pointer output = ImageType::New();
+    output->SetRegions( region );
+    output->Allocate();
+    output->FillBuffer( 0 );
+    for( LabelMapType::ConstIterator oit( filter->GetOutput() ); !oit.IsAtEnd(); ++oit )
+      {
+      const LabelMapType::LabelObjectType *labelObject = oit.GetLabelObject();
+      for( itk::SizeValueType l = 0; l < labelObject->GetNumberOfLines(); l++ )
+        {
+        ImageType::IndexType index = labelObject->GetLine( l ).GetIndex();
+        for( itk::SizeValueType i = 0; i < labelObject->GetLine( l ).GetLength(); i++, index[0]++ )
+          {
+          output->SetPixel( index, output->GetPixel( index ) == 0 ? oit.GetLabel() : 255 );
+          }
+        }
+      }
+
+    // the pixels of each object in the input, then the holes of the objects
+    // filled alone, by increasing label
+    ImageType::Pointer expected = ImageType::New();
+    expected->SetRegions( region );
+    expected->Allocate();
+    itk::ImageRegionIterator< ImageType > eit( expected, region );
+    for( lit.GoToBegin(); !lit.IsAtEnd(); ++lit, ++eit )
+      {
+      eit.Set( lit.Get() );
+      }
+    for( LabelMapType::ConstIterator oit( labelizer->GetOutput() ); !oit.IsAtEnd(); ++oit )
+      {
+      ImageType::Pointer object = ImageType::New();
+      object->SetRegions( region );
+      object->Allocate();
+      itk::ImageRegionIterator< ImageType > bit( object, region );
+      for( lit.GoToBegin(); !lit.IsAtEnd(); ++lit, ++bit )
+        {
+        bit.Set( lit.Get() == oit.GetLabel() ? 1 : 0 );
+        }
+
+      ReferenceType::Pointer reference = ReferenceType::New();
+      reference->SetInput( object );
+      reference->SetForegroundValue( 1 );
+      reference->SetFullyConnected( fullyConnected != 0 );
+      TRY_EXPECT_NO_EXCEPTION( reference->Update() );
+      itk::ImageRegionConstIterator< ImageType > rit( reference->GetOutput(), region );
+      for( eit.GoToBegin(); !eit.IsAtEnd(); ++eit, ++rit )
+        {
+        if( eit.Get() == 0 && rit.Get() == 1 )
+          {
+          eit.Set( oit.GetLabel() );
+          }
+        }
+      }
+
+    itk::ImageRegionConstIteratorWithIndex< ImageType > oit( output, region );
+    for( eit.GoToBegin(); !oit.IsAtEnd(); ++oit, ++eit )
+      {
+      if( oit.Get() != eit.Get() )
+        {
+        std::cerr << "Mismatch in the labels at " << oit.GetIndex() << " with fully connected " << fullyConnected
+                  << ": expected " << static_cast< int >( eit.Get() ) << ", got " << static_cast< int >( oit.Get() )
+                  << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,111 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkLabelImageToLabelMapFilter.h"
+#include "itkStatisticsLabelObject.h"
+#include "itkStatisticsLabelMapFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+#include <cmath>
+
+/* Computes the shape and statistics attributes of a label map with a lot
+ * of small objects of several sizes with 1 and 4 threads, and checks that
+ * the attributes are the same. */
+int itkLabelMapFilterThreadingTest( int, char * [] )
+{
+  const unsigned int Dimension = 3;
+
+  typedef itk::Image< unsigned int, Dimension >                           LabelImageType;
+  typedef itk::Image< unsigned char, Dimension >                          ImageType;
+  typedef itk::StatisticsLabelObject< unsigned int, Dimension >           LabelObjectType;
+  typedef itk::LabelMap< LabelObjectType >                                LabelMapType;
+  typedef itk::LabelImageToLabelMapFilter< LabelImageType, LabelMapType > ToLabelMapType;
+  typedef itk::StatisticsLabelMapFilter< LabelMapType, ImageType >        StatisticsType;
+
+  // staggered bricks 4 rows high and 3 slices thick, 2 to 7 pixels wide,
+  // with holes of background along diagonal planes, on a smooth feature image
+  LabelImageType::SizeType size;
+  size[0] = 64;
+  size[1] = 64;
+  size[2] = 32;
+  LabelImageType::Pointer labels = LabelImageType::New();
+  labels->SetRegions( size );
+  labels->Allocate();
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex< LabelImageType > lit( labels, labels->GetLargestPossibleRegion() );
+  itk::ImageRegionIterator< ImageType >               it( image, image->GetLargestPossibleRegion() );
+  for(; !lit.IsAtEnd(); ++lit, ++it )
+    {
+    const LabelImageType::IndexType index = lit.GetIndex();
+    const unsigned int              row = index[1] / 4 + 16 * ( index[2] / 3 );
+    const unsigned int              width = 2 + ( index[1] / 4 + index[2] / 3 ) % 6;
+    const unsigned int              brick = ( index[0] + 3 * ( row % 2 ) ) / width;
+    const bool                      hole = ( index[0] + index[1] + index[2] ) % 29 == 0;
+    lit.Set( hole ? 0 : 1 + brick + 40 * row );
+    it.Set( static_cast< unsigned char >( 120 + 100 * std::sin( 0.2 * index[0] ) * std::cos( 0.15 * index[1] )
+                                          + index[2] ) );
+    }
+
+  LabelMapType::Pointer maps[2];
+  const itk::ThreadIdType numberOfThreads[2] = { 1, 4 };
+  for( unsigned int i = 0; i < 2; i++ )
+    {
+    ToLabelMapType::Pointer toLabelMap = ToLabelMapType::New();
+    toLabelMap->SetInput( labels );
+    TRY_EXPECT_NO_EXCEPTION( toLabelMap->Update() );
+
+    StatisticsType::Pointer statistics = StatisticsType::New();
+    statistics->SetInput( toLabelMap->GetOutput() );
+    statistics->SetFeatureImage( image );
+    statistics->SetComputePerimeter( true );
+    statistics->SetNumberOfThreads( numberOfThreads[i] );
+    TRY_EXPECT_NO_EXCEPTION( statistics->Update() );
+    maps[i] = statistics->GetOutput();
+    }
+
+  std::cout << maps[0]->GetNumberOfLabelObjects() << " objects" << std::endl;
+  if( maps[0]->GetNumberOfLabelObjects() != maps[1]->GetNumberOfLabelObjects() )
+    {
+    std::cerr << "The number of objects differs" << std::endl;
+    return EXIT_FAILURE;
+    }
+  LabelMapType::ConstIterator rit( maps[0] );
+  LabelMapType::ConstIterator mit( maps[1] );
+  for(; !rit.IsAtEnd(); ++rit, ++mit )
+    {
+    const LabelObjectType *reference = rit.GetLabelObject();
+    const LabelObjectType *object = mit.GetLabelObject();
+    if( reference->GetLabel() != object->GetLabel()
+        || reference->GetNumberOfPixels() != object->GetNumberOfPixels()
+        || reference->GetNumberOfLines() != object->GetNumberOfLines()
+        || reference->GetCentroid() != object->GetCentroid()
+        || reference->GetPerimeter() != object->GetPerimeter()
+        || reference->GetSum() != object->GetSum()
+        || reference->GetMaximumIndex() != object->GetMaximumIndex() )
+      {
+      std::cerr << "The attributes of the object " << reference->GetLabel() << " differ" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
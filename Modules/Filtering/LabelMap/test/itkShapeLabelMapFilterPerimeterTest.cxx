@@ -0,0 +1,233 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkLabelImageToShapeLabelMapFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+#include <cmath>
+
+namespace
+{
+
+/* Fills an image with a ball cut in shells and stripes of three labels,
+ * which gives objects with holes and several components, and a box in a
+ * corner of the image. The region of the image doesn't start at 0. */
+template< typename TImage >
+void
+FillImage( TImage *image )
+{
+  const unsigned int Dimension = TImage::ImageDimension;
+  itk::ImageRegionIteratorWithIndex< TImage > it( image, image->GetLargestPossibleRegion() );
+  for(; !it.IsAtEnd(); ++it )
+    {
+    const typename TImage::IndexType index = it.GetIndex();
+    double                           distance = 0;
+    bool                             inBox = true;
+    for( unsigned int i = 0; i < Dimension; i++ )
+      {
+      distance += ( index[i] - 9.0 ) * ( index[i] - 9.0 );
+      inBox = inBox && index[i] >= 18 - static_cast< int >( i );
+      }
+    distance = std::sqrt( distance );
+    if( distance < 10.5 )
+      {
+      const int stripe = ( index[0] + 2 * index[1] + 30 ) / 5;
+      it.Set( 1 + ( static_cast< int >( distance / 3.0 ) + stripe ) % 3 );
+      }
+    else if( inBox )
+      {
+      it.Set( 4 );
+      }
+    else
+      {
+      it.Set( 0 );
+      }
+    }
+}
+
+/* Computes the Feret diameter of an object by comparing all its pixels. */
+template< typename TLabelObject, typename TSpacing >
+double
+BruteForceFeretDiameter( const TLabelObject *labelObject, const TSpacing & spacing )
+{
+  const unsigned int Dimension = TLabelObject::ImageDimension;
+  typedef typename TLabelObject::IndexType IndexType;
+  std::vector< IndexType >                 indices;
+  for( typename TLabelObject::ConstIndexIterator it( labelObject ); !it.IsAtEnd(); ++it )
+    {
+    indices.push_back( it.GetIndex() );
+    }
+  double diameter = 0;
+  for( unsigned int i = 0; i < indices.size(); i++ )
+    {
+    for( unsigned int j = i + 1; j < indices.size(); j++ )
+      {
+      double length = 0;
+      for( unsigned int d = 0; d < Dimension; d++ )
+        {
+        const double difference = ( indices[i][d] - indices[j][d] ) * spacing[d];
+        length += difference * difference;
+        }
+      diameter = std::max( diameter, length );
+      }
+    }
+  return std::sqrt( diameter );
+}
+
+/* Checks that two values are equal, up to the rounding errors of sums made
+ * in different orders. */
+bool
+AlmostEqual( double value1, double value2 )
+{
+  return std::abs( value1 - value2 ) <= 1e-9 * std::max( 1.0, std::abs( value1 ) );
+}
+
+/* Compares the attributes computed in one scan of the label image with the
+ * ones computed by ShapeLabelMapFilter from the lines of the objects. */
+template< typename TLabelObject >
+bool
+CompareAttributes( const TLabelObject *labelObject, const TLabelObject *reference )
+{
+  const unsigned int Dimension = TLabelObject::ImageDimension;
+  bool               equal = labelObject->GetNumberOfPixels() == reference->GetNumberOfPixels()
+    && labelObject->GetBoundingBox() == reference->GetBoundingBox()
+    && labelObject->GetNumberOfPixelsOnBorder() == reference->GetNumberOfPixelsOnBorder()
+    && AlmostEqual( labelObject->GetPhysicalSize(), reference->GetPhysicalSize() )
+    && AlmostEqual( labelObject->GetPerimeterOnBorder(), reference->GetPerimeterOnBorder() )
+    && AlmostEqual( labelObject->GetPerimeter(), reference->GetPerimeter() )
+    && AlmostEqual( labelObject->GetRoundness(), reference->GetRoundness() )
+    && AlmostEqual( labelObject->GetElongation(), reference->GetElongation() )
+    && AlmostEqual( labelObject->GetFlatness(), reference->GetFlatness() )
+    && AlmostEqual( labelObject->GetFeretDiameter(), reference->GetFeretDiameter() );
+  for( unsigned int i = 0; i < Dimension; i++ )
+    {
+    equal = equal && AlmostEqual( labelObject->GetCentroid()[i], reference->GetCentroid()[i] )
+      && AlmostEqual( labelObject->GetPrincipalMoments()[i], reference->GetPrincipalMoments()[i] )
+      && AlmostEqual( labelObject->GetEquivalentEllipsoidDiameter()[i],
+                      reference->GetEquivalentEllipsoidDiameter()[i] );
+    }
+  return equal;
+}
+
+/* Checks the perimeter of the objects against the values computed with
+ * the line image based implementation, the Feret diameter against a brute
+ * force computation, and all the attributes against the ones computed from
+ * the lines of the objects by ShapeLabelMapFilter. */
+template< unsigned int VDimension >
+bool
+CheckAttributes( const double *expectedPerimeters )
+{
+  typedef itk::Image< unsigned char, VDimension >                       ImageType;
+  typedef itk::LabelImageToShapeLabelMapFilter< ImageType >             FilterType;
+  typedef typename FilterType::OutputImageType                          LabelMapType;
+  typedef typename LabelMapType::LabelObjectType                        LabelObjectType;
+
+  typename ImageType::IndexType start;
+  start.Fill( -3 );
+  typename ImageType::SizeType size;
+  size.Fill( 32 );
+  typename ImageType::SpacingType spacing;
+  for( unsigned int i = 0; i < VDimension; i++ )
+    {
+    spacing[i] = 0.5 + 0.25 * i;
+    }
+  typename ImageType::Pointer image = ImageType::New();
+  image->SetRegions( typename ImageType::RegionType( start, size ) );
+  image->SetSpacing( spacing );
+  image->Allocate();
+  FillImage( image.GetPointer() );
+
+  // the attributes computed from the lines of the objects
+  typedef typename FilterType::LabelizerType           LabelizerType;
+  typedef typename FilterType::LabelObjectValuatorType ValuatorType;
+  typename LabelizerType::Pointer labelizer = LabelizerType::New();
+  labelizer->SetInput( image );
+  labelizer->SetBackgroundValue( 0 );
+  typename ValuatorType::Pointer valuator = ValuatorType::New();
+  valuator->SetInput( labelizer->GetOutput() );
+  valuator->SetComputeFeretDiameter( true );
+  valuator->SetComputePerimeter( true );
+  TRY_EXPECT_NO_EXCEPTION( valuator->Update() );
+  const LabelMapType *reference = valuator->GetOutput();
+
+  bool success = true;
+  for( unsigned int numberOfThreads = 1; numberOfThreads <= 4; numberOfThreads += 3 )
+    {
+    typename FilterType::Pointer filter = FilterType::New();
+    filter->SetInput( image );
+    filter->SetBackgroundValue( 0 );
+    filter->SetComputeFeretDiameter( true );
+    filter->SetComputePerimeter( true );
+    filter->SetNumberOfThreads( numberOfThreads );
+    TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+    const LabelMapType *labelMap = filter->GetOutput();
+    if( labelMap->GetNumberOfLabelObjects() != 4 || reference->GetNumberOfLabelObjects() != 4 )
+      {
+      std::cerr << VDimension << "D: " << labelMap->GetNumberOfLabelObjects() << " objects instead of 4" << std::endl;
+      return false;
+      }
+    for( unsigned int i = 0; i < 4; i++ )
+      {
+      const LabelObjectType *labelObject = labelMap->GetNthLabelObject( i );
+      const double           feretDiameter = BruteForceFeretDiameter( labelObject, spacing );
+      std::cout << VDimension << "D, " << numberOfThreads << " threads, label "
+                << static_cast< int >( labelObject->GetLabel() ) << ": perimeter " << labelObject->GetPerimeter()
+                << ", Feret diameter " << labelObject->GetFeretDiameter() << ", "
+                << labelObject->GetNumberOfPixelsOnBorder() << " pixels on the border" << std::endl;
+      if( std::abs( labelObject->GetPerimeter() - expectedPerimeters[i] ) > 1e-9 * expectedPerimeters[i] )
+        {
+        std::cerr << "  expected perimeter: " << expectedPerimeters[i] << std::endl;
+        success = false;
+        }
+      if( std::abs( labelObject->GetFeretDiameter() - feretDiameter ) > 1e-12 * feretDiameter )
+        {
+        std::cerr << "  expected Feret diameter: " << feretDiameter << std::endl;
+        success = false;
+        }
+      if( !CompareAttributes( labelObject, reference->GetLabelObject( labelObject->GetLabel() ) ) )
+        {
+        std::cerr << "  the attributes differ from the ones of ShapeLabelMapFilter" << std::endl;
+        success = false;
+        }
+      }
+    }
+  return success;
+}
+
+}
+
+int itkShapeLabelMapFilterPerimeterTest( int, char * [] )
+{
+  const double expectedPerimeters2D[4] = { 86.267382490296711, 99.607058910405854, 90.64697990534404,
+                                           25.765070375862475 };
+  const double expectedPerimeters3D[4] = { 1141.3820361581181, 1208.5260352033142, 1221.0472263618478,
+                                           383.42872004495268 };
+
+  std::cout.precision( 17 );
+  bool success = true;
+  success &= CheckAttributes< 2 >( expectedPerimeters2D );
+  success &= CheckAttributes< 3 >( expectedPerimeters3D );
+  if( !success )
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -22,6 +22,7 @@
 #include "itkProgressReporter.h"
 #include "itkAnchorErodeDilateLine.h"
 #include "itkBresenhamLine.h"
+#include "itkBarrier.h"
 
 namespace itk
 {
@@ -82,10 +83,18 @@ protected:
   ~AnchorErodeDilateImageFilter() {}
   void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
 
-  /** Multi-thread version GenerateData. */
+  /** Check the kernel, and allocate the image where the lines are
+   * processed. */
+  void BeforeThreadedGenerateData() ITK_OVERRIDE;
+
+  /** Multi-thread version GenerateData. The lines of each direction of the
+   * structuring element are shared between the threads, and the threads
+   * wait for each other before processing the next direction. */
   void  ThreadedGenerateData(const InputImageRegionType & outputRegionForThread,
                              ThreadIdType threadId) ITK_OVERRIDE;
 
+  void AfterThreadedGenerateData() ITK_OVERRIDE;
+
   // should be set by the meta filter
   InputImagePixelType m_Boundary;
 
@@ -95,6 +104,15 @@ private:
 
   typedef BresenhamLine< itkGetStaticConstMacro(InputImageDimension) > BresType;
 
+  // the output requested region padded by the radius of the kernel, the
+  // image where the lines are processed in place, which is the output
+  // when its buffer is large enough, and the synchronization of the
+  // threads between the directions
+  InputImageRegionType      m_PaddedRegion;
+  InputImagePointer         m_InternalBuffer;
+  ThreadIdType              m_NumberOfThreadsUsed;
+  typename Barrier::Pointer m_Barrier;
+
   // the class that operates on lines
   typedef AnchorErodeDilateLine< InputImagePixelType, TFunction1 > AnchorLineType;
 }; // end of class
@@ -19,6 +19,7 @@
 #define itkAnchorErodeDilateImageFilter_hxx
 
 #include "itkAnchorErodeDilateImageFilter.h"
+#include "itkImageRegionSplitterSlowDimension.h"
 
 
 #include "itkAnchorUtilities.h"
@@ -27,22 +28,60 @@ namespace itk
 template< typename TImage, typename TKernel, typename TFunction1 >
 AnchorErodeDilateImageFilter< TImage, TKernel, TFunction1 >
 ::AnchorErodeDilateImageFilter():
-  m_Boundary( NumericTraits< InputImagePixelType >::ZeroValue() )
+  m_Boundary( NumericTraits< InputImagePixelType >::ZeroValue() ),
+  m_NumberOfThreadsUsed( 1 )
 {
 }
 
 template< typename TImage, typename TKernel, typename TFunction1 >
 void
 AnchorErodeDilateImageFilter< TImage, TKernel, TFunction1 >
-::ThreadedGenerateData(const InputImageRegionType & outputRegionForThread,
-                       ThreadIdType threadId)
+::BeforeThreadedGenerateData()
 {
   // check that we are using a decomposable kernel
   if ( !this->GetKernel().GetDecomposable() )
     {
     itkExceptionMacro("Anchor morphology only works with decomposable structuring elements");
-    return;
     }
+
+  // the lines are processed on the whole padded region, so the threads
+  // don't compute the same pixels again on the borders of their regions
+  m_PaddedRegion = this->GetOutput()->GetRequestedRegion();
+  m_PaddedRegion.PadByRadius( this->GetKernel().GetRadius() );
+  m_PaddedRegion.Crop( this->GetInput()->GetRequestedRegion() );
+
+  // the lines are processed in place in the output, unless it is too small
+  if ( this->GetOutput()->GetBufferedRegion() == m_PaddedRegion )
+    {
+    m_InternalBuffer = this->GetOutput();
+    }
+  else
+    {
+    m_InternalBuffer = InputImageType::New();
+    m_InternalBuffer->SetRegions(m_PaddedRegion);
+    m_InternalBuffer->Allocate();
+    }
+
+  // number of threads can be constrained by the region size, so call the
+  // SplitRequestedRegion to get the real number of threads which will be used
+  ThreadIdType numberOfThreads = this->GetNumberOfThreads();
+  if ( MultiThreader::GetGlobalMaximumNumberOfThreads() != 0 )
+    {
+    numberOfThreads = std::min( this->GetNumberOfThreads(), MultiThreader::GetGlobalMaximumNumberOfThreads() );
+    }
+  InputImageRegionType splitRegion;
+  m_NumberOfThreadsUsed = this->SplitRequestedRegion(0, numberOfThreads, splitRegion);
+
+  m_Barrier = Barrier::New();
+  m_Barrier->Initialize(m_NumberOfThreadsUsed);
+}
+
+template< typename TImage, typename TKernel, typename TFunction1 >
+void
+AnchorErodeDilateImageFilter< TImage, TKernel, TFunction1 >
+::ThreadedGenerateData(const InputImageRegionType & outputRegionForThread,
+                       ThreadIdType threadId)
+{
   // TFunction1 will be < for erosions
   // TFunction2 will be <=
 
@@ -57,19 +96,9 @@ AnchorErodeDilateImageFilter< TImage, TKernel, TFunction1 >
   ProgressReporter progress(this, threadId, this->GetKernel().GetLines().size() + 1);
 
   InputImageConstPointer input = this->GetInput();
+  InputImagePointer      output = m_InternalBuffer;
+  InputImageRegionType   IReg = m_PaddedRegion;
 
-  InputImageRegionType IReg = outputRegionForThread;
-  IReg.PadByRadius( this->GetKernel().GetRadius() );
-  IReg.Crop( this->GetInput()->GetRequestedRegion() );
-
-  // allocate an internal buffer
-  typename InputImageType::Pointer internalbuffer = InputImageType::New();
-  internalbuffer->SetRegions(IReg);
-  internalbuffer->Allocate();
-  InputImagePointer output = internalbuffer;
-
-  // get the region size
-  InputImageRegionType OReg = outputRegionForThread;
   // maximum buffer length is sum of dimensions
   unsigned int bufflength = 0;
   for ( unsigned i = 0; i < TImage::ImageDimension; i++ )
@@ -80,6 +109,7 @@ AnchorErodeDilateImageFilter< TImage, TKernel, TFunction1 >
   // compat
   bufflength += 2;
 
+  // the line buffers are private to the thread
   std::vector<InputImagePixelType> buffer(bufflength);
   std::vector<InputImagePixelType> inbuffer(bufflength);
 
@@ -87,6 +117,8 @@ AnchorErodeDilateImageFilter< TImage, TKernel, TFunction1 >
   typename KernelType::DecompType decomposition = this->GetKernel().GetLines();
   BresType BresLine;
 
+  ImageRegionSplitterSlowDimension::Pointer splitter = ImageRegionSplitterSlowDimension::New();
+
   for ( unsigned i = 0; i < decomposition.size(); i++ )
     {
     typename KernelType::LType ThisLine = decomposition[i];
@@ -104,36 +136,72 @@ AnchorErodeDilateImageFilter< TImage, TKernel, TFunction1 >
 
     InputImageRegionType BigFace = MakeEnlargedFace< InputImageType, KernelLType >(input, IReg, ThisLine);
 
-    AnchorLine.SetSize(SELength);
-
-    DoAnchorFace< TImage, BresType, AnchorLineType, KernelLType >(
-      input,
-      output,
-      m_Boundary,
-      ThisLine,
-      AnchorLine,
-      TheseOffsets,
-      inbuffer,
-      buffer,
-      IReg,
-      BigFace
-      );
+    // the lines starting from the face don't overlap, so each thread
+    // processes the lines starting from its part of the face
+    const unsigned int numberOfPieces = splitter->GetNumberOfSplits(BigFace, m_NumberOfThreadsUsed);
+    if ( threadId < numberOfPieces )
+      {
+      InputImageRegionType face = BigFace;
+      splitter->GetSplit(threadId, numberOfPieces, face);
+
+      AnchorLine.SetSize(SELength);
+
+      DoAnchorFace< TImage, BresType, AnchorLineType, KernelLType >(
+        input,
+        output,
+        m_Boundary,
+        ThisLine,
+        AnchorLine,
+        TheseOffsets,
+        inbuffer,
+        buffer,
+        IReg,
+        face
+        );
+      }
+
+    // wait for the other threads to complete this direction before using
+    // its result
+    m_Barrier->Wait();
+
     // after the first pass the input will be taken from the output
-    input = internalbuffer;
+    input = m_InternalBuffer;
     progress.CompletedPixel();
     }
 
-  // copy internal buffer to output
   typedef ImageRegionIterator< InputImageType > IterType;
-  IterType oit(this->GetOutput(), OReg);
-  IterType iit(internalbuffer, OReg);
-  for ( oit.GoToBegin(), iit.GoToBegin(); !oit.IsAtEnd(); ++oit, ++iit )
+  if ( decomposition.empty() )
     {
-    oit.Set( iit.Get() );
+    // the kernel is the center only
+    ImageRegionConstIterator< InputImageType > iit(this->GetInput(), outputRegionForThread);
+    IterType oit(this->GetOutput(), outputRegionForThread);
+    for ( oit.GoToBegin(), iit.GoToBegin(); !oit.IsAtEnd(); ++oit, ++iit )
+      {
+      oit.Set( iit.Get() );
+      }
+    }
+  else if ( m_InternalBuffer != this->GetOutput() )
+    {
+    // copy internal buffer to output
+    IterType oit(this->GetOutput(), outputRegionForThread);
+    IterType iit(m_InternalBuffer, outputRegionForThread);
+    for ( oit.GoToBegin(), iit.GoToBegin(); !oit.IsAtEnd(); ++oit, ++iit )
+      {
+      oit.Set( iit.Get() );
+      }
     }
   progress.CompletedPixel();
 }
 
+template< typename TImage, typename TKernel, typename TFunction1 >
+void
+AnchorErodeDilateImageFilter< TImage, TKernel, TFunction1 >
+::AfterThreadedGenerateData()
+{
+  m_InternalBuffer = ITK_NULLPTR;
+  m_Barrier = ITK_NULLPTR;
+}
+
 template< typename TImage, typename TKernel, typename TFunction1 >
 void
 AnchorErodeDilateImageFilter< TImage, TKernel, TFunction1 >
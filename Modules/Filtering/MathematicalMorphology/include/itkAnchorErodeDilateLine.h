@@ -99,7 +99,7 @@ private:
   inline bool Compare( const InputImagePixelType & a, const InputImagePixelType & b )
     {
     TCompare compare;
-    return compare( a, b ) || Math::AlmostEquals(a, b);
+    return compare( a, b ) || a == b;
     }
 
 }; // end of class
@@ -43,7 +43,7 @@ AnchorOpenCloseLine< TInputPix, TCompare >
   // closing, and then copy the result to the output. Hopefully this
   // will improve cache performance when working along non raster
   // directions.
-  if ( bufflength <= m_Size / 2 )
+  if ( bufflength <= m_Size / 2 + 1 )
     {
     // No point doing anything fancy - just look for the extreme value
     // This is important for angled structuring elements
@@ -190,6 +190,28 @@ public:
    */
   void ComputeBufferFromLines();
 
+  /**
+   * Try to decompose the structuring element in lines, so the fast line
+   * based algorithms can be used with it. The lines are searched along the
+   * axes and the diagonals, from the longest to the shortest, and the
+   * decomposition is kept only if the buffer computed from the lines is
+   * exactly the one of the structuring element. Returns true and makes the
+   * structuring element decomposable on success; the structuring element
+   * is left unchanged otherwise. Boxes, and the polygons with edges along
+   * the axes and the diagonals, are decomposable; balls are not.
+   */
+  bool ComputeLinesFromBuffer();
+
+  /**
+   * Return the structuring element decomposed in lines when possible (see
+   * ComputeLinesFromBuffer()), or a copy of it otherwise. Balls are not
+   * sums of lines, so the cost of the filters grows with their radius. When
+   * approximateBalls is true, a ball of dimension 2 or 3 is replaced by the
+   * polygon of the same radius, which is decomposable but only
+   * approximates it (see Polygon()).
+   */
+  static Self Decompose(const Self & kernel, bool approximateBalls = false);
+
   /**
    * The RadiusIsParametric mode ensures that the area of the foreground
    * corresponds to the radius that was specified.
@@ -236,6 +258,14 @@ private:
 
   bool m_RadiusIsParametric;
 
+  /** Check whether the opening of the set of offsets by the line of
+   * 2*halfLength+1 pixels along direction is the set. */
+  bool IsOpenedByLine(const std::vector< bool > & set, const OffsetType & direction,
+                      unsigned int halfLength) const;
+
+  /** Check whether the structuring element is a ball of its radius. */
+  bool IsBall() const;
+
   /** Check for correct odd size image.
    *  Return image size. Called in constructor FromImage.*/
   static RadiusType CheckImageSize(const ImageType * image);
@@ -19,6 +19,7 @@
 #define itkFlatStructuringElement_hxx
 #include "vnl/vnl_math.h"
 #include "itkFlatStructuringElement.h"
+#include <algorithm>
 #include <cmath>
 #include <vector>
 
@@ -1008,6 +1009,201 @@ FlatStructuringElement< VDimension >::ComputeBufferFromLines()
     }
 }
 
+template< unsigned int VDimension >
+bool
+FlatStructuringElement< VDimension >::ComputeLinesFromBuffer()
+{
+  const RadiusType          radius = this->GetRadius();
+  const std::vector< bool > set( this->Begin(), this->End() );
+
+  // the candidate directions: the axes first, then the diagonals. Only the
+  // first non zero component is positive, the lines being symmetric.
+  std::vector< OffsetType > directions;
+  for ( unsigned int nonZeros = 1; nonZeros <= VDimension; nonZeros++ )
+    {
+    OffsetType direction;
+    direction.Fill(-1);
+    while ( true )
+      {
+      unsigned int numberOfNonZeros = 0;
+      int          firstNonZero = 0;
+      for ( unsigned int d = 0; d < VDimension; d++ )
+        {
+        if ( direction[d] != 0 )
+          {
+          if ( numberOfNonZeros == 0 )
+            {
+            firstNonZero = direction[d];
+            }
+          numberOfNonZeros++;
+          }
+        }
+      if ( numberOfNonZeros == nonZeros && firstNonZero > 0 )
+        {
+        directions.push_back(direction);
+        }
+      unsigned int d = 0;
+      for (; d < VDimension; d++ )
+        {
+        if ( ++direction[d] <= 1 )
+          {
+          break;
+          }
+        direction[d] = -1;
+        }
+      if ( d >= VDimension )
+        {
+        break;
+        }
+      }
+    }
+
+  // the longest line along each direction such that the structuring
+  // element is opened by the line, i.e. is a union of translations of the
+  // line. A Minkowski sum of lines is opened by each of its lines.
+  DecompType lines;
+  for ( typename std::vector< OffsetType >::const_iterator it = directions.begin(); it != directions.end(); ++it )
+    {
+    const OffsetType & direction = *it;
+    unsigned int       maximumHalfLength = NumericTraits< unsigned int >::max();
+    for ( unsigned int d = 0; d < VDimension; d++ )
+      {
+      if ( direction[d] != 0 )
+        {
+        maximumHalfLength = std::min( maximumHalfLength, static_cast< unsigned int >( radius[d] ) );
+        }
+      }
+    // a set opened by a line is opened by all the shorter ones, so the
+    // short line is a quick test
+    if ( maximumHalfLength == 0 || !this->IsOpenedByLine(set, direction, 1) )
+      {
+      continue;
+      }
+    for ( unsigned int halfLength = maximumHalfLength; halfLength > 0; halfLength-- )
+      {
+      if ( this->IsOpenedByLine(set, direction, halfLength) )
+        {
+        LType line;
+        for ( unsigned int d = 0; d < VDimension; d++ )
+          {
+          line[d] = direction[d] * static_cast< float >( 2 * halfLength + 1 );
+          }
+        lines.push_back(line);
+        break;
+        }
+      }
+    }
+  if ( lines.empty() )
+    {
+    return false;
+    }
+
+  // check that the line based algorithms give the same structuring element
+  Self decomposed;
+  decomposed.SetRadius(radius);
+  decomposed.SetDecomposable(true);
+  for ( unsigned int i = 0; i < lines.size(); i++ )
+    {
+    decomposed.AddLine(lines[i]);
+    }
+  decomposed.ComputeBufferFromLines();
+  for ( unsigned int i = 0; i < this->Size(); i++ )
+    {
+    if ( decomposed[i] != ( *this )[i] )
+      {
+      return false;
+      }
+    }
+
+  m_Lines = lines;
+  m_Decomposable = true;
+  return true;
+}
+
+template< unsigned int VDimension >
+FlatStructuringElement< VDimension >
+FlatStructuringElement< VDimension >::Decompose(const Self & kernel, bool approximateBalls)
+{
+  Self res = kernel;
+  if ( res.GetDecomposable() || res.ComputeLinesFromBuffer() )
+    {
+    return res;
+    }
+
+  // the polygons are only available in 2D and 3D. In 3D, 10 lines give an
+  // icosahedron.
+  if ( approximateBalls && ( VDimension == 2 || VDimension == 3 ) && kernel.IsBall() )
+    {
+    return Polygon(kernel.GetRadius(), VDimension == 2 ? 0 : 10);
+    }
+  return res;
+}
+
+template< unsigned int VDimension >
+bool
+FlatStructuringElement< VDimension >::IsBall() const
+{
+  const Self balls[2] = { Ball(this->GetRadius(), false), Ball(this->GetRadius(), true) };
+  for ( unsigned int b = 0; b < 2; b++ )
+    {
+    if ( std::equal( this->Begin(), this->End(), balls[b].Begin() ) )
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+template< unsigned int VDimension >
+bool
+FlatStructuringElement< VDimension >::IsOpenedByLine(const std::vector< bool > & set,
+                                                      const OffsetType & direction,
+                                                      unsigned int halfLength) const
+{
+  const RadiusType radius = this->GetRadius();
+  const int        h = static_cast< int >( halfLength );
+  OffsetValueType  step = 0;
+
+  for ( unsigned int d = 0; d < VDimension; d++ )
+    {
+    step += direction[d] * static_cast< OffsetValueType >( this->GetStride(d) );
+    }
+
+  std::vector< bool > eroded(set.size(), false);
+  for ( unsigned int i = 0; i < set.size(); i++ )
+    {
+    if ( !set[i] )
+      {
+      continue;
+      }
+    const OffsetType offset = this->GetOffset(i);
+    bool             inside = true;
+    for ( unsigned int d = 0; d < VDimension && inside; d++ )
+      {
+      inside = std::abs( offset[d] - h * direction[d] ) <= static_cast< OffsetValueType >( radius[d] )
+               && std::abs( offset[d] + h * direction[d] ) <= static_cast< OffsetValueType >( radius[d] );
+      }
+    for ( int k = -h; k <= h && inside; k++ )
+      {
+      inside = set[i + k * step];
+      }
+    eroded[i] = inside;
+    }
+
+  std::vector< bool > dilated(set.size(), false);
+  for ( unsigned int i = 0; i < set.size(); i++ )
+    {
+    if ( eroded[i] )
+      {
+      for ( int k = -h; k <= h; k++ )
+        {
+        dilated[i + k * step] = true;
+        }
+      }
+    }
+  return dilated == set;
+}
+
 /** Check if size of input Image is odd in all dimensions, throwing exception if even */
 template< unsigned int VDimension >
 typename FlatStructuringElement< VDimension >::RadiusType
@@ -39,6 +39,11 @@ namespace itk
  * The structuring element is assumed to be composed of binary
  * values (zero or one). Only elements of the structuring element
  * having values > 0 are candidates for affecting the center pixel.
+ * A FlatStructuringElement which is not decomposable, but is exactly a
+ * sum of lines, is decomposed when set, so the line based algorithms are
+ * used with it (see FlatStructuringElement::ComputeLinesFromBuffer()).
+ * Balls are not sums of lines, but can be approximated by polygons (see
+ * SetApproximateBalls()).
  *
  * \sa MorphologyImageFilter, GrayscaleFunctionDilateImageFilter, BinaryDilateImageFilter
  * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
@@ -116,6 +121,15 @@ public:
 
   itkGetConstMacro(Algorithm, int);
 
+  /** Set/Get whether a ball structuring element is replaced by the polygon
+   * of the same radius, so the line based algorithms are used with it. The
+   * polygon only approximates the ball, but the cost of the filter does not
+   * depend on the radius anymore. This option must be set before the
+   * kernel. Defaults to false. \sa FlatStructuringElement::Decompose() */
+  itkSetMacro(ApproximateBalls, bool);
+  itkGetConstReferenceMacro(ApproximateBalls, bool);
+  itkBooleanMacro(ApproximateBalls);
+
   /** GrayscaleDilateImageFilter need to set its internal filters as modified */
   virtual void Modified() const ITK_OVERRIDE;
 
@@ -154,6 +168,8 @@ private:
   // and the name of the filter
   int m_Algorithm;
 
+  bool m_ApproximateBalls;
+
   // the boundary condition need to be stored here
   DefaultBoundaryConditionType m_BoundaryCondition;
 }; // end of class
@@ -34,6 +34,7 @@ GrayscaleDilateImageFilter< TInputImage, TOutputImage, TKernel >
   m_AnchorFilter = AnchorFilterType::New();
   m_VHGWFilter = VHGWFilterType::New();
   m_Algorithm = HISTO;
+  m_ApproximateBalls = false;
 
   this->SetBoundary( NumericTraits< PixelType >::NonpositiveMin() );
 }
@@ -57,6 +58,17 @@ GrayscaleDilateImageFilter< TInputImage, TOutputImage, TKernel >
 {
   const FlatKernelType *flatKernel = dynamic_cast< const FlatKernelType * >( &kernel );
 
+  if ( flatKernel != ITK_NULLPTR && !flatKernel->GetDecomposable() )
+    {
+    // a decomposition in lines allows to use the line based algorithms
+    const FlatKernelType decomposedKernel = FlatKernelType::Decompose(*flatKernel, m_ApproximateBalls);
+    if ( decomposedKernel.GetDecomposable() )
+      {
+      this->SetKernel( *dynamic_cast< const KernelType * >( &decomposedKernel ) );
+      return;
+      }
+    }
+
   if ( flatKernel != ITK_NULLPTR && flatKernel->GetDecomposable() )
     {
     m_AnchorFilter->SetKernel(*flatKernel);
@@ -228,6 +240,7 @@ GrayscaleDilateImageFilter< TInputImage, TOutputImage, TKernel >
   os << indent << "Boundary: " <<  static_cast< typename NumericTraits< PixelType >::PrintType >( m_Boundary )
      << std::endl;
   os << indent << "Algorithm: " << m_Algorithm << std::endl;
+  os << indent << "ApproximateBalls: " << m_ApproximateBalls << std::endl;
 }
 } // end namespace itk
 #endif
@@ -40,6 +40,7 @@ GrayscaleMorphologicalClosingImageFilter< TInputImage, TOutputImage, TKernel >
   m_AnchorFilter = AnchorFilterType::New();
   m_Algorithm = HISTO;
   m_SafeBorder = true;
+  m_ApproximateBalls = false;
 }
 
 template< typename TInputImage, typename TOutputImage, typename TKernel >
@@ -49,6 +50,17 @@ GrayscaleMorphologicalClosingImageFilter< TInputImage, TOutputImage, TKernel >
 {
   const FlatKernelType *flatKernel = dynamic_cast< const FlatKernelType * >( &kernel );
 
+  if ( flatKernel != ITK_NULLPTR && !flatKernel->GetDecomposable() )
+    {
+    // a decomposition in lines allows to use the line based algorithms
+    const FlatKernelType decomposedKernel = FlatKernelType::Decompose(*flatKernel, m_ApproximateBalls);
+    if ( decomposedKernel.GetDecomposable() )
+      {
+      this->SetKernel( *dynamic_cast< const KernelType * >( &decomposedKernel ) );
+      return;
+      }
+    }
+
   if ( flatKernel != ITK_NULLPTR && flatKernel->GetDecomposable() )
     {
     m_AnchorFilter->SetKernel(*flatKernel);
@@ -337,6 +349,7 @@ GrayscaleMorphologicalClosingImageFilter< TInputImage, TOutputImage, TKernel >
 
   os << indent << "Algorithm: " << m_Algorithm << std::endl;
   os << indent << "SafeBorder: " << m_SafeBorder << std::endl;
+  os << indent << "ApproximateBalls: " << m_ApproximateBalls << std::endl;
 }
 } // end namespace itk
 #endif
@@ -112,6 +112,15 @@ public:
 
   itkGetConstMacro(Algorithm, int);
 
+  /** Set/Get whether a ball structuring element is replaced by the polygon
+   * of the same radius, so the line based algorithms are used with it. The
+   * polygon only approximates the ball, but the cost of the filter does not
+   * depend on the radius anymore. This option must be set before the
+   * kernel. Defaults to false. \sa FlatStructuringElement::Decompose() */
+  itkSetMacro(ApproximateBalls, bool);
+  itkGetConstReferenceMacro(ApproximateBalls, bool);
+  itkBooleanMacro(ApproximateBalls);
+
   /** MorphologicalGradientImageFilter need to set its internal filters as
     modified */
   virtual void Modified() const ITK_OVERRIDE;
@@ -152,6 +161,8 @@ private:
 
   // and the name of the filter
   int m_Algorithm;
+
+  bool m_ApproximateBalls;
 }; // end of class
 } // end namespace itk
 
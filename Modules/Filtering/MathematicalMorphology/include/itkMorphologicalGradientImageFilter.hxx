@@ -37,6 +37,7 @@ MorphologicalGradientImageFilter< TInputImage, TOutputImage, TKernel >
   m_VanHerkGilWermanDilateFilter = VHGWDilateFilterType::New();
   m_VanHerkGilWermanErodeFilter = VHGWErodeFilterType::New();
   m_Algorithm = HISTO;
+  m_ApproximateBalls = false;
 }
 
 template< typename TInputImage, typename TOutputImage, typename TKernel >
@@ -46,6 +47,17 @@ MorphologicalGradientImageFilter< TInputImage, TOutputImage, TKernel >
 {
   const FlatKernelType *flatKernel = dynamic_cast< const FlatKernelType * >( &kernel );
 
+  if ( flatKernel != ITK_NULLPTR && !flatKernel->GetDecomposable() )
+    {
+    // a decomposition in lines allows to use the line based algorithms
+    const FlatKernelType decomposedKernel = FlatKernelType::Decompose(*flatKernel, m_ApproximateBalls);
+    if ( decomposedKernel.GetDecomposable() )
+      {
+      this->SetKernel( *dynamic_cast< const KernelType * >( &decomposedKernel ) );
+      return;
+      }
+    }
+
   if ( flatKernel != ITK_NULLPTR && flatKernel->GetDecomposable() )
     {
     m_AnchorDilateFilter->SetKernel(*flatKernel);
@@ -225,6 +237,7 @@ MorphologicalGradientImageFilter< TInputImage, TOutputImage, TKernel >
   Superclass::PrintSelf(os, indent);
 
   os << indent << "Algorithm: " << m_Algorithm << std::endl;
+  os << indent << "ApproximateBalls: " << m_ApproximateBalls << std::endl;
 }
 } // end namespace itk
 #endif
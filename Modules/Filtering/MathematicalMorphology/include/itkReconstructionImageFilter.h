@@ -22,6 +22,7 @@
 #include "itkShapedNeighborhoodIterator.h"
 #include "itkImageRegionIterator.h"
 #include "itkProgressReporter.h"
+#include "itkBarrier.h"
 #include <queue>
 
 //#define BASIC
@@ -43,6 +44,13 @@ namespace itk
  * applications and efficient algorithms" -- IEEE Transactions on
  * Image processing, Vol 2, No 2, pp 176-201, April 1993
  *
+ * When UseInternalCopy is on, the image is split in slabs along its
+ * slowest dimension, and each thread runs the raster, antiraster and
+ * FIFO steps on its own slab. The pixels on the borders of the slabs
+ * are then exchanged between the threads, and propagated again in
+ * each slab, until no pixel changes. The result doesn't depend on the
+ * number of threads.
+ *
  * \author Richard Beare. Department of Medicine, Monash University,
  * Melbourne, Australia.
  *
@@ -130,7 +138,7 @@ public:
   /**
    * Perform a padding of the image internally to increase the performance
    * of the filter. UseInternalCopy can be set to false to reduce the memory
-   * usage.
+   * usage, but the filter is then run by a single thread.
    */
   itkSetMacro(UseInternalCopy, bool);
   itkGetConstReferenceMacro(UseInternalCopy, bool);
@@ -151,6 +159,14 @@ protected:
 
   void GenerateData() ITK_OVERRIDE;
 
+  /** Pad the marker and the mask images, and prepare the threads. */
+  void BeforeThreadedGenerateData() ITK_OVERRIDE;
+
+  void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                            ThreadIdType threadId) ITK_OVERRIDE;
+
+  void AfterThreadedGenerateData() ITK_OVERRIDE;
+
   /**
    * the value of the border - used in boundary condition.
    */
@@ -163,6 +179,16 @@ private:
   bool m_FullyConnected;
   bool m_UseInternalCopy;
 
+  /** The padded copies of the marker and the mask images, and the offsets
+   * of the neighbors in their buffers, used by the threads. */
+  MarkerImagePointer             m_PaddedMarker;
+  MaskImagePointer               m_PaddedMask;
+  std::vector< OffsetValueType > m_NeighborOffsets;
+
+  typename Barrier::Pointer    m_Barrier;
+  std::vector< char >          m_InvalidThreads;
+  std::vector< SizeValueType > m_NumberOfBorderUpdates;
+
   typedef typename itk::NeighborhoodAlgorithm::ImageBoundaryFacesCalculator< OutputImageType > FaceCalculatorType;
 
   typedef typename FaceCalculatorType::FaceListType           FaceListType;
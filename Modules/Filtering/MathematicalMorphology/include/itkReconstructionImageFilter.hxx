@@ -24,7 +24,7 @@
 #include "itkConnectedComponentAlgorithm.h"
 
 #include "itkConstantPadImageFilter.h"
-#include "itkCropImageFilter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
 
 namespace itk
 {
@@ -99,12 +99,18 @@ ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >::GetMaskImage()
   return this->GetInput(1);
 }
 
-// a version that takes a padded copy of mask and marker
 template< typename TInputImage, typename TOutputImage, typename TCompare >
 void
 ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
 ::GenerateData()
 {
+  if ( m_UseInternalCopy )
+    {
+    // the padded copies are processed by the threads
+    Superclass::GenerateData();
+    return;
+    }
+
   // Allocate the output
   this->AllocateOutputs();
   // there are 2 passes that use all pixels and a 3rd that uses some
@@ -125,52 +131,23 @@ ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
     itkExceptionMacro(<< "Marker and mask must have the same size.");
     }
 
-  // create padded versions of the marker image and the mask image
-  typedef typename itk::ConstantPadImageFilter< InputImageType, InputImageType > PadType;
-
   MarkerImageConstPointer markerImageP;
   MaskImageConstPointer   maskImageP;
 
-  ISizeType padSize;
-
-  if ( m_UseInternalCopy )
-    {
-    typename PadType::Pointer MaskPad = PadType::New();
-    typename PadType::Pointer MarkerPad = PadType::New();
-    padSize.Fill(1);
-
-    MaskPad->SetConstant(m_MarkerValue);
-    MarkerPad->SetConstant(m_MarkerValue);
-    MaskPad->SetPadLowerBound(padSize);
-    MaskPad->SetPadUpperBound(padSize);
-    MarkerPad->SetPadLowerBound(padSize);
-    MarkerPad->SetPadUpperBound(padSize);
-
-    MaskPad->SetInput(maskImage);
-    MarkerPad->SetInput(markerImage);
-    MaskPad->Update();
-    MarkerPad->Update();
-
-    markerImageP = MarkerPad->GetOutput();
-    maskImageP = MaskPad->GetOutput();
-    }
-  else
-    {
-    maskImageP = this->GetMaskImage();
-    InputIteratorType inIt( markerImage,
+  maskImageP = this->GetMaskImage();
+  InputIteratorType inIt( markerImage,
+                          output->GetRequestedRegion() );
+  OutputIteratorType outIt( output,
                             output->GetRequestedRegion() );
-    OutputIteratorType outIt( output,
-                              output->GetRequestedRegion() );
-    // copy marker to output - isn't there a better way?
-    while ( !outIt.IsAtEnd() )
-      {
-      MarkerImagePixelType currentValue = inIt.Get();
-      outIt.Set( static_cast< OutputImagePixelType >( currentValue ) );
-      ++inIt;
-      ++outIt;
-      }
-    markerImageP = output;
+  // copy marker to output - isn't there a better way?
+  while ( !outIt.IsAtEnd() )
+    {
+    MarkerImagePixelType currentValue = inIt.Get();
+    outIt.Set( static_cast< OutputImagePixelType >( currentValue ) );
+    ++inIt;
+    ++outIt;
     }
+  markerImageP = output;
 
   // declare our queue type
   typedef typename std::queue< OutputImageIndexType > FifoType;
@@ -181,46 +158,18 @@ ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
   CNInputIterator   mskNIt;
   ISizeType         kernelRadius;
   kernelRadius.Fill(1);
-  if ( m_UseInternalCopy )
-    {
-    FaceCalculatorType faceCalculator;
-
-    FaceListType   faceList;
-    FaceListTypeIt fit;
-
-    faceList = faceCalculator(maskImageP, maskImageP->GetLargestPossibleRegion(),
-                              kernelRadius);
-    // we will only be processing the body region
-    fit = faceList.begin();
-    // must be a better way of doing this
-    NOutputIterator tt(kernelRadius,
-                       markerImageP,
-                       *fit);
-    outNIt = tt;
-
-    InputIteratorType ttt(maskImageP,
-                          *fit);
-    mskIt = ttt;
-    CNInputIterator tttt(kernelRadius,
-                         maskImageP,
-                         *fit);
-    mskNIt = tttt;
-    }
-  else
-    {
-    NOutputIterator tt( kernelRadius,
-                        markerImageP,
+  NOutputIterator tt( kernelRadius,
+                      markerImageP,
+                      output->GetRequestedRegion() );
+  outNIt = tt;
+
+  InputIteratorType ttt( maskImageP,
+                         output->GetRequestedRegion() );
+  mskIt = ttt;
+  CNInputIterator tttt( kernelRadius,
+                        maskImageP,
                         output->GetRequestedRegion() );
-    outNIt = tt;
-
-    InputIteratorType ttt( maskImageP,
-                           output->GetRequestedRegion() );
-    mskIt = ttt;
-    CNInputIterator tttt( kernelRadius,
-                          maskImageP,
-                          output->GetRequestedRegion() );
-    mskNIt = tttt;
-    }
+  mskNIt = tttt;
 
   setConnectivityPrevious(&outNIt, m_FullyConnected);
 
@@ -370,21 +319,363 @@ ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
       }
     progress.CompletedPixel();
     }
+}
 
-  if ( m_UseInternalCopy )
+template< typename TInputImage, typename TOutputImage, typename TCompare >
+void
+ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
+::BeforeThreadedGenerateData()
+{
+  // mask and marker must have the same size
+  if ( this->GetMarkerImage()->GetRequestedRegion().GetSize() != this->GetMaskImage()->GetRequestedRegion().GetSize() )
+    {
+    itkExceptionMacro(<< "Marker and mask must have the same size.");
+    }
+
+  // create padded versions of the marker image and the mask image, so the
+  // neighbors of all the pixels are in the buffers. The padding pixels have
+  // the marker value, and never change.
+  typedef typename itk::ConstantPadImageFilter< InputImageType, InputImageType > PadType;
+
+  ISizeType padSize;
+  padSize.Fill(1);
+
+  typename PadType::Pointer MaskPad = PadType::New();
+  typename PadType::Pointer MarkerPad = PadType::New();
+  MaskPad->SetConstant(m_MarkerValue);
+  MarkerPad->SetConstant(m_MarkerValue);
+  MaskPad->SetPadLowerBound(padSize);
+  MaskPad->SetPadUpperBound(padSize);
+  MarkerPad->SetPadLowerBound(padSize);
+  MarkerPad->SetPadUpperBound(padSize);
+  MaskPad->SetInput( this->GetMaskImage() );
+  MarkerPad->SetInput( this->GetMarkerImage() );
+  MaskPad->SetNumberOfThreads( this->GetNumberOfThreads() );
+  MarkerPad->SetNumberOfThreads( this->GetNumberOfThreads() );
+  MaskPad->Update();
+  MarkerPad->Update();
+
+  m_PaddedMarker = MarkerPad->GetOutput();
+  m_PaddedMask = MaskPad->GetOutput();
+  m_PaddedMarker->DisconnectPipeline();
+  m_PaddedMask->DisconnectPipeline();
+
+  // the offsets of the neighbors in the padded buffers
+  m_NeighborOffsets.clear();
+  const OffsetValueType *offsetTable = m_PaddedMarker->GetOffsetTable();
+  typename InputImageType::OffsetType offset;
+  offset.Fill(-1);
+  bool done = false;
+  while ( !done )
+    {
+    unsigned int numberOfNonZero = 0;
+    OffsetValueType linearOffset = 0;
+    for ( unsigned int d = 0; d < MarkerImageDimension; d++ )
+      {
+      linearOffset += offset[d] * offsetTable[d];
+      if ( offset[d] != 0 )
+        {
+        numberOfNonZero++;
+        }
+      }
+    if ( numberOfNonZero == 1 || ( numberOfNonZero > 1 && m_FullyConnected ) )
+      {
+      m_NeighborOffsets.push_back(linearOffset);
+      }
+    // next offset
+    done = true;
+    for ( unsigned int d = 0; d < MarkerImageDimension && done; d++ )
+      {
+      if ( offset[d] < 1 )
+        {
+        offset[d]++;
+        done = false;
+        }
+      else
+        {
+        offset[d] = -1;
+        }
+      }
+    }
+
+  ThreadIdType numberOfThreads = this->GetNumberOfThreads();
+
+  if ( itk::MultiThreader::GetGlobalMaximumNumberOfThreads() != 0 )
     {
-    typedef typename itk::CropImageFilter< InputImageType, OutputImageType > CropType;
-    typename CropType::Pointer crop = CropType::New();
-
-    crop->SetInput(markerImageP);
-    crop->SetUpperBoundaryCropSize(padSize);
-    crop->SetLowerBoundaryCropSize(padSize);
-    crop->GraftOutput( this->GetOutput() );
-    /** execute the minipipeline */
-    crop->Update();
-
-    /** graft the minipipeline output back into this filter's output */
-    this->GraftOutput( crop->GetOutput() );
+    numberOfThreads = std::min(
+      this->GetNumberOfThreads(), itk::MultiThreader::GetGlobalMaximumNumberOfThreads() );
+    }
+
+  // number of threads can be constrained by the region size, so call the
+  // SplitRequestedRegion to get the real number of threads which will be used
+  OutputImageRegionType splitRegion;  // dummy region - just to call
+                                      // the following method
+
+  numberOfThreads = this->SplitRequestedRegion(0, numberOfThreads, splitRegion);
+
+  m_Barrier = Barrier::New();
+  m_Barrier->Initialize(numberOfThreads);
+
+  m_InvalidThreads.assign(numberOfThreads, 0);
+  m_NumberOfBorderUpdates.assign(numberOfThreads, 0);
+}
+
+template< typename TInputImage, typename TOutputImage, typename TCompare >
+void
+ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
+::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                       ThreadIdType threadId)
+{
+  // the regions of the threads are slabs along the slowest dimension, so
+  // the pixels of a thread are the ones between the first and the last
+  // pixel of its region in the padded buffer. The other pixels in that
+  // range are padding pixels, which are never modified.
+  TCompare compare;
+
+  InputImagePixelType       *marker = m_PaddedMarker->GetBufferPointer();
+  const InputImagePixelType *mask = m_PaddedMask->GetBufferPointer();
+
+  InputImageIndexType lastIndex = outputRegionForThread.GetIndex();
+  for ( unsigned int d = 0; d < MarkerImageDimension; d++ )
+    {
+    lastIndex[d] += outputRegionForThread.GetSize()[d] - 1;
+    }
+  const OffsetValueType first = m_PaddedMarker->ComputeOffset( outputRegionForThread.GetIndex() );
+  const OffsetValueType last = m_PaddedMarker->ComputeOffset(lastIndex);
+  const OffsetValueType lineLength = outputRegionForThread.GetSize()[0];
+
+  // the offsets of the first pixel of the lines of the region
+  std::vector< OffsetValueType > lines;
+  MarkerImageRegionType          lineRegion = outputRegionForThread;
+  lineRegion.SetSize(0, 1);
+  for ( ImageRegionConstIteratorWithIndex< InputImageType > lit(m_PaddedMarker, lineRegion);
+        !lit.IsAtEnd(); ++lit )
+    {
+    lines.push_back( m_PaddedMarker->ComputeOffset( lit.GetIndex() ) );
+    }
+
+  std::vector< OffsetValueType > previousOffsets;
+  std::vector< OffsetValueType > laterOffsets;
+  for ( typename std::vector< OffsetValueType >::const_iterator oIt = m_NeighborOffsets.begin();
+        oIt != m_NeighborOffsets.end(); ++oIt )
+    {
+    if ( *oIt < 0 )
+      {
+      previousOffsets.push_back(*oIt);
+      }
+    else
+      {
+      laterOffsets.push_back(*oIt);
+      }
+    }
+
+  ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels() * 2);
+
+  // scan in forward raster order, with the neighbors in the slab only
+  for ( typename std::vector< OffsetValueType >::const_iterator lIt = lines.begin(); lIt != lines.end(); ++lIt )
+    {
+    for ( OffsetValueType p = *lIt; p < *lIt + lineLength; p++ )
+      {
+      InputImagePixelType V = marker[p];
+
+      // be sure that the pixels in the images follow the preconditions
+      if ( compare(V, mask[p]) )
+        {
+        m_InvalidThreads[threadId] = 1;
+        }
+
+      for ( typename std::vector< OffsetValueType >::const_iterator oIt = previousOffsets.begin();
+            oIt != previousOffsets.end(); ++oIt )
+        {
+        const OffsetValueType q = p + *oIt;
+        if ( q >= first && compare(marker[q], V) )
+          {
+          V = marker[q];
+          }
+        }
+      // this step clamps to the mask
+      if ( compare(V, mask[p]) )
+        {
+        V = mask[p];
+        }
+      marker[p] = V;
+      progress.CompletedPixel();
+      }
+    }
+
+  // reverse raster order pass, which puts in the fifo the pixels which
+  // may still propagate
+  typedef std::queue< OffsetValueType > FifoType;
+  FifoType fifo;
+
+  for ( typename std::vector< OffsetValueType >::const_reverse_iterator lIt = lines.rbegin();
+        lIt != lines.rend(); ++lIt )
+    {
+    for ( OffsetValueType p = *lIt + lineLength - 1; p >= *lIt; p-- )
+      {
+      InputImagePixelType V = marker[p];
+      for ( typename std::vector< OffsetValueType >::const_iterator oIt = laterOffsets.begin();
+            oIt != laterOffsets.end(); ++oIt )
+        {
+        const OffsetValueType q = p + *oIt;
+        if ( q <= last && compare(marker[q], V) )
+          {
+          V = marker[q];
+          }
+        }
+      if ( compare(V, mask[p]) )
+        {
+        V = mask[p];
+        }
+      marker[p] = V;
+
+      for ( typename std::vector< OffsetValueType >::const_iterator oIt = laterOffsets.begin();
+            oIt != laterOffsets.end(); ++oIt )
+        {
+        const OffsetValueType q = p + *oIt;
+        if ( q <= last && compare(V, marker[q]) && compare(mask[q], marker[q]) )
+          {
+          fifo.push(p);
+          break;
+          }
+        }
+      progress.CompletedPixel();
+      }
+    }
+
+  // the pixels on the borders of the slab, which may be modified by the
+  // neighbor slabs, are in its first and last planes along the slowest
+  // dimension
+  unsigned int splitDimension = 0;
+  for ( unsigned int d = 1; d < MarkerImageDimension; d++ )
+    {
+    if ( this->GetOutput()->GetRequestedRegion().GetSize()[d] > 1 )
+      {
+      splitDimension = d;
+      }
+    }
+  const OffsetValueType planeStride = m_PaddedMarker->GetOffsetTable()[splitDimension];
+
+  std::vector< std::pair< OffsetValueType, InputImagePixelType > > borderUpdates;
+  while ( true )
+    {
+    // process the fifo, with the neighbors in the slab only
+    while ( !fifo.empty() )
+      {
+      const OffsetValueType p = fifo.front();
+      fifo.pop();
+      const InputImagePixelType V = marker[p];
+      for ( typename std::vector< OffsetValueType >::const_iterator oIt = m_NeighborOffsets.begin();
+            oIt != m_NeighborOffsets.end(); ++oIt )
+        {
+        const OffsetValueType q = p + *oIt;
+        // candidate for dilation via flooding
+        if ( q >= first && q <= last && compare(V, marker[q]) && Math::NotAlmostEquals( mask[q], marker[q] ) )
+          {
+          marker[q] = compare(mask[q], V) ? V : mask[q];
+          fifo.push(q);
+          }
+        }
+      }
+
+    m_Barrier->Wait();
+    bool invalid = false;
+    for ( ThreadIdType t = 0; t < m_InvalidThreads.size(); t++ )
+      {
+      invalid = invalid || m_InvalidThreads[t];
+      }
+    if ( invalid )
+      {
+      // the exception is thrown in AfterThreadedGenerateData()
+      return;
+      }
+
+    // collect the values propagated from the other slabs to the borders of
+    // this one. The other threads don't modify their pixels meanwhile.
+    borderUpdates.clear();
+    for ( OffsetValueType p = first; p <= last; p++ )
+      {
+      if ( p >= first + planeStride && p <= last - planeStride )
+        {
+        // skip the inner part of the slab
+        p = last - planeStride + 1;
+        }
+      if ( !Math::NotAlmostEquals( mask[p], marker[p] ) )
+        {
+        continue;
+        }
+      InputImagePixelType V = marker[p];
+      for ( typename std::vector< OffsetValueType >::const_iterator oIt = m_NeighborOffsets.begin();
+            oIt != m_NeighborOffsets.end(); ++oIt )
+        {
+        const OffsetValueType q = p + *oIt;
+        if ( ( q < first || q > last ) && compare(marker[q], V) )
+          {
+          V = marker[q];
+          }
+        }
+      if ( compare(V, marker[p]) )
+        {
+        borderUpdates.push_back( std::make_pair( p, compare(V, mask[p]) ? mask[p] : V ) );
+        }
+      }
+    m_Barrier->Wait();
+
+    // apply them, and propagate them in the slab
+    for ( typename std::vector< std::pair< OffsetValueType, InputImagePixelType > >::const_iterator uIt =
+            borderUpdates.begin(); uIt != borderUpdates.end(); ++uIt )
+      {
+      marker[uIt->first] = uIt->second;
+      fifo.push(uIt->first);
+      }
+    m_NumberOfBorderUpdates[threadId] = borderUpdates.size();
+    m_Barrier->Wait();
+
+    SizeValueType numberOfBorderUpdates = 0;
+    for ( ThreadIdType t = 0; t < m_NumberOfBorderUpdates.size(); t++ )
+      {
+      numberOfBorderUpdates += m_NumberOfBorderUpdates[t];
+      }
+    if ( numberOfBorderUpdates == 0 )
+      {
+      break;
+      }
+    }
+
+  // copy the slab to the output
+  ImageRegionConstIterator< InputImageType > inIt(m_PaddedMarker, outputRegionForThread);
+  ImageRegionIterator< OutputImageType >     outIt(this->GetOutput(), outputRegionForThread);
+  for (; !outIt.IsAtEnd(); ++inIt, ++outIt )
+    {
+    outIt.Set( static_cast< OutputImagePixelType >( inIt.Get() ) );
+    }
+}
+
+template< typename TInputImage, typename TOutputImage, typename TCompare >
+void
+ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
+::AfterThreadedGenerateData()
+{
+  m_PaddedMarker = ITK_NULLPTR;
+  m_PaddedMask = ITK_NULLPTR;
+  m_Barrier = ITK_NULLPTR;
+
+  bool invalid = false;
+  for ( ThreadIdType t = 0; t < m_InvalidThreads.size(); t++ )
+    {
+    invalid = invalid || m_InvalidThreads[t];
+    }
+  if ( invalid )
+    {
+    TCompare compare;
+    if ( compare(0, 1) )
+      {
+      itkExceptionMacro(<< "Marker pixels must be <= mask pixels.");
+      }
+    else
+      {
+      itkExceptionMacro(<< "Marker pixels must be >= mask pixels.");
+      }
     }
 }
 
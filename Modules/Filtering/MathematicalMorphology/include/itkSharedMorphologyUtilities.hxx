@@ -202,13 +202,12 @@ int ComputeStartEnd(const typename TImage::IndexType StartIndex,
       }
     else
       {
-      for (; sPos < (int)LineOffsets.size(); )
+      for (; sPos + 1 < (int)LineOffsets.size(); )
         {
+        ++sPos;
         itkAssertInDebugAndIgnoreInReleaseMacro(sPos >= 0);
         itkAssertInDebugAndIgnoreInReleaseMacro( sPos < (int)LineOffsets.size() );
-        ++sPos;
-        if ( !AllImage.IsInside(StartIndex + LineOffsets[sPos]) ) { ++sPos; }
-        else { break; }
+        if ( AllImage.IsInside(StartIndex + LineOffsets[sPos]) ) { break; }
         }
       }
     if ( AllImage.IsInside(StartIndex + LineOffsets[ePos]) )
@@ -228,8 +227,7 @@ int ComputeStartEnd(const typename TImage::IndexType StartIndex,
         --ePos;
         itkAssertInDebugAndIgnoreInReleaseMacro(ePos >= 0);
         itkAssertInDebugAndIgnoreInReleaseMacro( ePos < (int)LineOffsets.size() );
-        if ( !AllImage.IsInside(StartIndex + LineOffsets[ePos]) ) { --ePos; }
-        else { break; }
+        if ( AllImage.IsInside(StartIndex + LineOffsets[ePos]) ) { break; }
         }
       }
     }
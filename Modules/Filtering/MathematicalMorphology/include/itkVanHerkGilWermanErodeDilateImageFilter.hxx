@@ -20,6 +20,7 @@
 
 #include "itkVanHerkGilWermanErodeDilateImageFilter.h"
 #include "itkImageRegionIterator.h"
+#include "itkImageRegionSplitterSlowDimension.h"
 
 #include "itkVanHerkGilWermanUtilities.h"
 
@@ -28,23 +29,60 @@ namespace itk
 template< typename TImage, typename TKernel, typename TFunction1 >
 VanHerkGilWermanErodeDilateImageFilter< TImage, TKernel, TFunction1 >
 ::VanHerkGilWermanErodeDilateImageFilter():
-  m_Boundary( NumericTraits< InputImagePixelType >::ZeroValue() )
+  m_Boundary( NumericTraits< InputImagePixelType >::ZeroValue() ),
+  m_NumberOfThreadsUsed( 1 )
 {
 }
 
 template< typename TImage, typename TKernel, typename TFunction1 >
 void
 VanHerkGilWermanErodeDilateImageFilter< TImage, TKernel, TFunction1 >
-::ThreadedGenerateData(const InputImageRegionType & outputRegionForThread,
-                       ThreadIdType threadId)
+::BeforeThreadedGenerateData()
 {
   // check that we are using a decomposable kernel
   if ( !this->GetKernel().GetDecomposable() )
     {
     itkExceptionMacro("VanHerkGilWerman morphology only works with decomposable structuring elements");
-    return;
     }
 
+  // the lines are processed on the whole padded region, so the threads
+  // don't compute the same pixels again on the borders of their regions
+  m_PaddedRegion = this->GetOutput()->GetRequestedRegion();
+  m_PaddedRegion.PadByRadius( this->GetKernel().GetRadius() );
+  m_PaddedRegion.Crop( this->GetInput()->GetRequestedRegion() );
+
+  // the lines are processed in place in the output, unless it is too small
+  if ( this->GetOutput()->GetBufferedRegion() == m_PaddedRegion )
+    {
+    m_InternalBuffer = this->GetOutput();
+    }
+  else
+    {
+    m_InternalBuffer = InputImageType::New();
+    m_InternalBuffer->SetRegions(m_PaddedRegion);
+    m_InternalBuffer->Allocate();
+    }
+
+  // number of threads can be constrained by the region size, so call the
+  // SplitRequestedRegion to get the real number of threads which will be used
+  ThreadIdType numberOfThreads = this->GetNumberOfThreads();
+  if ( MultiThreader::GetGlobalMaximumNumberOfThreads() != 0 )
+    {
+    numberOfThreads = std::min( this->GetNumberOfThreads(), MultiThreader::GetGlobalMaximumNumberOfThreads() );
+    }
+  InputImageRegionType splitRegion;
+  m_NumberOfThreadsUsed = this->SplitRequestedRegion(0, numberOfThreads, splitRegion);
+
+  m_Barrier = Barrier::New();
+  m_Barrier->Initialize(m_NumberOfThreadsUsed);
+}
+
+template< typename TImage, typename TKernel, typename TFunction1 >
+void
+VanHerkGilWermanErodeDilateImageFilter< TImage, TKernel, TFunction1 >
+::ThreadedGenerateData(const InputImageRegionType & outputRegionForThread,
+                       ThreadIdType threadId)
+{
 // TFunction1 will be < for erosions
 
   // the initial version will adopt the methodology of loading a line
@@ -56,20 +94,9 @@ VanHerkGilWermanErodeDilateImageFilter< TImage, TKernel, TFunction1 >
   ProgressReporter progress(this, threadId, this->GetKernel().GetLines().size() + 1);
 
   InputImageConstPointer input = this->GetInput();
+  InputImagePointer      output = m_InternalBuffer;
+  InputImageRegionType   IReg = m_PaddedRegion;
 
-  InputImageRegionType IReg = outputRegionForThread;
-  IReg.PadByRadius( this->GetKernel().GetRadius() );
-  // IReg.PadByRadius( this->GetKernel().GetRadius() );
-  IReg.Crop( this->GetInput()->GetRequestedRegion() );
-
-  // allocate an internal buffer
-  typename InputImageType::Pointer internalbuffer = InputImageType::New();
-  internalbuffer->SetRegions(IReg);
-  internalbuffer->Allocate();
-  InputImagePointer output = internalbuffer;
-
-  // get the region size
-  InputImageRegionType OReg = outputRegionForThread;
   // maximum buffer length is sum of dimensions
   unsigned int bufflength = 0;
   for ( unsigned i = 0; i < TImage::ImageDimension; i++ )
@@ -80,6 +107,7 @@ VanHerkGilWermanErodeDilateImageFilter< TImage, TKernel, TFunction1 >
   // compat
   bufflength += 2;
 
+  // the line buffers are private to the thread
   std::vector<InputImagePixelType> buffer(bufflength);
   std::vector<InputImagePixelType> forward(bufflength);
   std::vector<InputImagePixelType> reverse(bufflength);
@@ -89,6 +117,8 @@ VanHerkGilWermanErodeDilateImageFilter< TImage, TKernel, TFunction1 >
 
   typedef typename KernelType::LType KernelLType;
 
+  ImageRegionSplitterSlowDimension::Pointer splitter = ImageRegionSplitterSlowDimension::New();
+
   for ( unsigned i = 0; i < decomposition.size(); i++ )
     {
     typename KernelType::LType ThisLine = decomposition[i];
@@ -102,27 +132,62 @@ VanHerkGilWermanErodeDilateImageFilter< TImage, TKernel, TFunction1 >
 
     InputImageRegionType BigFace = MakeEnlargedFace< InputImageType, KernelLType >(input, IReg, ThisLine);
 
-    DoFace< TImage, BresType, TFunction1, KernelLType >(input, output, m_Boundary, ThisLine,
-                                                        TheseOffsets, SELength,
-                                                        buffer, forward,
-                                                        reverse, IReg, BigFace);
+    // the lines starting from the face don't overlap, so each thread
+    // processes the lines starting from its part of the face
+    const unsigned int numberOfPieces = splitter->GetNumberOfSplits(BigFace, m_NumberOfThreadsUsed);
+    if ( threadId < numberOfPieces )
+      {
+      InputImageRegionType face = BigFace;
+      splitter->GetSplit(threadId, numberOfPieces, face);
+
+      DoFace< TImage, BresType, TFunction1, KernelLType >(input, output, m_Boundary, ThisLine,
+                                                          TheseOffsets, SELength,
+                                                          buffer, forward,
+                                                          reverse, IReg, face);
+      }
+
+    // wait for the other threads to complete this direction before using
+    // its result
+    m_Barrier->Wait();
 
     // after the first pass the input will be taken from the output
-    input = internalbuffer;
+    input = m_InternalBuffer;
     progress.CompletedPixel();
     }
 
-  // copy internal buffer to output
   typedef ImageRegionIterator< InputImageType > IterType;
-  IterType oit(this->GetOutput(), OReg);
-  IterType iit(internalbuffer, OReg);
-  for ( oit.GoToBegin(), iit.GoToBegin(); !oit.IsAtEnd(); ++oit, ++iit )
+  if ( decomposition.empty() )
     {
-    oit.Set( iit.Get() );
+    // the kernel is the center only
+    ImageRegionConstIterator< InputImageType > iit(this->GetInput(), outputRegionForThread);
+    IterType oit(this->GetOutput(), outputRegionForThread);
+    for ( oit.GoToBegin(), iit.GoToBegin(); !oit.IsAtEnd(); ++oit, ++iit )
+      {
+      oit.Set( iit.Get() );
+      }
+    }
+  else if ( m_InternalBuffer != this->GetOutput() )
+    {
+    // copy internal buffer to output
+    IterType oit(this->GetOutput(), outputRegionForThread);
+    IterType iit(m_InternalBuffer, outputRegionForThread);
+    for ( oit.GoToBegin(), iit.GoToBegin(); !oit.IsAtEnd(); ++oit, ++iit )
+      {
+      oit.Set( iit.Get() );
+      }
     }
   progress.CompletedPixel();
 }
 
+template< typename TImage, typename TKernel, typename TFunction1 >
+void
+VanHerkGilWermanErodeDilateImageFilter< TImage, TKernel, TFunction1 >
+::AfterThreadedGenerateData()
+{
+  m_InternalBuffer = ITK_NULLPTR;
+  m_Barrier = ITK_NULLPTR;
+}
+
 template< typename TImage, typename TKernel, typename TFunction1 >
 void
 VanHerkGilWermanErodeDilateImageFilter< TImage, TKernel, TFunction1 >
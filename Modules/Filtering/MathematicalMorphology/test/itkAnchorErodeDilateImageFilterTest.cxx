@@ -0,0 +1,155 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkAnchorDilateImageFilter.h"
+#include "itkAnchorErodeImageFilter.h"
+#include "itkVanHerkGilWermanDilateImageFilter.h"
+#include "itkVanHerkGilWermanErodeImageFilter.h"
+#include "itkFlatStructuringElement.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+
+const unsigned int Dimension = 3;
+
+typedef itk::Image< float, Dimension >           ImageType;
+typedef itk::FlatStructuringElement< Dimension > SEType;
+
+/* Checks that the output of the filter with several threads, and on a part
+ * of the image only if checkRegion is true, is the same as its output with
+ * a single thread. */
+template< typename TFilter >
+bool
+CheckThreads( const ImageType *image, const SEType & kernel, float boundary, bool checkRegion, const char *name )
+{
+  typename TFilter::Pointer reference = TFilter::New();
+  reference->SetInput( image );
+  reference->SetKernel( kernel );
+  reference->SetBoundary( boundary );
+  reference->SetNumberOfThreads( 1 );
+  TRY_EXPECT_NO_EXCEPTION( reference->Update() );
+
+  typename TFilter::Pointer filter = TFilter::New();
+  filter->SetInput( image );
+  filter->SetKernel( kernel );
+  filter->SetBoundary( boundary );
+  filter->SetNumberOfThreads( 4 );
+  TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+  // only a part of the output is requested, so the lines are processed in
+  // an internal buffer
+  ImageType::RegionType region = image->GetLargestPossibleRegion();
+  region.ShrinkByRadius( 7 );
+  typename TFilter::Pointer regionFilter = TFilter::New();
+  regionFilter->SetInput( image );
+  regionFilter->SetKernel( kernel );
+  regionFilter->SetBoundary( boundary );
+  regionFilter->SetNumberOfThreads( 3 );
+  regionFilter->GetOutput()->SetRequestedRegion( region );
+  TRY_EXPECT_NO_EXCEPTION( regionFilter->Update() );
+
+  itk::ImageRegionConstIteratorWithIndex< ImageType > rit( reference->GetOutput(), image->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< ImageType >          it( filter->GetOutput(), image->GetLargestPossibleRegion() );
+  for(; !rit.IsAtEnd(); ++rit, ++it )
+    {
+    if( it.Get() != rit.Get() )
+      {
+      std::cerr << name << ": mismatch at " << rit.GetIndex() << ": expected " << rit.Get() << ", got "
+                << it.Get() << std::endl;
+      return false;
+      }
+    if( checkRegion && region.IsInside( rit.GetIndex() )
+        && regionFilter->GetOutput()->GetPixel( rit.GetIndex() ) != rit.Get() )
+      {
+      std::cerr << name << ": mismatch in the requested region at " << rit.GetIndex() << ": expected "
+                << rit.Get() << ", got " << regionFilter->GetOutput()->GetPixel( rit.GetIndex() ) << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+}
+
+/* Dilates and erodes a 3D image with a box and a polygon, with the anchor
+ * and the van Herk/Gil-Werman algorithms, and checks that the results
+ * don't depend on the number of threads. */
+int itkAnchorErodeDilateImageFilterTest( int, char * [] )
+{
+  ImageType::SizeType size;
+  size[0] = 67;
+  size[1] = 53;
+  size[2] = 41;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+  for(; !it.IsAtEnd(); ++it )
+    {
+    // plateaus of a coarse ramp, so that the lines have equal values for the
+    // anchors, with small bright cubes and dark voxels that the dilations
+    // and erosions spread with the shape of the kernel
+    const ImageType::IndexType index = it.GetIndex();
+    float                      value = static_cast< float >( ( 2 * index[0] + index[1] + 3 * index[2] ) / 16 );
+    if( index[0] % 17 < 3 && index[1] % 13 < 3 && index[2] % 11 < 3 )
+      {
+      value += 100.0f;
+      }
+    if( ( index[0] + index[1] ) % 19 == 0 && index[2] % 7 == 2 )
+      {
+      value -= 50.0f;
+      }
+    it.Set( value );
+    }
+
+  SEType::RadiusType radius;
+  radius[0] = 5;
+  radius[1] = 3;
+  radius[2] = 4;
+  std::vector< SEType > kernels;
+  kernels.push_back( SEType::Box( radius ) );
+  radius.Fill( 5 );
+  kernels.push_back( SEType::Polygon( radius, 7 ) );
+
+  const float lowest = itk::NumericTraits< float >::NonpositiveMin();
+  const float highest = itk::NumericTraits< float >::max();
+  bool        success = true;
+  for( unsigned int k = 0; k < kernels.size(); k++ )
+    {
+    // the lines of the polygon may be longer than its radius in total, so
+    // the padding of the requested region is not enough for it
+    const bool checkRegion = k == 0;
+    success &= CheckThreads< itk::AnchorDilateImageFilter< ImageType, SEType > >(
+      image, kernels[k], lowest, checkRegion, "AnchorDilate" );
+    success &= CheckThreads< itk::AnchorErodeImageFilter< ImageType, SEType > >(
+      image, kernels[k], highest, checkRegion, "AnchorErode" );
+    success &= CheckThreads< itk::VanHerkGilWermanDilateImageFilter< ImageType, SEType > >(
+      image, kernels[k], lowest, checkRegion, "VanHerkGilWermanDilate" );
+    success &= CheckThreads< itk::VanHerkGilWermanErodeImageFilter< ImageType, SEType > >(
+      image, kernels[k], highest, checkRegion, "VanHerkGilWermanErode" );
+    }
+
+  if( !success )
+    {
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
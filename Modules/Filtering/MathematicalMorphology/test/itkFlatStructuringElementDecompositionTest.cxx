@@ -0,0 +1,235 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkFlatStructuringElement.h"
+#include "itkGrayscaleDilateImageFilter.h"
+#include "itkGrayscaleMorphologicalOpeningImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+
+const unsigned int Dimension = 2;
+
+typedef itk::FlatStructuringElement< Dimension > SEType;
+
+/* Copy the buffer of the structuring element in a structuring element
+ * which is not decomposable. */
+SEType
+CopyBuffer( const SEType & se )
+{
+  SEType copy;
+  copy.SetRadius( se.GetRadius() );
+  SEType::ConstIterator it = se.Begin();
+  for( SEType::Iterator cit = copy.Begin(); cit != copy.End(); ++cit, ++it )
+    {
+    *cit = *it;
+    }
+  return copy;
+}
+
+bool
+SameBuffer( const SEType & se1, const SEType & se2 )
+{
+  for( unsigned int i = 0; i < se1.Size(); i++ )
+    {
+    if( se1[i] != se2[i] )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+/* Decompose the structuring element, and check that the decomposition is
+ * found when expected and that the buffer is not modified. */
+bool
+CheckDecomposition( const SEType & se, bool expected, const char *name )
+{
+  SEType decomposed = CopyBuffer( se );
+  const bool result = decomposed.ComputeLinesFromBuffer();
+  std::cout << name << ": " << decomposed.GetLines().size() << " lines" << std::endl;
+  if( result != expected || decomposed.GetDecomposable() != expected )
+    {
+    std::cerr << name << ": the decomposition is " << result << ", expected " << expected << std::endl;
+    return false;
+    }
+  if( !SameBuffer( se, decomposed ) )
+    {
+    std::cerr << name << ": the buffer has been modified" << std::endl;
+    return false;
+    }
+  return true;
+}
+
+}
+
+/* Decomposes several structuring elements in lines, and checks that the
+ * grayscale filters use the line based algorithm with the decomposable
+ * ones, with the same result as the basic algorithm, and with the balls
+ * when they are approximated by polygons. */
+int itkFlatStructuringElementDecompositionTest( int, char * [] )
+{
+  SEType::RadiusType radius;
+  radius.Fill( 5 );
+
+  const SEType octagon = SEType::Polygon( radius, 4 );
+  const SEType box = SEType::Box( radius );
+  const SEType ball = SEType::Ball( radius );
+  const SEType cross = SEType::Cross( radius );
+  bool         success = true;
+  success &= CheckDecomposition( octagon, true, "Octagon" );
+  success &= CheckDecomposition( box, true, "Box" );
+  success &= CheckDecomposition( ball, false, "Ball" );
+  success &= CheckDecomposition( cross, false, "Cross" );
+  radius[1] = 2;
+  success &= CheckDecomposition( SEType::Polygon( radius, 2 ), true, "Rectangle" );
+  radius[1] = 5;
+
+  // the balls are only replaced by polygons on request
+  const SEType decomposedBall = SEType::Decompose( ball );
+  const SEType approximatedBall = SEType::Decompose( ball, true );
+  const SEType polygon = SEType::Polygon( radius, 0 );
+  if( decomposedBall.GetDecomposable() || !SameBuffer( ball, decomposedBall ) )
+    {
+    std::cerr << "Ball: the exact decomposition should fail" << std::endl;
+    success = false;
+    }
+  if( !approximatedBall.GetDecomposable() || approximatedBall.GetLines().size() != polygon.GetLines().size()
+      || !SameBuffer( polygon, approximatedBall ) )
+    {
+    std::cerr << "Ball: the approximation should be the polygon of the same radius" << std::endl;
+    success = false;
+    }
+  if( SEType::Decompose( cross, true ).GetDecomposable() )
+    {
+    std::cerr << "Cross: only the balls should be approximated" << std::endl;
+    success = false;
+    }
+  if( !success )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // the grayscale filters with float pixels
+  typedef itk::Image< float, Dimension > ImageType;
+  ImageType::SizeType size;
+  size[0] = 53;
+  size[1] = 41;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+  for(; !it.IsAtEnd(); ++it )
+    {
+    // thin bright lines and dark dots on a ramp, which the openings and the
+    // dilations modify differently depending on the shape of the kernel
+    const ImageType::IndexType index = it.GetIndex();
+    float                      value = 0.37f * index[0] + 0.11f * index[1];
+    if( ( index[0] + 2 * index[1] ) % 9 == 0 )
+      {
+      value += 40.5f;
+      }
+    if( index[0] % 7 == 3 && index[1] % 5 == 1 )
+      {
+      value -= 25.25f;
+      }
+    it.Set( value );
+    }
+
+  const SEType kernel = CopyBuffer( octagon );
+
+  typedef itk::GrayscaleDilateImageFilter< ImageType, ImageType, SEType > DilateType;
+  DilateType::Pointer dilate = DilateType::New();
+  dilate->SetInput( image );
+  dilate->SetKernel( kernel );
+  TEST_SET_GET_VALUE( DilateType::ANCHOR, dilate->GetAlgorithm() );
+  TRY_EXPECT_NO_EXCEPTION( dilate->Update() );
+
+  DilateType::Pointer basicDilate = DilateType::New();
+  basicDilate->SetInput( image );
+  basicDilate->SetKernel( kernel );
+  basicDilate->SetAlgorithm( DilateType::BASIC );
+  TRY_EXPECT_NO_EXCEPTION( basicDilate->Update() );
+
+  typedef itk::GrayscaleMorphologicalOpeningImageFilter< ImageType, ImageType, SEType > OpeningType;
+  OpeningType::Pointer opening = OpeningType::New();
+  opening->SetInput( image );
+  opening->SetKernel( kernel );
+  TEST_SET_GET_VALUE( OpeningType::ANCHOR, opening->GetAlgorithm() );
+  TRY_EXPECT_NO_EXCEPTION( opening->Update() );
+
+  OpeningType::Pointer basicOpening = OpeningType::New();
+  basicOpening->SetInput( image );
+  basicOpening->SetKernel( kernel );
+  basicOpening->SetAlgorithm( OpeningType::BASIC );
+  TRY_EXPECT_NO_EXCEPTION( basicOpening->Update() );
+
+  // a ball gives the same result as the polygon when it is approximated
+  OpeningType::Pointer ballOpening = OpeningType::New();
+  ballOpening->SetInput( image );
+  ballOpening->ApproximateBallsOn();
+  ballOpening->SetKernel( ball );
+  TEST_SET_GET_VALUE( OpeningType::ANCHOR, ballOpening->GetAlgorithm() );
+  TRY_EXPECT_NO_EXCEPTION( ballOpening->Update() );
+
+  OpeningType::Pointer polygonOpening = OpeningType::New();
+  polygonOpening->SetInput( image );
+  polygonOpening->SetKernel( polygon );
+  TRY_EXPECT_NO_EXCEPTION( polygonOpening->Update() );
+
+  itk::ImageRegionConstIterator< ImageType > ait( ballOpening->GetOutput(), image->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< ImageType > pit( polygonOpening->GetOutput(), image->GetLargestPossibleRegion() );
+  for(; !ait.IsAtEnd(); ++ait, ++pit )
+    {
+    if( ait.Get() != pit.Get() )
+      {
+      std::cerr << "The opening by the approximated ball differs from the opening by the polygon" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // the algorithms don't manage the border of the image the same way, so
+  // only the pixels far enough from the border are compared
+  ImageType::RegionType region = image->GetLargestPossibleRegion();
+  region.ShrinkByRadius( 2 * static_cast< itk::OffsetValueType >( kernel.GetRadius()[0] ) );
+  itk::ImageRegionConstIteratorWithIndex< ImageType > rit( image, region );
+  itk::ImageRegionConstIterator< ImageType >          dit( dilate->GetOutput(), region );
+  itk::ImageRegionConstIterator< ImageType >          bdit( basicDilate->GetOutput(), region );
+  itk::ImageRegionConstIterator< ImageType >          oit( opening->GetOutput(), region );
+  itk::ImageRegionConstIterator< ImageType >          boit( basicOpening->GetOutput(), region );
+  for(; !rit.IsAtEnd(); ++rit, ++dit, ++bdit, ++oit, ++boit )
+    {
+    if( dit.Get() != bdit.Get() )
+      {
+      std::cerr << "Dilation mismatch at " << rit.GetIndex() << ": expected " << bdit.Get() << ", got "
+                << dit.Get() << std::endl;
+      return EXIT_FAILURE;
+      }
+    if( oit.Get() != boit.Get() )
+      {
+      std::cerr << "Opening mismatch at " << rit.GetIndex() << ": expected " << boit.Get() << ", got "
+                << oit.Get() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
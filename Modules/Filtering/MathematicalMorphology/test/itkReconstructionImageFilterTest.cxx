@@ -0,0 +1,137 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkReconstructionByDilationImageFilter.h"
+#include "itkReconstructionByErosionImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+
+const unsigned int Dimension = 3;
+
+typedef itk::Image< short, Dimension > ImageType;
+
+/* Runs the filter with several threads and checks the result against the
+ * single threaded version without internal copy. */
+template< typename TFilter >
+bool
+CheckThreads( const ImageType *marker, const ImageType *mask, bool fullyConnected, const char *name )
+{
+  typename TFilter::Pointer reference = TFilter::New();
+  reference->SetMarkerImage( marker );
+  reference->SetMaskImage( mask );
+  reference->SetFullyConnected( fullyConnected );
+  reference->SetUseInternalCopy( false );
+  TRY_EXPECT_NO_EXCEPTION( reference->Update() );
+
+  const itk::ThreadIdType numberOfThreads[] = { 1, 3, 4 };
+  for( unsigned int t = 0; t < 3; t++ )
+    {
+    typename TFilter::Pointer filter = TFilter::New();
+    filter->SetMarkerImage( marker );
+    filter->SetMaskImage( mask );
+    filter->SetFullyConnected( fullyConnected );
+    filter->SetNumberOfThreads( numberOfThreads[t] );
+    TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+    itk::ImageRegionConstIteratorWithIndex< ImageType > rit( reference->GetOutput(),
+      mask->GetLargestPossibleRegion() );
+    itk::ImageRegionConstIterator< ImageType > it( filter->GetOutput(), mask->GetLargestPossibleRegion() );
+    for(; !rit.IsAtEnd(); ++rit, ++it )
+      {
+      if( it.Get() != rit.Get() )
+        {
+        std::cerr << name << " with " << numberOfThreads[t] << " threads: mismatch at " << rit.GetIndex()
+                  << ": expected " << rit.Get() << ", got " << it.Get() << std::endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+}
+
+/* Reconstructs by dilation and by erosion a 3D image with long paths
+ * crossing the image, and checks that the results don't depend on the
+ * number of threads. */
+int itkReconstructionImageFilterTest( int, char * [] )
+{
+  ImageType::IndexType start;
+  start[0] = 3;
+  start[1] = -2;
+  start[2] = 5;
+  ImageType::SizeType size;
+  size[0] = 45;
+  size[1] = 37;
+  size[2] = 29;
+  ImageType::RegionType region( start, size );
+
+  // the mask is a spiral ridge, which the reconstruction follows across the
+  // slabs, with ripples whose regional extrema stop it locally, and the
+  // markers are seeds on a lattice
+  ImageType::Pointer mask = ImageType::New();
+  mask->SetRegions( region );
+  mask->Allocate();
+  ImageType::Pointer lowMarker = ImageType::New();
+  lowMarker->SetRegions( region );
+  lowMarker->Allocate();
+  ImageType::Pointer highMarker = ImageType::New();
+  highMarker->SetRegions( region );
+  highMarker->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > it( mask, region );
+  for(; !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType index = it.GetIndex();
+    const double               angle = 0.4 * index[2];
+    const double               ridge = std::cos( 0.3 * index[0] - std::cos( angle ) )
+      * std::cos( 0.3 * index[1] - std::sin( angle ) );
+    const double ripple = std::sin( 0.9 * index[0] ) * std::sin( 0.7 * index[1] + 0.5 * index[2] );
+    const short  value = static_cast< short >( 100 * ridge + 8 * ripple );
+    it.Set( value );
+    const bool seed = index[0] % 15 == 7 && index[1] % 12 == 5 && index[2] % 9 == 4;
+    lowMarker->SetPixel( index, seed ? value : -200 );
+    highMarker->SetPixel( index, seed ? value : 200 );
+    }
+
+  bool success = true;
+  for( unsigned int fullyConnected = 0; fullyConnected < 2; fullyConnected++ )
+    {
+    success &= CheckThreads< itk::ReconstructionByDilationImageFilter< ImageType, ImageType > >(
+      lowMarker, mask, fullyConnected != 0, "ReconstructionByDilation" );
+    success &= CheckThreads< itk::ReconstructionByErosionImageFilter< ImageType, ImageType > >(
+      highMarker, mask, fullyConnected != 0, "ReconstructionByErosion" );
+    }
+  if( !success )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // the marker must be below the mask
+  typedef itk::ReconstructionByDilationImageFilter< ImageType, ImageType > DilationType;
+  DilationType::Pointer dilation = DilationType::New();
+  dilation->SetMarkerImage( highMarker );
+  dilation->SetMaskImage( mask );
+  dilation->SetNumberOfThreads( 3 );
+  TRY_EXPECT_EXCEPTION( dilation->Update() );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -43,6 +43,11 @@ namespace itk
  * When the Gaussian kernel is small, this filter tends to run faster than
  * itk::RecursiveGaussianImageFilter.
  *
+ * All the directions are filtered in a single multi-threaded pass by
+ * SeparableNeighborhoodOperatorImageFilter, which processes the image by
+ * cache sized tiles and keeps the intermediate results in double
+ * precision.
+ *
  * \sa GaussianOperator
  * \sa Image
  * \sa Neighborhood
@@ -207,10 +212,13 @@ public:
    * The default value is $ImageDimension^2$.
    *
    * This parameter was introduced to reduce the memory used by images
-   * internally, at the cost of performance.
+   * internally, at the cost of performance. It is now ignored: the filter
+   * no longer allocates intermediate images.
+   *
+   * \deprecated The filter does not stream internally anymore.
    */
-  itkSetMacro(InternalNumberOfStreamDivisions, unsigned int);
-  itkGetConstReferenceMacro(InternalNumberOfStreamDivisions, unsigned int);
+  itkLegacyMacro(void SetInternalNumberOfStreamDivisions(unsigned int));
+  itkLegacyMacro(unsigned int GetInternalNumberOfStreamDivisions() const);
 
   /** DiscreteGaussianImageFilter needs a larger input requested region
    * than the output requested region (larger by the size of the
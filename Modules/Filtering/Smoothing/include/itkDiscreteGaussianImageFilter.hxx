@@ -19,11 +19,10 @@
 #define itkDiscreteGaussianImageFilter_hxx
 
 #include "itkDiscreteGaussianImageFilter.h"
-#include "itkNeighborhoodOperatorImageFilter.h"
+#include "itkSeparableNeighborhoodOperatorImageFilter.h"
 #include "itkGaussianOperator.h"
 #include "itkImageRegionIterator.h"
 #include "itkProgressAccumulator.h"
-#include "itkStreamingImageFilter.h"
 
 namespace itk
 {
@@ -122,8 +121,8 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
   output->Allocate();
 
   // Create an internal image to protect the input image's metdata
-  // (e.g. RequestedRegion). The StreamingImageFilter changes the
-  // requested region as part of its normal processing.
+  // (e.g. RequestedRegion). The internal filter changes the requested
+  // region as part of its normal processing.
   typename TInputImage::Pointer localInput = TInputImage::New();
   localInput->Graft( this->GetInput() );
 
@@ -152,58 +151,28 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
     return;
     }
 
-  // Type of the pixel to use for intermediate results
-  typedef typename NumericTraits< OutputPixelType >::RealType RealOutputPixelType;
-  typedef Image< OutputPixelType, ImageDimension >            RealOutputImageType;
+  typedef typename NumericTraits< OutputPixelType >::RealType       RealOutputPixelType;
+  typedef typename NumericTraits< RealOutputPixelType >::ValueType RealOutputPixelValueType;
 
-  typedef typename NumericTraits<RealOutputPixelType>::ValueType RealOutputPixelValueType;
+  // All the directions are filtered by a single filter, which does not
+  // allocate intermediate images
+  typedef SeparableNeighborhoodOperatorImageFilter< InputImageType, OutputImageType,
+                                                    RealOutputPixelValueType > SeparableFilterType;
 
-  // Type definition for the internal neighborhood filter
-  //
-  // First filter convolves and changes type from input type to real type
-  // Middle filters convolves from real to real
-  // Last filter convolves and changes type from real type to output type
-  // Streaming filter forces the mini-pipeline to run in chunks
-
-
-  typedef NeighborhoodOperatorImageFilter< InputImageType,
-                                           RealOutputImageType, RealOutputPixelValueType > FirstFilterType;
-  typedef NeighborhoodOperatorImageFilter< RealOutputImageType,
-                                           RealOutputImageType, RealOutputPixelValueType > IntermediateFilterType;
-  typedef NeighborhoodOperatorImageFilter< RealOutputImageType,
-                                           OutputImageType, RealOutputPixelValueType > LastFilterType;
-  typedef NeighborhoodOperatorImageFilter< InputImageType,
-                                           OutputImageType, RealOutputPixelValueType > SingleFilterType;
-
-  typedef StreamingImageFilter< OutputImageType, OutputImageType >
-  StreamingFilterType;
-
-  typedef typename FirstFilterType::Pointer        FirstFilterPointer;
-  typedef typename IntermediateFilterType::Pointer IntermediateFilterPointer;
-  typedef typename LastFilterType::Pointer         LastFilterPointer;
-  typedef typename SingleFilterType::Pointer       SingleFilterPointer;
-  typedef typename StreamingFilterType::Pointer    StreamingFilterPointer;
-
-  // Create a series of operators
-  typedef GaussianOperator< RealOutputPixelValueType, ImageDimension > OperatorType;
-
-  std::vector< OperatorType > oper;
-  oper.resize(filterDimensionality);
+  typename SeparableFilterType::Pointer separableFilter = SeparableFilterType::New();
+  separableFilter->SetInput(localInput);
+  separableFilter->SetNumberOfThreads( this->GetNumberOfThreads() );
 
   // Create a process accumulator for tracking the progress of minipipeline
   ProgressAccumulator::Pointer progress = ProgressAccumulator::New();
   progress->SetMiniPipelineFilter(this);
+  progress->RegisterInternalFilter(separableFilter, 1.0f);
 
   // Set up the operators
-  unsigned int i;
-  for ( i = 0; i < filterDimensionality; ++i )
+  for ( unsigned int i = 0; i < filterDimensionality; ++i )
     {
-    // we reverse the direction to minimize computation while, because
-    // the largest dimension will be split slice wise for streaming
-    unsigned int reverse_i = filterDimensionality - i - 1;
-
-    // Set up the operator for this dimension
-    oper[reverse_i].SetDirection(i);
+    GaussianOperator< RealOutputPixelValueType, ImageDimension > oper;
+    oper.SetDirection(i);
     if ( m_UseImageSpacing == true )
       {
       if ( localInput->GetSpacing()[i] == 0.0 )
@@ -215,117 +184,54 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
         // convert the variance from physical units to pixels
         double s = localInput->GetSpacing()[i];
         s = s * s;
-        oper[reverse_i].SetVariance(m_Variance[i] / s);
+        oper.SetVariance(m_Variance[i] / s);
         }
       }
     else
       {
-      oper[reverse_i].SetVariance(m_Variance[i]);
+      oper.SetVariance(m_Variance[i]);
       }
 
-    oper[reverse_i].SetMaximumKernelWidth(m_MaximumKernelWidth);
-    oper[reverse_i].SetMaximumError(m_MaximumError[i]);
-    oper[reverse_i].CreateDirectional();
+    oper.SetMaximumKernelWidth(m_MaximumKernelWidth);
+    oper.SetMaximumError(m_MaximumError[i]);
+    oper.CreateDirectional();
+
+    separableFilter->SetOperator(oper);
     }
 
-  // Create a chain of filters
-  //
-  //
+  // Graft this filters output onto the mini-pipeline so the mini-pipeline
+  // has the correct region ivars and will write to this filters bulk data
+  // output.
+  separableFilter->GraftOutput(output);
 
-  if ( filterDimensionality == 1 )
-    {
-    // Use just a single filter
-    SingleFilterPointer singleFilter = SingleFilterType::New();
-    singleFilter->SetOperator(oper[0]);
-    singleFilter->SetInput(localInput);
-    progress->RegisterInternalFilter(singleFilter, 1.0f / m_FilterDimensionality);
-
-    // Graft this filters output onto the mini-pipeline so the mini-pipeline
-    // has the correct region ivars and will write to this filters bulk data
-    // output.
-    singleFilter->GraftOutput(output);
-
-    // Update the filter
-    singleFilter->Update();
-
-    // Graft the last output of the mini-pipeline onto this filters output so
-    // the final output has the correct region ivars and a handle to the final
-    // bulk data
-    this->GraftOutput(output);
-    }
-  else
-    {
-    // Setup a full mini-pipeline and stream the data through the
-    // pipeline.
-    unsigned int numberOfStages = filterDimensionality * this->GetInternalNumberOfStreamDivisions() + 1;
-
-    // First filter convolves and changes type from input type to real type
-    FirstFilterPointer firstFilter = FirstFilterType::New();
-    firstFilter->SetOperator(oper[0]);
-    firstFilter->ReleaseDataFlagOn();
-    firstFilter->SetInput(localInput);
-    progress->RegisterInternalFilter(firstFilter, 1.0f / numberOfStages);
-
-    // Middle filters convolves from real to real
-    std::vector< IntermediateFilterPointer > intermediateFilters;
-    if ( filterDimensionality > 2 )
-      {
-      for ( i = 1; i < filterDimensionality - 1; ++i )
-        {
-        IntermediateFilterPointer f = IntermediateFilterType::New();
-        f->SetOperator(oper[i]);
-        f->ReleaseDataFlagOn();
-        progress->RegisterInternalFilter(f, 1.0f / numberOfStages);
-
-        if ( i == 1 )
-          {
-          f->SetInput( firstFilter->GetOutput() );
-          }
-        else
-          {
-          // note: first filter in vector (zeroth element) is for i==1
-          f->SetInput( intermediateFilters[i - 2]->GetOutput() );
-          }
-
-        intermediateFilters.push_back(f);
-        }
-      }
+  // Update the filter
+  separableFilter->Update();
 
-    // Last filter convolves and changes type from real type to output type
-    LastFilterPointer lastFilter = LastFilterType::New();
-    lastFilter->SetOperator(oper[filterDimensionality - 1]);
-    lastFilter->ReleaseDataFlagOn();
-    if ( filterDimensionality > 2 )
-      {
-      lastFilter->SetInput( intermediateFilters[filterDimensionality - 3]->GetOutput() );
-      }
-    else
-      {
-      lastFilter->SetInput( firstFilter->GetOutput() );
-      }
-    progress->RegisterInternalFilter(lastFilter, 1.0f / numberOfStages);
-
-    // Put in a StreamingImageFilter so the mini-pipeline is processed
-    // in chunks to minimize memory usage
-    StreamingFilterPointer streamingFilter = StreamingFilterType::New();
-    streamingFilter->SetInput( lastFilter->GetOutput() );
-    streamingFilter->SetNumberOfStreamDivisions( this->GetInternalNumberOfStreamDivisions() );
-    progress->RegisterInternalFilter(streamingFilter, 1.0f / numberOfStages);
-
-    // Graft this filters output onto the mini-pipeline so the mini-pipeline
-    // has the correct region ivars and will write to this filters bulk data
-    // output.
-    streamingFilter->GraftOutput(output);
-
-    // Update the last filter in the chain
-    streamingFilter->Update();
-
-    // Graft the last output of the mini-pipeline onto this filters output so
-    // the final output has the correct region ivars and a handle to the final
-    // bulk data
-    this->GraftOutput(output);
-    }
+  // Graft the last output of the mini-pipeline onto this filters output so
+  // the final output has the correct region ivars and a handle to the final
+  // bulk data
+  this->GraftOutput( separableFilter->GetOutput() );
+}
+
+#if !defined( ITK_LEGACY_REMOVE )
+template< typename TInputImage, typename TOutputImage >
+void
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::SetInternalNumberOfStreamDivisions(unsigned int divisions)
+{
+  itkLegacyBodyMacro(DiscreteGaussianImageFilter::SetInternalNumberOfStreamDivisions, 4.10);
+  m_InternalNumberOfStreamDivisions = divisions;
+}
+
+template< typename TInputImage, typename TOutputImage >
+unsigned int
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::GetInternalNumberOfStreamDivisions() const
+{
+  itkLegacyBodyMacro(DiscreteGaussianImageFilter::GetInternalNumberOfStreamDivisions, 4.10);
+  return m_InternalNumberOfStreamDivisions;
 }
+#endif
 
 template< typename TInputImage, typename TOutputImage >
 void
@@ -0,0 +1,122 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSmoothingRecursiveGaussianVectorFieldImageFilter_h
+#define itkSmoothingRecursiveGaussianVectorFieldImageFilter_h
+
+#include "itkRecursiveGaussianImageFilter.h"
+#include "itkImageRegionSplitterDirection.h"
+#include <vector>
+
+namespace itk
+{
+/** \class SmoothingRecursiveGaussianVectorFieldImageFilter
+ * \brief Smooths a vector image along all directions with the recursive
+ * Gaussian filter, all the components at once.
+ *
+ * SmoothingRecursiveGaussianImageFilter smooths a multi-component image
+ * with a pipeline of one RecursiveGaussianImageFilter per direction, each
+ * allocating its own output. This filter is meant for displacement fields
+ * that are smoothed repeatedly, for example at every iteration of a
+ * registration: it runs one multi-threaded pass per direction over a
+ * single image, in place when the input can be overwritten, and keeps its
+ * line buffers between updates. The components of a line are filtered
+ * together by RecursiveSeparableImageFilter::FilterInterleavedDataArray,
+ * so the result matches SmoothingRecursiveGaussianImageFilter.
+ *
+ * The image may be an Image of Vector, CovariantVector or FixedArray
+ * pixels, a VectorImage, or an Image of scalars. Sigma is isotropic and
+ * measured in physical units. The Direction and Order inherited from
+ * RecursiveGaussianImageFilter are not used: every direction is smoothed
+ * and only the zero order is supported.
+ *
+ * \sa SmoothingRecursiveGaussianImageFilter
+ * \sa RecursiveGaussianImageFilter
+ * \ingroup ITKSmoothing
+ */
+template< typename TImage >
+class SmoothingRecursiveGaussianVectorFieldImageFilter:
+  public RecursiveGaussianImageFilter< TImage, TImage >
+{
+public:
+  /** Standard class typedefs. */
+  typedef SmoothingRecursiveGaussianVectorFieldImageFilter Self;
+  typedef RecursiveGaussianImageFilter< TImage, TImage >   Superclass;
+  typedef SmartPointer< Self >                             Pointer;
+  typedef SmartPointer< const Self >                       ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(SmoothingRecursiveGaussianVectorFieldImageFilter, RecursiveGaussianImageFilter);
+
+  /** Image dimension. */
+  itkStaticConstMacro(ImageDimension, unsigned int, TImage::ImageDimension);
+
+  typedef TImage                                     ImageType;
+  typedef typename ImageType::PixelType              PixelType;
+  typedef typename ImageType::RegionType             RegionType;
+  typedef typename Superclass::ScalarRealType        ScalarRealType;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+
+protected:
+  SmoothingRecursiveGaussianVectorFieldImageFilter();
+  virtual ~SmoothingRecursiveGaussianVectorFieldImageFilter() {}
+  void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+  /** Smooth along each direction in turn, with one threaded pass per
+   * direction. */
+  void GenerateData() ITK_OVERRIDE;
+
+  /** Filter the lines of the region along the current direction. */
+  void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                            ThreadIdType threadId) ITK_OVERRIDE;
+
+  /** Never split the regions along the current direction. */
+  virtual const ImageRegionSplitterBase* GetImageRegionSplitter(void) const ITK_OVERRIDE;
+
+  /** The filter needs the whole image along every direction. */
+  void EnlargeOutputRequestedRegion(DataObject *output) ITK_OVERRIDE;
+
+  /** Check that the zero order is selected, in addition to the checks of
+   * the superclass. */
+  virtual void VerifyPreconditions() ITK_OVERRIDE;
+
+private:
+  SmoothingRecursiveGaussianVectorFieldImageFilter(const Self &) ITK_DELETE_FUNCTION;
+  void operator=(const Self &) ITK_DELETE_FUNCTION;
+
+  /** Direction smoothed by the current pass. */
+  unsigned int m_SmoothingDirection;
+
+  /** Image read by the current pass: the input for the first direction,
+   * the output for the following ones. */
+  const ImageType *m_PassInput;
+
+  ImageRegionSplitterDirection::Pointer m_ImageRegionSplitter;
+
+  /** Per-thread line buffers, kept across passes and updates. */
+  std::vector< std::vector< ScalarRealType > > m_ThreadBuffers;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkSmoothingRecursiveGaussianVectorFieldImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,207 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSmoothingRecursiveGaussianVectorFieldImageFilter_hxx
+#define itkSmoothingRecursiveGaussianVectorFieldImageFilter_hxx
+
+#include "itkSmoothingRecursiveGaussianVectorFieldImageFilter.h"
+#include "itkImageLinearIteratorWithIndex.h"
+#include "itkImageLinearConstIteratorWithIndex.h"
+#include "itkDefaultConvertPixelTraits.h"
+#include "itkNumericTraits.h"
+
+namespace itk
+{
+
+template< typename TImage >
+SmoothingRecursiveGaussianVectorFieldImageFilter< TImage >
+::SmoothingRecursiveGaussianVectorFieldImageFilter() :
+  m_SmoothingDirection( 0 ),
+  m_PassInput( ITK_NULLPTR ),
+  m_ImageRegionSplitter( ImageRegionSplitterDirection::New() )
+{
+  this->InPlaceOn();
+}
+
+template< typename TImage >
+void
+SmoothingRecursiveGaussianVectorFieldImageFilter< TImage >
+::VerifyPreconditions()
+{
+  this->Superclass::VerifyPreconditions();
+
+  if( this->GetOrder() != Superclass::ZeroOrder )
+    {
+    itkExceptionMacro( "Only the zero order is supported." );
+    }
+}
+
+template< typename TImage >
+void
+SmoothingRecursiveGaussianVectorFieldImageFilter< TImage >
+::EnlargeOutputRequestedRegion(DataObject *output)
+{
+  ImageType *out = dynamic_cast< ImageType * >( output );
+
+  if ( out )
+    {
+    out->SetRequestedRegionToLargestPossibleRegion();
+    }
+}
+
+template< typename TImage >
+const ImageRegionSplitterBase*
+SmoothingRecursiveGaussianVectorFieldImageFilter< TImage >
+::GetImageRegionSplitter(void) const
+{
+  return this->m_ImageRegionSplitter;
+}
+
+template< typename TImage >
+void
+SmoothingRecursiveGaussianVectorFieldImageFilter< TImage >
+::GenerateData()
+{
+  this->AllocateOutputs();
+
+  ImageType *output = this->GetOutput();
+  const RegionType region = output->GetRequestedRegion();
+
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    if ( region.GetSize(d) < 4 )
+      {
+      itkExceptionMacro(
+        "The number of pixels along direction " << d
+        << " is less than 4. This filter requires a minimum of four pixels along the dimension to be processed.");
+      }
+    }
+
+  const ThreadIdType numberOfThreads = this->GetNumberOfThreads();
+  if ( this->m_ThreadBuffers.size() < numberOfThreads )
+    {
+    this->m_ThreadBuffers.resize(numberOfThreads);
+    }
+
+  typename ImageSource< ImageType >::ThreadStruct str;
+  str.Filter = this;
+
+  this->GetMultiThreader()->SetNumberOfThreads(numberOfThreads);
+  this->GetMultiThreader()->SetSingleMethod(this->ThreaderCallback, &str);
+
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    this->m_SmoothingDirection = d;
+    this->m_ImageRegionSplitter->SetDirection(d);
+    this->m_PassInput = ( d == 0 ) ? this->GetInput() : output;
+
+    this->SetUp( output->GetSpacing()[d] );
+
+    this->GetMultiThreader()->SingleMethodExecute();
+
+    this->UpdateProgress( static_cast< float >( d + 1 ) / ImageDimension );
+    }
+
+  this->m_PassInput = ITK_NULLPTR;
+}
+
+template< typename TImage >
+void
+SmoothingRecursiveGaussianVectorFieldImageFilter< TImage >
+::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId)
+{
+  typedef DefaultConvertPixelTraits< PixelType >      PixelTraits;
+  typedef typename PixelTraits::ComponentType         ComponentType;
+  typedef ImageLinearConstIteratorWithIndex< TImage > InputIteratorType;
+  typedef ImageLinearIteratorWithIndex< TImage >      OutputIteratorType;
+
+  if ( outputRegionForThread.GetNumberOfPixels() == 0 )
+    {
+    return;
+    }
+
+  ImageType *        output = this->GetOutput();
+  const unsigned int direction = this->m_SmoothingDirection;
+
+  InputIteratorType  inputIt(this->m_PassInput, outputRegionForThread);
+  OutputIteratorType outputIt(output, outputRegionForThread);
+  inputIt.SetDirection(direction);
+  outputIt.SetDirection(direction);
+
+  // All the components of a line are filtered together, interleaved as
+  // they are in the pixels.
+  const unsigned int  numberOfComponents = output->GetNumberOfComponentsPerPixel();
+  const SizeValueType ln = outputRegionForThread.GetSize(direction);
+  const SizeValueType numberOfLineValues = ln * numberOfComponents;
+
+  std::vector< ScalarRealType > & buffer = this->m_ThreadBuffers[threadId];
+  if ( buffer.size() < 3 * numberOfLineValues )
+    {
+    buffer.resize(3 * numberOfLineValues);
+    }
+  ScalarRealType *inps = &buffer[0];
+  ScalarRealType *outs = inps + numberOfLineValues;
+  ScalarRealType *scratch = outs + numberOfLineValues;
+
+  PixelType value;
+  NumericTraits< PixelType >::SetLength(value, numberOfComponents);
+
+  inputIt.GoToBegin();
+  outputIt.GoToBegin();
+  while ( !inputIt.IsAtEnd() )
+    {
+    ScalarRealType *in = inps;
+    while ( !inputIt.IsAtEndOfLine() )
+      {
+      const PixelType & pixel = inputIt.Get();
+      for ( unsigned int c = 0; c < numberOfComponents; ++c )
+        {
+        *in++ = static_cast< ScalarRealType >( PixelTraits::GetNthComponent(c, pixel) );
+        }
+      ++inputIt;
+      }
+
+    this->FilterInterleavedDataArray(outs, inps, scratch, ln, numberOfComponents);
+
+    const ScalarRealType *out = outs;
+    while ( !outputIt.IsAtEndOfLine() )
+      {
+      for ( unsigned int c = 0; c < numberOfComponents; ++c )
+        {
+        PixelTraits::SetNthComponent(c, value, static_cast< ComponentType >( *out++ ) );
+        }
+      outputIt.Set(value);
+      ++outputIt;
+      }
+
+    inputIt.NextLine();
+    outputIt.NextLine();
+    }
+}
+
+template< typename TImage >
+void
+SmoothingRecursiveGaussianVectorFieldImageFilter< TImage >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "SmoothingDirection: " << m_SmoothingDirection << std::endl;
+}
+} // end namespace itk
+
+#endif
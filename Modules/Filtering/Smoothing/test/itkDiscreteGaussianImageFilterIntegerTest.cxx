@@ -0,0 +1,159 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkDiscreteGaussianImageFilter.h"
+#include "itkNeighborhoodOperatorImageFilter.h"
+#include "itkGaussianOperator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include <algorithm>
+#include <cstdlib>
+
+/*
+ * DiscreteGaussianImageFilter keeps the intermediate results of the
+ * directional filters in double, and converts to the output pixel type
+ * once.  This test checks that an integer output is the conversion of the
+ * real output, and compares it with the former chain of filters, which
+ * converted each intermediate result to the output pixel type.
+ */
+namespace
+{
+const unsigned int Dimension = 2;
+
+typedef unsigned char                           PixelType;
+typedef itk::Image< PixelType, Dimension >      ImageType;
+typedef itk::Image< double, Dimension >         RealImageType;
+
+const double       Variance = 4.0;
+const double       MaximumError = 0.01;
+const unsigned int MaximumKernelWidth = 32;
+
+template< typename TOutputImage >
+typename TOutputImage::Pointer
+DiscreteGaussian( const ImageType * image )
+{
+  typedef itk::DiscreteGaussianImageFilter< ImageType, TOutputImage > FilterType;
+  typename FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( image );
+  filter->SetVariance( Variance );
+  filter->SetMaximumError( MaximumError );
+  filter->SetMaximumKernelWidth( MaximumKernelWidth );
+  filter->Update();
+  return filter->GetOutput();
+}
+
+ImageType::Pointer
+ChainOfDirectionalFilters( const ImageType * image )
+{
+  typedef itk::NeighborhoodOperatorImageFilter< ImageType, ImageType, double > FilterType;
+
+  ImageType::ConstPointer input = image;
+  ImageType::Pointer      output;
+  for( unsigned int i = 0; i < Dimension; ++i )
+    {
+    itk::GaussianOperator< double, Dimension > oper;
+    oper.SetDirection( i );
+    oper.SetVariance( Variance );
+    oper.SetMaximumError( MaximumError );
+    oper.SetMaximumKernelWidth( MaximumKernelWidth );
+    oper.CreateDirectional();
+
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput( input );
+    filter->SetOperator( oper );
+    filter->Update();
+    output = filter->GetOutput();
+    output->DisconnectPipeline();
+    input = output;
+    }
+  return output;
+}
+}
+
+int itkDiscreteGaussianImageFilterIntegerTest( int, char * [] )
+{
+  ImageType::SizeType size;
+  size[0] = 61;
+  size[1] = 47;
+
+  // Steps, a checkerboard and isolated bright pixels, so that the smoothed
+  // values have fractional parts
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+  for(; !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType & index = it.GetIndex();
+    PixelType value = static_cast< PixelType >( index[0] < 30 ? 40 : 160 );
+    if( index[1] > 20 && ( index[0] + index[1] ) % 2 == 0 )
+      {
+      value = static_cast< PixelType >( value + 51 );
+      }
+    if( index[0] % 13 == 5 && index[1] % 9 == 4 )
+      {
+      value = 255;
+      }
+    it.Set( value );
+    }
+
+  ImageType::Pointer     output = DiscreteGaussian< ImageType >( image );
+  RealImageType::Pointer realOutput = DiscreteGaussian< RealImageType >( image );
+  ImageType::Pointer     chain = ChainOfDirectionalFilters( image );
+
+  unsigned int numberOfConversionErrors = 0;
+  unsigned int numberOfChainDifferences = 0;
+  int          maximumChainDifference = 0;
+
+  itk::ImageRegionConstIteratorWithIndex< ImageType > oIt( output, output->GetLargestPossibleRegion() );
+  for(; !oIt.IsAtEnd(); ++oIt )
+    {
+    const ImageType::IndexType & index = oIt.GetIndex();
+    if( oIt.Get() != static_cast< PixelType >( realOutput->GetPixel( index ) ) )
+      {
+      numberOfConversionErrors++;
+      }
+
+    const int difference = std::abs( static_cast< int >( oIt.Get() ) - static_cast< int >( chain->GetPixel( index ) ) );
+    if( difference > 0 )
+      {
+      numberOfChainDifferences++;
+      }
+    maximumChainDifference = std::max( maximumChainDifference, difference );
+    }
+
+  std::cout << numberOfChainDifferences << " pixels differ from the chain of directional filters, by at most "
+            << maximumChainDifference << std::endl;
+
+  if( numberOfConversionErrors > 0 )
+    {
+    std::cerr << numberOfConversionErrors << " integer pixels are not the conversion of the real output" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The chain truncates Dimension - 1 intermediate results, each by less
+  // than one grey level, which the following directions average
+  if( numberOfChainDifferences == 0 || maximumChainDifference > static_cast< int >( Dimension - 1 ) )
+    {
+    std::cerr << "Expected differences of at most " << Dimension - 1
+              << " grey level with the chain of directional filters" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
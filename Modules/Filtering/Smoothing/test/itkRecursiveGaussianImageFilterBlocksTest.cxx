@@ -0,0 +1,145 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkRecursiveGaussianImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include <algorithm>
+
+/*
+ * RecursiveSeparableImageFilter filters the lines of scalar images by blocks
+ * when the direction is not the first dimension, and one at a time along the
+ * first dimension or for multi-component pixels.  This test filters a volume
+ * along Y and Z, and compares the result with the filtering along X of the
+ * volume whose axes are swapped, and with the filtering of an image of
+ * vectors, which both use the one-line path.
+ */
+namespace
+{
+const unsigned int Dimension = 3;
+
+typedef itk::Image< float, Dimension >                      ImageType;
+typedef itk::Image< itk::Vector< float, 2 >, Dimension >    VectorImageType;
+typedef itk::RecursiveGaussianImageFilter< ImageType, ImageType >             FilterType;
+typedef itk::RecursiveGaussianImageFilter< VectorImageType, VectorImageType > VectorFilterType;
+
+ImageType::IndexType
+SwapAxes( ImageType::IndexType index, unsigned int direction )
+{
+  std::swap( index[0], index[direction] );
+  return index;
+}
+
+ImageType::Pointer
+SwapAxes( const ImageType * image, unsigned int direction )
+{
+  ImageType::SizeType size = image->GetLargestPossibleRegion().GetSize();
+  std::swap( size[0], size[direction] );
+
+  ImageType::Pointer swapped = ImageType::New();
+  swapped->SetRegions( size );
+  swapped->Allocate();
+
+  itk::ImageRegionConstIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+  for(; !it.IsAtEnd(); ++it )
+    {
+    swapped->SetPixel( SwapAxes( it.GetIndex(), direction ), it.Get() );
+    }
+  return swapped;
+}
+
+template< typename TFilter >
+typename TFilter::OutputImageType::Pointer
+Filter( const typename TFilter::InputImageType * image, unsigned int direction,
+        typename TFilter::OrderEnumType order )
+{
+  typename TFilter::Pointer filter = TFilter::New();
+  filter->SetInput( image );
+  filter->SetDirection( direction );
+  filter->SetOrder( order );
+  filter->SetSigma( 2.5 );
+  filter->SetNumberOfThreads( 3 );
+  filter->Update();
+  return filter->GetOutput();
+}
+}
+
+int itkRecursiveGaussianImageFilterBlocksTest( int, char * [] )
+{
+  // A size which is not a multiple of the 16 lines of a block along X
+  ImageType::SizeType size;
+  size[0] = 37;
+  size[1] = 23;
+  size[2] = 29;
+
+  // A ramp with a few bright points, in two components of opposite signs
+  ImageType::Pointer       image = ImageType::New();
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+  vectorImage->SetRegions( size );
+  vectorImage->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+  for(; !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType & index = it.GetIndex();
+    float value = 0.5f * index[0] - 0.25f * index[1] + 0.125f * index[2];
+    if( index[0] % 11 == 3 && index[1] % 7 == 2 && index[2] % 5 == 1 )
+      {
+      value += 100.0f;
+      }
+    it.Set( value );
+
+    VectorImageType::PixelType vector;
+    vector[0] = value;
+    vector[1] = -value;
+    vectorImage->SetPixel( index, vector );
+    }
+
+  const FilterType::OrderEnumType orders[2] = { FilterType::ZeroOrder, FilterType::FirstOrder };
+  for( unsigned int direction = 1; direction < Dimension; direction++ )
+    {
+    for( unsigned int o = 0; o < 2; o++ )
+      {
+      ImageType::Pointer blocks = Filter< FilterType >( image, direction, orders[o] );
+      ImageType::Pointer lines = Filter< FilterType >( SwapAxes( image, direction ), 0, orders[o] );
+      VectorImageType::Pointer vectors = Filter< VectorFilterType >( vectorImage, direction,
+                                                                     static_cast< VectorFilterType::OrderEnumType >( orders[o] ) );
+
+      unsigned int numberOfDifferences = 0;
+      itk::ImageRegionConstIteratorWithIndex< ImageType > bIt( blocks, blocks->GetLargestPossibleRegion() );
+      for(; !bIt.IsAtEnd(); ++bIt )
+        {
+        const VectorImageType::PixelType & vector = vectors->GetPixel( bIt.GetIndex() );
+        if( bIt.Get() != lines->GetPixel( SwapAxes( bIt.GetIndex(), direction ) )
+            || bIt.Get() != vector[0] || -bIt.Get() != vector[1] )
+          {
+          numberOfDifferences++;
+          }
+        }
+      if( numberOfDifferences > 0 )
+        {
+        std::cerr << "Direction " << direction << ", order " << o << ": " << numberOfDifferences
+                  << " pixels differ between the blocks and the lines" << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
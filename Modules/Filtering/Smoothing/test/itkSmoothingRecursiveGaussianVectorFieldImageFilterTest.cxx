@@ -0,0 +1,191 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkSmoothingRecursiveGaussianVectorFieldImageFilter.h"
+#include "itkSmoothingRecursiveGaussianImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkVectorImage.h"
+#include "itkFilterWatcher.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+
+/* Fills a field with a smooth pattern plus a few spikes, so that the
+ * borders and the interior of every line are exercised. */
+template< typename TImage >
+void
+FillField( TImage *image, unsigned int numberOfComponents )
+{
+  typedef itk::ImageRegionIteratorWithIndex< TImage > IteratorType;
+  typedef typename TImage::PixelType                  PixelType;
+  typedef itk::DefaultConvertPixelTraits< PixelType > PixelTraits;
+
+  PixelType value;
+  itk::NumericTraits< PixelType >::SetLength( value, numberOfComponents );
+  IteratorType it( image, image->GetLargestPossibleRegion() );
+  for( ; !it.IsAtEnd(); ++it )
+    {
+    const typename TImage::IndexType index = it.GetIndex();
+    for( unsigned int c = 0; c < numberOfComponents; c++ )
+      {
+      double v = std::sin( 0.3 * ( c + 1 ) * index[0] + 0.2 * index[1] ) + 0.1 * c * index[2];
+      if( ( index[0] + 3 * index[1] + 7 * index[2] + c ) % 23 == 0 )
+        {
+        v += 10.0;
+        }
+      PixelTraits::SetNthComponent( c, value, static_cast< typename PixelTraits::ComponentType >( v ) );
+      }
+    it.Set( value );
+    }
+}
+
+/* Returns the largest difference between the components of two images. */
+template< typename TImage >
+double
+MaximumDifference( const TImage *image1, const TImage *image2, unsigned int numberOfComponents )
+{
+  typedef itk::ImageRegionConstIterator< TImage >                   IteratorType;
+  typedef itk::DefaultConvertPixelTraits< typename TImage::PixelType > PixelTraits;
+
+  double maximumDifference = 0.0;
+  IteratorType it1( image1, image1->GetLargestPossibleRegion() );
+  IteratorType it2( image2, image2->GetLargestPossibleRegion() );
+  for( ; !it1.IsAtEnd(); ++it1, ++it2 )
+    {
+    for( unsigned int c = 0; c < numberOfComponents; c++ )
+      {
+      const double difference = std::abs(
+        static_cast< double >( PixelTraits::GetNthComponent( c, it1.Get() ) )
+        - static_cast< double >( PixelTraits::GetNthComponent( c, it2.Get() ) ) );
+      maximumDifference = std::max( maximumDifference, difference );
+      }
+    }
+  return maximumDifference;
+}
+
+}
+
+/* Smooths an image of vectors and a vector image, in place and not, and
+ * checks the results against SmoothingRecursiveGaussianImageFilter. */
+int itkSmoothingRecursiveGaussianVectorFieldImageFilterTest( int, char * [] )
+{
+  const unsigned int Dimension = 3;
+  const unsigned int NumberOfComponents = 3;
+  const double       tolerance = 1e-4;
+
+  typedef itk::Image< itk::Vector< float, NumberOfComponents >, Dimension > FieldType;
+  typedef itk::VectorImage< float, Dimension >                               VectorImageType;
+
+  typedef itk::SmoothingRecursiveGaussianVectorFieldImageFilter< FieldType >       FieldSmootherType;
+  typedef itk::SmoothingRecursiveGaussianVectorFieldImageFilter< VectorImageType > VectorImageSmootherType;
+  typedef itk::SmoothingRecursiveGaussianImageFilter< FieldType >                  FieldReferenceType;
+  typedef itk::SmoothingRecursiveGaussianImageFilter< VectorImageType >            VectorImageReferenceType;
+
+  FieldType::SizeType size;
+  size[0] = 21;
+  size[1] = 17;
+  size[2] = 12;
+  FieldType::SpacingType spacing;
+  spacing[0] = 1.0;
+  spacing[1] = 0.75;
+  spacing[2] = 2.0;
+  const double sigma = 2.5;
+
+  // Image of vectors
+  FieldType::Pointer field = FieldType::New();
+  field->SetRegions( size );
+  field->SetSpacing( spacing );
+  field->Allocate();
+  FillField< FieldType >( field, NumberOfComponents );
+
+  FieldReferenceType::Pointer fieldReference = FieldReferenceType::New();
+  fieldReference->SetInput( field );
+  fieldReference->SetSigma( sigma );
+  TRY_EXPECT_NO_EXCEPTION( fieldReference->Update() );
+
+  FieldSmootherType::Pointer fieldSmoother = FieldSmootherType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( fieldSmoother, SmoothingRecursiveGaussianVectorFieldImageFilter );
+  FilterWatcher watcher( fieldSmoother, "fieldSmoother" );
+  fieldSmoother->SetInput( field );
+  fieldSmoother->SetSigma( sigma );
+  fieldSmoother->InPlaceOff();
+  TRY_EXPECT_NO_EXCEPTION( fieldSmoother->Update() );
+
+  double difference = MaximumDifference< FieldType >( fieldReference->GetOutput(), fieldSmoother->GetOutput(),
+    NumberOfComponents );
+  if( difference > tolerance )
+    {
+    std::cerr << "Image of vectors: maximum difference " << difference << " exceeds " << tolerance << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // A second update reuses the line buffers and overwrites the input
+  const FieldType::PixelType *fieldBuffer = field->GetBufferPointer();
+  fieldSmoother->InPlaceOn();
+  fieldSmoother->SetNumberOfThreads( 3 );
+  fieldSmoother->Modified();
+  TRY_EXPECT_NO_EXCEPTION( fieldSmoother->Update() );
+  if( fieldSmoother->GetOutput()->GetBufferPointer() != fieldBuffer )
+    {
+    std::cerr << "The filter did not run in place" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  difference = MaximumDifference< FieldType >( fieldReference->GetOutput(), fieldSmoother->GetOutput(),
+    NumberOfComponents );
+  if( difference > tolerance )
+    {
+    std::cerr << "Image of vectors in place: maximum difference " << difference << " exceeds " << tolerance
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Vector image
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  vectorImage->SetRegions( size );
+  vectorImage->SetSpacing( spacing );
+  vectorImage->SetNumberOfComponentsPerPixel( NumberOfComponents + 1 );
+  vectorImage->Allocate();
+  FillField< VectorImageType >( vectorImage, NumberOfComponents + 1 );
+
+  VectorImageReferenceType::Pointer vectorImageReference = VectorImageReferenceType::New();
+  vectorImageReference->SetInput( vectorImage );
+  vectorImageReference->SetSigma( sigma );
+  TRY_EXPECT_NO_EXCEPTION( vectorImageReference->Update() );
+
+  VectorImageSmootherType::Pointer vectorImageSmoother = VectorImageSmootherType::New();
+  vectorImageSmoother->SetInput( vectorImage );
+  vectorImageSmoother->SetSigma( sigma );
+  TRY_EXPECT_NO_EXCEPTION( vectorImageSmoother->Update() );
+
+  difference = MaximumDifference< VectorImageType >( vectorImageReference->GetOutput(),
+    vectorImageSmoother->GetOutput(), NumberOfComponents + 1 );
+  if( difference > tolerance )
+    {
+    std::cerr << "Vector image: maximum difference " << difference << " exceeds " << tolerance << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Derivatives are not supported
+  fieldSmoother->SetFirstOrder();
+  TRY_EXPECT_EXCEPTION( fieldSmoother->Update() );
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -39,7 +39,8 @@ namespace itk
  * independently in each dimension.
  *
  * When the Gaussian kernel is small, this filter tends to run faster than
- * itk::RecursiveGaussianImageFilter.
+ * itk::RecursiveGaussianImageFilter. All the directions are filtered in a
+ * single pass by SeparableNeighborhoodOperatorImageFilter.
  *
  * \author Ivan Macia, VICOMTech, Spain, http://www.vicomtech.es
  *
@@ -128,10 +129,13 @@ public:
    * The default value is $ImageDimension^2$.
    *
    * This parameter was introduced to reduce the memory used by images
-   * internally, at the cost of performance.
+   * internally, at the cost of performance. It is now ignored: the filter
+   * no longer allocates intermediate images.
+   *
+   * \deprecated The filter does not stream internally anymore.
    */
-  itkSetMacro(InternalNumberOfStreamDivisions, unsigned int);
-  itkGetConstMacro(InternalNumberOfStreamDivisions, unsigned int);
+  itkLegacyMacro(void SetInternalNumberOfStreamDivisions(unsigned int));
+  itkLegacyMacro(unsigned int GetInternalNumberOfStreamDivisions() const);
 
   /** Convenience Set methods for setting all dimensional parameters
    *  to the same values.
@@ -0,0 +1,201 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkHierarchicalQueue_h
+#define itkHierarchicalQueue_h
+
+#include "itkNumericTraits.h"
+#include <map>
+#include <queue>
+#include <vector>
+
+namespace itk
+{
+/** \class HierarchicalQueue
+ * \brief A queue of values ordered by priority, and in FIFO order for the
+ * values with the same priority.
+ *
+ * The values with the lowest priority are the first to come out of the
+ * queue. This is the hierarchical queue (FAH, File d'Attente Hierarchique)
+ * used by the flooding algorithms of the morphological watershed.
+ *
+ * For the integer priority types of 8 or 16 bits, the queue is an array of
+ * FIFOs indexed by the priority, which avoids the cost of the map lookup
+ * for each value. The FIFOs are released as soon as they are emptied. For
+ * the other priority types, the queue is a map of FIFOs.
+ *
+ * \sa MorphologicalWatershedFromMarkersImageFilter
+ * \ingroup ITKReview
+ */
+template< typename TPriority, typename TValue,
+          bool VUseArray = ( NumericTraits< TPriority >::is_integer && sizeof( TPriority ) <= 2 ) >
+class HierarchicalQueue
+{
+public:
+  typedef TPriority PriorityType;
+  typedef TValue    ValueType;
+
+  HierarchicalQueue() : m_Size(0) {}
+
+  bool Empty() const
+  {
+    return m_Size == 0;
+  }
+
+  SizeValueType Size() const
+  {
+    return m_Size;
+  }
+
+  void Push(const PriorityType & priority, const ValueType & value)
+  {
+    m_Levels[priority].push(value);
+    ++m_Size;
+  }
+
+  /** The lowest priority in the queue. The queue must not be empty. */
+  PriorityType FrontPriority() const
+  {
+    return m_Levels.begin()->first;
+  }
+
+  /** The first value with the lowest priority in the queue. The queue must
+   * not be empty. */
+  const ValueType & Front() const
+  {
+    return m_Levels.begin()->second.front();
+  }
+
+  void Pop()
+  {
+    typename LevelMapType::iterator it = m_Levels.begin();
+    it->second.pop();
+    --m_Size;
+    if ( it->second.empty() )
+      {
+      m_Levels.erase(it);
+      }
+  }
+
+private:
+  typedef std::map< PriorityType, std::queue< ValueType > > LevelMapType;
+
+  LevelMapType  m_Levels;
+  SizeValueType m_Size;
+};
+
+/** The hierarchical queue for the integer priority types of 8 or 16 bits.
+ * \ingroup ITKReview
+ */
+template< typename TPriority, typename TValue >
+class HierarchicalQueue< TPriority, TValue, true >
+{
+public:
+  typedef TPriority PriorityType;
+  typedef TValue    ValueType;
+
+  HierarchicalQueue() :
+    m_Levels( SizeValueType(1) << ( 8 * sizeof( PriorityType ) ) ),
+    m_Current( m_Levels.size() ),
+    m_Size(0)
+  {}
+
+  bool Empty() const
+  {
+    return m_Size == 0;
+  }
+
+  SizeValueType Size() const
+  {
+    return m_Size;
+  }
+
+  void Push(const PriorityType & priority, const ValueType & value)
+  {
+    const SizeValueType level = LevelOf(priority);
+
+    m_Levels[level].m_Values.push_back(value);
+    if ( level < m_Current )
+      {
+      m_Current = level;
+      }
+    ++m_Size;
+  }
+
+  /** The lowest priority in the queue. The queue must not be empty. */
+  PriorityType FrontPriority() const
+  {
+    return static_cast< PriorityType >( static_cast< OffsetValueType >( m_Current )
+                                        + static_cast< OffsetValueType >( NumericTraits< PriorityType >::NonpositiveMin() ) );
+  }
+
+  /** The first value with the lowest priority in the queue. The queue must
+   * not be empty. */
+  const ValueType & Front() const
+  {
+    const Level & level = m_Levels[m_Current];
+
+    return level.m_Values[level.m_Head];
+  }
+
+  void Pop()
+  {
+    Level & level = m_Levels[m_Current];
+
+    ++level.m_Head;
+    --m_Size;
+    if ( level.m_Head == level.m_Values.size() )
+      {
+      // release the memory of the level, and find the next one
+      std::vector< ValueType >().swap(level.m_Values);
+      level.m_Head = 0;
+      if ( m_Size == 0 )
+        {
+        m_Current = m_Levels.size();
+        }
+      else
+        {
+        while ( m_Levels[m_Current].m_Values.empty() )
+          {
+          ++m_Current;
+          }
+        }
+      }
+  }
+
+private:
+  struct Level {
+    Level() : m_Head(0) {}
+
+    std::vector< ValueType > m_Values;
+    SizeValueType            m_Head;
+  };
+
+  static SizeValueType LevelOf(const PriorityType & priority)
+  {
+    return static_cast< SizeValueType >(
+      static_cast< OffsetValueType >( priority )
+      - static_cast< OffsetValueType >( NumericTraits< PriorityType >::NonpositiveMin() ) );
+  }
+
+  std::vector< Level > m_Levels;
+  SizeValueType        m_Current;
+  SizeValueType        m_Size;
+};
+} // end namespace itk
+
+#endif
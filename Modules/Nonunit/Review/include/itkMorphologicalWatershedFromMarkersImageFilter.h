@@ -19,6 +19,7 @@
 #define itkMorphologicalWatershedFromMarkersImageFilter_h
 
 #include "itkImageToImageFilter.h"
+#include "itkHierarchicalQueue.h"
 
 namespace itk
 {
@@ -63,6 +64,12 @@ namespace itk
  * Chapter 9.2 of Pierre Soille's book "Morphological Image Analysis:
  * Principles and Applications", Second Edition, Springer, 2003.
  *
+ * The initialization of the output and of the hierarchical queue is done
+ * by several threads. The flooding itself is done by a single thread, in
+ * the same order whatever the number of threads, so the result doesn't
+ * depend on the number of threads. With the input images of 8 or 16 bits,
+ * the hierarchical queue is an array indexed by the gray levels.
+ *
  * This code was contributed in the Insight Journal paper:
  * "The watershed transform in ITK - discussion and new developments"
  * by Beare R., Lehmann G.
@@ -172,16 +179,39 @@ protected:
    * \sa ProcessObject::EnlargeOutputRequestedRegion() */
   void EnlargeOutputRequestedRegion( DataObject *itkNotUsed(output) ) ITK_OVERRIDE;
 
-  /** The filter is single threaded. */
-  void GenerateData() ITK_OVERRIDE;
+  void BeforeThreadedGenerateData() ITK_OVERRIDE;
+
+  /** Initialize the output, and find the pixels of the region to put in
+   * the hierarchical queue. */
+  void ThreadedGenerateData(const LabelImageRegionType & outputRegionForThread,
+                            ThreadIdType threadId) ITK_OVERRIDE;
+
+  /** The flooding is single threaded. */
+  void AfterThreadedGenerateData() ITK_OVERRIDE;
 
 private:
   MorphologicalWatershedFromMarkersImageFilter(const Self &) ITK_DELETE_FUNCTION;
   void operator=(const Self &) ITK_DELETE_FUNCTION;
 
+  typedef Image< bool, ImageDimension >                             StatusImageType;
+  typedef HierarchicalQueue< InputImagePixelType, OffsetValueType > QueueType;
+  typedef typename LabelImageType::OffsetType                       OffsetType;
+
   bool m_FullyConnected;
 
   bool m_MarkWatershedLine;
+
+  /** The neighbors, in the order of the shaped neighborhood iterators,
+   * and their offsets in the buffer. */
+  std::vector< OffsetType >      m_NeighborOffsets;
+  std::vector< OffsetValueType > m_NeighborBufferOffsets;
+
+  /** The pixels put in the queue by each thread, in raster order. */
+  std::vector< std::vector< OffsetValueType > > m_ThreadSeeds;
+
+  /** The pixels already processed or in the queue, with watershed
+   * lines. */
+  typename StatusImageType::Pointer m_StatusImage;
 }; // end of class
 } // end namespace itk
 
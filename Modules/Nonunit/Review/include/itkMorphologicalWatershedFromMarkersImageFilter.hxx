@@ -18,17 +18,9 @@
 #ifndef itkMorphologicalWatershedFromMarkersImageFilter_hxx
 #define itkMorphologicalWatershedFromMarkersImageFilter_hxx
 
-#include <algorithm>
-#include <queue>
-#include <list>
 #include "itkMorphologicalWatershedFromMarkersImageFilter.h"
 #include "itkProgressReporter.h"
-#include "itkImageRegionIterator.h"
 #include "itkImageRegionConstIteratorWithIndex.h"
-#include "itkConstShapedNeighborhoodIterator.h"
-#include "itkConstantBoundaryCondition.h"
-#include "itkSize.h"
-#include "itkConnectedComponentAlgorithm.h"
 
 /*
  * This code was contributed in the Insight Journal paper:
@@ -87,252 +79,283 @@ MorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >
 template< typename TInputImage, typename TLabelImage >
 void
 MorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >
-::GenerateData()
+::BeforeThreadedGenerateData()
 {
   // there is 2 possible cases: with or without watershed lines.
   // the algorithm with watershed lines is from Meyer
   // the algorithm without watershed lines is from beucher
   // The 2 algorithms are very similar and so are integrated in the same filter.
 
-  //---------------------------------------------------------------------------
-  // declare the vars common to the 2 algorithms: constants, iterators,
-  // hierarchical queue, progress reporter, and status image
-  // also allocate output images and verify preconditions
-  //---------------------------------------------------------------------------
-
-  // the label used to find background in the marker image
-  static LabelImagePixelType bgLabel =
-    NumericTraits< LabelImagePixelType >::ZeroValue();
-  // the label used to mark the watershed line in the output image
-  static LabelImagePixelType wsLabel =
-    NumericTraits< LabelImagePixelType >::ZeroValue();
-
-  this->AllocateOutputs();
-
-  LabelImageConstPointer markerImage = this->GetMarkerImage();
-  InputImageConstPointer inputImage = this->GetInput();
-  LabelImagePointer      outputImage = this->GetOutput();
-
-  // Set up the progress reporter
-  // we can't found the exact number of pixel to process in the 2nd pass, so we
-  // use the maximum number possible.
-  ProgressReporter
-  progress(this, 0, markerImage->GetRequestedRegion().GetNumberOfPixels() * 2);
-
   // mask and marker must have the same size
-  if ( markerImage->GetRequestedRegion().GetSize() != inputImage->GetRequestedRegion().GetSize() )
+  if ( this->GetMarkerImage()->GetRequestedRegion().GetSize() != this->GetInput()->GetRequestedRegion().GetSize() )
     {
     itkExceptionMacro(<< "Marker and input must have the same size.");
     }
 
-  // FAH (in french: File d'Attente Hierarchique)
-  typedef std::queue< IndexType >                    QueueType;
-  typedef std::map< InputImagePixelType, QueueType > MapType;
-  MapType fah;
-
-  // the radius which will be used for all the shaped iterators
-  Size< ImageDimension > radius;
-  radius.Fill(1);
-
-  // iterator for the marker image
-  typedef ConstShapedNeighborhoodIterator< LabelImageType > MarkerIteratorType;
-  typename MarkerIteratorType::ConstIterator nmIt;
-  MarkerIteratorType
-  markerIt( radius, markerImage, markerImage->GetRequestedRegion() );
-  // add a boundary constant to avoid adding pixels on the border in the fah
-  ConstantBoundaryCondition< LabelImageType > lcbc;
-  lcbc.SetConstant( NumericTraits< LabelImagePixelType >::max() );
-  markerIt.OverrideBoundaryCondition(&lcbc);
-  setConnectivity(&markerIt, m_FullyConnected);
-
-  // iterator for the input image
-  typedef ConstShapedNeighborhoodIterator< InputImageType > InputIteratorType;
-  InputIteratorType
-  inputIt( radius, inputImage, inputImage->GetRequestedRegion() );
-  typename InputIteratorType::ConstIterator niIt;
-  setConnectivity(&inputIt, m_FullyConnected);
-
-  // iterator for the output image
-  typedef ShapedNeighborhoodIterator< LabelImageType > OutputIteratorType;
-  typedef typename OutputIteratorType::OffsetType      OffsetType;
-  typename OutputIteratorType::Iterator noIt;
-  OutputIteratorType
-  outputIt( radius, outputImage, outputImage->GetRequestedRegion() );
-  setConnectivity(&outputIt, m_FullyConnected);
-
-  //---------------------------------------------------------------------------
-  // Meyer's algorithm
-  //---------------------------------------------------------------------------
-  if ( m_MarkWatershedLine )
+  // the neighbors, in the order of the shaped neighborhood iterators
+  // configured with setConnectivity(), so the pixels are put in the
+  // hierarchical queue in the same order
+  m_NeighborOffsets.clear();
+  m_NeighborBufferOffsets.clear();
+  const OffsetValueType *offsetTable = this->GetOutput()->GetOffsetTable();
+  OffsetType offset;
+  offset.Fill(-1);
+  bool done = false;
+  while ( !done )
     {
-    // first stage:
-    //  - set markers pixels to already processed status
-    //  - copy markers pixels to output image
-    //  - init FAH with indexes of background pixels with marker pixel(s) in
-    //    their neighborhood
-
-    ConstantBoundaryCondition< LabelImageType > lcbc2;
-    // outside pixel are watershed so they won't be use to find real watershed
-    // pixels
-    lcbc2.SetConstant(wsLabel);
-    outputIt.OverrideBoundaryCondition(&lcbc2);
-
-    // create a temporary image to store the state of each pixel (processed or
-    // not)
-    typedef Image< bool, ImageDimension > StatusImageType;
-    typename StatusImageType::Pointer statusImage = StatusImageType::New();
-    statusImage->SetRegions( markerImage->GetLargestPossibleRegion() );
-    statusImage->Allocate();
-
-    // iterator for the status image
-    typedef ShapedNeighborhoodIterator< StatusImageType > StatusIteratorType;
-    typename StatusIteratorType::Iterator nsIt;
-    StatusIteratorType
-                                                 statusIt( radius, statusImage, outputImage->GetRequestedRegion() );
-    ConstantBoundaryCondition< StatusImageType > bcbc;
-    bcbc.SetConstant(true);    // outside pixel are already processed
-    statusIt.OverrideBoundaryCondition(&bcbc);
-    setConnectivity(&statusIt, m_FullyConnected);
-
-    // the status image must be initialized before the first stage. In the
-    // first stage, the set to true are the neighbors of the marker (and the
-    // marker) so it's difficult (impossible ?) to init the status image at
-    // the same time
-    // the overhead should be small
-    statusImage->FillBuffer(false);
-
-    for ( markerIt.GoToBegin(), statusIt.GoToBegin(), outputIt.GoToBegin(), inputIt.GoToBegin();
-          !markerIt.IsAtEnd();
-          ++markerIt, ++outputIt )
+    unsigned int numberOfNonZero = 0;
+    OffsetValueType bufferOffset = 0;
+    for ( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      bufferOffset += offset[d] * offsetTable[d];
+      if ( offset[d] != 0 )
+        {
+        numberOfNonZero++;
+        }
+      }
+    if ( numberOfNonZero == 1 || ( numberOfNonZero > 1 && m_FullyConnected ) )
+      {
+      m_NeighborOffsets.push_back(offset);
+      m_NeighborBufferOffsets.push_back(bufferOffset);
+      }
+    // next offset
+    done = true;
+    for ( unsigned int d = 0; d < ImageDimension && done; d++ )
       {
-      LabelImagePixelType markerPixel = markerIt.GetCenterPixel();
-      if ( markerPixel != bgLabel )
+      if ( offset[d] < 1 )
+        {
+        offset[d]++;
+        done = false;
+        }
+      else
         {
-        IndexType idx = markerIt.GetIndex();
+        offset[d] = -1;
+        }
+      }
+    }
 
-        // move the iterators to the right place
-        OffsetType shift = idx - statusIt.GetIndex();
-        statusIt += shift;
-        inputIt += shift;
+  m_ThreadSeeds.clear();
+  m_ThreadSeeds.resize( this->GetNumberOfThreads() );
 
-        // this pixel belongs to a marker
-        // mark it as already processed
-        statusIt.SetCenterPixel(true);
-        // copy it to the output image
-        outputIt.SetCenterPixel(markerPixel);
-        // and increase progress because this pixel will not be used in the
-        // flooding stage.
-        progress.CompletedPixel();
+  if ( m_MarkWatershedLine )
+    {
+    // create a temporary image to store the state of each pixel (processed
+    // or not)
+    m_StatusImage = StatusImageType::New();
+    m_StatusImage->SetRegions( this->GetOutput()->GetBufferedRegion() );
+    m_StatusImage->Allocate();
+    }
+}
 
+template< typename TInputImage, typename TLabelImage >
+void
+MorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >
+::ThreadedGenerateData(const LabelImageRegionType & outputRegionForThread,
+                       ThreadIdType threadId)
+{
+  // the label used to find background in the marker image
+  const LabelImagePixelType bgLabel = NumericTraits< LabelImagePixelType >::ZeroValue();
+  // the label used to mark the watershed line in the output image
+  const LabelImagePixelType wsLabel = NumericTraits< LabelImagePixelType >::ZeroValue();
+
+  const LabelImageType *markerImage = this->GetMarkerImage();
+  LabelImageType       *outputImage = this->GetOutput();
+
+  const LabelImagePixelType *marker = markerImage->GetBufferPointer();
+  LabelImagePixelType       *output = outputImage->GetBufferPointer();
+
+  // the pixels in this region have all their neighbors in the image
+  const LabelImageRegionType & region = outputImage->GetBufferedRegion();
+  LabelImageRegionType         interior = region;
+  interior.ShrinkByRadius(1);
+
+  std::vector< OffsetValueType > & seeds = m_ThreadSeeds[threadId];
+  const unsigned int               numberOfNeighbors = m_NeighborOffsets.size();
+
+  ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels(), 100, 0.0f, 0.5f);
+
+  // first stage:
+  //  - copy markers pixels to output image
+  //  - with watershed lines, set markers pixels to already processed status
+  //    and find the background pixels with marker pixel(s) in their
+  //    neighborhood
+  //  - without watershed lines, find the marker pixels with background
+  //    pixel(s) in their neighborhood
+  // the pixels to put in the hierarchical queue are stored in raster order,
+  // and put in the queue by AfterThreadedGenerateData()
+  for ( ImageRegionConstIteratorWithIndex< LabelImageType > markerIt(markerImage, outputRegionForThread);
+        !markerIt.IsAtEnd(); ++markerIt )
+    {
+    const IndexType       idx = markerIt.GetIndex();
+    const OffsetValueType p = outputImage->ComputeOffset(idx);
+    const LabelImagePixelType markerPixel = marker[p];
+    if ( markerPixel != bgLabel )
+      {
+      // this pixel belongs to a marker
+      // copy it to the output image
+      output[p] = markerPixel;
+      const bool isInterior = interior.IsInside(idx);
+      if ( m_MarkWatershedLine )
+        {
+        // mark it as already processed
+        m_StatusImage->GetBufferPointer()[p] = true;
         // search the background pixels in the neighborhood
-        for ( nmIt = markerIt.Begin(), nsIt = statusIt.Begin(), niIt = inputIt.Begin();
-              nmIt != markerIt.End();
-              nmIt++, nsIt++, niIt++ )
+        for ( unsigned int i = 0; i < numberOfNeighbors; i++ )
           {
-          if ( !nsIt.Get() && nmIt.Get() == bgLabel )
+          if ( ( isInterior || region.IsInside(idx + m_NeighborOffsets[i]) )
+               && marker[p + m_NeighborBufferOffsets[i]] == bgLabel )
             {
-            // this neighbor is a background pixel and is not already
-            // processed; add its index to fah
-            fah[niIt.Get()].push( markerIt.GetIndex()
-                                  + nmIt.GetNeighborhoodOffset() );
-            // mark it as already in the fah to avoid adding it several times
-            nsIt.Set(true);
+            seeds.push_back(p + m_NeighborBufferOffsets[i]);
             }
           }
         }
       else
         {
-        // Some pixels may be never processed so, by default, non marked pixels
-        // must be marked as watershed
-        outputIt.SetCenterPixel(wsLabel);
+        // search if it has background pixel in its neighborhood
+        for ( unsigned int i = 0; i < numberOfNeighbors; i++ )
+          {
+          if ( ( isInterior || region.IsInside(idx + m_NeighborOffsets[i]) )
+               && marker[p + m_NeighborBufferOffsets[i]] == bgLabel )
+            {
+            seeds.push_back(p);
+            break;
+            }
+          }
+        }
+      }
+    else
+      {
+      // Some pixels may be never processed so, by default, non marked pixels
+      // must be marked as watershed
+      output[p] = wsLabel;
+      if ( m_MarkWatershedLine )
+        {
+        m_StatusImage->GetBufferPointer()[p] = false;
         }
-      // one more pixel done in the init stage
-      progress.CompletedPixel();
       }
-    // fill the borders of the status image with "true"
-    //FillSides<StatusImageType>(statusImage, true);
-    // Now disable the boundary checks
-    //outputIt.NeedToUseBoundaryConditionOff();
-    //statusIt.NeedToUseBoundaryConditionOff();
-    //inputIt.NeedToUseBoundaryConditionOff();
-    // end of init stage
-
-    // flooding
-    // init all the iterators
-    outputIt.GoToBegin();
-    statusIt.GoToBegin();
-    inputIt.GoToBegin();
+    progress.CompletedPixel();
+    }
+}
 
-    // and start flooding
-    while ( !fah.empty() )
+template< typename TInputImage, typename TLabelImage >
+void
+MorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >
+::AfterThreadedGenerateData()
+{
+  // the label used to mark the watershed line in the output image
+  const LabelImagePixelType wsLabel = NumericTraits< LabelImagePixelType >::ZeroValue();
+
+  LabelImageType *outputImage = this->GetOutput();
+
+  const InputImagePixelType *input = this->GetInput()->GetBufferPointer();
+  LabelImagePixelType       *output = outputImage->GetBufferPointer();
+
+  // the pixels in this region have all their neighbors in the image
+  const LabelImageRegionType & region = outputImage->GetBufferedRegion();
+  LabelImageRegionType         interior = region;
+  interior.ShrinkByRadius(1);
+
+  const unsigned int numberOfNeighbors = m_NeighborOffsets.size();
+
+  // we can't found the exact number of pixel to process in the flooding
+  // stage, so we use the maximum number possible.
+  ProgressReporter progress(this, 0, region.GetNumberOfPixels(), 100, 0.5f, 0.5f);
+
+  // FAH (in french: File d'Attente Hierarchique)
+  QueueType fah;
+
+  //---------------------------------------------------------------------------
+  // Meyer's algorithm
+  //---------------------------------------------------------------------------
+  if ( m_MarkWatershedLine )
+    {
+    bool *status = m_StatusImage->GetBufferPointer();
+
+    // init FAH with the background pixels found by the threads, in the
+    // raster order of the marker pixels, and mark them as already in the
+    // fah to avoid adding them several times
+    for ( unsigned int t = 0; t < m_ThreadSeeds.size(); t++ )
       {
-      // store the current vars
-      InputImagePixelType currentValue = fah.begin()->first;
-      QueueType           currentQueue = fah.begin()->second;
-      // and remove them from the fah
-      fah.erase( fah.begin() );
+      for ( typename std::vector< OffsetValueType >::const_iterator sIt = m_ThreadSeeds[t].begin();
+            sIt != m_ThreadSeeds[t].end(); ++sIt )
+        {
+        if ( !status[*sIt] )
+          {
+          fah.Push(input[*sIt], *sIt);
+          status[*sIt] = true;
+          }
+        }
+      }
+    m_ThreadSeeds.clear();
 
-      while ( !currentQueue.empty() )
+    // and start flooding
+    while ( !fah.Empty() )
+      {
+      const InputImagePixelType currentValue = fah.FrontPriority();
+      const OffsetValueType     p = fah.Front();
+      fah.Pop();
+
+      const IndexType idx = outputImage->ComputeIndex(p);
+      const bool      isInterior = interior.IsInside(idx);
+
+      // iterate over the neighbors. If there is only one marker value, give
+      // that value to the pixel, else keep it as is (watershed line).
+      // outside pixels are watershed so they are not used.
+      LabelImagePixelType marker = wsLabel;
+      bool                collision = false;
+      for ( unsigned int i = 0; i < numberOfNeighbors; i++ )
         {
-        IndexType idx = currentQueue.front();
-        currentQueue.pop();
-
-        // move the iterators to the right place
-        OffsetType shift = idx - outputIt.GetIndex();
-        outputIt += shift;
-        statusIt += shift;
-        inputIt += shift;
-
-        // iterate over the neighbors. If there is only one marker value, give
-        // that value to the pixel, else keep it as is (watershed line)
-        LabelImagePixelType marker = wsLabel;
-        bool                collision = false;
-        for ( noIt = outputIt.Begin(); noIt != outputIt.End(); noIt++ )
+        if ( !isInterior && !region.IsInside(idx + m_NeighborOffsets[i]) )
+          {
+          continue;
+          }
+        const LabelImagePixelType o = output[p + m_NeighborBufferOffsets[i]];
+        if ( o != wsLabel )
           {
-          LabelImagePixelType o = noIt.Get();
-          if ( o != wsLabel )
+          if ( marker != wsLabel && o != marker )
             {
-            if ( marker != wsLabel && o != marker )
-              {
-              collision = true;
-              break;
-              }
-            else
-                  { marker = o; }
+            collision = true;
+            break;
+            }
+          else
+            {
+            marker = o;
             }
           }
-        if ( !collision )
+        }
+      if ( !collision )
+        {
+        // set the marker value
+        output[p] = marker;
+        // and propagate to the neighbors
+        for ( unsigned int i = 0; i < numberOfNeighbors; i++ )
           {
-          // set the marker value
-          outputIt.SetCenterPixel(marker);
-          // and propagate to the neighbors
-          for ( niIt = inputIt.Begin(), nsIt = statusIt.Begin();
-                niIt != inputIt.End();
-                niIt++, nsIt++ )
+          if ( !isInterior && !region.IsInside(idx + m_NeighborOffsets[i]) )
             {
-            if ( !nsIt.Get() )
+            continue;
+            }
+          const OffsetValueType n = p + m_NeighborBufferOffsets[i];
+          if ( !status[n] )
+            {
+            // the pixel is not yet processed. add it to the fah
+            const InputImagePixelType GrayVal = input[n];
+            if ( GrayVal <= currentValue )
+              {
+              fah.Push(currentValue, n);
+              }
+            else
               {
-              // the pixel is not yet processed. add it to the fah
-              InputImagePixelType GrayVal = niIt.Get();
-              if ( GrayVal <= currentValue )
-                {
-                currentQueue.push( inputIt.GetIndex()
-                                   + niIt.GetNeighborhoodOffset() );
-                }
-              else
-                {
-                fah[GrayVal].push( inputIt.GetIndex()
-                                   + niIt.GetNeighborhoodOffset() );
-                }
-              // mark it as already in the fah
-              nsIt.Set(true);
+              fah.Push(GrayVal, n);
               }
+            // mark it as already in the fah
+            status[n] = true;
             }
           }
-        // one more pixel in the flooding stage
-        progress.CompletedPixel();
         }
+      // one more pixel in the flooding stage
+      progress.CompletedPixel();
       }
+    m_StatusImage = ITK_NULLPTR;
     }
 
   //---------------------------------------------------------------------------
@@ -340,110 +363,52 @@ MorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >
   //---------------------------------------------------------------------------
   else
     {
-    // first stage:
-    //  - copy markers pixels to output image
-    //  - init FAH with indexes of pixels with background pixel in their
-    //    neighborhood
-
-    ConstantBoundaryCondition< LabelImageType > lcbc2;
-    // outside pixel are watershed so they won't be use to find real watershed
-    // pixels
-    lcbc2.SetConstant( NumericTraits< LabelImagePixelType >::max() );
-    outputIt.OverrideBoundaryCondition(&lcbc2);
-
-    for ( markerIt.GoToBegin(), outputIt.GoToBegin(), inputIt.GoToBegin();
-          !markerIt.IsAtEnd();
-          ++markerIt, ++outputIt )
+    // init FAH with the marker pixels with background pixel in their
+    // neighborhood found by the threads, in raster order
+    for ( unsigned int t = 0; t < m_ThreadSeeds.size(); t++ )
       {
-      LabelImagePixelType markerPixel = markerIt.GetCenterPixel();
-      if ( markerPixel != bgLabel )
-        {
-        IndexType  idx = markerIt.GetIndex();
-        OffsetType shift = idx - inputIt.GetIndex();
-        inputIt += shift;
-
-        // this pixels belongs to a marker
-        // copy it to the output image
-        outputIt.SetCenterPixel(markerPixel);
-        // search if it has background pixel in its neighborhood
-        bool haveBgNeighbor = false;
-        for ( nmIt = markerIt.Begin(); nmIt != markerIt.End(); nmIt++ )
-          {
-          if ( nmIt.Get() == bgLabel )
-            {
-            haveBgNeighbor = true;
-            break;
-            }
-          }
-        if ( haveBgNeighbor )
-          {
-          // there is a background pixel in the neighborhood; add to fah
-          fah[inputIt.GetCenterPixel()].push( markerIt.GetIndex() );
-          }
-        else
-          {
-          // increase progress because this pixel will not be used in the
-          // flooding stage.
-          progress.CompletedPixel();
-          }
-        }
-      else
+      for ( typename std::vector< OffsetValueType >::const_iterator sIt = m_ThreadSeeds[t].begin();
+            sIt != m_ThreadSeeds[t].end(); ++sIt )
         {
-        outputIt.SetCenterPixel(wsLabel);
+        fah.Push(input[*sIt], *sIt);
         }
-      progress.CompletedPixel();
       }
-    // end of init stage
-
-    // flooding
-    // init all the iterators
-    outputIt.GoToBegin();
-    inputIt.GoToBegin();
+    m_ThreadSeeds.clear();
 
     // and start flooding
-    while ( !fah.empty() )
+    while ( !fah.Empty() )
       {
-      // store the current vars
-      InputImagePixelType currentValue = fah.begin()->first;
-      QueueType           currentQueue = fah.begin()->second;
-      // and remove them from the fah
-      fah.erase( fah.begin() );
+      const InputImagePixelType currentValue = fah.FrontPriority();
+      const OffsetValueType     p = fah.Front();
+      fah.Pop();
 
-      while ( !currentQueue.empty() )
+      const IndexType idx = outputImage->ComputeIndex(p);
+      const bool      isInterior = interior.IsInside(idx);
+
+      const LabelImagePixelType currentMarker = output[p];
+      // iterate over neighbors to propagate the marker
+      for ( unsigned int i = 0; i < numberOfNeighbors; i++ )
         {
-        IndexType idx = currentQueue.front();
-        currentQueue.pop();
-
-        // move the iterators to the right place
-        OffsetType shift = idx - outputIt.GetIndex();
-        outputIt += shift;
-        inputIt += shift;
-
-        LabelImagePixelType currentMarker = outputIt.GetCenterPixel();
-        // get the current value of the pixel
-        // iterate over neighbors to propagate the marker
-        for ( noIt = outputIt.Begin(), niIt = inputIt.Begin();
-              noIt != outputIt.End();
-              noIt++, niIt++ )
+        if ( !isInterior && !region.IsInside(idx + m_NeighborOffsets[i]) )
+          {
+          continue;
+          }
+        const OffsetValueType n = p + m_NeighborBufferOffsets[i];
+        if ( output[n] == wsLabel )
           {
-          if ( noIt.Get() == wsLabel )
+          // the pixel is not yet processed. It can be labeled with the
+          // current label
+          output[n] = currentMarker;
+          const InputImagePixelType GrayVal = input[n];
+          if ( GrayVal <= currentValue )
             {
-            // the pixel is not yet processed. It can be labeled with the
-            // current label
-            noIt.Set(currentMarker);
-            InputImagePixelType GrayVal = niIt.Get();
-            if ( GrayVal <= currentValue )
-              {
-              currentQueue.push( inputIt.GetIndex()
-                                 + noIt.GetNeighborhoodOffset() );
-              }
-            else
-              {
-              fah[GrayVal].push( inputIt.GetIndex()
-                                 + noIt.GetNeighborhoodOffset() );
-              }
-            progress.CompletedPixel();
+            fah.Push(currentValue, n);
+            }
+          else
+            {
+            fah.Push(GrayVal, n);
             }
+          progress.CompletedPixel();
           }
         }
       }
@@ -0,0 +1,166 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMorphologicalWatershedFromMarkersImageFilter.h"
+#include "itkCastImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+
+const unsigned int Dimension = 3;
+
+typedef itk::Image< unsigned char, Dimension > ImageType;
+typedef itk::Image< float, Dimension >         FloatImageType;
+typedef itk::Image< unsigned short, Dimension > LabelImageType;
+
+template< typename TImage >
+typename LabelImageType::Pointer
+Watershed( const TImage *image, const LabelImageType *markers, bool markWatershedLine, bool fullyConnected,
+           itk::ThreadIdType numberOfThreads )
+{
+  typedef itk::MorphologicalWatershedFromMarkersImageFilter< TImage, LabelImageType > FilterType;
+  typename FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( image );
+  filter->SetMarkerImage( markers );
+  filter->SetMarkWatershedLine( markWatershedLine );
+  filter->SetFullyConnected( fullyConnected );
+  filter->SetNumberOfThreads( numberOfThreads );
+  filter->Update();
+  return filter->GetOutput();
+}
+
+/* Checks that the elements come out of a hierarchical queue in priority,
+ * then FIFO order. */
+template< typename TPriority >
+bool
+CheckQueue( const char *name )
+{
+  itk::HierarchicalQueue< TPriority, int > queue;
+  const int priorities[] = { 5, -3, 5, 0, -3, 7, 5 };
+  for( int i = 0; i < 7; i++ )
+    {
+    queue.Push( static_cast< TPriority >( priorities[i] ), i );
+    }
+  // the elements pushed with the current priority come out before the
+  // elements with a larger one
+  const int expected[] = { 1, 4, 3, 7, 0, 2, 6, 5 };
+  for( int i = 0; i < 8; i++ )
+    {
+    if( queue.Empty() || queue.Front() != expected[i] )
+      {
+      std::cerr << name << ": unexpected element at position " << i << std::endl;
+      return false;
+      }
+    const TPriority priority = queue.FrontPriority();
+    queue.Pop();
+    if( i == 2 )
+      {
+      queue.Push( priority, 7 );
+      }
+    }
+  if( !queue.Empty() )
+    {
+    std::cerr << name << ": the queue is not empty" << std::endl;
+    return false;
+    }
+  return true;
+}
+
+}
+
+/* Floods a 3D image with several markers, and checks that the results don't
+ * depend on the number of threads, and on the kind of hierarchical queue
+ * used. */
+int itkMorphologicalWatershedFromMarkersImageFilterTest2( int, char * [] )
+{
+  if( !CheckQueue< short >( "short" ) || !CheckQueue< double >( "double" ) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  ImageType::IndexType start;
+  start[0] = 2;
+  start[1] = -3;
+  start[2] = 1;
+  ImageType::SizeType size;
+  size[0] = 43;
+  size[1] = 37;
+  size[2] = 23;
+  ImageType::RegionType region( start, size );
+
+  // a quantized wave, which has plateaus, and markers on a lattice which
+  // puts several labels in some basins and none in others
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( region );
+  image->Allocate();
+  LabelImageType::Pointer markers = LabelImageType::New();
+  markers->SetRegions( region );
+  markers->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, region );
+  for(; !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType index = it.GetIndex();
+    const double               wave = std::sin( 0.4 * index[0] ) * std::cos( 0.35 * index[1] ) + std::sin( 0.3 * index[2] );
+    it.Set( static_cast< unsigned char >( 8 * std::floor( 3 * ( wave + 2 ) ) ) );
+    const bool marked = index[0] % 11 == 5 && index[1] % 9 == 4 && index[2] % 6 == 3;
+    markers->SetPixel( index, marked ? ( index[0] / 11 + 3 * ( index[1] / 9 ) ) % 7 + 1 : 0 );
+    }
+
+  typedef itk::CastImageFilter< ImageType, FloatImageType > CastType;
+  CastType::Pointer cast = CastType::New();
+  cast->SetInput( image );
+  TRY_EXPECT_NO_EXCEPTION( cast->Update() );
+
+  for( unsigned int markWatershedLine = 0; markWatershedLine < 2; markWatershedLine++ )
+    {
+    for( unsigned int fullyConnected = 0; fullyConnected < 2; fullyConnected++ )
+      {
+      LabelImageType::Pointer reference = Watershed( image.GetPointer(), markers.GetPointer(),
+        markWatershedLine != 0, fullyConnected != 0, 1 );
+      LabelImageType::Pointer threaded = Watershed( image.GetPointer(), markers.GetPointer(),
+        markWatershedLine != 0, fullyConnected != 0, 4 );
+      LabelImageType::Pointer floatReference = Watershed( cast->GetOutput(), markers.GetPointer(),
+        markWatershedLine != 0, fullyConnected != 0, 3 );
+
+      unsigned int numberOfWatershedPixels = 0;
+      itk::ImageRegionConstIteratorWithIndex< LabelImageType > rit( reference, region );
+      for(; !rit.IsAtEnd(); ++rit )
+        {
+        const LabelImageType::IndexType index = rit.GetIndex();
+        if( threaded->GetPixel( index ) != rit.Get() || floatReference->GetPixel( index ) != rit.Get() )
+          {
+          std::cerr << "Mismatch at " << index << " with mark watershed line " << markWatershedLine
+                    << " and fully connected " << fullyConnected << ": " << rit.Get() << ", "
+                    << threaded->GetPixel( index ) << ", " << floatReference->GetPixel( index ) << std::endl;
+          return EXIT_FAILURE;
+          }
+        if( rit.Get() == 0 )
+          {
+          numberOfWatershedPixels++;
+          }
+        }
+      std::cout << "Mark watershed line " << markWatershedLine << ", fully connected " << fullyConnected
+                << ": " << numberOfWatershedPixels << " watershed pixels" << std::endl;
+      }
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
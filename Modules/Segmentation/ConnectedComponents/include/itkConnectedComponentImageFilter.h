@@ -45,9 +45,20 @@ namespace itk
  *
  * After the filter is executed, ObjectCount holds the number of connected components.
  *
+ * All the steps are multithreaded: the run length encoding of the lines,
+ * the merging of the runs within the region of each thread, the merging
+ * across the boundaries between the regions, which is done pairwise so
+ * that the threads never work on the same components, and the final
+ * relabeling.
+ *
+ * When NumberOfStreamDivisions is greater than one, the input and the mask
+ * are requested and encoded piece by piece, so that a streaming capable
+ * pipeline never holds more than one piece of them. Only the run length
+ * encoding and the output are kept in memory, which allows labeling
+ * masks larger than the memory available for the input pipeline.
+ *
  * \sa ImageToImageFilter
  *
- * \ingroup SingleThreaded
  * \ingroup ITKConnectedComponents
  *
  * \wiki
@@ -162,12 +173,22 @@ public:
   itkSetMacro(BackgroundValue, OutputImagePixelType);
   itkGetConstMacro(BackgroundValue, OutputImagePixelType);
 
+  /**
+   * Set/Get the number of pieces in which the input and the mask are
+   * requested from the pipeline. The pieces are run length encoded one
+   * after the other before the components are labeled. Default is 1: the
+   * whole input is requested at once and encoded by all the threads.
+   */
+  itkSetClampMacro(NumberOfStreamDivisions, unsigned int, 1, NumericTraits< unsigned int >::max());
+  itkGetConstMacro(NumberOfStreamDivisions, unsigned int);
+
 protected:
   ConnectedComponentImageFilter()
   {
     m_FullyConnected = false;
     m_ObjectCount = 0;
     m_BackgroundValue = NumericTraits< OutputImagePixelType >::ZeroValue();
+    m_NumberOfStreamDivisions = 1;
   }
 
   virtual ~ConnectedComponentImageFilter() {}
@@ -201,6 +222,7 @@ private:
 
   LabelType            m_ObjectCount;
   OutputImagePixelType m_BackgroundValue;
+  unsigned int         m_NumberOfStreamDivisions;
 
   // some additional types
   typedef typename TOutputImage::RegionType::SizeType OutSizeType;
@@ -239,7 +261,16 @@ public:
 
   void LinkLabels(const LabelType lab1, const LabelType lab2);
 
-  SizeValueType CreateConsecutive();
+  /** Find the root of a label without modifying the union-find
+   * structure, so that it can be called by several threads. */
+  LabelType FindRoot(LabelType label) const
+  {
+    while ( label != m_UnionFind[label] )
+      {
+      label = m_UnionFind[label];
+      }
+    return label;
+  }
 
   //////////////////
   bool CheckNeighbors(const OutputIndexType & A,
@@ -247,6 +278,13 @@ public:
 
   void CompareLines(lineEncoding & current, const lineEncoding & Neighbour);
 
+  /** Run length encode the lines of the region into the line map, and
+   * return the number of runs. */
+  SizeValueType EncodeLines(const RegionType & region);
+
+  /** Position of the line starting at the index in the line map. */
+  SizeValueType ComputeLineId(const IndexType & index) const;
+
   void FillOutput(const LineMapType & LineMap,
                   ProgressReporter & progress);
 
@@ -262,6 +300,7 @@ public:
   }
 
   typename std::vector< IdentifierType > m_NumberOfLabels;
+  typename std::vector< IdentifierType > m_NumberOfObjects;
   typename std::vector< IdentifierType > m_FirstLineIdToJoin;
 
   typename Barrier::Pointer m_Barrier;
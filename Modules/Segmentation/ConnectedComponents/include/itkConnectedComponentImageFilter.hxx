@@ -25,7 +25,7 @@
 #include "itkImageLinearConstIteratorWithIndex.h"
 #include "itkConstShapedNeighborhoodIterator.h"
 #include "itkImageRegionIterator.h"
-#include "itkMaskImageFilter.h"
+#include "itkImageRegionSplitterSlowDimension.h"
 #include "itkConnectedComponentAlgorithm.h"
 
 namespace itk
@@ -44,12 +44,22 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
     {
     return;
     }
-  input->SetRequestedRegion( input->GetLargestPossibleRegion() );
+  RegionType region = input->GetLargestPossibleRegion();
+
+  // When streaming, only the first piece is requested here, the others
+  // are requested in BeforeThreadedGenerateData()
+  if ( m_NumberOfStreamDivisions > 1 )
+    {
+    ImageRegionSplitterSlowDimension::Pointer splitter = ImageRegionSplitterSlowDimension::New();
+    const unsigned int numberOfPieces = splitter->GetNumberOfSplits(region, m_NumberOfStreamDivisions);
+    splitter->GetSplit(0, numberOfPieces, region);
+    }
+  input->SetRequestedRegion( region );
 
   MaskImagePointer mask = const_cast< MaskImageType * >( this->GetMaskImage() );
   if ( mask )
     {
-    mask->SetRequestedRegion( input->GetLargestPossibleRegion() );
+    mask->SetRequestedRegion( region );
     }
 }
 
@@ -68,23 +78,8 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
 ::BeforeThreadedGenerateData()
 {
   typename TOutputImage::Pointer output = this->GetOutput();
-  typename TInputImage::ConstPointer input = this->GetInput();
-  typename TMaskImage::ConstPointer mask = this->GetMaskImage();
 
-  typedef MaskImageFilter< TInputImage, TMaskImage, TInputImage >
-  MaskFilterType;
-  typename MaskFilterType::Pointer maskFilter = MaskFilterType::New();
-  if ( mask )
-    {
-    maskFilter->SetInput(input);
-    maskFilter->SetMaskImage(mask);
-    maskFilter->Update();
-    m_Input = maskFilter->GetOutput();
-    }
-  else
-    {
-    m_Input = input;
-    }
+  m_Input = this->GetInput();
 
   ThreadIdType nbOfThreads = this->GetNumberOfThreads();
   if ( itk::MultiThreader::GetGlobalMaximumNumberOfThreads() != 0 )
@@ -101,6 +96,8 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
   // set up the vars used in the threads
   m_NumberOfLabels.clear();
   m_NumberOfLabels.resize(nbOfThreads, 0);
+  m_NumberOfObjects.clear();
+  m_NumberOfObjects.resize(nbOfThreads, 0);
   m_Barrier = Barrier::New();
   m_Barrier->Initialize(nbOfThreads);
   const SizeValueType pixelcount = output->GetRequestedRegion().GetNumberOfPixels();
@@ -108,125 +105,236 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
   const SizeValueType linecount = pixelcount / xsize;
   m_LineMap.resize(linecount);
   m_FirstLineIdToJoin.resize(nbOfThreads - 1);
+
+  // encode the input piece by piece; the threads will then only count the
+  // runs of their lines
+  if ( m_NumberOfStreamDivisions > 1 )
+    {
+    InputImageType *input = const_cast< InputImageType * >( this->GetInput() );
+    MaskImageType  *mask = const_cast< MaskImageType * >( this->GetMaskImage() );
+
+    const RegionType region = output->GetRequestedRegion();
+    ImageRegionSplitterSlowDimension::Pointer splitter = ImageRegionSplitterSlowDimension::New();
+    const unsigned int numberOfPieces = splitter->GetNumberOfSplits(region, m_NumberOfStreamDivisions);
+
+    for ( unsigned int piece = 0; piece < numberOfPieces && !this->GetAbortGenerateData(); piece++ )
+      {
+      RegionType streamRegion = region;
+      splitter->GetSplit(piece, numberOfPieces, streamRegion);
+
+      input->SetRequestedRegion(streamRegion);
+      input->PropagateRequestedRegion();
+      input->UpdateOutputData();
+      if ( mask )
+        {
+        mask->SetRequestedRegion(streamRegion);
+        mask->PropagateRequestedRegion();
+        mask->UpdateOutputData();
+        }
+
+      this->EncodeLines(streamRegion);
+      }
+    }
 }
 
 template< typename TInputImage, typename TOutputImage, typename TMaskImage >
-void
+SizeValueType
 ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
-::ThreadedGenerateData(const RegionType & outputRegionForThread,
-                       ThreadIdType threadId)
+::ComputeLineId(const IndexType & index) const
 {
-  typename TOutputImage::Pointer output = this->GetOutput();
-  typename TMaskImage::ConstPointer mask = this->GetMaskImage();
+  const RegionType & region = this->GetOutput()->GetRequestedRegion();
 
-  const ThreadIdType nbOfThreads = m_NumberOfLabels.size();
+  SizeValueType lineId = 0;
+  SizeValueType stride = 1;
+  for ( unsigned int i = 1; i < ImageDimension; i++ )
+    {
+    lineId += static_cast< SizeValueType >( index[i] - region.GetIndex()[i] ) * stride;
+    stride *= region.GetSize()[i];
+    }
+  return lineId;
+}
 
-  // create a line iterator
+template< typename TInputImage, typename TOutputImage, typename TMaskImage >
+SizeValueType
+ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
+::EncodeLines(const RegionType & region)
+{
+  typename TMaskImage::ConstPointer mask = this->GetMaskImage();
+
+  // create the line iterators
   typedef itk::ImageLinearConstIteratorWithIndex< InputImageType > InputLineIteratorType;
-  InputLineIteratorType inLineIt(m_Input, outputRegionForThread);
+  InputLineIteratorType inLineIt(m_Input, region);
   inLineIt.SetDirection(0);
 
-  // set the progress reporter to deal with the number of lines
-  const SizeValueType pixelcountForThread = outputRegionForThread.GetNumberOfPixels();
-  const SizeValueType xsizeForThread = outputRegionForThread.GetSize()[0];
-  const SizeValueType linecountForThread = pixelcountForThread / xsizeForThread;
-  ProgressReporter    progress(this, threadId, linecountForThread * 2);
-
-  // find the split axis
-  const IndexType outputRegionIdx = output->GetRequestedRegion().GetIndex();
-  const IndexType outputRegionForThreadIdx = outputRegionForThread.GetIndex();
-  SizeType  outputRegionSize = output->GetRequestedRegion().GetSize();
-  SizeType  outputRegionForThreadSize = outputRegionForThread.GetSize();
-  int             splitAxis = 0;
-  for ( unsigned int i = 0; i < ImageDimension; i++ )
+  typedef itk::ImageLinearConstIteratorWithIndex< MaskImageType > MaskLineIteratorType;
+  MaskLineIteratorType maskLineIt;
+  if ( mask )
     {
-    if ( outputRegionSize[i] != outputRegionForThreadSize[i] )
-      {
-      splitAxis = i;
-      }
+    maskLineIt = MaskLineIteratorType(mask, region);
+    maskLineIt.SetDirection(0);
+    maskLineIt.GoToBegin();
     }
 
-  // compute the number of pixels before that threads
-  outputRegionSize[splitAxis] = outputRegionForThreadIdx[splitAxis] - outputRegionIdx[splitAxis];
-  typedef SizeValueType LineIdType;
-  LineIdType firstLineIdForThread = RegionType(outputRegionIdx, outputRegionSize).GetNumberOfPixels() / xsizeForThread;
-  LineIdType lineId = firstLineIdForThread;
+  // The pixels outside of the mask are background. Testing the mask while
+  // encoding avoids a masked copy of the input.
+  std::vector< bool > isObject( region.GetSize()[0] );
 
-  OffsetVec LineOffsets;
-  SetupLineOffsets(LineOffsets);
-
-  LineIdType nbOfLabels = 0;
+  SizeValueType nbOfRuns = 0;
   for ( inLineIt.GoToBegin();
         !inLineIt.IsAtEnd();
         inLineIt.NextLine() )
     {
     inLineIt.GoToBeginOfLine();
-    lineEncoding ThisLine;
+    const IndexType lineIndex = inLineIt.GetIndex();
+
+    SizeValueType x = 0;
     while ( !inLineIt.IsAtEndOfLine() )
       {
       const InputPixelType PVal = inLineIt.Get();
-      //std::cout << inLineIt.GetIndex() << std::endl;
-      if ( PVal != NumericTraits< InputPixelType >::ZeroValue( PVal ) )
+      isObject[x++] = ( PVal != NumericTraits< InputPixelType >::ZeroValue( PVal ) );
+      ++inLineIt;
+      }
+    if ( mask )
+      {
+      maskLineIt.GoToBeginOfLine();
+      x = 0;
+      while ( !maskLineIt.IsAtEndOfLine() )
+        {
+        if ( maskLineIt.Get() == NumericTraits< MaskPixelType >::ZeroValue() )
+          {
+          isObject[x] = false;
+          }
+        ++x;
+        ++maskLineIt;
+        }
+      maskLineIt.NextLine();
+      }
+
+    lineEncoding ThisLine;
+    const SizeValueType xsize = isObject.size();
+    x = 0;
+    while ( x < xsize )
+      {
+      if ( isObject[x] )
         {
         // We've hit the start of a run
         runLength thisRun;
-        const IndexType thisIndex = inLineIt.GetIndex();
-        //std::cout << thisIndex << std::endl;
+        IndexType thisIndex = lineIndex;
+        thisIndex[0] += x;
         SizeValueType length = 1;
-        ++inLineIt;
-        while ( !inLineIt.IsAtEndOfLine()
-                && inLineIt.Get() != NumericTraits< InputPixelType >::ZeroValue( PVal ) )
+        ++x;
+        while ( x < xsize && isObject[x] )
           {
           ++length;
-          ++inLineIt;
+          ++x;
           }
         // create the run length object to go in the vector
         thisRun.length = length;
         thisRun.label = 0; // will give a real label later
         thisRun.where = thisIndex;
         ThisLine.push_back(thisRun);
-        nbOfLabels++;
+        nbOfRuns++;
         }
       else
         {
-        ++inLineIt;
+        ++x;
         }
       }
-    m_LineMap[lineId] = ThisLine;
-    lineId++;
-    progress.CompletedPixel();
+    m_LineMap[this->ComputeLineId(lineIndex)] = ThisLine;
     }
+  return nbOfRuns;
+}
+
+template< typename TInputImage, typename TOutputImage, typename TMaskImage >
+void
+ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
+::ThreadedGenerateData(const RegionType & outputRegionForThread,
+                       ThreadIdType threadId)
+{
+  typename TOutputImage::Pointer output = this->GetOutput();
+
+  const ThreadIdType nbOfThreads = m_NumberOfLabels.size();
+
+  // set the progress reporter to deal with the number of lines
+  const SizeValueType pixelcountForThread = outputRegionForThread.GetNumberOfPixels();
+  const SizeValueType xsizeForThread = outputRegionForThread.GetSize()[0];
+  const SizeValueType linecountForThread = pixelcountForThread / xsizeForThread;
+  ProgressReporter    progress(this, threadId, linecountForThread + 1);
+
+  // find the split axis
+  const IndexType outputRegionIdx = output->GetRequestedRegion().GetIndex();
+  SizeType  outputRegionForThreadSize = outputRegionForThread.GetSize();
+  int             splitAxis = 0;
+  for ( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    if ( output->GetRequestedRegion().GetSize()[i] != outputRegionForThreadSize[i] )
+      {
+      splitAxis = i;
+      }
+    }
+
+  // the lines of the thread are contiguous in the line map
+  typedef SizeValueType LineIdType;
+  const LineIdType firstLineIdForThread = this->ComputeLineId( outputRegionForThread.GetIndex() );
+  const LineIdType endLineIdForThread = firstLineIdForThread + linecountForThread;
+
+  OffsetVec LineOffsets;
+  SetupLineOffsets(LineOffsets);
+
+  // encode the lines, unless they have already been encoded piece by piece
+  SizeValueType nbOfLabels = 0;
+  if ( m_NumberOfStreamDivisions > 1 )
+    {
+    for ( LineIdType ThisIdx = firstLineIdForThread; ThisIdx < endLineIdForThread; ++ThisIdx )
+      {
+      nbOfLabels += m_LineMap[ThisIdx].size();
+      }
+    }
+  else
+    {
+    nbOfLabels = this->EncodeLines(outputRegionForThread);
+    }
+  progress.CompletedPixel();
 
   m_NumberOfLabels[threadId] = nbOfLabels;
 
   // wait for the other threads to complete that part
   this->Wait();
 
-  // compute the total number of labels
-  nbOfLabels = 0;
+  // compute the total number of labels and the first label of the thread,
+  // so that the labels follow the raster order
+  SizeValueType totalNbOfLabels = 0;
+  SizeValueType firstLabelForThread = 1;
   for ( ThreadIdType i = 0; i < nbOfThreads; i++ )
     {
-    nbOfLabels += m_NumberOfLabels[i];
+    totalNbOfLabels += m_NumberOfLabels[i];
+    if ( i < threadId )
+      {
+      firstLabelForThread += m_NumberOfLabels[i];
+      }
     }
+  const SizeValueType endLabelForThread = firstLabelForThread + nbOfLabels;
 
   if ( threadId == 0 )
     {
     // set up the union find structure
-    InitUnion(nbOfLabels);
-    // insert all the labels into the structure -- an extra loop but
-    // saves complicating the ones that come later
-    typename LineMapType::iterator MapBegin = m_LineMap.begin();
-    typename LineMapType::iterator MapEnd = m_LineMap.end();
-    typename LineMapType::iterator LineIt = MapBegin;
-    SizeValueType label = 1;
-    for ( LineIt = MapBegin; LineIt != MapEnd; ++LineIt )
+    InitUnion(totalNbOfLabels);
+    m_Consecutive = UnionFindType( m_UnionFind.size() );
+    }
+
+  // wait for the other threads to complete that part
+  this->Wait();
+
+  // insert the labels of the thread into the structure -- an extra loop
+  // but saves complicating the ones that come later
+  SizeValueType label = firstLabelForThread;
+  for ( LineIdType ThisIdx = firstLineIdForThread; ThisIdx < endLineIdForThread; ++ThisIdx )
+    {
+    for ( typename lineEncoding::iterator cIt = m_LineMap[ThisIdx].begin(); cIt != m_LineMap[ThisIdx].end(); ++cIt )
       {
-      for ( typename lineEncoding::iterator cIt = LineIt->begin(); cIt != LineIt->end(); ++cIt )
-        {
-        cIt->label = label;
-        InsertSet(label);
-        label++;
-        }
+      cIt->label = label;
+      InsertSet(label);
+      label++;
       }
     }
 
@@ -235,7 +343,6 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
 
   // now process the map and make appropriate entries in an equivalence
   // table
-  // itkAssertInDebugAndIgnoreInReleaseMacro( linecount == m_LineMap.size() );
   const SizeValueType pixelcount = output->GetRequestedRegion().GetNumberOfPixels();
   const SizeValueType xsize = output->GetRequestedRegion().GetSize()[0];
   const SizeValueType linecount = pixelcount / xsize;
@@ -282,6 +389,9 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
   // wait for the other threads to complete that part
   this->Wait();
 
+  // join the regions of the threads two by two: the regions joined at
+  // the same time are disjoint, so the threads never modify the same
+  // components
   while ( m_FirstLineIdToJoin.size() != 0 )
     {
     if ( threadId * 2 < static_cast<ThreadIdType>( m_FirstLineIdToJoin.size() ) )
@@ -329,15 +439,39 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
     this->Wait();
     }
 
-  if ( threadId == 0 )
+  // find the root of the labels of the thread, and count the roots. The
+  // union-find structure is only read from now on.
+  SizeValueType nbOfObjects = 0;
+  for ( SizeValueType I = firstLabelForThread; I < endLabelForThread; I++ )
     {
-    m_ObjectCount = CreateConsecutive();
+    const LabelType root = this->FindRoot(I);
+    m_Consecutive[I] = root;
+    if ( root == I )
+      {
+      ++nbOfObjects;
+      }
     }
+  m_NumberOfObjects[threadId] = nbOfObjects;
 
   this->Wait();
 
+  SizeValueType objectCount = 0;
+  SizeValueType firstObjectForThread = 0;
+  for ( ThreadIdType i = 0; i < nbOfThreads; i++ )
+    {
+    objectCount += m_NumberOfObjects[i];
+    if ( i < threadId )
+      {
+      firstObjectForThread += m_NumberOfObjects[i];
+      }
+    }
+
   // check for overflow exception here
-  if ( m_ObjectCount > static_cast< SizeValueType >(
+  if ( threadId == 0 )
+    {
+    m_ObjectCount = objectCount;
+    }
+  if ( objectCount > static_cast< SizeValueType >(
          NumericTraits< OutputPixelType >::max() ) )
     {
     if ( threadId == 0 )
@@ -353,6 +487,22 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
       }
     }
 
+  // give consecutive labels to the roots, in raster order, skipping the
+  // background value. The roots are not needed anymore in the union-find
+  // structure, so it stores the final labels.
+  const SizeValueType background = static_cast< SizeValueType >( m_BackgroundValue );
+  SizeValueType       object = firstObjectForThread;
+  for ( SizeValueType I = firstLabelForThread; I < endLabelForThread; I++ )
+    {
+    if ( m_Consecutive[I] == I )
+      {
+      m_UnionFind[I] = ( object < background ) ? object : object + 1;
+      ++object;
+      }
+    }
+
+  this->Wait();
+
   // create the output
   // A more complex version that is intended to minimize the number of
   // visits to the output image which should improve cache
@@ -368,17 +518,12 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
   ImageRegionIterator< OutputImageType > fend = oit;
   fend.GoToEnd();
 
-  lastLineIdForThread = firstLineIdForThread
-                        + RegionType( outputRegionIdx,
-                                      outputRegionForThread.GetSize() ).GetNumberOfPixels() / xsizeForThread;
-
-  for ( SizeValueType ThisIdx = firstLineIdForThread; ThisIdx < lastLineIdForThread; ThisIdx++ )
+  for ( SizeValueType ThisIdx = firstLineIdForThread; ThisIdx < endLineIdForThread; ThisIdx++ )
     {
     // now fill the labelled sections
     for ( typename lineEncoding::const_iterator cIt = m_LineMap[ThisIdx].begin(); cIt != m_LineMap[ThisIdx].end(); ++cIt )
       {
-      const SizeValueType   Ilab = LookupSet(cIt->label);
-      const OutputPixelType lab = m_Consecutive[Ilab];
+      const OutputPixelType lab = static_cast< OutputPixelType >( m_UnionFind[m_Consecutive[cIt->label]] );
       oit.SetIndex(cIt->where);
       // initialize the non labelled pixels
       for (; fstart != oit; ++fstart )
@@ -407,6 +552,7 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
 ::AfterThreadedGenerateData()
 {
   m_NumberOfLabels.clear();
+  m_NumberOfObjects.clear();
   m_Barrier = ITK_NULLPTR;
   m_LineMap.clear();
   m_Input = ITK_NULLPTR;
@@ -593,32 +739,6 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
   m_UnionFind[label] = label;
 }
 
-template< typename TInputImage, typename TOutputImage, typename TMaskImage >
-SizeValueType
-ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
-::CreateConsecutive()
-{
-  m_Consecutive = UnionFindType( m_UnionFind.size() );
-
-  SizeValueType CLab = 0;
-  SizeValueType count = 0;
-  for ( SizeValueType I = 1; I < m_UnionFind.size(); I++ )
-    {
-    SizeValueType L = m_UnionFind[I];
-    if ( L == I )
-      {
-      if ( CLab == static_cast< SizeValueType >( m_BackgroundValue ) )
-        {
-        ++CLab;
-        }
-      m_Consecutive[L] = CLab;
-      ++CLab;
-      ++count;
-      }
-    }
-  return count;
-}
-
 template< typename TInputImage, typename TOutputImage, typename TMaskImage >
 SizeValueType
 ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
@@ -661,6 +781,7 @@ ConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >
   os << indent << "ObjectCount: "  << m_ObjectCount << std::endl;
   os << indent << "BackgroundValue: "
      << static_cast< typename NumericTraits< OutputImagePixelType >::PrintType >( m_BackgroundValue ) << std::endl;
+  os << indent << "NumberOfStreamDivisions: "  << m_NumberOfStreamDivisions << std::endl;
 }
 } // end namespace itk
 
@@ -0,0 +1,222 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkConnectedComponentImageFilter.h"
+#include "itkCastImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkNeighborhoodIterator.h"
+#include "itkSimpleFilterWatcher.h"
+#include "itkTestingMacros.h"
+#include <queue>
+
+namespace
+{
+
+/* Labels the components by flood filling them in raster order. */
+template< typename TInputImage, typename TMaskImage, typename TOutputImage >
+typename TOutputImage::Pointer
+FloodFillLabels( const TInputImage *input, const TMaskImage *mask, bool fullyConnected )
+{
+  typedef typename TOutputImage::IndexType IndexType;
+
+  typename TOutputImage::Pointer labels = TOutputImage::New();
+  labels->SetRegions( input->GetLargestPossibleRegion() );
+  labels->Allocate();
+  labels->FillBuffer( 0 );
+
+  typename TOutputImage::SizeType radius;
+  radius.Fill( 1 );
+  itk::NeighborhoodIterator< TOutputImage > nit( radius, labels, labels->GetLargestPossibleRegion() );
+
+  typename TOutputImage::PixelType                  label = 0;
+  itk::ImageRegionIteratorWithIndex< TOutputImage > it( labels, labels->GetLargestPossibleRegion() );
+  for( ; !it.IsAtEnd(); ++it )
+    {
+    const IndexType start = it.GetIndex();
+    if( it.Get() != 0 || input->GetPixel( start ) == 0 || mask->GetPixel( start ) == 0 )
+      {
+      continue;
+      }
+    ++label;
+    std::queue< IndexType > queue;
+    labels->SetPixel( start, label );
+    queue.push( start );
+    while( !queue.empty() )
+      {
+      nit.SetLocation( queue.front() );
+      queue.pop();
+      for( unsigned int n = 0; n < nit.Size(); n++ )
+        {
+        const typename TOutputImage::OffsetType offset = nit.GetOffset( n );
+        unsigned int                             distance = 0;
+        for( unsigned int d = 0; d < TOutputImage::ImageDimension; d++ )
+          {
+          distance += std::abs( offset[d] );
+          }
+        if( distance == 0 || ( !fullyConnected && distance > 1 ) )
+          {
+          continue;
+          }
+        const IndexType index = nit.GetIndex( n );
+        if( labels->GetLargestPossibleRegion().IsInside( index ) && labels->GetPixel( index ) == 0
+            && input->GetPixel( index ) != 0 && mask->GetPixel( index ) != 0 )
+          {
+          labels->SetPixel( index, label );
+          queue.push( index );
+          }
+        }
+      }
+    }
+  return labels;
+}
+
+}
+
+/* Labels a 3D image with many components, with several threads and
+ * stream divisions, with and without a mask, and checks the labels against
+ * a flood fill. */
+int itkConnectedComponentImageFilterStreamingTest( int, char * [] )
+{
+  const unsigned int Dimension = 3;
+
+  typedef itk::Image< unsigned char, Dimension > InputImageType;
+  typedef itk::Image< unsigned char, Dimension > MaskImageType;
+  typedef itk::Image< unsigned int, Dimension >  OutputImageType;
+
+  typedef itk::CastImageFilter< InputImageType, InputImageType >                                 CastType;
+  typedef itk::ConnectedComponentImageFilter< InputImageType, OutputImageType, MaskImageType > FilterType;
+
+  InputImageType::IndexType start;
+  start[0] = 4;
+  start[1] = -2;
+  start[2] = 7;
+  InputImageType::SizeType size;
+  size[0] = 61;
+  size[1] = 37;
+  size[2] = 29;
+  InputImageType::RegionType region( start, size );
+
+  InputImageType::Pointer input = InputImageType::New();
+  input->SetRegions( region );
+  input->Allocate();
+  MaskImageType::Pointer mask = MaskImageType::New();
+  mask->SetRegions( region );
+  mask->Allocate();
+
+  // The image is split in slabs along the last direction by the stream
+  // divisions and the threads. It holds isolated dots on a lattice, and
+  // objects which cross the boundaries of the slabs: balls centered on the
+  // boundaries of 5 stream divisions, a rod through all the slabs, a
+  // staircase whose steps only touch by their edges, and a U whose branches
+  // are only joined in the last slab.
+  const InputImageType::OffsetValueType slab = ( size[2] + 4 ) / 5;
+
+  itk::ImageRegionIteratorWithIndex< InputImageType > it( input, region );
+  itk::ImageRegionIteratorWithIndex< MaskImageType >  mit( mask, region );
+  for( ; !it.IsAtEnd(); ++it, ++mit )
+    {
+    const InputImageType::IndexType  index = it.GetIndex();
+    const InputImageType::OffsetType r = index - start;
+
+    const bool dot = r[0] % 4 == 1 && r[1] % 4 == 1 && r[2] % 4 == 1;
+
+    bool ball = false;
+    for( InputImageType::OffsetValueType k = 1; k < 5; k++ )
+      {
+      const InputImageType::OffsetValueType dx = r[0] - 12 * k;
+      const InputImageType::OffsetValueType dy = r[1] - 6 - 5 * k;
+      const InputImageType::OffsetValueType dz = r[2] - k * slab;
+      ball = ball || dx * dx + dy * dy + dz * dz <= 6;
+      }
+
+    const bool rod = r[0] == 6 && r[1] == 30;
+    const bool staircase = r[0] == 20 + r[2] && r[1] == 33;
+    const bool branches = ( r[0] == 52 || r[0] == 56 ) && r[1] == 3 && r[2] >= 2;
+    const bool bottom = r[0] >= 52 && r[0] <= 56 && r[1] == 3 && r[2] == static_cast< InputImageType::OffsetValueType >( size[2] ) - 1;
+
+    it.Set( ( dot || ball || rod || staircase || branches || bottom ) ? 1 : 0 );
+    mit.Set( ( index[0] + index[2] ) % 13 == 0 ? 0 : 1 );
+    }
+
+  MaskImageType::Pointer fullMask = MaskImageType::New();
+  fullMask->SetRegions( region );
+  fullMask->Allocate();
+  fullMask->FillBuffer( 1 );
+
+  for( unsigned int useMask = 0; useMask < 2; useMask++ )
+    {
+    for( unsigned int fullyConnected = 0; fullyConnected < 2; fullyConnected++ )
+      {
+      OutputImageType::Pointer expected = FloodFillLabels< InputImageType, MaskImageType, OutputImageType >(
+        input, useMask ? mask.GetPointer() : fullMask.GetPointer(), fullyConnected != 0 );
+
+      for( unsigned int divisions = 1; divisions <= 5; divisions += 4 )
+        {
+        for( unsigned int threads = 1; threads <= 7; threads += 3 )
+          {
+          CastType::Pointer cast = CastType::New();
+          cast->SetInput( input );
+
+          FilterType::Pointer filter = FilterType::New();
+          filter->SetInput( cast->GetOutput() );
+          if( useMask )
+            {
+            filter->SetMaskImage( mask );
+            }
+          filter->SetFullyConnected( fullyConnected != 0 );
+          filter->SetNumberOfStreamDivisions( divisions );
+          filter->SetNumberOfThreads( threads );
+          TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+          // Only the last piece of the input is left in the pipeline
+          const bool streamed = cast->GetOutput()->GetBufferedRegion() != region;
+          if( streamed != ( divisions > 1 ) )
+            {
+            std::cerr << "Unexpected input buffered region " << cast->GetOutput()->GetBufferedRegion()
+                      << " with " << divisions << " stream divisions" << std::endl;
+            return EXIT_FAILURE;
+            }
+
+          itk::ImageRegionConstIterator< OutputImageType > expectedIt( expected, region );
+          itk::ImageRegionConstIteratorWithIndex< OutputImageType > outputIt( filter->GetOutput(), region );
+          OutputImageType::PixelType maximumLabel = 0;
+          for( ; !outputIt.IsAtEnd(); ++outputIt, ++expectedIt )
+            {
+            if( outputIt.Get() != expectedIt.Get() )
+              {
+              std::cerr << "Mismatch at " << outputIt.GetIndex() << " with mask " << useMask
+                        << ", fully connected " << fullyConnected << ", " << divisions << " stream divisions and "
+                        << threads << " threads: expected " << expectedIt.Get() << ", got " << outputIt.Get()
+                        << std::endl;
+              return EXIT_FAILURE;
+              }
+            maximumLabel = std::max( maximumLabel, expectedIt.Get() );
+            }
+          if( filter->GetObjectCount() != maximumLabel )
+            {
+            std::cerr << "Expected " << maximumLabel << " objects, got " << filter->GetObjectCount() << std::endl;
+            return EXIT_FAILURE;
+            }
+          }
+        }
+      }
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -25,6 +25,7 @@
 #include "itkNeighborhoodIterator.h"
 #include "itkMultiThreader.h"
 #include "itkBarrier.h"
+#include "itkAtomicInt.h"
 
 namespace itk
 {
@@ -230,6 +231,17 @@ private:
  * initializes, it will subtract the IsoSurfaceValue from all values, in the
  * input, shifting the isosurface of interest to zero in the output.
  *
+ * \par MULTITHREADING
+ *  The volume is split in slabs along its last dimension, one slab per
+ *  thread, and each thread updates the layers of its own slab. The change at
+ *  the active layer nodes, where most of the time is spent, is not computed
+ *  by slab: each thread splits its part of the active layer in chunks of
+ *  nodes, computes the change on its own chunks, and then takes the chunks
+ *  left by the other threads. A thread which holds a small part of the front
+ *  thus helps the others instead of waiting for them. The slabs are still
+ *  balanced from the histogram of the active layer every few iterations, for
+ *  the update of the layers.
+ *
  * \par IMPORTANT!
  *  Read the documentation for FiniteDifferenceImageFilter before attempting to
  *  use this filter.  The solver requires that you specify a
@@ -551,9 +563,15 @@ protected:
   }
 
   /** This method does the actual work of calculating change over a region
-   *  supplied by the multithreading mechanism.  */
+   *  supplied by the multithreading mechanism.  The thread computes the change
+   *  on the chunks of its own active layer first, and then on the chunks left
+   *  in the active layers of the other threads. */
   virtual TimeStepType ThreadedCalculateChange(ThreadIdType ThreadId);
 
+  /** Split the active layer of the thread in chunks, which are taken by all
+   *  the threads in ThreadedCalculateChange(). */
+  void ThreadedSplitActiveLayer(ThreadIdType ThreadId);
+
   /** 1. Updates the values (in the output-image) of the nodes in the active layer
    *  that are moving OUT of the active layer. These values are used in the
    *  ThreadedProcessFirstLayerStatusLists() method to assign values for new nodes
@@ -742,6 +760,17 @@ protected:
     /** Local histogram with each thread */
     int *m_ZHistogram;
 
+    /** The first node of each chunk of the active layer, followed by the end
+     *  of the layer */
+    std::vector< typename LayerType::Iterator > m_ActiveChunks;
+
+    /** The next chunk of the active layer to be taken by a thread */
+    AtomicInt< SizeValueType > m_NextActiveChunk;
+
+    /** The number of active layer nodes on which the thread computed the
+     *  change in the current iteration */
+    SizeValueType m_ActiveNodesComputed;
+
     /** pseudo-Semaphores used for signalling and waiting neighbor
      *  threads. Strictly speaking the semaphores are NOT just
      *  accessed by the thread that owns them
@@ -1217,6 +1217,11 @@ ParallelSparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
     str->Filter->m_IsInitialized = true;
     }
 
+  // The change is computed by all the threads on the whole active layer, so
+  // every layer must be split before any thread starts.
+  str->Filter->ThreadedSplitActiveLayer(ThreadId);
+  str->Filter->WaitForAll();
+
   unsigned int iter = str->Filter->GetElapsedIterations();
   while ( !( str->Filter->ThreadedHalt(arg) ) )
     {
@@ -1305,11 +1310,14 @@ ParallelSparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
         str->Filter->SetElapsedIterations (++iter);
         }
 
-      if ( ThreadId == 0 )
+      // A thread which took no chunk has no time step. When the iteration
+      // goes on, some layer has more than 10 nodes, so some thread took one.
+      if ( ThreadId == 0 && str->Filter->m_Stop == false )
         {
         for ( i = 0; i < str->Filter->m_NumOfThreads; i++ )
           {
           str->TimeStepList[i] = str->Filter->m_Data[i].TimeStep;
+          str->ValidTimeStepList[i] = ( str->Filter->m_Data[i].m_ActiveNodesComputed > 0 );
           }
         str->TimeStep = str->Filter->ResolveTimeStep(str->TimeStepList,
                                                      str->ValidTimeStepList );
@@ -1327,10 +1335,6 @@ ParallelSparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
     // Threaded Apply Update
     str->Filter->ThreadedApplyUpdate(str->TimeStep, ThreadId);
 
-    // We only need to wait for neighbors because ThreadedCalculateChange
-    // requires information only from the neighbors.
-    str->Filter->SignalNeighborsAndWait(ThreadId);
-
     if ( str->Filter->GetElapsedIterations()
          % LOAD_BALANCE_ITERATION_FREQUENCY == 0 )
       {
@@ -1348,6 +1352,11 @@ ParallelSparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
         str->Filter->WaitForAll();
         }
       }
+
+    // ThreadedCalculateChange requires information from all the threads,
+    // which must have updated and split their layers.
+    str->Filter->ThreadedSplitActiveLayer(ThreadId);
+    str->Filter->WaitForAll();
     }
 
   // post-process output
@@ -1393,77 +1402,93 @@ ParallelSparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
   // Calculates the update values for the active layer indices in this
   // iteration.  Iterates through the active layer index list, applying
   // the level set function to the output image (level set image) at each
-  // index.
+  // index.  The chunks of the thread's own active layer are taken first, and
+  // then those left in the active layers of the other threads.  The output
+  // image is only read here, so the change can be computed at any node.
+
+  m_Data[ThreadId].m_ActiveNodesComputed = 0;
 
-  typename LayerType::Iterator layerIt  = m_Data[ThreadId].m_Layers[0]->Begin();
-  typename LayerType::Iterator layerEnd = m_Data[ThreadId].m_Layers[0]->End();
+  typename LayerType::Iterator layerIt;
+  typename LayerType::Iterator layerEnd;
 
-  for (; layerIt != layerEnd; ++layerIt )
+  for ( ThreadIdType t = 0; t < m_NumOfThreads; ++t )
     {
-    outputIt.SetLocation(layerIt->m_Index);
-    // Calculate the offset to the surface from the center of this
-    // neighborhood.  This is used by some level set functions in sampling a
-    // speed, advection, or curvature term.
-    if ( this->m_InterpolateSurfaceLocation
-         && Math::NotExactlyEquals(( centerValue = outputIt.GetCenterPixel() ), NumericTraits< ValueType >::ZeroValue()) )
-      {
-      // Surface is at the zero crossing, so distance to surface is:
-      // phi(x) / norm(grad(phi)), where phi(x) is the center of the
-      // neighborhood.  The location is therefore
-      // (i,j,k) - ( phi(x) * grad(phi(x)) ) / norm(grad(phi))^2
-      norm_grad_phi_squared = 0.0;
+    ThreadData & data = m_Data[( ThreadId + t ) % m_NumOfThreads];
+    const SizeValueType numberOfChunks = data.m_ActiveChunks.size() - 1;
 
-      for ( i = 0; i < static_cast< unsigned int >( ImageDimension ); ++i )
+    for ( SizeValueType chunk = data.m_NextActiveChunk++; chunk < numberOfChunks;
+          chunk = data.m_NextActiveChunk++ )
+      {
+      layerEnd = data.m_ActiveChunks[chunk + 1];
+      for ( layerIt = data.m_ActiveChunks[chunk]; layerIt != layerEnd; ++layerIt )
         {
-        forwardValue = outputIt.GetPixel( center + m_NeighborList.GetStride(i) );
-        backwardValue = outputIt.GetPixel( center - m_NeighborList.GetStride(i) );
-
-        if ( forwardValue * backwardValue >= 0 )
+        ++m_Data[ThreadId].m_ActiveNodesComputed;
+        outputIt.SetLocation(layerIt->m_Index);
+        // Calculate the offset to the surface from the center of this
+        // neighborhood.  This is used by some level set functions in sampling a
+        // speed, advection, or curvature term.
+        if ( this->m_InterpolateSurfaceLocation
+             && Math::NotExactlyEquals(( centerValue = outputIt.GetCenterPixel() ), NumericTraits< ValueType >::ZeroValue()) )
           {
-          // 1. both neighbors have the same sign OR at least one of them is
-          // ZERO
-          dx_forward  = forwardValue - centerValue;
-          dx_backward = centerValue - backwardValue;
+          // Surface is at the zero crossing, so distance to surface is:
+          // phi(x) / norm(grad(phi)), where phi(x) is the center of the
+          // neighborhood.  The location is therefore
+          // (i,j,k) - ( phi(x) * grad(phi(x)) ) / norm(grad(phi))^2
+          norm_grad_phi_squared = 0.0;
 
-          // take the one-sided derivative with the larger magnitude
-          if ( vnl_math_abs(dx_forward) > vnl_math_abs(dx_backward) )
+          for ( i = 0; i < static_cast< unsigned int >( ImageDimension ); ++i )
             {
-            offset[i] = dx_forward;
+            forwardValue = outputIt.GetPixel( center + m_NeighborList.GetStride(i) );
+            backwardValue = outputIt.GetPixel( center - m_NeighborList.GetStride(i) );
+
+            if ( forwardValue * backwardValue >= 0 )
+              {
+              // 1. both neighbors have the same sign OR at least one of them is
+              // ZERO
+              dx_forward  = forwardValue - centerValue;
+              dx_backward = centerValue - backwardValue;
+
+              // take the one-sided derivative with the larger magnitude
+              if ( vnl_math_abs(dx_forward) > vnl_math_abs(dx_backward) )
+                {
+                offset[i] = dx_forward;
+                }
+              else
+                {
+                offset[i] = dx_backward;
+                }
+              }
+            else
+              {
+              // 2. neighbors have opposite sign
+              // take the one-sided derivative using the neighbor that has the
+              // opposite sign w.r.t. oneself
+              if ( centerValue * forwardValue < 0 )
+                {
+                offset[i] = forwardValue - centerValue;
+                }
+              else
+                {
+                offset[i] = centerValue - backwardValue;
+                }
+              }
+
+            norm_grad_phi_squared += offset[i] * offset[i];
             }
-          else
+
+          for ( i = 0; i < static_cast< unsigned int >( ImageDimension ); ++i )
             {
-            offset[i] = dx_backward;
+            offset[i] = ( offset[i] * outputIt.GetCenterPixel() )
+                        / ( norm_grad_phi_squared + MIN_NORM );
             }
+
+          layerIt->m_Value = df->ComputeUpdate (outputIt, (void *)m_Data[ThreadId].globalData, offset);
           }
-        else
+        else // Don't do interpolation
           {
-          // 2. neighbors have opposite sign
-          // take the one-sided derivative using the neighbor that has the
-          // opposite sign w.r.t. oneself
-          if ( centerValue * forwardValue < 0 )
-            {
-            offset[i] = forwardValue - centerValue;
-            }
-          else
-            {
-            offset[i] = centerValue - backwardValue;
-            }
+          layerIt->m_Value = df->ComputeUpdate (outputIt, (void *)m_Data[ThreadId].globalData);
           }
-
-        norm_grad_phi_squared += offset[i] * offset[i];
-        }
-
-      for ( i = 0; i < static_cast< unsigned int >( ImageDimension ); ++i )
-        {
-        offset[i] = ( offset[i] * outputIt.GetCenterPixel() )
-                    / ( norm_grad_phi_squared + MIN_NORM );
         }
-
-      layerIt->m_Value = df->ComputeUpdate (outputIt, (void *)m_Data[ThreadId].globalData, offset);
-      }
-    else // Don't do interpolation
-      {
-      layerIt->m_Value = df->ComputeUpdate (outputIt, (void *)m_Data[ThreadId].globalData);
       }
     }
 
@@ -1472,6 +1497,34 @@ ParallelSparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
   return timeStep;
 }
 
+template< typename TInputImage, typename TOutputImage >
+void
+ParallelSparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
+::ThreadedSplitActiveLayer(ThreadIdType ThreadId)
+{
+  // The number of active layer nodes in a chunk. A chunk is small enough for
+  // the threads to share the active layer evenly, and large enough for the
+  // cost of taking it to be negligible.
+  const SizeValueType NODES_PER_CHUNK = 64;
+
+  ThreadData & data = m_Data[ThreadId];
+  data.m_ActiveChunks.clear();
+
+  typename LayerType::Iterator layerIt  = data.m_Layers[0]->Begin();
+  typename LayerType::Iterator layerEnd = data.m_Layers[0]->End();
+
+  for ( SizeValueType n = 0; layerIt != layerEnd; ++layerIt, ++n )
+    {
+    if ( n % NODES_PER_CHUNK == 0 )
+      {
+      data.m_ActiveChunks.push_back(layerIt);
+      }
+    }
+  data.m_ActiveChunks.push_back(layerEnd);
+
+  data.m_NextActiveChunk = 0;
+}
+
 template< typename TInputImage, typename TOutputImage >
 void
 ParallelSparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
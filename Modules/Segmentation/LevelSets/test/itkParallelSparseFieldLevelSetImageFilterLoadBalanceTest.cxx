@@ -0,0 +1,200 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkLevelSetFunction.h"
+#include "itkParallelSparseFieldLevelSetImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include <algorithm>
+#include <cmath>
+
+/*
+ * A small sphere at one end of a long volume grows along the split axis of
+ * ParallelSparseFieldLevelSetImageFilter. The slabs are set around the
+ * initial sphere, so the growing front lies mostly in the last slab between
+ * two balancings of the load, and the other threads compute the change on
+ * the chunks of its active layer.
+ * The level set evolved with several threads is compared to the one evolved
+ * with one thread.
+ */
+namespace PSFLSIFLBT {  // local namespace for helper functions
+
+typedef ::itk::Image< float, 3 > ImageType;
+
+/**
+ * \class GrowFunction
+ * Subclasses LevelSetFunction, supplying a constant ``PropagationSpeed''.
+ */
+class GrowFunction : public ::itk::LevelSetFunction< ImageType >
+{
+public:
+  typedef GrowFunction                            Self;
+  typedef ::itk::LevelSetFunction< ImageType >    Superclass;
+  typedef Superclass::RadiusType                  RadiusType;
+  typedef Superclass::GlobalDataStruct            GlobalDataStruct;
+  typedef ::itk::SmartPointer<Self>               Pointer;
+  typedef ::itk::SmartPointer<const Self>         ConstPointer;
+
+  itkTypeMacro( GrowFunction, LevelSetFunction );
+
+  itkNewMacro(Self);
+
+protected:
+  ~GrowFunction() {}
+
+  GrowFunction()
+  {
+    RadiusType r;
+    r.Fill( 1 );
+    Superclass::Initialize(r);
+  }
+
+private:
+  virtual ScalarValueType PropagationSpeed(
+    const NeighborhoodType &,
+    const FloatOffsetType &,
+    GlobalDataStruct *
+    ) const ITK_OVERRIDE
+  {
+    return 1.0;
+  }
+};
+
+class GrowFilter : public
+::itk::ParallelSparseFieldLevelSetImageFilter< ImageType, ImageType >
+{
+public:
+  typedef GrowFilter                      Self;
+  typedef ::itk::SmartPointer<Self>       Pointer;
+  typedef ::itk::SmartPointer<const Self> ConstPointer;
+
+  itkTypeMacro( GrowFilter, ParallelSparseFieldLevelSetImageFilter );
+
+  itkNewMacro(Self);
+
+  itkSetMacro(Iterations, unsigned int);
+
+protected:
+  ~GrowFilter() {}
+  GrowFilter()
+  {
+    GrowFunction::Pointer p = GrowFunction::New();
+    p->SetPropagationWeight(1.0);
+    p->SetAdvectionWeight(0.0);
+    p->SetCurvatureWeight(0.2);
+    this->SetDifferenceFunction(p);
+    m_Iterations = 0;
+  }
+  GrowFilter(const Self &) ITK_DELETE_FUNCTION;
+
+private:
+  unsigned int m_Iterations;
+
+  virtual bool Halt() ITK_OVERRIDE
+  {
+    return this->GetElapsedIterations() == m_Iterations;
+  }
+};
+
+ImageType::Pointer
+Grow( const ImageType *init, itk::ThreadIdType numberOfThreads )
+{
+  GrowFilter::Pointer filter = GrowFilter::New();
+  filter->SetInput( init );
+  filter->SetIterations( 200 );
+  filter->SetNumberOfThreads( numberOfThreads );
+
+  filter->Update();
+  std::cout << numberOfThreads << " threads: "
+            << filter->GetElapsedIterations() << " iterations" << std::endl;
+
+  return filter->GetOutput();
+}
+
+} // end namespace PSFLSIFLBT
+
+int itkParallelSparseFieldLevelSetImageFilterLoadBalanceTest(int, char* [])
+{
+  typedef PSFLSIFLBT::ImageType ImageType;
+
+  ImageType::SizeType size;
+  size[0] = 32;
+  size[1] = 32;
+  size[2] = 128;
+
+  ImageType::Pointer init = ImageType::New();
+  init->SetRegions( size );
+  init->Allocate();
+
+  // the signed distance to a sphere at the beginning of the split axis
+  const double center[3] = { 16.0, 16.0, 10.0 };
+  const double radius = 6.0;
+  unsigned int initialInside = 0;
+  itk::ImageRegionIteratorWithIndex< ImageType > it( init, init->GetLargestPossibleRegion() );
+  for(; !it.IsAtEnd(); ++it )
+    {
+    double distance2 = 0.0;
+    for( unsigned int d = 0; d < 3; d++ )
+      {
+      distance2 += ( it.GetIndex()[d] - center[d] ) * ( it.GetIndex()[d] - center[d] );
+      }
+    it.Set( static_cast< float >( std::sqrt( distance2 ) - radius ) );
+    if( it.Get() < 0 )
+      {
+      initialInside++;
+      }
+    }
+
+  ImageType::Pointer serial = PSFLSIFLBT::Grow( init, 1 );
+  ImageType::Pointer parallel = PSFLSIFLBT::Grow( init, 4 );
+
+  unsigned int serialInside = 0;
+  unsigned int differentSigns = 0;
+  float        maximumDifference = 0.0f;
+  itk::ImageRegionIteratorWithIndex< ImageType > sIt( serial, serial->GetLargestPossibleRegion() );
+  itk::ImageRegionIteratorWithIndex< ImageType > pIt( parallel, parallel->GetLargestPossibleRegion() );
+  for(; !sIt.IsAtEnd(); ++sIt, ++pIt )
+    {
+    if( sIt.Get() < 0 )
+      {
+      serialInside++;
+      }
+    if( ( sIt.Get() < 0 ) != ( pIt.Get() < 0 ) )
+      {
+      differentSigns++;
+      }
+    maximumDifference = std::max( maximumDifference, std::abs( sIt.Get() - pIt.Get() ) );
+    }
+  std::cout << initialInside << " points inside initially, " << serialInside << " at the end" << std::endl;
+  std::cout << differentSigns << " points on different sides with several threads, maximum difference "
+            << maximumDifference << std::endl;
+
+  // the sphere has grown far along the split axis
+  if( serialInside < 20 * initialInside )
+    {
+    std::cerr << "The level set did not grow" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if( differentSigns > 0 || maximumDifference > 1e-4f )
+    {
+    std::cerr << "The level sets differ with several threads" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
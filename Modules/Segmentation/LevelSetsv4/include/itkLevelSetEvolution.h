@@ -332,16 +332,35 @@ public:
   typedef UpdateShiSparseLevelSet< ImageDimension, EquationContainerType >  UpdateLevelSetFilterType;
   typedef typename UpdateLevelSetFilterType::Pointer                        UpdateLevelSetFilterPointer;
 
+  /** Set the maximum number of threads to be used. */
+  void SetNumberOfThreads( const ThreadIdType threads );
+  /** Set the maximum number of threads to be used. */
+  ThreadIdType GetNumberOfThreads() const;
+
 protected:
   LevelSetEvolution();
   ~LevelSetEvolution();
 
+  typedef std::pair< LevelSetInputType, LevelSetOutputType > NodePairType;
+
+  // Signs of the updates of the points of the layers evolved by the current
+  // level set, computed in parallel before the layers are updated
+  LevelSetLayerType m_UpdateBuffer;
+
+  /** Compute the signs of the updates of the points of the layer in parallel */
+  void ComputeUpdateBuffer( const LevelSetLayerType & layer );
+
   /** Update the levelset by 1 iteration from the computed updates */
   virtual void UpdateLevelSets() ITK_OVERRIDE;
 
   /** Update the equations at the end of 1 iteration */
   virtual void UpdateEquations() ITK_OVERRIDE;
 
+  typedef ThreadedIteratorRangePartitioner< typename LevelSetType::LayerConstIterator > SplitLevelSetPartitionerType;
+  friend class LevelSetEvolutionComputeIterationThreader< typename LevelSetType::Superclass, SplitLevelSetPartitionerType, Self >;
+  typedef LevelSetEvolutionComputeIterationThreader< typename LevelSetType::Superclass, SplitLevelSetPartitionerType, Self > SplitLevelSetComputeIterationThreaderType;
+  typename SplitLevelSetComputeIterationThreaderType::Pointer m_SplitLevelSetComputeIterationThreader;
+
 private:
   LevelSetEvolution( const Self& );
   void operator = ( const Self& );
@@ -412,14 +431,33 @@ public:
   typedef UpdateMalcolmSparseLevelSet< ImageDimension, EquationContainerType > UpdateLevelSetFilterType;
   typedef typename UpdateLevelSetFilterType::Pointer UpdateLevelSetFilterPointer;
 
+  /** Set the maximum number of threads to be used. */
+  void SetNumberOfThreads( const ThreadIdType threads );
+  /** Set the maximum number of threads to be used. */
+  ThreadIdType GetNumberOfThreads() const;
+
 protected:
   LevelSetEvolution();
   virtual ~LevelSetEvolution();
 
+  typedef std::pair< LevelSetInputType, LevelSetOutputType > NodePairType;
+
+  // Signs of the updates of the points of the layers evolved by the current
+  // level set, computed in parallel before the layers are updated
+  LevelSetLayerType m_UpdateBuffer;
+
+  /** Compute the signs of the updates of the points of the layer in parallel */
+  void ComputeUpdateBuffer( const LevelSetLayerType & layer );
+
   virtual void UpdateLevelSets() ITK_OVERRIDE;
 
   virtual void UpdateEquations() ITK_OVERRIDE;
 
+  typedef ThreadedIteratorRangePartitioner< typename LevelSetType::LayerConstIterator > SplitLevelSetPartitionerType;
+  friend class LevelSetEvolutionComputeIterationThreader< typename LevelSetType::Superclass, SplitLevelSetPartitionerType, Self >;
+  typedef LevelSetEvolutionComputeIterationThreader< typename LevelSetType::Superclass, SplitLevelSetPartitionerType, Self > SplitLevelSetComputeIterationThreaderType;
+  typename SplitLevelSetComputeIterationThreaderType::Pointer m_SplitLevelSetComputeIterationThreader;
+
 private:
   LevelSetEvolution( const Self& ) ITK_DELETE_FUNCTION;
   void operator = ( const Self& ) ITK_DELETE_FUNCTION;
@@ -289,7 +289,7 @@ LevelSetEvolution< TEquationContainer, WhitakerSparseLevelSetImage< TOutput, VDi
   while( this->m_LevelSetContainerIteratorToProcessWhenThreading != this->m_LevelSetContainer->End() )
     {
     typename LevelSetType::ConstPointer levelSet = this->m_LevelSetContainerIteratorToProcessWhenThreading->GetLevelSet();
-    const LevelSetLayerType zeroLayer = levelSet->GetLayer( 0 );
+    const LevelSetLayerType & zeroLayer = levelSet->GetLayer( 0 );
     typename LevelSetType::LayerConstIterator layerBegin = zeroLayer.begin();
     typename LevelSetType::LayerConstIterator layerEnd = zeroLayer.end();
     typename SplitLevelSetPartitionerType::DomainType completeDomain( layerBegin, layerEnd );
@@ -348,6 +348,7 @@ LevelSetEvolution< TEquationContainer, WhitakerSparseLevelSetImage< TOutput, VDi
     updateLevelSet->SetInputLevelSet( levelSet );
     updateLevelSet->SetUpdate( * this->m_UpdateBuffer[it->GetIdentifier()] );
     updateLevelSet->SetEquationContainer( this->m_EquationContainer );
+    updateLevelSet->SetNumberOfThreads( this->GetNumberOfThreads() );
     updateLevelSet->SetTimeStep( this->m_Dt );
     updateLevelSet->SetCurrentLevelSetId( it->GetIdentifier() );
     updateLevelSet->Update();
@@ -374,6 +375,7 @@ template< typename TEquationContainer, unsigned int VDimension >
 LevelSetEvolution< TEquationContainer, ShiSparseLevelSetImage< VDimension > >
 ::LevelSetEvolution()
 {
+  this->m_SplitLevelSetComputeIterationThreader = SplitLevelSetComputeIterationThreaderType::New();
 }
 
 template< typename TEquationContainer, unsigned int VDimension >
@@ -381,6 +383,36 @@ LevelSetEvolution< TEquationContainer, ShiSparseLevelSetImage< VDimension > >
 ::~LevelSetEvolution()
 {}
 
+template< typename TEquationContainer, unsigned int VDimension >
+void
+LevelSetEvolution< TEquationContainer, ShiSparseLevelSetImage< VDimension > >
+::SetNumberOfThreads( const ThreadIdType numberOfThreads )
+{
+  this->m_SplitLevelSetComputeIterationThreader->SetMaximumNumberOfThreads( numberOfThreads );
+}
+
+template< typename TEquationContainer, unsigned int VDimension >
+ThreadIdType
+LevelSetEvolution< TEquationContainer, ShiSparseLevelSetImage< VDimension > >
+::GetNumberOfThreads() const
+{
+  return this->m_SplitLevelSetComputeIterationThreader->GetMaximumNumberOfThreads();
+}
+
+template< typename TEquationContainer, unsigned int VDimension >
+void
+LevelSetEvolution< TEquationContainer, ShiSparseLevelSetImage< VDimension > >
+::ComputeUpdateBuffer( const LevelSetLayerType & layer )
+{
+  // the partitioner can not split an empty range
+  if( layer.empty() )
+    {
+    return;
+    }
+  typename SplitLevelSetPartitionerType::DomainType completeDomain( layer.begin(), layer.end() );
+  this->m_SplitLevelSetComputeIterationThreader->Execute( this, completeDomain );
+}
+
 template< typename TEquationContainer, unsigned int VDimension >
 void LevelSetEvolution< TEquationContainer, ShiSparseLevelSetImage< VDimension > >
 ::UpdateLevelSets()
@@ -391,10 +423,19 @@ void LevelSetEvolution< TEquationContainer, ShiSparseLevelSetImage< VDimension >
     {
     typename LevelSetType::Pointer levelSet = it->GetLevelSet();
 
+    // the input level set does not change until the end of the update, so the
+    // updates of the points of the layers -1 and +1 are computed beforehand
+    this->m_LevelSetContainerIteratorToProcessWhenThreading = it;
+    this->m_UpdateBuffer.clear();
+    this->ComputeUpdateBuffer( levelSet->GetLayer( LevelSetType::MinusOneLayer() ) );
+    this->ComputeUpdateBuffer( levelSet->GetLayer( LevelSetType::PlusOneLayer() ) );
+
     UpdateLevelSetFilterPointer updateLevelSet = UpdateLevelSetFilterType::New();
     updateLevelSet->SetInputLevelSet( levelSet );
     updateLevelSet->SetCurrentLevelSetId( it->GetIdentifier() );
     updateLevelSet->SetEquationContainer( this->m_EquationContainer );
+    updateLevelSet->SetNumberOfThreads( this->GetNumberOfThreads() );
+    updateLevelSet->SetUpdate( this->m_UpdateBuffer );
     updateLevelSet->Update();
 
     levelSet->Graft( updateLevelSet->GetOutputLevelSet() );
@@ -417,6 +458,7 @@ template< typename TEquationContainer, unsigned int VDimension >
 LevelSetEvolution< TEquationContainer, MalcolmSparseLevelSetImage< VDimension > >
 ::LevelSetEvolution()
 {
+  this->m_SplitLevelSetComputeIterationThreader = SplitLevelSetComputeIterationThreaderType::New();
 }
 
 template< typename TEquationContainer, unsigned int VDimension >
@@ -424,6 +466,36 @@ LevelSetEvolution< TEquationContainer, MalcolmSparseLevelSetImage< VDimension >
 ::~LevelSetEvolution()
 {}
 
+template< typename TEquationContainer, unsigned int VDimension >
+void
+LevelSetEvolution< TEquationContainer, MalcolmSparseLevelSetImage< VDimension > >
+::SetNumberOfThreads( const ThreadIdType numberOfThreads )
+{
+  this->m_SplitLevelSetComputeIterationThreader->SetMaximumNumberOfThreads( numberOfThreads );
+}
+
+template< typename TEquationContainer, unsigned int VDimension >
+ThreadIdType
+LevelSetEvolution< TEquationContainer, MalcolmSparseLevelSetImage< VDimension > >
+::GetNumberOfThreads() const
+{
+  return this->m_SplitLevelSetComputeIterationThreader->GetMaximumNumberOfThreads();
+}
+
+template< typename TEquationContainer, unsigned int VDimension >
+void
+LevelSetEvolution< TEquationContainer, MalcolmSparseLevelSetImage< VDimension > >
+::ComputeUpdateBuffer( const LevelSetLayerType & layer )
+{
+  // the partitioner can not split an empty range
+  if( layer.empty() )
+    {
+    return;
+    }
+  typename SplitLevelSetPartitionerType::DomainType completeDomain( layer.begin(), layer.end() );
+  this->m_SplitLevelSetComputeIterationThreader->Execute( this, completeDomain );
+}
+
 template< typename TEquationContainer, unsigned int VDimension >
 void LevelSetEvolution< TEquationContainer, MalcolmSparseLevelSetImage< VDimension > >
 ::UpdateLevelSets()
@@ -435,10 +507,16 @@ void LevelSetEvolution< TEquationContainer, MalcolmSparseLevelSetImage< VDimensi
     typename LevelSetType::Pointer levelSet = it->GetLevelSet();
     LevelSetIdentifierType       levelSetId = it->GetIdentifier();
 
+    this->m_LevelSetContainerIteratorToProcessWhenThreading = it;
+    this->m_UpdateBuffer.clear();
+    this->ComputeUpdateBuffer( levelSet->GetLayer( LevelSetType::ZeroLayer() ) );
+
     UpdateLevelSetFilterPointer updateLevelSet = UpdateLevelSetFilterType::New();
     updateLevelSet->SetInputLevelSet( levelSet );
     updateLevelSet->SetCurrentLevelSetId( levelSetId );
     updateLevelSet->SetEquationContainer( this->m_EquationContainer );
+    updateLevelSet->SetNumberOfThreads( this->GetNumberOfThreads() );
+    updateLevelSet->SetUpdate( this->m_UpdateBuffer );
     updateLevelSet->Update();
 
     levelSet->Graft( updateLevelSet->GetOutputLevelSet() );
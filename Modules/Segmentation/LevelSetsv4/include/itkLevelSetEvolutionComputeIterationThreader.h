@@ -24,6 +24,7 @@
 
 #include "itkLevelSetDenseImage.h"
 #include "itkWhitakerSparseLevelSetImage.h"
+#include "itkLevelSetSparseImage.h"
 
 namespace itk
 {
@@ -198,6 +199,63 @@ private:
   void operator=( const Self & ) ITK_DELETE_FUNCTION;
 };
 
+// For Shi and Malcolm sparse level sets split by putting part of a layer in
+// each thread. Their values are the layers, so only the sign of the update is
+// kept.
+template< unsigned int VDimension, typename TLevelSetEvolution >
+class LevelSetEvolutionComputeIterationThreader<
+      LevelSetSparseImage< int8_t, VDimension >,
+      ThreadedIteratorRangePartitioner< typename LevelSetSparseImage< int8_t, VDimension >::LayerConstIterator >,
+      TLevelSetEvolution
+      >
+  : public DomainThreader< ThreadedIteratorRangePartitioner< typename LevelSetSparseImage< int8_t, VDimension >::LayerConstIterator >, TLevelSetEvolution >
+{
+public:
+  /** Standard class typedefs. */
+  typedef LevelSetEvolutionComputeIterationThreader                                                                                                          Self;
+  typedef DomainThreader< ThreadedIteratorRangePartitioner< typename LevelSetSparseImage< int8_t, VDimension >::LayerConstIterator >, TLevelSetEvolution > Superclass;
+  typedef SmartPointer< Self >                                                                                                                               Pointer;
+  typedef SmartPointer< const Self >                                                                                                                         ConstPointer;
+
+  /** Run time type information. */
+  itkTypeMacro( LevelSetEvolutionComputeIterationThreader, DomainThreader );
+
+  /** Standard New macro. */
+  itkNewMacro( Self );
+
+  /** Superclass types. */
+  typedef typename Superclass::DomainType    DomainType;
+  typedef typename Superclass::AssociateType AssociateType;
+
+  /** Types of the associate class. */
+  typedef TLevelSetEvolution                                     LevelSetEvolutionType;
+  typedef typename LevelSetEvolutionType::LevelSetType           LevelSetType;
+  typedef typename LevelSetType::OffsetType                      OffsetType;
+  typedef typename LevelSetEvolutionType::LevelSetContainerType  LevelSetContainerType;
+  typedef typename LevelSetEvolutionType::LevelSetIdentifierType LevelSetIdentifierType;
+  typedef typename LevelSetEvolutionType::LevelSetInputType      LevelSetInputType;
+  typedef typename LevelSetEvolutionType::LevelSetOutputType     LevelSetOutputType;
+  typedef typename LevelSetEvolutionType::LevelSetOutputRealType LevelSetOutputRealType;
+  typedef typename LevelSetEvolutionType::TermContainerType      TermContainerType;
+  typedef typename LevelSetEvolutionType::NodePairType           NodePairType;
+
+protected:
+  LevelSetEvolutionComputeIterationThreader();
+
+  virtual void BeforeThreadedExecution() ITK_OVERRIDE;
+
+  virtual void ThreadedExecution( const DomainType & iteratorSubRange, const ThreadIdType threadId ) ITK_OVERRIDE;
+
+  virtual void AfterThreadedExecution() ITK_OVERRIDE;
+
+  typedef std::vector< std::vector< NodePairType > > NodePairsPerThreadType;
+  NodePairsPerThreadType m_NodePairsPerThread;
+
+private:
+  LevelSetEvolutionComputeIterationThreader( const Self & ) ITK_DELETE_FUNCTION;
+  void operator=( const Self & ) ITK_DELETE_FUNCTION;
+};
+
 } // namespace itk
 
 #ifndef ITK_MANUAL_INSTANTIATION
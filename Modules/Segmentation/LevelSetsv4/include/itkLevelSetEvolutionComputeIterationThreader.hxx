@@ -238,13 +238,105 @@ LevelSetEvolutionComputeIterationThreader<
   LevelSetIdentifierType levelSetId = it->GetIdentifier();
   typename LevelSetEvolutionType::LevelSetLayerType * levelSetLayerUpdateBuffer = this->m_Associate->m_UpdateBuffer[ levelSetId ];
 
+  // the threads have the consecutive parts of the layer, so that the points
+  // are inserted in order at the end of the buffer
   const ThreadIdType numberOfThreads = this->GetNumberOfThreadsUsed();
   for( ThreadIdType ii = 0; ii < numberOfThreads; ++ii )
     {
     typename std::vector< NodePairType >::const_iterator pairIt = this->m_NodePairsPerThread[ii].begin();
     while( pairIt != this->m_NodePairsPerThread[ii].end() )
       {
-      levelSetLayerUpdateBuffer->insert( *pairIt );
+      levelSetLayerUpdateBuffer->insert( levelSetLayerUpdateBuffer->end(), *pairIt );
+      ++pairIt;
+      }
+    }
+}
+
+template< unsigned int VDimension, typename TLevelSetEvolution >
+LevelSetEvolutionComputeIterationThreader<
+      LevelSetSparseImage< int8_t, VDimension >,
+      ThreadedIteratorRangePartitioner< typename LevelSetSparseImage< int8_t, VDimension >::LayerConstIterator >,
+      TLevelSetEvolution >
+::LevelSetEvolutionComputeIterationThreader()
+{
+}
+
+template< unsigned int VDimension, typename TLevelSetEvolution >
+void
+LevelSetEvolutionComputeIterationThreader<
+      LevelSetSparseImage< int8_t, VDimension >,
+      ThreadedIteratorRangePartitioner< typename LevelSetSparseImage< int8_t, VDimension >::LayerConstIterator >,
+      TLevelSetEvolution >
+::BeforeThreadedExecution()
+{
+  const ThreadIdType numberOfThreads = this->GetNumberOfThreadsUsed();
+  this->m_NodePairsPerThread.resize( numberOfThreads );
+
+  for( ThreadIdType ii = 0; ii < numberOfThreads; ++ii )
+    {
+    this->m_NodePairsPerThread[ii].clear();
+    }
+}
+
+template< unsigned int VDimension, typename TLevelSetEvolution >
+void
+LevelSetEvolutionComputeIterationThreader<
+      LevelSetSparseImage< int8_t, VDimension >,
+      ThreadedIteratorRangePartitioner< typename LevelSetSparseImage< int8_t, VDimension >::LayerConstIterator >,
+      TLevelSetEvolution >
+::ThreadedExecution( const DomainType & iteratorSubRange,
+                     const ThreadIdType threadId )
+{
+  typename LevelSetContainerType::Iterator it = this->m_Associate->m_LevelSetContainerIteratorToProcessWhenThreading;
+  typename LevelSetType::ConstPointer levelSet = it->GetLevelSet();
+
+  LevelSetIdentifierType levelSetId = it->GetIdentifier();
+  OffsetType offset = levelSet->GetDomainOffset();
+
+  typename TermContainerType::Pointer termContainer = this->m_Associate->m_EquationContainer->GetEquation( levelSetId );
+
+  typename LevelSetType::LayerConstIterator listIt = iteratorSubRange.Begin();
+
+  while( listIt != iteratorSubRange.End() )
+    {
+    const LevelSetInputType levelsetIndex = listIt->first;
+    LevelSetInputType inputIndex = listIt->first + offset;
+
+    const LevelSetOutputRealType update = termContainer->Evaluate( inputIndex );
+
+    LevelSetOutputType sign = NumericTraits< LevelSetOutputType >::ZeroValue();
+    if( update > NumericTraits< LevelSetOutputRealType >::ZeroValue() )
+      {
+      sign = NumericTraits< LevelSetOutputType >::OneValue();
+      }
+    if( update < NumericTraits< LevelSetOutputRealType >::ZeroValue() )
+      {
+      sign = - NumericTraits< LevelSetOutputType >::OneValue();
+      }
+
+    this->m_NodePairsPerThread[threadId].push_back( NodePairType( levelsetIndex, sign ) );
+
+    ++listIt;
+    }
+}
+
+template< unsigned int VDimension, typename TLevelSetEvolution >
+void
+LevelSetEvolutionComputeIterationThreader<
+      LevelSetSparseImage< int8_t, VDimension >,
+      ThreadedIteratorRangePartitioner< typename LevelSetSparseImage< int8_t, VDimension >::LayerConstIterator >,
+      TLevelSetEvolution >
+::AfterThreadedExecution()
+{
+  typename LevelSetEvolutionType::LevelSetLayerType & levelSetLayerUpdateBuffer = this->m_Associate->m_UpdateBuffer;
+
+  const ThreadIdType numberOfThreads = this->GetNumberOfThreadsUsed();
+  for( ThreadIdType ii = 0; ii < numberOfThreads; ++ii )
+    {
+    typename std::vector< NodePairType >::const_iterator pairIt = this->m_NodePairsPerThread[ii].begin();
+    while( pairIt != this->m_NodePairsPerThread[ii].end() )
+      {
+      levelSetLayerUpdateBuffer.insert( levelSetLayerUpdateBuffer.end(), *pairIt );
       ++pairIt;
       }
     }
@@ -0,0 +1,102 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSparseLevelSetLayerScanThreader_h
+#define itkSparseLevelSetLayerScanThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkThreadedIteratorRangePartitioner.h"
+
+namespace itk
+{
+
+/** \class SparseLevelSetLayerScanThreader
+ * \brief Thread the scan of a layer in the update of a sparse level set.
+ *
+ * The layer is split in ranges of consecutive points, and each range is
+ * scanned by a method of the update class, which must only read the level
+ * set. The results are returned in the order of the layer, so that the
+ * update class can then move the points on one thread, in the same order as
+ * if the layer had been scanned on one thread.
+ *
+ * \tparam TLayer Layer of the sparse level set
+ * \tparam TResult Result of the scan of one point of the layer
+ * \tparam TAssociate Update class which scans the layer
+ *
+ * \ingroup ITKLevelSetsv4
+ */
+template< typename TLayer, typename TResult, typename TAssociate >
+class SparseLevelSetLayerScanThreader
+  : public DomainThreader< ThreadedIteratorRangePartitioner< typename TLayer::const_iterator >, TAssociate >
+{
+public:
+  /** Standard class typedefs. */
+  typedef SparseLevelSetLayerScanThreader                                                                   Self;
+  typedef DomainThreader< ThreadedIteratorRangePartitioner< typename TLayer::const_iterator >, TAssociate > Superclass;
+  typedef SmartPointer< Self >                                                                              Pointer;
+  typedef SmartPointer< const Self >                                                                        ConstPointer;
+
+  /** Run time type information. */
+  itkTypeMacro( SparseLevelSetLayerScanThreader, DomainThreader );
+
+  /** Standard New macro. */
+  itkNewMacro( Self );
+
+  /** Superclass types. */
+  typedef typename Superclass::DomainType    DomainType;
+  typedef typename Superclass::AssociateType AssociateType;
+
+  typedef TLayer                             LayerType;
+  typedef typename LayerType::const_iterator LayerConstIterator;
+  typedef TResult                            ResultType;
+  typedef std::vector< ResultType >          ResultContainerType;
+
+  /** Method of the associate which appends to the container the results of
+   *  the scan of the points in the range [begin, end) of the layer. */
+  typedef void ( AssociateType::*ScanMethodType )( LayerConstIterator begin,
+                                                    LayerConstIterator end,
+                                                    ResultContainerType & results ) const;
+
+  /** Scan the whole layer with the given method of the associate, and return
+   *  the results in the order of the layer. */
+  const ResultContainerType & Scan( AssociateType * associate, ScanMethodType method, const LayerType & layer );
+
+protected:
+  SparseLevelSetLayerScanThreader();
+
+  virtual void BeforeThreadedExecution() ITK_OVERRIDE;
+
+  virtual void ThreadedExecution( const DomainType & iteratorSubRange, const ThreadIdType threadId ) ITK_OVERRIDE;
+
+  virtual void AfterThreadedExecution() ITK_OVERRIDE;
+
+private:
+  SparseLevelSetLayerScanThreader( const Self & ) ITK_DELETE_FUNCTION;
+  void operator=( const Self & ) ITK_DELETE_FUNCTION;
+
+  ScanMethodType                     m_ScanMethod;
+  std::vector< ResultContainerType > m_ResultsPerThread;
+  ResultContainerType                m_Results;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkSparseLevelSetLayerScanThreader.hxx"
+#endif
+
+#endif
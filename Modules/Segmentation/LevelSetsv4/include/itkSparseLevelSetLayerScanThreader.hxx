@@ -0,0 +1,93 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSparseLevelSetLayerScanThreader_hxx
+#define itkSparseLevelSetLayerScanThreader_hxx
+
+#include "itkSparseLevelSetLayerScanThreader.h"
+
+namespace itk
+{
+
+template< typename TLayer, typename TResult, typename TAssociate >
+SparseLevelSetLayerScanThreader< TLayer, TResult, TAssociate >
+::SparseLevelSetLayerScanThreader() :
+  m_ScanMethod( ITK_NULLPTR )
+{
+}
+
+template< typename TLayer, typename TResult, typename TAssociate >
+const typename SparseLevelSetLayerScanThreader< TLayer, TResult, TAssociate >::ResultContainerType &
+SparseLevelSetLayerScanThreader< TLayer, TResult, TAssociate >
+::Scan( AssociateType * associate, ScanMethodType method, const LayerType & layer )
+{
+  this->m_Results.clear();
+
+  // the partitioner can not split an empty range
+  if( layer.empty() )
+    {
+    return this->m_Results;
+    }
+
+  this->m_ScanMethod = method;
+  this->Execute( associate, DomainType( layer.begin(), layer.end() ) );
+
+  return this->m_Results;
+}
+
+template< typename TLayer, typename TResult, typename TAssociate >
+void
+SparseLevelSetLayerScanThreader< TLayer, TResult, TAssociate >
+::BeforeThreadedExecution()
+{
+  const ThreadIdType numberOfThreads = this->GetNumberOfThreadsUsed();
+  this->m_ResultsPerThread.resize( numberOfThreads );
+
+  for( ThreadIdType ii = 0; ii < numberOfThreads; ++ii )
+    {
+    this->m_ResultsPerThread[ii].clear();
+    }
+}
+
+template< typename TLayer, typename TResult, typename TAssociate >
+void
+SparseLevelSetLayerScanThreader< TLayer, TResult, TAssociate >
+::ThreadedExecution( const DomainType & iteratorSubRange,
+                     const ThreadIdType threadId )
+{
+  ( this->m_Associate->*( this->m_ScanMethod ) )( iteratorSubRange.Begin(), iteratorSubRange.End(),
+                                                  this->m_ResultsPerThread[threadId] );
+}
+
+template< typename TLayer, typename TResult, typename TAssociate >
+void
+SparseLevelSetLayerScanThreader< TLayer, TResult, TAssociate >
+::AfterThreadedExecution()
+{
+  // the threads have the consecutive parts of the layer, so that the results
+  // are appended in the order of the layer
+  const ThreadIdType numberOfThreads = this->GetNumberOfThreadsUsed();
+  for( ThreadIdType ii = 0; ii < numberOfThreads; ++ii )
+    {
+    this->m_Results.insert( this->m_Results.end(),
+                            this->m_ResultsPerThread[ii].begin(), this->m_ResultsPerThread[ii].end() );
+    }
+}
+
+} // end namespace itk
+
+#endif
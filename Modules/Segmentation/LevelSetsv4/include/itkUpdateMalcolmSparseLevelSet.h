@@ -27,6 +27,7 @@
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkLabelMapToLabelImageFilter.h"
 #include "itkLabelImageToLabelMapFilter.h"
+#include "itkSparseLevelSetLayerScanThreader.h"
 
 namespace itk
 {
@@ -36,6 +37,13 @@ namespace itk
  *
  *  \tparam VDimension Dimension of the input space
  *  \tparam TEquationContainer Container of the system of levelset equations
+ *
+ *  With the unphased propagation, the neighbors which join the zero layer are
+ *  found over chunks of the layer on several threads, then the points are
+ *  moved on one thread in the order of the layer. The result does not depend
+ *  on the number of threads. The compaction of the layer runs on one thread,
+ *  since each point depends on the points which have been moved before it.
+ *
  *  \ingroup ITKLevelSetsv4
  */
 template< unsigned int VDimension,
@@ -103,6 +111,14 @@ public:
   itkSetMacro( CurrentLevelSetId, IdentifierType );
   itkGetMacro( CurrentLevelSetId, IdentifierType );
 
+  /** Set the signs of the updates of all points in the zero layer, when they
+   *  were computed beforehand. Otherwise they are computed in Update(). */
+  void SetUpdate( const LevelSetLayerType& update );
+
+  /** Set/Get the maximum number of threads used to scan the zero layer */
+  void SetNumberOfThreads( const ThreadIdType numberOfThreads );
+  ThreadIdType GetNumberOfThreads() const;
+
 protected:
   UpdateMalcolmSparseLevelSet();
   virtual ~UpdateMalcolmSparseLevelSet();
@@ -153,6 +169,20 @@ private:
 
   typedef std::pair< LevelSetInputType, LevelSetOutputType > NodePairType;
 
+  /** For each point of the zero layer, the bits of the active offsets of
+   * its neighbors which join the zero layer */
+  typedef SparseLevelSetLayerScanThreader< LevelSetLayerType, unsigned int, Self > LayerScanThreaderType;
+  typedef typename LayerScanThreaderType::ResultContainerType                      LayerScanResultContainerType;
+  typedef typename LayerScanResultContainerType::const_iterator                    LayerScanResultConstIterator;
+
+  typename LayerScanThreaderType::Pointer m_LayerScanThreader;
+
+  /** Scan the neighbors of the points in [begin, end) of the zero layer which
+   * join the zero layer in EvolveWithUnPhasedPropagation(). The points of the
+   * layer which come before a point are seen as already moved. */
+  void ScanUnPhasedPropagation( LevelSetLayerConstIterator begin, LevelSetLayerConstIterator end,
+                                LayerScanResultContainerType & results ) const;
+
 };
 }
 
@@ -35,6 +35,7 @@ UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
 {
   this->m_Offset.Fill( 0 );
   this->m_OutputLevelSet = LevelSetType::New();
+  this->m_LayerScanThreader = LayerScanThreaderType::New();
 }
 
 template< unsigned int VDimension, typename TEquationContainer >
@@ -67,7 +68,11 @@ UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
   this->m_InternalImage = labelMapToLabelImageFilter->GetOutput();
   this->m_InternalImage->DisconnectPipeline();
 
-  this->FillUpdateContainer();
+  if( this->m_Update.size() != this->m_OutputLevelSet->GetLayer( LevelSetType::ZeroLayer() ).size() )
+    {
+    this->m_Update.clear();
+    this->FillUpdateContainer();
+    }
 
   if( this->m_IsUsingUnPhasedPropagation )
     {
@@ -129,16 +134,43 @@ UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
   outputLabelMap->Graft( labelImageToLabelMapFilter->GetOutput() );
 }
 
+template< unsigned int VDimension,
+          typename TEquationContainer >
+void
+UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
+::SetUpdate( const LevelSetLayerType& update )
+{
+  this->m_Update = update;
+}
+
+template< unsigned int VDimension,
+          typename TEquationContainer >
+void
+UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
+::SetNumberOfThreads( const ThreadIdType numberOfThreads )
+{
+  this->m_LayerScanThreader->SetMaximumNumberOfThreads( numberOfThreads );
+}
+
+template< unsigned int VDimension,
+          typename TEquationContainer >
+ThreadIdType
+UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
+::GetNumberOfThreads() const
+{
+  return this->m_LayerScanThreader->GetMaximumNumberOfThreads();
+}
+
 template< unsigned int VDimension,
           typename TEquationContainer >
 void
 UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
 ::FillUpdateContainer()
 {
-  LevelSetLayerType levelZero = this->m_OutputLevelSet->GetLayer( LevelSetType::ZeroLayer() );
+  const LevelSetLayerType & levelZero = this->m_OutputLevelSet->GetLayer( LevelSetType::ZeroLayer() );
 
-  LevelSetLayerIterator nodeIt = levelZero.begin();
-  LevelSetLayerIterator nodeEnd = levelZero.end();
+  LevelSetLayerConstIterator nodeIt = levelZero.begin();
+  LevelSetLayerConstIterator nodeEnd = levelZero.end();
 
   TermContainerPointer termContainer = this->m_EquationContainer->GetEquation( this->m_CurrentLevelSetId );
 
@@ -205,6 +237,12 @@ UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
 
   LevelSetLayerType insertList;
 
+  // the neighbors which join the zero layer are found on several threads,
+  // then the points are moved on this one in the order of the layer
+  const LayerScanResultContainerType & insertMasks =
+    this->m_LayerScanThreader->Scan( this, &Self::ScanUnPhasedPropagation, levelZero );
+  LayerScanResultConstIterator maskIt = insertMasks.begin();
+
   LevelSetLayerIterator nodeIt = levelZero.begin();
   LevelSetLayerIterator nodeEnd = levelZero.end();
 
@@ -233,9 +271,12 @@ UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
         newValue = LevelSetType::MinusOneLayer();
         }
 
+      const unsigned int insertMask = *maskIt;
+
       LevelSetLayerIterator tempIt = nodeIt;
       ++nodeIt;
       ++upIt;
+      ++maskIt;
       levelZero.erase( tempIt );
 
       this->m_InternalImage->SetPixel( currentIdx, newValue );
@@ -243,17 +284,17 @@ UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
 
       neighIt.SetLocation( currentIdx );
 
+      unsigned int activeOffset = 0;
       for( typename NeighborhoodIteratorType::Iterator
            i = neighIt.Begin();
-           !i.IsAtEnd(); ++i )
+           !i.IsAtEnd(); ++i, ++activeOffset )
         {
-        LevelSetOutputType tempValue = i.Get();
-        if( tempValue * newValue == -1 )
+        if( insertMask & ( 1u << activeOffset ) )
           {
           LevelSetInputType tempIndex =
               neighIt.GetIndex( i.GetNeighborhoodOffset() );
 
-          insertList.insert( NodePairType( tempIndex, tempValue ) );
+          insertList.insert( NodePairType( tempIndex, static_cast< LevelSetOutputType >( -newValue ) ) );
           }
         }
       }
@@ -261,6 +302,7 @@ UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
       {
       ++nodeIt;
       ++upIt;
+      ++maskIt;
       }
     }
 
@@ -485,5 +527,99 @@ UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
     }
 }
 
+template< unsigned int VDimension,
+          typename TEquationContainer >
+void
+UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
+::ScanUnPhasedPropagation( LevelSetLayerConstIterator begin, LevelSetLayerConstIterator end,
+                           LayerScanResultContainerType & results ) const
+{
+  ZeroFluxNeumannBoundaryCondition< LabelImageType > sp_nbc;
+
+  typename NeighborhoodIteratorType::RadiusType radius;
+  radius.Fill( 1 );
+
+  NeighborhoodIteratorType neighIt( radius,
+                                    this->m_InternalImage,
+                                    this->m_InternalImage->GetLargestPossibleRegion() );
+
+  neighIt.OverrideBoundaryCondition( &sp_nbc );
+
+  typename NeighborhoodIteratorType::OffsetType sparse_offset;
+  sparse_offset.Fill( 0 );
+
+  for( unsigned int dim = 0; dim < ImageDimension; dim++ )
+    {
+    sparse_offset[dim] = -1;
+    neighIt.ActivateOffset( sparse_offset );
+    sparse_offset[dim] = 1;
+    neighIt.ActivateOffset( sparse_offset );
+    sparse_offset[dim] = 0;
+    }
+
+  const typename LevelSetLayerType::key_compare precedes = this->m_Update.key_comp();
+
+  LevelSetLayerConstIterator nodeIt = begin;
+  LevelSetLayerConstIterator upIt = this->m_Update.find( begin->first );
+
+  while( nodeIt != end )
+    {
+    const LevelSetInputType currentIdx = nodeIt->first;
+
+    itkAssertInDebugAndIgnoreInReleaseMacro( currentIdx == upIt->first );
+
+    const LevelSetOutputType update = upIt->second;
+
+    unsigned int insertMask = 0;
+
+    if( update != NumericTraits< LevelSetOutputType >::ZeroValue() )
+      {
+      const LevelSetOutputType newValue = ( update > NumericTraits< LevelSetOutputType >::ZeroValue() ) ?
+        LevelSetType::PlusOneLayer() : LevelSetType::MinusOneLayer();
+
+      neighIt.SetLocation( currentIdx );
+
+      unsigned int activeOffset = 0;
+      for( typename NeighborhoodIteratorType::Iterator
+           i = neighIt.Begin();
+           !i.IsAtEnd(); ++i, ++activeOffset )
+        {
+        LevelSetOutputType tempValue = i.Get();
+
+        // the points of the zero layer which come before the current one have
+        // already been moved when it is reached
+        if( tempValue == LevelSetType::ZeroLayer() )
+          {
+          const LevelSetInputType tempIndex = neighIt.GetIndex( i.GetNeighborhoodOffset() );
+          if( precedes( tempIndex, currentIdx ) )
+            {
+            LevelSetLayerConstIterator tempUpIt = this->m_Update.find( tempIndex );
+            if( tempUpIt != this->m_Update.end() )
+              {
+              if( tempUpIt->second > NumericTraits< LevelSetOutputType >::ZeroValue() )
+                {
+                tempValue = LevelSetType::PlusOneLayer();
+                }
+              else if( tempUpIt->second < NumericTraits< LevelSetOutputType >::ZeroValue() )
+                {
+                tempValue = LevelSetType::MinusOneLayer();
+                }
+              }
+            }
+          }
+
+        if( tempValue * newValue == -1 )
+          {
+          insertMask |= ( 1u << activeOffset );
+          }
+        }
+      }
+
+    results.push_back( insertMask );
+    ++nodeIt;
+    ++upIt;
+    }
+}
+
 }
 #endif // itkUpdateMalcolmSparseLevelSet_hxx
@@ -27,6 +27,7 @@
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkLabelMapToLabelImageFilter.h"
 #include "itkLabelImageToLabelMapFilter.h"
+#include "itkSparseLevelSetLayerScanThreader.h"
 
 namespace itk
 {
@@ -36,6 +37,12 @@ namespace itk
  *
  *  \tparam VDimension Dimension of the input space
  *  \tparam TEquationContainer Container of the system of levelset equations
+ *
+ *  The layers are scanned over chunks on several threads, to find the points
+ *  which move to the opposite layer or which are removed, and these points
+ *  are then moved on one thread in the order of the layer. The result does
+ *  not depend on the number of threads.
+ *
  *  \ingroup ITKLevelSetsv4
  */
 template< unsigned int VDimension,
@@ -103,6 +110,15 @@ public:
   itkSetMacro( CurrentLevelSetId, IdentifierType );
   itkGetMacro( CurrentLevelSetId, IdentifierType );
 
+  /** Set the signs of the updates of the points in the layers -1 and +1, when
+   *  they were computed beforehand. The updates of the other points are
+   *  computed when they are needed. */
+  void SetUpdate( const LevelSetLayerType& update );
+
+  /** Set/Get the maximum number of threads used to scan the layers */
+  void SetNumberOfThreads( const ThreadIdType numberOfThreads );
+  ThreadIdType GetNumberOfThreads() const;
+
 protected:
   UpdateShiSparseLevelSet();
   virtual ~UpdateShiSparseLevelSet();
@@ -119,6 +135,8 @@ protected:
 
   LabelImagePointer m_InternalImage;
 
+  LevelSetLayerType m_Update;
+
   typedef ShapedNeighborhoodIterator< LabelImageType > NeighborhoodIteratorType;
 
   /** Update +1 level set layers by checking the direction of the movement towards -1 */
@@ -130,6 +148,10 @@ protected:
   /** Update -1 level set layers by checking the direction of the movement towards +1 */
   void UpdateLayerMinusOne();
 
+  /** Return the update at the given point of the level set domain, taken from
+   *  the ones set with SetUpdate when it is there */
+  LevelSetOutputRealType EvaluateUpdate( const LevelSetInputType& idx ) const;
+
   /** Return true if there is a pixel from the opposite layer (+1 or -1) moving in the same direction */
   bool Con( const LevelSetInputType& idx,
             const LevelSetOutputType& currentStatus,
@@ -144,6 +166,33 @@ private:
   LevelSetOffsetType m_Offset;
 
   typedef std::pair< LevelSetInputType, LevelSetOutputType > NodePairType;
+
+  /** Whether each point of a layer moves to the opposite layer, or is
+   * removed from the layer */
+  typedef SparseLevelSetLayerScanThreader< LevelSetLayerType, bool, Self > LayerScanThreaderType;
+  typedef typename LayerScanThreaderType::ResultContainerType              LayerScanResultContainerType;
+  typedef typename LayerScanResultContainerType::const_iterator            LayerScanResultConstIterator;
+
+  typename LayerScanThreaderType::Pointer m_LayerScanThreader;
+
+  /** Scan whether the points in [begin, end) of the layer status move to the
+   * opposite layer */
+  void ScanMoves( LevelSetLayerConstIterator begin, LevelSetLayerConstIterator end,
+                  const LevelSetOutputType& status, LayerScanResultContainerType & results ) const;
+
+  /** Scan whether the points in [begin, end) of the layer status have no
+   * neighbor on the other side of the zero level set, and are removed */
+  void ScanRemovals( LevelSetLayerConstIterator begin, LevelSetLayerConstIterator end,
+                     const LevelSetOutputType& status, LayerScanResultContainerType & results ) const;
+
+  void ScanMovesOfLayerPlusOne( LevelSetLayerConstIterator begin, LevelSetLayerConstIterator end,
+                                LayerScanResultContainerType & results ) const;
+  void ScanMovesOfLayerMinusOne( LevelSetLayerConstIterator begin, LevelSetLayerConstIterator end,
+                                 LayerScanResultContainerType & results ) const;
+  void ScanRemovalsOfLayerPlusOne( LevelSetLayerConstIterator begin, LevelSetLayerConstIterator end,
+                                   LayerScanResultContainerType & results ) const;
+  void ScanRemovalsOfLayerMinusOne( LevelSetLayerConstIterator begin, LevelSetLayerConstIterator end,
+                                    LayerScanResultContainerType & results ) const;
 };
 }
 
@@ -32,6 +32,7 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
 {
   this->m_Offset.Fill( 0 );
   this->m_OutputLevelSet = LevelSetType::New();
+  this->m_LayerScanThreader = LayerScanThreaderType::New();
 }
 
 template< unsigned int VDimension,
@@ -41,6 +42,30 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
 {}
 
 
+template< unsigned int VDimension, typename TEquationContainer >
+void
+UpdateShiSparseLevelSet< VDimension, TEquationContainer >
+::SetUpdate( const LevelSetLayerType& update )
+{
+  this->m_Update = update;
+}
+
+template< unsigned int VDimension, typename TEquationContainer >
+void
+UpdateShiSparseLevelSet< VDimension, TEquationContainer >
+::SetNumberOfThreads( const ThreadIdType numberOfThreads )
+{
+  this->m_LayerScanThreader->SetMaximumNumberOfThreads( numberOfThreads );
+}
+
+template< unsigned int VDimension, typename TEquationContainer >
+ThreadIdType
+UpdateShiSparseLevelSet< VDimension, TEquationContainer >
+::GetNumberOfThreads() const
+{
+  return this->m_LayerScanThreader->GetMaximumNumberOfThreads();
+}
+
 template< unsigned int VDimension, typename TEquationContainer >
 void
 UpdateShiSparseLevelSet< VDimension, TEquationContainer >
@@ -69,35 +94,17 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
   this->m_InternalImage = labelMapToLabelImageFilter->GetOutput();
   this->m_InternalImage->DisconnectPipeline();
 
-  // neighborhood iterator
-  ZeroFluxNeumannBoundaryCondition< LabelImageType > spNBC;
-
-  typename NeighborhoodIteratorType::RadiusType radius;
-  radius.Fill( 1 );
-
-  NeighborhoodIteratorType neighIt( radius, this->m_InternalImage,
-                                    this->m_InternalImage->GetLargestPossibleRegion() );
-
-  neighIt.OverrideBoundaryCondition( &spNBC );
-
-  typename NeighborhoodIteratorType::OffsetType sparseOffset;
-  sparseOffset.Fill( 0 );
-
-  for( unsigned int dim = 0; dim < ImageDimension; ++dim )
-    {
-    sparseOffset[dim] = -1;
-    neighIt.ActivateOffset( sparseOffset );
-    sparseOffset[dim] = 1;
-    neighIt.ActivateOffset( sparseOffset );
-    sparseOffset[dim] = 0;
-    }
-
   // Step 2.1.1
   this->UpdateLayerPlusOne();
 
  // Step 2.1.2 - for each point x in L_out
   LevelSetLayerType & listIn = this->m_OutputLevelSet->GetLayer( LevelSetType::MinusOneLayer() );
 
+  // removing a point does not change whether the others are removed
+  const LayerScanResultContainerType & removalsIn =
+    this->m_LayerScanThreader->Scan( this, &Self::ScanRemovalsOfLayerMinusOne, listIn );
+  LayerScanResultConstIterator removalIt = removalsIn.begin();
+
   LevelSetLayerIterator nodeIt = listIn.begin();
   LevelSetLayerIterator nodeEnd = listIn.end();
 
@@ -107,20 +114,9 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
     const LevelSetInputType currentIndex = nodeIt->first;
     inputIndex = currentIndex + this->m_Offset;
 
-    neighIt.SetLocation( currentIndex );
-
-    bool toBeDeleted = true;
+    const bool toBeDeleted = *removalIt;
+    ++removalIt;
 
-    for( typename NeighborhoodIteratorType::Iterator
-         i = neighIt.Begin(); !i.IsAtEnd(); ++i )
-      {
-      LevelSetOutputType tempValue = i.Get();
-      if ( tempValue > NumericTraits< LevelSetOutputType >::ZeroValue() )
-        {
-        toBeDeleted = false;
-        break;
-        }
-      }
     if( toBeDeleted )
       {
       const LevelSetOutputType oldValue = LevelSetType::MinusOneLayer();
@@ -146,26 +142,21 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
 //     Step 2.1.4
   LevelSetLayerType & listOut = this->m_OutputLevelSet->GetLayer( LevelSetType::PlusOneLayer() );
 
+  const LayerScanResultContainerType & removalsOut =
+    this->m_LayerScanThreader->Scan( this, &Self::ScanRemovalsOfLayerPlusOne, listOut );
+  removalIt = removalsOut.begin();
+
   nodeIt = listOut.begin();
   nodeEnd = listOut.end();
 
   while( nodeIt != nodeEnd )
     {
     const LevelSetInputType currentIndex = nodeIt->first;
+    inputIndex = currentIndex + this->m_Offset;
 
-    neighIt.SetLocation( currentIndex );
-
-    bool toBeDeleted = true;
+    const bool toBeDeleted = *removalIt;
+    ++removalIt;
 
-    for( typename NeighborhoodIteratorType::Iterator i = neighIt.Begin(); !i.IsAtEnd(); ++i )
-      {
-      LevelSetOutputType tempValue = i.Get();
-      if ( tempValue < NumericTraits< LevelSetOutputType >::ZeroValue() )
-        {
-        toBeDeleted = false;
-        break;
-        }
-      }
     if( toBeDeleted )
       {
       const LevelSetOutputType oldValue = LevelSetType::PlusOneLayer();
@@ -229,54 +220,51 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
   LevelSetLayerType insertListIn;
   LevelSetLayerType insertListOut;
 
+  // the points which move are found on several threads, then moved on this
+  // one in the order of the layer
+  const LayerScanResultContainerType & moves =
+    this->m_LayerScanThreader->Scan( this, &Self::ScanMovesOfLayerPlusOne, listOut );
+  LayerScanResultConstIterator moveIt = moves.begin();
+
   LevelSetLayerIterator nodeIt   = listOut.begin();
   LevelSetLayerIterator nodeEnd  = listOut.end();
 
-  LevelSetInputType inputIndex;
-
   // for each point in Lz
   while( nodeIt != nodeEnd )
     {
     bool erased = false;
-    const LevelSetInputType   currentIndex = nodeIt->first;
-    const LevelSetOutputType  currentValue = nodeIt->second;
-    inputIndex = currentIndex + this->m_Offset;
-
-    // update the level set
-    LevelSetOutputRealType update = termContainer->Evaluate( inputIndex );
+    const LevelSetInputType currentIndex = nodeIt->first;
 
-    if( update < NumericTraits< LevelSetOutputRealType >::ZeroValue() )
+    if( *moveIt )
       {
-      if( Con( currentIndex, currentValue , update ) )
-        {
-        // CheckIn
-        insertListIn.insert(
-              NodePairType( currentIndex, LevelSetType::MinusOneLayer() ) );
+      // CheckIn
+      insertListIn.insert(
+            NodePairType( currentIndex, LevelSetType::MinusOneLayer() ) );
 
-        LevelSetLayerIterator tempIt = nodeIt;
-        ++nodeIt;
-        listOut.erase( tempIt );
-        erased = true;
+      LevelSetLayerIterator tempIt = nodeIt;
+      ++nodeIt;
+      listOut.erase( tempIt );
+      erased = true;
 
-        neighIt.SetLocation( currentIndex );
+      neighIt.SetLocation( currentIndex );
 
-        for( typename NeighborhoodIteratorType::Iterator
-            i = neighIt.Begin();
-            !i.IsAtEnd(); ++i )
-          {
-          LevelSetOutputType tempValue = i.Get();
+      for( typename NeighborhoodIteratorType::Iterator
+          i = neighIt.Begin();
+          !i.IsAtEnd(); ++i )
+        {
+        LevelSetOutputType tempValue = i.Get();
 
-          if ( tempValue == LevelSetType::PlusThreeLayer() )
-            {
-            LevelSetInputType tempIndex =
-                neighIt.GetIndex( i.GetNeighborhoodOffset() );
+        if ( tempValue == LevelSetType::PlusThreeLayer() )
+          {
+          LevelSetInputType tempIndex =
+              neighIt.GetIndex( i.GetNeighborhoodOffset() );
 
-            insertListOut.insert(
-                  NodePairType( tempIndex, LevelSetType::PlusOneLayer() ) );
-            }
+          insertListOut.insert(
+                NodePairType( tempIndex, LevelSetType::PlusOneLayer() ) );
           }
         }
       }
+    ++moveIt;
     if( !erased )
       {
       ++nodeIt;
@@ -346,6 +334,12 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
   LevelSetLayerType insertListIn;
   LevelSetLayerType insertListOut;
 
+  // the points which move are found on several threads, then moved on this
+  // one in the order of the layer
+  const LayerScanResultContainerType & moves =
+    this->m_LayerScanThreader->Scan( this, &Self::ScanMovesOfLayerMinusOne, listIn );
+  LayerScanResultConstIterator moveIt = moves.begin();
+
   LevelSetLayerIterator nodeIt   = listIn.begin();
   LevelSetLayerIterator nodeEnd  = listIn.end();
 
@@ -353,43 +347,36 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
   while( nodeIt != nodeEnd )
     {
     bool erased = false;
-    const LevelSetInputType   currentIndex = nodeIt->first;
-    const LevelSetOutputType  currentValue = nodeIt->second;
-    const LevelSetInputType inputIndex = currentIndex + this->m_Offset;
-
-    // update for the current level set
-    LevelSetOutputRealType update = termContainer->Evaluate( inputIndex );
+    const LevelSetInputType currentIndex = nodeIt->first;
 
-    if( update > NumericTraits< LevelSetOutputRealType >::ZeroValue() )
+    if( *moveIt )
       {
-      if( Con( currentIndex, currentValue , update ) )
-        {
-        // CheckOut
-        insertListOut.insert(
-              NodePairType( currentIndex, LevelSetType::PlusOneLayer() ) );
+      // CheckOut
+      insertListOut.insert(
+            NodePairType( currentIndex, LevelSetType::PlusOneLayer() ) );
 
-        LevelSetLayerIterator tempIt = nodeIt;
-        ++nodeIt;
-        listIn.erase( tempIt );
+      LevelSetLayerIterator tempIt = nodeIt;
+      ++nodeIt;
+      listIn.erase( tempIt );
 
-        erased = true;
+      erased = true;
 
-        neighIt.SetLocation( currentIndex );
+      neighIt.SetLocation( currentIndex );
 
-        for( typename NeighborhoodIteratorType::Iterator
-            i = neighIt.Begin(); !i.IsAtEnd(); ++i )
-          {
-          LevelSetOutputType tempValue = i.Get();
+      for( typename NeighborhoodIteratorType::Iterator
+          i = neighIt.Begin(); !i.IsAtEnd(); ++i )
+        {
+        LevelSetOutputType tempValue = i.Get();
 
-          if ( tempValue == LevelSetType::MinusThreeLayer() )
-            {
-            LevelSetInputType tempIndex = neighIt.GetIndex( i.GetNeighborhoodOffset() );
+        if ( tempValue == LevelSetType::MinusThreeLayer() )
+          {
+          LevelSetInputType tempIndex = neighIt.GetIndex( i.GetNeighborhoodOffset() );
 
-            insertListIn.insert( NodePairType( tempIndex, LevelSetType::MinusOneLayer() ) );
-            }
+          insertListIn.insert( NodePairType( tempIndex, LevelSetType::MinusOneLayer() ) );
           }
         }
       }
+    ++moveIt;
     if( !erased )
       {
       ++nodeIt;
@@ -422,14 +409,27 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
 }
 
 
+template< unsigned int VDimension, typename TEquationContainer >
+typename UpdateShiSparseLevelSet< VDimension, TEquationContainer >::LevelSetOutputRealType
+UpdateShiSparseLevelSet< VDimension, TEquationContainer >
+::EvaluateUpdate( const LevelSetInputType& idx ) const
+{
+  LevelSetLayerConstIterator upIt = this->m_Update.find( idx );
+  if( upIt != this->m_Update.end() )
+    {
+    return static_cast< LevelSetOutputRealType >( upIt->second );
+    }
+
+  TermContainerPointer termContainer = this->m_EquationContainer->GetEquation( this->m_CurrentLevelSetId );
+  return termContainer->Evaluate( idx + this->m_Offset );
+}
+
 template< unsigned int VDimension, typename TEquationContainer >
 bool
 UpdateShiSparseLevelSet< VDimension, TEquationContainer >
 ::Con( const LevelSetInputType& idx, const LevelSetOutputType& currentStatus,
        const LevelSetOutputRealType& currentUpdate ) const
 {
-  TermContainerPointer termContainer = this->m_EquationContainer->GetEquation( this->m_CurrentLevelSetId );
-
   ZeroFluxNeumannBoundaryCondition< LabelImageType > spNBC;
 
   typename NeighborhoodIteratorType::RadiusType radius;
@@ -465,7 +465,7 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
       {
       LevelSetInputType tempIdx = neighIt.GetIndex( i.GetNeighborhoodOffset() );
 
-      LevelSetOutputRealType neighborUpdate = termContainer->Evaluate( tempIdx + this->m_Offset );
+      LevelSetOutputRealType neighborUpdate = this->EvaluateUpdate( tempIdx );
 
       if ( neighborUpdate * currentUpdate > NumericTraits< LevelSetOutputType >::ZeroValue() )
         {
@@ -476,6 +476,120 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
  return false;
 }
 
+template< unsigned int VDimension, typename TEquationContainer >
+void
+UpdateShiSparseLevelSet< VDimension, TEquationContainer >
+::ScanMoves( LevelSetLayerConstIterator begin, LevelSetLayerConstIterator end,
+             const LevelSetOutputType& status, LayerScanResultContainerType & results ) const
+{
+  LevelSetLayerConstIterator nodeIt = begin;
+  while( nodeIt != end )
+    {
+    const LevelSetInputType currentIndex = nodeIt->first;
+
+    // update the level set
+    const LevelSetOutputRealType update = this->EvaluateUpdate( currentIndex );
+
+    bool moves = false;
+    if( ( status == LevelSetType::PlusOneLayer() ) ?
+        ( update < NumericTraits< LevelSetOutputRealType >::ZeroValue() ) :
+        ( update > NumericTraits< LevelSetOutputRealType >::ZeroValue() ) )
+      {
+      moves = this->Con( currentIndex, nodeIt->second, update );
+      }
+    results.push_back( moves );
+    ++nodeIt;
+    }
+}
+
+template< unsigned int VDimension, typename TEquationContainer >
+void
+UpdateShiSparseLevelSet< VDimension, TEquationContainer >
+::ScanRemovals( LevelSetLayerConstIterator begin, LevelSetLayerConstIterator end,
+                const LevelSetOutputType& status, LayerScanResultContainerType & results ) const
+{
+  ZeroFluxNeumannBoundaryCondition< LabelImageType > spNBC;
+
+  typename NeighborhoodIteratorType::RadiusType radius;
+  radius.Fill( 1 );
+
+  NeighborhoodIteratorType neighIt( radius, this->m_InternalImage,
+                                    this->m_InternalImage->GetLargestPossibleRegion() );
+
+  neighIt.OverrideBoundaryCondition( &spNBC );
+
+  typename NeighborhoodIteratorType::OffsetType sparseOffset;
+  sparseOffset.Fill( 0 );
+
+  for( unsigned int dim = 0; dim < ImageDimension; ++dim )
+    {
+    sparseOffset[dim] = -1;
+    neighIt.ActivateOffset( sparseOffset );
+    sparseOffset[dim] = 1;
+    neighIt.ActivateOffset( sparseOffset );
+    sparseOffset[dim] = 0;
+    }
+
+  LevelSetLayerConstIterator nodeIt = begin;
+  while( nodeIt != end )
+    {
+    neighIt.SetLocation( nodeIt->first );
+
+    // a point is removed when none of its neighbors is on the other side
+    bool toBeDeleted = true;
+
+    for( typename NeighborhoodIteratorType::Iterator i = neighIt.Begin(); !i.IsAtEnd(); ++i )
+      {
+      const LevelSetOutputType tempValue = i.Get();
+      if( ( status == LevelSetType::MinusOneLayer() ) ?
+          ( tempValue > NumericTraits< LevelSetOutputType >::ZeroValue() ) :
+          ( tempValue < NumericTraits< LevelSetOutputType >::ZeroValue() ) )
+        {
+        toBeDeleted = false;
+        break;
+        }
+      }
+    results.push_back( toBeDeleted );
+    ++nodeIt;
+    }
+}
+
+template< unsigned int VDimension, typename TEquationContainer >
+void
+UpdateShiSparseLevelSet< VDimension, TEquationContainer >
+::ScanMovesOfLayerPlusOne( LevelSetLayerConstIterator begin, LevelSetLayerConstIterator end,
+                           LayerScanResultContainerType & results ) const
+{
+  this->ScanMoves( begin, end, LevelSetType::PlusOneLayer(), results );
+}
+
+template< unsigned int VDimension, typename TEquationContainer >
+void
+UpdateShiSparseLevelSet< VDimension, TEquationContainer >
+::ScanMovesOfLayerMinusOne( LevelSetLayerConstIterator begin, LevelSetLayerConstIterator end,
+                            LayerScanResultContainerType & results ) const
+{
+  this->ScanMoves( begin, end, LevelSetType::MinusOneLayer(), results );
+}
+
+template< unsigned int VDimension, typename TEquationContainer >
+void
+UpdateShiSparseLevelSet< VDimension, TEquationContainer >
+::ScanRemovalsOfLayerPlusOne( LevelSetLayerConstIterator begin, LevelSetLayerConstIterator end,
+                              LayerScanResultContainerType & results ) const
+{
+  this->ScanRemovals( begin, end, LevelSetType::PlusOneLayer(), results );
+}
+
+template< unsigned int VDimension, typename TEquationContainer >
+void
+UpdateShiSparseLevelSet< VDimension, TEquationContainer >
+::ScanRemovalsOfLayerMinusOne( LevelSetLayerConstIterator begin, LevelSetLayerConstIterator end,
+                               LayerScanResultContainerType & results ) const
+{
+  this->ScanRemovals( begin, end, LevelSetType::MinusOneLayer(), results );
+}
+
 } // end namespace itk
 
 #endif // itkUpdateShiSparseLevelSet_hxx
@@ -27,6 +27,8 @@
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkLabelMapToLabelImageFilter.h"
 #include "itkLabelImageToLabelMapFilter.h"
+#include "itkSparseLevelSetLayerScanThreader.h"
+#include "itksys/hash_map.hxx"
 
 namespace itk
 {
@@ -37,6 +39,14 @@ namespace itk
  *  \tparam VDimension Dimension of the input space
  *  \tparam TLevelSetValueType Output type (float or double) of the levelset function
  *  \tparam TEquationContainer Container of the system of levelset equations
+ *
+ *  The layers -2, -1, +1 and +2 are updated in two passes: the neighborhoods
+ *  of their points are first scanned over chunks of the layer on several
+ *  threads, then the points are moved, and the terms updated, on one thread
+ *  in the order of the layer. The result does not depend on the number of
+ *  threads. The zero layer is updated on one thread, since its points read
+ *  the values of the neighbors which have already been updated.
+ *
  *  \ingroup ITKLevelSetsv4
  */
 template< unsigned int VDimension,
@@ -123,6 +133,10 @@ public:
   /** Set the update map for all points in the zero layer */
   void SetUpdate( const LevelSetLayerType& update );
 
+  /** Set/Get the maximum number of threads used to scan the layers */
+  void SetNumberOfThreads( const ThreadIdType numberOfThreads );
+  ThreadIdType GetNumberOfThreads() const;
+
 protected:
   UpdateWhitakerSparseLevelSet();
   virtual ~UpdateWhitakerSparseLevelSet();
@@ -172,7 +186,49 @@ private:
   LevelSetPointer    m_OutputLevelSet;
 
   LevelSetPointer   m_TempLevelSet;
-  LevelSetLayerType m_TempPhi;
+
+  /** The values of the points of the layers, and of their neighbors in the
+   * layers -3 and 3, by the offset of their index in m_InternalImage. */
+  typedef itksys::hash_map< OffsetValueType, LevelSetOutputType > TempPhiType;
+  typedef typename TempPhiType::iterator                          TempPhiIterator;
+
+  TempPhiType m_TempPhi;
+
+  /** Returns the value of index in m_TempPhi, or m_TempPhi.end() if index
+   * has no value or is outside of m_InternalImage. */
+  TempPhiIterator FindTempPhi( const LevelSetInputType& index );
+
+  /** Sets the value of index in m_TempPhi, if index is inside of
+   * m_InternalImage. */
+  void SetTempPhi( const LevelSetInputType& index, const LevelSetOutputType& value );
+
+  /** Gets the value of index in m_TempPhi, and returns false if index has no
+   * value or is outside of m_InternalImage. */
+  bool GetTempPhi( const LevelSetInputType& index, LevelSetOutputType& value ) const;
+
+  /** Whether a point has a neighbor in the next layer towards the zero
+   * layer, and the extremum of the values of its neighbors in that direction. */
+  typedef std::pair< bool, LevelSetOutputType > LayerScanResultType;
+
+  typedef SparseLevelSetLayerScanThreader< LevelSetLayerType, LayerScanResultType, Self > LayerScanThreaderType;
+  typedef typename LayerScanThreaderType::ResultContainerType                             LayerScanResultContainerType;
+  typedef typename LayerScanResultContainerType::const_iterator                           LayerScanResultConstIterator;
+
+  typename LayerScanThreaderType::Pointer m_LayerScanThreader;
+
+  /** Scan the points in [begin, end) of the layer layerId, only reading
+   * m_InternalImage and m_TempPhi. */
+  void ScanLayer( LevelSetLayerConstIterator begin, LevelSetLayerConstIterator end,
+                  const LevelSetLayerIdType layerId, LayerScanResultContainerType & results ) const;
+
+  void ScanLayerMinus1( LevelSetLayerConstIterator begin, LevelSetLayerConstIterator end,
+                        LayerScanResultContainerType & results ) const;
+  void ScanLayerPlus1( LevelSetLayerConstIterator begin, LevelSetLayerConstIterator end,
+                       LayerScanResultContainerType & results ) const;
+  void ScanLayerMinus2( LevelSetLayerConstIterator begin, LevelSetLayerConstIterator end,
+                        LayerScanResultContainerType & results ) const;
+  void ScanLayerPlus2( LevelSetLayerConstIterator begin, LevelSetLayerConstIterator end,
+                       LayerScanResultContainerType & results ) const;
 
   LevelSetLayerIdType m_MinStatus;
   LevelSetLayerIdType m_MaxStatus;
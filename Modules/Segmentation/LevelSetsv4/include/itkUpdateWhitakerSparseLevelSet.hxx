@@ -36,6 +36,7 @@ m_MaxStatus( LevelSetType::PlusThreeLayer() )
   this->m_Offset.Fill( 0 );
   this->m_TempLevelSet = LevelSetType::New();
   this->m_OutputLevelSet = LevelSetType::New();
+  this->m_LayerScanThreader = LayerScanThreaderType::New();
 }
 
 template< unsigned int VDimension,
@@ -54,6 +55,24 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
   this->m_Update = update;
 }
 
+template< unsigned int VDimension,
+          typename TLevelSetValueType,
+          typename TEquationContainer >
+void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationContainer >
+::SetNumberOfThreads( const ThreadIdType numberOfThreads )
+{
+  this->m_LayerScanThreader->SetMaximumNumberOfThreads( numberOfThreads );
+}
+
+template< unsigned int VDimension,
+          typename TLevelSetValueType,
+          typename TEquationContainer >
+ThreadIdType UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationContainer >
+::GetNumberOfThreads() const
+{
+  return this->m_LayerScanThreader->GetMaximumNumberOfThreads();
+}
+
 template< unsigned int VDimension,
           typename TLevelSetValueType,
           typename TEquationContainer >
@@ -98,12 +117,12 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
   // Here, we are adding all pairs of indices and levelset values to a map
   for( LevelSetLayerIdType status = LevelSetType::MinusOneLayer(); status < LevelSetType::PlusTwoLayer(); ++status )
     {
-    const LevelSetLayerType layer = this->m_InputLevelSet->GetLayer( status );
+    const LevelSetLayerType & layer = this->m_InputLevelSet->GetLayer( status );
 
     LevelSetLayerConstIterator it = layer.begin();
     while( it != layer.end() )
       {
-      this->m_TempPhi[ it->first ] = it->second;
+      this->m_TempPhi[ this->m_InternalImage->ComputeOffset( it->first ) ] = it->second;
       ++it;
       }
     }
@@ -137,7 +156,7 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
   while( it != layerMinus2.end() )
     {
     const LevelSetInputType currentIndex = it->first;
-    this->m_TempPhi[ currentIndex ] = LevelSetType::MinusTwoLayer();
+    this->SetTempPhi( currentIndex, LevelSetType::MinusTwoLayer() );
     neighIt.SetLocation( currentIndex );
 
     for( typename NeighborhoodIteratorType::Iterator nIt = neighIt.Begin();
@@ -147,20 +166,20 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
       if( nIt.Get() == LevelSetType::MinusThreeLayer() )
         {
         const LevelSetInputType neighborIndex = neighIt.GetIndex( nIt.GetNeighborhoodOffset() );
-        this->m_TempPhi[ neighborIndex ] = LevelSetType::MinusThreeLayer();
+        this->SetTempPhi( neighborIndex, LevelSetType::MinusThreeLayer() );
         }
       }
 
     ++it;
     }
 
-  LevelSetLayerType layerPlus2 = this->m_InputLevelSet->GetLayer( LevelSetType::PlusTwoLayer() );
+  const LevelSetLayerType & layerPlus2 = this->m_InputLevelSet->GetLayer( LevelSetType::PlusTwoLayer() );
 
   it = layerPlus2.begin();
   while( it != layerPlus2.end() )
     {
     LevelSetInputType currentIndex = it->first;
-    this->m_TempPhi[ currentIndex ] = LevelSetType::PlusTwoLayer();
+    this->SetTempPhi( currentIndex, LevelSetType::PlusTwoLayer() );
     neighIt.SetLocation( currentIndex );
 
     for( typename NeighborhoodIteratorType::Iterator nIt = neighIt.Begin();
@@ -170,7 +189,7 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
       if( nIt.Get() == LevelSetType::PlusThreeLayer() )
         {
         LevelSetInputType neighborIndex = neighIt.GetIndex( nIt.GetNeighborhoodOffset() );
-        this->m_TempPhi[ neighborIndex ] = LevelSetType::PlusThreeLayer();
+        this->SetTempPhi( neighborIndex, LevelSetType::PlusThreeLayer() );
         }
       }
 
@@ -281,7 +300,7 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
           {
           LevelSetInputType tempIndex = neighIt.GetIndex( it.GetNeighborhoodOffset() );
 
-          LevelSetLayerIterator tit = this->m_TempPhi.find( tempIndex );
+          TempPhiIterator tit = this->FindTempPhi( tempIndex );
 
           if( tit != this->m_TempPhi.end() )
             {
@@ -295,7 +314,7 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
 
       if( samedirection )
         {
-        LevelSetLayerIterator tit = this->m_TempPhi.find( currentIndex );
+        TempPhiIterator tit = this->FindTempPhi( currentIndex );
 
         if( tit != this->m_TempPhi.end() )
           {
@@ -305,7 +324,7 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
         else
           {
           // Kishore: Never comes here?
-          this->m_TempPhi.insert( NodePairType( currentIndex, tempValue ) );
+          this->SetTempPhi( currentIndex, tempValue );
           }
 
         LevelSetLayerIterator tempIt = nodeIt;
@@ -337,7 +356,7 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
             {
             LevelSetInputType tempIndex = neighIt.GetIndex( it.GetNeighborhoodOffset() );
 
-            LevelSetLayerIterator tit = this->m_TempPhi.find( tempIndex );
+            TempPhiIterator tit = this->FindTempPhi( tempIndex );
             if( tit != this->m_TempPhi.end() )
               {
               if( tit->second > 0.5 )
@@ -350,7 +369,7 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
 
         if( samedirection )
           {
-          LevelSetLayerIterator tit = this->m_TempPhi.find( currentIndex );
+          TempPhiIterator tit = this->FindTempPhi( currentIndex );
 
           if( tit != this->m_TempPhi.end() )
             { // change values
@@ -359,7 +378,7 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
             }
           else
             {// Kishore: Can this happen?
-            this->m_TempPhi.insert( NodePairType( currentIndex, tempValue ) );
+            this->SetTempPhi( currentIndex, tempValue );
             }
 
           LevelSetLayerIterator tempIt = nodeIt;
@@ -377,7 +396,7 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
       }
     else // -0.5 <= temp <= 0.5
       {
-      LevelSetLayerIterator it = this->m_TempPhi.find( currentIndex );
+      TempPhiIterator it = this->FindTempPhi( currentIndex );
 
       if( it != this->m_TempPhi.end() )
         { // change values
@@ -399,29 +418,6 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
 {
   TermContainerPointer termContainer = this->m_EquationContainer->GetEquation( this->m_CurrentLevelSetId );
 
-  ZeroFluxNeumannBoundaryCondition< LabelImageType > spNBC;
-
-  typename NeighborhoodIteratorType::RadiusType radius;
-  radius.Fill( 1 );
-
-  NeighborhoodIteratorType neighIt( radius,
-                                    this->m_InternalImage,
-                                    this->m_InternalImage->GetLargestPossibleRegion() );
-
-  neighIt.OverrideBoundaryCondition( &spNBC );
-
-  typename NeighborhoodIteratorType::OffsetType neighOffset;
-  neighOffset.Fill( 0 );
-
-  for( unsigned int dim = 0; dim < ImageDimension; dim++ )
-    {
-    neighOffset[dim] = -1;
-    neighIt.ActivateOffset( neighOffset );
-    neighOffset[dim] = 1;
-    neighIt.ActivateOffset( neighOffset );
-    neighOffset[dim] = 0;
-    }
-
   LevelSetLayerType& outputlayerMinus1 = this->m_OutputLevelSet->GetLayer( LevelSetType::MinusOneLayer() );
 
   LevelSetLayerType& layerMinusTwo = this->m_TempLevelSet->GetLayer( LevelSetType::MinusTwoLayer() );
@@ -432,43 +428,24 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
 
   LevelSetInputType inputIndex;
 
+  // the neighborhoods are scanned on several threads, but the points are
+  // moved on this thread in the order of the layer
+  const LayerScanResultContainerType & scanResults =
+    this->m_LayerScanThreader->Scan( this, &Self::ScanLayerMinus1, outputlayerMinus1 );
+  LayerScanResultConstIterator scanIt = scanResults.begin();
+
   while( nodeIt != nodeEnd )
     {
     LevelSetInputType currentIndex = nodeIt->first;
     inputIndex = currentIndex + this->m_Offset;
 
-    neighIt.SetLocation( currentIndex );
-
-    bool thereIsAPointWithLabelEqualTo0 = false;
-
-    LevelSetOutputType max = NumericTraits< LevelSetOutputType >::NonpositiveMin();
-
-    // compute M and check if point with label 0 exists in the neighborhood
-    for( typename NeighborhoodIteratorType::Iterator it = neighIt.Begin();
-         !it.IsAtEnd();
-         ++it )
-      {
-      LevelSetInputType tempIndex = neighIt.GetIndex( it.GetNeighborhoodOffset() );
-
-      LevelSetLayerIdType label = it.Get();
-
-      if( label >= LevelSetType::ZeroLayer() )
-        {
-        if( label == LevelSetType::ZeroLayer() )
-          {
-          thereIsAPointWithLabelEqualTo0 = true;
-          }
-
-        LevelSetLayerIterator phiIt = this->m_TempPhi.find( tempIndex );
-        itkAssertInDebugAndIgnoreInReleaseMacro( phiIt != this->m_TempPhi.end() );
-
-        max = std::max( max, phiIt->second );
-        }
-      } // end for
+    const bool thereIsAPointWithLabelEqualTo0 = scanIt->first;
+    LevelSetOutputType max = scanIt->second;
+    ++scanIt;
 
     if( thereIsAPointWithLabelEqualTo0 )
       {
-      LevelSetLayerIterator phiIt = this->m_TempPhi.find( currentIndex );
+      TempPhiIterator phiIt = this->FindTempPhi( currentIndex );
 
       max = max - 1.;
 
@@ -480,7 +457,7 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
         }
       else
         { // Kishore: Can this happen?
-        this->m_TempPhi.insert( NodePairType( currentIndex, max ) );
+        this->SetTempPhi( currentIndex, max );
         }
 
       if( max >= -0.5 )
@@ -522,29 +499,6 @@ template< unsigned int VDimension,
 void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationContainer >
 ::UpdateLayerPlus1()
 {
-  ZeroFluxNeumannBoundaryCondition< LabelImageType > spNBC;
-
-  typename NeighborhoodIteratorType::RadiusType radius;
-  radius.Fill( 1 );
-
-  NeighborhoodIteratorType neighIt( radius,
-                                    this->m_InternalImage,
-                                    this->m_InternalImage->GetLargestPossibleRegion() );
-
-  neighIt.OverrideBoundaryCondition( &spNBC );
-
-  typename NeighborhoodIteratorType::OffsetType neighOffset;
-  neighOffset.Fill( 0 );
-
-  for( unsigned int dim = 0; dim < ImageDimension; dim++ )
-    {
-    neighOffset[dim] = -1;
-    neighIt.ActivateOffset( neighOffset );
-    neighOffset[dim] = 1;
-    neighIt.ActivateOffset( neighOffset );
-    neighOffset[dim] = 0;
-    }
-
   TermContainerPointer termContainer = this->m_EquationContainer->GetEquation( this->m_CurrentLevelSetId );
 
   LevelSetLayerType& layerPlus2 = this->m_TempLevelSet->GetLayer( LevelSetType::PlusTwoLayer() );
@@ -555,46 +509,24 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
   LevelSetLayerIterator nodeIt   = outputLayerPlus1.begin();
   LevelSetLayerIterator nodeEnd  = outputLayerPlus1.end();
 
+  // the neighborhoods are scanned on several threads, but the points are
+  // moved on this thread in the order of the layer
+  const LayerScanResultContainerType & scanResults =
+    this->m_LayerScanThreader->Scan( this, &Self::ScanLayerPlus1, outputLayerPlus1 );
+  LayerScanResultConstIterator scanIt = scanResults.begin();
+
   while( nodeIt != nodeEnd )
     {
     const LevelSetInputType currentIndex = nodeIt->first;
     const LevelSetInputType inputIndex = currentIndex + this->m_Offset;
 
-    neighIt.SetLocation( currentIndex );
-
-    bool thereIsAPointWithLabelEqualTo0 = false;
-
-    LevelSetOutputType max = NumericTraits< LevelSetOutputType >::max();
-
-    for( typename NeighborhoodIteratorType::Iterator it = neighIt.Begin();
-         !it.IsAtEnd();
-         ++it )
-      {
-      LevelSetLayerIdType label = it.Get();
-
-      if( label <= LevelSetType::ZeroLayer() )
-        {
-        if( label == LevelSetType::ZeroLayer() )
-          {
-          thereIsAPointWithLabelEqualTo0 = true;
-          }
-        const LevelSetInputType neighborIndex = neighIt.GetIndex( it.GetNeighborhoodOffset() );
-
-        LevelSetLayerIterator phiIt = this->m_TempPhi.find( neighborIndex );
-        if( phiIt != this->m_TempPhi.end() )
-          {
-          max = std::min( max, phiIt->second );
-          }
-        else
-          {
-          itkDebugMacro( << neighborIndex << "is not in this->m_TempPhi" <<std::endl );
-          }
-        }
-      } // end for
+    const bool thereIsAPointWithLabelEqualTo0 = scanIt->first;
+    LevelSetOutputType max = scanIt->second;
+    ++scanIt;
 
     if( thereIsAPointWithLabelEqualTo0 )
       {
-      LevelSetLayerIterator phiIt = this->m_TempPhi.find( currentIndex );
+      TempPhiIterator phiIt = this->FindTempPhi( currentIndex );
 
       max = max + 1.;
 
@@ -606,7 +538,7 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
         }
       else
         {// Kishore: can this happen?
-        this->m_TempPhi.insert( NodePairType( currentIndex, max ) );
+        this->SetTempPhi( currentIndex, max );
         }
 
       if( max <= 0.5 )
@@ -645,29 +577,6 @@ template< unsigned int VDimension,
 void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationContainer >
 ::UpdateLayerMinus2()
 {
-  ZeroFluxNeumannBoundaryCondition< LabelImageType > spNBC;
-
-  typename NeighborhoodIteratorType::RadiusType radius;
-  radius.Fill( 1 );
-
-  NeighborhoodIteratorType neighIt( radius,
-                                    this->m_InternalImage,
-                                    this->m_InternalImage->GetLargestPossibleRegion() );
-
-  neighIt.OverrideBoundaryCondition( &spNBC );
-
-  typename NeighborhoodIteratorType::OffsetType neighOffset;
-  neighOffset.Fill( 0 );
-
-  for( unsigned int dim = 0; dim < ImageDimension; ++dim )
-    {
-    neighOffset[dim] = -1;
-    neighIt.ActivateOffset( neighOffset );
-    neighOffset[dim] = 1;
-    neighIt.ActivateOffset( neighOffset );
-    neighOffset[dim] = 0;
-    }
-
   TermContainerPointer termContainer = this->m_EquationContainer->GetEquation( this->m_CurrentLevelSetId );
 
   LevelSetLayerType& outputLayerMinus2 = this->m_OutputLevelSet->GetLayer( LevelSetType::MinusTwoLayer() );
@@ -676,41 +585,24 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
   LevelSetLayerIterator nodeIt = outputLayerMinus2.begin();
   const LevelSetLayerIterator nodeEnd = outputLayerMinus2.end();
 
+  // the neighborhoods are scanned on several threads, but the points are
+  // moved on this thread in the order of the layer
+  const LayerScanResultContainerType & scanResults =
+    this->m_LayerScanThreader->Scan( this, &Self::ScanLayerMinus2, outputLayerMinus2 );
+  LayerScanResultConstIterator scanIt = scanResults.begin();
+
   while( nodeIt != nodeEnd )
     {
     const LevelSetInputType currentIndex = nodeIt->first;
     const LevelSetInputType inputIndex = currentIndex + this->m_Offset;
 
-    neighIt.SetLocation( currentIndex );
-
-    bool thereIsAPointWithLabelEqualToMinus1 = false;
-
-    LevelSetOutputType max = NumericTraits< LevelSetOutputType >::NonpositiveMin();
-
-    for( typename NeighborhoodIteratorType::Iterator it = neighIt.Begin();
-         !it.IsAtEnd();
-         ++it )
-      {
-      const LevelSetLayerIdType label = it.Get();
-
-      if( label >= LevelSetType::MinusOneLayer() )
-        {
-        if( label == LevelSetType::MinusOneLayer() )
-          {
-          thereIsAPointWithLabelEqualToMinus1 = true;
-          }
-        const LevelSetInputType neighborIndex = neighIt.GetIndex( it.GetNeighborhoodOffset() );
-
-        const LevelSetLayerIterator phiIt = this->m_TempPhi.find( neighborIndex );
-        itkAssertInDebugAndIgnoreInReleaseMacro( phiIt != this->m_TempPhi.end() );
-
-        max = std::max( max, phiIt->second );
-        }
-      } // end for
+    const bool thereIsAPointWithLabelEqualToMinus1 = scanIt->first;
+    LevelSetOutputType max = scanIt->second;
+    ++scanIt;
 
     if( thereIsAPointWithLabelEqualToMinus1 )
       {
-      const LevelSetLayerIterator phiIt = this->m_TempPhi.find( currentIndex );
+      const TempPhiIterator phiIt = this->FindTempPhi( currentIndex );
 
       max = max - 1.;
 
@@ -722,8 +614,7 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
         }
       else
         {//Kishore: can this happen?
-        this->m_TempPhi.insert(
-              NodePairType( currentIndex, max ) );
+        this->SetTempPhi( currentIndex, max );
         }
 
       if( max >= -1.5 ) //change layers only
@@ -743,7 +634,7 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
 
         termContainer->UpdatePixel( inputIndex, max, LevelSetType::MinusThreeLayer() );
 
-        this->m_TempPhi.erase( currentIndex );
+        this->m_TempPhi.erase( this->m_InternalImage->ComputeOffset( currentIndex ) );
         }
       else
         {
@@ -757,7 +648,7 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
       this->m_InternalImage->SetPixel( currentIndex, LevelSetType::MinusThreeLayer() );
       termContainer->UpdatePixel( inputIndex, tempIt->second, LevelSetType::MinusThreeLayer() );
       outputLayerMinus2.erase( tempIt );
-      this->m_TempPhi.erase( currentIndex );
+      this->m_TempPhi.erase( this->m_InternalImage->ComputeOffset( currentIndex ) );
       }
     }
 }
@@ -768,29 +659,6 @@ template< unsigned int VDimension,
 void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationContainer >
 ::UpdateLayerPlus2()
 {
-  ZeroFluxNeumannBoundaryCondition< LabelImageType > spNBC;
-
-  typename NeighborhoodIteratorType::RadiusType radius;
-  radius.Fill( 1 );
-
-  NeighborhoodIteratorType neighIt( radius,
-                                    this->m_InternalImage,
-                                    this->m_InternalImage->GetLargestPossibleRegion() );
-
-  neighIt.OverrideBoundaryCondition( &spNBC );
-
-  typename NeighborhoodIteratorType::OffsetType neighOffset;
-  neighOffset.Fill( 0 );
-
-  for( unsigned int dim = 0; dim < ImageDimension; dim++ )
-    {
-    neighOffset[dim] = -1;
-    neighIt.ActivateOffset( neighOffset );
-    neighOffset[dim] = 1;
-    neighIt.ActivateOffset( neighOffset );
-    neighOffset[dim] = 0;
-    }
-
   TermContainerPointer termContainer = this->m_EquationContainer->GetEquation( this->m_CurrentLevelSetId );
 
   LevelSetLayerType& outputLayerPlus2 = this->m_OutputLevelSet->GetLayer( LevelSetType::PlusTwoLayer() );
@@ -799,43 +667,24 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
   LevelSetLayerIterator nodeIt = outputLayerPlus2.begin();
   const LevelSetLayerIterator nodeEnd = outputLayerPlus2.end();
 
+  // the neighborhoods are scanned on several threads, but the points are
+  // moved on this thread in the order of the layer
+  const LayerScanResultContainerType & scanResults =
+    this->m_LayerScanThreader->Scan( this, &Self::ScanLayerPlus2, outputLayerPlus2 );
+  LayerScanResultConstIterator scanIt = scanResults.begin();
+
   while( nodeIt != nodeEnd )
     {
     const LevelSetInputType currentIndex = nodeIt->first;
     const LevelSetInputType inputIndex = currentIndex + this->m_Offset;
 
-    neighIt.SetLocation( currentIndex );
-
-    bool thereIsAPointWithLabelEqualToPlus1 = false;
-    LevelSetOutputType max = NumericTraits< LevelSetOutputType >::max();
-
-    for( typename NeighborhoodIteratorType::Iterator it = neighIt.Begin();
-         !it.IsAtEnd();
-         ++it )
-      {
-      LevelSetLayerIdType label = it.Get();
-      if( label <= LevelSetType::PlusOneLayer() )
-        {
-        if( label == LevelSetType::PlusOneLayer() )
-          {
-          thereIsAPointWithLabelEqualToPlus1 = true;
-          }
-        const LevelSetInputType neighborIndex = neighIt.GetIndex( it.GetNeighborhoodOffset() );
-        LevelSetLayerIterator phiIt = this->m_TempPhi.find( neighborIndex );
-        if( phiIt != this->m_TempPhi.end() )
-          {
-          max = std::min( max, phiIt->second );
-          }
-        else
-          {
-          itkDebugMacro( << neighborIndex << " is not in this->m_TempPhi" << std::endl );
-          }
-        }
-      }
+    const bool thereIsAPointWithLabelEqualToPlus1 = scanIt->first;
+    LevelSetOutputType max = scanIt->second;
+    ++scanIt;
 
     if( thereIsAPointWithLabelEqualToPlus1 )
       {
-      LevelSetLayerIterator phiIt = this->m_TempPhi.find( currentIndex );
+      TempPhiIterator phiIt = this->FindTempPhi( currentIndex );
 
       max = max + 1.;
 
@@ -848,7 +697,7 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
       else
         // todo: remove dead code
         {//Kishore: can this happen?
-        this->m_TempPhi.insert( NodePairType( currentIndex, max ) );
+        this->SetTempPhi( currentIndex, max );
         }
 
       if( max <= 1.5 ) // change layers
@@ -867,7 +716,7 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
 
         termContainer->UpdatePixel( inputIndex, max, LevelSetType::PlusThreeLayer() );
 
-        this->m_TempPhi.erase( currentIndex );
+        this->m_TempPhi.erase( this->m_InternalImage->ComputeOffset( currentIndex ) );
         }
       else
         {
@@ -881,7 +730,7 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
       this->m_InternalImage->SetPixel( currentIndex, LevelSetType::PlusThreeLayer() );
       termContainer->UpdatePixel( inputIndex, tempIt->second, LevelSetType::PlusThreeLayer() );
       outputLayerPlus2.erase( tempIt );
-      this->m_TempPhi.erase( currentIndex );
+      this->m_TempPhi.erase( this->m_InternalImage->ComputeOffset( currentIndex ) );
       }
     }
 }
@@ -969,7 +818,7 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
       {
       LevelSetInputType tempIndex = neighIt.GetIndex( it.GetNeighborhoodOffset() );
 
-      LevelSetLayerIterator phiIt = this->m_TempPhi.find( tempIndex );
+      TempPhiIterator phiIt = this->FindTempPhi( tempIndex );
       if( phiIt != this->m_TempPhi.end() )
         {
         if( Math::ExactlyEquals(phiIt->second, -3.) ) // change values
@@ -1043,7 +892,7 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
       {
       LevelSetInputType tempIndex = neighIt.GetIndex( it.GetNeighborhoodOffset() );
 
-      LevelSetLayerIterator phiIt = this->m_TempPhi.find( tempIndex );
+      TempPhiIterator phiIt = this->FindTempPhi( tempIndex );
       if( phiIt != this->m_TempPhi.end() )
         {
         if( phiIt->second == 3. )
@@ -1109,5 +958,163 @@ void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationCont
     layerPlus2.erase( tempIt );
     }
 }
+
+template< unsigned int VDimension,
+          typename TLevelSetValueType,
+          typename TEquationContainer >
+typename UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationContainer >::TempPhiIterator
+UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationContainer >
+::FindTempPhi( const LevelSetInputType& index )
+{
+  // the neighbors given by the iterators can be outside of the image
+  if( !this->m_InternalImage->GetBufferedRegion().IsInside( index ) )
+    {
+    return this->m_TempPhi.end();
+    }
+  return this->m_TempPhi.find( this->m_InternalImage->ComputeOffset( index ) );
+}
+
+template< unsigned int VDimension,
+          typename TLevelSetValueType,
+          typename TEquationContainer >
+void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationContainer >
+::SetTempPhi( const LevelSetInputType& index, const LevelSetOutputType& value )
+{
+  if( this->m_InternalImage->GetBufferedRegion().IsInside( index ) )
+    {
+    this->m_TempPhi[ this->m_InternalImage->ComputeOffset( index ) ] = value;
+    }
+}
+
+template< unsigned int VDimension,
+          typename TLevelSetValueType,
+          typename TEquationContainer >
+bool UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationContainer >
+::GetTempPhi( const LevelSetInputType& index, LevelSetOutputType& value ) const
+{
+  if( !this->m_InternalImage->GetBufferedRegion().IsInside( index ) )
+    {
+    return false;
+    }
+  typename TempPhiType::const_iterator phiIt = this->m_TempPhi.find( this->m_InternalImage->ComputeOffset( index ) );
+  if( phiIt == this->m_TempPhi.end() )
+    {
+    return false;
+    }
+  value = phiIt->second;
+  return true;
+}
+
+template< unsigned int VDimension,
+          typename TLevelSetValueType,
+          typename TEquationContainer >
+void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationContainer >
+::ScanLayer( LevelSetLayerConstIterator begin, LevelSetLayerConstIterator end,
+             const LevelSetLayerIdType layerId, LayerScanResultContainerType & results ) const
+{
+  ZeroFluxNeumannBoundaryCondition< LabelImageType > spNBC;
+
+  typename NeighborhoodIteratorType::RadiusType radius;
+  radius.Fill( 1 );
+
+  NeighborhoodIteratorType neighIt( radius,
+                                    this->m_InternalImage,
+                                    this->m_InternalImage->GetLargestPossibleRegion() );
+
+  neighIt.OverrideBoundaryCondition( &spNBC );
+
+  typename NeighborhoodIteratorType::OffsetType neighOffset;
+  neighOffset.Fill( 0 );
+
+  for( unsigned int dim = 0; dim < ImageDimension; dim++ )
+    {
+    neighOffset[dim] = -1;
+    neighIt.ActivateOffset( neighOffset );
+    neighOffset[dim] = 1;
+    neighIt.ActivateOffset( neighOffset );
+    neighOffset[dim] = 0;
+    }
+
+  // the points of the negative layers take the maximum of their neighbors
+  // with a greater label, and the points of the positive layers the minimum
+  // of their neighbors with a lower label
+  const bool inside = ( layerId < LevelSetType::ZeroLayer() );
+  const LevelSetLayerIdType closerLayerId = static_cast< LevelSetLayerIdType >( inside ? layerId + 1 : layerId - 1 );
+
+  LevelSetLayerConstIterator nodeIt = begin;
+  while( nodeIt != end )
+    {
+    neighIt.SetLocation( nodeIt->first );
+
+    bool thereIsAPointWithCloserLabel = false;
+    LevelSetOutputType extremum = inside ? NumericTraits< LevelSetOutputType >::NonpositiveMin() :
+                                           NumericTraits< LevelSetOutputType >::max();
+
+    for( typename NeighborhoodIteratorType::Iterator it = neighIt.Begin();
+         !it.IsAtEnd();
+         ++it )
+      {
+      const LevelSetLayerIdType label = it.Get();
+
+      if( inside ? ( label >= closerLayerId ) : ( label <= closerLayerId ) )
+        {
+        if( label == closerLayerId )
+          {
+          thereIsAPointWithCloserLabel = true;
+          }
+        const LevelSetInputType neighborIndex = neighIt.GetIndex( it.GetNeighborhoodOffset() );
+
+        LevelSetOutputType value;
+        if( this->GetTempPhi( neighborIndex, value ) )
+          {
+          extremum = inside ? std::max( extremum, value ) : std::min( extremum, value );
+          }
+        }
+      }
+
+    results.push_back( LayerScanResultType( thereIsAPointWithCloserLabel, extremum ) );
+    ++nodeIt;
+    }
+}
+
+template< unsigned int VDimension,
+          typename TLevelSetValueType,
+          typename TEquationContainer >
+void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationContainer >
+::ScanLayerMinus1( LevelSetLayerConstIterator begin, LevelSetLayerConstIterator end,
+                   LayerScanResultContainerType & results ) const
+{
+  this->ScanLayer( begin, end, LevelSetType::MinusOneLayer(), results );
+}
+
+template< unsigned int VDimension,
+          typename TLevelSetValueType,
+          typename TEquationContainer >
+void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationContainer >
+::ScanLayerPlus1( LevelSetLayerConstIterator begin, LevelSetLayerConstIterator end,
+                  LayerScanResultContainerType & results ) const
+{
+  this->ScanLayer( begin, end, LevelSetType::PlusOneLayer(), results );
+}
+
+template< unsigned int VDimension,
+          typename TLevelSetValueType,
+          typename TEquationContainer >
+void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationContainer >
+::ScanLayerMinus2( LevelSetLayerConstIterator begin, LevelSetLayerConstIterator end,
+                   LayerScanResultContainerType & results ) const
+{
+  this->ScanLayer( begin, end, LevelSetType::MinusTwoLayer(), results );
+}
+
+template< unsigned int VDimension,
+          typename TLevelSetValueType,
+          typename TEquationContainer >
+void UpdateWhitakerSparseLevelSet< VDimension, TLevelSetValueType, TEquationContainer >
+::ScanLayerPlus2( LevelSetLayerConstIterator begin, LevelSetLayerConstIterator end,
+                  LayerScanResultContainerType & results ) const
+{
+  this->ScanLayer( begin, end, LevelSetType::PlusTwoLayer(), results );
+}
 }
 #endif // itkUpdateWhitakerSparseLevelSet_hxx
@@ -0,0 +1,216 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkLevelSetContainer.h"
+#include "itkLevelSetEquationChanAndVeseInternalTerm.h"
+#include "itkLevelSetEquationChanAndVeseExternalTerm.h"
+#include "itkLevelSetEquationTermContainer.h"
+#include "itkLevelSetEquationContainer.h"
+#include "itkSinRegularizedHeavisideStepFunction.h"
+#include "itkLevelSetEvolution.h"
+#include "itkBinaryImageToLevelSetImageAdaptor.h"
+#include "itkLevelSetEvolutionNumberOfIterationsStoppingCriterion.h"
+#include "itkLabelMapToLabelImageFilter.h"
+
+namespace
+{
+const unsigned int Dimension = 3;
+
+typedef unsigned short                                      InputPixelType;
+typedef itk::Image< InputPixelType, Dimension >             InputImageType;
+typedef itk::ImageRegionIteratorWithIndex< InputImageType > InputIteratorType;
+typedef itk::Image< int8_t, Dimension >                     LabelImageType;
+typedef itk::ImageRegionConstIterator< LabelImageType >     LabelIteratorType;
+
+/* Evolves a level set of the given type from the binary image with the given
+ * number of threads, and returns the image of its layers. */
+template< typename TLevelSet >
+LabelImageType::Pointer
+EvolveLevelSet( InputImageType * input, InputImageType * binary, itk::ThreadIdType numberOfThreads )
+{
+  typedef TLevelSet                                                                     SparseLevelSetType;
+  typedef itk::BinaryImageToLevelSetImageAdaptor< InputImageType, SparseLevelSetType > BinaryToSparseAdaptorType;
+  typedef itk::LevelSetContainer< itk::IdentifierType, SparseLevelSetType >            LevelSetContainerType;
+  typedef itk::LevelSetEquationChanAndVeseInternalTerm< InputImageType, LevelSetContainerType >
+                                                                                        ChanAndVeseInternalTermType;
+  typedef itk::LevelSetEquationChanAndVeseExternalTerm< InputImageType, LevelSetContainerType >
+                                                                                        ChanAndVeseExternalTermType;
+  typedef itk::LevelSetEquationTermContainer< InputImageType, LevelSetContainerType >  TermContainerType;
+  typedef itk::LevelSetEquationContainer< TermContainerType >                           EquationContainerType;
+  typedef itk::LevelSetEvolution< EquationContainerType, SparseLevelSetType >           LevelSetEvolutionType;
+  typedef typename SparseLevelSetType::OutputRealType                                   LevelSetOutputRealType;
+  typedef itk::SinRegularizedHeavisideStepFunction< LevelSetOutputRealType, LevelSetOutputRealType >
+                                                                                        HeavisideFunctionBaseType;
+  typedef itk::LevelSetEvolutionNumberOfIterationsStoppingCriterion< LevelSetContainerType >
+                                                                                        StoppingCriterionType;
+
+  typename BinaryToSparseAdaptorType::Pointer adaptor = BinaryToSparseAdaptorType::New();
+  adaptor->SetInputImage( binary );
+  adaptor->Initialize();
+
+  typename SparseLevelSetType::Pointer level_set = adaptor->GetModifiableLevelSet();
+
+  typename HeavisideFunctionBaseType::Pointer heaviside = HeavisideFunctionBaseType::New();
+  heaviside->SetEpsilon( 1.0 );
+
+  typename LevelSetContainerType::Pointer lscontainer = LevelSetContainerType::New();
+  lscontainer->SetHeaviside( heaviside );
+  lscontainer->AddLevelSet( 0, level_set, false );
+
+  typename ChanAndVeseInternalTermType::Pointer cvInternalTerm0 = ChanAndVeseInternalTermType::New();
+  cvInternalTerm0->SetInput( input );
+  cvInternalTerm0->SetCoefficient( 1.0 );
+
+  typename ChanAndVeseExternalTermType::Pointer cvExternalTerm0 = ChanAndVeseExternalTermType::New();
+  cvExternalTerm0->SetInput( input );
+  cvExternalTerm0->SetCoefficient( 1.0 );
+
+  typename TermContainerType::Pointer termContainer0 = TermContainerType::New();
+  termContainer0->SetInput( input );
+  termContainer0->SetCurrentLevelSetId( 0 );
+  termContainer0->SetLevelSetContainer( lscontainer );
+  termContainer0->AddTerm( 0, cvInternalTerm0 );
+  termContainer0->AddTerm( 1, cvExternalTerm0 );
+
+  typename EquationContainerType::Pointer equationContainer = EquationContainerType::New();
+  equationContainer->AddEquation( 0, termContainer0 );
+  equationContainer->SetLevelSetContainer( lscontainer );
+
+  typename StoppingCriterionType::Pointer criterion = StoppingCriterionType::New();
+  criterion->SetNumberOfIterations( 100 );
+
+  typename LevelSetEvolutionType::Pointer evolution = LevelSetEvolutionType::New();
+  evolution->SetEquationContainer( equationContainer );
+  evolution->SetStoppingCriterion( criterion );
+  evolution->SetLevelSetContainer( lscontainer );
+  evolution->SetNumberOfThreads( numberOfThreads );
+
+  evolution->Update();
+  std::cout << evolution->GetNameOfClass() << " of " << level_set->GetNameOfClass() << ", "
+            << evolution->GetNumberOfThreads() << " threads" << std::endl;
+
+  typedef itk::LabelMapToLabelImageFilter< typename SparseLevelSetType::LabelMapType, LabelImageType >
+                                                                                        LabelMapToLabelImageFilterType;
+  typename LabelMapToLabelImageFilterType::Pointer labelMapToLabelImage = LabelMapToLabelImageFilterType::New();
+  labelMapToLabelImage->SetInput( level_set->GetLabelMap() );
+  labelMapToLabelImage->Update();
+
+  return labelMapToLabelImage->GetOutput();
+}
+
+/* Checks that the layers of the level set are the same with one or several
+ * threads, and optionally that the level set segments the sphere. */
+template< typename TLevelSet >
+bool
+CheckLevelSet( InputImageType * input, InputImageType * binary, bool checkSegmentation )
+{
+  LabelImageType::Pointer serial = EvolveLevelSet< TLevelSet >( input, binary, 1 );
+  LabelImageType::Pointer parallel = EvolveLevelSet< TLevelSet >( input, binary, 4 );
+
+  unsigned int numberOfErrors = 0;
+  unsigned int numberOfDifferences = 0;
+  InputIteratorType it( input, input->GetLargestPossibleRegion() );
+  LabelIteratorType sIt( serial, serial->GetLargestPossibleRegion() );
+  LabelIteratorType pIt( parallel, parallel->GetLargestPossibleRegion() );
+  for( ; !it.IsAtEnd(); ++it, ++sIt, ++pIt )
+    {
+    // the negative layers are inside, and the zero layer of Malcolm on the
+    // contour
+    const bool inside = sIt.Get() < 0;
+    const bool sphere = it.Get() == 200;
+    if( inside != sphere && sIt.Get() != 0 )
+      {
+      numberOfErrors++;
+      }
+    if( sIt.Get() != pIt.Get() )
+      {
+      numberOfDifferences++;
+      }
+    }
+  std::cout << numberOfErrors << " points wrongly classified, " << numberOfDifferences
+            << " points different with several threads" << std::endl;
+  return ( numberOfErrors == 0 || !checkSegmentation ) && numberOfDifferences == 0;
+}
+}
+
+/* Segments a sphere with Shi and Malcolm sparse level sets initialized with a
+ * box, with one and several threads, and compares the segmentations. The Shi
+ * level set does not reach the sphere with the Chan and Vese terms, so only
+ * the Malcolm one is checked against the sphere. */
+int itkSingleLevelSetShiAndMalcolmImage3DTest( int , char* [] )
+{
+  // a bright sphere on a dark background
+  InputImageType::SizeType size;
+  size.Fill( 32 );
+
+  InputImageType::Pointer input = InputImageType::New();
+  input->SetRegions( size );
+  input->Allocate();
+
+  const double radius = 8.;
+  const double center = 17.;
+
+  InputIteratorType it( input, input->GetLargestPossibleRegion() );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const InputImageType::IndexType index = it.GetIndex();
+    double distance2 = 0.;
+    for( unsigned int dim = 0; dim < Dimension; dim++ )
+      {
+      distance2 += ( index[dim] - center ) * ( index[dim] - center );
+      }
+    it.Set( distance2 < radius * radius ? 200 : 50 );
+    }
+
+  // Binary initialization with a box around the sphere
+  InputImageType::Pointer binary = InputImageType::New();
+  binary->SetRegions( input->GetLargestPossibleRegion() );
+  binary->Allocate();
+  binary->FillBuffer( itk::NumericTraits<InputPixelType>::ZeroValue() );
+
+  InputImageType::RegionType region;
+  region.GetModifiableIndex().Fill( 4 );
+  region.GetModifiableSize().Fill( 26 );
+
+  InputIteratorType iIt( binary, region );
+  for( iIt.GoToBegin(); !iIt.IsAtEnd(); ++iIt )
+    {
+    iIt.Set( itk::NumericTraits<InputPixelType>::OneValue() );
+    }
+
+  try
+    {
+    if( !CheckLevelSet< itk::ShiSparseLevelSetImage< Dimension > >( input, binary, false ) )
+      {
+      std::cerr << "Different layers of the Shi level set with several threads" << std::endl;
+      return EXIT_FAILURE;
+      }
+    if( !CheckLevelSet< itk::MalcolmSparseLevelSetImage< Dimension > >( input, binary, true ) )
+      {
+      std::cerr << "Wrong segmentation with the Malcolm level set" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  catch ( itk::ExceptionObject& err )
+    {
+    std::cerr << err << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
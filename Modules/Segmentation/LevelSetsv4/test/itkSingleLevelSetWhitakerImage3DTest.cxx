@@ -0,0 +1,245 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkLevelSetContainer.h"
+#include "itkLevelSetEquationChanAndVeseInternalTerm.h"
+#include "itkLevelSetEquationChanAndVeseExternalTerm.h"
+#include "itkLevelSetEquationTermContainer.h"
+#include "itkLevelSetEquationContainer.h"
+#include "itkSinRegularizedHeavisideStepFunction.h"
+#include "itkLevelSetEvolution.h"
+#include "itkBinaryImageToLevelSetImageAdaptor.h"
+#include "itkLevelSetEvolutionNumberOfIterationsStoppingCriterion.h"
+#include "itkLabelMapToLabelImageFilter.h"
+
+namespace
+{
+const unsigned int Dimension = 3;
+
+typedef unsigned short                                    InputPixelType;
+typedef itk::Image< InputPixelType, Dimension >           InputImageType;
+typedef itk::ImageRegionIteratorWithIndex< InputImageType >
+                                                          InputIteratorType;
+
+typedef float                                             PixelType;
+
+typedef itk::WhitakerSparseLevelSetImage< PixelType, Dimension >
+                                                          SparseLevelSetType;
+typedef itk::BinaryImageToLevelSetImageAdaptor< InputImageType, SparseLevelSetType >
+                                                          BinaryToSparseAdaptorType;
+
+typedef itk::IdentifierType                               IdentifierType;
+
+typedef itk::LevelSetContainer< IdentifierType, SparseLevelSetType >
+                                                          LevelSetContainerType;
+
+typedef itk::LevelSetEquationChanAndVeseInternalTerm< InputImageType, LevelSetContainerType >
+                                                          ChanAndVeseInternalTermType;
+typedef itk::LevelSetEquationChanAndVeseExternalTerm< InputImageType, LevelSetContainerType >
+                                                          ChanAndVeseExternalTermType;
+typedef itk::LevelSetEquationTermContainer< InputImageType, LevelSetContainerType >
+                                                          TermContainerType;
+
+typedef itk::LevelSetEquationContainer< TermContainerType >
+                                                          EquationContainerType;
+
+typedef itk::LevelSetEvolution< EquationContainerType, SparseLevelSetType >
+                                                          LevelSetEvolutionType;
+
+typedef SparseLevelSetType::OutputRealType                      LevelSetOutputRealType;
+typedef itk::SinRegularizedHeavisideStepFunction< LevelSetOutputRealType, LevelSetOutputRealType >
+                                                          HeavisideFunctionBaseType;
+
+/* Evolves the level set from the binary image with the given number of
+ * threads. */
+SparseLevelSetType::Pointer
+EvolveLevelSet( InputImageType * input, InputImageType * binary, itk::ThreadIdType numberOfThreads )
+{
+  // Convert binary mask to sparse level set
+  BinaryToSparseAdaptorType::Pointer adaptor = BinaryToSparseAdaptorType::New();
+  adaptor->SetInputImage( binary );
+  adaptor->Initialize();
+
+  SparseLevelSetType::Pointer level_set = adaptor->GetModifiableLevelSet();
+
+  HeavisideFunctionBaseType::Pointer heaviside = HeavisideFunctionBaseType::New();
+  heaviside->SetEpsilon( 1.0 );
+
+  LevelSetContainerType::Pointer lscontainer = LevelSetContainerType::New();
+  lscontainer->SetHeaviside( heaviside );
+  if ( !lscontainer->AddLevelSet( 0, level_set, false ) )
+    {
+    return ITK_NULLPTR;
+    }
+
+  ChanAndVeseInternalTermType::Pointer cvInternalTerm0 = ChanAndVeseInternalTermType::New();
+  cvInternalTerm0->SetInput( input );
+  cvInternalTerm0->SetCoefficient( 1.0 );
+
+  ChanAndVeseExternalTermType::Pointer cvExternalTerm0 = ChanAndVeseExternalTermType::New();
+  cvExternalTerm0->SetInput( input );
+  cvExternalTerm0->SetCoefficient( 1.0 );
+
+  TermContainerType::Pointer termContainer0 = TermContainerType::New();
+  termContainer0->SetInput( input );
+  termContainer0->SetCurrentLevelSetId( 0 );
+  termContainer0->SetLevelSetContainer( lscontainer );
+  termContainer0->AddTerm( 0, cvInternalTerm0 );
+  termContainer0->AddTerm( 1, cvExternalTerm0 );
+
+  EquationContainerType::Pointer equationContainer = EquationContainerType::New();
+  equationContainer->AddEquation( 0, termContainer0 );
+  equationContainer->SetLevelSetContainer( lscontainer );
+
+  typedef itk::LevelSetEvolutionNumberOfIterationsStoppingCriterion< LevelSetContainerType >
+      StoppingCriterionType;
+  StoppingCriterionType::Pointer criterion = StoppingCriterionType::New();
+  criterion->SetNumberOfIterations( 200 );
+
+  LevelSetEvolutionType::Pointer evolution = LevelSetEvolutionType::New();
+  evolution->SetEquationContainer( equationContainer );
+  evolution->SetStoppingCriterion( criterion );
+  evolution->SetLevelSetContainer( lscontainer );
+  evolution->SetNumberOfThreads( numberOfThreads );
+
+  evolution->Update();
+
+  return level_set;
+}
+}
+
+/* Segments a sphere with a Whitaker sparse level set initialized with a box
+ * which touches the border of the image, and checks the segmentation. The
+ * layers must be the same with one and several threads. */
+int itkSingleLevelSetWhitakerImage3DTest( int , char* [] )
+{
+  // a bright sphere on a dark background
+  InputImageType::SizeType size;
+  size.Fill( 32 );
+
+  InputImageType::Pointer input = InputImageType::New();
+  input->SetRegions( size );
+  input->Allocate();
+
+  const double radius = 8.;
+  const double center = 17.;
+
+  InputIteratorType it( input, input->GetLargestPossibleRegion() );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const InputImageType::IndexType index = it.GetIndex();
+    double distance2 = 0.;
+    for( unsigned int dim = 0; dim < Dimension; dim++ )
+      {
+      distance2 += ( index[dim] - center ) * ( index[dim] - center );
+      }
+    it.Set( distance2 < radius * radius ? 200 : 50 );
+    }
+
+  // Binary initialization with a box on the first corner of the image
+  InputImageType::Pointer binary = InputImageType::New();
+  binary->SetRegions( input->GetLargestPossibleRegion() );
+  binary->Allocate();
+  binary->FillBuffer( itk::NumericTraits<InputPixelType>::ZeroValue() );
+
+  InputImageType::RegionType region;
+  InputImageType::SizeType boxSize;
+  boxSize.Fill( 30 );
+  region.SetSize( boxSize );
+
+  InputIteratorType iIt( binary, region );
+  for( iIt.GoToBegin(); !iIt.IsAtEnd(); ++iIt )
+    {
+    iIt.Set( itk::NumericTraits<InputPixelType>::OneValue() );
+    }
+
+  SparseLevelSetType::Pointer level_set;
+  SparseLevelSetType::Pointer level_set_threads;
+  try
+    {
+    level_set = EvolveLevelSet( input, binary, 1 );
+    level_set_threads = EvolveLevelSet( input, binary, 4 );
+    }
+  catch ( itk::ExceptionObject& err )
+    {
+    std::cerr << err << std::endl;
+    return EXIT_FAILURE;
+    }
+  if( level_set.IsNull() || level_set_threads.IsNull() )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // the layers are updated in the same order whatever the number of threads,
+  // so that their values are exactly the same
+  for( SparseLevelSetType::LayerIdType status = SparseLevelSetType::MinusTwoLayer();
+       status <= SparseLevelSetType::PlusTwoLayer(); ++status )
+    {
+    if( level_set->GetLayer( status ) != level_set_threads->GetLayer( status ) )
+      {
+      std::cerr << "The layer " << static_cast< int >( status ) << " is different with several threads" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // the points of the layers -3 to -1 are inside
+  typedef itk::Image< SparseLevelSetType::LayerIdType, Dimension > LabelImageType;
+  typedef itk::LabelMapToLabelImageFilter< SparseLevelSetType::LabelMapType, LabelImageType >
+                                                            LabelMapToLabelImageFilterType;
+  LabelMapToLabelImageFilterType::Pointer labelMapToLabelImage = LabelMapToLabelImageFilterType::New();
+  labelMapToLabelImage->SetInput( level_set->GetLabelMap() );
+  labelMapToLabelImage->Update();
+
+  LabelMapToLabelImageFilterType::Pointer labelMapToLabelImageThreads = LabelMapToLabelImageFilterType::New();
+  labelMapToLabelImageThreads->SetInput( level_set_threads->GetLabelMap() );
+  labelMapToLabelImageThreads->Update();
+
+  itk::ImageRegionIteratorWithIndex< LabelImageType > lIt( labelMapToLabelImage->GetOutput(),
+                                                          labelMapToLabelImage->GetOutput()->GetLargestPossibleRegion() );
+  itk::ImageRegionIteratorWithIndex< LabelImageType > tIt( labelMapToLabelImageThreads->GetOutput(),
+                                                          labelMapToLabelImageThreads->GetOutput()->GetLargestPossibleRegion() );
+  unsigned int numberOfErrors = 0;
+  unsigned int numberOfDifferences = 0;
+  for( it.GoToBegin(), lIt.GoToBegin(), tIt.GoToBegin(); !it.IsAtEnd(); ++it, ++lIt, ++tIt )
+    {
+    const bool inside = lIt.Get() < SparseLevelSetType::ZeroLayer();
+    const bool sphere = it.Get() == 200;
+    if( inside != sphere && lIt.Get() != SparseLevelSetType::ZeroLayer() )
+      {
+      numberOfErrors++;
+      }
+    if( lIt.Get() != tIt.Get() )
+      {
+      numberOfDifferences++;
+      }
+    }
+  std::cout << numberOfErrors << " points wrongly classified, " << numberOfDifferences
+            << " points different with several threads" << std::endl;
+  if( numberOfErrors > 0 )
+    {
+    std::cerr << "The level set did not converge to the sphere" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if( numberOfDifferences > 0 )
+    {
+    std::cerr << "Different label maps with several threads" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
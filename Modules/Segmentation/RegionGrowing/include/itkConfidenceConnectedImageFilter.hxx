@@ -25,7 +25,7 @@
 #include "itkMeanImageFunction.h"
 #include "itkSumOfSquaresImageFunction.h"
 #include "itkBinaryThresholdImageFunction.h"
-#include "itkFloodFilledImageFunctionConditionalIterator.h"
+#include "itkParallelFloodFill.h"
 #include "itkProgressReporter.h"
 
 namespace itk
@@ -138,11 +138,8 @@ void
 ConfidenceConnectedImageFilter< TInputImage, TOutputImage >
 ::GenerateData()
 {
-  typedef BinaryThresholdImageFunction< InputImageType, double >  FunctionType;
-  typedef BinaryThresholdImageFunction< OutputImageType, double > SecondFunctionType;
-
-  typedef FloodFilledImageFunctionConditionalIterator< OutputImageType, FunctionType >           IteratorType;
-  typedef FloodFilledImageFunctionConditionalConstIterator< InputImageType, SecondFunctionType > SecondIteratorType;
+  typedef BinaryThresholdImageFunction< InputImageType, double > FunctionType;
+  typedef ParallelFloodFill< OutputImageType, FunctionType >     FloodFillType;
 
   unsigned int loop;
 
@@ -302,20 +299,16 @@ ConfidenceConnectedImageFilter< TInputImage, TOutputImage >
     << "\nLower intensity = " << lower << ", Upper intensity = " << upper << "\nmean = " << m_Mean
     << " , std::sqrt(variance) = " << std::sqrt(m_Variance) );
 
-  // Segment the image, the iterator walks the output image (so Set()
-  // writes into the output image), starting at the seed point.  As
-  // the iterator walks, if the corresponding pixel in the input image
-  // (accessed via the "function" assigned to the iterator) is within
-  // the [lower, upper] bounds prescribed, the pixel is added to the
-  // output segmentation and its neighbors become candidates for the
-  // iterator to walk.
-  IteratorType it = IteratorType (outputImage, function, m_Seeds);
-  it.GoToBegin();
-  while ( !it.IsAtEnd() )
-    {
-    it.Set(m_ReplaceValue);
-    ++it;
-    }
+  // Segment the image, starting at the seed points.  If a pixel in the
+  // input image (accessed via the "function" assigned to the flood fill)
+  // is within the [lower, upper] bounds prescribed, the pixel is added to
+  // the output segmentation and its neighbors become candidates for the
+  // flood fill.
+  FloodFillType initialFloodFill(region, m_Seeds);
+  initialFloodFill.SetFunction(function);
+  initialFloodFill.SetMultiThreader( this->GetMultiThreader(), this->GetNumberOfThreads() );
+  initialFloodFill.Fill();
+  initialFloodFill.Paint(outputImage, m_ReplaceValue);
 
   ProgressReporter progress(this, 0, region.GetNumberOfPixels() * m_NumberOfIterations);
 
@@ -324,28 +317,24 @@ ConfidenceConnectedImageFilter< TInputImage, TOutputImage >
     // Now that we have an initial segmentation, let's recalculate the
     // statistics.  Since we have already labelled the output, we visit
     // pixels in the input image that have been set in the output image.
-    // Essentially, we flip the iterator around, so we walk the input
-    // image (so Get() will get pixel values from the input) and constrain
-    // iterator such it only visits pixels that were set in the output.
-    typename SecondFunctionType::Pointer secondFunction = SecondFunctionType::New();
-    secondFunction->SetInputImage (outputImage);
-    secondFunction->ThresholdBetween(m_ReplaceValue, m_ReplaceValue);
-
     typename NumericTraits< typename InputImageType::PixelType >::RealType sum, sumOfSquares;
     sum = NumericTraits< InputRealType >::ZeroValue();
     sumOfSquares = NumericTraits< InputRealType >::ZeroValue();
     typename TOutputImage::SizeValueType numberOfSamples = 0;
 
-    SecondIteratorType sit =
-      SecondIteratorType (inputImage, secondFunction, m_Seeds);
-    sit.GoToBegin();
-    while ( !sit.IsAtEnd() )
+    ImageRegionConstIterator< InputImageType >  iit(inputImage, region);
+    ImageRegionConstIterator< OutputImageType > oit(outputImage, region);
+    while ( !oit.IsAtEnd() )
       {
-      const InputRealType value = static_cast< InputRealType >( sit.Get() );
-      sum += value;
-      sumOfSquares += value * value;
-      ++numberOfSamples;
-      ++sit;
+      if ( Math::ExactlyEquals( oit.Get(), m_ReplaceValue ) )
+        {
+        const InputRealType value = static_cast< InputRealType >( iit.Get() );
+        sum += value;
+        sumOfSquares += value * value;
+        ++numberOfSamples;
+        }
+      ++iit;
+      ++oit;
       }
     m_Mean      = sum / double(numberOfSamples);
     m_Variance  = ( sumOfSquares - ( sum * sum / double(numberOfSamples) ) ) / ( double(numberOfSamples) - 1.0 );
@@ -398,29 +387,24 @@ ConfidenceConnectedImageFilter< TInputImage, TOutputImage >
                    << " , std::sqrt(variance) = " << std::sqrt(m_Variance) );
     itkDebugMacro(<< "\nsum = " << sum << ", sumOfSquares = " << sumOfSquares << "\nnum = " << numberOfSamples);
 
-    // Rerun the segmentation, the iterator walks the output image,
-    // starting at the seed point.  As the iterator walks, if the
-    // corresponding pixel in the input image (accessed via the
-    // "function" assigned to the iterator) is within the [lower,
-    // upper] bounds prescribed, the pixel is added to the output
-    // segmentation and its neighbors become candidates for the
-    // iterator to walk.
+    // Rerun the segmentation, starting at the seed points.  If a pixel
+    // in the input image (accessed via the "function" assigned to the
+    // flood fill) is within the [lower, upper] bounds prescribed, the
+    // pixel is added to the output segmentation and its neighbors become
+    // candidates for the flood fill.
     outputImage->FillBuffer (NumericTraits< OutputImagePixelType >::ZeroValue());
-    IteratorType thirdIt = IteratorType (outputImage, function, m_Seeds);
-    thirdIt.GoToBegin();
+    FloodFillType floodFill(region, m_Seeds);
+    floodFill.SetFunction(function);
+    floodFill.SetMultiThreader( this->GetMultiThreader(), this->GetNumberOfThreads() );
     try
       {
-      while ( !thirdIt.IsAtEnd() )
-        {
-        thirdIt.Set(m_ReplaceValue);
-        ++thirdIt;
-        progress.CompletedPixel();  // potential exception thrown here
-        }
+      floodFill.Fill(&progress);
       }
     catch ( ProcessAborted & )
       {
       break; // interrupt the iterations loop
       }
+    floodFill.Paint(outputImage, m_ReplaceValue);
     }  // end iteration loop
 
   if ( this->GetAbortGenerateData() )
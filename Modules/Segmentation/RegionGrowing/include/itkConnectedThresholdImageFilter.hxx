@@ -20,10 +20,8 @@
 
 #include "itkConnectedThresholdImageFilter.h"
 #include "itkBinaryThresholdImageFunction.h"
-#include "itkFloodFilledImageFunctionConditionalIterator.h"
+#include "itkParallelFloodFill.h"
 #include "itkProgressReporter.h"
-
-#include "itkShapedFloodFilledImageFunctionConditionalIterator.h"
 #include "itkMath.h"
 
 namespace itk
@@ -294,38 +292,13 @@ ConnectedThresholdImageFilter< TInputImage, TOutputImage >
 
   ProgressReporter progress( this, 0, region.GetNumberOfPixels() );
 
-  if ( this->m_Connectivity == FaceConnectivity )
-    {
-    typedef FloodFilledImageFunctionConditionalIterator< OutputImageType, FunctionType > IteratorType;
-    IteratorType it (outputImage, function, m_Seeds);
-    it.GoToBegin();
-
-    while ( !it.IsAtEnd() )
-      {
-      it.Set(m_ReplaceValue);
-      ++it;
-      progress.CompletedPixel();  // potential exception thrown here
-      }
-    }
-  else if ( this->m_Connectivity == FullConnectivity )
-    {
-    // use the fully connected iterator here. The fully connected iterator
-    // below is a superset of the above. However, it is reported to be 20%
-    // slower. Hence we use this "if" block to use the old iterator when
-    // we don't need full connectivity.
-
-    typedef ShapedFloodFilledImageFunctionConditionalIterator< OutputImageType, FunctionType > IteratorType;
-    IteratorType it (outputImage, function, m_Seeds);
-    it.FullyConnectedOn();
-    it.GoToBegin();
-
-    while ( !it.IsAtEnd() )
-      {
-      it.Set(m_ReplaceValue);
-      ++it;
-      progress.CompletedPixel();  // potential exception thrown here
-      }
-    }
+  // The flood is done by several threads, one level of neighbors at a time
+  typedef ParallelFloodFill< OutputImageType, FunctionType > FloodFillType;
+  FloodFillType floodFill( region, m_Seeds, this->m_Connectivity == FullConnectivity );
+  floodFill.SetFunction(function);
+  floodFill.SetMultiThreader( this->GetMultiThreader(), this->GetNumberOfThreads() );
+  floodFill.Fill(&progress);
+  floodFill.Paint(outputImage, m_ReplaceValue);
 }
 } // end namespace itk
 
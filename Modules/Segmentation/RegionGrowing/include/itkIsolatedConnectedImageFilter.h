@@ -63,6 +63,9 @@ namespace itk
  * isolating threshold because no such threshold exists.  The user can
  * check for this by querying the GetThresholdingFailed() flag.
  *
+ * The region found with the last threshold which separates the seeds is
+ * kept during the binary search, and the region of the next guess is grown
+ * from it instead of from Seeds1.
  *
  * \ingroup RegionGrowingSegmentation
  * \ingroup ITKRegionGrowing
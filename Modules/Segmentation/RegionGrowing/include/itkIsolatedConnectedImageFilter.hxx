@@ -20,7 +20,7 @@
 
 #include "itkIsolatedConnectedImageFilter.h"
 #include "itkBinaryThresholdImageFunction.h"
-#include "itkFloodFilledImageFunctionConditionalIterator.h"
+#include "itkParallelFloodFill.h"
 #include "itkProgressReporter.h"
 #include "itkIterationReporter.h"
 #include "itkMath.h"
@@ -220,17 +220,25 @@ IsolatedConnectedImageFilter< TInputImage, TOutputImage >
   outputImage->Allocate();
   outputImage->FillBuffer (NumericTraits< OutputImagePixelType >::ZeroValue());
 
-  typedef BinaryThresholdImageFunction< InputImageType >                               FunctionType;
-  typedef FloodFilledImageFunctionConditionalIterator< OutputImageType, FunctionType > IteratorType;
+  typedef BinaryThresholdImageFunction< InputImageType >     FunctionType;
+  typedef ParallelFloodFill< OutputImageType, FunctionType > FloodFillType;
 
   typename FunctionType::Pointer function = FunctionType::New();
   function->SetInputImage (inputImage);
 
   float             progressWeight = 0.0f;
   float             cumulatedProgress = 0.0f;
-  IteratorType      it = IteratorType (outputImage, function, m_Seeds1);
   IterationReporter iterate(this, 0, 1);
 
+  // The region found with a threshold which isolates the seeds is kept. The
+  // next guesses are closer to the seeds 2, so their regions contain this
+  // one: they are grown from it instead of from the seeds 1. The growth is
+  // stopped as soon as one of the seeds 2 is reached.
+  FloodFillType isolatedFloodFill(region, m_Seeds1);
+  isolatedFloodFill.SetFunction(function);
+  isolatedFloodFill.SetMultiThreader( this->GetMultiThreader(), this->GetNumberOfThreads() );
+  isolatedFloodFill.SetStopIndices(m_Seeds2);
+
   // If the upper threshold has not been set, find it.
   if ( m_FindUpperThreshold )
     {
@@ -252,35 +260,11 @@ IsolatedConnectedImageFilter< TInputImage, TOutputImage >
       {
       ProgressReporter progress(this, 0, region.GetNumberOfPixels(), 100, cumulatedProgress, progressWeight);
       cumulatedProgress += progressWeight;
-      outputImage->FillBuffer (NumericTraits< OutputImagePixelType >::ZeroValue());
       function->ThresholdBetween ( m_Lower, static_cast< InputImagePixelType >( guess ) );
-      it.GoToBegin();
-      while ( !it.IsAtEnd() )
-        {
-        it.Set(m_ReplaceValue);
-        if ( it.GetIndex() == *m_Seeds2.begin() )
-          {
-          break;
-          }
-        ++it;
-        progress.CompletedPixel(); // potential exception thrown here
-        }
-      // If any of second seeds are included, decrease the upper bound.
-      // Find the sum of the intensities in m_Seeds2.  If the second
-      // seeds are not included, the sum should be zero.  Otherwise,
-      // it will be other than zero.
-      InputRealType seedIntensitySum = NumericTraits< InputRealType >::ZeroValue();
-      typename SeedsContainerType::const_iterator si = m_Seeds2.begin();
-      typename SeedsContainerType::const_iterator li = m_Seeds2.end();
-      while ( si != li )
-        {
-        const InputRealType value =
-          static_cast< InputRealType >( outputImage->GetPixel(*si) );
-        seedIntensitySum += value;
-        si++;
-        }
+      FloodFillType floodFill = isolatedFloodFill;
 
-      if ( Math::NotExactlyEquals(seedIntensitySum, NumericTraits< InputRealType >::ZeroValue()) )
+      // If any of second seeds are included, decrease the upper bound.
+      if ( floodFill.Fill(&progress) )
         {
         upper = guess;
         }
@@ -288,6 +272,7 @@ IsolatedConnectedImageFilter< TInputImage, TOutputImage >
       else
         {
         lower = guess;
+        isolatedFloodFill = floodFill;
         }
       guess = ( upper + lower ) / 2;
       iterate.CompletedStep();
@@ -319,35 +304,11 @@ IsolatedConnectedImageFilter< TInputImage, TOutputImage >
       {
       ProgressReporter progress(this, 0, region.GetNumberOfPixels(), 100, cumulatedProgress, progressWeight);
       cumulatedProgress += progressWeight;
-      outputImage->FillBuffer (NumericTraits< OutputImagePixelType >::ZeroValue());
       function->ThresholdBetween (static_cast< InputImagePixelType >( guess ), m_Upper);
-      it.GoToBegin();
-      while ( !it.IsAtEnd() )
-        {
-        it.Set(m_ReplaceValue);
-        if ( it.GetIndex() == *m_Seeds2.begin() )
-          {
-          break;
-          }
-        ++it;
-        progress.CompletedPixel(); // potential exception thrown here
-        }
-      // If any of second seeds are included, increase the lower bound.
-      // Find the sum of the intensities in m_Seeds2.  If the second
-      // seeds are not included, the sum should be zero.  Otherwise,
-      // it will be other than zero.
-      InputRealType seedIntensitySum = NumericTraits< InputRealType >::ZeroValue();
-      typename SeedsContainerType::const_iterator si = m_Seeds2.begin();
-      typename SeedsContainerType::const_iterator li = m_Seeds2.end();
-      while ( si != li )
-        {
-        const InputRealType value =
-          static_cast< InputRealType >( outputImage->GetPixel(*si) );
-        seedIntensitySum += value;
-        si++;
-        }
+      FloodFillType floodFill = isolatedFloodFill;
 
-      if ( Math::NotExactlyEquals(seedIntensitySum, NumericTraits< InputRealType >::ZeroValue()) )
+      // If any of second seeds are included, increase the lower bound.
+      if ( floodFill.Fill(&progress) )
         {
         lower = guess;
         }
@@ -355,6 +316,7 @@ IsolatedConnectedImageFilter< TInputImage, TOutputImage >
       else
         {
         upper = guess;
+        isolatedFloodFill = floodFill;
         }
       guess = ( upper + lower ) / 2;
       iterate.CompletedStep();
@@ -367,10 +329,10 @@ IsolatedConnectedImageFilter< TInputImage, TOutputImage >
                                                                    // guess
     }
 
-  // now rerun the algorithm with the thresholds that separate the seeds.
+  // now grow the region with the thresholds that separate the seeds,
+  // without stopping at the second seeds.
   ProgressReporter progress(this, 0, region.GetNumberOfPixels(), 100, cumulatedProgress, progressWeight);
 
-  outputImage->FillBuffer (NumericTraits< OutputImagePixelType >::ZeroValue());
   if ( m_FindUpperThreshold )
     {
     function->ThresholdBetween (m_Lower, m_IsolatedValue);
@@ -379,13 +341,9 @@ IsolatedConnectedImageFilter< TInputImage, TOutputImage >
     {
     function->ThresholdBetween (m_IsolatedValue, m_Upper);
     }
-  it.GoToBegin();
-  while ( !it.IsAtEnd() )
-    {
-    it.Set(m_ReplaceValue);
-    ++it;
-    progress.CompletedPixel(); // potential exception thrown here
-    }
+  isolatedFloodFill.SetStopIndices( SeedsContainerType() );
+  isolatedFloodFill.Fill(&progress);
+  isolatedFloodFill.Paint(outputImage, m_ReplaceValue);
 
   // If any of the second seeds are included or some of the first
   // seeds are not included, the algorithm could not find any threshold
@@ -20,7 +20,7 @@
 
 #include "itkNeighborhoodConnectedImageFilter.h"
 #include "itkNeighborhoodBinaryThresholdImageFunction.h"
-#include "itkFloodFilledImageFunctionConditionalIterator.h"
+#include "itkParallelFloodFill.h"
 #include "itkProgressReporter.h"
 
 namespace itk
@@ -125,23 +125,22 @@ NeighborhoodConnectedImageFilter< TInputImage, TOutputImage >
   outputImage->Allocate();
   outputImage->FillBuffer (NumericTraits< OutputImagePixelType >::ZeroValue());
 
-  typedef NeighborhoodBinaryThresholdImageFunction< InputImageType >                   FunctionType;
-  typedef FloodFilledImageFunctionConditionalIterator< OutputImageType, FunctionType > IteratorType;
+  typedef NeighborhoodBinaryThresholdImageFunction< InputImageType > FunctionType;
+  typedef ParallelFloodFill< OutputImageType, FunctionType >         FloodFillType;
 
   typename FunctionType::Pointer function = FunctionType::New();
   function->SetInputImage (inputImage);
   function->ThresholdBetween (m_Lower, m_Upper);
   function->SetRadius (m_Radius);
-  IteratorType it = IteratorType (outputImage, function, m_Seeds);
 
   ProgressReporter progress( this, 0,
                              outputImage->GetRequestedRegion().GetNumberOfPixels() );
-  while ( !it.IsAtEnd() )
-    {
-    it.Set(m_ReplaceValue);
-    ++it;
-    progress.CompletedPixel();
-    }
+
+  FloodFillType floodFill( outputImage->GetRequestedRegion(), m_Seeds );
+  floodFill.SetFunction(function);
+  floodFill.SetMultiThreader( this->GetMultiThreader(), this->GetNumberOfThreads() );
+  floodFill.Fill(&progress);
+  floodFill.Paint(outputImage, m_ReplaceValue);
 }
 } // end namespace itk
 
@@ -0,0 +1,171 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkParallelFloodFill_h
+#define itkParallelFloodFill_h
+
+#include "itkMultiThreader.h"
+#include "itkProgressReporter.h"
+#include <vector>
+
+namespace itk
+{
+/** \class ParallelFloodFill
+ * \brief Finds the pixels connected to a set of seeds which satisfy the
+ * condition of an image function, with several threads.
+ *
+ * The region is grown one level at a time: the neighbors of the pixels added
+ * at the previous level are tested by the threads, each one on a part of the
+ * front, and the results are then added to the region in the order of the
+ * threads. The pixels found are the same as with
+ * FloodFilledImageFunctionConditionalIterator, whatever the number of
+ * threads. The pixels of the region and the pixels tested outside are stored
+ * in two bit masks.
+ *
+ * The pixels tested outside are kept, and tested again by the next call to
+ * Fill(). When the function is changed so that the region can only grow, as
+ * when a threshold is raised, Fill() continues the previous region instead of
+ * flooding again from the seeds. The object can be copied to save a region
+ * and restore it later.
+ *
+ * The function must be safe to evaluate from several threads, as
+ * BinaryThresholdImageFunction and NeighborhoodBinaryThresholdImageFunction
+ * are.
+ *
+ * \sa FloodFilledImageFunctionConditionalIterator
+ * \sa ConnectedThresholdImageFilter
+ * \ingroup ITKRegionGrowing
+ */
+template< typename TImage, typename TFunction >
+class ParallelFloodFill
+{
+public:
+  typedef ParallelFloodFill Self;
+
+  typedef TImage                         ImageType;
+  typedef TFunction                      FunctionType;
+  typedef typename ImageType::IndexType  IndexType;
+  typedef typename ImageType::RegionType RegionType;
+  typedef typename ImageType::PixelType  PixelType;
+  typedef std::vector< IndexType >       IndexContainerType;
+
+  itkStaticConstMacro(ImageDimension, unsigned int, ImageType::ImageDimension);
+
+  /** Prepares the flood of the region from the seeds inside the region. The
+   * neighbors of a pixel are the pixels which share a face with it, or with
+   * fullyConnected, all the pixels which touch it. */
+  ParallelFloodFill(const RegionType & region, const IndexContainerType & seeds, bool fullyConnected = false);
+
+  void SetFunction(const FunctionType *function)
+  {
+    m_Function = function;
+  }
+
+  /** The threader used to test the pixels. Without threader, a single thread
+   * is used. */
+  void SetMultiThreader(MultiThreader *threader, ThreadIdType numberOfThreads)
+  {
+    m_MultiThreader = threader;
+    m_NumberOfThreads = numberOfThreads;
+  }
+
+  /** Fill() stops as soon as one of these pixels is in the region. */
+  void SetStopIndices(const IndexContainerType & indices)
+  {
+    m_StopIndices = indices;
+  }
+
+  /** Grows the region with the current function. A pixel added to the region
+   * is reported to progress. Returns true if the growth was stopped by one of
+   * the stop indices. */
+  bool Fill(ProgressReporter *progress = ITK_NULLPTR);
+
+  bool IsInside(const IndexType & index) const
+  {
+    return m_Region.IsInside(index) && m_Inside[this->OffsetOf(index)];
+  }
+
+  /** Sets the pixels of the region to value in image. The buffer of image
+   * must contain the region. */
+  void Paint(ImageType *image, const PixelType & value) const;
+
+private:
+  typedef typename ImageType::OffsetType OffsetType;
+
+  struct Candidate {
+    IndexType m_Index;
+    bool      m_Inside;
+  };
+
+  struct ThreadStruct {
+    Self *                    Filler;
+    const IndexContainerType *Pixels;
+    bool                      TestNeighbors;
+  };
+
+  SizeValueType OffsetOf(const IndexType & index) const
+  {
+    SizeValueType offset = 0;
+
+    for ( int i = ImageDimension - 1; i >= 0; i-- )
+      {
+      offset = offset * m_Region.GetSize(i) + static_cast< SizeValueType >( index[i] - m_Region.GetIndex(i) );
+      }
+    return offset;
+  }
+
+  /** Tests the pixels, or their neighbors not tested yet, in parallel. */
+  void Test(const IndexContainerType & pixels, bool testNeighbors);
+
+  /** Tests a part of the pixels or of their neighbors. */
+  void ThreadedTest(const IndexContainerType & pixels, bool testNeighbors,
+                    ThreadIdType threadId, ThreadIdType numberOfThreads);
+
+  /** Adds the candidates found by the threads to the region or to the
+   * boundary, in the order of the threads. */
+  void AddCandidates(ProgressReporter *progress);
+
+  bool StopIndexReached() const;
+
+  static ITK_THREAD_RETURN_TYPE ThreaderCallback(void *arg);
+
+  RegionType                m_Region;
+  std::vector< OffsetType > m_Neighbors;
+  const FunctionType *      m_Function;
+  MultiThreader *           m_MultiThreader;
+  ThreadIdType              m_NumberOfThreads;
+  IndexContainerType        m_StopIndices;
+
+  // The pixels in the region, and the pixels tested outside of it
+  std::vector< bool > m_Inside;
+  std::vector< bool > m_Outside;
+
+  // The pixels added at the last level, whose neighbors are not tested yet
+  IndexContainerType m_Front;
+
+  // The pixels tested outside, tested again by the next fill
+  IndexContainerType m_Boundary;
+
+  std::vector< std::vector< Candidate > > m_Candidates;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkParallelFloodFill.hxx"
+#endif
+
+#endif
@@ -0,0 +1,265 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkParallelFloodFill_hxx
+#define itkParallelFloodFill_hxx
+
+#include "itkParallelFloodFill.h"
+#include "itkImageRegionIterator.h"
+
+namespace itk
+{
+template< typename TImage, typename TFunction >
+ParallelFloodFill< TImage, TFunction >
+::ParallelFloodFill(const RegionType & region, const IndexContainerType & seeds, bool fullyConnected) :
+  m_Region(region),
+  m_Function(ITK_NULLPTR),
+  m_MultiThreader(ITK_NULLPTR),
+  m_NumberOfThreads(1),
+  m_Inside(region.GetNumberOfPixels(), false),
+  m_Outside(region.GetNumberOfPixels(), false)
+{
+  // the offsets of the neighbors, with the values -1, 0 and 1 on each axis
+  unsigned int numberOfOffsets = 1;
+  for ( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    numberOfOffsets *= 3;
+    }
+  for ( unsigned int n = 0; n < numberOfOffsets; n++ )
+    {
+    OffsetType   offset;
+    unsigned int numberOfNonZero = 0;
+    unsigned int code = n;
+    for ( unsigned int i = 0; i < ImageDimension; i++ )
+      {
+      offset[i] = static_cast< OffsetValueType >( code % 3 ) - 1;
+      code /= 3;
+      if ( offset[i] != 0 )
+        {
+        numberOfNonZero++;
+        }
+      }
+    if ( numberOfNonZero == 1 || ( fullyConnected && numberOfNonZero > 1 ) )
+      {
+      m_Neighbors.push_back(offset);
+      }
+    }
+
+  // the seeds are tested by the first fill
+  for ( typename IndexContainerType::const_iterator it = seeds.begin(); it != seeds.end(); ++it )
+    {
+    if ( m_Region.IsInside(*it) )
+      {
+      m_Boundary.push_back(*it);
+      }
+    }
+}
+
+template< typename TImage, typename TFunction >
+bool
+ParallelFloodFill< TImage, TFunction >
+::Fill(ProgressReporter *progress)
+{
+  // Test again the pixels found outside by the previous fill
+  IndexContainerType pixels;
+  pixels.swap(m_Boundary);
+  for ( typename IndexContainerType::const_iterator it = pixels.begin(); it != pixels.end(); ++it )
+    {
+    m_Outside[this->OffsetOf(*it)] = false;
+    }
+  this->Test(pixels, false);
+  this->AddCandidates(progress);
+
+  // Then grow the region one level at a time
+  while ( !this->StopIndexReached() )
+    {
+    if ( m_Front.empty() )
+      {
+      return false;
+      }
+    pixels.clear();
+    pixels.swap(m_Front);
+    this->Test(pixels, true);
+    this->AddCandidates(progress);
+    }
+  return true;
+}
+
+template< typename TImage, typename TFunction >
+void
+ParallelFloodFill< TImage, TFunction >
+::Paint(ImageType *image, const PixelType & value) const
+{
+  // the masks are in the same order as the iterator
+  ImageRegionIterator< ImageType > it(image, m_Region);
+  for ( SizeValueType offset = 0; !it.IsAtEnd(); ++it, ++offset )
+    {
+    if ( m_Inside[offset] )
+      {
+      it.Set(value);
+      }
+    }
+}
+
+template< typename TImage, typename TFunction >
+void
+ParallelFloodFill< TImage, TFunction >
+::Test(const IndexContainerType & pixels, bool testNeighbors)
+{
+  // The threads are only worth starting for a large front
+  const SizeValueType MinimumPixelsPerThread = 256;
+
+  ThreadIdType numberOfThreads = 1;
+  if ( m_MultiThreader )
+    {
+    numberOfThreads = static_cast< ThreadIdType >(
+      std::min( static_cast< SizeValueType >( m_NumberOfThreads ), pixels.size() / MinimumPixelsPerThread ) );
+    numberOfThreads = std::max( numberOfThreads, ThreadIdType(1) );
+    }
+  if ( m_Candidates.size() < numberOfThreads )
+    {
+    m_Candidates.resize(numberOfThreads);
+    }
+  for ( ThreadIdType i = 0; i < m_Candidates.size(); i++ )
+    {
+    m_Candidates[i].clear();
+    }
+
+  if ( numberOfThreads == 1 )
+    {
+    this->ThreadedTest(pixels, testNeighbors, 0, 1);
+    }
+  else
+    {
+    ThreadStruct str;
+    str.Filler = this;
+    str.Pixels = &pixels;
+    str.TestNeighbors = testNeighbors;
+    m_MultiThreader->SetNumberOfThreads(numberOfThreads);
+    m_MultiThreader->SetSingleMethod(Self::ThreaderCallback, &str);
+    m_MultiThreader->SingleMethodExecute();
+    }
+}
+
+template< typename TImage, typename TFunction >
+void
+ParallelFloodFill< TImage, TFunction >
+::ThreadedTest(const IndexContainerType & pixels, bool testNeighbors,
+               ThreadIdType threadId, ThreadIdType numberOfThreads)
+{
+  const SizeValueType begin = pixels.size() * threadId / numberOfThreads;
+  const SizeValueType end = pixels.size() * ( threadId + 1 ) / numberOfThreads;
+
+  std::vector< Candidate > & candidates = m_Candidates[threadId];
+
+  // The masks are only read here: a pixel reached from several pixels of
+  // the front is tested more than once, and added only once by
+  // AddCandidates().
+  Candidate candidate;
+  for ( SizeValueType p = begin; p < end; p++ )
+    {
+    if ( !testNeighbors )
+      {
+      candidate.m_Index = pixels[p];
+      candidate.m_Inside = m_Function->EvaluateAtIndex(candidate.m_Index);
+      candidates.push_back(candidate);
+      continue;
+      }
+    for ( typename std::vector< OffsetType >::const_iterator nit = m_Neighbors.begin();
+          nit != m_Neighbors.end();
+          ++nit )
+      {
+      candidate.m_Index = pixels[p] + *nit;
+      if ( !m_Region.IsInside(candidate.m_Index) )
+        {
+        continue;
+        }
+      const SizeValueType offset = this->OffsetOf(candidate.m_Index);
+      if ( m_Inside[offset] || m_Outside[offset] )
+        {
+        continue;
+        }
+      candidate.m_Inside = m_Function->EvaluateAtIndex(candidate.m_Index);
+      candidates.push_back(candidate);
+      }
+    }
+}
+
+template< typename TImage, typename TFunction >
+void
+ParallelFloodFill< TImage, TFunction >
+::AddCandidates(ProgressReporter *progress)
+{
+  for ( ThreadIdType i = 0; i < m_Candidates.size(); i++ )
+    {
+    const std::vector< Candidate > & candidates = m_Candidates[i];
+    for ( typename std::vector< Candidate >::const_iterator it = candidates.begin(); it != candidates.end(); ++it )
+      {
+      const SizeValueType offset = this->OffsetOf(it->m_Index);
+      if ( m_Inside[offset] || m_Outside[offset] )
+        {
+        // already added by a previous candidate
+        continue;
+        }
+      if ( it->m_Inside )
+        {
+        m_Inside[offset] = true;
+        m_Front.push_back(it->m_Index);
+        if ( progress )
+          {
+          progress->CompletedPixel(); // potential exception thrown here
+          }
+        }
+      else
+        {
+        m_Outside[offset] = true;
+        m_Boundary.push_back(it->m_Index);
+        }
+      }
+    }
+}
+
+template< typename TImage, typename TFunction >
+bool
+ParallelFloodFill< TImage, TFunction >
+::StopIndexReached() const
+{
+  for ( typename IndexContainerType::const_iterator it = m_StopIndices.begin(); it != m_StopIndices.end(); ++it )
+    {
+    if ( this->IsInside(*it) )
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+template< typename TImage, typename TFunction >
+ITK_THREAD_RETURN_TYPE
+ParallelFloodFill< TImage, TFunction >
+::ThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  ThreadStruct *                   str = static_cast< ThreadStruct * >( info->UserData );
+
+  str->Filler->ThreadedTest(*str->Pixels, str->TestNeighbors, info->ThreadID, info->NumberOfThreads);
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+} // end namespace itk
+
+#endif
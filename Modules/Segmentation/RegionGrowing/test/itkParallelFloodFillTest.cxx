@@ -0,0 +1,199 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkConnectedThresholdImageFilter.h"
+#include "itkIsolatedConnectedImageFilter.h"
+#include "itkBinaryThresholdImageFunction.h"
+#include "itkFloodFilledImageFunctionConditionalIterator.h"
+#include "itkShapedFloodFilledImageFunctionConditionalIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkTestingMacros.h"
+#include <cmath>
+
+namespace
+{
+const unsigned int Dimension = 2;
+
+typedef itk::Image< unsigned char, Dimension >                 ImageType;
+typedef itk::BinaryThresholdImageFunction< ImageType, double > FunctionType;
+typedef std::vector< ImageType::IndexType >                    SeedsContainerType;
+
+/* Floods the image from the seeds with the iterators, as the region growing
+ * filters did. */
+ImageType::Pointer
+ReferenceFlood( const ImageType *image, SeedsContainerType seeds, double lower, double upper,
+                bool fullyConnected )
+{
+  ImageType::Pointer output = ImageType::New();
+  output->SetRegions( image->GetLargestPossibleRegion() );
+  output->Allocate( true );
+
+  FunctionType::Pointer function = FunctionType::New();
+  function->SetInputImage( image );
+  function->ThresholdBetween( lower, upper );
+  if( fullyConnected )
+    {
+    itk::ShapedFloodFilledImageFunctionConditionalIterator< ImageType, FunctionType > it( output, function, seeds );
+    it.FullyConnectedOn();
+    for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      it.Set( 255 );
+      }
+    }
+  else
+    {
+    itk::FloodFilledImageFunctionConditionalIterator< ImageType, FunctionType > it( output, function, seeds );
+    for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      it.Set( 255 );
+      }
+    }
+  return output;
+}
+
+bool
+SameImages( const ImageType *image1, const ImageType *image2 )
+{
+  itk::ImageRegionConstIterator< ImageType > it1( image1, image1->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< ImageType > it2( image2, image2->GetLargestPossibleRegion() );
+  for(; !it1.IsAtEnd(); ++it1, ++it2 )
+    {
+    if( it1.Get() != it2.Get() )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+}
+
+/* Compares the region grown by ConnectedThresholdImageFilter with several
+ * threads to the one found by the flood filled iterators, and the threshold
+ * found by IsolatedConnectedImageFilter to the one found by trying all the
+ * thresholds. */
+int itkParallelFloodFillTest( int, char * [] )
+{
+  ImageType::SizeType size;
+  size.Fill( 512 );
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+  // bumps, cut by diagonal walls one pixel thick, which stop the face
+  // connected regions but not the fully connected ones, except where the
+  // walls have gaps
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+  for(; !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType index = it.GetIndex();
+    const double               value = 130.0 + 100.0 * std::sin( index[0] / 31.0 ) * std::cos( index[1] / 23.0 );
+    const bool                 isWall = ( index[0] + index[1] ) % 37 == 0 && index[1] % 50 != 25;
+    it.Set( static_cast< unsigned char >( isWall ? 0 : value ) );
+    }
+
+  SeedsContainerType   seeds;
+  ImageType::IndexType seed;
+  seed[0] = 49;
+  seed[1] = 0;
+  seeds.push_back( seed );
+  seed[0] = 250;
+  seed[1] = 300;
+  seeds.push_back( seed );
+
+  // connected threshold
+  typedef itk::ConnectedThresholdImageFilter< ImageType, ImageType > ConnectedType;
+  ImageType::Pointer references[2];
+  for( unsigned int fullyConnected = 0; fullyConnected < 2; fullyConnected++ )
+    {
+    ImageType::Pointer reference = ReferenceFlood( image, seeds, 120, 255, fullyConnected );
+    references[fullyConnected] = reference;
+    for( itk::ThreadIdType numberOfThreads = 1; numberOfThreads <= 4; numberOfThreads += 3 )
+      {
+      ConnectedType::Pointer connected = ConnectedType::New();
+      connected->SetInput( image );
+      connected->SetSeed( seeds[0] );
+      connected->AddSeed( seeds[1] );
+      connected->SetLower( 120 );
+      connected->SetUpper( 255 );
+      connected->SetReplaceValue( 255 );
+      connected->SetConnectivity( fullyConnected ? ConnectedType::FullConnectivity : ConnectedType::FaceConnectivity );
+      connected->SetNumberOfThreads( numberOfThreads );
+      TRY_EXPECT_NO_EXCEPTION( connected->Update() );
+      if( !SameImages( reference, connected->GetOutput() ) )
+        {
+        std::cerr << "The regions differ with fully connected " << fullyConnected << " and " << numberOfThreads
+                  << " threads" << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+  if( SameImages( references[0], references[1] ) )
+    {
+    std::cerr << "The walls don't separate the face connected regions" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // isolated connected: the lowest lower threshold which separates the seeds
+  SeedsContainerType seeds1( 1, seeds[0] );
+  SeedsContainerType seeds2( 1, seeds[1] );
+  unsigned int       isolatedValue = 0;
+  for( unsigned int threshold = 0; threshold < 256; threshold++ )
+    {
+    ImageType::Pointer region = ReferenceFlood( image, seeds1, threshold, 255, false );
+    if( region->GetPixel( seeds2[0] ) == 0 )
+      {
+      isolatedValue = threshold;
+      break;
+      }
+    }
+
+  typedef itk::IsolatedConnectedImageFilter< ImageType, ImageType > IsolatedType;
+  IsolatedType::Pointer isolated = IsolatedType::New();
+  isolated->SetInput( image );
+  isolated->AddSeed1( seeds1[0] );
+  isolated->AddSeed2( seeds2[0] );
+  isolated->SetLower( 0 );
+  isolated->SetUpper( 255 );
+  isolated->SetReplaceValue( 255 );
+  isolated->SetIsolatedValueTolerance( 1 );
+  isolated->FindUpperThresholdOff();
+  isolated->SetNumberOfThreads( 4 );
+  TRY_EXPECT_NO_EXCEPTION( isolated->Update() );
+  std::cout << "IsolatedConnected: isolated value "
+            << static_cast< unsigned int >( isolated->GetIsolatedValue() ) << ", lowest isolated value "
+            << isolatedValue << std::endl;
+
+  // the binary search stops when the isolated value is known within the
+  // tolerance
+  const unsigned int foundValue = isolated->GetIsolatedValue();
+  if( foundValue < isolatedValue || foundValue > isolatedValue + 1 || isolated->GetThresholdingFailed() )
+    {
+    std::cerr << "Wrong isolated value, expected " << isolatedValue << " or " << isolatedValue + 1 << std::endl;
+    return EXIT_FAILURE;
+    }
+  ImageType::Pointer reference = ReferenceFlood( image, seeds1, foundValue, 255, false );
+  if( !SameImages( reference, isolated->GetOutput() ) )
+    {
+    std::cerr << "The isolated regions differ" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
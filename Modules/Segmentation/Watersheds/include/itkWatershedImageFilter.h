@@ -23,6 +23,7 @@
 #include "itkWatershedSegmentTreeGenerator.h"
 #include "itkWatershedRelabeler.h"
 #include "itkWatershedMiniPipelineProgressCommand.h"
+#include <vector>
 
 namespace itk
 {
@@ -138,10 +139,25 @@ namespace itk
  * Threshold and Level parameters are controlled through the class'
  * Get/SetThreshold() and Get/SetLevel() methods.
  *
- * \par Notes on streaming the watershed segmentation code
- *  Coming soon... 12/06/01
- *
- *
+ * \par Segmenting in slabs
+ * When NumberOfSlabs is greater than one, the input is split in slabs
+ * along its slowest dimension, which are processed in parallel by up to
+ * GetNumberOfThreads() threads.  The whole input is still requested and
+ * must be in memory: the slabs bound the working memory of the
+ * segmentation, not the input.  The output image is used as that working
+ * memory: it holds the pixel each pixel flows to until the labels are
+ * known.  The thresholded image and the intermediate label images of the
+ * Segmenter and of the Relabeler are not allocated, so that besides the
+ * input and the output, only the segment table and the tables of the
+ * slabs, whose sizes depend on the number of segments and plateaus, are
+ * held in memory.  The slabs are processed following the rules of the
+ * Segmenter, including the order in which it numbers the segments and
+ * collects their edges, so that the output is the same as with a single
+ * slab.  A change to the flooding rules of the Segmenter must be made in
+ * both places; itkWatershedImageFilterSlabsTest checks that the labels are
+ * identical.  With several slabs, the whole segmentation is done again when
+ * the Level is changed, and GetBasicSegmentation() still executes the
+ * Segmenter on the whole input.
  *
  * \ingroup WatershedSegmentation
  * \ingroup ITKWatersheds
@@ -185,7 +201,8 @@ public:
   /** Method for creation through the object factory. */
   itkNewMacro(Self);
 
-  /** Standard process object method.  This filter is not multithreaded. */
+  /** Standard process object method.  This filter is multithreaded only when
+   * NumberOfSlabs is greater than one. */
   void GenerateData() ITK_OVERRIDE;
 
   /** Overloaded to link the input to this filter with the input of the
@@ -225,7 +242,14 @@ public:
 
   itkGetConstMacro(Level, double);
 
-  /** Get the basic segmentation from the Segmenter member filter. */
+  /** Set/Get the number of slabs in which the input is split to be segmented
+   * in parallel.  The default value of 1 segments the whole input at
+   * once. */
+  itkSetClampMacro(NumberOfSlabs, unsigned int, 1, NumericTraits< unsigned int >::max());
+  itkGetConstMacro(NumberOfSlabs, unsigned int);
+
+  /** Get the basic segmentation from the Segmenter member filter.  The
+   * basic segmentation is always computed on the whole input. */
   typename watershed::Segmenter< InputImageType >::OutputImageType *
   GetBasicSegmentation()
   {
@@ -269,6 +293,123 @@ private:
   WatershedImageFilter(const Self &) ITK_DELETE_FUNCTION;
   void operator=(const Self &) ITK_DELETE_FUNCTION;
 
+  typedef watershed::Segmenter< InputImageType >       SegmenterType;
+  typedef typename SegmenterType::SegmentTableType     SegmentTableType;
+
+  /** The edge tables of the Segmenter, which are filled in the same order in
+   * the slab mode so that the edge lists are identical. */
+  typedef itksys::hash_map< IdentifierType, ScalarType, itksys::hash< IdentifierType > >    EdgeTableType;
+  typedef itksys::hash_map< IdentifierType, EdgeTableType, itksys::hash< IdentifierType > > EdgeTableHashType;
+
+  /** The lowest pixel around a plateau and its value, indexed by the first
+   * pixel of the plateau.  The pixels are identified by their offsets in the
+   * output buffer. */
+  typedef std::pair< ScalarType, IdentifierType > LowestNeighborType;
+  typedef itksys::hash_map< IdentifierType, LowestNeighborType, itksys::hash< IdentifierType > >
+  LowestNeighborMapType;
+
+  /** The label of the pixels which flow to a given pixel. */
+  typedef itksys::hash_map< IdentifierType, IdentifierType, itksys::hash< IdentifierType > > LabelMapType;
+
+  /** An edge found in a slab, with the lowest height seen in the slab. */
+  struct SlabEdge {
+    IdentifierType m_Label;
+    IdentifierType m_Neighbor;
+    ScalarType     m_Height;
+  };
+
+  /** Hashes the pair of labels of an edge. */
+  struct SlabEdgeHash {
+    size_t operator()(const std::pair< IdentifierType, IdentifierType > & edge) const
+    {
+      return static_cast< size_t >( edge.first * 2654435761u + edge.second );
+    }
+  };
+
+  /** A slab of the input, and the tables collected on it.  The slab is the
+   * range [m_Begin, m_End) of the buffer. */
+  struct SlabChunk {
+    IdentifierType                                         m_Begin;
+    IdentifierType                                         m_End;
+    ScalarType                                             m_Minimum;
+    ScalarType                                             m_Maximum;
+    IdentifierType                                         m_FirstLabel;
+    std::vector< IdentifierType >                          m_Seeds;
+    std::vector< IdentifierType >                          m_Exits;
+    LowestNeighborMapType                                  m_LowestNeighbors;
+    LabelMapType                                           m_Labels;
+    std::vector< std::pair< IdentifierType, ScalarType > > m_Segments;
+    std::vector< SlabEdge >                                m_Edges;
+  };
+
+  /** The steps of the slab mode which are done on each slab. */
+  typedef enum {
+    ComputeRangeStep,
+    LinkPixelsStep,
+    FindLowestNeighborsStep,
+    ResolvePathsStep,
+    FindLabelsStep,
+    RelabelStep,
+    CollectSegmentsStep
+    } SlabStepType;
+
+  struct SlabThreadStruct {
+    Self *                      Filter;
+    std::vector< SlabChunk > *  Chunks;
+    SlabStepType                Step;
+    const ScalarType *          Input;
+    IdentifierType *            Output;
+    SizeType                    Size;
+    IdentifierType              Stride[ImageDimension];
+    ScalarType                  ThresholdValue;
+    ScalarType                  Wall;
+    LowestNeighborMapType       Descending;
+    LabelMapType                Labels;
+  };
+
+  /** Segments the input in slabs, with the output image as the working
+   * memory. */
+  void GenerateDataInSlabs(unsigned int splitDimension, unsigned int numberOfChunks);
+
+  /** The value of a pixel in the image thresholded by the Segmenter. */
+  static ScalarType Thresholded(ScalarType value, ScalarType thresholdValue);
+
+  static ScalarType GetValue(const SlabThreadStruct & str, IdentifierType pixel);
+
+  /** Gets the i-th neighbor of a pixel, in the order of the connectivity of
+   * the Segmenter: the lower neighbors from the last dimension to the first,
+   * then the upper neighbors from the first dimension to the last.  Returns
+   * false when the neighbor is in the retaining wall around the image. */
+  static bool GetNeighbor(const SlabThreadStruct & str, IdentifierType pixel, const IndexType & index,
+                          unsigned int i, IdentifierType & neighbor);
+
+  /** Whether a pixel belongs to a plateau, i.e. one of its neighbors or the
+   * retaining wall is almost equal to it. */
+  static bool IsFlat(const SlabThreadStruct & str, IdentifierType pixel, const IndexType & index);
+
+  /** The first pixel of the plateau of a flat pixel, once the plateaus are
+   * linked across the slabs. */
+  static IdentifierType GetPlateau(const SlabThreadStruct & str, IdentifierType pixel);
+
+  /** The index of a pixel, and the index of the next pixel. */
+  static void ComputeIndex(const SlabThreadStruct & str, IdentifierType pixel, IndexType & index);
+  static void IncrementIndex(const SlabThreadStruct & str, IndexType & index);
+
+  /** The steps done on each slab. */
+  void ComputeChunkRange(const SlabThreadStruct & str, SlabChunk & chunk) const;
+  void LinkChunkPixels(const SlabThreadStruct & str, SlabChunk & chunk) const;
+  void FindChunkLowestNeighbors(const SlabThreadStruct & str, SlabChunk & chunk) const;
+  void ResolveChunkPaths(const SlabThreadStruct & str, SlabChunk & chunk) const;
+  void FindChunkLabels(const SlabThreadStruct & str, SlabChunk & chunk) const;
+  void RelabelChunk(const SlabThreadStruct & str, SlabChunk & chunk) const;
+  void CollectChunkSegments(const SlabThreadStruct & str, SlabChunk & chunk) const;
+
+  /** Static function used as a "callback" by the MultiThreader.  The slabs
+   * are distributed between the threads in a round-robin fashion. */
+  static ITK_THREAD_RETURN_TYPE SlabThreaderCallback(void *arg);
+
+  unsigned int m_NumberOfSlabs;
+
   /** A Percentage of the maximum depth (max - min pixel value) in the input
    *  image.  This percentage will be used to threshold the minimum values in
    *  the image. */
@@ -18,6 +18,8 @@
 #ifndef itkWatershedImageFilter_hxx
 #define itkWatershedImageFilter_hxx
 #include "itkWatershedImageFilter.h"
+#include "itkMath.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -78,7 +80,7 @@ CLANG_PRAGMA_POP    \
 
 template< typename TInputImage >
 WatershedImageFilter< TInputImage >
-::WatershedImageFilter():m_Threshold(0.0), m_Level(0.0)
+::WatershedImageFilter():m_NumberOfSlabs(1), m_Threshold(0.0), m_Level(0.0)
 {
   // Set up the mini-pipeline for the first execution.
   m_Segmenter    = watershed::Segmenter< InputImageType >::New();
@@ -178,6 +180,33 @@ void
 WatershedImageFilter< TInputImage >
 ::GenerateData()
 {
+  // The input is split along its slowest dimension, so that the slabs are
+  // contiguous in the buffers
+  const RegionType largestRegion = this->GetInput()->GetLargestPossibleRegion();
+  unsigned int     splitDimension = ImageDimension - 1;
+  while ( splitDimension > 0 && largestRegion.GetSize()[splitDimension] == 1 )
+    {
+    --splitDimension;
+    }
+  const SizeValueType numberOfChunks =
+    std::min( static_cast< SizeValueType >( m_NumberOfSlabs ),
+              largestRegion.GetSize()[splitDimension] );
+  if ( numberOfChunks > 1 && this->GetInput()->GetBufferedRegion() == largestRegion )
+    {
+    this->GenerateDataInSlabs( splitDimension, static_cast< unsigned int >( numberOfChunks ) );
+
+    m_GenerateDataMTime.Modified();
+    m_InputChanged = false;
+    m_LevelChanged = false;
+    m_ThresholdChanged = false;
+    return;
+    }
+
+  // The slab mode may have connected the tree generator to another
+  // segment table
+  m_TreeGenerator->SetInputSegmentTable( m_Segmenter->GetSegmentTable() );
+  m_TreeGenerator->SetConsumeInput(false);
+
   // Set the largest possible region in the segmenter
   m_Segmenter->SetLargestPossibleRegion( this->GetInput()
                                          ->GetLargestPossibleRegion() );
@@ -209,6 +238,766 @@ WatershedImageFilter< TInputImage >
   m_ThresholdChanged = false;
 }
 
+template< typename TInputImage >
+void
+WatershedImageFilter< TInputImage >
+::GenerateDataInSlabs(unsigned int splitDimension, unsigned int numberOfChunks)
+{
+  const InputImageType *input = this->GetInput();
+  const RegionType      largestRegion = input->GetLargestPossibleRegion();
+
+  // The output holds the pixel each pixel flows to until it is labeled
+  this->AllocateOutputs();
+  OutputImageType *output = this->GetOutput();
+
+  SlabThreadStruct str;
+  str.Filter = this;
+  str.Input = input->GetBufferPointer();
+  str.Output = output->GetBufferPointer();
+  str.Size = largestRegion.GetSize();
+  IdentifierType stride = 1;
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    str.Stride[i] = stride;
+    stride *= str.Size[i];
+    }
+  str.ThresholdValue = NumericTraits< ScalarType >::ZeroValue();
+  str.Wall = NumericTraits< ScalarType >::ZeroValue();
+
+  // The slabs are made of whole layers along the split dimension
+  const SizeValueType        length = str.Size[splitDimension];
+  std::vector< SlabChunk > chunks(numberOfChunks);
+  for ( unsigned int c = 0; c < numberOfChunks; ++c )
+    {
+    chunks[c].m_Begin = c * length / numberOfChunks * str.Stride[splitDimension];
+    chunks[c].m_End = ( c + 1 ) * length / numberOfChunks * str.Stride[splitDimension];
+    }
+  str.Chunks = &chunks;
+
+  MultiThreader *threader = this->GetMultiThreader();
+  threader->SetNumberOfThreads( std::min( this->GetNumberOfThreads(),
+                                          static_cast< ThreadIdType >( numberOfChunks ) ) );
+  threader->SetSingleMethod(Self::SlabThreaderCallback, &str);
+
+  str.Step = ComputeRangeStep;
+  threader->SingleMethodExecute();
+
+  // The threshold value and the retaining wall are the ones of the
+  // Segmenter
+  ScalarType minimum = chunks[0].m_Minimum;
+  ScalarType maximum = chunks[0].m_Maximum;
+  for ( unsigned int c = 1; c < numberOfChunks; ++c )
+    {
+    minimum = std::min(minimum, chunks[c].m_Minimum);
+    maximum = std::max(maximum, chunks[c].m_Maximum);
+    }
+  if ( NumericTraits< ScalarType >::IsInteger
+CLANG_PRAGMA_PUSH
+CLANG_SUPPRESS_Wfloat_equal
+       && maximum == NumericTraits< ScalarType >::max() )
+CLANG_PRAGMA_POP
+    {
+    maximum -= NumericTraits< ScalarType >::OneValue();
+    }
+  str.ThresholdValue = static_cast< ScalarType >( ( m_Threshold * ( maximum - minimum ) ) + minimum );
+  str.Wall = maximum + NumericTraits< ScalarType >::OneValue();
+
+  // Each pixel is linked to its steepest descent neighbor, or to the first
+  // pixel of its plateau in its slab
+  str.Step = LinkPixelsStep;
+  threader->SingleMethodExecute();
+
+  // Link the plateaus across the faces shared by the slabs.  Only the first
+  // pixels of the plateaus in the slabs are changed, and they are then
+  // linked to the first pixel of the whole plateau.
+  const IdentifierType          faceSize = str.Stride[splitDimension];
+  std::vector< IdentifierType > linked;
+  for ( unsigned int c = 1; c < numberOfChunks; ++c )
+    {
+    for ( IdentifierType pixel = chunks[c].m_Begin; pixel < chunks[c].m_Begin + faceSize; ++pixel )
+      {
+      if ( !Math::AlmostEquals( Self::GetValue(str, pixel), Self::GetValue(str, pixel - faceSize) ) )
+        {
+        continue;
+        }
+      IdentifierType a = pixel;
+      IdentifierType b = pixel - faceSize;
+      while ( str.Output[a] != a )
+        {
+        a = str.Output[a];
+        }
+      while ( str.Output[b] != b )
+        {
+        b = str.Output[b];
+        }
+      if ( a != b )
+        {
+        str.Output[std::max(a, b)] = std::min(a, b);
+        linked.push_back( std::max(a, b) );
+        }
+      }
+    }
+  for ( typename std::vector< IdentifierType >::const_iterator it = linked.begin(); it != linked.end(); ++it )
+    {
+    IdentifierType first = *it;
+    while ( str.Output[first] != first )
+      {
+      first = str.Output[first];
+      }
+    str.Output[*it] = first;
+    }
+  std::vector< IdentifierType >().swap(linked);
+
+  // The plateaus which have a lower neighbor flow to the first lowest one
+  str.Step = FindLowestNeighborsStep;
+  threader->SingleMethodExecute();
+  LowestNeighborMapType lowestNeighbors;
+  for ( unsigned int c = 0; c < numberOfChunks; ++c )
+    {
+    for ( typename LowestNeighborMapType::const_iterator it = chunks[c].m_LowestNeighbors.begin();
+          it != chunks[c].m_LowestNeighbors.end(); ++it )
+      {
+      std::pair< typename LowestNeighborMapType::iterator, bool > inserted = lowestNeighbors.insert(*it);
+      if ( !inserted.second && it->second.first < inserted.first->second.first )
+        {
+        inserted.first->second = it->second;
+        }
+      }
+    chunks[c].m_LowestNeighbors.clear();
+    }
+  for ( typename LowestNeighborMapType::const_iterator it = lowestNeighbors.begin(); it != lowestNeighbors.end(); ++it )
+    {
+    if ( it->second.first < Self::GetValue(str, it->first) )
+      {
+      str.Descending.insert(*it);
+      str.Output[it->first] = it->second.second;
+      }
+    }
+  lowestNeighbors.clear();
+
+  // Follow the paths to their ends in the slabs, then the paths which leave
+  // their slab to their ends in the image
+  str.Step = ResolvePathsStep;
+  threader->SingleMethodExecute();
+  for ( unsigned int c = 0; c < numberOfChunks; ++c )
+    {
+    const std::vector< IdentifierType > & exits = chunks[c].m_Exits;
+    for ( typename std::vector< IdentifierType >::const_iterator it = exits.begin(); it != exits.end(); ++it )
+      {
+      IdentifierType end = str.Output[*it];
+      while ( str.Output[end] != end )
+        {
+        end = str.Output[end];
+        }
+      str.Output[*it] = end;
+      }
+    std::vector< IdentifierType >().swap(chunks[c].m_Exits);
+    }
+
+  // The Segmenter creates labels for the minima and the plateaus in raster
+  // order, and the pixels which flow to the same end get the smallest label
+  // created on their path
+  IdentifierType firstLabel = 1;
+  for ( unsigned int c = 0; c < numberOfChunks; ++c )
+    {
+    chunks[c].m_FirstLabel = firstLabel;
+    firstLabel += static_cast< IdentifierType >( chunks[c].m_Seeds.size() );
+    }
+  str.Step = FindLabelsStep;
+  threader->SingleMethodExecute();
+  str.Descending.clear();
+  for ( unsigned int c = 0; c < numberOfChunks; ++c )
+    {
+    for ( typename LabelMapType::const_iterator it = chunks[c].m_Labels.begin(); it != chunks[c].m_Labels.end(); ++it )
+      {
+      std::pair< typename LabelMapType::iterator, bool > inserted = str.Labels.insert(*it);
+      if ( !inserted.second && it->second < inserted.first->second )
+        {
+        inserted.first->second = it->second;
+        }
+      }
+    chunks[c].m_Labels.clear();
+    }
+  str.Step = RelabelStep;
+  threader->SingleMethodExecute();
+  str.Labels.clear();
+
+  // Fill the segment table as the Segmenter does, from the segments and the
+  // edges found in the slabs in raster order
+  str.Step = CollectSegmentsStep;
+  threader->SingleMethodExecute();
+
+  typedef typename SegmentTableType::segment_t SegmentType;
+  typename SegmentTableType::Pointer segments = SegmentTableType::New();
+  EdgeTableHashType                  edgeHash;
+  const EdgeTableType                tempEdgeTable;
+  for ( unsigned int c = 0; c < numberOfChunks; ++c )
+    {
+    const std::vector< std::pair< IdentifierType, ScalarType > > & chunkSegments = chunks[c].m_Segments;
+    for ( typename std::vector< std::pair< IdentifierType, ScalarType > >::const_iterator it = chunkSegments.begin();
+          it != chunkSegments.end(); ++it )
+      {
+      SegmentType *segment = segments->Lookup(it->first);
+      if ( segment == ITK_NULLPTR )
+        {
+        SegmentType temp;
+        temp.min = it->second;
+        segments->Add(it->first, temp);
+        edgeHash.insert( typename EdgeTableHashType::value_type(it->first, tempEdgeTable) );
+        }
+      else if ( it->second < segment->min )
+        {
+        segment->min = it->second;
+        }
+      }
+    std::vector< std::pair< IdentifierType, ScalarType > >().swap(chunks[c].m_Segments);
+
+    const std::vector< SlabEdge > & chunkEdges = chunks[c].m_Edges;
+    for ( typename std::vector< SlabEdge >::const_iterator it = chunkEdges.begin(); it != chunkEdges.end(); ++it )
+      {
+      EdgeTableType &                         edges = edgeHash.find(it->m_Label)->second;
+      typename EdgeTableType::iterator        edge = edges.find(it->m_Neighbor);
+      if ( edge == edges.end() )
+        {
+        edges.insert( typename EdgeTableType::value_type(it->m_Neighbor, it->m_Height) );
+        }
+      else if ( it->m_Height < edge->second )
+        {
+        edge->second = it->m_Height;
+        }
+      }
+    std::vector< SlabEdge >().swap(chunks[c].m_Edges);
+    }
+  for ( typename EdgeTableHashType::iterator it = edgeHash.begin(); it != edgeHash.end(); ++it )
+    {
+    SegmentType *segment = segments->Lookup(it->first);
+    segment->edge_list.resize( it->second.size() );
+    typename SegmentTableType::edge_list_t::iterator list = segment->edge_list.begin();
+    for ( typename EdgeTableType::const_iterator edge = it->second.begin(); edge != it->second.end(); ++edge, ++list )
+      {
+      list->label = edge->first;
+      list->height = edge->second;
+      }
+    it->second.clear();
+    }
+  edgeHash.clear();
+  segments->SortEdgeLists();
+  segments->SetMaximumDepth(maximum - minimum);
+
+  // Setup the progress command
+  WatershedMiniPipelineProgressCommand::Pointer c =
+    dynamic_cast< WatershedMiniPipelineProgressCommand * >(
+      m_TreeGenerator->GetCommand(m_ObserverTag) );
+  c->SetCount(0.0);
+  c->SetNumberOfFilters(1);
+
+  // The table is not needed after the tree generation
+  m_TreeGenerator->SetInputSegmentTable(segments);
+  m_TreeGenerator->SetConsumeInput(true);
+  m_TreeGenerator->Update();
+
+  // Merge the segments up to the flood level as the Relabeler does
+  typedef typename watershed::SegmentTreeGenerator< ScalarType >::SegmentTreeType SegmentTreeType;
+  SegmentTreeType *tree = m_TreeGenerator->GetOutputSegmentTree();
+  if ( !tree->Empty() )
+    {
+    const ScalarType          mergeLimit = static_cast< ScalarType >( m_Level * tree->Back().saliency );
+    EquivalencyTable::Pointer equivalencies = EquivalencyTable::New();
+    for ( typename SegmentTreeType::Iterator it = tree->Begin();
+          it != tree->End() && it->saliency <= mergeLimit; ++it )
+      {
+      equivalencies->Add(it->from, it->to);
+      }
+    SegmenterType::RelabelImage(output, largestRegion, equivalencies);
+    }
+}
+
+template< typename TInputImage >
+typename WatershedImageFilter< TInputImage >::ScalarType
+WatershedImageFilter< TInputImage >
+::Thresholded(ScalarType value, ScalarType thresholdValue)
+{
+  if ( value < thresholdValue )
+    {
+    return thresholdValue;
+    }
+  if ( NumericTraits< ScalarType >::IsInteger
+CLANG_PRAGMA_PUSH
+CLANG_SUPPRESS_Wfloat_equal
+       && value == NumericTraits< ScalarType >::max() )
+CLANG_PRAGMA_POP
+    {
+    return value - NumericTraits< ScalarType >::OneValue();
+    }
+  return value;
+}
+
+template< typename TInputImage >
+typename WatershedImageFilter< TInputImage >::ScalarType
+WatershedImageFilter< TInputImage >
+::GetValue(const SlabThreadStruct & str, IdentifierType pixel)
+{
+  return Self::Thresholded(str.Input[pixel], str.ThresholdValue);
+}
+
+template< typename TInputImage >
+bool
+WatershedImageFilter< TInputImage >
+::GetNeighbor(const SlabThreadStruct & str, IdentifierType pixel, const IndexType & index,
+              unsigned int i, IdentifierType & neighbor)
+{
+  if ( i < ImageDimension )
+    {
+    const unsigned int d = ImageDimension - 1 - i;
+    if ( index[d] == 0 )
+      {
+      return false;
+      }
+    neighbor = pixel - str.Stride[d];
+    }
+  else
+    {
+    const unsigned int d = i - ImageDimension;
+    if ( index[d] + 1 == static_cast< OffsetValueType >( str.Size[d] ) )
+      {
+      return false;
+      }
+    neighbor = pixel + str.Stride[d];
+    }
+  return true;
+}
+
+template< typename TInputImage >
+bool
+WatershedImageFilter< TInputImage >
+::IsFlat(const SlabThreadStruct & str, IdentifierType pixel, const IndexType & index)
+{
+  const ScalarType value = Self::GetValue(str, pixel);
+  for ( unsigned int i = 0; i < 2 * ImageDimension; ++i )
+    {
+    IdentifierType neighbor = pixel;
+    const bool     inside = Self::GetNeighbor(str, pixel, index, i, neighbor);
+    if ( Math::AlmostEquals( value, inside ? Self::GetValue(str, neighbor) : str.Wall ) )
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+template< typename TInputImage >
+IdentifierType
+WatershedImageFilter< TInputImage >
+::GetPlateau(const SlabThreadStruct & str, IdentifierType pixel)
+{
+  // A flat pixel is linked to the first pixel of its plateau in its slab,
+  // which is linked to the first pixel of the plateau
+  return str.Output[str.Output[pixel]];
+}
+
+template< typename TInputImage >
+void
+WatershedImageFilter< TInputImage >
+::ComputeIndex(const SlabThreadStruct & str, IdentifierType pixel, IndexType & index)
+{
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    index[i] = static_cast< OffsetValueType >( pixel / str.Stride[i] % str.Size[i] );
+    }
+}
+
+template< typename TInputImage >
+void
+WatershedImageFilter< TInputImage >
+::IncrementIndex(const SlabThreadStruct & str, IndexType & index)
+{
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    if ( ++index[i] < static_cast< OffsetValueType >( str.Size[i] ) )
+      {
+      return;
+      }
+    index[i] = 0;
+    }
+}
+
+template< typename TInputImage >
+void
+WatershedImageFilter< TInputImage >
+::ComputeChunkRange(const SlabThreadStruct & str, SlabChunk & chunk) const
+{
+  chunk.m_Minimum = str.Input[chunk.m_Begin];
+  chunk.m_Maximum = str.Input[chunk.m_Begin];
+  for ( IdentifierType pixel = chunk.m_Begin; pixel < chunk.m_End; ++pixel )
+    {
+    const ScalarType value = str.Input[pixel];
+    if ( value < chunk.m_Minimum )
+      {
+      chunk.m_Minimum = value;
+      }
+    if ( chunk.m_Maximum < value )
+      {
+      chunk.m_Maximum = value;
+      }
+    }
+}
+
+template< typename TInputImage >
+void
+WatershedImageFilter< TInputImage >
+::LinkChunkPixels(const SlabThreadStruct & str, SlabChunk & chunk) const
+{
+  IdentifierType *output = str.Output;
+  IndexType       index;
+
+  Self::ComputeIndex(str, chunk.m_Begin, index);
+  for ( IdentifierType pixel = chunk.m_Begin; pixel < chunk.m_End; ++pixel, Self::IncrementIndex(str, index) )
+    {
+    const ScalarType value = Self::GetValue(str, pixel);
+    bool             flat = false;
+    bool             seed = false;
+    bool             singlePixelMinimum = true;
+    ScalarType       lowestValue = str.Wall;
+    IdentifierType   lowest = pixel;
+
+    output[pixel] = pixel;
+    for ( unsigned int i = 0; i < 2 * ImageDimension; ++i )
+      {
+      IdentifierType   neighbor = pixel;
+      const bool       inside = Self::GetNeighbor(str, pixel, index, i, neighbor);
+      const ScalarType neighborValue = inside ? Self::GetValue(str, neighbor) : str.Wall;
+      if ( Math::AlmostEquals(value, neighborValue) )
+        {
+        // The Segmenter creates a label unless the first neighbor on the
+        // plateau is an already labeled pixel
+        if ( !flat )
+          {
+          flat = true;
+          seed = !inside || i >= ImageDimension;
+          }
+        // Union of the plateaus in the slab, the first pixel being the root
+        if ( inside && i < ImageDimension && neighbor >= chunk.m_Begin )
+          {
+          IdentifierType a = pixel;
+          IdentifierType b = neighbor;
+          while ( output[a] != a )
+            {
+            output[a] = output[output[a]];
+            a = output[a];
+            }
+          while ( output[b] != b )
+            {
+            output[b] = output[output[b]];
+            b = output[b];
+            }
+          output[std::max(a, b)] = std::min(a, b);
+          }
+        }
+      else if ( !flat )
+        {
+        if ( i == 0 || neighborValue < lowestValue )
+          {
+          lowestValue = neighborValue;
+          lowest = neighbor;
+          }
+        if ( neighborValue < value )
+          {
+          singlePixelMinimum = false;
+          }
+        }
+      }
+
+    if ( !flat )
+      {
+      if ( singlePixelMinimum )
+        {
+        seed = true;
+        }
+      else
+        {
+        output[pixel] = lowest;
+        }
+      }
+    if ( seed )
+      {
+      chunk.m_Seeds.push_back(pixel);
+      }
+    }
+
+  // Link the flat pixels to the first pixel of their plateau.  A pixel is
+  // linked to a previous one, which is already done.
+  Self::ComputeIndex(str, chunk.m_Begin, index);
+  for ( IdentifierType pixel = chunk.m_Begin; pixel < chunk.m_End; ++pixel, Self::IncrementIndex(str, index) )
+    {
+    if ( output[pixel] != pixel && Self::IsFlat(str, pixel, index) )
+      {
+      output[pixel] = output[output[pixel]];
+      }
+    }
+}
+
+template< typename TInputImage >
+void
+WatershedImageFilter< TInputImage >
+::FindChunkLowestNeighbors(const SlabThreadStruct & str, SlabChunk & chunk) const
+{
+  // As in the Segmenter, the lowest neighbor of a plateau is the first one
+  // found in raster order
+  LowestNeighborType *lowest = ITK_NULLPTR;
+  IdentifierType      lowestPlateau = 0;
+  IndexType           index;
+
+  Self::ComputeIndex(str, chunk.m_Begin, index);
+  for ( IdentifierType pixel = chunk.m_Begin; pixel < chunk.m_End; ++pixel, Self::IncrementIndex(str, index) )
+    {
+    if ( !Self::IsFlat(str, pixel, index) )
+      {
+      continue;
+      }
+    const IdentifierType plateau = Self::GetPlateau(str, pixel);
+    if ( lowest == ITK_NULLPTR || plateau != lowestPlateau )
+      {
+      typename LowestNeighborMapType::iterator it = chunk.m_LowestNeighbors.find(plateau);
+      lowest = it == chunk.m_LowestNeighbors.end() ? ITK_NULLPTR : &it->second;
+      lowestPlateau = plateau;
+      }
+    for ( unsigned int i = 0; i < 2 * ImageDimension; ++i )
+      {
+      IdentifierType neighbor = pixel;
+      if ( !Self::GetNeighbor(str, pixel, index, i, neighbor) )
+        {
+        continue;
+        }
+      const ScalarType neighborValue = Self::GetValue(str, neighbor);
+      if ( !( neighborValue < ( lowest == ITK_NULLPTR ? str.Wall : lowest->first ) ) )
+        {
+        continue;
+        }
+      IndexType neighborIndex = index;
+      if ( i < ImageDimension )
+        {
+        --neighborIndex[ImageDimension - 1 - i];
+        }
+      else
+        {
+        ++neighborIndex[i - ImageDimension];
+        }
+      if ( Self::IsFlat(str, neighbor, neighborIndex) && Self::GetPlateau(str, neighbor) == plateau )
+        {
+        continue;
+        }
+      if ( lowest == ITK_NULLPTR )
+        {
+        lowest = &chunk.m_LowestNeighbors.insert(
+          typename LowestNeighborMapType::value_type( plateau, LowestNeighborType(neighborValue, neighbor) ) ).first->second;
+        }
+      else
+        {
+        *lowest = LowestNeighborType(neighborValue, neighbor);
+        }
+      }
+    }
+}
+
+template< typename TInputImage >
+void
+WatershedImageFilter< TInputImage >
+::ResolveChunkPaths(const SlabThreadStruct & str, SlabChunk & chunk) const
+{
+  // Each pixel is linked to the end of its path in the slab, which is either
+  // the end of the path in the image or a pixel which flows out of the slab
+  IdentifierType *output = str.Output;
+  for ( IdentifierType pixel = chunk.m_Begin; pixel < chunk.m_End; ++pixel )
+    {
+    IdentifierType end = pixel;
+    while ( output[end] != end && output[end] >= chunk.m_Begin && output[end] < chunk.m_End )
+      {
+      end = output[end];
+      }
+    for ( IdentifierType next = pixel; next != end; )
+      {
+      const IdentifierType current = next;
+      next = output[current];
+      output[current] = end;
+      }
+    if ( output[pixel] < chunk.m_Begin || output[pixel] >= chunk.m_End )
+      {
+      chunk.m_Exits.push_back(pixel);
+      }
+    }
+}
+
+template< typename TInputImage >
+void
+WatershedImageFilter< TInputImage >
+::FindChunkLabels(const SlabThreadStruct & str, SlabChunk & chunk) const
+{
+  // The pixels which flow out of the slab are linked to the end of their
+  // path, the other pixels to the end of their path in the slab
+  IdentifierType *output = str.Output;
+  for ( IdentifierType pixel = chunk.m_Begin; pixel < chunk.m_End; ++pixel )
+    {
+    const IdentifierType end = output[output[pixel]];
+    if ( end != output[pixel] )
+      {
+      output[pixel] = end;
+      }
+    }
+
+  // The smallest label created on the path of each end.  The seeds are in
+  // raster order, so the first label found for an end is the smallest one.
+  for ( SizeValueType k = 0; k < chunk.m_Seeds.size(); ++k )
+    {
+    const IdentifierType seed = chunk.m_Seeds[k];
+    if ( output[seed] == seed || str.Descending.find(seed) != str.Descending.end() )
+      {
+      chunk.m_Labels.insert( typename LabelMapType::value_type( output[seed],
+                                                                chunk.m_FirstLabel + static_cast< IdentifierType >( k ) ) );
+      }
+    }
+  std::vector< IdentifierType >().swap(chunk.m_Seeds);
+}
+
+template< typename TInputImage >
+void
+WatershedImageFilter< TInputImage >
+::RelabelChunk(const SlabThreadStruct & str, SlabChunk & chunk) const
+{
+  IdentifierType *output = str.Output;
+  IdentifierType  end = output[chunk.m_Begin];
+  IdentifierType  label = str.Labels.find(end)->second;
+  for ( IdentifierType pixel = chunk.m_Begin; pixel < chunk.m_End; ++pixel )
+    {
+    if ( output[pixel] != end )
+      {
+      end = output[pixel];
+      label = str.Labels.find(end)->second;
+      }
+    output[pixel] = label;
+    }
+}
+
+template< typename TInputImage >
+void
+WatershedImageFilter< TInputImage >
+::CollectChunkSegments(const SlabThreadStruct & str, SlabChunk & chunk) const
+{
+  // The segments and the edges in the order they are first found, with the
+  // lowest values found in the slab
+  typedef itksys::hash_map< IdentifierType, SizeValueType, itksys::hash< IdentifierType > > SegmentIndexMapType;
+  typedef itksys::hash_map< std::pair< IdentifierType, IdentifierType >, SizeValueType, SlabEdgeHash >
+  EdgeIndexMapType;
+  SegmentIndexMapType segmentIndices;
+  EdgeIndexMapType    edgeIndices;
+  IdentifierType      label = str.Output[chunk.m_Begin];
+  SizeValueType       segmentIndex = 0;
+  IndexType           index;
+
+  // The last edge found in each direction, which is most often the edge of
+  // the next pixel
+  IdentifierType lastNeighbors[2 * ImageDimension];
+  SizeValueType  lastEdges[2 * ImageDimension];
+  std::fill(lastNeighbors, lastNeighbors + 2 * ImageDimension, label);
+  std::fill(lastEdges, lastEdges + 2 * ImageDimension, 0);
+
+  chunk.m_Segments.push_back( std::make_pair( label, Self::GetValue(str, chunk.m_Begin) ) );
+  segmentIndices.insert( typename SegmentIndexMapType::value_type(label, segmentIndex) );
+
+  Self::ComputeIndex(str, chunk.m_Begin, index);
+  for ( IdentifierType pixel = chunk.m_Begin; pixel < chunk.m_End; ++pixel, Self::IncrementIndex(str, index) )
+    {
+    const ScalarType value = Self::GetValue(str, pixel);
+    if ( str.Output[pixel] != label )
+      {
+      label = str.Output[pixel];
+      const std::pair< typename SegmentIndexMapType::iterator, bool > inserted =
+        segmentIndices.insert( typename SegmentIndexMapType::value_type( label, chunk.m_Segments.size() ) );
+      segmentIndex = inserted.first->second;
+      if ( inserted.second )
+        {
+        chunk.m_Segments.push_back( std::make_pair(label, value) );
+        }
+      std::fill(lastNeighbors, lastNeighbors + 2 * ImageDimension, label);
+      }
+    if ( value < chunk.m_Segments[segmentIndex].second )
+      {
+      chunk.m_Segments[segmentIndex].second = value;
+      }
+
+    // As in the Segmenter, the height of an edge is the largest value of
+    // the two pixels
+    for ( unsigned int i = 0; i < 2 * ImageDimension; ++i )
+      {
+      IdentifierType neighbor = pixel;
+      if ( !Self::GetNeighbor(str, pixel, index, i, neighbor) || str.Output[neighbor] == label )
+        {
+        continue;
+        }
+      const ScalarType neighborValue = Self::GetValue(str, neighbor);
+      const ScalarType height = neighborValue < value ? value : neighborValue;
+      if ( str.Output[neighbor] != lastNeighbors[i] )
+        {
+        const std::pair< typename EdgeIndexMapType::iterator, bool > inserted =
+          edgeIndices.insert( typename EdgeIndexMapType::value_type( std::make_pair( label, str.Output[neighbor] ),
+                                                                     chunk.m_Edges.size() ) );
+        if ( inserted.second )
+          {
+          SlabEdge edge;
+          edge.m_Label = label;
+          edge.m_Neighbor = str.Output[neighbor];
+          edge.m_Height = height;
+          chunk.m_Edges.push_back(edge);
+          }
+        lastNeighbors[i] = str.Output[neighbor];
+        lastEdges[i] = inserted.first->second;
+        }
+      if ( height < chunk.m_Edges[lastEdges[i]].m_Height )
+        {
+        chunk.m_Edges[lastEdges[i]].m_Height = height;
+        }
+      }
+    }
+}
+
+template< typename TInputImage >
+ITK_THREAD_RETURN_TYPE
+WatershedImageFilter< TInputImage >
+::SlabThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  SlabThreadStruct *             str = static_cast< SlabThreadStruct * >( info->UserData );
+
+  for ( SizeValueType c = info->ThreadID; c < str->Chunks->size(); c += info->NumberOfThreads )
+    {
+    SlabChunk & chunk = ( *str->Chunks )[c];
+    switch ( str->Step )
+      {
+      case ComputeRangeStep:
+        str->Filter->ComputeChunkRange(*str, chunk);
+        break;
+      case LinkPixelsStep:
+        str->Filter->LinkChunkPixels(*str, chunk);
+        break;
+      case FindLowestNeighborsStep:
+        str->Filter->FindChunkLowestNeighbors(*str, chunk);
+        break;
+      case ResolvePathsStep:
+        str->Filter->ResolveChunkPaths(*str, chunk);
+        break;
+      case FindLabelsStep:
+        str->Filter->FindChunkLabels(*str, chunk);
+        break;
+      case RelabelStep:
+        str->Filter->RelabelChunk(*str, chunk);
+        break;
+      case CollectSegmentsStep:
+        str->Filter->CollectChunkSegments(*str, chunk);
+        break;
+      }
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
 template< typename TInputImage >
 void
 WatershedImageFilter< TInputImage >
@@ -217,6 +1006,7 @@ WatershedImageFilter< TInputImage >
   Superclass::PrintSelf(os, indent);
   os << indent << "Threshold: " << m_Threshold << std::endl;
   os << indent << "Level: " << m_Level << std::endl;
+  os << indent << "NumberOfSlabs: " << m_NumberOfSlabs << std::endl;
 }
 } // end namespace itk
 
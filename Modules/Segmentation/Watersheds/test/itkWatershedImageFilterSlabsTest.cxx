@@ -0,0 +1,191 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkWatershedImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+#include <cmath>
+#include <set>
+
+namespace
+{
+
+const unsigned int Dimension = 3;
+
+typedef itk::Image< itk::IdentifierType, Dimension > LabelImageType;
+
+template< typename TImage >
+typename TImage::Pointer
+CreateImage( const typename TImage::SizeType & size )
+{
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions( size );
+  image->Allocate();
+  return image;
+}
+
+/* Counts the pixels whose label differs, the labels being expected to be
+ * identical and not only equivalent. */
+itk::SizeValueType
+CountDifferences( const LabelImageType *reference, const LabelImageType *labels )
+{
+  itk::SizeValueType                              differences = 0;
+  itk::ImageRegionConstIterator< LabelImageType > rit( reference, reference->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< LabelImageType > it( labels, reference->GetLargestPossibleRegion() );
+  for(; !rit.IsAtEnd(); ++rit, ++it )
+    {
+    if( rit.Get() != it.Get() )
+      {
+      ++differences;
+      }
+    }
+  return differences;
+}
+
+itk::SizeValueType
+CountLabels( const LabelImageType *labels )
+{
+  std::set< itk::IdentifierType >                 found;
+  itk::ImageRegionConstIterator< LabelImageType > it( labels, labels->GetLargestPossibleRegion() );
+  for(; !it.IsAtEnd(); ++it )
+    {
+    found.insert( it.Get() );
+    }
+  return found.size();
+}
+
+/* Checks that the labels computed with several numbers of slabs and threads
+ * are the ones computed on a single slab, at the given level and at half
+ * of it. */
+template< typename TImage >
+bool
+CheckSlabs( const TImage *image, double threshold, double level, const char *name )
+{
+  typedef itk::WatershedImageFilter< TImage > FilterType;
+
+  // The largest number of slabs gives slabs of a single layer along the
+  // split dimension, which is the last one larger than one pixel
+  const typename TImage::SizeType size = image->GetLargestPossibleRegion().GetSize();
+  const itk::SizeValueType        depth = size[Dimension - 1] > 1 ? size[Dimension - 1] : size[Dimension - 2];
+  const unsigned int              slabCounts[] = { 2, 5, static_cast< unsigned int >( depth ) };
+  const itk::ThreadIdType         threads[] = { 1, 3, 4 };
+
+  typename FilterType::Pointer reference = FilterType::New();
+  reference->SetInput( image );
+  reference->SetThreshold( threshold );
+
+  for( unsigned int i = 0; i < 3; ++i )
+    {
+    typename FilterType::Pointer filter = FilterType::New();
+    filter->SetInput( image );
+    filter->SetThreshold( threshold );
+    filter->SetNumberOfSlabs( slabCounts[i] );
+    TEST_SET_GET_VALUE( slabCounts[i], filter->GetNumberOfSlabs() );
+    filter->SetNumberOfThreads( threads[i] );
+
+    const double levels[] = { level, level / 2 };
+    for( unsigned int j = 0; j < 2; ++j )
+      {
+      const double currentLevel = levels[j];
+      reference->SetLevel( currentLevel );
+      TRY_EXPECT_NO_EXCEPTION( reference->Update() );
+      filter->SetLevel( currentLevel );
+      TRY_EXPECT_NO_EXCEPTION( filter->Update() );
+
+      const itk::SizeValueType differences = CountDifferences( reference->GetOutput(), filter->GetOutput() );
+      const itk::SizeValueType labels = CountLabels( reference->GetOutput() );
+      std::cout << name << ", level " << currentLevel << ", " << slabCounts[i] << " slabs: " << labels
+                << " labels, " << differences << " different pixels" << std::endl;
+      if( differences > 0 || labels < 2 )
+        {
+        std::cerr << name << ": the labels computed in slabs differ from the reference" << std::endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+}
+
+/* Segments 3D images in slabs and in a single slab, and checks that the labels
+ * are identical.  The images are the distance to centers on a staggered
+ * lattice, which gives a basin for each center, with ripples which split
+ * some of the basins.  The integer image is quantized, so that its plateaus
+ * cross the faces of the slabs, and has a wall at the largest value of the
+ * pixel type. */
+int itkWatershedImageFilterSlabsTest( int, char * [] )
+{
+  typedef itk::Image< float, Dimension >         FloatImageType;
+  typedef itk::Image< unsigned char, Dimension > CharImageType;
+
+  FloatImageType::SizeType size;
+  size[0] = 47;
+  size[1] = 41;
+  size[2] = 53;
+  FloatImageType::Pointer floatImage = CreateImage< FloatImageType >( size );
+  CharImageType::Pointer  charImage = CreateImage< CharImageType >( size );
+
+  itk::ImageRegionIteratorWithIndex< FloatImageType > it( floatImage, floatImage->GetLargestPossibleRegion() );
+  itk::ImageRegionIterator< CharImageType >           cit( charImage, charImage->GetLargestPossibleRegion() );
+  for(; !it.IsAtEnd(); ++it, ++cit )
+    {
+    const FloatImageType::IndexType index = it.GetIndex();
+    double                          distance = 1000.0;
+    for( int z = 4; z < 60; z += 9 )
+      {
+      for( int y = 5; y < 48; y += 10 )
+        {
+        for( int x = 6 + 3 * ( ( y / 10 + z / 9 ) % 2 ); x < 54; x += 12 )
+          {
+          const double dx = index[0] - x;
+          const double dy = index[1] - y;
+          const double dz = index[2] - z;
+          distance = std::min( distance, std::sqrt( dx * dx + dy * dy + dz * dz ) );
+          }
+        }
+      }
+    const double ripple = 0.6 * std::sin( 0.9 * index[0] ) * std::sin( 0.8 * index[1] + 0.5 * index[2] );
+    it.Set( static_cast< float >( distance + ripple ) );
+    cit.Set( index[0] == 23 ? 255 : static_cast< unsigned char >( 10 * ( distance + 1 ) ) );
+    }
+
+  // A single slice, which is split along its rows
+  CharImageType::SizeType sliceSize = size;
+  sliceSize[2] = 1;
+  CharImageType::Pointer slice = CreateImage< CharImageType >( sliceSize );
+  itk::ImageRegionIterator< CharImageType > sit( slice, slice->GetLargestPossibleRegion() );
+  for( cit.GoToBegin(); !sit.IsAtEnd(); ++sit, ++cit )
+    {
+    sit.Set( cit.Get() );
+    }
+
+  bool success = true;
+  success &= CheckSlabs< FloatImageType >( floatImage, 0.0, 0.0, "Float" );
+  success &= CheckSlabs< FloatImageType >( floatImage, 0.05, 0.2, "Float, flooded" );
+  success &= CheckSlabs< CharImageType >( charImage, 0.0, 0.1, "UnsignedChar" );
+  success &= CheckSlabs< CharImageType >( charImage, 0.1, 0.3, "UnsignedChar, flooded" );
+  success &= CheckSlabs< CharImageType >( slice, 0.0, 0.1, "Slice" );
+  if( !success )
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}